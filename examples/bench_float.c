@@ -0,0 +1,132 @@
+// bench_float.c
+//
+/****************************************************************************
+   liblscp - LinuxSampler Control Protocol API
+   Copyright (C) 2004-2021, rncbc aka Rui Nuno Capela. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+*****************************************************************************/
+
+
+#include "src/common.h"
+
+#include <locale.h>
+#include <sys/time.h>
+
+#define BENCH_ROUNDS  1000000
+
+
+// Current time in nanoseconds (wall clock).
+static double bench_clock (void)
+{
+	struct timeval tv;
+
+	gettimeofday(&tv, NULL);
+
+	return (double) tv.tv_sec * 1e9 + (double) tv.tv_usec * 1e3;
+}
+
+
+// As it used to be: switch the process-global locale to "C" and back.
+static float bench_sscanf ( const char *psz )
+{
+	char szNumeric[33], szCType[33];
+	float f = 0.0f;
+
+	szNumeric[32] = szCType[32] = (char) 0;
+	strncpy(szNumeric, setlocale(LC_NUMERIC, NULL), 32);
+	strncpy(szCType, setlocale(LC_CTYPE, NULL), 32);
+	setlocale(LC_NUMERIC, "C");
+	setlocale(LC_CTYPE, "C");
+
+	sscanf(psz, "%f", &f);
+
+	setlocale(LC_NUMERIC, szNumeric);
+	setlocale(LC_CTYPE, szCType);
+
+	return f;
+}
+
+
+static int bench_sprintf ( char *pszBuffer, float f )
+{
+	char szNumeric[33], szCType[33];
+	int n;
+
+	szNumeric[32] = szCType[32] = (char) 0;
+	strncpy(szNumeric, setlocale(LC_NUMERIC, NULL), 32);
+	strncpy(szCType, setlocale(LC_CTYPE, NULL), 32);
+	setlocale(LC_NUMERIC, "C");
+	setlocale(LC_CTYPE, "C");
+
+	n = sprintf(pszBuffer, "%g", f);
+
+	setlocale(LC_NUMERIC, szNumeric);
+	setlocale(LC_CTYPE, szCType);
+
+	return n;
+}
+
+
+int main ( int argc, char *argv[] )
+{
+	static const char *values[] = {
+		"0.5", "1", "0.707107", "1.25", "0.000125", "3.5", "0.1", "2"
+	};
+
+	char szBuffer[32];
+	volatile float fSink = 0.0f;
+	volatile int iSink = 0;
+	double t0, t1;
+	int i;
+
+	(void) argc;
+	(void) argv;
+
+	setlocale(LC_ALL, "");
+
+	t0 = bench_clock();
+	for (i = 0; i < BENCH_ROUNDS; i++)
+		fSink = bench_sscanf(values[i & 7]);
+	t1 = bench_clock();
+	printf("parse:  setlocale x4 + sscanf  %6.1f ns\n", (t1 - t0) / BENCH_ROUNDS);
+
+	t0 = bench_clock();
+	for (i = 0; i < BENCH_ROUNDS; i++)
+		fSink = lscp_atof(values[i & 7]);
+	t1 = bench_clock();
+	printf("parse:  lscp_atof              %6.1f ns\n", (t1 - t0) / BENCH_ROUNDS);
+
+	t0 = bench_clock();
+	for (i = 0; i < BENCH_ROUNDS; i++)
+		iSink = bench_sprintf(szBuffer, (float) (i & 1023) / 64.0f);
+	t1 = bench_clock();
+	printf("format: setlocale x4 + %%g      %6.1f ns\n", (t1 - t0) / BENCH_ROUNDS);
+
+	t0 = bench_clock();
+	for (i = 0; i < BENCH_ROUNDS; i++)
+		iSink = lscp_ftoa(szBuffer, sizeof(szBuffer), (float) (i & 1023) / 64.0f);
+	t1 = bench_clock();
+	printf("format: lscp_ftoa              %6.1f ns\n", (t1 - t0) / BENCH_ROUNDS);
+
+	(void) fSink;
+	(void) iSink;
+
+	return 0;
+}
+
+
+// end of bench_float.c
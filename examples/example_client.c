@@ -622,13 +622,80 @@ void client_test_all ( lscp_client_t *pClient, int step )
 }
 
 
+////////////////////////////////////////////////////////////////////////
+
+void client_meters ( lscp_client_t *pClient )
+{
+	lscp_channel_meter_t meter;
+	int *piChannels;
+	int iVoiceCount;
+	int i;
+
+	// Live meters are kept up-to-date from the event stream...
+	if (!lscp_client_get_live_meters(pClient)
+		&& lscp_client_set_live_meters(pClient, 1) != LSCP_OK) {
+		fprintf(stderr, "client_meters: Live meters not available.\n");
+		return;
+	}
+
+	iVoiceCount = lscp_get_total_voice_count_meter(pClient);
+	if (iVoiceCount >= 0)
+		printf("total_voice_count=%d\n", iVoiceCount);
+	else printf("total_voice_count (not notified yet)\n");
+
+	piChannels = lscp_list_channels(pClient);
+	for (i = 0; piChannels && piChannels[i] >= 0; i++) {
+		if (lscp_get_channel_meter(pClient, piChannels[i], &meter) == 0) {
+			printf("channel=%d voice_count=%d stream_count=%d fill=%lu..%lu%s\n",
+				piChannels[i], meter.voice_count, meter.stream_count,
+				meter.fill_min, meter.fill_max,
+				meter.fill_percentage ? "%" : " bytes");
+		}
+		else printf("channel=%d (not notified yet)\n", piChannels[i]);
+	}
+}
+
+
+void client_topology ( lscp_client_t *pClient )
+{
+	const lscp_device_topology_t *pTopology;
+	const lscp_topology_device_t *pDevice;
+	int i;
+
+	// The device topology mirror is only refetched as notified stale...
+	if (!lscp_client_get_device_mirror(pClient)
+		&& lscp_client_set_device_mirror(pClient, 1) != LSCP_OK) {
+		fprintf(stderr, "client_topology: Device mirror not available.\n");
+		return;
+	}
+
+	pTopology = lscp_get_device_topology(pClient);
+	if (pTopology == NULL) {
+		fprintf(stderr, "client_topology: No device topology.\n");
+		return;
+	}
+
+	for (i = 0; i < pTopology->audio_count; i++) {
+		pDevice = &(pTopology->audio_devices[i]);
+		printf("audio_device=%d driver=%s channels=%d\n", pDevice->device,
+			pDevice->info.driver ? pDevice->info.driver : "", pDevice->port_count);
+	}
+
+	for (i = 0; i < pTopology->midi_count; i++) {
+		pDevice = &(pTopology->midi_devices[i]);
+		printf("midi_device=%d driver=%s ports=%d\n", pDevice->device,
+			pDevice->info.driver ? pDevice->info.driver : "", pDevice->port_count);
+	}
+}
+
+
 ////////////////////////////////////////////////////////////////////////
 
 void client_usage (void)
 {
 	printf("\n  %s %s (Build: %s)\n", lscp_client_package(), lscp_client_version(), lscp_client_build());
 
-	fputs("\n  Available commands: help, test[step], exit, quit, subscribe, unsubscribe", stdout);
+	fputs("\n  Available commands: help, test[step], exit, quit, subscribe, unsubscribe, meters, topology", stdout);
 	fputs("\n  (all else are sent verbatim to server)\n\n", stdout);
 
 }
@@ -679,6 +746,12 @@ int main (int argc, char *argv[] )
 		if (strcmp(szLine, "unsubscribe") == 0)
 			lscp_client_unsubscribe(pClient, LSCP_EVENT_MISCELLANEOUS);
 		else
+		if (strcmp(szLine, "meters") == 0)
+			client_meters(pClient);
+		else
+		if (strcmp(szLine, "topology") == 0)
+			client_topology(pClient);
+		else
 		if (strcmp(szLine, "test") == 0)
 			client_test_all(pClient, 0);
 		else
@@ -34,7 +34,7 @@ static WSADATA _wsaData;
 
 ////////////////////////////////////////////////////////////////////////
 
-lscp_status_t server_callback ( lscp_connect_t *pConnect, const char *pchBuffer, int cchBuffer, void *pvData )
+lscp_status_t server_request ( lscp_connect_t *pConnect, const char *pchBuffer, int cchBuffer )
 {
 	lscp_status_t ret = LSCP_OK;
 	lscp_parser_t tok;
@@ -49,23 +49,6 @@ lscp_status_t server_callback ( lscp_connect_t *pConnect, const char *pchBuffer,
 	static int iMidiInstruments = 0;
 	static float fVolume = 1.0f;
 
-	if (pchBuffer == NULL) {
-		fprintf(stderr, "server_callback: addr=%s port=%d: ",
-			inet_ntoa(pConnect->client.addr.sin_addr),
-			htons(pConnect->client.addr.sin_port));
-		switch (cchBuffer) {
-		case LSCP_CONNECT_OPEN:
-			fprintf(stderr, "New client connection.\n");
-			break;
-		case LSCP_CONNECT_CLOSE:
-			fprintf(stderr, "Connection closed.\n");
-			break;
-		}
-		return ret;
-	}
-
-	lscp_socket_trace("server_callback", &(pConnect->client.addr), pchBuffer, cchBuffer);
-
 	lscp_parser_init(&tok, pchBuffer, cchBuffer);
 
 	if (lscp_parser_test(&tok, "GET")) {
@@ -821,6 +804,46 @@ lscp_status_t server_callback ( lscp_connect_t *pConnect, const char *pchBuffer,
 }
 
 
+lscp_status_t server_callback ( lscp_connect_t *pConnect, const char *pchBuffer, int cchBuffer, void *pvData )
+{
+	lscp_status_t ret = LSCP_OK;
+	const char *pchLine;
+	int i;
+
+	if (pchBuffer == NULL) {
+		fprintf(stderr, "server_callback: addr=%s port=%d: ",
+			inet_ntoa(pConnect->client.addr.sin_addr),
+			htons(pConnect->client.addr.sin_port));
+		switch (cchBuffer) {
+		case LSCP_CONNECT_OPEN:
+			fprintf(stderr, "New client connection.\n");
+			break;
+		case LSCP_CONNECT_CLOSE:
+			fprintf(stderr, "Connection closed.\n");
+			break;
+		}
+		return ret;
+	}
+
+	lscp_socket_trace("server_callback", &(pConnect->client.addr), pchBuffer, cchBuffer);
+
+	// Requests may come pipelined, several lines at once:
+	// each one gets its own reply, in order...
+	pchLine = pchBuffer;
+	for (i = 0; i < cchBuffer && ret == LSCP_OK; i++) {
+		if (pchBuffer[i] == '\n') {
+			if (pchBuffer + i > pchLine + 1)
+				ret = server_request(pConnect, pchLine, (int) (pchBuffer + i + 1 - pchLine));
+			pchLine = pchBuffer + i + 1;
+		}
+	}
+	if (ret == LSCP_OK && pchLine < pchBuffer + cchBuffer)
+		ret = server_request(pConnect, pchLine, (int) (pchBuffer + cchBuffer - pchLine));
+
+	return ret;
+}
+
+
 ////////////////////////////////////////////////////////////////////////
 
 
@@ -81,6 +81,67 @@ typedef struct _lscp_channel_info_t
 } lscp_channel_info_t;
 
 
+/** All sampler channels info table extra queries (flags). */
+#define LSCP_CHANNEL_TABLE_VOICE_COUNT  0x01
+#define LSCP_CHANNEL_TABLE_STREAM_COUNT 0x02
+
+/** All sampler channels info table: one row per sampler channel, with
+    one array per field; text fields are interned (equal strings share
+    the same pointer) and audio routings are -1 terminated. */
+typedef struct _lscp_channel_table_t
+{
+	int           count;            // Number of rows (sampler channels).
+	int *         channel;          // Sampler channel numbers.
+	const char ** engine_name;
+	int *         audio_device;
+	int *         audio_channels;
+	const int **  audio_routing;
+	const char ** instrument_file;
+	int *         instrument_nr;
+	const char ** instrument_name;
+	int *         instrument_status;
+	int *         midi_device;
+	int *         midi_port;
+	int *         midi_channel;
+	int *         midi_map;
+	float *       volume;
+	int *         mute;
+	int *         solo;
+	int *         voice_count;      // Active voices (-1 if not queried).
+	int *         stream_count;     // Active disk streams (-1 if not queried).
+	const void *  row_index;        // Sampler channel to row index (opaque).
+
+} lscp_channel_table_t;
+
+
+/** Structured response view item: spans into the response text. */
+typedef struct _lscp_response_item_t
+{
+	int           key;          // Key offset (-1 for plain list items).
+	int           key_len;      // Key length.
+	int           value;        // Value offset.
+	int           value_len;    // Value length (trimmed).
+
+} lscp_response_item_t;
+
+
+/** Structured response view: "KEY: value" lines and/or comma lists. */
+typedef struct _lscp_response_t
+{
+	const char *  data;         // Response text being viewed.
+	int           count;        // Number of items.
+	lscp_response_item_t *items;
+	int           items_size;   // Allocated items (reused).
+	char *        buffer;       // Private response text copy (reused).
+	int           buffer_size;  // Allocated copy size.
+
+} lscp_response_t;
+
+
+/** Lazy channel info opaque descriptor (decoded on field access). */
+typedef struct _lscp_channel_lazy_t lscp_channel_lazy_t;
+
+
 /** Buffer fill cache struct. */
 typedef struct _lscp_buffer_fill_t
 {
@@ -89,6 +150,9 @@ typedef struct _lscp_buffer_fill_t
 
 } lscp_buffer_fill_t;
 
+/** Buffer fill array terminator (stream id of the last, extra entry). */
+#define LSCP_BUFFER_FILL_END    ((unsigned int) -1)
+
 
 /** Buffer fill stream usage types. */
 typedef enum _lscp_usage_t
@@ -155,6 +219,97 @@ typedef enum _lscp_midi_map_mode_t
 } lscp_midi_map_mode_t;
 
 
+/** MIDI instrument map mirror entry struct. */
+typedef struct _lscp_midi_map_entry_t
+{
+	lscp_midi_instrument_t      instr;
+	lscp_midi_instrument_info_t info;
+
+} lscp_midi_map_entry_t;
+
+
+/** MIDI instrument map mirror map struct. */
+typedef struct _lscp_midi_map_t
+{
+	int                     map;
+	char *                  name;
+	int                     entry_count;
+	lscp_midi_map_entry_t * entries;
+
+} lscp_midi_map_t;
+
+
+/** MIDI instrument map mirror struct. */
+typedef struct _lscp_midi_maps_t
+{
+	int                     map_count;
+	lscp_midi_map_t *       maps;
+
+} lscp_midi_maps_t;
+
+
+/** Scene setting to be left as currently found (integer fields). */
+#define LSCP_SCENE_KEEP         (-100)
+
+/** Scene effect send desired state. */
+typedef struct _lscp_scene_fxsend_t
+{
+	int           fxsend;           // Effect send number.
+	float         level;            // Send level (negative to keep).
+	const int *   audio_routing;    // Audio routing (-1 terminated, NULL to keep).
+
+} lscp_scene_fxsend_t;
+
+
+/** Scene sampler channel desired state: integer fields set to
+    @ref LSCP_SCENE_KEEP, negative floats and NULL pointers leave
+    the current setting as is. */
+typedef struct _lscp_scene_channel_t
+{
+	int           channel;          // Sampler channel number.
+	const char *  engine_name;
+	const char *  instrument_file;
+	int           instrument_nr;
+	int           audio_device;
+	const int *   audio_routing;    // Audio routing (-1 terminated).
+	int           midi_device;
+	int           midi_port;
+	int           midi_channel;
+	int           midi_map;
+	float         volume;
+	int           mute;
+	int           solo;
+	int           fxsend_count;     // Number of effect sends.
+	const lscp_scene_fxsend_t *fxsends;
+
+} lscp_scene_channel_t;
+
+
+/** Scene MIDI instrument map entry desired state. */
+typedef struct _lscp_scene_instrument_t
+{
+	lscp_midi_instrument_t instr;   // Map, bank and program key.
+	const char *  engine_name;
+	const char *  instrument_file;
+	int           instrument_nr;
+	float         volume;           // Volume (negative for 1.0).
+	lscp_load_mode_t load_mode;
+	const char *  name;             // Entry name (NULL to keep).
+
+} lscp_scene_instrument_t;
+
+
+/** Scene desired state description. */
+typedef struct _lscp_scene_t
+{
+	int           channel_count;    // Number of sampler channels.
+	const lscp_scene_channel_t *channels;
+	int           instrument_count; // Number of MIDI map entries.
+	const lscp_scene_instrument_t *instruments;
+
+} lscp_scene_t;
+
+
 //-------------------------------------------------------------------------
 // Client socket main structure.
 
@@ -171,6 +326,108 @@ typedef lscp_status_t (*lscp_client_proc_t)
 	void *pvData
 );
 
+/** Decoded event notification data (missing fields are -1). */
+typedef struct _lscp_event_data_t
+{
+	lscp_event_t  event;            // Event notification type.
+	int           channel;          // Sampler channel.
+	int           device;           // Audio output or MIDI input device.
+	int           port;             // MIDI input port.
+	int           count;            // Any *_COUNT event value.
+	int           map;              // MIDI instrument map.
+	int           bank;             // MIDI instrument bank.
+	int           prog;             // MIDI instrument program.
+	unsigned char midi[3];          // MIDI event bytes (status, data1, data2).
+	int           fill_count;       // Number of buffer fill entries.
+	int           fill_percentage;  // Buffer fill usage in percentage (else bytes).
+	const struct _lscp_buffer_fill_t *fill; // Buffer fill entries.
+	const char *  text;             // Raw notification data.
+	int           text_len;         // Raw notification data length.
+
+} lscp_event_data_t;
+
+/** Compact MIDI event record, as notified by CHANNEL_MIDI (sampler
+    channel) or DEVICE_MIDI (device and port), missing fields are -1. */
+typedef struct _lscp_midi_event_t
+{
+	lscp_event_t  event;            // Either CHANNEL_MIDI or DEVICE_MIDI.
+	int           channel;          // Sampler channel.
+	int           device;           // MIDI input device.
+	int           port;             // MIDI input port.
+	unsigned char midi[3];          // MIDI event bytes (status, data1, data2).
+
+} lscp_midi_event_t;
+
+/** Live meter values of a sampler channel, as last notified (-1 if not yet). */
+typedef struct _lscp_channel_meter_t
+{
+	int           voice_count;      // Active voices (VOICE_COUNT).
+	int           stream_count;     // Active disk streams (STREAM_COUNT).
+	int           fill_count;       // Number of buffer fill entries (BUFFER_FILL).
+	int           fill_percentage;  // Buffer fill usage in percentage (else bytes).
+	unsigned long fill_min;         // Lowest buffer fill usage.
+	unsigned long fill_max;         // Highest buffer fill usage.
+	unsigned int  serial;           // Update counter (changes on every update).
+
+} lscp_channel_meter_t;
+
+/** Telemetry statistics over a time window (values as recorded,
+    buffer fill in percentage, voice count in voices). */
+typedef struct _lscp_telemetry_stats_t
+{
+	int           samples;          // Samples (or downsampled buckets) in window.
+	float         min;              // Lowest value.
+	float         mean;             // Average value.
+	float         slope;            // Trend, in value units per second.
+	float         last;             // Latest value.
+	int           age;              // Latest value age (msecs).
+
+} lscp_telemetry_stats_t;
+
+/** Client decoded event callback procedure prototype. */
+typedef lscp_status_t (*lscp_client_event_proc_t)
+(
+	struct _lscp_client_t *pClient,
+	const lscp_event_data_t *pEventData,
+	void *pvData
+);
+
+/** Client batched MIDI events callback procedure prototype. */
+typedef lscp_status_t (*lscp_client_midi_proc_t)
+(
+	struct _lscp_client_t *pClient,
+	const lscp_midi_event_t *pMidiEvents,
+	int iMidiEvents,
+	void *pvData
+);
+
+/** Queued event delivery overflow policy. */
+typedef enum _lscp_queue_policy_t
+{
+	LSCP_QUEUE_DROP = 0,            // Drop newest events while full (counted).
+	LSCP_QUEUE_WAIT                 // Hold the event service until drained
+	                                // (within the client timeout, then drop).
+
+} lscp_queue_policy_t;
+
+/** Client queued events ready callback procedure prototype. */
+typedef void (*lscp_client_ready_proc_t)
+(
+	struct _lscp_client_t *pClient,
+	void *pvData
+);
+
+/** Client disk stream underrun prediction callback procedure prototype. */
+typedef void (*lscp_client_underrun_proc_t)
+(
+	struct _lscp_client_t *pClient,
+	int iSamplerChannel,
+	unsigned int iStreamId,
+	const lscp_telemetry_stats_t *pStats,
+	int iEta,
+	void *pvData
+);
+
 //-------------------------------------------------------------------------
 // Client versioning teller function.
 
@@ -189,6 +446,40 @@ lscp_status_t           lscp_client_set_timeout         (lscp_client_t *pClient,
 int                     lscp_client_get_timeout         (lscp_client_t *pClient);
 bool                    lscp_client_connection_lost     (lscp_client_t *pClient);
 
+lscp_status_t           lscp_client_set_event_callback  (lscp_client_t *pClient, lscp_client_event_proc_t pfnEventCallback, void *pvData);
+
+lscp_status_t           lscp_client_set_event_queue     (lscp_client_t *pClient, int iCapacity, lscp_queue_policy_t policy, lscp_client_ready_proc_t pfnReady, void *pvData);
+int                     lscp_client_get_event_queue     (lscp_client_t *pClient);
+int                     lscp_client_drain_events        (lscp_client_t *pClient, int iMaxEvents);
+unsigned long           lscp_client_get_event_drops     (lscp_client_t *pClient);
+
+lscp_status_t           lscp_client_set_event_conflation (lscp_client_t *pClient, lscp_event_t events, int iInterval);
+lscp_event_t            lscp_client_get_event_conflation (lscp_client_t *pClient, int *piInterval);
+
+int                     lscp_client_add_event_handler   (lscp_client_t *pClient, lscp_event_t event, int iId, lscp_client_event_proc_t pfnHandler, void *pvData);
+lscp_status_t           lscp_client_remove_event_handler (lscp_client_t *pClient, int iHandle);
+
+lscp_status_t           lscp_client_set_midi_callback   (lscp_client_t *pClient, lscp_client_midi_proc_t pfnMidiCallback, void *pvData);
+
+lscp_status_t           lscp_client_set_channel_cache   (lscp_client_t *pClient, int iChannelCache);
+int                     lscp_client_get_channel_cache   (lscp_client_t *pClient);
+
+lscp_status_t           lscp_client_flush_metadata      (lscp_client_t *pClient);
+
+lscp_status_t           lscp_client_set_live_meters     (lscp_client_t *pClient, int iLiveMeters);
+int                     lscp_client_get_live_meters     (lscp_client_t *pClient);
+
+lscp_status_t           lscp_client_set_telemetry       (lscp_client_t *pClient, int iTelemetry);
+int                     lscp_client_get_telemetry       (lscp_client_t *pClient);
+lscp_status_t           lscp_client_set_underrun_callback (lscp_client_t *pClient, lscp_client_underrun_proc_t pfnUnderrun, int iHorizon, float fThreshold, void *pvData);
+
+lscp_status_t           lscp_client_set_midi_map_mirror (lscp_client_t *pClient, int iMidiMapMirror);
+int                     lscp_client_get_midi_map_mirror (lscp_client_t *pClient);
+
+lscp_status_t           lscp_client_save_warm_start     (lscp_client_t *pClient, const char *pszFilename);
+lscp_status_t           lscp_client_load_warm_start     (lscp_client_t *pClient, const char *pszFilename);
+lscp_status_t           lscp_client_reconcile_warm_start (lscp_client_t *pClient);
+
 //-------------------------------------------------------------------------
 // Client common protocol functions.
 
@@ -196,6 +487,27 @@ lscp_status_t           lscp_client_query               (lscp_client_t *pClient,
 const char *            lscp_client_get_result          (lscp_client_t *pClient );
 int                     lscp_client_get_errno           (lscp_client_t *pClient );
 
+lscp_status_t           lscp_client_query_response      (lscp_client_t *pClient, const char *pszQuery, int iMultiLine, lscp_response_t *pResponse);
+
+//-------------------------------------------------------------------------
+// Structured response view functions.
+
+void                    lscp_response_init              (lscp_response_t *pResponse);
+void                    lscp_response_free              (lscp_response_t *pResponse);
+
+int                     lscp_response_parse             (lscp_response_t *pResponse, const char *pszText);
+int                     lscp_response_count             (lscp_response_t *pResponse);
+int                     lscp_response_find              (lscp_response_t *pResponse, const char *pszKey);
+
+const char *            lscp_response_key               (lscp_response_t *pResponse, int iItem, int *pcchKey);
+const char *            lscp_response_value             (lscp_response_t *pResponse, int iItem, int *pcchValue);
+const char *            lscp_response_string            (lscp_response_t *pResponse, int iItem, int *pcchString);
+int                     lscp_response_copy              (lscp_response_t *pResponse, int iItem, char *pszBuffer, int cchMaxBuffer);
+
+int                     lscp_response_int               (lscp_response_t *pResponse, int iItem, int iDefault);
+float                   lscp_response_float             (lscp_response_t *pResponse, int iItem, float fDefault);
+int                     lscp_response_bool              (lscp_response_t *pResponse, int iItem, int iDefault);
+
 //-------------------------------------------------------------------------
 // Client registration protocol functions.
 
@@ -219,7 +531,30 @@ int                     lscp_get_available_engines      (lscp_client_t *pClient)
 const char **           lscp_list_available_engines     (lscp_client_t *pClient);
 
 lscp_engine_info_t *    lscp_get_engine_info            (lscp_client_t *pClient, const char *pszEngineName);
+const lscp_engine_info_t *lscp_get_engine_info_snapshot (lscp_client_t *pClient, const char *pszEngineName);
 lscp_channel_info_t *   lscp_get_channel_info           (lscp_client_t *pClient, int iSamplerChannel);
+const lscp_channel_info_t *lscp_get_channel_info_snapshot (lscp_client_t *pClient, int iSamplerChannel);
+
+const lscp_channel_table_t *lscp_get_all_channel_info   (lscp_client_t *pClient, int iFlags);
+int                     lscp_channel_table_row          (const lscp_channel_table_t *pTable, int iSamplerChannel);
+
+lscp_channel_lazy_t *   lscp_get_channel_info_lazy      (lscp_client_t *pClient, int iSamplerChannel);
+
+const char *            lscp_channel_lazy_engine_name       (lscp_channel_lazy_t *pLazy);
+int                     lscp_channel_lazy_audio_device      (lscp_channel_lazy_t *pLazy);
+int                     lscp_channel_lazy_audio_channels    (lscp_channel_lazy_t *pLazy);
+const int *             lscp_channel_lazy_audio_routing     (lscp_channel_lazy_t *pLazy);
+const char *            lscp_channel_lazy_instrument_file   (lscp_channel_lazy_t *pLazy);
+int                     lscp_channel_lazy_instrument_nr     (lscp_channel_lazy_t *pLazy);
+const char *            lscp_channel_lazy_instrument_name   (lscp_channel_lazy_t *pLazy);
+int                     lscp_channel_lazy_instrument_status (lscp_channel_lazy_t *pLazy);
+int                     lscp_channel_lazy_midi_device       (lscp_channel_lazy_t *pLazy);
+int                     lscp_channel_lazy_midi_port         (lscp_channel_lazy_t *pLazy);
+int                     lscp_channel_lazy_midi_channel      (lscp_channel_lazy_t *pLazy);
+int                     lscp_channel_lazy_midi_map          (lscp_channel_lazy_t *pLazy);
+float                   lscp_channel_lazy_volume            (lscp_channel_lazy_t *pLazy);
+int                     lscp_channel_lazy_mute              (lscp_channel_lazy_t *pLazy);
+int                     lscp_channel_lazy_solo              (lscp_channel_lazy_t *pLazy);
 
 int                     lscp_get_channel_voice_count    (lscp_client_t *pClient, int iSamplerChannel);
 int                     lscp_get_channel_stream_count   (lscp_client_t *pClient, int iSamplerChannel);
@@ -247,6 +582,7 @@ lscp_status_t           lscp_reset_channel              (lscp_client_t *pClient,
 lscp_status_t           lscp_reset_sampler              (lscp_client_t *pClient);
 
 lscp_server_info_t *    lscp_get_server_info            (lscp_client_t *pClient);
+const lscp_server_info_t *lscp_get_server_info_snapshot (lscp_client_t *pClient);
 
 int                     lscp_get_total_voice_count      (lscp_client_t *pClient);
 int                     lscp_get_total_voice_count_max  (lscp_client_t *pClient);
@@ -270,6 +606,7 @@ int                     lscp_get_fxsends                (lscp_client_t *pClient,
 int *                   lscp_list_fxsends               (lscp_client_t *pClient, int iSamplerChannel);
 
 lscp_fxsend_info_t *    lscp_get_fxsend_info            (lscp_client_t *pClient, int iSamplerChannel, int iFxSend);
+const lscp_fxsend_info_t *lscp_get_fxsend_info_snapshot (lscp_client_t *pClient, int iSamplerChannel, int iFxSend);
 
 lscp_status_t           lscp_set_fxsend_name            (lscp_client_t *pClient, int iSamplerChannel, int iFxSend, const char *pszFxName);
 lscp_status_t           lscp_set_fxsend_audio_channel   (lscp_client_t *pClient, int iSamplerChannel, int iFxSend, int iAudioSrc, int iAudioDst);
@@ -295,14 +632,48 @@ int                     lscp_get_midi_instruments       (lscp_client_t *pClient,
 lscp_midi_instrument_t *lscp_list_midi_instruments      (lscp_client_t *pClient, int iMidiMap);
 
 lscp_midi_instrument_info_t *lscp_get_midi_instrument_info(lscp_client_t *pClient, lscp_midi_instrument_t *pMidiInstr);
+const lscp_midi_instrument_info_t *lscp_get_midi_instrument_info_snapshot (lscp_client_t *pClient, lscp_midi_instrument_t *pMidiInstr);
 
 lscp_status_t           lscp_clear_midi_instruments     (lscp_client_t *pClient, int iMidiMap);
 
+//-------------------------------------------------------------------------
+// MIDI instrument map mirror functions.
+
+const lscp_midi_maps_t *lscp_get_midi_instrument_mirror (lscp_client_t *pClient);
+
+const lscp_midi_map_entry_t *lscp_find_midi_instrument  (lscp_client_t *pClient, lscp_midi_instrument_t *pMidiInstr);
+const lscp_midi_map_entry_t **lscp_find_midi_instruments_by_name (lscp_client_t *pClient, const char *pszName);
+const lscp_midi_map_entry_t **lscp_find_midi_instruments_by_file (lscp_client_t *pClient, const char *pszFileName, int iInstrIndex);
+
 //-------------------------------------------------------------------------
 // Instrument editor functions.
 
 lscp_status_t           lscp_edit_channel_instrument    (lscp_client_t *pClient, int iSamplerChannel);
 
+//-------------------------------------------------------------------------
+// Reference-counted info snapshot functions.
+
+void                    lscp_snapshot_ref               (const void *pvSnapshot);
+void                    lscp_snapshot_unref             (const void *pvSnapshot);
+
+//-------------------------------------------------------------------------
+// Live meter functions (lock-free readers).
+
+int                     lscp_get_channel_meter          (lscp_client_t *pClient, int iSamplerChannel, lscp_channel_meter_t *pMeter);
+int                     lscp_get_total_voice_count_meter (lscp_client_t *pClient);
+
+//-------------------------------------------------------------------------
+// Telemetry functions.
+
+int                     lscp_get_stream_fill_stats      (lscp_client_t *pClient, int iSamplerChannel, unsigned int iStreamId, int iWindow, lscp_telemetry_stats_t *pStats);
+int                     lscp_get_channel_voice_stats    (lscp_client_t *pClient, int iSamplerChannel, int iWindow, lscp_telemetry_stats_t *pStats);
+
+//-------------------------------------------------------------------------
+// Scene diff and apply functions.
+
+const char **           lscp_scene_diff                 (lscp_client_t *pClient, const lscp_scene_t *pScene, const lscp_channel_table_t *pCurrent);
+lscp_status_t           lscp_scene_apply                (lscp_client_t *pClient, const lscp_scene_t *pScene, const lscp_channel_table_t *pCurrent);
+
 #if defined(__cplusplus)
 }
 #endif
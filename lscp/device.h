@@ -99,6 +99,28 @@ typedef struct _lscp_device_port_info_t
 } lscp_device_port_info_t;
 
 
+/** Device topology mirror device struct (audio output or MIDI input). */
+typedef struct _lscp_topology_device_t
+{
+	int           device;       // Device number identifier.
+	lscp_device_info_t info;    // Device information.
+	int           port_count;   // Number of audio channels or MIDI ports.
+	lscp_device_port_info_t *ports; // Audio channels or MIDI ports information.
+
+} lscp_topology_device_t;
+
+
+/** Device topology mirror struct. */
+typedef struct _lscp_device_topology_t
+{
+	int           audio_count;  // Number of audio output devices.
+	lscp_topology_device_t *audio_devices;
+	int           midi_count;   // Number of MIDI input devices.
+	lscp_topology_device_t *midi_devices;
+
+} lscp_device_topology_t;
+
+
 //-------------------------------------------------------------------------
 // Audio driver control functions.
 
@@ -106,7 +128,9 @@ int                     lscp_get_available_audio_drivers    (lscp_client_t *pCli
 const char **           lscp_list_available_audio_drivers   (lscp_client_t *pClient);
 
 lscp_driver_info_t *    lscp_get_audio_driver_info      (lscp_client_t *pClient, const char *pszAudioDriver);
+const lscp_driver_info_t *lscp_get_audio_driver_info_snapshot (lscp_client_t *pClient, const char *pszAudioDriver);
 lscp_param_info_t *     lscp_get_audio_driver_param_info(lscp_client_t *pClient, const char *pszAudioDriver, const char *pszParam, lscp_param_t *pDepList);
+const lscp_param_info_t *lscp_get_audio_driver_param_info_snapshot (lscp_client_t *pClient, const char *pszAudioDriver, const char *pszParam, lscp_param_t *pDepList);
 
 //-------------------------------------------------------------------------
 // Audio device control functions.
@@ -117,11 +141,14 @@ lscp_status_t           lscp_destroy_audio_device       (lscp_client_t *pClient,
 int                     lscp_get_audio_devices          (lscp_client_t *pClient);
 int *                   lscp_list_audio_devices         (lscp_client_t *pClient);
 lscp_device_info_t *    lscp_get_audio_device_info      (lscp_client_t *pClient, int iAudioDevice);
+const lscp_device_info_t *lscp_get_audio_device_info_snapshot (lscp_client_t *pClient, int iAudioDevice);
 lscp_status_t           lscp_set_audio_device_param     (lscp_client_t *pClient, int iAudioDevice, lscp_param_t *pParam);
 
 lscp_device_port_info_t *lscp_get_audio_channel_info    (lscp_client_t *pClient, int iAudioDevice, int iAudioChannel);
+const lscp_device_port_info_t *lscp_get_audio_channel_info_snapshot (lscp_client_t *pClient, int iAudioDevice, int iAudioChannel);
 
 lscp_param_info_t *     lscp_get_audio_channel_param_info   (lscp_client_t *pClient, int iAudioDevice, int iAudioChannel, const char *pszParam);
+const lscp_param_info_t *lscp_get_audio_channel_param_info_snapshot (lscp_client_t *pClient, int iAudioDevice, int iAudioChannel, const char *pszParam);
 lscp_status_t           lscp_set_audio_channel_param        (lscp_client_t *pClient, int iAudioDevice, int iAudioChannel, lscp_param_t *pParam);
 
 
@@ -132,7 +159,9 @@ int                     lscp_get_available_midi_drivers (lscp_client_t *pClient)
 const char **           lscp_list_available_midi_drivers(lscp_client_t *pClient);
 
 lscp_driver_info_t *    lscp_get_midi_driver_info       (lscp_client_t *pClient, const char *pszMidiDriver);
+const lscp_driver_info_t *lscp_get_midi_driver_info_snapshot (lscp_client_t *pClient, const char *pszMidiDriver);
 lscp_param_info_t *     lscp_get_midi_driver_param_info (lscp_client_t *pClient, const char *pszMidiDriver, const char *pszParam, lscp_param_t *pDepList);
+const lscp_param_info_t *lscp_get_midi_driver_param_info_snapshot (lscp_client_t *pClient, const char *pszMidiDriver, const char *pszParam, lscp_param_t *pDepList);
 
 //-------------------------------------------------------------------------
 // MIDI device control functions.
@@ -143,13 +172,24 @@ lscp_status_t           lscp_destroy_midi_device        (lscp_client_t *pClient,
 int                     lscp_get_midi_devices           (lscp_client_t *pClient);
 int *                   lscp_list_midi_devices          (lscp_client_t *pClient);
 lscp_device_info_t *    lscp_get_midi_device_info       (lscp_client_t *pClient, int iMidiDevice);
+const lscp_device_info_t *lscp_get_midi_device_info_snapshot (lscp_client_t *pClient, int iMidiDevice);
 lscp_status_t           lscp_set_midi_device_param      (lscp_client_t *pClient, int iMidiDevice, lscp_param_t *pParam);
 
 lscp_device_port_info_t *lscp_get_midi_port_info        (lscp_client_t *pClient, int iMidiDevice, int iMidiPort);
+const lscp_device_port_info_t *lscp_get_midi_port_info_snapshot (lscp_client_t *pClient, int iMidiDevice, int iMidiPort);
 
 lscp_param_info_t *     lscp_get_midi_port_param_info   (lscp_client_t *pClient, int iMidiDevice, int iMidiPort, const char *pszParam);
+const lscp_param_info_t *lscp_get_midi_port_param_info_snapshot (lscp_client_t *pClient, int iMidiDevice, int iMidiPort, const char *pszParam);
 lscp_status_t           lscp_set_midi_port_param        (lscp_client_t *pClient, int iMidiDevice, int iMidiPort, lscp_param_t *pParam);
 
+//-------------------------------------------------------------------------
+// Device topology mirror functions.
+
+lscp_status_t           lscp_client_set_device_mirror   (lscp_client_t *pClient, int iDeviceMirror);
+int                     lscp_client_get_device_mirror   (lscp_client_t *pClient);
+
+const lscp_device_topology_t *lscp_get_device_topology  (lscp_client_t *pClient);
+
 //-------------------------------------------------------------------------
 // Generic parameter list functions.
 
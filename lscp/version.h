@@ -0,0 +1,32 @@
+// version.h
+//
+/****************************************************************************
+   liblscp - LinuxSampler Control Protocol API
+   Copyright (C) 2004-2024, rncbc aka Rui Nuno Capela. All rights reserved.
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+*****************************************************************************/
+
+#ifndef __LSCP_VERSION_H
+#define __LSCP_VERSION_H
+
+#define LSCP_PACKAGE    "liblscp"
+#define LSCP_VERSION    "0.9.12"
+#define LSCP_BUILD      "0.9.12"
+
+#endif // __LSCP_VERSION_H
+
+// end of version.h
@@ -20,9 +20,12 @@
 
 *****************************************************************************/
 
-#include <locale.h>
 #include "common.h"
+
+#include <ctype.h>
+#include <limits.h>
 #include <sys/time.h>
+#include <time.h>
 #ifdef WIN32
 # include <errno.h>
 #else
@@ -34,6 +37,14 @@
 #define LSCP_TIMEOUT_MSECS  500
 
 
+// Brief pause while the event queue is full.
+#if defined(WIN32)
+#define _lscp_client_yield()  Sleep(1)
+#else
+#define _lscp_client_yield()  usleep(1000)
+#endif
+
+
 // Whether to use getaddrinfo() instead
 // of deprecated gethostbyname()
 #if !defined(WIN32)
@@ -43,51 +54,422 @@
 
 // Local prototypes.
 
+static int _lscp_client_evt_pending (lscp_client_t *pClient);
+static int _lscp_client_evt_queue (lscp_client_t *pClient,
+	lscp_event_t event, const char *pszToken, int cchToken);
+static lscp_status_t _lscp_client_evt_dispatch (lscp_client_t *pClient,
+	lscp_event_t event, const char *pszToken, int cchToken,
+	const lscp_event_data_t *pEventData);
+static void _lscp_client_evt_deliver (lscp_client_t *pClient,
+	lscp_event_t event, const char *pszToken, int cchToken,
+	const lscp_event_data_t *pEventData);
+static void _lscp_client_evt_reply (lscp_client_t *pClient, char *pszLine);
+static void _lscp_client_evt_timeout (lscp_client_t *pClient);
+static int _lscp_client_evt_midi (lscp_client_t *pClient,
+	const char *pszLine);
+static void _lscp_client_evt_midi_flush (lscp_client_t *pClient);
+static void _lscp_client_evt_line (lscp_client_t *pClient, char *pszLine);
+static void _lscp_client_evt_flush (lscp_client_t *pClient);
 static void _lscp_client_evt_proc (void *pvClient);
 
 static lscp_status_t _lscp_client_evt_connect (lscp_client_t *pClient);
+static int _lscp_client_evt_split (lscp_event_t events,
+	lscp_event_t *pEvents);
+static int _lscp_client_evt_clock (void);
+static int _lscp_client_evt_wait (lscp_evt_reply_t *pReply,
+	int iTimeout, int iStart);
+static lscp_status_t _lscp_client_evt_send (lscp_client_t *pClient,
+	int iSubscribe, const lscp_event_t *pEvents, int iEvents,
+	lscp_status_t *pStatus);
 static lscp_status_t _lscp_client_evt_request (lscp_client_t *pClient,
-	int iSubscribe, lscp_event_t event);
+	int iSubscribe, lscp_event_t events);
+static lscp_event_t _lscp_client_evt_internal (lscp_client_t *pClient);
+static lscp_status_t _lscp_client_evt_depend (lscp_client_t *pClient,
+	lscp_event_t *pDepends, const lscp_event_t *pEvents, int iEvents,
+	int iSubscribe);
+static lscp_status_t _lscp_client_evt_enable (lscp_client_t *pClient,
+	int *piEnabled, lscp_event_t *pDepends, lscp_event_t events,
+	int iEnable);
+
+static lscp_server_info_t *_lscp_server_info_query (lscp_client_t *pClient,
+	lscp_server_info_t *pServerInfo);
+static lscp_engine_info_t *_lscp_engine_info_query (lscp_client_t *pClient,
+	lscp_engine_info_t *pEngineInfo, const char *pszQuery);
+static lscp_engine_info_t *_lscp_engine_info_cached (lscp_client_t *pClient,
+	const char *pszQuery, int iSnapshot);
+static lscp_status_t _lscp_channel_info_query (lscp_client_t *pClient,
+	lscp_channel_info_t *pChannelInfo, int iSamplerChannel);
+static void _lscp_channel_info_parse (lscp_intern_pool_t *pPool,
+	lscp_channel_info_t *pChannelInfo, char *pszResult);
+static void _lscp_channel_table_result (lscp_client_t *pClient,
+	int iQuery, lscp_status_t ret, char *pszResult, void *pvData);
+static lscp_fxsend_info_t *_lscp_fxsend_info_query (lscp_client_t *pClient,
+	lscp_fxsend_info_t *pFxSendInfo, const char *pszQuery);
+static void _lscp_fxsend_info_parse (lscp_fxsend_info_t *pFxSendInfo,
+	char *pszResult);
+static void _lscp_midi_map_name_parse (char **ppszName, char *pszResult);
+static void _lscp_midi_instrument_info_parse (lscp_intern_pool_t *pPool,
+	lscp_midi_instrument_info_t *pInstrInfo, char *pszResult);
+static lscp_midi_instrument_info_t *_lscp_midi_instrument_info_query (
+	lscp_client_t *pClient, lscp_midi_instrument_info_t *pInstrInfo,
+	const char *pszQuery);
+static int _lscp_map_midi_instrument_query (char *pszQuery, int cchQuery,
+	int iNonModal,
+	const lscp_midi_instrument_t *pMidiInstr, const char *pszEngineName,
+	const char *pszFileName, int iInstrIndex, float fVolume,
+	lscp_load_mode_t load_mode, const char *pszName);
+
+static void _lscp_channel_cache_event (lscp_client_t *pClient,
+	lscp_event_t event, const char *pszData);
+static void _lscp_channel_cache_invalidate (lscp_client_t *pClient,
+	int iSamplerChannel);
+static lscp_channel_info_t *_lscp_channel_cache_lock (lscp_client_t *pClient,
+	int iSamplerChannel);
+static void _lscp_channel_cache_unlock (lscp_client_t *pClient);
+
+static void _lscp_midi_mirror_touch (lscp_client_t *pClient, int64_t key);
+static lscp_status_t _lscp_handlers_sync (lscp_client_t *pClient,
+	lscp_event_t event);
+
+static void _lscp_scene_clear (lscp_client_t *pClient);
+
+static int _lscp_response_load (lscp_response_t *pResponse, const char *pszText);
 
 
 //-------------------------------------------------------------------------
-// General helper functions.
+// Event service (datagram oriented).
 
-struct _locale_t {
-	char numeric[32+1];
-	char ctype[32+1];
-};
+// Whether there are (un)subscription replies still due.
+static int _lscp_client_evt_pending ( lscp_client_t *pClient )
+{
+	lscp_evt_reply_t *pReply = &(pClient->evt_reply);
+	int iPending;
+
+	lscp_mutex_lock(pReply->mutex);
+	iPending = (pReply->received < pReply->expected);
+	lscp_mutex_unlock(pReply->mutex);
+
+	return iPending;
+}
+
+
+// Hand over an event to the delivery queue, if any; returns zero
+// when there's none, meaning direct callback delivery.
+static int _lscp_client_evt_queue ( lscp_client_t *pClient,
+	lscp_event_t event, const char *pszToken, int cchToken )
+{
+	lscp_event_queue_t *pQueue;
+	int iPush, iWait;
+
+	// Keep the queue from being swapped away meanwhile...
+	pClient->evt_queue_busy = 1;
+	_lscp_atomic_barrier();
+
+	pQueue = pClient->evt_queue;
+	if (pQueue) {
+		// Wait for room, if so asked, while the queue is still current,
+		// but no longer than the client timeout nor while (un)subscription
+		// replies are due, as those are only read by this very thread...
+		iWait = 0;
+		while ((iPush = lscp_event_queue_push(pQueue,
+				event, pszToken, cchToken)) < 0) {
+			if (!pClient->evt.iState || pClient->evt_queue != pQueue)
+				break;
+			if (iWait >= pClient->iTimeout || _lscp_client_evt_pending(pClient)) {
+				pQueue->drops++;
+				break;
+			}
+			_lscp_client_yield();
+			iWait++;
+		}
+		if (iPush > 0)
+			(*pQueue->pfnReady)(pClient, pQueue->pvReady);
+	}
+
+	_lscp_atomic_barrier();
+	pClient->evt_queue_busy = 0;
+
+	return (pQueue != NULL);
+}
+
+
+// Dispatch an event to the registered handlers, if any, then to the
+// client callback, if subscribed by the client itself (event data may
+// be given as already decoded, otherwise only decoded if needed).
+static lscp_status_t _lscp_client_evt_dispatch ( lscp_client_t *pClient,
+	lscp_event_t event, const char *pszToken, int cchToken,
+	const lscp_event_data_t *pEventData )
+{
+	lscp_event_data_t evdata;
+	lscp_client_event_proc_t pfnEventCallback;
+	void *pvEventData;
+	unsigned int seq;
+	lscp_status_t ret = LSCP_OK;
 
-// we need to ensure a constant locale setting e.g. for parsing
-// floating point numbers with atof(), as the floating point separator
-// character varies by the invidual locale settings
-static void _save_and_set_c_locale(struct _locale_t* locale)
+	// Read a consistent callback and data pair, lock-free...
+	do {
+		while ((seq = pClient->event_seq) & 1)
+			;
+		_lscp_atomic_barrier();
+		pfnEventCallback = pClient->pfnEventCallback;
+		pvEventData = pClient->pvEventData;
+		_lscp_atomic_barrier();
+	} while (seq != pClient->event_seq);
+
+	if (pEventData == NULL
+		&& ((pClient->handlers.registered & event)
+			|| (pfnEventCallback && (pClient->events & event)))) {
+		lscp_event_data_decode(&evdata, event,
+			pszToken, cchToken,
+			&(pClient->event_fill),
+			&(pClient->event_fill_size));
+		pEventData = &evdata;
+	}
+
+	// Route to the handlers of this event (and channel/device)...
+	if (pClient->handlers.registered & event) {
+		ret = lscp_handler_table_dispatch(&(pClient->handlers),
+			pClient, pEventData);
+	}
+
+	if (ret != LSCP_OK || (pClient->events & event) == 0)
+		return ret;
+
+	// Already taken by the MIDI events fast path, if so...
+	if ((event & LSCP_MIDI_EVENTS) && pClient->pfnMidiCallback)
+		return ret;
+
+	if (pfnEventCallback) {
+		// Invoke the typed event callback...
+		ret = (*pfnEventCallback)(
+			pClient,
+			pEventData,
+			pvEventData);
+	} else {
+		// Invoke the client event callback...
+		ret = (*pClient->pfnCallback)(
+			pClient,
+			event,
+			pszToken,
+			cchToken,
+			pClient->pvData);
+	}
+
+	return ret;
+}
+
+
+// Deliver a subscribed event, either queued or dispatched
+// right away (event data may be given as already decoded).
+static void _lscp_client_evt_deliver ( lscp_client_t *pClient,
+	lscp_event_t event, const char *pszToken, int cchToken,
+	const lscp_event_data_t *pEventData )
 {
-	locale->numeric[32] = locale->ctype[32] = 0;
-	strncpy(locale->numeric, setlocale(LC_NUMERIC, NULL), 32);
-	strncpy(locale->ctype, setlocale(LC_CTYPE, NULL), 32);
-	setlocale(LC_NUMERIC, "C");
-	setlocale(LC_CTYPE, "C");
+	if (_lscp_client_evt_queue(pClient, event, pszToken, cchToken))
+		return;
+
+	if (_lscp_client_evt_dispatch(pClient, event,
+			pszToken, cchToken, pEventData) != LSCP_OK)
+		pClient->evt.iState = 0;
 }
 
-// restore the original locale setting as nothing happened
-static void _restore_locale(struct _locale_t* locale)
+
+// Match an (un)subscription reply to its request, in order.
+static void _lscp_client_evt_reply ( lscp_client_t *pClient, char *pszLine )
 {
-	setlocale(LC_NUMERIC, locale->numeric);
-	setlocale(LC_CTYPE, locale->ctype);
+	lscp_evt_reply_t *pReply = &(pClient->evt_reply);
+	char *pszResult;
+	int iErrno;
+
+	lscp_status_t ret;
+
+	lscp_mutex_lock(pReply->mutex);
+
+	if (pReply->received < pReply->expected) {
+		ret = lscp_client_frame_result(pszLine, strlen(pszLine), 0,
+			&pszResult, &iErrno);
+		if (ret == LSCP_ERROR && !pReply->failed) {
+			pReply->failed = 1;
+			pReply->errnum = iErrno;
+			pReply->result[0] = (char) 0;
+			if (pszResult) {
+				strncpy(pReply->result, pszResult, sizeof(pReply->result) - 1);
+				pReply->result[sizeof(pReply->result) - 1] = (char) 0;
+			}
+		}
+		pReply->status[pReply->received++] = ret;
+		if (pReply->received >= pReply->expected)
+			lscp_cond_signal(pReply->cond);
+	}
+
+	lscp_mutex_unlock(pReply->mutex);
 }
 
-// seems the standard atof() function doesnt care much about locale
-// runtime modifications, so we use this workaround
-static float _atof(const char* txt) {
-	float f;
-	sscanf(txt, "%f", &f); // yeah, you're a good boy sscanf()
-	return f;
+
+// Give up on (un)subscription replies still due, if any.
+static void _lscp_client_evt_timeout ( lscp_client_t *pClient )
+{
+	lscp_evt_reply_t *pReply = &(pClient->evt_reply);
+
+	lscp_mutex_lock(pReply->mutex);
+
+	if (pReply->received < pReply->expected) {
+		pReply->timeout = 1;
+		lscp_cond_signal(pReply->cond);
+	}
+
+	lscp_mutex_unlock(pReply->mutex);
 }
 
 
-//-------------------------------------------------------------------------
-// Event service (datagram oriented).
+// Take a MIDI event notification into the batch, if subscribed by the
+// client; returns whether there's nothing else to do about it.
+static int _lscp_client_evt_midi ( lscp_client_t *pClient,
+	const char *pszLine )
+{
+	lscp_midi_batch_t *pBatch = &(pClient->midi_batch);
+	lscp_event_t event;
+
+	event = lscp_midi_event_decode(&(pBatch->events[pBatch->count]), pszLine);
+	if (event == LSCP_EVENT_NONE)
+		return 0;
+
+	if (pClient->events & event) {
+		if (++(pBatch->count) >= LSCP_MIDI_BATCH)
+			_lscp_client_evt_midi_flush(pClient);
+	}
+
+	// Registered handlers are still served as usual...
+	return ((pClient->handlers.registered & event) == 0);
+}
+
+
+// Deliver all MIDI events batched so far.
+static void _lscp_client_evt_midi_flush ( lscp_client_t *pClient )
+{
+	lscp_midi_batch_t *pBatch = &(pClient->midi_batch);
+	lscp_client_midi_proc_t pfnMidiCallback;
+
+	if (pBatch->count < 1)
+		return;
+
+	pfnMidiCallback = pClient->pfnMidiCallback;
+	if (pfnMidiCallback && (*pfnMidiCallback)(
+			pClient,
+			pBatch->events,
+			pBatch->count,
+			pClient->pvMidiData) != LSCP_OK)
+		pClient->evt.iState = 0;
+
+	pBatch->count = 0;
+}
+
+
+// Handle a single event notification line.
+static void _lscp_client_evt_line ( lscp_client_t *pClient, char *pszLine )
+{
+	const char *pszSeps = ":";
+	char  *pszToken;
+	char  *pch;
+	int    cchToken;
+
+	lscp_event_t event;
+	lscp_event_data_t evdata;
+	int iDecoded;
+	lscp_telemetry_alert_t alerts[LSCP_TELEMETRY_ALERTS];
+	int iAlerts;
+
+	// Anything but notifications may only be replies
+	// to pipelined (un)subscriptions, in order...
+	if (strncasecmp(pszLine, "NOTIFY:", 7) != 0) {
+		if ((strncasecmp(pszLine, "OK", 2) == 0
+				&& (pszLine[2] == '\0' || pszLine[2] == '['))
+			|| strncasecmp(pszLine, "ERR:", 4) == 0
+			|| strncasecmp(pszLine, "WRN:", 4) == 0
+			|| strncasecmp(pszLine, "WRN[", 4) == 0)
+			_lscp_client_evt_reply(pClient, pszLine);
+		return;
+	}
+
+	// MIDI events fast path, straight into the batch...
+	if (pClient->pfnMidiCallback && _lscp_client_evt_midi(pClient, pszLine))
+		return;
+
+	// Anything else comes after the MIDI events batched so far...
+	_lscp_client_evt_midi_flush(pClient);
+
+	// Parse for the notification event message...
+	pch = pszLine;
+	pszToken = lscp_strtok(NULL, pszSeps, &(pch)); // Have "NOTIFY"
+	if (pszToken == NULL || strcasecmp(pszToken, "NOTIFY") != 0)
+		return;
+	pszToken = lscp_strtok(NULL, pszSeps, &(pch));
+	event    = lscp_event_from_text(pszToken);
+	if (event == LSCP_EVENT_NONE)
+		return;
+	// And pick the rest of the line as data...
+	pszToken = (*pch ? pch : NULL);
+	cchToken = (pszToken == NULL ? 0 : strlen(pszToken));
+	// Keep the channel info cache coherent...
+	if (pClient->channel_cache.events & event)
+		_lscp_channel_cache_event(pClient, event, pszToken);
+	// Keep the live meters up-to-date...
+	iDecoded = 0;
+	if (pClient->meters.events & event) {
+		lscp_event_data_decode(&evdata, event,
+			pszToken, cchToken,
+			&(pClient->event_fill),
+			&(pClient->event_fill_size));
+		lscp_meter_table_update(&(pClient->meters), &evdata);
+		iDecoded = 1;
+	}
+	// Keep the telemetry time-series recorded...
+	if (pClient->telemetry.events & event) {
+		if (!iDecoded) {
+			lscp_event_data_decode(&evdata, event,
+				pszToken, cchToken,
+				&(pClient->event_fill),
+				&(pClient->event_fill_size));
+			iDecoded = 1;
+		}
+		iAlerts = lscp_telemetry_update(
+			&(pClient->telemetry), &evdata, alerts);
+		if (iAlerts > 0)
+			lscp_telemetry_notify(pClient, alerts, iAlerts);
+	}
+	// Keep the device topology mirror coherent...
+	if (pClient->device_mirror.events & event)
+		lscp_device_mirror_event(&(pClient->device_mirror), event, pszToken);
+	// Keep the MIDI instrument map mirror coherent...
+	if (pClient->midi_mirror.events & event)
+		lscp_midi_mirror_event(&(pClient->midi_mirror), event, pszToken);
+	// Double-check if we're really up to it...
+	if ((pClient->events | pClient->handlers.registered) & event) {
+		// Keep just the newest, if conflated...
+		if ((pClient->evt_conflate.events & event)
+			&& lscp_conflate_event(&(pClient->evt_conflate),
+				event, pszToken, cchToken) == 0)
+			return;
+		_lscp_client_evt_deliver(pClient, event, pszToken, cchToken,
+			iDecoded ? &evdata : NULL);
+	}
+}
+
+
+// Deliver all conflated events that are due.
+static void _lscp_client_evt_flush ( lscp_client_t *pClient )
+{
+	lscp_conflate_item_t *pItem;
+
+	while (pClient->evt.iState
+		&& (pItem = lscp_conflate_take(&(pClient->evt_conflate))) != NULL) {
+		if ((pClient->events | pClient->handlers.registered) & pItem->event) {
+			_lscp_client_evt_deliver(pClient, pItem->event,
+				pItem->text, pItem->text_len, NULL);
+		}
+	}
+}
+
 
 static void _lscp_client_evt_proc ( void *pvClient )
 {
@@ -98,15 +480,12 @@ static void _lscp_client_evt_proc ( void *pvClient )
 	struct timeval tv;                  // For specifying a timeout value.
 	int    iSelect;                     // Holds select return status.
 	int    iTimeout;
+	int    iDue;
 
-	char   achBuffer[LSCP_BUFSIZ];
+	lscp_framer_t *pFramer = &(pClient->evt_framer);
+	char  *pchBuffer;
 	int    cchBuffer;
-	const char *pszSeps = ":\r\n";
-	char  *pszToken;
-	char  *pch;
-	int    cchToken;
-
-	lscp_event_t event;
+	char  *pszLine;
 
 #ifdef CONFIG_DEBUG
 	fprintf(stderr, "_lscp_client_evt_proc: Client waiting for events.\n");
@@ -120,8 +499,14 @@ static void _lscp_client_evt_proc ( void *pvClient )
 		FD_SET((unsigned int) fd, &fds);
 		fdmax = fd;
 
-		// Use the timeout (x10) select feature ...
+		// Use the timeout (x10) select feature, just for the
+		// sake of polling the state; (un)subscription replies
+		// are timed out by whoever waits on them, regardless...
 		iTimeout = 10 * pClient->iTimeout;
+		// ...unless conflated events are due earlier.
+		iDue = lscp_conflate_due(&(pClient->evt_conflate));
+		if (iDue >= 0 && iDue < iTimeout)
+			iTimeout = iDue;
 		if (iTimeout >= 1000) {
 			tv.tv_sec = iTimeout / 1000;
 			iTimeout -= tv.tv_sec * 1000;
@@ -132,35 +517,19 @@ static void _lscp_client_evt_proc ( void *pvClient )
 		// Wait for event...
 		iSelect = select(fdmax + 1, &fds, NULL, NULL, &tv);
 		if (iSelect > 0 && FD_ISSET(fd, &fds)) {
-			// May recv now...
-			cchBuffer = recv(pClient->evt.sock, achBuffer, sizeof(achBuffer), 0);
-			if (cchBuffer > 0) {
-				// Make sure received buffer it's null terminated.
-				achBuffer[cchBuffer] = (char) 0;
-				pch = achBuffer;
-				do {
-					// Parse for the notification event message...
-					pszToken = lscp_strtok(NULL, pszSeps, &(pch)); // Have "NOTIFY"
-					if (strcasecmp(pszToken, "NOTIFY") == 0) {
-						pszToken = lscp_strtok(NULL, pszSeps, &(pch));
-						event    = lscp_event_from_text(pszToken);
-						// And pick the rest of data...
-						pszToken = lscp_strtok(NULL, pszSeps, &(pch));
-						cchToken = (pszToken == NULL ? 0 : strlen(pszToken));
-						// Double-check if we're really up to it...
-						if (pClient->events & event) {
-							// Invoke the client event callback...
-							if ((*pClient->pfnCallback)(
-									pClient,
-									event,
-									pszToken,
-									cchToken,
-									pClient->pvData) != LSCP_OK) {
-								pClient->evt.iState = 0;
-							}
-						}
-					}
-				} while (*pch);
+			// May recv now, in bulk, past any pending partial line...
+			pchBuffer = lscp_framer_space(pFramer, &cchBuffer);
+			if (pchBuffer == NULL) {
+				fprintf(stderr, "_lscp_client_evt_proc: out of memory.\n");
+				pClient->evt.iState = 0;
+				pClient->iErrno = -ENOMEM;
+			}
+			else if ((cchBuffer = recv(pClient->evt.sock, pchBuffer, cchBuffer, 0)) > 0) {
+				lscp_framer_commit(pFramer, cchBuffer);
+				// Handle each and every complete line, exactly once...
+				while (pClient->evt.iState
+					&& (pszLine = lscp_framer_line(pFramer)) != NULL)
+					_lscp_client_evt_line(pClient, pszLine);
 			} else {
 				lscp_socket_perror("_lscp_client_evt_proc: recv");
 				pClient->evt.iState = 0;
@@ -173,10 +542,19 @@ static void _lscp_client_evt_proc ( void *pvClient )
 			pClient->iErrno = -errno;
 		}
 
+		// Deliver the MIDI events batched on this round...
+		_lscp_client_evt_midi_flush(pClient);
+
+		// Deliver the latest of conflated events, if due...
+		_lscp_client_evt_flush(pClient);
+
 		// Finally, always signal the event.
 		lscp_cond_signal(pClient->cond);
 	}
 
+	// No more replies to wait for.
+	_lscp_client_evt_timeout(pClient);
+
 #ifdef CONFIG_DEBUG
 	fprintf(stderr, "_lscp_client_evt_proc: Client closing.\n");
 #endif
@@ -227,154 +605,602 @@ static lscp_status_t _lscp_client_evt_connect ( lscp_client_t *pClient )
 	// Set our socket agent struct...
 	lscp_socket_agent_init(&(pClient->evt), sock, &addr, cAddr);
 
+	// Nothing pending from any previous connection...
+	lscp_framer_free(&(pClient->evt_framer));
+	pClient->midi_batch.count = 0;
+
 	// And finally the service thread...
 	return lscp_socket_agent_start(&(pClient->evt), _lscp_client_evt_proc, pClient, 0);
 }
 
 
-// Subscribe to a single event.
-static lscp_status_t _lscp_client_evt_request ( lscp_client_t *pClient,
-	int iSubscribe, lscp_event_t event )
+// Split an event mask into single events, in (un)subscription order;
+// returns how many (unknown "upper" events are left out).
+static int _lscp_client_evt_split ( lscp_event_t events, lscp_event_t *pEvents )
+{
+	static const lscp_event_t flags[] = {
+		LSCP_EVENT_CHANNEL_COUNT,
+		LSCP_EVENT_VOICE_COUNT,
+		LSCP_EVENT_STREAM_COUNT,
+		LSCP_EVENT_BUFFER_FILL,
+		LSCP_EVENT_CHANNEL_INFO,
+		LSCP_EVENT_TOTAL_VOICE_COUNT,
+		LSCP_EVENT_AUDIO_OUTPUT_DEVICE_COUNT,
+		LSCP_EVENT_AUDIO_OUTPUT_DEVICE_INFO,
+		LSCP_EVENT_MIDI_INPUT_DEVICE_COUNT,
+		LSCP_EVENT_MIDI_INPUT_DEVICE_INFO,
+		LSCP_EVENT_MIDI_INSTRUMENT_MAP_COUNT,
+		LSCP_EVENT_MIDI_INSTRUMENT_MAP_INFO,
+		LSCP_EVENT_MIDI_INSTRUMENT_COUNT,
+		LSCP_EVENT_MIDI_INSTRUMENT_INFO,
+		LSCP_EVENT_MISCELLANEOUS
+	};
+
+	lscp_event_t currentEvent;
+	int i, iEvents = 0;
+
+	for (i = 0; i < (int) (sizeof(flags) / sizeof(flags[0])); i++) {
+		if (events & flags[i])
+			pEvents[iEvents++] = flags[i];
+	}
+
+	// Caution: for the upper 16 bits, we don't use bit flags anymore ...
+	currentEvent = events & 0xffff0000;
+	if (currentEvent == LSCP_EVENT_CHANNEL_MIDI
+		|| currentEvent == LSCP_EVENT_DEVICE_MIDI)
+		pEvents[iEvents++] = currentEvent;
+
+	return iEvents;
+}
+
+
+// Monotonic clock, for (un)subscription reply timeouts (msecs).
+static int _lscp_client_evt_clock (void)
+{
+#if defined(WIN32)
+	return (int) GetTickCount();
+#else
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return (int) ((unsigned int) ts.tv_sec * 1000u
+		+ (unsigned int) (ts.tv_nsec / 1000000));
+#endif
+}
+
+
+// Wait for some reply, until so many msecs since start; returns
+// non-zero when timed out (reply mutex is assumed locked).
+static int _lscp_client_evt_wait ( lscp_evt_reply_t *pReply,
+	int iTimeout, int iStart )
+{
+	int iRemain = iTimeout - (_lscp_client_evt_clock() - iStart);
+
+	if (iRemain <= 0)
+		return 1;
+
+#if defined(WIN32)
+	lscp_mutex_unlock(pReply->mutex);
+	WaitForSingleObject(pReply->cond, (DWORD) iRemain);
+	lscp_mutex_lock(pReply->mutex);
+#else
+	{
+		struct timespec ts;
+		clock_gettime(CLOCK_REALTIME, &ts);
+		ts.tv_sec  += iRemain / 1000;
+		ts.tv_nsec += (long) (iRemain % 1000) * 1000000L;
+		if (ts.tv_nsec >= 1000000000L) {
+			ts.tv_sec++;
+			ts.tv_nsec -= 1000000000L;
+		}
+		pthread_cond_timedwait(&(pReply->cond), &(pReply->mutex), &ts);
+	}
+#endif
+
+	return (iTimeout - (_lscp_client_evt_clock() - iStart) <= 0);
+}
+
+
+// Send event (un)subscription commands, all pipelined in one go,
+// and wait for their replies; each reply status is given on pStatus.
+static lscp_status_t _lscp_client_evt_send ( lscp_client_t *pClient,
+	int iSubscribe, const lscp_event_t *pEvents, int iEvents,
+	lscp_status_t *pStatus )
 {
+	lscp_evt_reply_t *pReply = &(pClient->evt_reply);
 	const char *pszEvent;
-	char  szQuery[LSCP_BUFSIZ];
-	int   cchQuery;
+	char  achQuery[LSCP_EVT_REPLIES * 48];
+	int   cchQuery = 0;
+	int   iStart;
+	int   i;
 
-	if (pClient == NULL)
-		return LSCP_FAILED;
+	lscp_status_t ret = LSCP_OK;
 
-	// Which (single) event?
-	pszEvent = lscp_event_to_text(event);
-	if (pszEvent == NULL)
+	if (iEvents < 1)
+		return ret;
+	if (iEvents > LSCP_EVT_REPLIES)
 		return LSCP_FAILED;
 
+	for (i = 0; i < iEvents; i++)
+		pStatus[i] = LSCP_FAILED;
+
 	// Build the query string...
-	cchQuery = sprintf(szQuery, "%sSUBSCRIBE %s\n\n",
-		(iSubscribe == 0 ? "UN" : ""), pszEvent);
-	// Just send data, forget result...
-	if (send(pClient->evt.sock, szQuery, cchQuery, 0) < cchQuery) {
-		lscp_socket_perror("_lscp_client_evt_request: send");
-		return LSCP_FAILED;
+	for (i = 0; i < iEvents; i++) {
+		pszEvent = lscp_event_to_text(pEvents[i]);
+		if (pszEvent == NULL)
+			return LSCP_FAILED;
+		cchQuery += sprintf(&achQuery[cchQuery], "%sSUBSCRIBE %s\r\n",
+			(iSubscribe == 0 ? "UN" : ""), pszEvent);
 	}
 
-	// Wait on response.
-	lscp_cond_wait(pClient->cond, pClient->mutex);
+	// Expect as many replies...
+	lscp_mutex_lock(pReply->mutex);
+	pReply->expected = iEvents;
+	pReply->received = 0;
+	pReply->timeout  = 0;
+	pReply->failed   = 0;
+	lscp_mutex_unlock(pReply->mutex);
+
+	// Just send it all at once...
+	iStart = _lscp_client_evt_clock();
+	if (send(pClient->evt.sock, achQuery, cchQuery, 0) < cchQuery) {
+		lscp_socket_perror("_lscp_client_evt_send: send");
+		ret = LSCP_FAILED;
+	}
 
-	// Update as naively as we can...
-	if (iSubscribe)
-		pClient->events |=  event;
-	else
-		pClient->events &= ~event;
+	// Wait on all responses, as matched by the event service,
+	// but no longer than the client timeout...
+	lscp_mutex_lock(pReply->mutex);
+	while (ret == LSCP_OK
+		&& pReply->received < pReply->expected
+		&& !pReply->timeout && pClient->evt.iState) {
+		if (_lscp_client_evt_wait(pReply, pClient->iTimeout, iStart) != 0
+			&& pReply->received < pReply->expected)
+			pReply->timeout = 1;
+	}
+	for (i = 0; i < pReply->received; i++)
+		pStatus[i] = pReply->status[i];
+	if (ret == LSCP_OK && pReply->received < pReply->expected)
+		ret = (pReply->timeout ? LSCP_TIMEOUT : LSCP_FAILED);
+	if (pReply->failed)
+		lscp_client_set_result(pClient, pReply->result, pReply->errnum);
+	// Any late replies are to be ignored.
+	pReply->expected = 0;
+	pReply->received = 0;
+	lscp_mutex_unlock(pReply->mutex);
 
-	return LSCP_OK;
+	return ret;
 }
 
 
-//-------------------------------------------------------------------------
-// Client versioning teller fuunction.
+// (Un)subscribe events on behalf of the client itself; the subscribed
+// events mask is only changed for the ones that went through.
+static lscp_status_t _lscp_client_evt_request ( lscp_client_t *pClient,
+	int iSubscribe, lscp_event_t events )
+{
+	lscp_event_t requests[LSCP_EVT_REPLIES];
+	lscp_event_t sends[LSCP_EVT_REPLIES] = { LSCP_EVENT_NONE };
+	lscp_status_t status[LSCP_EVT_REPLIES];
+	lscp_event_t internal, event;
+	int iRequests, iSends, i, j;
 
+	lscp_status_t ret;
 
-/** Retrieve the current client library version string. */
-const char* lscp_client_package (void) { return LSCP_PACKAGE; }
+	if (pClient == NULL)
+		return LSCP_FAILED;
 
-/** Retrieve the current client library version string. */
-const char* lscp_client_version (void) { return LSCP_VERSION; }
+	// Events the channel info cache, live meters or mirrors
+	// depend on are kept subscribed to the server anyway...
+	internal  = _lscp_client_evt_internal(pClient);
+	iRequests = _lscp_client_evt_split(events, requests);
+	for (i = iSends = 0; i < iRequests; i++) {
+		if ((internal & requests[i]) == 0)
+			sends[iSends++] = requests[i];
+	}
 
-/** Retrieve the current client library build string. */
-const char* lscp_client_build   (void) { return LSCP_BUILD; }
+	ret = _lscp_client_evt_send(pClient, iSubscribe, sends, iSends, status);
 
+	for (i = j = 0; i < iRequests; i++) {
+		event = requests[i];
+		if ((internal & event) == 0) {
+			if (status[j] != LSCP_OK && status[j] != LSCP_WARNING) {
+				if (ret == LSCP_OK)
+					ret = status[j];
+				j++;
+				continue;
+			}
+			j++;
+		}
+		if (iSubscribe)
+			pClient->events |=  event;
+		else
+			pClient->events &= ~event;
+	}
 
-//-------------------------------------------------------------------------
-// Client socket functions.
+	return ret;
+}
 
-/**
- *  Create a client instance, estabilishing a connection to a server hostname,
- *  which must be listening on the given port. A client callback function is
- *  also supplied for server notification event handling.
- *
- *  @param pszHost      Hostname of the linuxsampler listening server.
- *  @param iPort        Port number of the linuxsampler listening server.
- *  @param pfnCallback  Callback function to receive event notifications.
- *  @param pvData       User context opaque data, that will be passed
- *                      to the callback function.
- *
- *  @returns The new client instance pointer if successfull, which shall be
- *  used on all subsequent client calls, NULL otherwise.
- */
-lscp_client_t* lscp_client_create ( const char *pszHost, int iPort,
-	lscp_client_proc_t pfnCallback, void *pvData )
+
+// Events subscribed internally, on behalf of the client caches and mirrors.
+static lscp_event_t _lscp_client_evt_internal ( lscp_client_t *pClient )
 {
-	lscp_client_t  *pClient;
-#if defined(USE_GETADDRINFO)
-	char szPort[33];
-	struct addrinfo hints;
-	struct addrinfo *result, *res;
-#else
-	struct hostent *pHost;
-	struct sockaddr_in addr;
-	int cAddr;
-#endif	/* !USE_GETADDRINFO */
-	lscp_socket_t sock;
-#if defined(WIN32)
-	int iSockOpt = (-1);
-#endif
+	return (pClient->channel_cache.events
+		| pClient->meters.events
+		| pClient->telemetry.events
+		| pClient->device_mirror.events
+		| pClient->midi_mirror.events
+		| pClient->handlers.events);
+}
 
-	if (pfnCallback == NULL) {
-		fprintf(stderr, "lscp_client_create: Invalid client callback function.\n");
-		return NULL;
-	}
 
-#if defined(USE_GETADDRINFO)
+// (Un)subscribe the events some internal facility depends on,
+// whichever are not already subscribed by the client or other ones.
+static lscp_status_t _lscp_client_evt_depend ( lscp_client_t *pClient,
+	lscp_event_t *pDepends, const lscp_event_t *pEvents, int iEvents,
+	int iSubscribe )
+{
+	lscp_event_t sends[LSCP_EVT_REPLIES] = { LSCP_EVENT_NONE };
+	lscp_status_t status[LSCP_EVT_REPLIES];
+	lscp_event_t events, event;
+	int iSends, i;
 
-	// Convert port number to string/name...
-	snprintf(szPort, sizeof(szPort), "%d", iPort);
+	lscp_status_t ret;
 
-	// Obtain address(es) matching host/port...
-	memset(&hints, 0, sizeof(struct addrinfo));
-	hints.ai_family = AF_INET;
-	hints.ai_socktype = SOCK_STREAM;
+	if (iEvents > LSCP_EVT_REPLIES)
+		return LSCP_FAILED;
 
-	result = NULL;
+	// Let go of them first, so to tell who else still needs them...
+	if (!iSubscribe) {
+		for (i = 0; i < iEvents; i++)
+			*pDepends &= ~pEvents[i];
+	}
 
-	if (getaddrinfo(pszHost, szPort, &hints, &result)) {
-		lscp_socket_herror("lscp_client_create: getaddrinfo");
-		return NULL;
+	events = (pClient->events | _lscp_client_evt_internal(pClient));
+	for (i = iSends = 0; i < iEvents; i++) {
+		event = pEvents[i];
+		if ((events & event) == 0)
+			sends[iSends++] = event;
+		else if (iSubscribe)
+			*pDepends |= event;
 	}
 
-#else
+	ret = _lscp_client_evt_send(pClient, iSubscribe, sends, iSends, status);
 
-	// Obtain host matching name...
-	pHost = gethostbyname(pszHost);
-	if (pHost == NULL) {
-		lscp_socket_herror("lscp_client_create: gethostbyname");
-		return NULL;
+	for (i = 0; iSubscribe && i < iSends; i++) {
+		if (status[i] == LSCP_OK || status[i] == LSCP_WARNING)
+			*pDepends |= sends[i];
+		else if (ret == LSCP_OK)
+			ret = status[i];
 	}
 
-#endif	/* !USE_GETADDRINFO */
+	return ret;
+}
 
-	// Allocate client descriptor...
 
-	pClient = (lscp_client_t *) malloc(sizeof(lscp_client_t));
-	if (pClient == NULL) {
-		fprintf(stderr, "lscp_client_create: Out of memory.\n");
-		return NULL;
-	}
-	memset(pClient, 0, sizeof(lscp_client_t));
+// Turn some internal facility on or off, along with the events it
+// depends on, starting or closing the alternate connection as due;
+// it's left off whenever those can't be all subscribed.
+static lscp_status_t _lscp_client_evt_enable ( lscp_client_t *pClient,
+	int *piEnabled, lscp_event_t *pDepends, lscp_event_t events,
+	int iEnable )
+{
+	lscp_event_t split[LSCP_EVT_REPLIES];
+	int iEvents;
 
-	pClient->pfnCallback = pfnCallback;
-	pClient->pvData = pvData;
+	lscp_status_t ret = LSCP_OK;
 
-#ifdef CONFIG_DEBUG
-	fprintf(stderr,
-		"lscp_client_create: pClient=%p: pszHost=%s iPort=%d.\n",
-		 pClient, pszHost, iPort);
-#endif
+	iEvents = _lscp_client_evt_split(events, split);
 
-	// Prepare the command connection socket...
+	if (iEnable && !*piEnabled) {
+		// If applicable, start the alternate connection...
+		if ((pClient->events | _lscp_client_evt_internal(pClient)) == LSCP_EVENT_NONE)
+			ret = _lscp_client_evt_connect(pClient);
+		if (ret == LSCP_OK)
+			ret = _lscp_client_evt_depend(pClient, pDepends, split, iEvents, 1);
+		if (ret == LSCP_OK)
+			*piEnabled = 1;
+	}
 
-#if defined(USE_GETADDRINFO)
+	if (!iEnable || ret != LSCP_OK) {
+		*piEnabled = 0;
+		_lscp_client_evt_depend(pClient, pDepends, split, iEvents, 0);
+		// If necessary, close the alternate connection...
+		if ((pClient->events | _lscp_client_evt_internal(pClient)) == LSCP_EVENT_NONE)
+			lscp_socket_agent_free(&(pClient->evt));
+	}
 
-	// getaddrinfo() returns a list of address structures;
+	return ret;
+}
+
+
+//-------------------------------------------------------------------------
+// Coherent channel info cache helpers.
+
+// Invalidate cached items on behalf of server notifications
+// (called from the event service thread).
+static void _lscp_channel_cache_event ( lscp_client_t *pClient,
+	lscp_event_t event, const char *pszData )
+{
+	int iSamplerChannel = -1;
+
+	// Channels added or removed (CHANNEL_COUNT) makes
+	// the whole lot suspect; otherwise just the one.
+	if (event == LSCP_EVENT_CHANNEL_INFO && pszData)
+		iSamplerChannel = lscp_atoi(pszData);
+
+	_lscp_channel_cache_invalidate(pClient, iSamplerChannel);
+}
+
+
+// Invalidate one cached item, or all of them if iSamplerChannel < 0.
+static void _lscp_channel_cache_invalidate ( lscp_client_t *pClient,
+	int iSamplerChannel )
+{
+	if (pClient == NULL || !pClient->channel_cache.enabled)
+		return;
+
+	// Lock this section up.
+	lscp_mutex_lock(pClient->channel_cache.mutex);
+
+	lscp_channel_cache_invalidate(&(pClient->channel_cache), iSamplerChannel);
+
+	// Unlock this section down.
+	lscp_mutex_unlock(pClient->channel_cache.mutex);
+}
+
+
+// Get hold of a valid cached item for write-through, leaving the
+// cache locked on success; caller must _lscp_channel_cache_unlock().
+static lscp_channel_info_t *_lscp_channel_cache_lock ( lscp_client_t *pClient,
+	int iSamplerChannel )
+{
+	lscp_channel_cache_item_t *pItem;
+
+	if (pClient == NULL || !pClient->channel_cache.enabled)
+		return NULL;
+
+	lscp_mutex_lock(pClient->channel_cache.mutex);
+
+	pItem = (lscp_channel_cache_item_t *)
+		lscp_hash_find(&(pClient->channel_cache.items), iSamplerChannel);
+	if (pItem && pItem->valid)
+		return &(pItem->info);
+
+	lscp_mutex_unlock(pClient->channel_cache.mutex);
+
+	return NULL;
+}
+
+
+static void _lscp_channel_cache_unlock ( lscp_client_t *pClient )
+{
+	lscp_mutex_unlock(pClient->channel_cache.mutex);
+}
+
+
+// Get sampler channel info through the cache, only going to the
+// server when not already valid; the cached item is copied out while
+// locked, as notifications may void it anytime (caller owns client mutex).
+static lscp_status_t _lscp_channel_cache_get ( lscp_client_t *pClient,
+	lscp_channel_info_t *pChannelInfo, int iSamplerChannel )
+{
+	lscp_channel_cache_t *pCache = &(pClient->channel_cache);
+	lscp_channel_cache_item_t *pItem;
+	lscp_channel_info_t info;
+
+	// Lock this section up.
+	lscp_mutex_lock(pCache->mutex);
+
+	pItem = (lscp_channel_cache_item_t *)
+		lscp_hash_find(&(pCache->items), iSamplerChannel);
+	if (pItem == NULL) {
+		pItem = (lscp_channel_cache_item_t *)
+			malloc(sizeof(lscp_channel_cache_item_t));
+		if (pItem == NULL) {
+			lscp_mutex_unlock(pCache->mutex);
+			return LSCP_FAILED;
+		}
+		lscp_channel_info_init(&(pItem->info));
+		pItem->valid = 0;
+		pItem->dirty = 0;
+		lscp_hash_insert(&(pCache->items), iSamplerChannel, pItem);
+	}
+
+	// Served locally, as long as notifications are still flowing...
+	if (pItem->valid && pClient->evt.iState) {
+		lscp_channel_info_copy(pClient->intern, pChannelInfo, &(pItem->info));
+		lscp_mutex_unlock(pCache->mutex);
+		return LSCP_OK;
+	}
+
+	// Any notification from now on shall void this refresh.
+	pItem->dirty = 0;
+
+	// Unlock this section down.
+	lscp_mutex_unlock(pCache->mutex);
+
+	lscp_channel_info_init(&info);
+	if (_lscp_channel_info_query(pClient, &info, iSamplerChannel) == LSCP_OK) {
+		lscp_mutex_lock(pCache->mutex);
+		lscp_channel_info_free(&(pItem->info));
+		pItem->info  = info;
+		pItem->valid = !pItem->dirty;
+		lscp_channel_info_copy(pClient->intern, pChannelInfo, &(pItem->info));
+		lscp_mutex_unlock(pCache->mutex);
+		return LSCP_OK;
+	}
+	lscp_channel_info_free(&info);
+
+	// Most probably a stale channel; forget about it.
+	lscp_mutex_lock(pCache->mutex);
+	lscp_hash_remove(&(pCache->items), iSamplerChannel);
+	lscp_mutex_unlock(pCache->mutex);
+
+	lscp_channel_info_free(&(pItem->info));
+	free(pItem);
+
+	return LSCP_FAILED;
+}
+
+
+//-------------------------------------------------------------------------
+// MIDI instrument map mirror helpers.
+
+// Mark some of the MIDI instrument map mirror as stale,
+// on behalf of our own changes to it.
+static void _lscp_midi_mirror_touch ( lscp_client_t *pClient, int64_t key )
+{
+	if (pClient->midi_mirror.enabled)
+		lscp_midi_mirror_stale(&(pClient->midi_mirror), key);
+}
+
+
+//-------------------------------------------------------------------------
+// Event handler registry helpers.
+
+// (Un)subscribe an event on behalf of the registered handlers, whether
+// there's any left for it or not (caller holds the client mutex).
+static lscp_status_t _lscp_handlers_sync ( lscp_client_t *pClient,
+	lscp_event_t event )
+{
+	int iSubscribe, iEnabled;
+
+	iSubscribe = (lscp_handler_table_count(&(pClient->handlers), event) > 0);
+	iEnabled = ((pClient->handlers.events & event) != 0);
+	if (iSubscribe == iEnabled)
+		return LSCP_OK;
+
+	return _lscp_client_evt_enable(pClient, &iEnabled,
+		&(pClient->handlers.events), event, iSubscribe);
+}
+
+
+//-------------------------------------------------------------------------
+// Client versioning teller fuunction.
+
+
+/** Retrieve the current client library version string. */
+const char* lscp_client_package (void) { return LSCP_PACKAGE; }
+
+/** Retrieve the current client library version string. */
+const char* lscp_client_version (void) { return LSCP_VERSION; }
+
+/** Retrieve the current client library build string. */
+const char* lscp_client_build   (void) { return LSCP_BUILD; }
+
+
+//-------------------------------------------------------------------------
+// Client socket functions.
+
+/**
+ *  Create a client instance, estabilishing a connection to a server hostname,
+ *  which must be listening on the given port. A client callback function is
+ *  also supplied for server notification event handling.
+ *
+ *  @param pszHost      Hostname of the linuxsampler listening server.
+ *  @param iPort        Port number of the linuxsampler listening server.
+ *  @param pfnCallback  Callback function to receive event notifications.
+ *  @param pvData       User context opaque data, that will be passed
+ *                      to the callback function.
+ *
+ *  @returns The new client instance pointer if successfull, which shall be
+ *  used on all subsequent client calls, NULL otherwise.
+ */
+lscp_client_t* lscp_client_create ( const char *pszHost, int iPort,
+	lscp_client_proc_t pfnCallback, void *pvData )
+{
+	lscp_client_t  *pClient;
+#if defined(USE_GETADDRINFO)
+	char szPort[33];
+	struct addrinfo hints;
+	struct addrinfo *result, *res;
+#else
+	struct hostent *pHost;
+	struct sockaddr_in addr;
+	int cAddr;
+#endif	/* !USE_GETADDRINFO */
+	lscp_socket_t sock;
+#if defined(WIN32)
+	int iSockOpt = (-1);
+#endif
+
+	if (pfnCallback == NULL) {
+		fprintf(stderr, "lscp_client_create: Invalid client callback function.\n");
+		return NULL;
+	}
+
+#if defined(USE_GETADDRINFO)
+
+	// Convert port number to string/name...
+	snprintf(szPort, sizeof(szPort), "%d", iPort);
+
+	// Obtain address(es) matching host/port...
+	memset(&hints, 0, sizeof(struct addrinfo));
+	hints.ai_family = AF_INET;
+	hints.ai_socktype = SOCK_STREAM;
+
+	result = NULL;
+
+	if (getaddrinfo(pszHost, szPort, &hints, &result)) {
+		lscp_socket_herror("lscp_client_create: getaddrinfo");
+		return NULL;
+	}
+
+#else
+
+	// Obtain host matching name...
+	pHost = gethostbyname(pszHost);
+	if (pHost == NULL) {
+		lscp_socket_herror("lscp_client_create: gethostbyname");
+		return NULL;
+	}
+
+#endif	/* !USE_GETADDRINFO */
+
+	// Allocate client descriptor...
+
+	pClient = (lscp_client_t *) malloc(sizeof(lscp_client_t));
+	if (pClient == NULL) {
+		fprintf(stderr, "lscp_client_create: Out of memory.\n");
+		return NULL;
+	}
+	memset(pClient, 0, sizeof(lscp_client_t));
+
+	pClient->pfnCallback = pfnCallback;
+	pClient->pvData = pvData;
+	pClient->pfnEventCallback = NULL;
+	pClient->pvEventData = NULL;
+	pClient->event_seq = 0;
+	pClient->event_fill = NULL;
+	pClient->event_fill_size = 0;
+	lscp_framer_init(&(pClient->evt_framer));
+	pClient->evt_queue = NULL;
+	pClient->evt_queue_busy = 0;
+	lscp_mutex_init(pClient->evt_queue_mutex);
+	lscp_conflate_init(&(pClient->evt_conflate));
+	pClient->evt_reply.expected = 0;
+	pClient->evt_reply.received = 0;
+	pClient->evt_reply.timeout = 0;
+	pClient->evt_reply.failed = 0;
+	lscp_mutex_init(pClient->evt_reply.mutex);
+	lscp_cond_init(pClient->evt_reply.cond);
+	lscp_handler_table_init(&(pClient->handlers));
+	pClient->pfnMidiCallback = NULL;
+	pClient->pvMidiData = NULL;
+	pClient->midi_batch.count = 0;
+
+#ifdef CONFIG_DEBUG
+	fprintf(stderr,
+		"lscp_client_create: pClient=%p: pszHost=%s iPort=%d.\n",
+		 pClient, pszHost, iPort);
+#endif
+
+	// Prepare the command connection socket...
+
+#if defined(USE_GETADDRINFO)
+
+	// getaddrinfo() returns a list of address structures;
 	// try each address until we successfully connect(2);
 	// if socket or connect fails, we close the socket and
 	// try the next address...
@@ -465,6 +1291,13 @@ lscp_client_t* lscp_client_create ( const char *pszHost, int iPort,
 	lscp_socket_agent_init(&(pClient->evt), INVALID_SOCKET, NULL, 0);
 	// No events subscribed, yet.
 	pClient->events = LSCP_EVENT_NONE;
+	// Shared string intern pool.
+	pClient->intern = lscp_intern_pool_create();
+	if (pClient->intern == NULL) {
+		lscp_socket_agent_free(&(pClient->cmd));
+		free(pClient);
+		return NULL;
+	}
 	// Initialize cached members.
 	pClient->audio_drivers = NULL;
 	pClient->midi_drivers = NULL;
@@ -476,19 +1309,26 @@ lscp_client_t* lscp_client_create ( const char *pszHost, int iPort,
 	pClient->midi_instruments = NULL;
 	pClient->midi_maps = NULL;
 	pClient->midi_map_name = NULL;
-	lscp_driver_info_init(&(pClient->audio_driver_info));
-	lscp_driver_info_init(&(pClient->midi_driver_info));
 	lscp_device_info_init(&(pClient->audio_device_info));
 	lscp_device_info_init(&(pClient->midi_device_info));
-	lscp_param_info_init(&(pClient->audio_param_info));
-	lscp_param_info_init(&(pClient->midi_param_info));
 	lscp_device_port_info_init(&(pClient->audio_channel_info));
 	lscp_device_port_info_init(&(pClient->midi_port_info));
 	lscp_param_info_init(&(pClient->audio_channel_param_info));
 	lscp_param_info_init(&(pClient->midi_port_param_info));
 	lscp_server_info_init(&(pClient->server_info));
-	lscp_engine_info_init(&(pClient->engine_info));
 	lscp_channel_info_init(&(pClient->channel_info));
+	lscp_channel_lazy_init(&(pClient->channel_lazy));
+	lscp_channel_cache_init(&(pClient->channel_cache));
+	lscp_channel_store_init(&(pClient->channel_store));
+	lscp_meter_table_init(&(pClient->meters));
+	lscp_telemetry_init(&(pClient->telemetry));
+	lscp_device_mirror_init(&(pClient->device_mirror));
+	lscp_midi_mirror_init(&(pClient->midi_mirror));
+	lscp_hash_init(&(pClient->metadata));
+	pClient->warm_version = NULL;
+	pClient->scene_commands = NULL;
+	pClient->scene_count = 0;
+	pClient->scene_size = 0;
 	lscp_fxsend_info_init(&(pClient->fxsend_info));
 	lscp_midi_instrument_info_init(&(pClient->midi_instrument_info));
 	// Initialize error stuff.
@@ -496,6 +1336,7 @@ lscp_client_t* lscp_client_create ( const char *pszHost, int iPort,
 	pClient->iErrno = -1;
 	// Stream usage stuff.
 	pClient->buffer_fill = NULL;
+	pClient->buffer_fill_size = 0;
 	pClient->iStreamCount = 0;
 	// Default timeout value.
 	pClient->iTimeout = LSCP_TIMEOUT_MSECS;
@@ -551,21 +1392,27 @@ lscp_status_t lscp_client_destroy ( lscp_client_t *pClient )
 	lscp_mutex_lock(pClient->mutex);
 
 	// Free up all cached members.
+	lscp_metadata_flush(pClient);
+	if (pClient->warm_version)
+		free(pClient->warm_version);
+	pClient->warm_version = NULL;
+	_lscp_scene_clear(pClient);
+	if (pClient->scene_commands)
+		free(pClient->scene_commands);
+	pClient->scene_commands = NULL;
+	pClient->scene_size = 0;
 	lscp_midi_instrument_info_free(&(pClient->midi_instrument_info));
 	lscp_fxsend_info_free(&(pClient->fxsend_info));
+	lscp_channel_lazy_free(&(pClient->channel_lazy));
 	lscp_channel_info_free(&(pClient->channel_info));
-	lscp_engine_info_free(&(pClient->engine_info));
+	lscp_channel_store_free(&(pClient->channel_store));
 	lscp_server_info_free(&(pClient->server_info));
 	lscp_param_info_free(&(pClient->midi_port_param_info));
 	lscp_param_info_free(&(pClient->audio_channel_param_info));
 	lscp_device_port_info_free(&(pClient->midi_port_info));
 	lscp_device_port_info_free(&(pClient->audio_channel_info));
-	lscp_param_info_free(&(pClient->midi_param_info));
-	lscp_param_info_free(&(pClient->audio_param_info));
 	lscp_device_info_free(&(pClient->midi_device_info));
 	lscp_device_info_free(&(pClient->audio_device_info));
-	lscp_driver_info_free(&(pClient->midi_driver_info));
-	lscp_driver_info_free(&(pClient->audio_driver_info));
 	// Free available engine table.
 	lscp_szsplit_destroy(pClient->audio_drivers);
 	lscp_szsplit_destroy(pClient->midi_drivers);
@@ -595,6 +1442,7 @@ lscp_status_t lscp_client_destroy ( lscp_client_t *pClient )
 	if (pClient->buffer_fill)
 		free(pClient->buffer_fill);
 	pClient->buffer_fill = NULL;
+	pClient->buffer_fill_size = 0;
 	pClient->iStreamCount = 0;
 	pClient->iTimeout = 0;
 
@@ -602,6 +1450,30 @@ lscp_status_t lscp_client_destroy ( lscp_client_t *pClient )
 	lscp_socket_agent_free(&(pClient->evt));
 	lscp_socket_agent_free(&(pClient->cmd));
 
+	// Free decoded event stuff (event thread is now gone).
+	if (pClient->event_fill)
+		free(pClient->event_fill);
+	pClient->event_fill = NULL;
+	pClient->event_fill_size = 0;
+	lscp_framer_free(&(pClient->evt_framer));
+	lscp_event_queue_destroy(pClient->evt_queue);
+	pClient->evt_queue = NULL;
+	lscp_mutex_destroy(pClient->evt_queue_mutex);
+	lscp_conflate_free(&(pClient->evt_conflate));
+	lscp_mutex_destroy(pClient->evt_reply.mutex);
+	lscp_cond_destroy(pClient->evt_reply.cond);
+	lscp_handler_table_free(&(pClient->handlers));
+	// Free the channel info cache (likewise).
+	lscp_channel_cache_free(&(pClient->channel_cache));
+	lscp_meter_table_free(&(pClient->meters));
+	lscp_telemetry_free(&(pClient->telemetry));
+	lscp_device_mirror_free(&(pClient->device_mirror));
+	lscp_midi_mirror_free(&(pClient->midi_mirror));
+	// Drop the intern pool (all cached strings are gone by now,
+	// but the ones still referenced from outstanding snapshots).
+	lscp_intern_pool_release(pClient->intern);
+	pClient->intern = NULL;
+
 	// Last but not least, free good ol'transaction mutex.
 	lscp_mutex_unlock(pClient->mutex);
 	lscp_mutex_destroy(pClient->mutex);
@@ -649,1540 +1521,1720 @@ int lscp_client_get_timeout ( lscp_client_t *pClient )
 }
 
 /**
- *  Check whether connection to server is lost.
+ *  Set an optional decoded event callback. When set, event notifications
+ *  are parsed once by the library and delivered as a typed structure
+ *  (see @ref lscp_event_data_t) in place of the raw text callback given
+ *  on client creation. Decoded data is only valid during the callback.
+ *  May be called while events are flowing: the callback and its data
+ *  are always handed over as one consistent pair.
  *
- *  @param pClient  Pointer to client instance structure.
+ *  @param pClient          Pointer to client instance structure.
+ *  @param pfnEventCallback Decoded event callback function, or NULL
+ *                          to revert to the raw text callback.
+ *  @param pvData           User context opaque data, that will be passed
+ *                          to the decoded event callback function.
  *
- *  @returns @c true if client lost connection to server, @c false otherwise.
+ *  @returns LSCP_OK on success, LSCP_FAILED otherwise.
  */
-bool lscp_client_connection_lost ( lscp_client_t *pClient )
+lscp_status_t lscp_client_set_event_callback ( lscp_client_t *pClient,
+	lscp_client_event_proc_t pfnEventCallback, void *pvData )
 {
-    int err = lscp_client_get_errno(pClient);
-    if (err >= 0) return false;
-    return err == -EPIPE || err == -ECONNRESET || err == -ECONNABORTED;
-}
+	if (pClient == NULL)
+		return LSCP_FAILED;
 
+	// Lock this section up.
+	lscp_mutex_lock(pClient->mutex);
+
+	// Odd sequence: the event thread shall retry...
+	pClient->event_seq++;
+	_lscp_atomic_barrier();
+	pClient->pfnEventCallback = pfnEventCallback;
+	pClient->pvEventData = pvData;
+	// Even sequence: consistent again.
+	_lscp_atomic_barrier();
+	pClient->event_seq++;
+
+	// Unlock this section down.
+	lscp_mutex_unlock(pClient->mutex);
+
+	return LSCP_OK;
+}
 
-//-------------------------------------------------------------------------
-// Client common protocol functions.
 
 /**
- *  Submit a command query line string to the server. The query string
- *  must be cr/lf and null terminated. Besides the return code, the
- *  specific server response to the command request is made available
- *  by the @ref lscp_client_get_result and @ref lscp_client_get_errno
- *  function calls.
+ *  Set up queued event delivery. When enabled, the event service
+ *  thread no longer invokes the (raw or decoded) event callback
+ *  itself: it just decodes each subscribed event notification into
+ *  a lock-free single producer, single consumer queue, that is left
+ *  for the application to drain, see @ref lscp_client_drain_events,
+ *  from whichever (one) thread of its choice. Any events still queued
+ *  when the queue gets replaced or disabled are discarded.
+ *
+ *  The event service thread is also the one reading (un)subscription
+ *  replies, so when holding on a full queue it only waits for as long
+ *  as the client timeout, and not at all while (un)subscription replies
+ *  are due, dropping the event instead. Still, the draining thread
+ *  should not (un)subscribe events (that includes enabling or disabling
+ *  any of the caches, meters, mirrors or event handlers) while the
+ *  queue is full and being held on, or it will stall until then.
  *
  *  @param pClient      Pointer to client instance structure.
- *  @param pszQuery     Command request line to be sent to server,
- *                      must be cr/lf and null terminated.
+ *  @param iCapacity    Queue capacity in events (rounded up to a power
+ *                      of two), or zero to revert to direct delivery.
+ *  @param policy       What to do when the queue is full: either drop
+ *                      the newest events (@ref lscp_client_get_event_drops)
+ *                      or hold the event service until there's room
+ *                      (within the client timeout, then dropping).
+ *  @param pfnReady     Optional callback, invoked from the event service
+ *                      thread when events get queued, but only once
+ *                      until the next drain (eg. to wake up the consumer).
+ *  @param pvData       User context opaque data, that will be passed
+ *                      to the ready callback function.
  *
  *  @returns LSCP_OK on success, LSCP_FAILED otherwise.
  */
-lscp_status_t lscp_client_query ( lscp_client_t *pClient, const char *pszQuery )
+lscp_status_t lscp_client_set_event_queue ( lscp_client_t *pClient,
+	int iCapacity, lscp_queue_policy_t policy,
+	lscp_client_ready_proc_t pfnReady, void *pvData )
 {
-	lscp_status_t ret;
+	lscp_event_queue_t *pQueue = NULL;
+	lscp_event_queue_t *pOldQueue;
 
-	if (pClient == NULL)
+	if (pClient == NULL || iCapacity < 0)
 		return LSCP_FAILED;
 
-	// Lock this section up.
-	lscp_mutex_lock(pClient->mutex);
+	if (iCapacity > 0) {
+		pQueue = lscp_event_queue_create(iCapacity, policy, pfnReady, pvData);
+		if (pQueue == NULL)
+			return LSCP_FAILED;
+	}
 
-	// Just make the now guarded call.
-	ret = lscp_client_call(pClient, pszQuery, 0);
+	// Lock this section up (no draining meanwhile).
+	lscp_mutex_lock(pClient->evt_queue_mutex);
+
+	pOldQueue = pClient->evt_queue;
+	pClient->evt_queue = pQueue;
+	_lscp_atomic_barrier();
+
+	// Wait for the event service to let go of the old one...
+	while (pClient->evt_queue_busy)
+		_lscp_client_yield();
 
 	// Unlock this section down.
-	lscp_mutex_unlock(pClient->mutex);
+	lscp_mutex_unlock(pClient->evt_queue_mutex);
 
-	return ret;
+	lscp_event_queue_destroy(pOldQueue);
+
+	return LSCP_OK;
 }
 
+
 /**
- *  Get the last received result string. In case of error or warning,
- *  this is the text of the error or warning message issued.
+ *  Get the queued event delivery capacity.
  *
  *  @param pClient  Pointer to client instance structure.
  *
- *  @returns A pointer to the literal null-terminated result string as
- *  of the last command request.
+ *  @returns The event queue capacity, zero if events are delivered
+ *  directly, -1 in case of failure.
  */
-const char *lscp_client_get_result ( lscp_client_t *pClient )
+int lscp_client_get_event_queue ( lscp_client_t *pClient )
 {
+	int iCapacity = 0;
+
 	if (pClient == NULL)
-		return NULL;
+		return -1;
 
-	return pClient->pszResult;
+	// Lock this section up.
+	lscp_mutex_lock(pClient->evt_queue_mutex);
+
+	if (pClient->evt_queue)
+		iCapacity = (int) pClient->evt_queue->mask + 1;
+
+	// Unlock this section down.
+	lscp_mutex_unlock(pClient->evt_queue_mutex);
+
+	return iCapacity;
 }
 
 
 /**
- *  Get the last error/warning number received.
+ *  Drain queued events, invoking the event callback (either decoded
+ *  or raw) on the calling thread, in notification order. Only one
+ *  thread may drain at a time; the event callback must not change
+ *  the event queue setup (@ref lscp_client_set_event_queue).
  *
- *  @param pClient  Pointer to client instance structure.
+ *  @param pClient      Pointer to client instance structure.
+ *  @param iMaxEvents   Maximum number of events to deliver in this
+ *                      batch, or zero for all those queued so far.
  *
- *  @returns The numerical value of the last error or warning
- *  response code received.
+ *  @returns The number of events delivered, -1 in case of failure
+ *  (eg. queued event delivery is not enabled).
  */
-int lscp_client_get_errno ( lscp_client_t *pClient )
+int lscp_client_drain_events ( lscp_client_t *pClient, int iMaxEvents )
 {
-	if (pClient == NULL)
+	lscp_event_queue_t *pQueue;
+	lscp_event_slot_t *pSlot;
+	lscp_status_t ret;
+	int iEvents = 0;
+
+	if (pClient == NULL || iMaxEvents < 0)
 		return -1;
 
-	return pClient->iErrno;
-}
+	// Lock this section up.
+	lscp_mutex_lock(pClient->evt_queue_mutex);
 
+	pQueue = pClient->evt_queue;
+	if (pQueue == NULL) {
+		lscp_mutex_unlock(pClient->evt_queue_mutex);
+		return -1;
+	}
+
+	// Any events queued from now on shall signal ready again...
+	lscp_event_queue_arm(pQueue);
+
+	if (iMaxEvents == 0)
+		iMaxEvents = (int) (pQueue->tail - pQueue->head);
+
+	while (iEvents < iMaxEvents
+		&& (pSlot = lscp_event_queue_front(pQueue)) != NULL) {
+		ret = _lscp_client_evt_dispatch(pClient,
+			pSlot->data.event,
+			pSlot->data.text,
+			pSlot->data.text_len,
+			&(pSlot->data));
+		lscp_event_queue_pop(pQueue);
+		++iEvents;
+		// Same as if called from the event service...
+		if (ret != LSCP_OK) {
+			pClient->evt.iState = 0;
+			break;
+		}
+	}
+
+	// Unlock this section down.
+	lscp_mutex_unlock(pClient->evt_queue_mutex);
+
+	return iEvents;
+}
 
-//-------------------------------------------------------------------------
-// Client registration protocol functions.
 
 /**
- *  Register frontend for receiving event messages by the sampler backend.
- *  @e Caution: since liblscp v0.5.5.4 you have to call lscp_client_subscribe()
- *  for @e each event you want to subscribe. That is the old bitflag approach
- *  was abondoned at this point. You can however still register all older
- *  events with one lscp_client_subscribe() call at once. Thus, the old
- *  behavior of this functions was not broken. Those older events are namely:
- *  @code
- *  SUBSCRIBE CHANNEL_COUNT | VOICE_COUNT | STREAM_COUNT
- *      | BUFFER_FILL | CHANNEL_INFO | TOTAL_VOICE_COUNT
- *      | AUDIO_OUTPUT_DEVICE_COUNT | AUDIO_OUTPUT_DEVICE_INFO
- *      | MIDI_INPUT_DEVICE_COUNT | MIDI_INPUT_DEVICE_INFO
- *      | MIDI_INSTRUMENT_MAP_COUNT | MIDI_INSTRUMENT_MAP_INFO
- *      | MIDI_INSTRUMENT_COUNT | MIDI_INSTRUMENT_INFO
- *      | MISCELLANEOUS
- *  @endcode
- *  The old events occupy the lower 16 bits (as bit flags), and all younger
- *  events enumerate the whole upper 16 bits range. The new, enumerated
- *  events are namely:
- *  @code
- *  SUBSCRIBE CHANNEL_MIDI
- *  @endcode
+ *  Get the number of events dropped for a full event queue, since
+ *  queued event delivery was last set up.
  *
  *  @param pClient  Pointer to client instance structure.
- *  @param events   LSCP event to subscribe.
  *
- *  @returns LSCP_OK on success, LSCP_FAILED otherwise.
+ *  @returns The number of dropped events.
  */
-lscp_status_t lscp_client_subscribe ( lscp_client_t *pClient, lscp_event_t events )
+unsigned long lscp_client_get_event_drops ( lscp_client_t *pClient )
 {
-	lscp_status_t ret = LSCP_OK;
-	lscp_event_t currentEvent;
+	unsigned long iDrops = 0;
 
 	if (pClient == NULL)
-		return LSCP_FAILED;
+		return 0;
 
 	// Lock this section up.
-	lscp_mutex_lock(pClient->mutex);
-
-	// If applicable, start the alternate connection...
-	if (pClient->events == LSCP_EVENT_NONE)
-		ret = _lscp_client_evt_connect(pClient);
+	lscp_mutex_lock(pClient->evt_queue_mutex);
 
-	// Send the subscription commands.
-	if (ret == LSCP_OK && (events & LSCP_EVENT_CHANNEL_COUNT))
-		ret = _lscp_client_evt_request(pClient, 1, LSCP_EVENT_CHANNEL_COUNT);
-	if (ret == LSCP_OK && (events & LSCP_EVENT_VOICE_COUNT))
-		ret = _lscp_client_evt_request(pClient, 1, LSCP_EVENT_VOICE_COUNT);
-	if (ret == LSCP_OK && (events & LSCP_EVENT_STREAM_COUNT))
-		ret = _lscp_client_evt_request(pClient, 1, LSCP_EVENT_STREAM_COUNT);
-	if (ret == LSCP_OK && (events & LSCP_EVENT_BUFFER_FILL))
-		ret = _lscp_client_evt_request(pClient, 1, LSCP_EVENT_BUFFER_FILL);
-	if (ret == LSCP_OK && (events & LSCP_EVENT_CHANNEL_INFO))
-		ret = _lscp_client_evt_request(pClient, 1, LSCP_EVENT_CHANNEL_INFO);
-	if (ret == LSCP_OK && (events & LSCP_EVENT_TOTAL_VOICE_COUNT))
-		ret = _lscp_client_evt_request(pClient, 1, LSCP_EVENT_TOTAL_VOICE_COUNT);
-	if (ret == LSCP_OK && (events & LSCP_EVENT_AUDIO_OUTPUT_DEVICE_COUNT))
-		ret = _lscp_client_evt_request(pClient, 1, LSCP_EVENT_AUDIO_OUTPUT_DEVICE_COUNT);
-	if (ret == LSCP_OK && (events & LSCP_EVENT_AUDIO_OUTPUT_DEVICE_INFO))
-		ret = _lscp_client_evt_request(pClient, 1, LSCP_EVENT_AUDIO_OUTPUT_DEVICE_INFO);
-	if (ret == LSCP_OK && (events & LSCP_EVENT_MIDI_INPUT_DEVICE_COUNT))
-		ret = _lscp_client_evt_request(pClient, 1, LSCP_EVENT_MIDI_INPUT_DEVICE_COUNT);
-	if (ret == LSCP_OK && (events & LSCP_EVENT_MIDI_INPUT_DEVICE_INFO))
-		ret = _lscp_client_evt_request(pClient, 1, LSCP_EVENT_MIDI_INPUT_DEVICE_INFO);
-	if (ret == LSCP_OK && (events & LSCP_EVENT_MIDI_INSTRUMENT_MAP_COUNT))
-		ret = _lscp_client_evt_request(pClient, 1, LSCP_EVENT_MIDI_INSTRUMENT_MAP_COUNT);
-	if (ret == LSCP_OK && (events & LSCP_EVENT_MIDI_INSTRUMENT_MAP_INFO))
-		ret = _lscp_client_evt_request(pClient, 1, LSCP_EVENT_MIDI_INSTRUMENT_MAP_INFO);
-	if (ret == LSCP_OK && (events & LSCP_EVENT_MIDI_INSTRUMENT_COUNT))
-		ret = _lscp_client_evt_request(pClient, 1, LSCP_EVENT_MIDI_INSTRUMENT_COUNT);
-	if (ret == LSCP_OK && (events & LSCP_EVENT_MIDI_INSTRUMENT_INFO))
-		ret = _lscp_client_evt_request(pClient, 1, LSCP_EVENT_MIDI_INSTRUMENT_INFO);
-	if (ret == LSCP_OK && (events & LSCP_EVENT_MISCELLANEOUS))
-		ret = _lscp_client_evt_request(pClient, 1, LSCP_EVENT_MISCELLANEOUS);
-	// Caution: for the upper 16 bits, we don't use bit flags anymore ...
-	currentEvent = events & 0xffff0000;
-	if (ret == LSCP_OK && currentEvent) {
-		switch (currentEvent) {
-			case LSCP_EVENT_CHANNEL_MIDI:
-			case LSCP_EVENT_DEVICE_MIDI:
-				ret = _lscp_client_evt_request(pClient, 1, currentEvent);
-				break;
-			default: // unknown "upper" event type
-				ret = LSCP_FAILED;
-				break;
-		}
-	}
+	if (pClient->evt_queue)
+		iDrops = pClient->evt_queue->drops;
 
 	// Unlock this section down.
-	lscp_mutex_unlock(pClient->mutex);
+	lscp_mutex_unlock(pClient->evt_queue_mutex);
 
-	return ret;
+	return iDrops;
 }
 
 
 /**
- *  Deregister frontend from receiving UDP event messages anymore.
- *  @e Caution: since liblscp v0.5.5.4 you have to call
- *  lscp_client_unsubscribe() for @e each event you want to unsubscribe.
- *  That is the old bitflag approach was abondoned at this point. You can
- *  however still register all older events with one lscp_client_subscribe()
- *  call at once. Thus, the old behavior of this functions was not broken.
- *  Those older events are namely:
- *  @code
- *  UNSUBSCRIBE CHANNEL_COUNT | VOICE_COUNT | STREAM_COUNT
- *      | BUFFER_FILL | CHANNEL_INFO | TOTAL_VOICE_COUNT
- *      | AUDIO_OUTPUT_DEVICE_COUNT | AUDIO_OUTPUT_DEVICE_INFO
- *      | MIDI_INPUT_DEVICE_COUNT | MIDI_INPUT_DEVICE_INFO
- *      | MIDI_INSTRUMENT_MAP_COUNT | MIDI_INSTRUMENT_MAP_INFO
- *      | MIDI_INSTRUMENT_COUNT | MIDI_INSTRUMENT_INFO
- *      | MISCELLANEOUS
- *  @endcode
- *  The old events occupy the lower 16 bits (as bit flags), and all younger
- *  events enumerate the whole upper 16 bits range. The new, enumerated
- *  events are namely:
- *  @code
- *  UNSUBSCRIBE CHANNEL_MIDI
- *  @endcode
+ *  Set event conflation. Conflated events are not delivered one by one
+ *  as notified: only the newest of each event type and sampler channel
+ *  is kept, and all of those are delivered together at most once every
+ *  given interval. Only level events (VOICE_COUNT, STREAM_COUNT,
+ *  BUFFER_FILL and TOTAL_VOICE_COUNT) may be conflated; any other
+ *  (structural) events are always delivered as notified.
  *
- *  @param pClient  Pointer to client instance structure.
- *  @param events   LSCP event to unsubscribe.
+ *  @param pClient      Pointer to client instance structure.
+ *  @param events       Bit-wise OR'ed event flags to conflate,
+ *                      or LSCP_EVENT_NONE to deliver them all.
+ *  @param iInterval    Minimum delivery interval in milliseconds,
+ *                      or zero to deliver them all.
  *
  *  @returns LSCP_OK on success, LSCP_FAILED otherwise.
  */
-lscp_status_t lscp_client_unsubscribe ( lscp_client_t *pClient, lscp_event_t events )
+lscp_status_t lscp_client_set_event_conflation ( lscp_client_t *pClient,
+	lscp_event_t events, int iInterval )
 {
-	lscp_status_t ret = LSCP_OK;
-	lscp_event_t currentEvent;
-
-	if (pClient == NULL)
+	if (pClient == NULL || iInterval < 0 || iInterval > LSCP_CONFLATE_MAX)
 		return LSCP_FAILED;
 
+	events &= LSCP_CONFLATE_EVENTS;
+	if (iInterval == 0)
+		events = LSCP_EVENT_NONE;
+	if (events == LSCP_EVENT_NONE)
+		iInterval = 0;
+
 	// Lock this section up.
 	lscp_mutex_lock(pClient->mutex);
 
-	// Send the unsubscription commands.
-	if (ret == LSCP_OK && (events & LSCP_EVENT_CHANNEL_COUNT))
-		ret = _lscp_client_evt_request(pClient, 0, LSCP_EVENT_CHANNEL_COUNT);
-	if (ret == LSCP_OK && (events & LSCP_EVENT_VOICE_COUNT))
-		ret = _lscp_client_evt_request(pClient, 0, LSCP_EVENT_VOICE_COUNT);
-	if (ret == LSCP_OK && (events & LSCP_EVENT_STREAM_COUNT))
-		ret = _lscp_client_evt_request(pClient, 0, LSCP_EVENT_STREAM_COUNT);
-	if (ret == LSCP_OK && (events & LSCP_EVENT_BUFFER_FILL))
-		ret = _lscp_client_evt_request(pClient, 0, LSCP_EVENT_BUFFER_FILL);
-	if (ret == LSCP_OK && (events & LSCP_EVENT_CHANNEL_INFO))
-		ret = _lscp_client_evt_request(pClient, 0, LSCP_EVENT_CHANNEL_INFO);
-	if (ret == LSCP_OK && (events & LSCP_EVENT_TOTAL_VOICE_COUNT))
-		ret = _lscp_client_evt_request(pClient, 0, LSCP_EVENT_TOTAL_VOICE_COUNT);
-	if (ret == LSCP_OK && (events & LSCP_EVENT_AUDIO_OUTPUT_DEVICE_COUNT))
-		ret = _lscp_client_evt_request(pClient, 0, LSCP_EVENT_AUDIO_OUTPUT_DEVICE_COUNT);
-	if (ret == LSCP_OK && (events & LSCP_EVENT_AUDIO_OUTPUT_DEVICE_INFO))
-		ret = _lscp_client_evt_request(pClient, 0, LSCP_EVENT_AUDIO_OUTPUT_DEVICE_INFO);
-	if (ret == LSCP_OK && (events & LSCP_EVENT_MIDI_INPUT_DEVICE_COUNT))
-		ret = _lscp_client_evt_request(pClient, 0, LSCP_EVENT_MIDI_INPUT_DEVICE_COUNT);
-	if (ret == LSCP_OK && (events & LSCP_EVENT_MIDI_INPUT_DEVICE_INFO))
-		ret = _lscp_client_evt_request(pClient, 0, LSCP_EVENT_MIDI_INPUT_DEVICE_INFO);
-	if (ret == LSCP_OK && (events & LSCP_EVENT_MIDI_INSTRUMENT_MAP_COUNT))
-		ret = _lscp_client_evt_request(pClient, 0, LSCP_EVENT_MIDI_INSTRUMENT_MAP_COUNT);
-	if (ret == LSCP_OK && (events & LSCP_EVENT_MIDI_INSTRUMENT_MAP_INFO))
-		ret = _lscp_client_evt_request(pClient, 0, LSCP_EVENT_MIDI_INSTRUMENT_MAP_INFO);
-	if (ret == LSCP_OK && (events & LSCP_EVENT_MIDI_INSTRUMENT_COUNT))
-		ret = _lscp_client_evt_request(pClient, 0, LSCP_EVENT_MIDI_INSTRUMENT_COUNT);
-	if (ret == LSCP_OK && (events & LSCP_EVENT_MIDI_INSTRUMENT_INFO))
-		ret = _lscp_client_evt_request(pClient, 0, LSCP_EVENT_MIDI_INSTRUMENT_INFO);
-	if (ret == LSCP_OK && (events & LSCP_EVENT_MISCELLANEOUS))
-		ret = _lscp_client_evt_request(pClient, 0, LSCP_EVENT_MISCELLANEOUS);
-	// Caution: for the upper 16 bits, we don't use bit flags anymore ...
-	currentEvent = events & 0xffff0000;
-	if (ret == LSCP_OK && currentEvent) {
-		switch (currentEvent) {
-			case LSCP_EVENT_CHANNEL_MIDI:
-			case LSCP_EVENT_DEVICE_MIDI:
-				ret = _lscp_client_evt_request(pClient, 0, currentEvent);
-				break;
-			default: // unknown "upper" event type
-				ret = LSCP_FAILED;
-				break;
-		}
-	}
-
-	// If necessary, close the alternate connection...
-	if (pClient->events == LSCP_EVENT_NONE)
-		lscp_socket_agent_free(&(pClient->evt));
+	// Anything still pending gets flushed when due, as usual...
+	pClient->evt_conflate.interval = iInterval;
+	pClient->evt_conflate.events = events;
 
 	// Unlock this section down.
 	lscp_mutex_unlock(pClient->mutex);
 
-	return ret;
+	return LSCP_OK;
 }
 
 
 /**
- *  Getting current subscribed events.
+ *  Get the current event conflation setting.
  *
- *  @param pClient  Pointer to client instance structure.
+ *  @param pClient      Pointer to client instance structure.
+ *  @param piInterval   Optional pointer to get the delivery interval
+ *                      in milliseconds.
  *
- *  @returns The current subscrived bit-wise OR'ed event flags.
+ *  @returns The bit-wise OR'ed event flags being conflated.
  */
-lscp_event_t lscp_client_get_events ( lscp_client_t *pClient )
+lscp_event_t lscp_client_get_event_conflation ( lscp_client_t *pClient,
+	int *piInterval )
 {
+	lscp_event_t events;
+
 	if (pClient == NULL)
 		return LSCP_EVENT_NONE;
 
-	return pClient->events;
-}
+	// Lock this section up.
+	lscp_mutex_lock(pClient->mutex);
 
+	events = pClient->evt_conflate.events;
+	if (piInterval)
+		*piInterval = pClient->evt_conflate.interval;
+
+	// Unlock this section down.
+	lscp_mutex_unlock(pClient->mutex);
+
+	return events;
+}
 
-//-------------------------------------------------------------------------
-// Client command protocol functions.
 
 /**
- *  Loading an instrument:
- *  LOAD INSTRUMENT <filename> <instr-index> <sampler-channel>
+ *  Register an event handler, on its own, to be invoked with the decoded
+ *  data of every notification of the given event type, optionally just
+ *  the ones about a given sampler channel, device (audio output or MIDI
+ *  input) or MIDI instrument map. Several handlers may be registered
+ *  for the same key, being invoked in order of registration, after the
+ *  ones registered for a given sampler channel, device or map if any.
+ *  The event gets subscribed internally while there are handlers for
+ *  it, regardless of @ref lscp_client_subscribe, and the client event
+ *  callback is still only invoked for events subscribed by the client.
+ *  Handlers are invoked from the event service thread, or from the
+ *  draining one if queued event delivery is enabled, without any lock
+ *  held, so these may register or unregister handlers, themselves
+ *  included; one unregistered from another thread meanwhile may still
+ *  be running, but is not invoked anew.
  *
- *  @param pClient          Pointer to client instance structure.
- *  @param pszFileName      Instrument file name.
- *  @param iInstrIndex      Instrument index number.
- *  @param iSamplerChannel  Sampler Channel.
+ *  @param pClient      Pointer to client instance structure.
+ *  @param event        LSCP event (a single one) to handle.
+ *  @param iId          Sampler channel, device or map number to handle
+ *                      the event for, or -1 for any.
+ *  @param pfnHandler   Decoded event handler function.
+ *  @param pvData       User context opaque data, that will be passed
+ *                      to the handler function.
  *
- *  @returns LSCP_OK on success, LSCP_FAILED otherwise.
+ *  @returns The handler registration handle (a positive number),
+ *  -1 in case of failure.
  */
-lscp_status_t lscp_load_instrument ( lscp_client_t *pClient,
-	const char *pszFileName, int iInstrIndex, int iSamplerChannel )
+int lscp_client_add_event_handler ( lscp_client_t *pClient,
+	lscp_event_t event, int iId, lscp_client_event_proc_t pfnHandler,
+	void *pvData )
 {
-	char szQuery[LSCP_BUFSIZ];
+	lscp_status_t ret;
+	int iHandle;
 
-	if (pszFileName == NULL || iSamplerChannel < 0)
-		return LSCP_FAILED;
+	if (pClient == NULL || lscp_event_to_text(event) == NULL)
+		return -1;
 
-	sprintf(szQuery, "LOAD INSTRUMENT '%s' %d %d\r\n",
-		pszFileName, iInstrIndex, iSamplerChannel);
-	return lscp_client_query(pClient, szQuery);
+	iHandle = lscp_handler_table_add(&(pClient->handlers),
+		event, iId, pfnHandler, pvData);
+	if (iHandle < 0)
+		return -1;
+
+	// Lock this section up.
+	lscp_mutex_lock(pClient->mutex);
+
+	ret = _lscp_handlers_sync(pClient, event);
+
+	// Unlock this section down.
+	lscp_mutex_unlock(pClient->mutex);
+
+	if (ret != LSCP_OK) {
+		lscp_client_remove_event_handler(pClient, iHandle);
+		return -1;
+	}
+
+	return iHandle;
 }
 
 
 /**
- *  Loading an instrument in the background (non modal):
- *  LOAD INSTRUMENT NON_MODAL <filename> <instr-index> <sampler-channel>
+ *  Unregister an event handler. The event gets unsubscribed internally
+ *  when its last handler is gone, unless otherwise still subscribed.
  *
- *  @param pClient          Pointer to client instance structure.
- *  @param pszFileName      Instrument file name.
- *  @param iInstrIndex      Instrument index number.
- *  @param iSamplerChannel  Sampler Channel.
+ *  @param pClient  Pointer to client instance structure.
+ *  @param iHandle  Handler registration handle, as given by
+ *                  @ref lscp_client_add_event_handler.
  *
  *  @returns LSCP_OK on success, LSCP_FAILED otherwise.
  */
-lscp_status_t lscp_load_instrument_non_modal ( lscp_client_t *pClient,
-	const char *pszFileName, int iInstrIndex, int iSamplerChannel )
+lscp_status_t lscp_client_remove_event_handler ( lscp_client_t *pClient,
+	int iHandle )
 {
-	char szQuery[LSCP_BUFSIZ];
+	lscp_event_t event;
+	lscp_status_t ret;
 
-	if (pszFileName == NULL || iSamplerChannel < 0)
+	if (pClient == NULL)
 		return LSCP_FAILED;
 
-	sprintf(szQuery, "LOAD INSTRUMENT NON_MODAL '%s' %d %d\r\n",
-		pszFileName, iInstrIndex, iSamplerChannel);
-	return lscp_client_query(pClient, szQuery);
+	event = lscp_handler_table_remove(&(pClient->handlers), iHandle);
+	if (event == LSCP_EVENT_NONE)
+		return LSCP_FAILED;
+
+	// Lock this section up.
+	lscp_mutex_lock(pClient->mutex);
+
+	ret = _lscp_handlers_sync(pClient, event);
+
+	// Unlock this section down.
+	lscp_mutex_unlock(pClient->mutex);
+
+	return ret;
 }
 
 
 /**
- *  Loading a sampler engine:
- *  LOAD ENGINE <engine-name> <sampler-channel>
+ *  Set an optional MIDI events callback. When set, CHANNEL_MIDI and
+ *  DEVICE_MIDI notifications subscribed by the client take a fast path:
+ *  they are decoded straight into compact records, without allocation,
+ *  and handed over in batches, in place of the (raw or decoded) event
+ *  callback, neither being queued nor conflated. Batches are delivered
+ *  from the event service thread, as soon as full, as all data received
+ *  at once is handled, or before any other notification is handled, so
+ *  that the order of arrival is kept. Records are only valid during the
+ *  callback. Registered event handlers are served as usual.
  *
  *  @param pClient          Pointer to client instance structure.
- *  @param pszEngineName    Engine name.
- *  @param iSamplerChannel  Sampler channel number.
+ *  @param pfnMidiCallback  Batched MIDI events callback function, or
+ *                          NULL to revert to the regular event delivery.
+ *  @param pvData           User context opaque data, that will be passed
+ *                          to the MIDI events callback function.
  *
  *  @returns LSCP_OK on success, LSCP_FAILED otherwise.
  */
-lscp_status_t lscp_load_engine ( lscp_client_t *pClient, const char *pszEngineName, int iSamplerChannel )
+lscp_status_t lscp_client_set_midi_callback ( lscp_client_t *pClient,
+	lscp_client_midi_proc_t pfnMidiCallback, void *pvData )
 {
-	char szQuery[LSCP_BUFSIZ];
-
-	if (pszEngineName == NULL || iSamplerChannel < 0)
+	if (pClient == NULL)
 		return LSCP_FAILED;
 
-	sprintf(szQuery, "LOAD ENGINE %s %d\r\n",
-		pszEngineName, iSamplerChannel);
-	return lscp_client_query(pClient, szQuery);
+	// Lock this section up.
+	lscp_mutex_lock(pClient->mutex);
+
+	pClient->pvMidiData = pvData;
+	pClient->pfnMidiCallback = pfnMidiCallback;
+
+	// Unlock this section down.
+	lscp_mutex_unlock(pClient->mutex);
+
+	return LSCP_OK;
 }
 
 
 /**
- *  Current number of sampler channels:
- *  GET CHANNELS
+ *  Enable or disable the coherent sampler channel info cache. When
+ *  enabled, @ref lscp_get_channel_info results are kept per sampler
+ *  channel and only fetched from the server on first read or after
+ *  being invalidated by CHANNEL_INFO or CHANNEL_COUNT notifications,
+ *  which are subscribed internally for the purpose. Sampler channel
+ *  setters also update the cached information (write-through).
  *
- *  @param pClient  Pointer to client instance structure.
+ *  @param pClient          Pointer to client instance structure.
+ *  @param iChannelCache    Boolean flag, either 1 (one) to enable
+ *                          or 0 (zero) to disable the cache.
  *
- *  @returns The current total number of sampler channels on success,
- *  -1 otherwise.
+ *  @returns LSCP_OK on success, LSCP_FAILED otherwise.
  */
-int lscp_get_channels ( lscp_client_t *pClient )
+lscp_status_t lscp_client_set_channel_cache ( lscp_client_t *pClient,
+	int iChannelCache )
 {
-	int iChannels = -1;
+	lscp_status_t ret;
 
 	if (pClient == NULL)
-		return -1;
+		return LSCP_FAILED;
 
 	// Lock this section up.
 	lscp_mutex_lock(pClient->mutex);
 
-	if (lscp_client_call(pClient, "GET CHANNELS\r\n", 0) == LSCP_OK)
-		iChannels = atoi(lscp_client_get_result(pClient));
+	ret = _lscp_client_evt_enable(pClient,
+		&(pClient->channel_cache.enabled), &(pClient->channel_cache.events),
+		LSCP_CHANNEL_CACHE_EVENTS, iChannelCache);
 
-	// Unlock this section doen.
+	if (!pClient->channel_cache.enabled) {
+		lscp_mutex_lock(pClient->channel_cache.mutex);
+		lscp_channel_cache_flush(&(pClient->channel_cache));
+		lscp_mutex_unlock(pClient->channel_cache.mutex);
+	}
+
+	// Unlock this section down.
 	lscp_mutex_unlock(pClient->mutex);
 
-	return iChannels;
+	return ret;
 }
 
 
 /**
- *  List current sampler channels number identifiers:
- *  LIST CHANNELS
+ *  Get whether the coherent sampler channel info cache is enabled.
  *
  *  @param pClient  Pointer to client instance structure.
  *
- *  @returns An array of the sampler channels identifiers as positive integers,
- *  terminated with -1 on success, NULL otherwise.
+ *  @returns 1 (one) if enabled, 0 (zero) if disabled or in case of failure.
  */
-int *lscp_list_channels ( lscp_client_t *pClient )
+int lscp_client_get_channel_cache ( lscp_client_t *pClient )
 {
-	const char *pszSeps = ",";
+	if (pClient == NULL)
+		return 0;
 
+	return pClient->channel_cache.enabled;
+}
+
+
+/**
+ *  Flush all memoized server metadata, namely available engines and
+ *  drivers lists, engine and driver information, and driver parameter
+ *  information, which are otherwise only queried once per client
+ *  connection. All pointers previously returned by the corresponding
+ *  getters become invalid, except for snapshots still being referenced.
+ *
+ *  @param pClient  Pointer to client instance structure.
+ *
+ *  @returns LSCP_OK on success, LSCP_FAILED otherwise.
+ */
+lscp_status_t lscp_client_flush_metadata ( lscp_client_t *pClient )
+{
 	if (pClient == NULL)
-		return NULL;
+		return LSCP_FAILED;
 
 	// Lock this section up.
 	lscp_mutex_lock(pClient->mutex);
 
-	if (pClient->channels) {
-		lscp_isplit_destroy(pClient->channels);
-		pClient->channels = NULL;
-	}
+	lscp_metadata_flush(pClient);
 
-	if (lscp_client_call(pClient, "LIST CHANNELS\r\n", 0) == LSCP_OK)
-		pClient->channels = lscp_isplit_create(lscp_client_get_result(pClient), pszSeps);
+	lscp_szsplit_destroy(pClient->audio_drivers);
+	lscp_szsplit_destroy(pClient->midi_drivers);
+	lscp_szsplit_destroy(pClient->engines);
+	pClient->audio_drivers = NULL;
+	pClient->midi_drivers = NULL;
+	pClient->engines = NULL;
 
 	// Unlock this section down.
 	lscp_mutex_unlock(pClient->mutex);
 
-	return pClient->channels;
+	return LSCP_OK;
 }
 
 
 /**
- *  Adding a new sampler channel:
- *  ADD CHANNEL
+ *  Enable or disable the live meters. When enabled, sampler channel
+ *  voice count, disk stream count and buffer fill, and the total voice
+ *  count, are kept up-to-date from VOICE_COUNT, STREAM_COUNT, BUFFER_FILL
+ *  and TOTAL_VOICE_COUNT notifications, which are subscribed internally
+ *  for the purpose. Current values may then be read from any thread,
+ *  without locking nor network round-trips, with @ref lscp_get_channel_meter
+ *  and @ref lscp_get_total_voice_count_meter.
  *
- *  @param pClient  Pointer to client instance structure.
+ *  @param pClient      Pointer to client instance structure.
+ *  @param iLiveMeters  Boolean flag, either 1 (one) to enable
+ *                      or 0 (zero) to disable the live meters.
  *
- *  @returns The new sampler channel number identifier,
- *  or -1 in case of failure.
+ *  @returns LSCP_OK on success, LSCP_FAILED otherwise.
  */
-int lscp_add_channel ( lscp_client_t *pClient )
+lscp_status_t lscp_client_set_live_meters ( lscp_client_t *pClient,
+	int iLiveMeters )
 {
-	int iSamplerChannel = -1;
+	lscp_status_t ret;
 
 	if (pClient == NULL)
-		return -1;
+		return LSCP_FAILED;
 
 	// Lock this section up.
 	lscp_mutex_lock(pClient->mutex);
 
-	if (lscp_client_call(pClient, "ADD CHANNEL\r\n", 0) == LSCP_OK)
-		iSamplerChannel = atoi(lscp_client_get_result(pClient));
+	// Start over from scratch...
+	if (iLiveMeters && !pClient->meters.enabled)
+		lscp_meter_table_reset(&(pClient->meters));
+
+	ret = _lscp_client_evt_enable(pClient,
+		&(pClient->meters.enabled), &(pClient->meters.events),
+		LSCP_METER_EVENTS, iLiveMeters);
 
 	// Unlock this section down.
 	lscp_mutex_unlock(pClient->mutex);
 
-	return iSamplerChannel;
+	return ret;
 }
 
 
 /**
- *  Removing a sampler channel:
- *  REMOVE CHANNEL <sampler-channel>
+ *  Get whether the live meters are enabled.
  *
- *  @param pClient          Pointer to client instance structure.
- *  @param iSamplerChannel  Sampler channel number.
+ *  @param pClient  Pointer to client instance structure.
  *
- *  @returns LSCP_OK on success, LSCP_FAILED otherwise.
+ *  @returns 1 (one) if enabled, 0 (zero) if disabled or in case of failure.
  */
-lscp_status_t lscp_remove_channel ( lscp_client_t *pClient, int iSamplerChannel )
+int lscp_client_get_live_meters ( lscp_client_t *pClient )
 {
-	char szQuery[LSCP_BUFSIZ];
-
-	if (iSamplerChannel < 0)
-		return LSCP_FAILED;
+	if (pClient == NULL)
+		return 0;
 
-	sprintf(szQuery, "REMOVE CHANNEL %d\r\n", iSamplerChannel);
-	return lscp_client_query(pClient, szQuery);
+	return pClient->meters.enabled;
 }
 
 
 /**
- *  Getting all available engines count:
- *  GET AVAILABLE_ENGINES
+ *  Enable or disable the telemetry. When enabled, a bounded time-series
+ *  is recorded for every disk stream buffer fill (in percentage) and
+ *  sampler channel voice count, from BUFFER_FILL and VOICE_COUNT
+ *  notifications, which are subscribed internally for the purpose,
+ *  and also from @ref lscp_get_channel_buffer_fill polls (percentage
+ *  usage only). Each series keeps its most recent samples as they
+ *  come, plus downsampled buckets of 1 and 10 seconds, for a minute
+ *  and ten minutes respectively. Disabling drops all recorded series.
  *
- *  @param pClient  Pointer to client instance structure.
+ *  @param pClient      Pointer to client instance structure.
+ *  @param iTelemetry   Boolean flag, either 1 (one) to enable
+ *                      or 0 (zero) to disable the telemetry.
  *
- *  @returns The current total number of sampler engines on success,
- *  -1 otherwise.
+ *  @returns LSCP_OK on success, LSCP_FAILED otherwise.
  */
-int lscp_get_available_engines ( lscp_client_t *pClient )
+lscp_status_t lscp_client_set_telemetry ( lscp_client_t *pClient,
+	int iTelemetry )
 {
-	int iAvailableEngines = -1;
+	lscp_status_t ret;
 
 	if (pClient == NULL)
-		return -1;
+		return LSCP_FAILED;
 
 	// Lock this section up.
 	lscp_mutex_lock(pClient->mutex);
 
-	if (lscp_client_call(pClient, "GET AVAILABLE_ENGINES\r\n", 0) == LSCP_OK)
-		iAvailableEngines = atoi(lscp_client_get_result(pClient));
+	// Start over from scratch...
+	if (iTelemetry && !pClient->telemetry.enabled)
+		lscp_telemetry_reset(&(pClient->telemetry));
+
+	ret = _lscp_client_evt_enable(pClient,
+		&(pClient->telemetry.enabled), &(pClient->telemetry.events),
+		LSCP_TELEMETRY_EVENTS, iTelemetry);
+
+	if (!pClient->telemetry.enabled)
+		lscp_telemetry_reset(&(pClient->telemetry));
 
 	// Unlock this section down.
 	lscp_mutex_unlock(pClient->mutex);
 
-	return iAvailableEngines;
+	return ret;
 }
 
 
 /**
- *  Getting all available engines:
- *  LIST AVAILABLE_ENGINES
+ *  Get whether the telemetry is enabled.
  *
  *  @param pClient  Pointer to client instance structure.
  *
- *  @returns A NULL terminated array of engine name strings,
- *  or NULL in case of failure.
+ *  @returns 1 (one) if enabled, 0 (zero) if disabled or in case of failure.
  */
-const char **lscp_list_available_engines ( lscp_client_t *pClient )
+int lscp_client_get_telemetry ( lscp_client_t *pClient )
 {
-	const char *pszSeps = ",";
-
 	if (pClient == NULL)
-		return NULL;
+		return 0;
 
-	// Lock this section up.
-	lscp_mutex_lock(pClient->mutex);
+	return pClient->telemetry.enabled;
+}
 
-	if (pClient->engines) {
-		lscp_szsplit_destroy(pClient->engines);
-		pClient->engines = NULL;
-	}
 
-	if (lscp_client_call(pClient, "LIST AVAILABLE_ENGINES\r\n", 0) == LSCP_OK)
-		pClient->engines = lscp_szsplit_create(lscp_client_get_result(pClient), pszSeps);
+/**
+ *  Set the disk stream underrun prediction callback. Whenever a disk
+ *  stream buffer fill, as recorded by the telemetry, trends down to reach
+ *  the given threshold within the given horizon, the callback is invoked
+ *  once, with the trend statistics over the last horizon period and the
+ *  estimated time left; it won't be invoked again for the same stream
+ *  until the condition clears. The callback is invoked from the event
+ *  service thread, or from the thread polling with
+ *  @ref lscp_get_channel_buffer_fill, with no locks held.
+ *
+ *  @param pClient      Pointer to client instance structure.
+ *  @param pfnUnderrun  Callback procedure, or NULL to reset.
+ *  @param iHorizon     Prediction horizon, and trend window, in msecs.
+ *  @param fThreshold   Buffer fill threshold, in percentage.
+ *  @param pvData       User context opaque data, that will be passed
+ *                      to the callback procedure.
+ *
+ *  @returns LSCP_OK on success, LSCP_FAILED otherwise.
+ */
+lscp_status_t lscp_client_set_underrun_callback ( lscp_client_t *pClient,
+	lscp_client_underrun_proc_t pfnUnderrun, int iHorizon, float fThreshold,
+	void *pvData )
+{
+	if (pClient == NULL)
+		return LSCP_FAILED;
+	if (pfnUnderrun && iHorizon < 1)
+		return LSCP_FAILED;
 
-	// Unlock this section down.
-	lscp_mutex_unlock(pClient->mutex);
+	lscp_mutex_lock(pClient->telemetry.mutex);
+	pClient->telemetry.pfnUnderrun = pfnUnderrun;
+	pClient->telemetry.pvUnderrun  = pvData;
+	pClient->telemetry.horizon     = iHorizon;
+	pClient->telemetry.threshold   = fThreshold;
+	lscp_mutex_unlock(pClient->telemetry.mutex);
 
-	return (const char **) pClient->engines;
+	return LSCP_OK;
 }
 
 
 /**
- *  Getting information about an engine.
- *  GET ENGINE INFO <engine-name>
+ *  Enable or disable the device topology mirror. When enabled, all audio
+ *  output and MIDI input devices, their audio channels and MIDI ports are
+ *  mirrored locally, see @ref lscp_get_device_topology. The mirror is
+ *  bulk-fetched with pipelined requests, then kept current by refetching
+ *  only what AUDIO_OUTPUT_DEVICE_COUNT/INFO and MIDI_INPUT_DEVICE_COUNT/INFO
+ *  notifications tell to be stale, which are subscribed internally for
+ *  the purpose.
  *
  *  @param pClient          Pointer to client instance structure.
- *  @param pszEngineName    Engine name.
+ *  @param iDeviceMirror    Boolean flag, either 1 (one) to enable
+ *                          or 0 (zero) to disable the mirror.
  *
- *  @returns A pointer to a @ref lscp_engine_info_t structure, with all the
- *  information of the given sampler engine, or NULL in case of failure.
+ *  @returns LSCP_OK on success, LSCP_FAILED otherwise.
  */
-lscp_engine_info_t *lscp_get_engine_info ( lscp_client_t *pClient,
-	const char *pszEngineName )
+lscp_status_t lscp_client_set_device_mirror ( lscp_client_t *pClient,
+	int iDeviceMirror )
 {
-	lscp_engine_info_t *pEngineInfo;
-	char szQuery[LSCP_BUFSIZ];
-	const char *pszResult;
-	const char *pszSeps = ":";
-	const char *pszCrlf = "\r\n";
-	char *pszToken;
-	char *pch;
+	lscp_device_mirror_t *pMirror;
+	lscp_status_t ret;
 
 	if (pClient == NULL)
-		return NULL;
-	if (pszEngineName == NULL)
-		return NULL;
+		return LSCP_FAILED;
+
+	pMirror = &(pClient->device_mirror);
 
 	// Lock this section up.
 	lscp_mutex_lock(pClient->mutex);
 
-	pEngineInfo = &(pClient->engine_info);
-	lscp_engine_info_reset(pEngineInfo);
-
-	sprintf(szQuery, "GET ENGINE INFO %s\r\n", pszEngineName);
-	if (lscp_client_call(pClient, szQuery, 1) == LSCP_OK) {
-		pszResult = lscp_client_get_result(pClient);
-		pszToken = lscp_strtok((char *) pszResult, pszSeps, &(pch));
-		while (pszToken) {
-			if (strcasecmp(pszToken, "DESCRIPTION") == 0) {
-				pszToken = lscp_strtok(NULL, pszCrlf, &(pch));
-				if (pszToken)
-					lscp_unquote_dup(&(pEngineInfo->description), &pszToken);
-			}
-			else if (strcasecmp(pszToken, "VERSION") == 0) {
-				pszToken = lscp_strtok(NULL, pszCrlf, &(pch));
-				if (pszToken)
-					lscp_unquote_dup(&(pEngineInfo->version), &pszToken);
-			}
-			pszToken = lscp_strtok(NULL, pszSeps, &(pch));
-		}
+	ret = _lscp_client_evt_enable(pClient,
+		&(pMirror->enabled), &(pMirror->events),
+		LSCP_MIRROR_EVENTS, iDeviceMirror);
+
+	if (!pMirror->enabled) {
+		// Start over from scratch next time...
+		lscp_mutex_lock(pMirror->mutex);
+		lscp_device_topology_free(&(pMirror->topology));
+		lscp_hash_free(&(pMirror->stale));
+		pMirror->audio_stale = 1;
+		pMirror->midi_stale  = 1;
+		pMirror->warm = 0;
+		lscp_mutex_unlock(pMirror->mutex);
 	}
-	else pEngineInfo = NULL;
 
 	// Unlock this section down.
 	lscp_mutex_unlock(pClient->mutex);
 
-	return pEngineInfo;
+	return ret;
 }
 
 
 /**
- *  Getting sampler channel informations:
- *  GET CHANNEL INFO <sampler-channel>
+ *  Get whether the device topology mirror is enabled.
+ *
+ *  @param pClient  Pointer to client instance structure.
+ *
+ *  @returns 1 (one) if enabled, 0 (zero) if disabled or in case of failure.
+ */
+int lscp_client_get_device_mirror ( lscp_client_t *pClient )
+{
+	if (pClient == NULL)
+		return 0;
+
+	return pClient->device_mirror.enabled;
+}
+
+
+/**
+ *  Enable or disable the MIDI instrument map mirror. When enabled, all
+ *  MIDI instrument maps and their entries are mirrored locally, with
+ *  constant time lookups by map, bank and program, and indexed lookups
+ *  by name or instrument file, see @ref lscp_get_midi_instrument_mirror.
+ *  The mirror is bulk-fetched with pipelined requests, then kept current
+ *  by refetching only what MIDI_INSTRUMENT_MAP_COUNT/INFO and
+ *  MIDI_INSTRUMENT_COUNT/INFO notifications tell to be stale, which are
+ *  subscribed internally for the purpose.
  *
  *  @param pClient          Pointer to client instance structure.
- *  @param iSamplerChannel  Sampler channel number.
+ *  @param iMidiMapMirror   Boolean flag, either 1 (one) to enable
+ *                          or 0 (zero) to disable the mirror.
  *
- *  @returns A pointer to a @ref lscp_channel_info_t structure, with all the
- *  information of the given sampler channel, or NULL in case of failure.
+ *  @returns LSCP_OK on success, LSCP_FAILED otherwise.
  */
-lscp_channel_info_t *lscp_get_channel_info ( lscp_client_t *pClient, int iSamplerChannel )
+lscp_status_t lscp_client_set_midi_map_mirror ( lscp_client_t *pClient,
+	int iMidiMapMirror )
 {
-	lscp_channel_info_t *pChannelInfo;
-	char szQuery[LSCP_BUFSIZ];
-	const char *pszResult;
-	const char *pszSeps = ":";
-	const char *pszCrlf = "\r\n";
-	char *pszToken;
-	char *pch;
-	struct _locale_t locale;
+	lscp_midi_mirror_t *pMirror;
+	lscp_status_t ret;
 
 	if (pClient == NULL)
-		return NULL;
-	if (iSamplerChannel < 0)
-		return NULL;
+		return LSCP_FAILED;
+
+	pMirror = &(pClient->midi_mirror);
 
 	// Lock this section up.
 	lscp_mutex_lock(pClient->mutex);
 
-	pChannelInfo = &(pClient->channel_info);
-	lscp_channel_info_reset(pChannelInfo);
-
-	_save_and_set_c_locale(&locale);
+	ret = _lscp_client_evt_enable(pClient,
+		&(pMirror->enabled), &(pMirror->events),
+		LSCP_MIDI_MIRROR_EVENTS, iMidiMapMirror);
 
-	sprintf(szQuery, "GET CHANNEL INFO %d\r\n", iSamplerChannel);
-	if (lscp_client_call(pClient, szQuery, 1) == LSCP_OK) {
-		pszResult = lscp_client_get_result(pClient);
-		pszToken = lscp_strtok((char *) pszResult, pszSeps, &(pch));
-		while (pszToken) {
-			if (strcasecmp(pszToken, "ENGINE_NAME") == 0) {
-				pszToken = lscp_strtok(NULL, pszCrlf, &(pch));
-				if (pszToken)
-					lscp_unquote_dup(&(pChannelInfo->engine_name), &pszToken);
-			}
-			else if (strcasecmp(pszToken, "AUDIO_OUTPUT_DEVICE") == 0) {
-				pszToken = lscp_strtok(NULL, pszCrlf, &(pch));
-				if (pszToken)
-					pChannelInfo->audio_device = atoi(lscp_ltrim(pszToken));
-			}
-			else if (strcasecmp(pszToken, "AUDIO_OUTPUT_CHANNELS") == 0) {
-				pszToken = lscp_strtok(NULL, pszCrlf, &(pch));
-				if (pszToken)
-					pChannelInfo->audio_channels = atoi(lscp_ltrim(pszToken));
-			}
-			else if (strcasecmp(pszToken, "AUDIO_OUTPUT_ROUTING") == 0) {
-				pszToken = lscp_strtok(NULL, pszCrlf, &(pch));
-				if (pszToken) {
-					if (pChannelInfo->audio_routing)
-						lscp_isplit_destroy(pChannelInfo->audio_routing);
-					pChannelInfo->audio_routing = lscp_isplit_create(pszToken, ",");
-				}
-			}
-			else if (strcasecmp(pszToken, "INSTRUMENT_FILE") == 0) {
-				pszToken = lscp_strtok(NULL, pszCrlf, &(pch));
-				if (pszToken)
-					lscp_unquote_dup(&(pChannelInfo->instrument_file), &pszToken);
-			}
-			else if (strcasecmp(pszToken, "INSTRUMENT_NR") == 0) {
-				pszToken = lscp_strtok(NULL, pszCrlf, &(pch));
-				if (pszToken)
-					pChannelInfo->instrument_nr = atoi(lscp_ltrim(pszToken));
-			}
-			else if (strcasecmp(pszToken, "INSTRUMENT_NAME") == 0) {
-				pszToken = lscp_strtok(NULL, pszCrlf, &(pch));
-				if (pszToken)
-					lscp_unquote_dup(&(pChannelInfo->instrument_name), &pszToken);
-			}
-			else if (strcasecmp(pszToken, "INSTRUMENT_STATUS") == 0) {
-				pszToken = lscp_strtok(NULL, pszCrlf, &(pch));
-				if (pszToken)
-					pChannelInfo->instrument_status = atoi(lscp_ltrim(pszToken));
-			}
-			else if (strcasecmp(pszToken, "MIDI_INPUT_DEVICE") == 0) {
-				pszToken = lscp_strtok(NULL, pszCrlf, &(pch));
-				if (pszToken)
-					pChannelInfo->midi_device = atoi(lscp_ltrim(pszToken));
-			}
-			else if (strcasecmp(pszToken, "MIDI_INPUT_PORT") == 0) {
-				pszToken = lscp_strtok(NULL, pszCrlf, &(pch));
-				if (pszToken)
-					pChannelInfo->midi_port = atoi(lscp_ltrim(pszToken));
-			}
-			else if (strcasecmp(pszToken, "MIDI_INPUT_CHANNEL") == 0) {
-				pszToken = lscp_strtok(NULL, pszCrlf, &(pch));
-				if (pszToken) {
-					pszToken = lscp_ltrim(pszToken);
-					if (strcasecmp(pszToken, "ALL") == 0)
-						pChannelInfo->midi_channel = LSCP_MIDI_CHANNEL_ALL;
-					else
-						pChannelInfo->midi_channel = atoi(pszToken);
-				}
-			}
-			else if (strcasecmp(pszToken, "MIDI_INSTRUMENT_MAP") == 0) {
-				pszToken = lscp_strtok(NULL, pszCrlf, &(pch));
-				if (pszToken) {
-					pszToken = lscp_ltrim(pszToken);
-					if (strcasecmp(pszToken, "NONE") == 0)
-						pChannelInfo->midi_map = LSCP_MIDI_MAP_NONE;
-					else
-					if (strcasecmp(pszToken, "DEFAULT") == 0)
-						pChannelInfo->midi_map = LSCP_MIDI_MAP_DEFAULT;
-					else
-						pChannelInfo->midi_map = atoi(pszToken);
-				}
-			}
-			else if (strcasecmp(pszToken, "VOLUME") == 0) {
-				pszToken = lscp_strtok(NULL, pszCrlf, &(pch));
-				if (pszToken)
-					pChannelInfo->volume = _atof(lscp_ltrim(pszToken));
-			}
-			else if (strcasecmp(pszToken, "MUTE") == 0) {
-				pszToken = lscp_strtok(NULL, pszCrlf, &(pch));
-				if (pszToken)
-					pChannelInfo->mute = (strcasecmp(lscp_unquote(&pszToken, 0), "TRUE") == 0);
-			}
-			else if (strcasecmp(pszToken, "SOLO") == 0) {
-				pszToken = lscp_strtok(NULL, pszCrlf, &(pch));
-				if (pszToken)
-					pChannelInfo->solo = (strcasecmp(lscp_unquote(&pszToken, 0), "TRUE") == 0);
-			}
-			pszToken = lscp_strtok(NULL, pszSeps, &(pch));
-		}
+	if (!pMirror->enabled) {
+		// Start over from scratch next time...
+		lscp_midi_mirror_reset(pMirror);
 	}
-	else pChannelInfo = NULL;
 
-	_restore_locale(&locale);
-
-	// Unlock this section up.
+	// Unlock this section down.
 	lscp_mutex_unlock(pClient->mutex);
 
-	return pChannelInfo;
+	return ret;
 }
 
 
 /**
- *  Current number of active voices:
- *  GET CHANNEL VOICE_COUNT <sampler-channel>
+ *  Get whether the MIDI instrument map mirror is enabled.
  *
- *  @param pClient          Pointer to client instance structure.
- *  @param iSamplerChannel  Sampler channel number.
+ *  @param pClient  Pointer to client instance structure.
  *
- *  @returns The number of voices currently active, -1 in case of failure.
+ *  @returns 1 (one) if enabled, 0 (zero) if disabled or in case of failure.
  */
-int lscp_get_channel_voice_count ( lscp_client_t *pClient, int iSamplerChannel )
+int lscp_client_get_midi_map_mirror ( lscp_client_t *pClient )
 {
-	char szQuery[LSCP_BUFSIZ];
-	int iVoiceCount = -1;
-
 	if (pClient == NULL)
-		return -1;
-	if (iSamplerChannel < 0)
-		return -1;
+		return 0;
+
+	return pClient->midi_mirror.enabled;
+}
+
+
+/**
+ *  Save a warm-start cache file, holding all memoized server metadata
+ *  (engine, driver and parameter information) and the current state of
+ *  the device topology and MIDI instrument map mirrors, whichever are
+ *  enabled. The file is keyed by the server version, so that it may be
+ *  told stale on a later @ref lscp_client_reconcile_warm_start.
+ *
+ *  @param pClient      Pointer to client instance structure.
+ *  @param pszFilename  Warm-start cache file name to write.
+ *
+ *  @returns LSCP_OK on success, LSCP_FAILED otherwise.
+ */
+lscp_status_t lscp_client_save_warm_start ( lscp_client_t *pClient,
+	const char *pszFilename )
+{
+	const lscp_server_info_t *pServerInfo;
+	lscp_status_t ret;
+
+	if (pClient == NULL || pszFilename == NULL)
+		return LSCP_FAILED;
+
+	pServerInfo = lscp_get_server_info_snapshot(pClient);
+	if (pServerInfo == NULL)
+		return LSCP_FAILED;
 
 	// Lock this section up.
 	lscp_mutex_lock(pClient->mutex);
 
-	sprintf(szQuery, "GET CHANNEL VOICE_COUNT %d\r\n", iSamplerChannel);
-	if (lscp_client_call(pClient, szQuery, 0) == LSCP_OK)
-		iVoiceCount = atoi(lscp_client_get_result(pClient));
+	ret = lscp_warm_start_save(pClient, pszFilename, pServerInfo->version);
 
 	// Unlock this section down.
 	lscp_mutex_unlock(pClient->mutex);
 
-	return iVoiceCount;
+	lscp_snapshot_unref(pServerInfo);
+
+	return ret;
 }
 
 
 /**
- *  Current number of active disk streams:
- *  GET CHANNEL STREAM_COUNT <sampler-channel>
+ *  Load a warm-start cache file, as previously saved with
+ *  @ref lscp_client_save_warm_start, without any server round-trip.
+ *  Server metadata gets memoized as found, while the enabled device
+ *  topology and MIDI instrument map mirrors take the last-known state,
+ *  which is then served as is, until reconciled with the live server
+ *  through @ref lscp_client_reconcile_warm_start.
  *
- *  @param pClient          Pointer to client instance structure.
- *  @param iSamplerChannel  Sampler channel number.
+ *  @param pClient      Pointer to client instance structure.
+ *  @param pszFilename  Warm-start cache file name to read.
  *
- *  @returns The number of active disk streams on success, -1 otherwise.
+ *  @returns LSCP_OK on success, LSCP_FAILED otherwise.
  */
-int lscp_get_channel_stream_count ( lscp_client_t *pClient, int iSamplerChannel )
+lscp_status_t lscp_client_load_warm_start ( lscp_client_t *pClient,
+	const char *pszFilename )
 {
-	char szQuery[LSCP_BUFSIZ];
-	int iStreamCount = -1;
+	FILE *pFile;
+	char *pchData;
+	long cbData;
+	lscp_status_t ret = LSCP_FAILED;
 
-	if (pClient == NULL)
-		return -1;
-	if (iSamplerChannel < 0)
-		return -1;
+	if (pClient == NULL || pszFilename == NULL)
+		return LSCP_FAILED;
 
-	// Lock this section up.
-	lscp_mutex_lock(pClient->mutex);
+	pFile = fopen(pszFilename, "rb");
+	if (pFile == NULL)
+		return LSCP_FAILED;
 
-	sprintf(szQuery, "GET CHANNEL STREAM_COUNT %d\r\n", iSamplerChannel);
-	if (lscp_client_call(pClient, szQuery, 0) == LSCP_OK)
-		iStreamCount = atoi(lscp_client_get_result(pClient));
+	cbData = -1;
+	if (fseek(pFile, 0, SEEK_END) == 0) {
+		cbData = ftell(pFile);
+		if (fseek(pFile, 0, SEEK_SET) != 0)
+			cbData = -1;
+	}
 
-	// Unlock this section down.
-	lscp_mutex_unlock(pClient->mutex);
+	pchData = NULL;
+	if (cbData > 0 && cbData < INT_MAX)
+		pchData = (char *) malloc(cbData);
+	if (pchData) {
+		if (fread(pchData, 1, cbData, pFile) == (size_t) cbData)
+			ret = lscp_warm_start_load(pClient, pchData, (int) cbData);
+		free(pchData);
+	}
 
-	return iStreamCount;
+	fclose(pFile);
+
+	return ret;
 }
 
 
 /**
- *  Current least usage of active disk streams.
+ *  Reconcile the state loaded from a warm-start cache file with the
+ *  live server, possibly from a background thread: memoized metadata is
+ *  dropped if the server version has changed since the file was saved,
+ *  and the enabled mirrors are refetched, in a few pipelined requests.
  *
- *  @param pClient          Pointer to client instance structure.
- *  @param iSamplerChannel  Sampler channel number.
+ *  @param pClient  Pointer to client instance structure.
  *
- *  @returns The usage percentage of the least filled active disk stream
- *  on success, -1 otherwise.
+ *  @returns LSCP_OK on success, LSCP_FAILED otherwise.
  */
-int lscp_get_channel_stream_usage ( lscp_client_t *pClient, int iSamplerChannel )
+lscp_status_t lscp_client_reconcile_warm_start ( lscp_client_t *pClient )
 {
-	char szQuery[LSCP_BUFSIZ];
-	int  iStreamUsage = -1;
-	const char *pszResult;
-	const char *pszSeps = "[]%,";
-	char *pszToken;
-	char *pch;
-	int   iStream;
-	int   iPercent;
+	const lscp_server_info_t *pServerInfo;
+	lscp_status_t ret = LSCP_OK;
 
 	if (pClient == NULL)
-		return -1;
-	if (iSamplerChannel < 0)
-		return -1;
+		return LSCP_FAILED;
+	if (pClient->warm_version == NULL)
+		return LSCP_OK;
+
+	pServerInfo = lscp_get_server_info_snapshot(pClient);
+	if (pServerInfo == NULL)
+		return LSCP_FAILED;
 
 	// Lock this section up.
 	lscp_mutex_lock(pClient->mutex);
 
-	iStream = 0;
-	sprintf(szQuery, "GET CHANNEL BUFFER_FILL PERCENTAGE %d\r\n", iSamplerChannel);
-	if (lscp_client_call(pClient, szQuery, 0) == LSCP_OK) {
-		pszResult = lscp_client_get_result(pClient);
-		pszToken = lscp_strtok((char *) pszResult, pszSeps, &(pch));
-		while (pszToken) {
-			if (*pszToken) {
-				// Skip stream id.
-				pszToken = lscp_strtok(NULL, pszSeps, &(pch));
-				if (pszToken == NULL)
-					break;
-				// Get least buffer fill percentage.
-				iPercent = atol(pszToken);
-				if (iStreamUsage > iPercent || iStream == 0)
-					iStreamUsage = iPercent;
-				iStream++;
-			}
-			pszToken = lscp_strtok(NULL, pszSeps, &(pch));
-		}
+	if (pClient->warm_version) {
+		if (pServerInfo->version == NULL
+			|| strcmp(pClient->warm_version, pServerInfo->version))
+			lscp_metadata_flush(pClient);
+		free(pClient->warm_version);
+		pClient->warm_version = NULL;
 	}
 
+	pClient->device_mirror.warm = 0;
+	pClient->midi_mirror.warm = 0;
+
 	// Unlock this section down.
 	lscp_mutex_unlock(pClient->mutex);
 
-	return iStreamUsage;
+	lscp_snapshot_unref(pServerInfo);
+
+	if (pClient->device_mirror.enabled
+		&& lscp_get_device_topology(pClient) == NULL)
+		ret = LSCP_FAILED;
+	if (pClient->midi_mirror.enabled
+		&& lscp_get_midi_instrument_mirror(pClient) == NULL)
+		ret = LSCP_FAILED;
+
+	return ret;
 }
 
 
 /**
- *  Current fill state of disk stream buffers:
- *  GET CHANNEL BUFFER_FILL {BYTES|PERCENTAGE} <sampler-channel>
+ *  Check whether connection to server is lost.
  *
- *  @param pClient          Pointer to client instance structure.
- *  @param usage_type       Usage type to be returned, either
- *                          @ref LSCP_USAGE_BYTES, or
- *                          @ref LSCP_USAGE_PERCENTAGE.
- *  @param iSamplerChannel  Sampler channel number.
+ *  @param pClient  Pointer to client instance structure.
  *
- *  @returns A pointer to a @ref lscp_buffer_fill_t structure, with the
- *  information of the current disk stream buffer fill usage, for the given
- *  sampler channel, or NULL in case of failure.
+ *  @returns @c true if client lost connection to server, @c false otherwise.
  */
-lscp_buffer_fill_t *lscp_get_channel_buffer_fill ( lscp_client_t *pClient,
-	lscp_usage_t usage_type, int iSamplerChannel )
+bool lscp_client_connection_lost ( lscp_client_t *pClient )
 {
-	lscp_buffer_fill_t *pBufferFill;
-	char szQuery[LSCP_BUFSIZ];
-	int iStreamCount;
-	const char *pszUsageType = (usage_type == LSCP_USAGE_BYTES ? "BYTES" : "PERCENTAGE");
-	const char *pszResult;
-	const char *pszSeps = "[]%,";
-	char *pszToken;
-	char *pch;
-	int   iStream;
+    int err = lscp_client_get_errno(pClient);
+    if (err >= 0) return false;
+    return err == -EPIPE || err == -ECONNRESET || err == -ECONNABORTED;
+}
 
-	// Retrieve a channel stream estimation.
-	iStreamCount = lscp_get_channel_stream_count(pClient, iSamplerChannel);
-	if (iStreamCount < 0)
-		return NULL;
+
+//-------------------------------------------------------------------------
+// Client common protocol functions.
+
+/**
+ *  Submit a command query line string to the server. The query string
+ *  must be cr/lf and null terminated. Besides the return code, the
+ *  specific server response to the command request is made available
+ *  by the @ref lscp_client_get_result and @ref lscp_client_get_errno
+ *  function calls.
+ *
+ *  @param pClient      Pointer to client instance structure.
+ *  @param pszQuery     Command request line to be sent to server,
+ *                      must be cr/lf and null terminated.
+ *
+ *  @returns LSCP_OK on success, LSCP_FAILED otherwise.
+ */
+lscp_status_t lscp_client_query ( lscp_client_t *pClient, const char *pszQuery )
+{
+	lscp_status_t ret;
+
+	if (pClient == NULL)
+		return LSCP_FAILED;
 
 	// Lock this section up.
 	lscp_mutex_lock(pClient->mutex);
 
-	// Check if we need to reallocate the stream usage array.
-	if (pClient->iStreamCount != iStreamCount) {
-		if (pClient->buffer_fill)
-			free(pClient->buffer_fill);
-		if (iStreamCount > 0)
-			pClient->buffer_fill = (lscp_buffer_fill_t *) malloc(iStreamCount * sizeof(lscp_buffer_fill_t));
-		else
-			pClient->buffer_fill = NULL;
-		pClient->iStreamCount = iStreamCount;
-	}
-
-	// Get buffer fill usage...
-	pBufferFill = pClient->buffer_fill;
-	if (pBufferFill && iStreamCount > 0) {
-		iStream = 0;
-		pBufferFill = pClient->buffer_fill;
-		sprintf(szQuery, "GET CHANNEL BUFFER_FILL %s %d\r\n", pszUsageType, iSamplerChannel);
-		if (lscp_client_call(pClient, szQuery, 0) == LSCP_OK) {
-			pszResult = lscp_client_get_result(pClient);
-			pszToken = lscp_strtok((char *) pszResult, pszSeps, &(pch));
-			while (pszToken && iStream < pClient->iStreamCount) {
-				if (*pszToken) {
-					pBufferFill[iStream].stream_id = atol(pszToken);
-					pszToken = lscp_strtok(NULL, pszSeps, &(pch));
-					if (pszToken == NULL)
-						break;
-					pBufferFill[iStream].stream_usage = atol(pszToken);
-					iStream++;
-				}
-				pszToken = lscp_strtok(NULL, pszSeps, &(pch));
-			}
-		}   // Reset the usage, whatever it was before.
-		else while (iStream < pClient->iStreamCount)
-			pBufferFill[iStream++].stream_usage = 0;
-	}
+	// Just make the now guarded call.
+	ret = lscp_client_call(pClient, pszQuery, 0);
 
 	// Unlock this section down.
 	lscp_mutex_unlock(pClient->mutex);
 
-	return pBufferFill;
+	return ret;
 }
 
-
 /**
- *  Setting audio output type:
- *  SET CHANNEL AUDIO_OUTPUT_TYPE <sampler-channel> <audio-output-type>
+ *  Get the last received result string. In case of error or warning,
+ *  this is the text of the error or warning message issued.
  *
- *  @param pClient          Pointer to client instance structure.
- *  @param iSamplerChannel  Sampler channel number.
- *  @param pszAudioDriver   Audio output driver type (e.g. "ALSA" or "JACK").
+ *  @param pClient  Pointer to client instance structure.
  *
- *  @returns LSCP_OK on success, LSCP_FAILED otherwise.
+ *  @returns A pointer to the literal null-terminated result string as
+ *  of the last command request.
  */
-lscp_status_t lscp_set_channel_audio_type ( lscp_client_t *pClient,
-	int iSamplerChannel, const char *pszAudioDriver )
+const char *lscp_client_get_result ( lscp_client_t *pClient )
 {
-	char szQuery[LSCP_BUFSIZ];
-
-	if (iSamplerChannel < 0 || pszAudioDriver == NULL)
-		return LSCP_FAILED;
+	if (pClient == NULL)
+		return NULL;
 
-	sprintf(szQuery, "SET CHANNEL AUDIO_OUTPUT_TYPE %d %s\r\n",
-		iSamplerChannel, pszAudioDriver);
-	return lscp_client_query(pClient, szQuery);
+	return pClient->pszResult;
 }
 
 
 /**
- *  Setting audio output device:
- *  SET CHANNEL AUDIO_OUTPUT_DEVICE <sampler-channel> <device-id>
+ *  Get the last error/warning number received.
  *
- *  @param pClient          Pointer to client instance structure.
- *  @param iSamplerChannel  Sampler channel number.
- *  @param iAudioDevice     Audio output device number identifier.
+ *  @param pClient  Pointer to client instance structure.
  *
- *  @returns LSCP_OK on success, LSCP_FAILED otherwise.
+ *  @returns The numerical value of the last error or warning
+ *  response code received.
  */
-lscp_status_t lscp_set_channel_audio_device ( lscp_client_t *pClient,
-	int iSamplerChannel, int iAudioDevice )
+int lscp_client_get_errno ( lscp_client_t *pClient )
 {
-	char szQuery[LSCP_BUFSIZ];
-
-	if (iSamplerChannel < 0 || iAudioDevice < 0)
-		return LSCP_FAILED;
+	if (pClient == NULL)
+		return -1;
 
-	sprintf(szQuery, "SET CHANNEL AUDIO_OUTPUT_DEVICE %d %d\r\n",
-		iSamplerChannel, iAudioDevice);
-	return lscp_client_query(pClient, szQuery);
+	return pClient->iErrno;
 }
 
 
 /**
- *  Setting audio output channel:
- *  SET CHANNEL AUDIO_OUTPUT_CHANNEL <sampler-channel> <audio-output-chan> <audio-input-chan>
+ *  Submit a command query line string to the server and get its
+ *  response as a structured view (see @ref lscp_response_parse).
+ *  The response text is copied into the view own private storage,
+ *  so it stays valid regardless of any other client calls.
  *
- *  @param pClient          Pointer to client instance structure.
- *  @param iSamplerChannel  Sampler channel number.
- *  @param iAudioOut        Audio output device channel to be routed from.
- *  @param iAudioIn         Audio output device channel to be routed into.
+ *  @param pClient      Pointer to client instance structure.
+ *  @param pszQuery     Command request line to be sent to server,
+ *                      must be cr/lf and null terminated.
+ *  @param iMultiLine   Whether the command has a multi-line result
+ *                      (e.g. GET ... INFO commands), terminated
+ *                      by a single dot line.
+ *  @param pResponse    Pointer to an initialized response view.
  *
  *  @returns LSCP_OK on success, LSCP_FAILED otherwise.
  */
-lscp_status_t lscp_set_channel_audio_channel ( lscp_client_t *pClient,
-	int iSamplerChannel, int iAudioOut, int iAudioIn )
+lscp_status_t lscp_client_query_response ( lscp_client_t *pClient,
+	const char *pszQuery, int iMultiLine, lscp_response_t *pResponse )
 {
-	char szQuery[LSCP_BUFSIZ];
+	lscp_status_t ret;
 
-	if (iSamplerChannel < 0 || iAudioOut < 0 || iAudioIn < 0)
+	if (pClient == NULL || pResponse == NULL)
 		return LSCP_FAILED;
 
-	sprintf(szQuery, "SET CHANNEL AUDIO_OUTPUT_CHANNEL %d %d %d\r\n",
-		iSamplerChannel, iAudioOut, iAudioIn);
-	return lscp_client_query(pClient, szQuery);
+	// Lock this section up.
+	lscp_mutex_lock(pClient->mutex);
+
+	ret = lscp_client_call(pClient, pszQuery, (iMultiLine ? 1 : 0));
+	if (ret == LSCP_OK
+		&& _lscp_response_load(pResponse, lscp_client_get_result(pClient)) < 0)
+		ret = LSCP_FAILED;
+
+	// Unlock this section down.
+	lscp_mutex_unlock(pClient->mutex);
+
+	return ret;
 }
 
 
-/**
- *  Setting MIDI input type:
- *  SET CHANNEL MIDI_INPUT_TYPE <sampler-channel> <midi-input-type>
- *
- *  @param pClient          Pointer to client instance structure.
- *  @param iSamplerChannel  Sampler channel number.
- *  @param pszMidiDriver    MIDI input driver type (e.g. "ALSA").
- *
- *  @returns LSCP_OK on success, LSCP_FAILED otherwise.
- */
-lscp_status_t lscp_set_channel_midi_type ( lscp_client_t *pClient,
-	int iSamplerChannel, const char *pszMidiDriver )
+//-------------------------------------------------------------------------
+// Structured response view functions.
+
+// Append a new item to the response view, growing as needed.
+static lscp_response_item_t *_lscp_response_item ( lscp_response_t *pResponse )
 {
-	char szQuery[LSCP_BUFSIZ];
+	lscp_response_item_t *pItems;
+	int iSize;
+
+	if (pResponse->count >= pResponse->items_size) {
+		iSize = (pResponse->items_size > 0 ? pResponse->items_size << 1 : 16);
+		pItems = (lscp_response_item_t *) realloc(pResponse->items,
+			iSize * sizeof(lscp_response_item_t));
+		if (pItems == NULL)
+			return NULL;
+		pResponse->items = pItems;
+		pResponse->items_size = iSize;
+	}
 
-	if (iSamplerChannel < 0 || pszMidiDriver == NULL)
-		return LSCP_FAILED;
+	return &(pResponse->items[pResponse->count++]);
+}
 
-	sprintf(szQuery, "SET CHANNEL MIDI_INPUT_TYPE %d %s\r\n",
-		iSamplerChannel, pszMidiDriver);
-	return lscp_client_query(pClient, szQuery);
+
+// Whether a character may be part of a response key.
+static int _lscp_response_keych ( char ch )
+{
+	return ((ch >= 'A' && ch <= 'Z') || (ch >= 'a' && ch <= 'z')
+		|| (ch >= '0' && ch <= '9') || ch == '_' || ch == '.');
+}
+
+
+// Trimmed span [iBegin, iEnd) item value setter.
+static void _lscp_response_span ( lscp_response_item_t *pItem,
+	const char *pszText, int iBegin, int iEnd )
+{
+	while (iBegin < iEnd && isspace((unsigned char) pszText[iBegin]))
+		iBegin++;
+	while (iEnd > iBegin && isspace((unsigned char) pszText[iEnd - 1]))
+		iEnd--;
+
+	pItem->value = iBegin;
+	pItem->value_len = iEnd - iBegin;
+}
+
+
+// Make a private copy of the response text and parse it.
+static int _lscp_response_load ( lscp_response_t *pResponse, const char *pszText )
+{
+	char *pszBuffer;
+	int cchText, iSize;
+
+	cchText = strlen(pszText);
+	if (cchText + 1 > pResponse->buffer_size) {
+		iSize = (pResponse->buffer_size > 0 ? pResponse->buffer_size : LSCP_BUFSIZ);
+		while (cchText + 1 > iSize)
+			iSize <<= 1;
+		pszBuffer = (char *) realloc(pResponse->buffer, iSize);
+		if (pszBuffer == NULL)
+			return -1;
+		pResponse->buffer = pszBuffer;
+		pResponse->buffer_size = iSize;
+	}
+	memcpy(pResponse->buffer, pszText, cchText + 1);
+
+	return lscp_response_parse(pResponse, pResponse->buffer);
 }
 
 
 /**
- *  Setting MIDI input device:
- *  SET CHANNEL MIDI_INPUT_DEVICE <sampler-channel> <device-id>
+ *  Initialize an empty structured response view.
  *
- *  @param pClient          Pointer to client instance structure.
- *  @param iSamplerChannel  Sampler channel number.
- *  @param iMidiDevice      MIDI input device number identifier.
+ *  @param pResponse    Pointer to response view structure.
+ */
+void lscp_response_init ( lscp_response_t *pResponse )
+{
+	if (pResponse == NULL)
+		return;
+
+	pResponse->data        = NULL;
+	pResponse->count       = 0;
+	pResponse->items       = NULL;
+	pResponse->items_size  = 0;
+	pResponse->buffer      = NULL;
+	pResponse->buffer_size = 0;
+}
+
+
+/**
+ *  Free all storage held by a structured response view.
  *
- *  @returns LSCP_OK on success, LSCP_FAILED otherwise.
+ *  @param pResponse    Pointer to response view structure.
  */
-lscp_status_t lscp_set_channel_midi_device ( lscp_client_t *pClient,
-	int iSamplerChannel, int iMidiDevice )
+void lscp_response_free ( lscp_response_t *pResponse )
 {
-	char szQuery[LSCP_BUFSIZ];
+	if (pResponse == NULL)
+		return;
 
-	if (iSamplerChannel < 0 || iMidiDevice < 0)
-		return LSCP_FAILED;
+	if (pResponse->items)
+		free(pResponse->items);
+	if (pResponse->buffer)
+		free(pResponse->buffer);
 
-	sprintf(szQuery, "SET CHANNEL MIDI_INPUT_DEVICE %d %d\r\n",
-		iSamplerChannel, iMidiDevice);
-	return lscp_client_query(pClient, szQuery);
+	lscp_response_init(pResponse);
 }
 
 
 /**
- *  Setting MIDI input port:
- *  SET CHANNEL MIDI_INPUT_PORT <sampler-channel> <midi-input-port>
+ *  Parse a response text into a structured view, without copying.
+ *  Lines of the "KEY: value" form make keyed items; any other line
+ *  is split into plain list items by commas (quoted items may hold
+ *  commas). The text must outlive the view, which only keeps offsets;
+ *  item storage is reused across calls.
  *
- *  @param pClient          Pointer to client instance structure.
- *  @param iSamplerChannel  Sampler channel number.
- *  @param iMidiPort        MIDI input driver virtual port number.
+ *  @param pResponse    Pointer to an initialized response view.
+ *  @param pszText      Null terminated response text to be viewed.
  *
- *  @returns LSCP_OK on success, LSCP_FAILED otherwise.
+ *  @returns The number of parsed items, or -1 in case of failure.
  */
-lscp_status_t lscp_set_channel_midi_port ( lscp_client_t *pClient,
-	int iSamplerChannel, int iMidiPort )
+int lscp_response_parse ( lscp_response_t *pResponse, const char *pszText )
 {
-	char szQuery[LSCP_BUFSIZ];
+	lscp_response_item_t *pItem;
+	const char *pch;
+	char chQuote;
+	int iLine, iEnd, iKey, i;
 
-	if (iSamplerChannel < 0 || iMidiPort < 0)
-		return LSCP_FAILED;
+	if (pResponse == NULL || pszText == NULL)
+		return -1;
 
-	sprintf(szQuery, "SET CHANNEL MIDI_INPUT_PORT %d %d\r\n",
-		iSamplerChannel, iMidiPort);
-	return lscp_client_query(pClient, szQuery);
+	pResponse->data  = pszText;
+	pResponse->count = 0;
+
+	for (iLine = 0; pszText[iLine]; iLine = iEnd) {
+		// Find this line end...
+		pch  = lscp_strscan(pszText + iLine, "\r\n");
+		iEnd = (int) (pch - pszText);
+		// Keyed line?
+		for (iKey = iLine; iKey < iEnd && _lscp_response_keych(pszText[iKey]); iKey++)
+			;
+		if (iKey > iLine && iKey < iEnd && pszText[iKey] == ':') {
+			pItem = _lscp_response_item(pResponse);
+			if (pItem == NULL)
+				return -1;
+			pItem->key = iLine;
+			pItem->key_len = iKey - iLine;
+			_lscp_response_span(pItem, pszText, iKey + 1, iEnd);
+		}
+		else if (iEnd > iLine) {
+			// Plain comma separated list...
+			chQuote = (char) 0;
+			for (i = iLine; i <= iEnd; i++) {
+				if (i < iEnd && chQuote) {
+					if (pszText[i] == chQuote)
+						chQuote = (char) 0;
+				}
+				else if (i < iEnd && (pszText[i] == '\'' || pszText[i] == '\"')) {
+					chQuote = pszText[i];
+				}
+				else if (i == iEnd || pszText[i] == ',') {
+					pItem = _lscp_response_item(pResponse);
+					if (pItem == NULL)
+						return -1;
+					pItem->key = -1;
+					pItem->key_len = 0;
+					_lscp_response_span(pItem, pszText, iLine, i);
+					iLine = i + 1;
+				}
+			}
+		}
+		// Skip line terminators...
+		while (pszText[iEnd] == '\r' || pszText[iEnd] == '\n')
+			iEnd++;
+	}
+
+	return pResponse->count;
 }
 
 
 /**
- *  Setting MIDI input channel:
- *  SET CHANNEL MIDI_INPUT_CHANNEL <sampler-channel> <midi-input-chan>
+ *  Get the number of items of a structured response view.
  *
- *  @param pClient          Pointer to client instance structure.
- *  @param iSamplerChannel  Sampler channel number.
- *  @param iMidiChannel     MIDI channel address number to listen (0-15) or
- *                          @ref LSCP_MIDI_CHANNEL_ALL (16) to listen on all channels.
+ *  @param pResponse    Pointer to response view structure.
  *
- *  @returns LSCP_OK on success, LSCP_FAILED otherwise.
+ *  @returns The number of items.
  */
-lscp_status_t lscp_set_channel_midi_channel ( lscp_client_t *pClient,
-	int iSamplerChannel, int iMidiChannel )
+int lscp_response_count ( lscp_response_t *pResponse )
 {
-	char szQuery[LSCP_BUFSIZ];
-
-	if (iSamplerChannel < 0 || iMidiChannel < 0 || iMidiChannel > 16)
-		return LSCP_FAILED;
-
-	if (iMidiChannel == LSCP_MIDI_CHANNEL_ALL)
-		sprintf(szQuery, "SET CHANNEL MIDI_INPUT_CHANNEL %d ALL\r\n",
-			iSamplerChannel);
-	else
-		sprintf(szQuery, "SET CHANNEL MIDI_INPUT_CHANNEL %d %d\r\n",
-			iSamplerChannel, iMidiChannel);
-	return lscp_client_query(pClient, szQuery);
+	return (pResponse ? pResponse->count : 0);
 }
 
 
 /**
- *  Setting MIDI instrument map:
- *  SET CHANNEL MIDI_INSTRUMENT_MAP <sampler-channel> <midi-map>
+ *  Find a keyed item of a structured response view (case-insensitive).
  *
- *  @param pClient          Pointer to client instance structure.
- *  @param iSamplerChannel  Sampler channel number.
- *  @param iMidiMap         MIDI instrument map number, or either
- *                          @ref LSCP_MIDI_MAP_NONE or
- *                          @ref LSCP_MIDI_MAP_DEFAULT .
+ *  @param pResponse    Pointer to response view structure.
+ *  @param pszKey       Item key to look for.
  *
- *  @returns LSCP_OK on success, LSCP_FAILED otherwise.
+ *  @returns The item index, or -1 if not found.
  */
-lscp_status_t lscp_set_channel_midi_map ( lscp_client_t *pClient,
-	int iSamplerChannel, int iMidiMap )
+int lscp_response_find ( lscp_response_t *pResponse, const char *pszKey )
 {
-	char szQuery[LSCP_BUFSIZ];
-
-	if (iSamplerChannel < 0)
-		return LSCP_FAILED;
+	lscp_response_item_t *pItem;
+	int cchKey, i;
 
-	sprintf(szQuery, "SET CHANNEL MIDI_INSTRUMENT_MAP %d ", iSamplerChannel);
-	if (iMidiMap == LSCP_MIDI_MAP_NONE)
-		strcat(szQuery , "NONE");
-	else
-	if (iMidiMap == LSCP_MIDI_MAP_DEFAULT)
-		strcat(szQuery , "DEFAULT");
-	else
-		sprintf(szQuery + strlen(szQuery), "%d", iMidiMap);
+	if (pResponse == NULL || pszKey == NULL)
+		return -1;
 
-	strcat(szQuery, "\r\n");
+	cchKey = strlen(pszKey);
+	for (i = 0; i < pResponse->count; i++) {
+		pItem = &(pResponse->items[i]);
+		if (pItem->key >= 0 && pItem->key_len == cchKey
+			&& strncasecmp(pResponse->data + pItem->key, pszKey, cchKey) == 0)
+			return i;
+	}
 
-	return lscp_client_query(pClient, szQuery);
+	return -1;
 }
 
 
 /**
- *  Setting channel volume:
- *  SET CHANNEL VOLUME <sampler-channel> <volume>
+ *  Get an item key span of a structured response view.
  *
- *  @param pClient          Pointer to client instance structure.
- *  @param iSamplerChannel  Sampler channel number.
- *  @param fVolume          Sampler channel volume as a positive floating point
- *                          number, where a value less than 1.0 for attenuation,
- *                          and greater than 1.0 for amplification.
+ *  @param pResponse    Pointer to response view structure.
+ *  @param iItem        Item index.
+ *  @param pcchKey      Pointer to the key length result, if not NULL.
  *
- *  @returns LSCP_OK on success, LSCP_FAILED otherwise.
+ *  @returns A pointer to the key start (not null terminated),
+ *  or NULL if the item has no key or is out of range.
  */
-lscp_status_t lscp_set_channel_volume ( lscp_client_t *pClient,
-	int iSamplerChannel, float fVolume )
+const char *lscp_response_key ( lscp_response_t *pResponse, int iItem, int *pcchKey )
 {
-	char szQuery[LSCP_BUFSIZ];
-	struct _locale_t locale;
+	lscp_response_item_t *pItem;
 
-	if (iSamplerChannel < 0 || fVolume < 0.0f)
-		return LSCP_FAILED;
+	if (pcchKey)
+		*pcchKey = 0;
+	if (pResponse == NULL || iItem < 0 || iItem >= pResponse->count)
+		return NULL;
 
-	_save_and_set_c_locale(&locale);
-	sprintf(szQuery, "SET CHANNEL VOLUME %d %g\r\n",
-		iSamplerChannel, fVolume);
-	_restore_locale(&locale);
+	pItem = &(pResponse->items[iItem]);
+	if (pItem->key < 0)
+		return NULL;
+	if (pcchKey)
+		*pcchKey = pItem->key_len;
 
-	return lscp_client_query(pClient, szQuery);
+	return pResponse->data + pItem->key;
 }
 
 
 /**
- *  Muting a sampler channel:
- *  SET CHANNEL MUTE <sampler-channel> <mute>
+ *  Get an item value span of a structured response view, as is.
  *
- *  @param pClient          Pointer to client instance structure.
- *  @param iSamplerChannel  Sampler channel number.
- *  @param iMute            Sampler channel mute state as a boolean value,
- *                          either 1 (one) to mute the channel or 0 (zero)
- *                          to unmute the channel.
+ *  @param pResponse    Pointer to response view structure.
+ *  @param iItem        Item index.
+ *  @param pcchValue    Pointer to the value length result, if not NULL.
  *
- *  @returns LSCP_OK on success, LSCP_FAILED otherwise.
+ *  @returns A pointer to the value start (not null terminated),
+ *  or NULL if the item is out of range.
  */
-lscp_status_t lscp_set_channel_mute ( lscp_client_t *pClient,
-	int iSamplerChannel, int iMute )
+const char *lscp_response_value ( lscp_response_t *pResponse, int iItem, int *pcchValue )
 {
-	char szQuery[LSCP_BUFSIZ];
+	lscp_response_item_t *pItem;
 
-	if (iSamplerChannel < 0 || iMute < 0 || iMute > 1)
-		return LSCP_FAILED;
+	if (pcchValue)
+		*pcchValue = 0;
+	if (pResponse == NULL || iItem < 0 || iItem >= pResponse->count)
+		return NULL;
 
-	sprintf(szQuery, "SET CHANNEL MUTE %d %d\r\n",
-		iSamplerChannel, iMute);
-	return lscp_client_query(pClient, szQuery);
+	pItem = &(pResponse->items[iItem]);
+	if (pcchValue)
+		*pcchValue = pItem->value_len;
+
+	return pResponse->data + pItem->value;
 }
 
 
 /**
- *  Soloing a sampler channel:
- *  SET CHANNEL SOLO <sampler-channel> <solo>
+ *  Get an item value span of a structured response view, unquoted.
  *
- *  @param pClient          Pointer to client instance structure.
- *  @param iSamplerChannel  Sampler channel number.
- *  @param iSolo            Sampler channel solo state as a boolean value,
- *                          either 1 (one) to solo the channel or 0 (zero)
- *                          to unsolo the channel.
+ *  @param pResponse    Pointer to response view structure.
+ *  @param iItem        Item index.
+ *  @param pcchString   Pointer to the string length result, if not NULL.
  *
- *  @returns LSCP_OK on success, LSCP_FAILED otherwise.
+ *  @returns A pointer to the unquoted string start (not null terminated),
+ *  or NULL if the item is out of range.
  */
-lscp_status_t lscp_set_channel_solo ( lscp_client_t *pClient,
-	int iSamplerChannel, int iSolo )
+const char *lscp_response_string ( lscp_response_t *pResponse, int iItem, int *pcchString )
 {
-	char szQuery[LSCP_BUFSIZ];
+	const char *psz;
+	int cch;
+
+	psz = lscp_response_value(pResponse, iItem, &cch);
+	if (psz && cch >= 2 && (psz[0] == '\'' || psz[0] == '\"')
+		&& psz[cch - 1] == psz[0]) {
+		psz++;
+		cch -= 2;
+	}
 
-	if (iSamplerChannel < 0 || iSolo < 0 || iSolo > 1)
-		return LSCP_FAILED;
+	if (pcchString)
+		*pcchString = cch;
 
-	sprintf(szQuery, "SET CHANNEL SOLO %d %d\r\n",
-		iSamplerChannel, iSolo);
-	return lscp_client_query(pClient, szQuery);
+	return psz;
 }
 
 
 /**
- *  Resetting a sampler channel:
- *  RESET CHANNEL <sampler-channel>
+ *  Copy an item unquoted value of a structured response view
+ *  into a null terminated string buffer.
  *
- *  @param pClient          Pointer to client instance structure.
- *  @param iSamplerChannel  Sampler channel number.
+ *  @param pResponse    Pointer to response view structure.
+ *  @param iItem        Item index.
+ *  @param pszBuffer    Destination string buffer.
+ *  @param cchMaxBuffer Destination string buffer size.
  *
- *  @returns LSCP_OK on success, LSCP_FAILED otherwise.
+ *  @returns The copied string length, or -1 if the item is out of range.
  */
-lscp_status_t lscp_reset_channel ( lscp_client_t *pClient, int iSamplerChannel )
+int lscp_response_copy ( lscp_response_t *pResponse, int iItem,
+	char *pszBuffer, int cchMaxBuffer )
 {
-	char szQuery[LSCP_BUFSIZ];
+	const char *psz;
+	int cch;
 
-	if (iSamplerChannel < 0)
-		return LSCP_FAILED;
+	if (pszBuffer == NULL || cchMaxBuffer < 1)
+		return -1;
 
-	sprintf(szQuery, "RESET CHANNEL %d\r\n", iSamplerChannel);
-	return lscp_client_query(pClient, szQuery);
+	psz = lscp_response_string(pResponse, iItem, &cch);
+	if (psz == NULL) {
+		pszBuffer[0] = (char) 0;
+		return -1;
+	}
+
+	if (cch >= cchMaxBuffer)
+		cch = cchMaxBuffer - 1;
+	memcpy(pszBuffer, psz, cch);
+	pszBuffer[cch] = (char) 0;
+
+	return cch;
 }
 
 
 /**
- *  Resetting the sampler:
- *  RESET
+ *  Get an item value of a structured response view, as integer.
  *
- *  @param pClient  Pointer to client instance structure.
+ *  @param pResponse    Pointer to response view structure.
+ *  @param iItem        Item index.
+ *  @param iDefault     Default value, for a missing item.
  *
- *  @returns LSCP_OK on success, LSCP_FAILED otherwise.
+ *  @returns The item value as integer.
  */
-lscp_status_t lscp_reset_sampler ( lscp_client_t *pClient )
+int lscp_response_int ( lscp_response_t *pResponse, int iItem, int iDefault )
 {
-	// Do actual whole sampler reset...
-	return lscp_client_query(pClient, "RESET\r\n");
+	const char *psz = lscp_response_string(pResponse, iItem, NULL);
+	return (psz ? lscp_atoi(psz) : iDefault);
 }
 
 
 /**
- *  Getting information about the server.
- *  GET SERVER INFO
+ *  Get an item value of a structured response view, as floating point.
  *
- *  @param pClient  Pointer to client instance structure.
+ *  @param pResponse    Pointer to response view structure.
+ *  @param iItem        Item index.
+ *  @param fDefault     Default value, for a missing item.
  *
- *  @returns A pointer to a @ref lscp_server_info_t structure, with all the
- *  information of the current connected server, or NULL in case of failure.
+ *  @returns The item value as floating point (locale-independent).
  */
-lscp_server_info_t *lscp_get_server_info ( lscp_client_t *pClient )
+float lscp_response_float ( lscp_response_t *pResponse, int iItem, float fDefault )
 {
-	lscp_server_info_t *pServerInfo;
-	const char *pszResult;
-	const char *pszSeps = ":";
-	const char *pszCrlf = "\r\n";
-	char *pszToken;
-	char *pch;
-
-	if (pClient == NULL)
-		return NULL;
+	const char *psz = lscp_response_string(pResponse, iItem, NULL);
+	return (psz ? lscp_atof(psz) : fDefault);
+}
 
-	// Lock this section up.
-	lscp_mutex_lock(pClient->mutex);
 
-	pServerInfo = &(pClient->server_info);
-	lscp_server_info_reset(pServerInfo);
+/**
+ *  Get an item value of a structured response view, as boolean.
+ *
+ *  @param pResponse    Pointer to response view structure.
+ *  @param iItem        Item index.
+ *  @param iDefault     Default value, for a missing item.
+ *
+ *  @returns 1 if the item value is TRUE (or a non-zero number), 0 otherwise.
+ */
+int lscp_response_bool ( lscp_response_t *pResponse, int iItem, int iDefault )
+{
+	const char *psz;
+	int cch;
 
-	if (lscp_client_call(pClient, "GET SERVER INFO\r\n", 1) == LSCP_OK) {
-		pszResult = lscp_client_get_result(pClient);
-		pszToken = lscp_strtok((char *) pszResult, pszSeps, &(pch));
-		while (pszToken) {
-			if (strcasecmp(pszToken, "DESCRIPTION") == 0) {
-				pszToken = lscp_strtok(NULL, pszCrlf, &(pch));
-				if (pszToken)
-					lscp_unquote_dup(&(pServerInfo->description), &pszToken);
-			}
-			else if (strcasecmp(pszToken, "VERSION") == 0) {
-				pszToken = lscp_strtok(NULL, pszCrlf, &(pch));
-				if (pszToken)
-					lscp_unquote_dup(&(pServerInfo->version), &pszToken);
-			}
-			else if (strcasecmp(pszToken, "PROTOCOL_VERSION") == 0) {
-				pszToken = lscp_strtok(NULL, pszCrlf, &(pch));
-				if (pszToken)
-					lscp_unquote_dup(&(pServerInfo->protocol_version), &pszToken);
-			}
-			pszToken = lscp_strtok(NULL, pszSeps, &(pch));
-		}
-	}
-	else pServerInfo = NULL;
+	psz = lscp_response_string(pResponse, iItem, &cch);
+	if (psz == NULL)
+		return iDefault;
 
-	// Unlock this section down.
-	lscp_mutex_unlock(pClient->mutex);
+	if (cch == 4 && strncasecmp(psz, "TRUE", 4) == 0)
+		return 1;
 
-	return pServerInfo;
+	return (lscp_atoi(psz) != 0);
 }
 
 
+//-------------------------------------------------------------------------
+// Client registration protocol functions.
+
 /**
- *  Current total number of active voices:
- *  GET TOTAL_VOICE_COUNT
+ *  Register frontend for receiving event messages by the sampler backend.
+ *  @e Caution: since liblscp v0.5.5.4 you have to call lscp_client_subscribe()
+ *  for @e each event you want to subscribe. That is the old bitflag approach
+ *  was abondoned at this point. You can however still register all older
+ *  events with one lscp_client_subscribe() call at once. Thus, the old
+ *  behavior of this functions was not broken. Those older events are namely:
+ *  @code
+ *  SUBSCRIBE CHANNEL_COUNT | VOICE_COUNT | STREAM_COUNT
+ *      | BUFFER_FILL | CHANNEL_INFO | TOTAL_VOICE_COUNT
+ *      | AUDIO_OUTPUT_DEVICE_COUNT | AUDIO_OUTPUT_DEVICE_INFO
+ *      | MIDI_INPUT_DEVICE_COUNT | MIDI_INPUT_DEVICE_INFO
+ *      | MIDI_INSTRUMENT_MAP_COUNT | MIDI_INSTRUMENT_MAP_INFO
+ *      | MIDI_INSTRUMENT_COUNT | MIDI_INSTRUMENT_INFO
+ *      | MISCELLANEOUS
+ *  @endcode
+ *  The old events occupy the lower 16 bits (as bit flags), and all younger
+ *  events enumerate the whole upper 16 bits range. The new, enumerated
+ *  events are namely:
+ *  @code
+ *  SUBSCRIBE CHANNEL_MIDI
+ *  @endcode
  *
  *  @param pClient  Pointer to client instance structure.
+ *  @param events   LSCP event to subscribe.
  *
- *  @returns The total number of voices currently active,
- *  -1 in case of failure.
+ *  @returns LSCP_OK on success, LSCP_FAILED otherwise.
  */
-int lscp_get_total_voice_count ( lscp_client_t *pClient )
+lscp_status_t lscp_client_subscribe ( lscp_client_t *pClient, lscp_event_t events )
 {
-	int iVoiceCount = -1;
+	lscp_status_t ret = LSCP_OK;
+	lscp_event_t currentEvent;
 
 	if (pClient == NULL)
-		return -1;
+		return LSCP_FAILED;
 
 	// Lock this section up.
 	lscp_mutex_lock(pClient->mutex);
 
-	if (lscp_client_call(pClient, "GET TOTAL_VOICE_COUNT\r\n", 0) == LSCP_OK)
-		iVoiceCount = atoi(lscp_client_get_result(pClient));
+	// If applicable, start the alternate connection...
+	if ((pClient->events | _lscp_client_evt_internal(pClient)) == LSCP_EVENT_NONE)
+		ret = _lscp_client_evt_connect(pClient);
+
+	// Send the subscription commands, all at once.
+	if (ret == LSCP_OK)
+		ret = _lscp_client_evt_request(pClient, 1, events);
+	// Caution: for the upper 16 bits, we don't use bit flags anymore ...
+	currentEvent = events & 0xffff0000;
+	if (ret == LSCP_OK && currentEvent
+		&& currentEvent != LSCP_EVENT_CHANNEL_MIDI
+		&& currentEvent != LSCP_EVENT_DEVICE_MIDI) // unknown "upper" event type
+		ret = LSCP_FAILED;
+
+	// If nothing's left, close the alternate connection...
+	if ((pClient->events | _lscp_client_evt_internal(pClient)) == LSCP_EVENT_NONE)
+		lscp_socket_agent_free(&(pClient->evt));
 
 	// Unlock this section down.
 	lscp_mutex_unlock(pClient->mutex);
 
-	return iVoiceCount;
+	return ret;
 }
 
 
 /**
- *  Maximum amount of active voices:
- *  GET TOTAL_VOICE_COUNT_MAX
+ *  Deregister frontend from receiving UDP event messages anymore.
+ *  @e Caution: since liblscp v0.5.5.4 you have to call
+ *  lscp_client_unsubscribe() for @e each event you want to unsubscribe.
+ *  That is the old bitflag approach was abondoned at this point. You can
+ *  however still register all older events with one lscp_client_subscribe()
+ *  call at once. Thus, the old behavior of this functions was not broken.
+ *  Those older events are namely:
+ *  @code
+ *  UNSUBSCRIBE CHANNEL_COUNT | VOICE_COUNT | STREAM_COUNT
+ *      | BUFFER_FILL | CHANNEL_INFO | TOTAL_VOICE_COUNT
+ *      | AUDIO_OUTPUT_DEVICE_COUNT | AUDIO_OUTPUT_DEVICE_INFO
+ *      | MIDI_INPUT_DEVICE_COUNT | MIDI_INPUT_DEVICE_INFO
+ *      | MIDI_INSTRUMENT_MAP_COUNT | MIDI_INSTRUMENT_MAP_INFO
+ *      | MIDI_INSTRUMENT_COUNT | MIDI_INSTRUMENT_INFO
+ *      | MISCELLANEOUS
+ *  @endcode
+ *  The old events occupy the lower 16 bits (as bit flags), and all younger
+ *  events enumerate the whole upper 16 bits range. The new, enumerated
+ *  events are namely:
+ *  @code
+ *  UNSUBSCRIBE CHANNEL_MIDI
+ *  @endcode
  *
  *  @param pClient  Pointer to client instance structure.
+ *  @param events   LSCP event to unsubscribe.
  *
- *  @returns The maximum amount of voices currently active,
- *  -1 in case of failure.
+ *  @returns LSCP_OK on success, LSCP_FAILED otherwise.
  */
-int lscp_get_total_voice_count_max ( lscp_client_t *pClient )
+lscp_status_t lscp_client_unsubscribe ( lscp_client_t *pClient, lscp_event_t events )
 {
-	int iVoiceCount = -1;
+	lscp_status_t ret = LSCP_OK;
+	lscp_event_t currentEvent;
 
 	if (pClient == NULL)
-		return -1;
+		return LSCP_FAILED;
 
 	// Lock this section up.
 	lscp_mutex_lock(pClient->mutex);
 
-	if (lscp_client_call(pClient, "GET TOTAL_VOICE_COUNT_MAX\r\n", 0) == LSCP_OK)
-		iVoiceCount = atoi(lscp_client_get_result(pClient));
+	// Send the unsubscription commands, all at once.
+	ret = _lscp_client_evt_request(pClient, 0, events);
+	// Caution: for the upper 16 bits, we don't use bit flags anymore ...
+	currentEvent = events & 0xffff0000;
+	if (ret == LSCP_OK && currentEvent
+		&& currentEvent != LSCP_EVENT_CHANNEL_MIDI
+		&& currentEvent != LSCP_EVENT_DEVICE_MIDI) // unknown "upper" event type
+		ret = LSCP_FAILED;
+
+	// If necessary, close the alternate connection...
+	if ((pClient->events | _lscp_client_evt_internal(pClient)) == LSCP_EVENT_NONE)
+		lscp_socket_agent_free(&(pClient->evt));
 
 	// Unlock this section down.
 	lscp_mutex_unlock(pClient->mutex);
 
-	return iVoiceCount;
+	return ret;
 }
 
 
 /**
- *  Get global volume attenuation:
- *  GET VOLUME
+ *  Getting current subscribed events.
  *
  *  @param pClient  Pointer to client instance structure.
  *
- *  @returns The global volume as positive floating point value usually in
- *  the range between 0.0 and 1.0; in case of failure 0.0 is returned.
+ *  @returns The current subscrived bit-wise OR'ed event flags.
  */
-float lscp_get_volume ( lscp_client_t *pClient )
+lscp_event_t lscp_client_get_events ( lscp_client_t *pClient )
 {
-	float fVolume = 0.0f;
-	struct _locale_t locale;
-
 	if (pClient == NULL)
-		return 0.0f;
-
-	// Lock this section up.
-	lscp_mutex_lock(pClient->mutex);
-
-	_save_and_set_c_locale(&locale);
-
-	if (lscp_client_call(pClient, "GET VOLUME\r\n", 0) == LSCP_OK)
-		fVolume = _atof(lscp_client_get_result(pClient));
-
-	_restore_locale(&locale);
-
-	// Unlock this section down.
-	lscp_mutex_unlock(pClient->mutex);
+		return LSCP_EVENT_NONE;
 
-	return fVolume;
+	return pClient->events;
 }
 
 
+//-------------------------------------------------------------------------
+// Client command protocol functions.
+
 /**
- *  Setting global volume attenuation:
- *  SET VOLUME <volume>
+ *  Loading an instrument:
+ *  LOAD INSTRUMENT <filename> <instr-index> <sampler-channel>
  *
- *  @param pClient  Pointer to client instance structure.
- *  @param fVolume  Global volume parameter as positive floating point
- *                  value usually be in the range between 0.0 and 1.0,
- *                  that is for attenuating the overall volume.
+ *  @param pClient          Pointer to client instance structure.
+ *  @param pszFileName      Instrument file name.
+ *  @param iInstrIndex      Instrument index number.
+ *  @param iSamplerChannel  Sampler Channel.
  *
  *  @returns LSCP_OK on success, LSCP_FAILED otherwise.
  */
-lscp_status_t lscp_set_volume ( lscp_client_t *pClient, float fVolume )
+lscp_status_t lscp_load_instrument ( lscp_client_t *pClient,
+	const char *pszFileName, int iInstrIndex, int iSamplerChannel )
 {
 	char szQuery[LSCP_BUFSIZ];
-	struct _locale_t locale;
+	lscp_status_t ret;
 
-	if (fVolume < 0.0f)
+	if (pszFileName == NULL || iSamplerChannel < 0)
 		return LSCP_FAILED;
 
-	_save_and_set_c_locale(&locale);
-	sprintf(szQuery, "SET VOLUME %g\r\n", fVolume);
-	_restore_locale(&locale);
+	sprintf(szQuery, "LOAD INSTRUMENT '%s' %d %d\r\n",
+		pszFileName, iInstrIndex, iSamplerChannel);
+	ret = lscp_client_query(pClient, szQuery);
+	_lscp_channel_cache_invalidate(pClient, iSamplerChannel);
 
-	return lscp_client_query(pClient, szQuery);
+	return ret;
 }
 
 
 /**
- *  Get global voice limit setting:
- *  @code
- *  GET VOICES
- *  @endcode
- *  This value reflects the maximum amount of voices a sampler engine
- *  processes simultaniously before voice stealing kicks in.
+ *  Loading an instrument in the background (non modal):
+ *  LOAD INSTRUMENT NON_MODAL <filename> <instr-index> <sampler-channel>
  *
- *  @param pClient  Pointer to client instance structure.
+ *  @param pClient          Pointer to client instance structure.
+ *  @param pszFileName      Instrument file name.
+ *  @param iInstrIndex      Instrument index number.
+ *  @param iSamplerChannel  Sampler Channel.
  *
- *  @returns The current global maximum amount of voices limit or a
- *           negative value on error (e.g. if sampler doesn't support
- *           this command).
+ *  @returns LSCP_OK on success, LSCP_FAILED otherwise.
  */
-int lscp_get_voices ( lscp_client_t *pClient )
+lscp_status_t lscp_load_instrument_non_modal ( lscp_client_t *pClient,
+	const char *pszFileName, int iInstrIndex, int iSamplerChannel )
 {
-	int iVoices = -1;
-
-	if (pClient == NULL)
-		return -1;
-
-	// Lock this section up.
-	lscp_mutex_lock(pClient->mutex);
+	char szQuery[LSCP_BUFSIZ];
+	lscp_status_t ret;
 
-	if (lscp_client_call(pClient, "GET VOICES\r\n", 0) == LSCP_OK)
-		iVoices = atoi(lscp_client_get_result(pClient));
+	if (pszFileName == NULL || iSamplerChannel < 0)
+		return LSCP_FAILED;
 
-	// Unlock this section down.
-	lscp_mutex_unlock(pClient->mutex);
+	sprintf(szQuery, "LOAD INSTRUMENT NON_MODAL '%s' %d %d\r\n",
+		pszFileName, iInstrIndex, iSamplerChannel);
+	ret = lscp_client_query(pClient, szQuery);
+	_lscp_channel_cache_invalidate(pClient, iSamplerChannel);
 
-	return iVoices;
+	return ret;
 }
 
 
 /**
- *  Setting global voice limit setting:
- *  @code
- *  SET VOICES <max-voices>
- *  @endcode
- *  This value reflects the maximum amount of voices a sampler engine
- *  processes simultaniously before voice stealing kicks in. Note that
- *  this value will be passed to all sampler engine instances, that is
- *  the total amount of maximum voices on the running system is thus
- *  @param iMaxVoices multiplied with the current amount of sampler
- *  engine instances.
+ *  Loading a sampler engine:
+ *  LOAD ENGINE <engine-name> <sampler-channel>
  *
- *  @param pClient     Pointer to client instance structure.
- *  @param iMaxVoices  Global voice limit setting as integer value larger
- *                     or equal to 1.
+ *  @param pClient          Pointer to client instance structure.
+ *  @param pszEngineName    Engine name.
+ *  @param iSamplerChannel  Sampler channel number.
  *
  *  @returns LSCP_OK on success, LSCP_FAILED otherwise.
  */
-lscp_status_t lscp_set_voices ( lscp_client_t *pClient, int iMaxVoices )
+lscp_status_t lscp_load_engine ( lscp_client_t *pClient, const char *pszEngineName, int iSamplerChannel )
 {
 	char szQuery[LSCP_BUFSIZ];
+	lscp_status_t ret;
 
-	if (iMaxVoices < 1)
+	if (pszEngineName == NULL || iSamplerChannel < 0)
 		return LSCP_FAILED;
 
-	sprintf(szQuery, "SET VOICES %d\r\n", iMaxVoices);
-	return lscp_client_query(pClient, szQuery);
+	sprintf(szQuery, "LOAD ENGINE %s %d\r\n",
+		pszEngineName, iSamplerChannel);
+	ret = lscp_client_query(pClient, szQuery);
+	_lscp_channel_cache_invalidate(pClient, iSamplerChannel);
+
+	return ret;
 }
 
 
 /**
- *  Get global disk streams limit setting:
- *  @code
- *  GET STREAMS
- *  @endcode
- *  This value reflects the maximum amount of disk streams a sampler
- *  engine processes simultaniously.
+ *  Current number of sampler channels:
+ *  GET CHANNELS
  *
  *  @param pClient  Pointer to client instance structure.
  *
- *  @returns The current global maximum amount of disk streams limit
- *           or a negative value on error (e.g. if sampler doesn't
- *           support this command).
+ *  @returns The current total number of sampler channels on success,
+ *  -1 otherwise.
  */
-int lscp_get_streams ( lscp_client_t *pClient )
+int lscp_get_channels ( lscp_client_t *pClient )
 {
-	int iStreams = -1;
+	int iChannels = -1;
 
 	if (pClient == NULL)
 		return -1;
@@ -2190,165 +3242,145 @@ int lscp_get_streams ( lscp_client_t *pClient )
 	// Lock this section up.
 	lscp_mutex_lock(pClient->mutex);
 
-	if (lscp_client_call(pClient, "GET STREAMS\r\n", 0) == LSCP_OK)
-		iStreams = atoi(lscp_client_get_result(pClient));
+	if (lscp_client_call(pClient, "GET CHANNELS\r\n", 0) == LSCP_OK)
+		iChannels = lscp_atoi(lscp_client_get_result(pClient));
 
-	// Unlock this section down.
+	// Unlock this section doen.
 	lscp_mutex_unlock(pClient->mutex);
 
-	return iStreams;
+	return iChannels;
 }
 
 
 /**
- *  Setting global disk streams limit setting:
- *  @code
- *  SET STREAMS <max-streams>
- *  @endcode
- *  This value reflects the maximum amount of dist streams a sampler
- *  engine instance processes simultaniously. Note that this value will
- *  be passed to all sampler engine instances, that is the total amount
- *  of maximum disk streams on the running system is thus
- *  @param iMaxStreams multiplied with the current amount of sampler
- *  engine instances.
+ *  List current sampler channels number identifiers:
+ *  LIST CHANNELS
  *
- *  @param pClient      Pointer to client instance structure.
- *  @param iMaxStreams  Global streams limit setting as positive integer
- *                      value (larger or equal to 0).
+ *  @param pClient  Pointer to client instance structure.
  *
- *  @returns LSCP_OK on success, LSCP_FAILED otherwise.
+ *  @returns An array of the sampler channels identifiers as positive integers,
+ *  terminated with -1 on success, NULL otherwise.
  */
-lscp_status_t lscp_set_streams ( lscp_client_t *pClient, int iMaxStreams )
+int *lscp_list_channels ( lscp_client_t *pClient )
 {
-	char szQuery[LSCP_BUFSIZ];
+	const char *pszSeps = ",";
 
-	if (iMaxStreams < 0)
-		return LSCP_FAILED;
+	if (pClient == NULL)
+		return NULL;
 
-	sprintf(szQuery, "SET STREAMS %d\r\n", iMaxStreams);
-	return lscp_client_query(pClient, szQuery);
+	// Lock this section up.
+	lscp_mutex_lock(pClient->mutex);
+
+	if (pClient->channels) {
+		lscp_isplit_destroy(pClient->channels);
+		pClient->channels = NULL;
+	}
+
+	if (lscp_client_call(pClient, "LIST CHANNELS\r\n", 0) == LSCP_OK)
+		pClient->channels = lscp_isplit_create(lscp_client_get_result(pClient), pszSeps);
+
+	// Unlock this section down.
+	lscp_mutex_unlock(pClient->mutex);
+
+	return pClient->channels;
 }
 
 
 /**
- *  Add an effect send to a sampler channel:
- *  CREATE FX_SEND <sampler-channel> <midi-ctrl> [<fx-name>]
+ *  Adding a new sampler channel:
+ *  ADD CHANNEL
  *
- *  @param pClient          Pointer to client instance structure.
- *  @param iSamplerChannel  Sampler channel number.
- *  @param iMidiController  MIDI controller used to alter the effect,
- *                          usually a number between 0 and 127.
- *  @param pszFxName        Optional name for the effect send entity,
- *                          does not have to be unique.
+ *  @param pClient  Pointer to client instance structure.
  *
- *  @returns The new effect send number identifier, or -1 in case of failure.
+ *  @returns The new sampler channel number identifier,
+ *  or -1 in case of failure.
  */
-int lscp_create_fxsend ( lscp_client_t *pClient,
-	int iSamplerChannel, int iMidiController, const char *pszFxName )
+int lscp_add_channel ( lscp_client_t *pClient )
 {
-	int iFxSend = -1;
-	char szQuery[LSCP_BUFSIZ];
+	int iSamplerChannel = -1;
 
 	if (pClient == NULL)
 		return -1;
-	if (iSamplerChannel < 0 || iMidiController < 0 || iMidiController > 127)
-		return -1;
 
 	// Lock this section up.
 	lscp_mutex_lock(pClient->mutex);
 
-	sprintf(szQuery, "CREATE FX_SEND %d %d",
-		iSamplerChannel, iMidiController);
-
-	if (pszFxName)
-		sprintf(szQuery + strlen(szQuery), " '%s'", pszFxName);
-
-	strcat(szQuery, "\r\n");
-
-	if (lscp_client_call(pClient, szQuery, 0) == LSCP_OK)
-		iFxSend = atoi(lscp_client_get_result(pClient));
+	if (lscp_client_call(pClient, "ADD CHANNEL\r\n", 0) == LSCP_OK)
+		iSamplerChannel = lscp_atoi(lscp_client_get_result(pClient));
 
 	// Unlock this section down.
 	lscp_mutex_unlock(pClient->mutex);
 
-	return iFxSend;
+	return iSamplerChannel;
 }
 
 
 /**
- *  Remove an effect send from a sampler channel:
- *  DESTROY FX_SEND <sampler-channel> <fx-send-id>
+ *  Removing a sampler channel:
+ *  REMOVE CHANNEL <sampler-channel>
  *
  *  @param pClient          Pointer to client instance structure.
  *  @param iSamplerChannel  Sampler channel number.
- *  @param iFxSend          Effect send number.
  *
  *  @returns LSCP_OK on success, LSCP_FAILED otherwise.
  */
-lscp_status_t lscp_destroy_fxsend ( lscp_client_t *pClient,
-	int iSamplerChannel, int iFxSend )
+lscp_status_t lscp_remove_channel ( lscp_client_t *pClient, int iSamplerChannel )
 {
 	char szQuery[LSCP_BUFSIZ];
+	lscp_status_t ret;
 
-	if (iSamplerChannel < 0 || iFxSend < 0)
+	if (iSamplerChannel < 0)
 		return LSCP_FAILED;
 
-	sprintf(szQuery, "DESTROY FX_SEND %d %d\r\n",
-		iSamplerChannel, iFxSend);
+	sprintf(szQuery, "REMOVE CHANNEL %d\r\n", iSamplerChannel);
+	ret = lscp_client_query(pClient, szQuery);
+	_lscp_channel_cache_invalidate(pClient, iSamplerChannel);
 
-	return lscp_client_query(pClient, szQuery);
+	return ret;
 }
 
 
 /**
- *  Get amount of effect sends on a sampler channel:
- *  GET FX_SENDS <sampler-channel>
+ *  Getting all available engines count:
+ *  GET AVAILABLE_ENGINES
  *
- *  @param pClient          Pointer to client instance structure.
- *  @param iSamplerChannel  Sampler channel number.
+ *  @param pClient  Pointer to client instance structure.
  *
- *  @returns The current total number of effect sends of the sampler channel
- *  on success, -1 otherwise.
+ *  @returns The current total number of sampler engines on success,
+ *  -1 otherwise.
  */
-int lscp_get_fxsends ( lscp_client_t *pClient, int iSamplerChannel )
+int lscp_get_available_engines ( lscp_client_t *pClient )
 {
-	int iFxSends = -1;
-	char szQuery[LSCP_BUFSIZ];
+	int iAvailableEngines = -1;
 
 	if (pClient == NULL)
 		return -1;
-	if (iSamplerChannel < 0)
-		return -1;
 
 	// Lock this section up.
 	lscp_mutex_lock(pClient->mutex);
 
-	sprintf(szQuery, "GET FX_SENDS %d\r\n", iSamplerChannel);
-
-	if (lscp_client_call(pClient, szQuery, 0) == LSCP_OK)
-		iFxSends = atoi(lscp_client_get_result(pClient));
+	if (lscp_client_call(pClient, "GET AVAILABLE_ENGINES\r\n", 0) == LSCP_OK)
+		iAvailableEngines = lscp_atoi(lscp_client_get_result(pClient));
 
-	// Unlock this section doen.
+	// Unlock this section down.
 	lscp_mutex_unlock(pClient->mutex);
 
-	return iFxSends;
+	return iAvailableEngines;
 }
 
 
 /**
- *  List all effect sends on a sampler channel:
- *  LIST FX_SENDS <sampler-channel>
+ *  Getting all available engines:
+ *  LIST AVAILABLE_ENGINES
  *
- *  @param pClient          Pointer to client instance structure.
- *  @param iSamplerChannel  Sampler channel number.
+ *  @param pClient  Pointer to client instance structure.
  *
- *  @returns An array of the effect sends identifiers as positive integers,
- *  terminated with -1 on success, NULL otherwise.
+ *  @returns A NULL terminated array of engine name strings,
+ *  or NULL in case of failure.
  */
-int *lscp_list_fxsends ( lscp_client_t *pClient, int iSamplerChannel )
+const char **lscp_list_available_engines ( lscp_client_t *pClient )
 {
 	const char *pszSeps = ",";
-	char szQuery[LSCP_BUFSIZ];
 
 	if (pClient == NULL)
 		return NULL;
@@ -2356,727 +3388,3368 @@ int *lscp_list_fxsends ( lscp_client_t *pClient, int iSamplerChannel )
 	// Lock this section up.
 	lscp_mutex_lock(pClient->mutex);
 
-	if (pClient->fxsends) {
-		lscp_isplit_destroy(pClient->fxsends);
-		pClient->fxsends = NULL;
-	}
-
-	sprintf(szQuery, "LIST FX_SENDS %d\r\n", iSamplerChannel);
-
-	if (lscp_client_call(pClient, szQuery, 0) == LSCP_OK)
-		pClient->fxsends = lscp_isplit_create(lscp_client_get_result(pClient), pszSeps);
+	// Memoized, until flushed...
+	if (pClient->engines == NULL
+		&& lscp_client_call(pClient, "LIST AVAILABLE_ENGINES\r\n", 0) == LSCP_OK)
+		pClient->engines = lscp_szsplit_create(lscp_client_get_result(pClient), pszSeps);
 
 	// Unlock this section down.
 	lscp_mutex_unlock(pClient->mutex);
 
-	return pClient->fxsends;
+	return (const char **) pClient->engines;
 }
 
 
 /**
- *  Getting effect send information
- *  GET FX_SEND INFO <sampler-channel> <fx-send-id>
+ *  Getting information about an engine.
+ *  GET ENGINE INFO <engine-name>
  *
  *  @param pClient          Pointer to client instance structure.
- *  @param iSamplerChannel  Sampler channel number.
- *  @param iFxSend          Effect send number.
+ *  @param pszEngineName    Engine name.
  *
- *  @returns A pointer to a @ref lscp_fxsend_info_t structure, with the
- *  information of the given FX send, or NULL in case of failure.
+ *  @returns A pointer to a @ref lscp_engine_info_t structure, with all the
+ *  information of the given sampler engine, or NULL in case of failure.
  */
-lscp_fxsend_info_t *lscp_get_fxsend_info ( lscp_client_t *pClient,
-	int iSamplerChannel, int iFxSend )
+lscp_engine_info_t *lscp_get_engine_info ( lscp_client_t *pClient,
+	const char *pszEngineName )
 {
-	lscp_fxsend_info_t *pFxSendInfo;
 	char szQuery[LSCP_BUFSIZ];
-	const char *pszResult;
-	const char *pszSeps = ":";
-	const char *pszCrlf = "\r\n";
-	char *pszToken;
-	char *pch;
-	struct _locale_t locale;
 
 	if (pClient == NULL)
 		return NULL;
-	if (iSamplerChannel < 0 || iFxSend < 0)
+	if (pszEngineName == NULL)
 		return NULL;
 
-	// Lock this section up.
-	lscp_mutex_lock(pClient->mutex);
+	sprintf(szQuery, "GET ENGINE INFO %s\r\n", pszEngineName);
+	return _lscp_engine_info_cached(pClient, szQuery, 0);
+}
 
-	_save_and_set_c_locale(&locale);
 
-	pFxSendInfo = &(pClient->fxsend_info);
-	lscp_fxsend_info_reset(pFxSendInfo);
+// Memoized engine info query (engine metadata never changes while
+// the server is running). Returns the cached info, with an additional
+// reference on behalf of the caller if iSnapshot is set.
+static lscp_engine_info_t *_lscp_engine_info_cached ( lscp_client_t *pClient,
+	const char *pszQuery, int iSnapshot )
+{
+	lscp_engine_info_t *pEngineInfo;
 
-	sprintf(szQuery, "GET FX_SEND INFO %d %d\r\n", iSamplerChannel, iFxSend);
-	if (lscp_client_call(pClient, szQuery, 1) == LSCP_OK) {
-		pszResult = lscp_client_get_result(pClient);
-		pszToken = lscp_strtok((char *) pszResult, pszSeps, &(pch));
-		while (pszToken) {
-			if (strcasecmp(pszToken, "NAME") == 0) {
-				pszToken = lscp_strtok(NULL, pszCrlf, &(pch));
-				if (pszToken)
-					lscp_unquote_dup(&(pFxSendInfo->name), &pszToken);
-			}
-			else if (strcasecmp(pszToken, "MIDI_CONTROLLER") == 0) {
-				pszToken = lscp_strtok(NULL, pszCrlf, &(pch));
-				if (pszToken)
-					pFxSendInfo->midi_controller = atoi(lscp_ltrim(pszToken));
-			}
-			else if (strcasecmp(pszToken, "AUDIO_OUTPUT_ROUTING") == 0) {
-				pszToken = lscp_strtok(NULL, pszCrlf, &(pch));
-				if (pszToken) {
-					if (pFxSendInfo->audio_routing)
-						lscp_isplit_destroy(pFxSendInfo->audio_routing);
-					pFxSendInfo->audio_routing = lscp_isplit_create(pszToken, ",");
-				}
-			}
-			else if (strcasecmp(pszToken, "LEVEL") == 0) {
-				pszToken = lscp_strtok(NULL, pszCrlf, &(pch));
-				if (pszToken)
-					pFxSendInfo->level = _atof(lscp_ltrim(pszToken));
-			}
-			pszToken = lscp_strtok(NULL, pszSeps, &(pch));
-		}
-	}
-	else pFxSendInfo = NULL;
+	pEngineInfo = (lscp_engine_info_t *) lscp_metadata_find(pClient, pszQuery, iSnapshot);
+	if (pEngineInfo)
+		return pEngineInfo;
 
-	_restore_locale(&locale);
+	pEngineInfo = (lscp_engine_info_t *) lscp_snapshot_alloc(LSCP_SNAPSHOT_ENGINE_INFO);
+	if (pEngineInfo == NULL)
+		return NULL;
 
-	// Unlock this section up.
-	lscp_mutex_unlock(pClient->mutex);
+	if (_lscp_engine_info_query(pClient, pEngineInfo, pszQuery) == NULL) {
+		lscp_snapshot_unref(pEngineInfo);
+		return NULL;
+	}
 
-	return pFxSendInfo;
+	return (lscp_engine_info_t *) lscp_metadata_insert(pClient, pszQuery, pEngineInfo, iSnapshot);
 }
 
 
 /**
- *  Alter effect send's name:
- *  @code
- *  SET FX_SEND NAME <sampler-chan> <fx-send-id> <name>
- *  @endcode
+ *  Getting a snapshot of information about an engine.
+ *  GET ENGINE INFO <engine-name>
  *
  *  @param pClient          Pointer to client instance structure.
- *  @param iSamplerChannel  Sampler channel number.
- *  @param iFxSend          Effect send number.
- *  @param pszFxName        Effect send's new name.
+ *  @param pszEngineName    Engine name.
  *
- *  @returns LSCP_OK on success, LSCP_FAILED otherwise.
+ *  @returns A pointer to an immutable and reference-counted @ref lscp_engine_info_t
+ *  snapshot, owned by the caller and valid across any subsequent calls,
+ *  which must be released with @ref lscp_snapshot_unref when done,
+ *  or NULL in case of failure.
  */
-lscp_status_t lscp_set_fxsend_name ( lscp_client_t *pClient,
-	int iSamplerChannel, int iFxSend, const char *pszFxName )
+const lscp_engine_info_t *lscp_get_engine_info_snapshot ( lscp_client_t *pClient,
+	const char *pszEngineName )
 {
 	char szQuery[LSCP_BUFSIZ];
 
-	if (!pClient || iSamplerChannel < 0 || iFxSend < 0 || !pszFxName)
-		return LSCP_FAILED;
+	if (pClient == NULL)
+		return NULL;
+	if (pszEngineName == NULL)
+		return NULL;
 
-	snprintf(szQuery, LSCP_BUFSIZ, "SET FX_SEND NAME %d %d '%s'\r\n",
-		iSamplerChannel, iFxSend, pszFxName);
-	return lscp_client_query(pClient, szQuery);
+	sprintf(szQuery, "GET ENGINE INFO %s\r\n", pszEngineName);
+	return _lscp_engine_info_cached(pClient, szQuery, 1);
 }
 
 
-/**
- *  Alter effect send's audio routing:
- *  SET FX_SEND AUDIO_OUTPUT_CHANNEL <sampler-chan> <fx-send-id>
- *    <audio-src> <audio-dst>
- *
- *  @param pClient          Pointer to client instance structure.
- *  @param iSamplerChannel  Sampler channel number.
- *  @param iFxSend          Effect send number.
- *  @param iAudioSrc        Audio output device channel to be routed from.
- *  @param iAudioDst        Audio output device channel to be routed into.
- *
- *  @returns LSCP_OK on success, LSCP_FAILED otherwise.
- */
-lscp_status_t lscp_set_fxsend_audio_channel ( lscp_client_t *pClient,
-	int iSamplerChannel, int iFxSend, int iAudioSrc, int iAudioDst )
+// Common engine info query command.
+static lscp_engine_info_t *_lscp_engine_info_query ( lscp_client_t *pClient,
+	lscp_engine_info_t *pEngineInfo, const char *pszQuery )
 {
-	char szQuery[LSCP_BUFSIZ];
-
-	if (iSamplerChannel < 0 || iFxSend < 0 || iAudioSrc < 0 || iAudioDst < 0)
-		return LSCP_FAILED;
-
-	sprintf(szQuery, "SET FX_SEND AUDIO_OUTPUT_CHANNEL %d %d %d %d\r\n",
-		iSamplerChannel, iFxSend, iAudioSrc, iAudioDst);
-	return lscp_client_query(pClient, szQuery);
-}
+	const char *pszResult;
+	const char *pszSeps = ":";
+	const char *pszCrlf = "\r\n";
+	char *pszToken;
+	char *pch;
 
+	// Lock this section up.
+	lscp_mutex_lock(pClient->mutex);
 
-/**
- *  Alter effect send's MIDI controller:
- *  SET FX_SEND MIDI_CONTROLLER <sampler-chan> <fx-send-id> <midi-ctrl>
- *
- *  @param pClient          Pointer to client instance structure.
- *  @param iSamplerChannel  Sampler channel number.
- *  @param iFxSend          Effect send number.
- *  @param iMidiController  MIDI controller used to alter the effect,
- *                          usually a number between 0 and 127.
- *
- *  @returns LSCP_OK on success, LSCP_FAILED otherwise.
- */
-lscp_status_t lscp_set_fxsend_midi_controller ( lscp_client_t *pClient,
-	int iSamplerChannel, int iFxSend, int iMidiController )
-{
-	char szQuery[LSCP_BUFSIZ];
+	lscp_engine_info_reset(pEngineInfo);
+	if (lscp_client_call(pClient, pszQuery, 1) == LSCP_OK) {
+		pszResult = lscp_client_get_result(pClient);
+		pszToken = lscp_strtok((char *) pszResult, pszSeps, &(pch));
+		while (pszToken) {
+			if (strcasecmp(pszToken, "DESCRIPTION") == 0) {
+				pszToken = lscp_strtok(NULL, pszCrlf, &(pch));
+				if (pszToken)
+					lscp_unquote_dup(&(pEngineInfo->description), &pszToken);
+			}
+			else if (strcasecmp(pszToken, "VERSION") == 0) {
+				pszToken = lscp_strtok(NULL, pszCrlf, &(pch));
+				if (pszToken)
+					lscp_unquote_dup(&(pEngineInfo->version), &pszToken);
+			}
+			pszToken = lscp_strtok(NULL, pszSeps, &(pch));
+		}
+	}
+	else pEngineInfo = NULL;
 
-	if (iSamplerChannel < 0 || iFxSend < 0 ||
-		iMidiController < 0 || iMidiController > 127)
-		return LSCP_FAILED;
+	// Unlock this section down.
+	lscp_mutex_unlock(pClient->mutex);
 
-	sprintf(szQuery, "SET FX_SEND MIDI_CONTROLLER %d %d %d\r\n",
-		iSamplerChannel, iFxSend, iMidiController);
-	return lscp_client_query(pClient, szQuery);
+	return pEngineInfo;
 }
 
 
 /**
- *  Alter effect send's audio level:
- *  SET FX_SEND LEVEL <sampler-chan> <fx-send-id> <level>
+ *  Getting sampler channel informations:
+ *  GET CHANNEL INFO <sampler-channel>
  *
  *  @param pClient          Pointer to client instance structure.
  *  @param iSamplerChannel  Sampler channel number.
- *  @param iFxSend          Effect send number.
- *  @param fLevel           Effect send volume level.
  *
- *  @returns LSCP_OK on success, LSCP_FAILED otherwise.
+ *  @returns A pointer to a @ref lscp_channel_info_t structure, with all the
+ *  information of the given sampler channel, or NULL in case of failure.
  */
-lscp_status_t lscp_set_fxsend_level ( lscp_client_t *pClient,
-	int iSamplerChannel, int iFxSend, float fLevel )
+lscp_channel_info_t *lscp_get_channel_info ( lscp_client_t *pClient, int iSamplerChannel )
 {
-	char szQuery[LSCP_BUFSIZ];
-	struct _locale_t locale;
+	lscp_channel_info_t *pChannelInfo;
 
-	if (iSamplerChannel < 0 || iFxSend < 0 || fLevel < 0.0f)
-		return LSCP_FAILED;
+	if (pClient == NULL)
+		return NULL;
+	if (iSamplerChannel < 0)
+		return NULL;
 
-	_save_and_set_c_locale(&locale);
-	sprintf(szQuery, "SET FX_SEND LEVEL %d %d %f\r\n",
-		iSamplerChannel, iFxSend, fLevel);
-	_restore_locale(&locale);
+	// Lock this section up.
+	lscp_mutex_lock(pClient->mutex);
 
-	return lscp_client_query(pClient, szQuery);
+	pChannelInfo = &(pClient->channel_info);
+	lscp_channel_info_reset(pChannelInfo);
+	if (pClient->channel_cache.enabled) {
+		if (_lscp_channel_cache_get(pClient, pChannelInfo, iSamplerChannel) != LSCP_OK)
+			pChannelInfo = NULL;
+	} else {
+		if (_lscp_channel_info_query(pClient, pChannelInfo, iSamplerChannel) != LSCP_OK)
+			pChannelInfo = NULL;
+	}
+
+	// Unlock this section up.
+	lscp_mutex_unlock(pClient->mutex);
+
+	return pChannelInfo;
 }
 
 
 /**
- *  Create a new MIDI instrument map:
- *  ADD MIDI_INSTRUMENT_MAP [<name>]
+ *  Getting a snapshot of sampler channel informations:
+ *  GET CHANNEL INFO <sampler-channel>
  *
- *  @param pClient      Pointer to client instance structure.
- *  @param pszMapName   MIDI instrument map name (optional)
+ *  @param pClient          Pointer to client instance structure.
+ *  @param iSamplerChannel  Sampler channel number.
  *
- *  @returns The new MIDI instrument map number identifier,
- *  or -1 in case of failure.
+ *  @returns A pointer to an immutable and reference-counted @ref lscp_channel_info_t
+ *  snapshot, owned by the caller and valid across any subsequent calls,
+ *  which must be released with @ref lscp_snapshot_unref when done,
+ *  or NULL in case of failure.
  */
-int lscp_add_midi_instrument_map ( lscp_client_t *pClient, const char *pszMapName )
+const lscp_channel_info_t *lscp_get_channel_info_snapshot ( lscp_client_t *pClient,
+	int iSamplerChannel )
 {
-	int iMidiMap = -1;
-	char szQuery[LSCP_BUFSIZ];
+	lscp_channel_info_t *pChannelInfo;
 
 	if (pClient == NULL)
-		return -1;
+		return NULL;
+	if (iSamplerChannel < 0)
+		return NULL;
+
+	pChannelInfo = (lscp_channel_info_t *) lscp_snapshot_alloc(LSCP_SNAPSHOT_CHANNEL_INFO);
+	if (pChannelInfo == NULL)
+		return NULL;
 
 	// Lock this section up.
 	lscp_mutex_lock(pClient->mutex);
 
-	strcpy(szQuery, "ADD MIDI_INSTRUMENT_MAP");
-
-	if (pszMapName)
-		sprintf(szQuery + strlen(szQuery), " '%s'", pszMapName);
-
-	strcat(szQuery, "\r\n");
-
-	if (lscp_client_call(pClient, szQuery, 0) == LSCP_OK)
-		iMidiMap = atoi(lscp_client_get_result(pClient));
+	if (_lscp_channel_info_query(pClient, pChannelInfo, iSamplerChannel) != LSCP_OK) {
+		lscp_snapshot_unref(pChannelInfo);
+		pChannelInfo = NULL;
+	}
 
 	// Unlock this section down.
 	lscp_mutex_unlock(pClient->mutex);
 
-	return iMidiMap;
+	return pChannelInfo;
 }
 
 
-/**
- *  Delete one particular or all MIDI instrument maps:
- *  REMOVE MIDI_INSTRUMENT_MAP <midi-map>
- *
- *  @param pClient  Pointer to client instance structure.
- *  @param iMidiMap MIDI instrument map number.
- *
- *  @returns LSCP_OK on success, LSCP_FAILED otherwise.
- */
-lscp_status_t lscp_remove_midi_instrument_map ( lscp_client_t *pClient, int iMidiMap )
+// Actual sampler channel info query (caller owns client mutex).
+static lscp_status_t _lscp_channel_info_query ( lscp_client_t *pClient,
+	lscp_channel_info_t *pChannelInfo, int iSamplerChannel )
 {
+	lscp_status_t ret;
 	char szQuery[LSCP_BUFSIZ];
 
-	if (iMidiMap < 0)
-		return LSCP_FAILED;
-
-	sprintf(szQuery, "REMOVE MIDI_INSTRUMENT_MAP %d\r\n", iMidiMap);
+	sprintf(szQuery, "GET CHANNEL INFO %d\r\n", iSamplerChannel);
+	ret = lscp_client_call(pClient, szQuery, 1);
+	if (ret == LSCP_OK)
+		_lscp_channel_info_parse(pClient->intern, pChannelInfo,
+			(char *) lscp_client_get_result(pClient));
 
-	return lscp_client_query(pClient, szQuery);
+	return ret;
 }
 
 
-/**
- *  Get amount of existing MIDI instrument maps:
- *  GET MIDI_INSTRUMENT_MAPS
- *
- *  @param pClient  Pointer to client instance structure.
- *
- *  @returns The current total number of MIDI instrument maps
- *  on success, -1 otherwise.
- */
-int lscp_get_midi_instrument_maps ( lscp_client_t *pClient )
+// Parse a GET CHANNEL INFO response (parsed in place).
+static void _lscp_channel_info_parse ( lscp_intern_pool_t *pPool,
+	lscp_channel_info_t *pChannelInfo, char *pszResult )
 {
-	int iMidiMaps = -1;
-
-	if (pClient == NULL)
-		return -1;
-
-	// Lock this section up.
-	lscp_mutex_lock(pClient->mutex);
-
-	if (lscp_client_call(pClient, "GET MIDI_INSTRUMENT_MAPS\r\n", 0) == LSCP_OK)
-		iMidiMaps = atoi(lscp_client_get_result(pClient));
-
-	// Unlock this section doen.
-	lscp_mutex_unlock(pClient->mutex);
+	const char *pszSeps = ":";
+	const char *pszCrlf = "\r\n";
+	char *pszToken;
+	char *pch;
 
-	return iMidiMaps;
+	pszToken = lscp_strtok(pszResult, pszSeps, &(pch));
+	while (pszToken) {
+		if (strcasecmp(pszToken, "ENGINE_NAME") == 0) {
+			pszToken = lscp_strtok(NULL, pszCrlf, &(pch));
+			if (pszToken)
+				lscp_unquote_intern(pPool, &(pChannelInfo->engine_name), &pszToken);
+		}
+		else if (strcasecmp(pszToken, "AUDIO_OUTPUT_DEVICE") == 0) {
+			pszToken = lscp_strtok(NULL, pszCrlf, &(pch));
+			if (pszToken)
+				pChannelInfo->audio_device = lscp_atoi(lscp_ltrim(pszToken));
+		}
+		else if (strcasecmp(pszToken, "AUDIO_OUTPUT_CHANNELS") == 0) {
+			pszToken = lscp_strtok(NULL, pszCrlf, &(pch));
+			if (pszToken)
+				pChannelInfo->audio_channels = lscp_atoi(lscp_ltrim(pszToken));
+		}
+		else if (strcasecmp(pszToken, "AUDIO_OUTPUT_ROUTING") == 0) {
+			pszToken = lscp_strtok(NULL, pszCrlf, &(pch));
+			if (pszToken) {
+				if (pChannelInfo->audio_routing)
+					lscp_isplit_destroy(pChannelInfo->audio_routing);
+				pChannelInfo->audio_routing = lscp_isplit_create(pszToken, ",");
+			}
+		}
+		else if (strcasecmp(pszToken, "INSTRUMENT_FILE") == 0) {
+			pszToken = lscp_strtok(NULL, pszCrlf, &(pch));
+			if (pszToken)
+				lscp_unquote_intern(pPool, &(pChannelInfo->instrument_file), &pszToken);
+		}
+		else if (strcasecmp(pszToken, "INSTRUMENT_NR") == 0) {
+			pszToken = lscp_strtok(NULL, pszCrlf, &(pch));
+			if (pszToken)
+				pChannelInfo->instrument_nr = lscp_atoi(lscp_ltrim(pszToken));
+		}
+		else if (strcasecmp(pszToken, "INSTRUMENT_NAME") == 0) {
+			pszToken = lscp_strtok(NULL, pszCrlf, &(pch));
+			if (pszToken)
+				lscp_unquote_intern(pPool, &(pChannelInfo->instrument_name), &pszToken);
+		}
+		else if (strcasecmp(pszToken, "INSTRUMENT_STATUS") == 0) {
+			pszToken = lscp_strtok(NULL, pszCrlf, &(pch));
+			if (pszToken)
+				pChannelInfo->instrument_status = lscp_atoi(lscp_ltrim(pszToken));
+		}
+		else if (strcasecmp(pszToken, "MIDI_INPUT_DEVICE") == 0) {
+			pszToken = lscp_strtok(NULL, pszCrlf, &(pch));
+			if (pszToken)
+				pChannelInfo->midi_device = lscp_atoi(lscp_ltrim(pszToken));
+		}
+		else if (strcasecmp(pszToken, "MIDI_INPUT_PORT") == 0) {
+			pszToken = lscp_strtok(NULL, pszCrlf, &(pch));
+			if (pszToken)
+				pChannelInfo->midi_port = lscp_atoi(lscp_ltrim(pszToken));
+		}
+		else if (strcasecmp(pszToken, "MIDI_INPUT_CHANNEL") == 0) {
+			pszToken = lscp_strtok(NULL, pszCrlf, &(pch));
+			if (pszToken) {
+				pszToken = lscp_ltrim(pszToken);
+				if (strcasecmp(pszToken, "ALL") == 0)
+					pChannelInfo->midi_channel = LSCP_MIDI_CHANNEL_ALL;
+				else
+					pChannelInfo->midi_channel = lscp_atoi(pszToken);
+			}
+		}
+		else if (strcasecmp(pszToken, "MIDI_INSTRUMENT_MAP") == 0) {
+			pszToken = lscp_strtok(NULL, pszCrlf, &(pch));
+			if (pszToken) {
+				pszToken = lscp_ltrim(pszToken);
+				if (strcasecmp(pszToken, "NONE") == 0)
+					pChannelInfo->midi_map = LSCP_MIDI_MAP_NONE;
+				else
+				if (strcasecmp(pszToken, "DEFAULT") == 0)
+					pChannelInfo->midi_map = LSCP_MIDI_MAP_DEFAULT;
+				else
+					pChannelInfo->midi_map = lscp_atoi(pszToken);
+			}
+		}
+		else if (strcasecmp(pszToken, "VOLUME") == 0) {
+			pszToken = lscp_strtok(NULL, pszCrlf, &(pch));
+			if (pszToken)
+				pChannelInfo->volume = lscp_atof(lscp_ltrim(pszToken));
+		}
+		else if (strcasecmp(pszToken, "MUTE") == 0) {
+			pszToken = lscp_strtok(NULL, pszCrlf, &(pch));
+			if (pszToken)
+				pChannelInfo->mute = (strcasecmp(lscp_unquote(&pszToken, 0), "TRUE") == 0);
+		}
+		else if (strcasecmp(pszToken, "SOLO") == 0) {
+			pszToken = lscp_strtok(NULL, pszCrlf, &(pch));
+			if (pszToken)
+				pChannelInfo->solo = (strcasecmp(lscp_unquote(&pszToken, 0), "TRUE") == 0);
+		}
+		pszToken = lscp_strtok(NULL, pszSeps, &(pch));
+	}
 }
 
 
-/**
- *  Getting all created MIDI instrument maps:
- *  LIST MIDI_INSTRUMENT_MAPS
- *
- *  @param pClient  Pointer to client instance structure.
- *
- *  @returns An array of the MIDI instrument map identifiers as positive
- *  integers, terminated with -1 on success, NULL otherwise.
- */
-int *lscp_list_midi_instrument_maps ( lscp_client_t *pClient )
+// All sampler channels info table pipelined request state.
+typedef struct _lscp_channel_table_batch_t
 {
-	const char *pszSeps = ",";
+	lscp_channel_store_t *store;
+	lscp_channel_info_t info;
+	// Queries per row, and extra queries offsets (-1 if none).
+	int stride;
+	int voice_count;
+	int stream_count;
+	// Out of memory while setting rows.
+	int failed;
 
-	if (pClient == NULL)
-		return NULL;
+} lscp_channel_table_batch_t;
 
-	// Lock this section up.
-	lscp_mutex_lock(pClient->mutex);
 
-	if (pClient->midi_maps) {
-		lscp_isplit_destroy(pClient->midi_maps);
-		pClient->midi_maps = NULL;
+// All sampler channels info table pipelined response handler.
+static void _lscp_channel_table_result ( lscp_client_t *pClient,
+	int iQuery, lscp_status_t ret, char *pszResult, void *pvData )
+{
+	lscp_channel_table_batch_t *pBatch = (lscp_channel_table_batch_t *) pvData;
+	lscp_channel_table_t *pTable = &(pBatch->store->table);
+	int iRow = iQuery / pBatch->stride;
+	int iKind = iQuery % pBatch->stride;
+	int iCount;
+
+	if (ret != LSCP_OK || pszResult == NULL)
+		return;
+
+	if (iKind == 0) {
+		lscp_channel_info_reset(&(pBatch->info));
+		_lscp_channel_info_parse(pClient->intern, &(pBatch->info), pszResult);
+		if (lscp_channel_store_set(pBatch->store, iRow, &(pBatch->info)) < 0)
+			pBatch->failed = 1;
+	} else {
+		iCount = lscp_atoi(pszResult);
+		if (iKind == pBatch->voice_count)
+			pTable->voice_count[iRow] = iCount;
+		else
+		if (iKind == pBatch->stream_count)
+			pTable->stream_count[iRow] = iCount;
 	}
-
-	if (lscp_client_call(pClient, "LIST MIDI_INSTRUMENT_MAPS\r\n", 0) == LSCP_OK)
-		pClient->midi_maps = lscp_isplit_create(lscp_client_get_result(pClient), pszSeps);
-
-	// Unlock this section down.
-	lscp_mutex_unlock(pClient->mutex);
-
-	return pClient->midi_maps;
 }
 
 
 /**
- *  Getting a MIDI instrument map name:
- *  GET MIDI_INSTRUMENT_MAP INFO <midi-map>
+ *  Getting all sampler channels informations at once: LIST CHANNELS,
+ *  then GET CHANNEL INFO <sampler-channel> for each one and, optionally,
+ *  GET CHANNEL VOICE_COUNT and/or STREAM_COUNT <sampler-channel> too,
+ *  all pipelined in one go (so it takes two round-trips in total).
  *
  *  @param pClient  Pointer to client instance structure.
- *  @param iMidiMap MIDI instrument map number.
+ *  @param iFlags   Extra queries: a bitwise OR of
+ *                  @ref LSCP_CHANNEL_TABLE_VOICE_COUNT and
+ *                  @ref LSCP_CHANNEL_TABLE_STREAM_COUNT, or zero.
  *
- *  @returns The MIDI instrument map name on success, NULL on failure.
+ *  @returns A pointer to a @ref lscp_channel_table_t structure, with one
+ *  row per sampler channel, owned by the client and valid until the
+ *  next call, or NULL in case of failure.
  */
-const char *lscp_get_midi_instrument_map_name ( lscp_client_t *pClient, int iMidiMap )
+const lscp_channel_table_t *lscp_get_all_channel_info ( lscp_client_t *pClient,
+	int iFlags )
 {
-	char szQuery[LSCP_BUFSIZ];
-	const char *pszResult;
-	const char *pszSeps = ":";
-	const char *pszCrlf = "\r\n";
-	char *pszToken;
-	char *pch;
+	lscp_channel_store_t *pStore;
+	lscp_channel_table_batch_t batch;
+	lscp_mirror_batch_t queries;
+	lscp_channel_table_t *pTable = NULL;
+	int *piChannels = NULL;
+	int *piResults = NULL;
+	int iRows, i, k;
+	char *pszQuery;
+
+	lscp_status_t ret;
 
 	if (pClient == NULL)
 		return NULL;
-	if (iMidiMap < 0)
-		return NULL;
+
+	pStore = &(pClient->channel_store);
+
+	batch.store  = pStore;
+	batch.stride = 1;
+	batch.voice_count  = -1;
+	batch.stream_count = -1;
+	batch.failed = 0;
+	if (iFlags & LSCP_CHANNEL_TABLE_VOICE_COUNT)
+		batch.voice_count = batch.stride++;
+	if (iFlags & LSCP_CHANNEL_TABLE_STREAM_COUNT)
+		batch.stream_count = batch.stride++;
 
 	// Lock this section up.
 	lscp_mutex_lock(pClient->mutex);
 
-	if (pClient->midi_map_name) {
-		free(pClient->midi_map_name);
-		pClient->midi_map_name = NULL;
-	}
+	ret = lscp_client_call(pClient, "LIST CHANNELS\r\n", 0);
+	if (ret == LSCP_OK)
+		piChannels = lscp_isplit_create(lscp_client_get_result(pClient), ",");
 
-	sprintf(szQuery, "GET MIDI_INSTRUMENT_MAP INFO %d\r\n", iMidiMap);
-	if (lscp_client_call(pClient, szQuery, 1) == LSCP_OK) {
-		pszResult = lscp_client_get_result(pClient);
-		pszToken = lscp_strtok((char *) pszResult, pszSeps, &(pch));
-		while (pszToken) {
-			if (strcasecmp(pszToken, "NAME") == 0) {
-				pszToken = lscp_strtok(NULL, pszCrlf, &(pch));
-				if (pszToken)
-					lscp_unquote_dup(&(pClient->midi_map_name), &pszToken);
+	iRows = 0;
+	while (piChannels && piChannels[iRows] >= 0)
+		iRows++;
+	if (ret == LSCP_OK && lscp_channel_store_reset(pStore, iRows) < 0)
+		ret = LSCP_FAILED;
+
+	if (ret == LSCP_OK && iRows > 0) {
+		piResults = (int *) malloc(iRows * batch.stride * sizeof(int));
+		if (piResults == NULL)
+			ret = LSCP_FAILED;
+		else
+		if (lscp_mirror_batch_init(&queries, iRows * batch.stride) < 0) {
+			lscp_mirror_batch_free(&queries);
+			ret = LSCP_FAILED;
+		}
+		if (ret == LSCP_OK) {
+			lscp_channel_info_init(&(batch.info));
+			for (i = 0; i < iRows; i++) {
+				pStore->table.channel[i] = piChannels[i];
+				for (k = 0; k < batch.stride; k++) {
+					pszQuery = lscp_mirror_batch_add(&queries, NULL);
+					if (k == 0) {
+						sprintf(pszQuery, "GET CHANNEL INFO %d\r\n", piChannels[i]);
+						piResults[queries.count - 1] = 1;
+					} else {
+						sprintf(pszQuery, "GET CHANNEL %s %d\r\n",
+							(k == batch.voice_count ? "VOICE_COUNT" : "STREAM_COUNT"),
+							piChannels[i]);
+						piResults[queries.count - 1] = 0;
+					}
+				}
 			}
-			pszToken = lscp_strtok(NULL, pszSeps, &(pch));
+			ret = lscp_client_call_mixed(pClient, queries.ppszQueries, queries.count,
+				piResults, _lscp_channel_table_result, &batch);
+			lscp_channel_info_free(&(batch.info));
+			lscp_mirror_batch_free(&queries);
 		}
+		if (piResults)
+			free(piResults);
 	}
 
+	if (ret == LSCP_OK && (batch.failed || lscp_channel_store_commit(pStore) < 0))
+		ret = LSCP_FAILED;
+	if (ret == LSCP_OK)
+		pTable = &(pStore->table);
+
 	// Unlock this section down.
 	lscp_mutex_unlock(pClient->mutex);
 
-	return pClient->midi_map_name;
+	if (piChannels)
+		lscp_isplit_destroy(piChannels);
+
+	return pTable;
 }
 
 
 /**
- *  Renaming a MIDI instrument map:
- *  SET MIDI_INSTRUMENT_MAP NAME <midi-map> <map-name>
+ *  Getting the row of a given sampler channel in a table as returned
+ *  by @ref lscp_get_all_channel_info, in constant time.
  *
- *  @param pClient      Pointer to client instance structure.
- *  @param iMidiMap     MIDI instrument map number.
- *  @param pszMapName   MIDI instrument map name.
+ *  @param pTable           Pointer to all sampler channels info table.
+ *  @param iSamplerChannel  Sampler channel number.
  *
- *  @returns LSCP_OK on success, LSCP_FAILED otherwise.
+ *  @returns The table row index of the given sampler channel,
+ *  or -1 if not found.
  */
-lscp_status_t lscp_set_midi_instrument_map_name ( lscp_client_t *pClient, int iMidiMap, const char *pszMapName )
+int lscp_channel_table_row ( const lscp_channel_table_t *pTable,
+	int iSamplerChannel )
 {
-	char szQuery[LSCP_BUFSIZ];
+	if (pTable == NULL || pTable->row_index == NULL)
+		return -1;
 
-	if (iMidiMap < 0)
-		return LSCP_FAILED;
-	if (pszMapName == NULL)
-		return LSCP_FAILED;
+	return (int) (intptr_t) lscp_hash_find(
+		(lscp_hash_t *) pTable->row_index, iSamplerChannel) - 1;
+}
 
-	sprintf(szQuery, "SET MIDI_INSTRUMENT_MAP NAME %d '%s'\r\n",
-		iMidiMap, pszMapName);
 
-	return lscp_client_query(pClient, szQuery);
-}
+//-------------------------------------------------------------------------
+// Lazy channel info decoding.
+
+// Channel info response field keys (see lscp_channel_field_t).
+static const char *_lscp_channel_keys[LSCP_CHANNEL_FIELDS] = {
+	"ENGINE_NAME",
+	"AUDIO_OUTPUT_DEVICE",
+	"AUDIO_OUTPUT_CHANNELS",
+	"AUDIO_OUTPUT_ROUTING",
+	"INSTRUMENT_FILE",
+	"INSTRUMENT_NR",
+	"INSTRUMENT_NAME",
+	"INSTRUMENT_STATUS",
+	"MIDI_INPUT_DEVICE",
+	"MIDI_INPUT_PORT",
+	"MIDI_INPUT_CHANNEL",
+	"MIDI_INSTRUMENT_MAP",
+	"VOLUME",
+	"MUTE",
+	"SOLO"
+};
 
 
-/**
- *  Create or replace a MIDI instrumnet map entry:
- *  MAP MIDI_INSTRUMENT <midi-map> <midi-bank> <midi-prog>
- *      <engine-name> <filename> <instr-index> <volume> [<load-mode> [<name>]}
- *
- *  @param pClient          Pointer to client instance structure.
- *  @param pMidiInstr       MIDI instrument bank and program parameter key.
- *  @param pszEngineName    Engine name.
- *  @param pszFileName      Instrument file name.
- *  @param iInstrIndex      Instrument index number.
- *  @param fVolume          Reflects the master volume of the instrument as
- *                          a positive floating point number, where a value
- *                          less than 1.0 for attenuation, and greater than
- *                          1.0 for amplification.
- *  @param load_mode        Instrument load life-time strategy, either
- *                          @ref LSCP_LOAD_DEFAULT, or
- *                          @ref LSCP_LOAD_ON_DEMAND, or
- *                          @ref LSCP_LOAD_ON_DEMAND_HOLD, or
- *                          @ref LSCP_LOAD_PERSISTENT.
- *  @param pszName         Instrument custom name for the map entry (optional).
- *
- *  @returns LSCP_OK on success, LSCP_FAILED otherwise.
- */
-lscp_status_t lscp_map_midi_instrument ( lscp_client_t *pClient,
-	lscp_midi_instrument_t *pMidiInstr, const char *pszEngineName,
-	const char *pszFileName, int iInstrIndex, float fVolume,
-	lscp_load_mode_t load_mode, const char *pszName )
+// Keep a raw response copy and index its field items, no decoding.
+static int _lscp_channel_lazy_load ( lscp_channel_lazy_t *pLazy, const char *pszResult )
 {
-	char szQuery[LSCP_BUFSIZ];
-	struct _locale_t locale;
-
-	if (pMidiInstr->map < 0)
-		return LSCP_FAILED;
-	if (pMidiInstr->bank < 0 || pMidiInstr->bank > 16383)
-		return LSCP_FAILED;
-	if (pMidiInstr->prog < 0 || pMidiInstr->prog > 127)
-		return LSCP_FAILED;
-	if (pszEngineName == NULL || pszFileName == NULL)
-		return LSCP_FAILED;
+	lscp_response_t *pResponse = &(pLazy->response);
+	const char *pszKey;
+	int cchKey, iField, i;
 
-	if (fVolume < 0.0f)
-		fVolume = 1.0f;
+	for (i = 0; i < LSCP_CHANNEL_FIELDS; i++)
+		pLazy->values[i] = -1;
+	pLazy->decoded = 0;
 
-	_save_and_set_c_locale(&locale);
-	sprintf(szQuery, "MAP MIDI_INSTRUMENT %d %d %d %s '%s' %d %g",
-		pMidiInstr->map, pMidiInstr->bank, pMidiInstr->prog,
-		pszEngineName, pszFileName, iInstrIndex, fVolume);
-	_restore_locale(&locale);
+	if (_lscp_response_load(pResponse, pszResult) < 0)
+		return -1;
 
-	switch (load_mode) {
-	case LSCP_LOAD_PERSISTENT:
-		strcat(szQuery, " PERSISTENT");
-		break;
-	case LSCP_LOAD_ON_DEMAND_HOLD:
-		strcat(szQuery, " ON_DEMAND_HOLD");
-		break;
-	case LSCP_LOAD_ON_DEMAND:
-		strcat(szQuery, " ON_DEMAND");
-		break;
-	case LSCP_LOAD_DEFAULT:
-	default:
-		break;
+	iField = 0;
+	for (i = 0; i < pResponse->count; i++) {
+		pszKey = lscp_response_key(pResponse, i, &cchKey);
+		if (pszKey == NULL)
+			continue;
+		// Fields usually come in order, so try the next one first...
+		if (iField >= LSCP_CHANNEL_FIELDS
+			|| (int) strlen(_lscp_channel_keys[iField]) != cchKey
+			|| strncasecmp(pszKey, _lscp_channel_keys[iField], cchKey) != 0) {
+			for (iField = 0; iField < LSCP_CHANNEL_FIELDS; iField++) {
+				if ((int) strlen(_lscp_channel_keys[iField]) == cchKey
+					&& strncasecmp(pszKey, _lscp_channel_keys[iField], cchKey) == 0)
+					break;
+			}
+		}
+		if (iField < LSCP_CHANNEL_FIELDS)
+			pLazy->values[iField++] = i;
 	}
 
-	if (pszName)
-		sprintf(szQuery + strlen(szQuery), " '%s'", pszName);
+	return 0;
+}
 
-	strcat(szQuery, "\r\n");
 
-	return lscp_client_query(pClient, szQuery);
+// Field response item index, if not already decoded; -1 otherwise.
+static int _lscp_channel_lazy_item ( lscp_channel_lazy_t *pLazy, int iField )
+{
+	if (pLazy->decoded & (1U << iField))
+		return -1;
+
+	pLazy->decoded |= (1U << iField);
+
+	return pLazy->values[iField];
 }
 
 
-/**
- *  Remove an entry from the MIDI instrument map:
- *  UNMAP MIDI_INSTRUMENT <midi-map> <midi-bank> <midi-prog>
- *
- *  @param pClient      Pointer to client instance structure.
- *  @param pMidiInstr   MIDI instrument bank and program parameter key.
- *
- *  @returns LSCP_OK on success, LSCP_FAILED otherwise.
- */
-lscp_status_t lscp_unmap_midi_instrument ( lscp_client_t *pClient,
-	lscp_midi_instrument_t *pMidiInstr )
+// Generic integer field decoder.
+static int _lscp_channel_lazy_int ( lscp_channel_lazy_t *pLazy, int iField, int *piValue )
 {
-	char szQuery[LSCP_BUFSIZ];
+	int iItem = _lscp_channel_lazy_item(pLazy, iField);
+	if (iItem >= 0)
+		*piValue = lscp_response_int(&(pLazy->response), iItem, *piValue);
+	return *piValue;
+}
 
-	if (pMidiInstr->map < 0)
-		return LSCP_FAILED;
-	if (pMidiInstr->bank < 0 || pMidiInstr->bank > 16383)
-		return LSCP_FAILED;
-	if (pMidiInstr->prog < 0 || pMidiInstr->prog > 127)
-		return LSCP_FAILED;
 
-	sprintf(szQuery, "UNMAP MIDI_INSTRUMENT %d %d %d\r\n",
-		pMidiInstr->map, pMidiInstr->bank, pMidiInstr->prog);
+// Generic string field decoder (null terminated in place).
+static const char *_lscp_channel_lazy_str ( lscp_channel_lazy_t *pLazy, int iField, char **ppszValue )
+{
+	const char *pszValue;
+	int cchValue;
+	int iItem = _lscp_channel_lazy_item(pLazy, iField);
+	if (iItem >= 0) {
+		pszValue = lscp_response_string(&(pLazy->response), iItem, &cchValue);
+		if (pszValue) {
+			// Safe, as the response text is our own private copy.
+			*ppszValue = (char *) pszValue;
+			(*ppszValue)[cchValue] = (char) 0;
+		}
+	}
+	return *ppszValue;
+}
 
-	return lscp_client_query(pClient, szQuery);
+
+// Generic boolean field decoder.
+static int _lscp_channel_lazy_bool ( lscp_channel_lazy_t *pLazy, int iField, int *piValue )
+{
+	int iItem = _lscp_channel_lazy_item(pLazy, iField);
+	if (iItem >= 0)
+		*piValue = lscp_response_bool(&(pLazy->response), iItem, *piValue);
+	return *piValue;
 }
 
 
 /**
- *  Get the total count of MIDI instrument map entries:
- *  GET MIDI_INSTRUMENTS ALL|<midi-map>
+ *  Getting sampler channel informations, lazily:
+ *  GET CHANNEL INFO <sampler-channel>
  *
- *  @param pClient  Pointer to client instance structure.
- *  @param iMidiMap MIDI instrument map number, or @ref LSCP_MIDI_MAP_ALL .
+ *  Only the raw response is kept and indexed; each field gets decoded
+ *  on its first access through the lscp_channel_lazy_*() accessors,
+ *  without any per-field allocations. Decoded strings and arrays are
+ *  owned by the client and are only valid until the next call.
  *
- *  @returns The current total number of MIDI instrument map entries
- *  on success, -1 otherwise.
+ *  @param pClient          Pointer to client instance structure.
+ *  @param iSamplerChannel  Sampler channel number.
+ *
+ *  @returns A pointer to a lazy channel info descriptor, to be used with
+ *  the lscp_channel_lazy_*() accessor functions, or NULL in case of failure.
  */
-int lscp_get_midi_instruments ( lscp_client_t *pClient, int iMidiMap )
+lscp_channel_lazy_t *lscp_get_channel_info_lazy ( lscp_client_t *pClient, int iSamplerChannel )
 {
-	int iInstruments = -1;
+	lscp_channel_lazy_t *pLazy;
 	char szQuery[LSCP_BUFSIZ];
 
 	if (pClient == NULL)
-		return -1;
+		return NULL;
+	if (iSamplerChannel < 0)
+		return NULL;
 
 	// Lock this section up.
 	lscp_mutex_lock(pClient->mutex);
 
-	strcpy(szQuery, "GET MIDI_INSTRUMENTS ");
-
-	if (iMidiMap < 0)
-		strcat(szQuery, "ALL");
-	else
-		sprintf(szQuery + strlen(szQuery), "%d", iMidiMap);
-
-	strcat(szQuery, "\r\n");
+	pLazy = &(pClient->channel_lazy);
+	lscp_channel_info_init(&(pLazy->info));
 
-	if (lscp_client_call(pClient, szQuery, 0) == LSCP_OK)
-		iInstruments = atoi(lscp_client_get_result(pClient));
+	sprintf(szQuery, "GET CHANNEL INFO %d\r\n", iSamplerChannel);
+	if (lscp_client_call(pClient, szQuery, 1) != LSCP_OK
+		|| _lscp_channel_lazy_load(pLazy, lscp_client_get_result(pClient)) < 0)
+		pLazy = NULL;
 
 	// Unlock this section down.
 	lscp_mutex_unlock(pClient->mutex);
 
-	return iInstruments;
+	return pLazy;
 }
 
 
-/**
- *  Getting indeces of all MIDI instrument map entries:
- *  LIST MIDI_INSTRUMENTS ALL|<midi-map>
+/** Lazy channel info accessor: engine name. */
+const char *lscp_channel_lazy_engine_name ( lscp_channel_lazy_t *pLazy )
+{
+	if (pLazy == NULL)
+		return NULL;
+
+	return _lscp_channel_lazy_str(pLazy, LSCP_CHANNEL_ENGINE_NAME,
+		&(pLazy->info.engine_name));
+}
+
+
+/** Lazy channel info accessor: audio output device number. */
+int lscp_channel_lazy_audio_device ( lscp_channel_lazy_t *pLazy )
+{
+	if (pLazy == NULL)
+		return 0;
+
+	return _lscp_channel_lazy_int(pLazy, LSCP_CHANNEL_AUDIO_OUTPUT_DEVICE,
+		&(pLazy->info.audio_device));
+}
+
+
+/** Lazy channel info accessor: number of audio output channels. */
+int lscp_channel_lazy_audio_channels ( lscp_channel_lazy_t *pLazy )
+{
+	if (pLazy == NULL)
+		return 0;
+
+	return _lscp_channel_lazy_int(pLazy, LSCP_CHANNEL_AUDIO_OUTPUT_CHANNELS,
+		&(pLazy->info.audio_channels));
+}
+
+
+/** Lazy channel info accessor: audio output routing, -1 terminated. */
+const int *lscp_channel_lazy_audio_routing ( lscp_channel_lazy_t *pLazy )
+{
+	const char *pszValue;
+	int *piRouting;
+	int cchValue, iSize, iItem, i, k;
+
+	if (pLazy == NULL)
+		return NULL;
+
+	iItem = _lscp_channel_lazy_item(pLazy, LSCP_CHANNEL_AUDIO_OUTPUT_ROUTING);
+	if (iItem < 0)
+		return pLazy->info.audio_routing;
+
+	pszValue = lscp_response_value(&(pLazy->response), iItem, &cchValue);
+	if (pszValue == NULL || cchValue < 1)
+		return NULL;
+
+	// Reuse routing storage, growing only as needed...
+	iSize = 2;
+	for (k = 0; k < cchValue; k++) {
+		if (pszValue[k] == ',')
+			iSize++;
+	}
+	if (iSize > pLazy->routing_size) {
+		piRouting = (int *) realloc(pLazy->routing, iSize * sizeof(int));
+		if (piRouting == NULL)
+			return NULL;
+		pLazy->routing = piRouting;
+		pLazy->routing_size = iSize;
+	}
+
+	i = 0;
+	pLazy->routing[i++] = lscp_atoi(pszValue);
+	for (k = 0; k < cchValue; k++) {
+		if (pszValue[k] == ',')
+			pLazy->routing[i++] = lscp_atoi(pszValue + k + 1);
+	}
+	pLazy->routing[i] = -1;
+
+	pLazy->info.audio_routing = pLazy->routing;
+	return pLazy->info.audio_routing;
+}
+
+
+/** Lazy channel info accessor: instrument file path. */
+const char *lscp_channel_lazy_instrument_file ( lscp_channel_lazy_t *pLazy )
+{
+	if (pLazy == NULL)
+		return NULL;
+
+	return _lscp_channel_lazy_str(pLazy, LSCP_CHANNEL_INSTRUMENT_FILE,
+		&(pLazy->info.instrument_file));
+}
+
+
+/** Lazy channel info accessor: instrument index number. */
+int lscp_channel_lazy_instrument_nr ( lscp_channel_lazy_t *pLazy )
+{
+	if (pLazy == NULL)
+		return 0;
+
+	return _lscp_channel_lazy_int(pLazy, LSCP_CHANNEL_INSTRUMENT_NR,
+		&(pLazy->info.instrument_nr));
+}
+
+
+/** Lazy channel info accessor: instrument name. */
+const char *lscp_channel_lazy_instrument_name ( lscp_channel_lazy_t *pLazy )
+{
+	if (pLazy == NULL)
+		return NULL;
+
+	return _lscp_channel_lazy_str(pLazy, LSCP_CHANNEL_INSTRUMENT_NAME,
+		&(pLazy->info.instrument_name));
+}
+
+
+/** Lazy channel info accessor: instrument loading status. */
+int lscp_channel_lazy_instrument_status ( lscp_channel_lazy_t *pLazy )
+{
+	if (pLazy == NULL)
+		return 0;
+
+	return _lscp_channel_lazy_int(pLazy, LSCP_CHANNEL_INSTRUMENT_STATUS,
+		&(pLazy->info.instrument_status));
+}
+
+
+/** Lazy channel info accessor: MIDI input device number. */
+int lscp_channel_lazy_midi_device ( lscp_channel_lazy_t *pLazy )
+{
+	if (pLazy == NULL)
+		return 0;
+
+	return _lscp_channel_lazy_int(pLazy, LSCP_CHANNEL_MIDI_INPUT_DEVICE,
+		&(pLazy->info.midi_device));
+}
+
+
+/** Lazy channel info accessor: MIDI input port number. */
+int lscp_channel_lazy_midi_port ( lscp_channel_lazy_t *pLazy )
+{
+	if (pLazy == NULL)
+		return 0;
+
+	return _lscp_channel_lazy_int(pLazy, LSCP_CHANNEL_MIDI_INPUT_PORT,
+		&(pLazy->info.midi_port));
+}
+
+
+/** Lazy channel info accessor: MIDI input channel (or LSCP_MIDI_CHANNEL_ALL). */
+int lscp_channel_lazy_midi_channel ( lscp_channel_lazy_t *pLazy )
+{
+	const char *pszValue;
+	int cchValue, iItem;
+
+	if (pLazy == NULL)
+		return 0;
+
+	iItem = _lscp_channel_lazy_item(pLazy, LSCP_CHANNEL_MIDI_INPUT_CHANNEL);
+	pszValue = lscp_response_value(&(pLazy->response), iItem, &cchValue);
+	if (pszValue) {
+		if (cchValue == 3 && strncasecmp(pszValue, "ALL", 3) == 0)
+			pLazy->info.midi_channel = LSCP_MIDI_CHANNEL_ALL;
+		else
+			pLazy->info.midi_channel = lscp_atoi(pszValue);
+	}
+
+	return pLazy->info.midi_channel;
+}
+
+
+/** Lazy channel info accessor: MIDI instrument map (or LSCP_MIDI_MAP_NONE/DEFAULT). */
+int lscp_channel_lazy_midi_map ( lscp_channel_lazy_t *pLazy )
+{
+	const char *pszValue;
+	int cchValue, iItem;
+
+	if (pLazy == NULL)
+		return 0;
+
+	iItem = _lscp_channel_lazy_item(pLazy, LSCP_CHANNEL_MIDI_INSTRUMENT_MAP);
+	pszValue = lscp_response_value(&(pLazy->response), iItem, &cchValue);
+	if (pszValue) {
+		if (cchValue == 4 && strncasecmp(pszValue, "NONE", 4) == 0)
+			pLazy->info.midi_map = LSCP_MIDI_MAP_NONE;
+		else
+		if (cchValue == 7 && strncasecmp(pszValue, "DEFAULT", 7) == 0)
+			pLazy->info.midi_map = LSCP_MIDI_MAP_DEFAULT;
+		else
+			pLazy->info.midi_map = lscp_atoi(pszValue);
+	}
+
+	return pLazy->info.midi_map;
+}
+
+
+/** Lazy channel info accessor: channel volume. */
+float lscp_channel_lazy_volume ( lscp_channel_lazy_t *pLazy )
+{
+	int iItem;
+
+	if (pLazy == NULL)
+		return 0.0f;
+
+	iItem = _lscp_channel_lazy_item(pLazy, LSCP_CHANNEL_VOLUME);
+	if (iItem >= 0)
+		pLazy->info.volume = lscp_response_float(&(pLazy->response), iItem,
+			pLazy->info.volume);
+
+	return pLazy->info.volume;
+}
+
+
+/** Lazy channel info accessor: channel mute state. */
+int lscp_channel_lazy_mute ( lscp_channel_lazy_t *pLazy )
+{
+	if (pLazy == NULL)
+		return 0;
+
+	return _lscp_channel_lazy_bool(pLazy, LSCP_CHANNEL_MUTE,
+		&(pLazy->info.mute));
+}
+
+
+/** Lazy channel info accessor: channel solo state. */
+int lscp_channel_lazy_solo ( lscp_channel_lazy_t *pLazy )
+{
+	if (pLazy == NULL)
+		return 0;
+
+	return _lscp_channel_lazy_bool(pLazy, LSCP_CHANNEL_SOLO,
+		&(pLazy->info.solo));
+}
+
+
+/**
+ *  Current number of active voices:
+ *  GET CHANNEL VOICE_COUNT <sampler-channel>
  *
- *  @param pClient  Pointer to client instance structure.
- *  @param iMidiMap MIDI instrument map number, or @ref LSCP_MIDI_MAP_ALL .
+ *  @param pClient          Pointer to client instance structure.
+ *  @param iSamplerChannel  Sampler channel number.
  *
- *  @returns An array of @ref lscp_midi_instrument_t, terminated with the
- *  {-1,-1,-1} triplet, NULL otherwise.
+ *  @returns The number of voices currently active, -1 in case of failure.
  */
-lscp_midi_instrument_t *lscp_list_midi_instruments ( lscp_client_t *pClient, int iMidiMap )
+int lscp_get_channel_voice_count ( lscp_client_t *pClient, int iSamplerChannel )
 {
 	char szQuery[LSCP_BUFSIZ];
+	int iVoiceCount = -1;
 
 	if (pClient == NULL)
-		return NULL;
+		return -1;
+	if (iSamplerChannel < 0)
+		return -1;
 
 	// Lock this section up.
 	lscp_mutex_lock(pClient->mutex);
 
-	if (pClient->midi_instruments) {
-		lscp_midi_instruments_destroy(pClient->midi_instruments);
-		pClient->midi_instruments = NULL;
-	}
+	sprintf(szQuery, "GET CHANNEL VOICE_COUNT %d\r\n", iSamplerChannel);
+	if (lscp_client_call(pClient, szQuery, 0) == LSCP_OK)
+		iVoiceCount = lscp_atoi(lscp_client_get_result(pClient));
 
-	strcpy(szQuery, "LIST MIDI_INSTRUMENTS ");
+	// Unlock this section down.
+	lscp_mutex_unlock(pClient->mutex);
 
-	if (iMidiMap < 0)
-		strcat(szQuery, "ALL");
-	else
-		sprintf(szQuery + strlen(szQuery), "%d", iMidiMap);
+	return iVoiceCount;
+}
 
-	strcat(szQuery, "\r\n");
 
+/**
+ *  Current number of active disk streams:
+ *  GET CHANNEL STREAM_COUNT <sampler-channel>
+ *
+ *  @param pClient          Pointer to client instance structure.
+ *  @param iSamplerChannel  Sampler channel number.
+ *
+ *  @returns The number of active disk streams on success, -1 otherwise.
+ */
+int lscp_get_channel_stream_count ( lscp_client_t *pClient, int iSamplerChannel )
+{
+	char szQuery[LSCP_BUFSIZ];
+	int iStreamCount = -1;
+
+	if (pClient == NULL)
+		return -1;
+	if (iSamplerChannel < 0)
+		return -1;
+
+	// Lock this section up.
+	lscp_mutex_lock(pClient->mutex);
+
+	sprintf(szQuery, "GET CHANNEL STREAM_COUNT %d\r\n", iSamplerChannel);
 	if (lscp_client_call(pClient, szQuery, 0) == LSCP_OK)
-		pClient->midi_instruments = lscp_midi_instruments_create(
-			lscp_client_get_result(pClient));
+		iStreamCount = lscp_atoi(lscp_client_get_result(pClient));
 
 	// Unlock this section down.
 	lscp_mutex_unlock(pClient->mutex);
 
-	return pClient->midi_instruments;
+	return iStreamCount;
 }
 
 
 /**
- *  Getting information about a MIDI instrument map entry:
- *  GET MIDI_INSTRUMENT INFO <midi-map> <midi-bank> <midi-prog>
+ *  Current least usage of active disk streams.
  *
- *  @param pClient      Pointer to client instance structure.
- *  @param pMidiInstr   MIDI instrument bank and program parameter key.
+ *  @param pClient          Pointer to client instance structure.
+ *  @param iSamplerChannel  Sampler channel number.
  *
- *  @returns A pointer to a @ref lscp_midi_instrument_info_t structure,
- *  with all the information of the given MIDI instrument map entry,
- *  or NULL in case of failure.
+ *  @returns The usage percentage of the least filled active disk stream
+ *  on success, -1 otherwise.
  */
-lscp_midi_instrument_info_t *lscp_get_midi_instrument_info ( lscp_client_t *pClient,
-	lscp_midi_instrument_t *pMidiInstr )
+int lscp_get_channel_stream_usage ( lscp_client_t *pClient, int iSamplerChannel )
 {
-	lscp_midi_instrument_info_t *pInstrInfo;
 	char szQuery[LSCP_BUFSIZ];
+	int  iStreamUsage = -1;
 	const char *pszResult;
-	const char *pszSeps = ":";
-	const char *pszCrlf = "\r\n";
+	const char *pszSeps = "[]%,";
 	char *pszToken;
 	char *pch;
-	struct _locale_t locale;
+	int   iStream;
+	int   iPercent;
 
 	if (pClient == NULL)
-		return NULL;
-	if (pMidiInstr->map < 0)
-		return NULL;
-	if (pMidiInstr->bank < 0 || pMidiInstr->bank > 16383)
-		return NULL;
-	if (pMidiInstr->prog < 0 || pMidiInstr->prog > 127)
-		return NULL;
+		return -1;
+	if (iSamplerChannel < 0)
+		return -1;
 
 	// Lock this section up.
 	lscp_mutex_lock(pClient->mutex);
 
-	_save_and_set_c_locale(&locale);
-
-	pInstrInfo = &(pClient->midi_instrument_info);
-	lscp_midi_instrument_info_reset(pInstrInfo);
-
-	sprintf(szQuery, "GET MIDI_INSTRUMENT INFO %d %d %d\r\n",
-		pMidiInstr->map, pMidiInstr->bank, pMidiInstr->prog);
-	if (lscp_client_call(pClient, szQuery, 1) == LSCP_OK) {
+	iStream = 0;
+	sprintf(szQuery, "GET CHANNEL BUFFER_FILL PERCENTAGE %d\r\n", iSamplerChannel);
+	if (lscp_client_call(pClient, szQuery, 0) == LSCP_OK) {
 		pszResult = lscp_client_get_result(pClient);
 		pszToken = lscp_strtok((char *) pszResult, pszSeps, &(pch));
 		while (pszToken) {
-			if (strcasecmp(pszToken, "NAME") == 0) {
-				pszToken = lscp_strtok(NULL, pszCrlf, &(pch));
-				if (pszToken)
-					lscp_unquote_dup(&(pInstrInfo->name), &pszToken);
-			}
-			else if (strcasecmp(pszToken, "ENGINE_NAME") == 0) {
-				pszToken = lscp_strtok(NULL, pszCrlf, &(pch));
-				if (pszToken)
-					lscp_unquote_dup(&(pInstrInfo->engine_name), &pszToken);
-			}
-			else if (strcasecmp(pszToken, "INSTRUMENT_FILE") == 0) {
-				pszToken = lscp_strtok(NULL, pszCrlf, &(pch));
-				if (pszToken)
-					lscp_unquote_dup(&(pInstrInfo->instrument_file), &pszToken);
-			}
-			else if (strcasecmp(pszToken, "INSTRUMENT_NR") == 0) {
-				pszToken = lscp_strtok(NULL, pszCrlf, &(pch));
-				if (pszToken)
-					pInstrInfo->instrument_nr = atoi(lscp_ltrim(pszToken));
-			}
-			else if (strcasecmp(pszToken, "INSTRUMENT_NAME") == 0) {
-				pszToken = lscp_strtok(NULL, pszCrlf, &(pch));
-				if (pszToken)
-					lscp_unquote_dup(&(pInstrInfo->instrument_name), &pszToken);
-			}
-			else if (strcasecmp(pszToken, "LOAD_MODE") == 0) {
-				pszToken = lscp_strtok(NULL, pszCrlf, &(pch));
-				if (pszToken) {
-					pszToken = lscp_ltrim(pszToken);
-					if (strcasecmp(pszToken, "ON_DEMAND") == 0)
-						pInstrInfo->load_mode = LSCP_LOAD_ON_DEMAND;
-					else
-					if (strcasecmp(pszToken, "ON_DEMAND_HOLD") == 0)
-						pInstrInfo->load_mode = LSCP_LOAD_ON_DEMAND_HOLD;
-					else
-					if (strcasecmp(pszToken, "PERSISTENT") == 0)
-						pInstrInfo->load_mode = LSCP_LOAD_PERSISTENT;
-					else
-						pInstrInfo->load_mode = LSCP_LOAD_DEFAULT;
-				}
-			}
-			else if (strcasecmp(pszToken, "VOLUME") == 0) {
-				pszToken = lscp_strtok(NULL, pszCrlf, &(pch));
-				if (pszToken)
-					pInstrInfo->volume = _atof(lscp_ltrim(pszToken));
+			if (*pszToken) {
+				// Skip stream id.
+				pszToken = lscp_strtok(NULL, pszSeps, &(pch));
+				if (pszToken == NULL)
+					break;
+				// Get least buffer fill percentage.
+				iPercent = atol(pszToken);
+				if (iStreamUsage > iPercent || iStream == 0)
+					iStreamUsage = iPercent;
+				iStream++;
 			}
 			pszToken = lscp_strtok(NULL, pszSeps, &(pch));
 		}
 	}
-	else pInstrInfo = NULL;
-
-	_restore_locale(&locale);
 
 	// Unlock this section down.
 	lscp_mutex_unlock(pClient->mutex);
 
-	return pInstrInfo;
+	return iStreamUsage;
 }
 
 
 /**
- *  Clear the MIDI instrumnet map:
- *  CLEAR MIDI_INSTRUMENTS ALL|<midi-map>
+ *  Current fill state of disk stream buffers:
+ *  GET CHANNEL BUFFER_FILL {BYTES|PERCENTAGE} <sampler-channel>
  *
- *  @param pClient  Pointer to client instance structure.
- *  @param iMidiMap MIDI instrument map number, or @ref LSCP_MIDI_MAP_ALL .
+ *  @param pClient          Pointer to client instance structure.
+ *  @param usage_type       Usage type to be returned, either
+ *                          @ref LSCP_USAGE_BYTES, or
+ *                          @ref LSCP_USAGE_PERCENTAGE.
+ *  @param iSamplerChannel  Sampler channel number.
  *
- *  @returns LSCP_OK on success, LSCP_FAILED otherwise.
+ *  @returns A pointer to a @ref lscp_buffer_fill_t array, with the
+ *  information of the current disk stream buffer fill usage, for the given
+ *  sampler channel, or NULL in case of failure. The array holds one entry
+ *  per stream as found in the server response, and is terminated by an
+ *  extra entry whose stream_id is @ref LSCP_BUFFER_FILL_END.
  */
-lscp_status_t lscp_clear_midi_instruments  ( lscp_client_t *pClient, int iMidiMap )
+lscp_buffer_fill_t *lscp_get_channel_buffer_fill ( lscp_client_t *pClient,
+	lscp_usage_t usage_type, int iSamplerChannel )
 {
+	lscp_buffer_fill_t *pBufferFill = NULL;
 	char szQuery[LSCP_BUFSIZ];
+	const char *pszUsageType = (usage_type == LSCP_USAGE_BYTES ? "BYTES" : "PERCENTAGE");
+	const char *pszResult;
+	int iStreamCount;
+	lscp_telemetry_alert_t alerts[LSCP_TELEMETRY_ALERTS];
+	int iAlerts = 0;
 
-	strcpy(szQuery, "CLEAR MIDI_INSTRUMENTS ");
+	if (pClient == NULL)
+		return NULL;
+	if (iSamplerChannel < 0)
+		return NULL;
+
+	// Lock this section up.
+	lscp_mutex_lock(pClient->mutex);
+
+	// Get buffer fill usage, sizing storage from the response itself...
+	sprintf(szQuery, "GET CHANNEL BUFFER_FILL %s %d\r\n", pszUsageType, iSamplerChannel);
+	if (lscp_client_call(pClient, szQuery, 0) == LSCP_OK) {
+		pszResult = lscp_client_get_result(pClient);
+		iStreamCount = lscp_buffer_fill_parse(pszResult,
+			pszResult + strlen(pszResult),
+			&(pClient->buffer_fill),
+			&(pClient->buffer_fill_size), NULL);
+		if (iStreamCount >= 0) {
+			pClient->iStreamCount = iStreamCount;
+			pBufferFill = pClient->buffer_fill;
+		}
+	}
+
+	// Keep the telemetry time-series recorded...
+	if (pBufferFill && usage_type == LSCP_USAGE_PERCENTAGE
+		&& pClient->telemetry.enabled) {
+		iAlerts = lscp_telemetry_fill(&(pClient->telemetry),
+			iSamplerChannel, pBufferFill, iStreamCount, alerts);
+	}
+
+	// Unlock this section down.
+	lscp_mutex_unlock(pClient->mutex);
+
+	if (iAlerts > 0)
+		lscp_telemetry_notify(pClient, alerts, iAlerts);
+
+	return pBufferFill;
+}
+
+
+/**
+ *  Setting audio output type:
+ *  SET CHANNEL AUDIO_OUTPUT_TYPE <sampler-channel> <audio-output-type>
+ *
+ *  @param pClient          Pointer to client instance structure.
+ *  @param iSamplerChannel  Sampler channel number.
+ *  @param pszAudioDriver   Audio output driver type (e.g. "ALSA" or "JACK").
+ *
+ *  @returns LSCP_OK on success, LSCP_FAILED otherwise.
+ */
+lscp_status_t lscp_set_channel_audio_type ( lscp_client_t *pClient,
+	int iSamplerChannel, const char *pszAudioDriver )
+{
+	char szQuery[LSCP_BUFSIZ];
+	lscp_status_t ret;
+
+	if (iSamplerChannel < 0 || pszAudioDriver == NULL)
+		return LSCP_FAILED;
+
+	sprintf(szQuery, "SET CHANNEL AUDIO_OUTPUT_TYPE %d %s\r\n",
+		iSamplerChannel, pszAudioDriver);
+	ret = lscp_client_query(pClient, szQuery);
+	_lscp_channel_cache_invalidate(pClient, iSamplerChannel);
+
+	return ret;
+}
+
+
+/**
+ *  Setting audio output device:
+ *  SET CHANNEL AUDIO_OUTPUT_DEVICE <sampler-channel> <device-id>
+ *
+ *  @param pClient          Pointer to client instance structure.
+ *  @param iSamplerChannel  Sampler channel number.
+ *  @param iAudioDevice     Audio output device number identifier.
+ *
+ *  @returns LSCP_OK on success, LSCP_FAILED otherwise.
+ */
+lscp_status_t lscp_set_channel_audio_device ( lscp_client_t *pClient,
+	int iSamplerChannel, int iAudioDevice )
+{
+	char szQuery[LSCP_BUFSIZ];
+	lscp_status_t ret;
+
+	if (iSamplerChannel < 0 || iAudioDevice < 0)
+		return LSCP_FAILED;
+
+	sprintf(szQuery, "SET CHANNEL AUDIO_OUTPUT_DEVICE %d %d\r\n",
+		iSamplerChannel, iAudioDevice);
+	ret = lscp_client_query(pClient, szQuery);
+	_lscp_channel_cache_invalidate(pClient, iSamplerChannel);
+
+	return ret;
+}
+
+
+/**
+ *  Setting audio output channel:
+ *  SET CHANNEL AUDIO_OUTPUT_CHANNEL <sampler-channel> <audio-output-chan> <audio-input-chan>
+ *
+ *  @param pClient          Pointer to client instance structure.
+ *  @param iSamplerChannel  Sampler channel number.
+ *  @param iAudioOut        Audio output device channel to be routed from.
+ *  @param iAudioIn         Audio output device channel to be routed into.
+ *
+ *  @returns LSCP_OK on success, LSCP_FAILED otherwise.
+ */
+lscp_status_t lscp_set_channel_audio_channel ( lscp_client_t *pClient,
+	int iSamplerChannel, int iAudioOut, int iAudioIn )
+{
+	char szQuery[LSCP_BUFSIZ];
+	lscp_channel_info_t *pChannelInfo;
+	lscp_status_t ret;
+
+	if (iSamplerChannel < 0 || iAudioOut < 0 || iAudioIn < 0)
+		return LSCP_FAILED;
+
+	sprintf(szQuery, "SET CHANNEL AUDIO_OUTPUT_CHANNEL %d %d %d\r\n",
+		iSamplerChannel, iAudioOut, iAudioIn);
+	ret = lscp_client_query(pClient, szQuery);
+	if (ret == LSCP_OK) {
+		// Write-through the channel info cache...
+		pChannelInfo = _lscp_channel_cache_lock(pClient, iSamplerChannel);
+		if (pChannelInfo) {
+			if (pChannelInfo->audio_routing
+				&& iAudioOut < pChannelInfo->audio_channels)
+				pChannelInfo->audio_routing[iAudioOut] = iAudioIn;
+			_lscp_channel_cache_unlock(pClient);
+		}
+	}
+
+	return ret;
+}
+
+
+/**
+ *  Setting MIDI input type:
+ *  SET CHANNEL MIDI_INPUT_TYPE <sampler-channel> <midi-input-type>
+ *
+ *  @param pClient          Pointer to client instance structure.
+ *  @param iSamplerChannel  Sampler channel number.
+ *  @param pszMidiDriver    MIDI input driver type (e.g. "ALSA").
+ *
+ *  @returns LSCP_OK on success, LSCP_FAILED otherwise.
+ */
+lscp_status_t lscp_set_channel_midi_type ( lscp_client_t *pClient,
+	int iSamplerChannel, const char *pszMidiDriver )
+{
+	char szQuery[LSCP_BUFSIZ];
+	lscp_status_t ret;
+
+	if (iSamplerChannel < 0 || pszMidiDriver == NULL)
+		return LSCP_FAILED;
+
+	sprintf(szQuery, "SET CHANNEL MIDI_INPUT_TYPE %d %s\r\n",
+		iSamplerChannel, pszMidiDriver);
+	ret = lscp_client_query(pClient, szQuery);
+	_lscp_channel_cache_invalidate(pClient, iSamplerChannel);
+
+	return ret;
+}
+
+
+/**
+ *  Setting MIDI input device:
+ *  SET CHANNEL MIDI_INPUT_DEVICE <sampler-channel> <device-id>
+ *
+ *  @param pClient          Pointer to client instance structure.
+ *  @param iSamplerChannel  Sampler channel number.
+ *  @param iMidiDevice      MIDI input device number identifier.
+ *
+ *  @returns LSCP_OK on success, LSCP_FAILED otherwise.
+ */
+lscp_status_t lscp_set_channel_midi_device ( lscp_client_t *pClient,
+	int iSamplerChannel, int iMidiDevice )
+{
+	char szQuery[LSCP_BUFSIZ];
+	lscp_channel_info_t *pChannelInfo;
+	lscp_status_t ret;
+
+	if (iSamplerChannel < 0 || iMidiDevice < 0)
+		return LSCP_FAILED;
+
+	sprintf(szQuery, "SET CHANNEL MIDI_INPUT_DEVICE %d %d\r\n",
+		iSamplerChannel, iMidiDevice);
+	ret = lscp_client_query(pClient, szQuery);
+	if (ret == LSCP_OK) {
+		// Write-through the channel info cache...
+		pChannelInfo = _lscp_channel_cache_lock(pClient, iSamplerChannel);
+		if (pChannelInfo) {
+			pChannelInfo->midi_device = iMidiDevice;
+			_lscp_channel_cache_unlock(pClient);
+		}
+	}
+
+	return ret;
+}
+
+
+/**
+ *  Setting MIDI input port:
+ *  SET CHANNEL MIDI_INPUT_PORT <sampler-channel> <midi-input-port>
+ *
+ *  @param pClient          Pointer to client instance structure.
+ *  @param iSamplerChannel  Sampler channel number.
+ *  @param iMidiPort        MIDI input driver virtual port number.
+ *
+ *  @returns LSCP_OK on success, LSCP_FAILED otherwise.
+ */
+lscp_status_t lscp_set_channel_midi_port ( lscp_client_t *pClient,
+	int iSamplerChannel, int iMidiPort )
+{
+	char szQuery[LSCP_BUFSIZ];
+	lscp_channel_info_t *pChannelInfo;
+	lscp_status_t ret;
+
+	if (iSamplerChannel < 0 || iMidiPort < 0)
+		return LSCP_FAILED;
+
+	sprintf(szQuery, "SET CHANNEL MIDI_INPUT_PORT %d %d\r\n",
+		iSamplerChannel, iMidiPort);
+	ret = lscp_client_query(pClient, szQuery);
+	if (ret == LSCP_OK) {
+		// Write-through the channel info cache...
+		pChannelInfo = _lscp_channel_cache_lock(pClient, iSamplerChannel);
+		if (pChannelInfo) {
+			pChannelInfo->midi_port = iMidiPort;
+			_lscp_channel_cache_unlock(pClient);
+		}
+	}
+
+	return ret;
+}
+
+
+/**
+ *  Setting MIDI input channel:
+ *  SET CHANNEL MIDI_INPUT_CHANNEL <sampler-channel> <midi-input-chan>
+ *
+ *  @param pClient          Pointer to client instance structure.
+ *  @param iSamplerChannel  Sampler channel number.
+ *  @param iMidiChannel     MIDI channel address number to listen (0-15) or
+ *                          @ref LSCP_MIDI_CHANNEL_ALL (16) to listen on all channels.
+ *
+ *  @returns LSCP_OK on success, LSCP_FAILED otherwise.
+ */
+lscp_status_t lscp_set_channel_midi_channel ( lscp_client_t *pClient,
+	int iSamplerChannel, int iMidiChannel )
+{
+	char szQuery[LSCP_BUFSIZ];
+	lscp_channel_info_t *pChannelInfo;
+	lscp_status_t ret;
+
+	if (iSamplerChannel < 0 || iMidiChannel < 0 || iMidiChannel > 16)
+		return LSCP_FAILED;
+
+	if (iMidiChannel == LSCP_MIDI_CHANNEL_ALL)
+		sprintf(szQuery, "SET CHANNEL MIDI_INPUT_CHANNEL %d ALL\r\n",
+			iSamplerChannel);
+	else
+		sprintf(szQuery, "SET CHANNEL MIDI_INPUT_CHANNEL %d %d\r\n",
+			iSamplerChannel, iMidiChannel);
+	ret = lscp_client_query(pClient, szQuery);
+	if (ret == LSCP_OK) {
+		// Write-through the channel info cache...
+		pChannelInfo = _lscp_channel_cache_lock(pClient, iSamplerChannel);
+		if (pChannelInfo) {
+			pChannelInfo->midi_channel = iMidiChannel;
+			_lscp_channel_cache_unlock(pClient);
+		}
+	}
+
+	return ret;
+}
+
+
+/**
+ *  Setting MIDI instrument map:
+ *  SET CHANNEL MIDI_INSTRUMENT_MAP <sampler-channel> <midi-map>
+ *
+ *  @param pClient          Pointer to client instance structure.
+ *  @param iSamplerChannel  Sampler channel number.
+ *  @param iMidiMap         MIDI instrument map number, or either
+ *                          @ref LSCP_MIDI_MAP_NONE or
+ *                          @ref LSCP_MIDI_MAP_DEFAULT .
+ *
+ *  @returns LSCP_OK on success, LSCP_FAILED otherwise.
+ */
+lscp_status_t lscp_set_channel_midi_map ( lscp_client_t *pClient,
+	int iSamplerChannel, int iMidiMap )
+{
+	char szQuery[LSCP_BUFSIZ];
+	lscp_channel_info_t *pChannelInfo;
+	lscp_status_t ret;
+
+	if (iSamplerChannel < 0)
+		return LSCP_FAILED;
+
+	sprintf(szQuery, "SET CHANNEL MIDI_INSTRUMENT_MAP %d ", iSamplerChannel);
+	if (iMidiMap == LSCP_MIDI_MAP_NONE)
+		strcat(szQuery , "NONE");
+	else
+	if (iMidiMap == LSCP_MIDI_MAP_DEFAULT)
+		strcat(szQuery , "DEFAULT");
+	else
+		sprintf(szQuery + strlen(szQuery), "%d", iMidiMap);
+
+	strcat(szQuery, "\r\n");
+
+	ret = lscp_client_query(pClient, szQuery);
+	if (ret == LSCP_OK) {
+		// Write-through the channel info cache...
+		pChannelInfo = _lscp_channel_cache_lock(pClient, iSamplerChannel);
+		if (pChannelInfo) {
+			pChannelInfo->midi_map = iMidiMap;
+			_lscp_channel_cache_unlock(pClient);
+		}
+	}
+
+	return ret;
+}
+
+
+/**
+ *  Setting channel volume:
+ *  SET CHANNEL VOLUME <sampler-channel> <volume>
+ *
+ *  @param pClient          Pointer to client instance structure.
+ *  @param iSamplerChannel  Sampler channel number.
+ *  @param fVolume          Sampler channel volume as a positive floating point
+ *                          number, where a value less than 1.0 for attenuation,
+ *                          and greater than 1.0 for amplification.
+ *
+ *  @returns LSCP_OK on success, LSCP_FAILED otherwise.
+ */
+lscp_status_t lscp_set_channel_volume ( lscp_client_t *pClient,
+	int iSamplerChannel, float fVolume )
+{
+	char szQuery[LSCP_BUFSIZ];
+	char szVolume[32];
+	lscp_channel_info_t *pChannelInfo;
+	lscp_status_t ret;
+
+	if (iSamplerChannel < 0 || fVolume < 0.0f)
+		return LSCP_FAILED;
+
+	lscp_ftoa(szVolume, sizeof(szVolume), fVolume);
+	sprintf(szQuery, "SET CHANNEL VOLUME %d %s\r\n",
+		iSamplerChannel, szVolume);
+
+	ret = lscp_client_query(pClient, szQuery);
+	if (ret == LSCP_OK) {
+		// Write-through the channel info cache...
+		pChannelInfo = _lscp_channel_cache_lock(pClient, iSamplerChannel);
+		if (pChannelInfo) {
+			pChannelInfo->volume = fVolume;
+			_lscp_channel_cache_unlock(pClient);
+		}
+	}
+
+	return ret;
+}
+
+
+/**
+ *  Muting a sampler channel:
+ *  SET CHANNEL MUTE <sampler-channel> <mute>
+ *
+ *  @param pClient          Pointer to client instance structure.
+ *  @param iSamplerChannel  Sampler channel number.
+ *  @param iMute            Sampler channel mute state as a boolean value,
+ *                          either 1 (one) to mute the channel or 0 (zero)
+ *                          to unmute the channel.
+ *
+ *  @returns LSCP_OK on success, LSCP_FAILED otherwise.
+ */
+lscp_status_t lscp_set_channel_mute ( lscp_client_t *pClient,
+	int iSamplerChannel, int iMute )
+{
+	char szQuery[LSCP_BUFSIZ];
+	lscp_channel_info_t *pChannelInfo;
+	lscp_status_t ret;
+
+	if (iSamplerChannel < 0 || iMute < 0 || iMute > 1)
+		return LSCP_FAILED;
+
+	sprintf(szQuery, "SET CHANNEL MUTE %d %d\r\n",
+		iSamplerChannel, iMute);
+	ret = lscp_client_query(pClient, szQuery);
+	if (ret == LSCP_OK) {
+		// Write-through the channel info cache...
+		pChannelInfo = _lscp_channel_cache_lock(pClient, iSamplerChannel);
+		if (pChannelInfo) {
+			pChannelInfo->mute = iMute;
+			_lscp_channel_cache_unlock(pClient);
+		}
+	}
+
+	return ret;
+}
+
+
+/**
+ *  Soloing a sampler channel:
+ *  SET CHANNEL SOLO <sampler-channel> <solo>
+ *
+ *  @param pClient          Pointer to client instance structure.
+ *  @param iSamplerChannel  Sampler channel number.
+ *  @param iSolo            Sampler channel solo state as a boolean value,
+ *                          either 1 (one) to solo the channel or 0 (zero)
+ *                          to unsolo the channel.
+ *
+ *  @returns LSCP_OK on success, LSCP_FAILED otherwise.
+ */
+lscp_status_t lscp_set_channel_solo ( lscp_client_t *pClient,
+	int iSamplerChannel, int iSolo )
+{
+	char szQuery[LSCP_BUFSIZ];
+	lscp_channel_info_t *pChannelInfo;
+	lscp_status_t ret;
+
+	if (iSamplerChannel < 0 || iSolo < 0 || iSolo > 1)
+		return LSCP_FAILED;
+
+	sprintf(szQuery, "SET CHANNEL SOLO %d %d\r\n",
+		iSamplerChannel, iSolo);
+	ret = lscp_client_query(pClient, szQuery);
+	if (ret == LSCP_OK) {
+		// Write-through the channel info cache...
+		pChannelInfo = _lscp_channel_cache_lock(pClient, iSamplerChannel);
+		if (pChannelInfo) {
+			pChannelInfo->solo = iSolo;
+			_lscp_channel_cache_unlock(pClient);
+		}
+	}
+
+	return ret;
+}
+
+
+/**
+ *  Resetting a sampler channel:
+ *  RESET CHANNEL <sampler-channel>
+ *
+ *  @param pClient          Pointer to client instance structure.
+ *  @param iSamplerChannel  Sampler channel number.
+ *
+ *  @returns LSCP_OK on success, LSCP_FAILED otherwise.
+ */
+lscp_status_t lscp_reset_channel ( lscp_client_t *pClient, int iSamplerChannel )
+{
+	char szQuery[LSCP_BUFSIZ];
+	lscp_status_t ret;
+
+	if (iSamplerChannel < 0)
+		return LSCP_FAILED;
+
+	sprintf(szQuery, "RESET CHANNEL %d\r\n", iSamplerChannel);
+	ret = lscp_client_query(pClient, szQuery);
+	_lscp_channel_cache_invalidate(pClient, iSamplerChannel);
+
+	return ret;
+}
+
+
+/**
+ *  Resetting the sampler:
+ *  RESET
+ *
+ *  @param pClient  Pointer to client instance structure.
+ *
+ *  @returns LSCP_OK on success, LSCP_FAILED otherwise.
+ */
+lscp_status_t lscp_reset_sampler ( lscp_client_t *pClient )
+{
+	lscp_status_t ret;
+
+	// Do actual whole sampler reset...
+	ret = lscp_client_query(pClient, "RESET\r\n");
+	_lscp_channel_cache_invalidate(pClient, -1);
+
+	return ret;
+}
+
+
+/**
+ *  Getting information about the server.
+ *  GET SERVER INFO
+ *
+ *  @param pClient  Pointer to client instance structure.
+ *
+ *  @returns A pointer to a @ref lscp_server_info_t structure, with all the
+ *  information of the current connected server, or NULL in case of failure.
+ */
+lscp_server_info_t *lscp_get_server_info ( lscp_client_t *pClient )
+{
+	if (pClient == NULL)
+		return NULL;
+
+	return _lscp_server_info_query(pClient, &(pClient->server_info));
+}
+
+
+/**
+ *  Getting a snapshot of information about the server.
+ *  GET SERVER INFO
+ *
+ *  @param pClient  Pointer to client instance structure.
+ *
+ *  @returns A pointer to an immutable and reference-counted @ref lscp_server_info_t
+ *  snapshot, owned by the caller and valid across any subsequent calls,
+ *  which must be released with @ref lscp_snapshot_unref when done,
+ *  or NULL in case of failure.
+ */
+const lscp_server_info_t *lscp_get_server_info_snapshot ( lscp_client_t *pClient )
+{
+	lscp_server_info_t *pServerInfo;
+
+	if (pClient == NULL)
+		return NULL;
+
+	pServerInfo = (lscp_server_info_t *) lscp_snapshot_alloc(LSCP_SNAPSHOT_SERVER_INFO);
+	if (pServerInfo && _lscp_server_info_query(pClient, pServerInfo) == NULL) {
+		lscp_snapshot_unref(pServerInfo);
+		pServerInfo = NULL;
+	}
+
+	return pServerInfo;
+}
+
+
+// Common server info query command.
+static lscp_server_info_t *_lscp_server_info_query ( lscp_client_t *pClient,
+	lscp_server_info_t *pServerInfo )
+{
+	const char *pszResult;
+	const char *pszSeps = ":";
+	const char *pszCrlf = "\r\n";
+	char *pszToken;
+	char *pch;
+
+	// Lock this section up.
+	lscp_mutex_lock(pClient->mutex);
+
+	lscp_server_info_reset(pServerInfo);
+	if (lscp_client_call(pClient, "GET SERVER INFO\r\n", 1) == LSCP_OK) {
+		pszResult = lscp_client_get_result(pClient);
+		pszToken = lscp_strtok((char *) pszResult, pszSeps, &(pch));
+		while (pszToken) {
+			if (strcasecmp(pszToken, "DESCRIPTION") == 0) {
+				pszToken = lscp_strtok(NULL, pszCrlf, &(pch));
+				if (pszToken)
+					lscp_unquote_dup(&(pServerInfo->description), &pszToken);
+			}
+			else if (strcasecmp(pszToken, "VERSION") == 0) {
+				pszToken = lscp_strtok(NULL, pszCrlf, &(pch));
+				if (pszToken)
+					lscp_unquote_dup(&(pServerInfo->version), &pszToken);
+			}
+			else if (strcasecmp(pszToken, "PROTOCOL_VERSION") == 0) {
+				pszToken = lscp_strtok(NULL, pszCrlf, &(pch));
+				if (pszToken)
+					lscp_unquote_dup(&(pServerInfo->protocol_version), &pszToken);
+			}
+			pszToken = lscp_strtok(NULL, pszSeps, &(pch));
+		}
+	}
+	else pServerInfo = NULL;
+
+	// Unlock this section down.
+	lscp_mutex_unlock(pClient->mutex);
+
+	return pServerInfo;
+}
+
+
+/**
+ *  Current total number of active voices:
+ *  GET TOTAL_VOICE_COUNT
+ *
+ *  @param pClient  Pointer to client instance structure.
+ *
+ *  @returns The total number of voices currently active,
+ *  -1 in case of failure.
+ */
+int lscp_get_total_voice_count ( lscp_client_t *pClient )
+{
+	int iVoiceCount = -1;
+
+	if (pClient == NULL)
+		return -1;
+
+	// Lock this section up.
+	lscp_mutex_lock(pClient->mutex);
+
+	if (lscp_client_call(pClient, "GET TOTAL_VOICE_COUNT\r\n", 0) == LSCP_OK)
+		iVoiceCount = lscp_atoi(lscp_client_get_result(pClient));
+
+	// Unlock this section down.
+	lscp_mutex_unlock(pClient->mutex);
+
+	return iVoiceCount;
+}
+
+
+/**
+ *  Maximum amount of active voices:
+ *  GET TOTAL_VOICE_COUNT_MAX
+ *
+ *  @param pClient  Pointer to client instance structure.
+ *
+ *  @returns The maximum amount of voices currently active,
+ *  -1 in case of failure.
+ */
+int lscp_get_total_voice_count_max ( lscp_client_t *pClient )
+{
+	int iVoiceCount = -1;
+
+	if (pClient == NULL)
+		return -1;
+
+	// Lock this section up.
+	lscp_mutex_lock(pClient->mutex);
+
+	if (lscp_client_call(pClient, "GET TOTAL_VOICE_COUNT_MAX\r\n", 0) == LSCP_OK)
+		iVoiceCount = lscp_atoi(lscp_client_get_result(pClient));
+
+	// Unlock this section down.
+	lscp_mutex_unlock(pClient->mutex);
+
+	return iVoiceCount;
+}
+
+
+/**
+ *  Get global volume attenuation:
+ *  GET VOLUME
+ *
+ *  @param pClient  Pointer to client instance structure.
+ *
+ *  @returns The global volume as positive floating point value usually in
+ *  the range between 0.0 and 1.0; in case of failure 0.0 is returned.
+ */
+float lscp_get_volume ( lscp_client_t *pClient )
+{
+	float fVolume = 0.0f;
+
+	if (pClient == NULL)
+		return 0.0f;
+
+	// Lock this section up.
+	lscp_mutex_lock(pClient->mutex);
+
+
+	if (lscp_client_call(pClient, "GET VOLUME\r\n", 0) == LSCP_OK)
+		fVolume = lscp_atof(lscp_client_get_result(pClient));
+
+
+	// Unlock this section down.
+	lscp_mutex_unlock(pClient->mutex);
+
+	return fVolume;
+}
+
+
+/**
+ *  Setting global volume attenuation:
+ *  SET VOLUME <volume>
+ *
+ *  @param pClient  Pointer to client instance structure.
+ *  @param fVolume  Global volume parameter as positive floating point
+ *                  value usually be in the range between 0.0 and 1.0,
+ *                  that is for attenuating the overall volume.
+ *
+ *  @returns LSCP_OK on success, LSCP_FAILED otherwise.
+ */
+lscp_status_t lscp_set_volume ( lscp_client_t *pClient, float fVolume )
+{
+	char szQuery[LSCP_BUFSIZ];
+	char szVolume[32];
+
+	if (fVolume < 0.0f)
+		return LSCP_FAILED;
+
+	lscp_ftoa(szVolume, sizeof(szVolume), fVolume);
+	sprintf(szQuery, "SET VOLUME %s\r\n", szVolume);
+
+	return lscp_client_query(pClient, szQuery);
+}
+
+
+/**
+ *  Get global voice limit setting:
+ *  @code
+ *  GET VOICES
+ *  @endcode
+ *  This value reflects the maximum amount of voices a sampler engine
+ *  processes simultaniously before voice stealing kicks in.
+ *
+ *  @param pClient  Pointer to client instance structure.
+ *
+ *  @returns The current global maximum amount of voices limit or a
+ *           negative value on error (e.g. if sampler doesn't support
+ *           this command).
+ */
+int lscp_get_voices ( lscp_client_t *pClient )
+{
+	int iVoices = -1;
+
+	if (pClient == NULL)
+		return -1;
+
+	// Lock this section up.
+	lscp_mutex_lock(pClient->mutex);
+
+	if (lscp_client_call(pClient, "GET VOICES\r\n", 0) == LSCP_OK)
+		iVoices = lscp_atoi(lscp_client_get_result(pClient));
+
+	// Unlock this section down.
+	lscp_mutex_unlock(pClient->mutex);
+
+	return iVoices;
+}
+
+
+/**
+ *  Setting global voice limit setting:
+ *  @code
+ *  SET VOICES <max-voices>
+ *  @endcode
+ *  This value reflects the maximum amount of voices a sampler engine
+ *  processes simultaniously before voice stealing kicks in. Note that
+ *  this value will be passed to all sampler engine instances, that is
+ *  the total amount of maximum voices on the running system is thus
+ *  @param iMaxVoices multiplied with the current amount of sampler
+ *  engine instances.
+ *
+ *  @param pClient     Pointer to client instance structure.
+ *  @param iMaxVoices  Global voice limit setting as integer value larger
+ *                     or equal to 1.
+ *
+ *  @returns LSCP_OK on success, LSCP_FAILED otherwise.
+ */
+lscp_status_t lscp_set_voices ( lscp_client_t *pClient, int iMaxVoices )
+{
+	char szQuery[LSCP_BUFSIZ];
+
+	if (iMaxVoices < 1)
+		return LSCP_FAILED;
+
+	sprintf(szQuery, "SET VOICES %d\r\n", iMaxVoices);
+	return lscp_client_query(pClient, szQuery);
+}
+
+
+/**
+ *  Get global disk streams limit setting:
+ *  @code
+ *  GET STREAMS
+ *  @endcode
+ *  This value reflects the maximum amount of disk streams a sampler
+ *  engine processes simultaniously.
+ *
+ *  @param pClient  Pointer to client instance structure.
+ *
+ *  @returns The current global maximum amount of disk streams limit
+ *           or a negative value on error (e.g. if sampler doesn't
+ *           support this command).
+ */
+int lscp_get_streams ( lscp_client_t *pClient )
+{
+	int iStreams = -1;
+
+	if (pClient == NULL)
+		return -1;
+
+	// Lock this section up.
+	lscp_mutex_lock(pClient->mutex);
+
+	if (lscp_client_call(pClient, "GET STREAMS\r\n", 0) == LSCP_OK)
+		iStreams = lscp_atoi(lscp_client_get_result(pClient));
+
+	// Unlock this section down.
+	lscp_mutex_unlock(pClient->mutex);
+
+	return iStreams;
+}
+
+
+/**
+ *  Setting global disk streams limit setting:
+ *  @code
+ *  SET STREAMS <max-streams>
+ *  @endcode
+ *  This value reflects the maximum amount of dist streams a sampler
+ *  engine instance processes simultaniously. Note that this value will
+ *  be passed to all sampler engine instances, that is the total amount
+ *  of maximum disk streams on the running system is thus
+ *  @param iMaxStreams multiplied with the current amount of sampler
+ *  engine instances.
+ *
+ *  @param pClient      Pointer to client instance structure.
+ *  @param iMaxStreams  Global streams limit setting as positive integer
+ *                      value (larger or equal to 0).
+ *
+ *  @returns LSCP_OK on success, LSCP_FAILED otherwise.
+ */
+lscp_status_t lscp_set_streams ( lscp_client_t *pClient, int iMaxStreams )
+{
+	char szQuery[LSCP_BUFSIZ];
+
+	if (iMaxStreams < 0)
+		return LSCP_FAILED;
+
+	sprintf(szQuery, "SET STREAMS %d\r\n", iMaxStreams);
+	return lscp_client_query(pClient, szQuery);
+}
+
+
+/**
+ *  Add an effect send to a sampler channel:
+ *  CREATE FX_SEND <sampler-channel> <midi-ctrl> [<fx-name>]
+ *
+ *  @param pClient          Pointer to client instance structure.
+ *  @param iSamplerChannel  Sampler channel number.
+ *  @param iMidiController  MIDI controller used to alter the effect,
+ *                          usually a number between 0 and 127.
+ *  @param pszFxName        Optional name for the effect send entity,
+ *                          does not have to be unique.
+ *
+ *  @returns The new effect send number identifier, or -1 in case of failure.
+ */
+int lscp_create_fxsend ( lscp_client_t *pClient,
+	int iSamplerChannel, int iMidiController, const char *pszFxName )
+{
+	int iFxSend = -1;
+	char szQuery[LSCP_BUFSIZ];
+
+	if (pClient == NULL)
+		return -1;
+	if (iSamplerChannel < 0 || iMidiController < 0 || iMidiController > 127)
+		return -1;
+
+	// Lock this section up.
+	lscp_mutex_lock(pClient->mutex);
+
+	sprintf(szQuery, "CREATE FX_SEND %d %d",
+		iSamplerChannel, iMidiController);
+
+	if (pszFxName)
+		sprintf(szQuery + strlen(szQuery), " '%s'", pszFxName);
+
+	strcat(szQuery, "\r\n");
+
+	if (lscp_client_call(pClient, szQuery, 0) == LSCP_OK)
+		iFxSend = lscp_atoi(lscp_client_get_result(pClient));
+
+	// Unlock this section down.
+	lscp_mutex_unlock(pClient->mutex);
+
+	return iFxSend;
+}
+
+
+/**
+ *  Remove an effect send from a sampler channel:
+ *  DESTROY FX_SEND <sampler-channel> <fx-send-id>
+ *
+ *  @param pClient          Pointer to client instance structure.
+ *  @param iSamplerChannel  Sampler channel number.
+ *  @param iFxSend          Effect send number.
+ *
+ *  @returns LSCP_OK on success, LSCP_FAILED otherwise.
+ */
+lscp_status_t lscp_destroy_fxsend ( lscp_client_t *pClient,
+	int iSamplerChannel, int iFxSend )
+{
+	char szQuery[LSCP_BUFSIZ];
+
+	if (iSamplerChannel < 0 || iFxSend < 0)
+		return LSCP_FAILED;
+
+	sprintf(szQuery, "DESTROY FX_SEND %d %d\r\n",
+		iSamplerChannel, iFxSend);
+
+	return lscp_client_query(pClient, szQuery);
+}
+
+
+/**
+ *  Get amount of effect sends on a sampler channel:
+ *  GET FX_SENDS <sampler-channel>
+ *
+ *  @param pClient          Pointer to client instance structure.
+ *  @param iSamplerChannel  Sampler channel number.
+ *
+ *  @returns The current total number of effect sends of the sampler channel
+ *  on success, -1 otherwise.
+ */
+int lscp_get_fxsends ( lscp_client_t *pClient, int iSamplerChannel )
+{
+	int iFxSends = -1;
+	char szQuery[LSCP_BUFSIZ];
+
+	if (pClient == NULL)
+		return -1;
+	if (iSamplerChannel < 0)
+		return -1;
+
+	// Lock this section up.
+	lscp_mutex_lock(pClient->mutex);
+
+	sprintf(szQuery, "GET FX_SENDS %d\r\n", iSamplerChannel);
+
+	if (lscp_client_call(pClient, szQuery, 0) == LSCP_OK)
+		iFxSends = lscp_atoi(lscp_client_get_result(pClient));
+
+	// Unlock this section doen.
+	lscp_mutex_unlock(pClient->mutex);
+
+	return iFxSends;
+}
+
+
+/**
+ *  List all effect sends on a sampler channel:
+ *  LIST FX_SENDS <sampler-channel>
+ *
+ *  @param pClient          Pointer to client instance structure.
+ *  @param iSamplerChannel  Sampler channel number.
+ *
+ *  @returns An array of the effect sends identifiers as positive integers,
+ *  terminated with -1 on success, NULL otherwise.
+ */
+int *lscp_list_fxsends ( lscp_client_t *pClient, int iSamplerChannel )
+{
+	const char *pszSeps = ",";
+	char szQuery[LSCP_BUFSIZ];
+
+	if (pClient == NULL)
+		return NULL;
+
+	// Lock this section up.
+	lscp_mutex_lock(pClient->mutex);
+
+	if (pClient->fxsends) {
+		lscp_isplit_destroy(pClient->fxsends);
+		pClient->fxsends = NULL;
+	}
+
+	sprintf(szQuery, "LIST FX_SENDS %d\r\n", iSamplerChannel);
+
+	if (lscp_client_call(pClient, szQuery, 0) == LSCP_OK)
+		pClient->fxsends = lscp_isplit_create(lscp_client_get_result(pClient), pszSeps);
+
+	// Unlock this section down.
+	lscp_mutex_unlock(pClient->mutex);
+
+	return pClient->fxsends;
+}
+
+
+/**
+ *  Getting effect send information
+ *  GET FX_SEND INFO <sampler-channel> <fx-send-id>
+ *
+ *  @param pClient          Pointer to client instance structure.
+ *  @param iSamplerChannel  Sampler channel number.
+ *  @param iFxSend          Effect send number.
+ *
+ *  @returns A pointer to a @ref lscp_fxsend_info_t structure, with the
+ *  information of the given FX send, or NULL in case of failure.
+ */
+lscp_fxsend_info_t *lscp_get_fxsend_info ( lscp_client_t *pClient,
+	int iSamplerChannel, int iFxSend )
+{
+	char szQuery[LSCP_BUFSIZ];
+
+	if (pClient == NULL)
+		return NULL;
+	if (iSamplerChannel < 0 || iFxSend < 0)
+		return NULL;
+
+	sprintf(szQuery, "GET FX_SEND INFO %d %d\r\n", iSamplerChannel, iFxSend);
+	return _lscp_fxsend_info_query(pClient, &(pClient->fxsend_info), szQuery);
+}
+
+
+/**
+ *  Getting a snapshot of effect send information
+ *  GET FX_SEND INFO <sampler-channel> <fx-send-id>
+ *
+ *  @param pClient          Pointer to client instance structure.
+ *  @param iSamplerChannel  Sampler channel number.
+ *  @param iFxSend          Effect send number.
+ *
+ *  @returns A pointer to an immutable and reference-counted @ref lscp_fxsend_info_t
+ *  snapshot, owned by the caller and valid across any subsequent calls,
+ *  which must be released with @ref lscp_snapshot_unref when done,
+ *  or NULL in case of failure.
+ */
+const lscp_fxsend_info_t *lscp_get_fxsend_info_snapshot ( lscp_client_t *pClient,
+	int iSamplerChannel, int iFxSend )
+{
+	lscp_fxsend_info_t *pFxSendInfo;
+	char szQuery[LSCP_BUFSIZ];
+
+	if (pClient == NULL)
+		return NULL;
+	if (iSamplerChannel < 0 || iFxSend < 0)
+		return NULL;
+
+	sprintf(szQuery, "GET FX_SEND INFO %d %d\r\n", iSamplerChannel, iFxSend);
+	pFxSendInfo = (lscp_fxsend_info_t *) lscp_snapshot_alloc(LSCP_SNAPSHOT_FXSEND_INFO);
+	if (pFxSendInfo && _lscp_fxsend_info_query(pClient, pFxSendInfo, szQuery) == NULL) {
+		lscp_snapshot_unref(pFxSendInfo);
+		pFxSendInfo = NULL;
+	}
+
+	return pFxSendInfo;
+}
+
+
+// Common effect send info query command.
+static lscp_fxsend_info_t *_lscp_fxsend_info_query ( lscp_client_t *pClient,
+	lscp_fxsend_info_t *pFxSendInfo, const char *pszQuery )
+{
+	// Lock this section up.
+	lscp_mutex_lock(pClient->mutex);
+
+	lscp_fxsend_info_reset(pFxSendInfo);
+	if (lscp_client_call(pClient, pszQuery, 1) == LSCP_OK)
+		_lscp_fxsend_info_parse(pFxSendInfo, (char *) lscp_client_get_result(pClient));
+	else pFxSendInfo = NULL;
+
+	// Unlock this section up.
+	lscp_mutex_unlock(pClient->mutex);
+
+	return pFxSendInfo;
+}
+
+
+// Parse a GET FX_SEND INFO response (parsed in place).
+static void _lscp_fxsend_info_parse ( lscp_fxsend_info_t *pFxSendInfo,
+	char *pszResult )
+{
+	const char *pszSeps = ":";
+	const char *pszCrlf = "\r\n";
+	char *pszToken;
+	char *pch;
+
+	pszToken = lscp_strtok(pszResult, pszSeps, &(pch));
+	while (pszToken) {
+		if (strcasecmp(pszToken, "NAME") == 0) {
+			pszToken = lscp_strtok(NULL, pszCrlf, &(pch));
+			if (pszToken)
+				lscp_unquote_dup(&(pFxSendInfo->name), &pszToken);
+		}
+		else if (strcasecmp(pszToken, "MIDI_CONTROLLER") == 0) {
+			pszToken = lscp_strtok(NULL, pszCrlf, &(pch));
+			if (pszToken)
+				pFxSendInfo->midi_controller = lscp_atoi(lscp_ltrim(pszToken));
+		}
+		else if (strcasecmp(pszToken, "AUDIO_OUTPUT_ROUTING") == 0) {
+			pszToken = lscp_strtok(NULL, pszCrlf, &(pch));
+			if (pszToken) {
+				if (pFxSendInfo->audio_routing)
+					lscp_isplit_destroy(pFxSendInfo->audio_routing);
+				pFxSendInfo->audio_routing = lscp_isplit_create(pszToken, ",");
+			}
+		}
+		else if (strcasecmp(pszToken, "LEVEL") == 0) {
+			pszToken = lscp_strtok(NULL, pszCrlf, &(pch));
+			if (pszToken)
+				pFxSendInfo->level = lscp_atof(lscp_ltrim(pszToken));
+		}
+		pszToken = lscp_strtok(NULL, pszSeps, &(pch));
+	}
+}
+
+
+/**
+ *  Alter effect send's name:
+ *  @code
+ *  SET FX_SEND NAME <sampler-chan> <fx-send-id> <name>
+ *  @endcode
+ *
+ *  @param pClient          Pointer to client instance structure.
+ *  @param iSamplerChannel  Sampler channel number.
+ *  @param iFxSend          Effect send number.
+ *  @param pszFxName        Effect send's new name.
+ *
+ *  @returns LSCP_OK on success, LSCP_FAILED otherwise.
+ */
+lscp_status_t lscp_set_fxsend_name ( lscp_client_t *pClient,
+	int iSamplerChannel, int iFxSend, const char *pszFxName )
+{
+	char szQuery[LSCP_BUFSIZ];
+
+	if (!pClient || iSamplerChannel < 0 || iFxSend < 0 || !pszFxName)
+		return LSCP_FAILED;
+
+	snprintf(szQuery, LSCP_BUFSIZ, "SET FX_SEND NAME %d %d '%s'\r\n",
+		iSamplerChannel, iFxSend, pszFxName);
+	return lscp_client_query(pClient, szQuery);
+}
+
+
+/**
+ *  Alter effect send's audio routing:
+ *  SET FX_SEND AUDIO_OUTPUT_CHANNEL <sampler-chan> <fx-send-id>
+ *    <audio-src> <audio-dst>
+ *
+ *  @param pClient          Pointer to client instance structure.
+ *  @param iSamplerChannel  Sampler channel number.
+ *  @param iFxSend          Effect send number.
+ *  @param iAudioSrc        Audio output device channel to be routed from.
+ *  @param iAudioDst        Audio output device channel to be routed into.
+ *
+ *  @returns LSCP_OK on success, LSCP_FAILED otherwise.
+ */
+lscp_status_t lscp_set_fxsend_audio_channel ( lscp_client_t *pClient,
+	int iSamplerChannel, int iFxSend, int iAudioSrc, int iAudioDst )
+{
+	char szQuery[LSCP_BUFSIZ];
+
+	if (iSamplerChannel < 0 || iFxSend < 0 || iAudioSrc < 0 || iAudioDst < 0)
+		return LSCP_FAILED;
+
+	sprintf(szQuery, "SET FX_SEND AUDIO_OUTPUT_CHANNEL %d %d %d %d\r\n",
+		iSamplerChannel, iFxSend, iAudioSrc, iAudioDst);
+	return lscp_client_query(pClient, szQuery);
+}
+
+
+/**
+ *  Alter effect send's MIDI controller:
+ *  SET FX_SEND MIDI_CONTROLLER <sampler-chan> <fx-send-id> <midi-ctrl>
+ *
+ *  @param pClient          Pointer to client instance structure.
+ *  @param iSamplerChannel  Sampler channel number.
+ *  @param iFxSend          Effect send number.
+ *  @param iMidiController  MIDI controller used to alter the effect,
+ *                          usually a number between 0 and 127.
+ *
+ *  @returns LSCP_OK on success, LSCP_FAILED otherwise.
+ */
+lscp_status_t lscp_set_fxsend_midi_controller ( lscp_client_t *pClient,
+	int iSamplerChannel, int iFxSend, int iMidiController )
+{
+	char szQuery[LSCP_BUFSIZ];
+
+	if (iSamplerChannel < 0 || iFxSend < 0 ||
+		iMidiController < 0 || iMidiController > 127)
+		return LSCP_FAILED;
+
+	sprintf(szQuery, "SET FX_SEND MIDI_CONTROLLER %d %d %d\r\n",
+		iSamplerChannel, iFxSend, iMidiController);
+	return lscp_client_query(pClient, szQuery);
+}
+
+
+/**
+ *  Alter effect send's audio level:
+ *  SET FX_SEND LEVEL <sampler-chan> <fx-send-id> <level>
+ *
+ *  @param pClient          Pointer to client instance structure.
+ *  @param iSamplerChannel  Sampler channel number.
+ *  @param iFxSend          Effect send number.
+ *  @param fLevel           Effect send volume level.
+ *
+ *  @returns LSCP_OK on success, LSCP_FAILED otherwise.
+ */
+lscp_status_t lscp_set_fxsend_level ( lscp_client_t *pClient,
+	int iSamplerChannel, int iFxSend, float fLevel )
+{
+	char szQuery[LSCP_BUFSIZ];
+	char szLevel[32];
+
+	if (iSamplerChannel < 0 || iFxSend < 0 || fLevel < 0.0f)
+		return LSCP_FAILED;
+
+	lscp_ftoa(szLevel, sizeof(szLevel), fLevel);
+	sprintf(szQuery, "SET FX_SEND LEVEL %d %d %s\r\n",
+		iSamplerChannel, iFxSend, szLevel);
+
+	return lscp_client_query(pClient, szQuery);
+}
+
+
+/**
+ *  Create a new MIDI instrument map:
+ *  ADD MIDI_INSTRUMENT_MAP [<name>]
+ *
+ *  @param pClient      Pointer to client instance structure.
+ *  @param pszMapName   MIDI instrument map name (optional)
+ *
+ *  @returns The new MIDI instrument map number identifier,
+ *  or -1 in case of failure.
+ */
+int lscp_add_midi_instrument_map ( lscp_client_t *pClient, const char *pszMapName )
+{
+	int iMidiMap = -1;
+	char szQuery[LSCP_BUFSIZ];
+
+	if (pClient == NULL)
+		return -1;
+
+	// Lock this section up.
+	lscp_mutex_lock(pClient->mutex);
+
+	strcpy(szQuery, "ADD MIDI_INSTRUMENT_MAP");
+
+	if (pszMapName)
+		sprintf(szQuery + strlen(szQuery), " '%s'", pszMapName);
+
+	strcat(szQuery, "\r\n");
+
+	if (lscp_client_call(pClient, szQuery, 0) == LSCP_OK) {
+		iMidiMap = lscp_atoi(lscp_client_get_result(pClient));
+		_lscp_midi_mirror_touch(pClient, LSCP_MIDI_MIRROR_MAPS);
+	}
+
+	// Unlock this section down.
+	lscp_mutex_unlock(pClient->mutex);
+
+	return iMidiMap;
+}
+
+
+/**
+ *  Delete one particular or all MIDI instrument maps:
+ *  REMOVE MIDI_INSTRUMENT_MAP <midi-map>
+ *
+ *  @param pClient  Pointer to client instance structure.
+ *  @param iMidiMap MIDI instrument map number.
+ *
+ *  @returns LSCP_OK on success, LSCP_FAILED otherwise.
+ */
+lscp_status_t lscp_remove_midi_instrument_map ( lscp_client_t *pClient, int iMidiMap )
+{
+	lscp_status_t ret;
+	char szQuery[LSCP_BUFSIZ];
+
+	if (pClient == NULL)
+		return LSCP_FAILED;
+	if (iMidiMap < 0)
+		return LSCP_FAILED;
+
+	sprintf(szQuery, "REMOVE MIDI_INSTRUMENT_MAP %d\r\n", iMidiMap);
+	ret = lscp_client_query(pClient, szQuery);
+	_lscp_midi_mirror_touch(pClient, LSCP_MIDI_MIRROR_MAPS);
+
+	return ret;
+}
+
+
+/**
+ *  Get amount of existing MIDI instrument maps:
+ *  GET MIDI_INSTRUMENT_MAPS
+ *
+ *  @param pClient  Pointer to client instance structure.
+ *
+ *  @returns The current total number of MIDI instrument maps
+ *  on success, -1 otherwise.
+ */
+int lscp_get_midi_instrument_maps ( lscp_client_t *pClient )
+{
+	int iMidiMaps = -1;
+
+	if (pClient == NULL)
+		return -1;
+
+	// Lock this section up.
+	lscp_mutex_lock(pClient->mutex);
+
+	if (lscp_client_call(pClient, "GET MIDI_INSTRUMENT_MAPS\r\n", 0) == LSCP_OK)
+		iMidiMaps = lscp_atoi(lscp_client_get_result(pClient));
+
+	// Unlock this section doen.
+	lscp_mutex_unlock(pClient->mutex);
+
+	return iMidiMaps;
+}
+
+
+/**
+ *  Getting all created MIDI instrument maps:
+ *  LIST MIDI_INSTRUMENT_MAPS
+ *
+ *  @param pClient  Pointer to client instance structure.
+ *
+ *  @returns An array of the MIDI instrument map identifiers as positive
+ *  integers, terminated with -1 on success, NULL otherwise.
+ */
+int *lscp_list_midi_instrument_maps ( lscp_client_t *pClient )
+{
+	const char *pszSeps = ",";
+
+	if (pClient == NULL)
+		return NULL;
+
+	// Lock this section up.
+	lscp_mutex_lock(pClient->mutex);
+
+	if (pClient->midi_maps) {
+		lscp_isplit_destroy(pClient->midi_maps);
+		pClient->midi_maps = NULL;
+	}
+
+	if (lscp_client_call(pClient, "LIST MIDI_INSTRUMENT_MAPS\r\n", 0) == LSCP_OK)
+		pClient->midi_maps = lscp_isplit_create(lscp_client_get_result(pClient), pszSeps);
+
+	// Unlock this section down.
+	lscp_mutex_unlock(pClient->mutex);
+
+	return pClient->midi_maps;
+}
+
+
+// Common MIDI instrument map info response name parser.
+static void _lscp_midi_map_name_parse ( char **ppszName, char *pszResult )
+{
+	const char *pszSeps = ":";
+	const char *pszCrlf = "\r\n";
+	char *pszToken;
+	char *pch;
+
+	pszToken = lscp_strtok(pszResult, pszSeps, &(pch));
+	while (pszToken) {
+		if (strcasecmp(pszToken, "NAME") == 0) {
+			pszToken = lscp_strtok(NULL, pszCrlf, &(pch));
+			if (pszToken)
+				lscp_unquote_dup(ppszName, &pszToken);
+		}
+		pszToken = lscp_strtok(NULL, pszSeps, &(pch));
+	}
+}
+
+
+/**
+ *  Getting a MIDI instrument map name:
+ *  GET MIDI_INSTRUMENT_MAP INFO <midi-map>
+ *
+ *  @param pClient  Pointer to client instance structure.
+ *  @param iMidiMap MIDI instrument map number.
+ *
+ *  @returns The MIDI instrument map name on success, NULL on failure.
+ */
+const char *lscp_get_midi_instrument_map_name ( lscp_client_t *pClient, int iMidiMap )
+{
+	char szQuery[LSCP_BUFSIZ];
+
+	if (pClient == NULL)
+		return NULL;
+	if (iMidiMap < 0)
+		return NULL;
+
+	// Lock this section up.
+	lscp_mutex_lock(pClient->mutex);
+
+	if (pClient->midi_map_name) {
+		free(pClient->midi_map_name);
+		pClient->midi_map_name = NULL;
+	}
+
+	sprintf(szQuery, "GET MIDI_INSTRUMENT_MAP INFO %d\r\n", iMidiMap);
+	if (lscp_client_call(pClient, szQuery, 1) == LSCP_OK) {
+		_lscp_midi_map_name_parse(&(pClient->midi_map_name),
+			(char *) lscp_client_get_result(pClient));
+	}
+
+	// Unlock this section down.
+	lscp_mutex_unlock(pClient->mutex);
+
+	return pClient->midi_map_name;
+}
+
+
+/**
+ *  Renaming a MIDI instrument map:
+ *  SET MIDI_INSTRUMENT_MAP NAME <midi-map> <map-name>
+ *
+ *  @param pClient      Pointer to client instance structure.
+ *  @param iMidiMap     MIDI instrument map number.
+ *  @param pszMapName   MIDI instrument map name.
+ *
+ *  @returns LSCP_OK on success, LSCP_FAILED otherwise.
+ */
+lscp_status_t lscp_set_midi_instrument_map_name ( lscp_client_t *pClient, int iMidiMap, const char *pszMapName )
+{
+	lscp_status_t ret;
+	char szQuery[LSCP_BUFSIZ];
+
+	if (pClient == NULL)
+		return LSCP_FAILED;
+	if (iMidiMap < 0)
+		return LSCP_FAILED;
+	if (pszMapName == NULL)
+		return LSCP_FAILED;
+
+	sprintf(szQuery, "SET MIDI_INSTRUMENT_MAP NAME %d '%s'\r\n",
+		iMidiMap, pszMapName);
+	ret = lscp_client_query(pClient, szQuery);
+	_lscp_midi_mirror_touch(pClient,
+		LSCP_MIDI_MIRROR_KEY(iMidiMap, LSCP_MIDI_MIRROR_NAME));
+
+	return ret;
+}
+
+
+// Build a MAP MIDI_INSTRUMENT command, optionally NON_MODAL.
+static int _lscp_map_midi_instrument_query ( char *pszQuery, int cchQuery,
+	int iNonModal, const lscp_midi_instrument_t *pMidiInstr,
+	const char *pszEngineName, const char *pszFileName, int iInstrIndex,
+	float fVolume, lscp_load_mode_t load_mode, const char *pszName )
+{
+	const char *pszLoadMode = NULL;
+	char szVolume[32];
+	int cch;
+
+	if (fVolume < 0.0f)
+		fVolume = 1.0f;
+
+	switch (load_mode) {
+	case LSCP_LOAD_PERSISTENT:
+		pszLoadMode = " PERSISTENT";
+		break;
+	case LSCP_LOAD_ON_DEMAND_HOLD:
+		pszLoadMode = " ON_DEMAND_HOLD";
+		break;
+	case LSCP_LOAD_ON_DEMAND:
+		pszLoadMode = " ON_DEMAND";
+		break;
+	case LSCP_LOAD_DEFAULT:
+	default:
+		pszLoadMode = "";
+		break;
+	}
+
+	lscp_ftoa(szVolume, sizeof(szVolume), fVolume);
+	cch = snprintf(pszQuery, cchQuery, "MAP MIDI_INSTRUMENT %s%d %d %d %s '%s' %d %s%s",
+		(iNonModal ? "NON_MODAL " : ""),
+		pMidiInstr->map, pMidiInstr->bank, pMidiInstr->prog,
+		pszEngineName, pszFileName, iInstrIndex, szVolume, pszLoadMode);
+
+	// Keep on the remaining length, unless already truncated...
+	if (pszName && cch >= 0 && cch < cchQuery)
+		cch += snprintf(pszQuery + cch, cchQuery - cch, " '%s'", pszName);
+	if (cch >= 0 && cch < cchQuery)
+		cch += snprintf(pszQuery + cch, cchQuery - cch, "\r\n");
+
+	// Whole length, as snprintf would tell.
+	return cch;
+}
+
+
+/**
+ *  Create or replace a MIDI instrumnet map entry:
+ *  MAP MIDI_INSTRUMENT <midi-map> <midi-bank> <midi-prog>
+ *      <engine-name> <filename> <instr-index> <volume> [<load-mode> [<name>]}
+ *
+ *  @param pClient          Pointer to client instance structure.
+ *  @param pMidiInstr       MIDI instrument bank and program parameter key.
+ *  @param pszEngineName    Engine name.
+ *  @param pszFileName      Instrument file name.
+ *  @param iInstrIndex      Instrument index number.
+ *  @param fVolume          Reflects the master volume of the instrument as
+ *                          a positive floating point number, where a value
+ *                          less than 1.0 for attenuation, and greater than
+ *                          1.0 for amplification.
+ *  @param load_mode        Instrument load life-time strategy, either
+ *                          @ref LSCP_LOAD_DEFAULT, or
+ *                          @ref LSCP_LOAD_ON_DEMAND, or
+ *                          @ref LSCP_LOAD_ON_DEMAND_HOLD, or
+ *                          @ref LSCP_LOAD_PERSISTENT.
+ *  @param pszName         Instrument custom name for the map entry (optional).
+ *
+ *  @returns LSCP_OK on success, LSCP_FAILED otherwise.
+ */
+lscp_status_t lscp_map_midi_instrument ( lscp_client_t *pClient,
+	lscp_midi_instrument_t *pMidiInstr, const char *pszEngineName,
+	const char *pszFileName, int iInstrIndex, float fVolume,
+	lscp_load_mode_t load_mode, const char *pszName )
+{
+	lscp_status_t ret;
+	char szQuery[LSCP_BUFSIZ];
+	int cchQuery;
+
+	if (pClient == NULL)
+		return LSCP_FAILED;
+	if (pMidiInstr->map < 0)
+		return LSCP_FAILED;
+	if (pMidiInstr->bank < 0 || pMidiInstr->bank > 16383)
+		return LSCP_FAILED;
+	if (pMidiInstr->prog < 0 || pMidiInstr->prog > 127)
+		return LSCP_FAILED;
+	if (pszEngineName == NULL || pszFileName == NULL)
+		return LSCP_FAILED;
+
+	cchQuery = _lscp_map_midi_instrument_query(szQuery, sizeof(szQuery), 0,
+		pMidiInstr, pszEngineName, pszFileName, iInstrIndex, fVolume,
+		load_mode, pszName);
+	if (cchQuery < 0 || cchQuery >= (int) sizeof(szQuery))
+		return LSCP_FAILED;
+
+	ret = lscp_client_query(pClient, szQuery);
+	_lscp_midi_mirror_touch(pClient,
+		LSCP_MIDI_MIRROR_KEY(pMidiInstr->map, LSCP_MIDI_MIRROR_LIST));
+	_lscp_midi_mirror_touch(pClient,
+		LSCP_MIDI_MIRROR_ENTRY_KEY(pMidiInstr->map, pMidiInstr->bank, pMidiInstr->prog));
+
+	return ret;
+}
+
+
+/**
+ *  Remove an entry from the MIDI instrument map:
+ *  UNMAP MIDI_INSTRUMENT <midi-map> <midi-bank> <midi-prog>
+ *
+ *  @param pClient      Pointer to client instance structure.
+ *  @param pMidiInstr   MIDI instrument bank and program parameter key.
+ *
+ *  @returns LSCP_OK on success, LSCP_FAILED otherwise.
+ */
+lscp_status_t lscp_unmap_midi_instrument ( lscp_client_t *pClient,
+	lscp_midi_instrument_t *pMidiInstr )
+{
+	lscp_status_t ret;
+	char szQuery[LSCP_BUFSIZ];
+
+	if (pClient == NULL)
+		return LSCP_FAILED;
+	if (pMidiInstr->map < 0)
+		return LSCP_FAILED;
+	if (pMidiInstr->bank < 0 || pMidiInstr->bank > 16383)
+		return LSCP_FAILED;
+	if (pMidiInstr->prog < 0 || pMidiInstr->prog > 127)
+		return LSCP_FAILED;
+
+	sprintf(szQuery, "UNMAP MIDI_INSTRUMENT %d %d %d\r\n",
+		pMidiInstr->map, pMidiInstr->bank, pMidiInstr->prog);
+	ret = lscp_client_query(pClient, szQuery);
+	_lscp_midi_mirror_touch(pClient,
+		LSCP_MIDI_MIRROR_KEY(pMidiInstr->map, LSCP_MIDI_MIRROR_LIST));
+
+	return ret;
+}
+
+
+/**
+ *  Get the total count of MIDI instrument map entries:
+ *  GET MIDI_INSTRUMENTS ALL|<midi-map>
+ *
+ *  @param pClient  Pointer to client instance structure.
+ *  @param iMidiMap MIDI instrument map number, or @ref LSCP_MIDI_MAP_ALL .
+ *
+ *  @returns The current total number of MIDI instrument map entries
+ *  on success, -1 otherwise.
+ */
+int lscp_get_midi_instruments ( lscp_client_t *pClient, int iMidiMap )
+{
+	int iInstruments = -1;
+	char szQuery[LSCP_BUFSIZ];
+
+	if (pClient == NULL)
+		return -1;
+
+	// Lock this section up.
+	lscp_mutex_lock(pClient->mutex);
+
+	strcpy(szQuery, "GET MIDI_INSTRUMENTS ");
+
+	if (iMidiMap < 0)
+		strcat(szQuery, "ALL");
+	else
+		sprintf(szQuery + strlen(szQuery), "%d", iMidiMap);
+
+	strcat(szQuery, "\r\n");
+
+	if (lscp_client_call(pClient, szQuery, 0) == LSCP_OK)
+		iInstruments = lscp_atoi(lscp_client_get_result(pClient));
+
+	// Unlock this section down.
+	lscp_mutex_unlock(pClient->mutex);
+
+	return iInstruments;
+}
+
+
+/**
+ *  Getting indeces of all MIDI instrument map entries:
+ *  LIST MIDI_INSTRUMENTS ALL|<midi-map>
+ *
+ *  @param pClient  Pointer to client instance structure.
+ *  @param iMidiMap MIDI instrument map number, or @ref LSCP_MIDI_MAP_ALL .
+ *
+ *  @returns An array of @ref lscp_midi_instrument_t, terminated with the
+ *  {-1,-1,-1} triplet, NULL otherwise.
+ */
+lscp_midi_instrument_t *lscp_list_midi_instruments ( lscp_client_t *pClient, int iMidiMap )
+{
+	char szQuery[LSCP_BUFSIZ];
+
+	if (pClient == NULL)
+		return NULL;
+
+	// Lock this section up.
+	lscp_mutex_lock(pClient->mutex);
+
+	if (pClient->midi_instruments) {
+		lscp_midi_instruments_destroy(pClient->midi_instruments);
+		pClient->midi_instruments = NULL;
+	}
+
+	strcpy(szQuery, "LIST MIDI_INSTRUMENTS ");
+
+	if (iMidiMap < 0)
+		strcat(szQuery, "ALL");
+	else
+		sprintf(szQuery + strlen(szQuery), "%d", iMidiMap);
+
+	strcat(szQuery, "\r\n");
+
+	if (lscp_client_call(pClient, szQuery, 0) == LSCP_OK)
+		pClient->midi_instruments = lscp_midi_instruments_create(
+			lscp_client_get_result(pClient));
+
+	// Unlock this section down.
+	lscp_mutex_unlock(pClient->mutex);
+
+	return pClient->midi_instruments;
+}
+
+
+/**
+ *  Getting information about a MIDI instrument map entry:
+ *  GET MIDI_INSTRUMENT INFO <midi-map> <midi-bank> <midi-prog>
+ *
+ *  @param pClient      Pointer to client instance structure.
+ *  @param pMidiInstr   MIDI instrument bank and program parameter key.
+ *
+ *  @returns A pointer to a @ref lscp_midi_instrument_info_t structure,
+ *  with all the information of the given MIDI instrument map entry,
+ *  or NULL in case of failure.
+ */
+lscp_midi_instrument_info_t *lscp_get_midi_instrument_info ( lscp_client_t *pClient,
+	lscp_midi_instrument_t *pMidiInstr )
+{
+	char szQuery[LSCP_BUFSIZ];
+
+	if (pClient == NULL)
+		return NULL;
+	if (pMidiInstr->map < 0)
+		return NULL;
+	if (pMidiInstr->bank < 0 || pMidiInstr->bank > 16383)
+		return NULL;
+	if (pMidiInstr->prog < 0 || pMidiInstr->prog > 127)
+		return NULL;
+
+	sprintf(szQuery, "GET MIDI_INSTRUMENT INFO %d %d %d\r\n",
+		pMidiInstr->map, pMidiInstr->bank, pMidiInstr->prog);
+	return _lscp_midi_instrument_info_query(pClient,
+		&(pClient->midi_instrument_info), szQuery);
+}
+
+
+/**
+ *  Getting a snapshot of information about a MIDI instrument map entry:
+ *  GET MIDI_INSTRUMENT INFO <midi-map> <midi-bank> <midi-prog>
+ *
+ *  @param pClient      Pointer to client instance structure.
+ *  @param pMidiInstr   MIDI instrument bank and program parameter key.
+ *
+ *  @returns A pointer to an immutable and reference-counted @ref lscp_midi_instrument_info_t
+ *  snapshot, owned by the caller and valid across any subsequent calls,
+ *  which must be released with @ref lscp_snapshot_unref when done,
+ *  or NULL in case of failure.
+ */
+const lscp_midi_instrument_info_t *lscp_get_midi_instrument_info_snapshot ( lscp_client_t *pClient,
+	lscp_midi_instrument_t *pMidiInstr )
+{
+	lscp_midi_instrument_info_t *pInstrInfo;
+	char szQuery[LSCP_BUFSIZ];
+
+	if (pClient == NULL)
+		return NULL;
+	if (pMidiInstr->map < 0)
+		return NULL;
+	if (pMidiInstr->bank < 0 || pMidiInstr->bank > 16383)
+		return NULL;
+	if (pMidiInstr->prog < 0 || pMidiInstr->prog > 127)
+		return NULL;
+
+	sprintf(szQuery, "GET MIDI_INSTRUMENT INFO %d %d %d\r\n",
+		pMidiInstr->map, pMidiInstr->bank, pMidiInstr->prog);
+	pInstrInfo = (lscp_midi_instrument_info_t *) lscp_snapshot_alloc(LSCP_SNAPSHOT_MIDI_INSTRUMENT_INFO);
+	if (pInstrInfo && _lscp_midi_instrument_info_query(pClient, pInstrInfo, szQuery) == NULL) {
+		lscp_snapshot_unref(pInstrInfo);
+		pInstrInfo = NULL;
+	}
+
+	return pInstrInfo;
+}
+
+
+// Common MIDI instrument map entry info response parser.
+static void _lscp_midi_instrument_info_parse ( lscp_intern_pool_t *pPool,
+	lscp_midi_instrument_info_t *pInstrInfo, char *pszResult )
+{
+	const char *pszSeps = ":";
+	const char *pszCrlf = "\r\n";
+	char *pszToken;
+	char *pch;
+
+	pszToken = lscp_strtok(pszResult, pszSeps, &(pch));
+	while (pszToken) {
+		if (strcasecmp(pszToken, "NAME") == 0) {
+			pszToken = lscp_strtok(NULL, pszCrlf, &(pch));
+			if (pszToken)
+				lscp_unquote_intern(pPool, &(pInstrInfo->name), &pszToken);
+		}
+		else if (strcasecmp(pszToken, "ENGINE_NAME") == 0) {
+			pszToken = lscp_strtok(NULL, pszCrlf, &(pch));
+			if (pszToken)
+				lscp_unquote_intern(pPool, &(pInstrInfo->engine_name), &pszToken);
+		}
+		else if (strcasecmp(pszToken, "INSTRUMENT_FILE") == 0) {
+			pszToken = lscp_strtok(NULL, pszCrlf, &(pch));
+			if (pszToken)
+				lscp_unquote_intern(pPool, &(pInstrInfo->instrument_file), &pszToken);
+		}
+		else if (strcasecmp(pszToken, "INSTRUMENT_NR") == 0) {
+			pszToken = lscp_strtok(NULL, pszCrlf, &(pch));
+			if (pszToken)
+				pInstrInfo->instrument_nr = lscp_atoi(lscp_ltrim(pszToken));
+		}
+		else if (strcasecmp(pszToken, "INSTRUMENT_NAME") == 0) {
+			pszToken = lscp_strtok(NULL, pszCrlf, &(pch));
+			if (pszToken)
+				lscp_unquote_intern(pPool, &(pInstrInfo->instrument_name), &pszToken);
+		}
+		else if (strcasecmp(pszToken, "LOAD_MODE") == 0) {
+			pszToken = lscp_strtok(NULL, pszCrlf, &(pch));
+			if (pszToken) {
+				pszToken = lscp_ltrim(pszToken);
+				if (strcasecmp(pszToken, "ON_DEMAND") == 0)
+					pInstrInfo->load_mode = LSCP_LOAD_ON_DEMAND;
+				else
+				if (strcasecmp(pszToken, "ON_DEMAND_HOLD") == 0)
+					pInstrInfo->load_mode = LSCP_LOAD_ON_DEMAND_HOLD;
+				else
+				if (strcasecmp(pszToken, "PERSISTENT") == 0)
+					pInstrInfo->load_mode = LSCP_LOAD_PERSISTENT;
+				else
+					pInstrInfo->load_mode = LSCP_LOAD_DEFAULT;
+			}
+		}
+		else if (strcasecmp(pszToken, "VOLUME") == 0) {
+			pszToken = lscp_strtok(NULL, pszCrlf, &(pch));
+			if (pszToken)
+				pInstrInfo->volume = lscp_atof(lscp_ltrim(pszToken));
+		}
+		pszToken = lscp_strtok(NULL, pszSeps, &(pch));
+	}
+}
+
+
+// Common MIDI instrument map entry info query command.
+static lscp_midi_instrument_info_t *_lscp_midi_instrument_info_query (
+	lscp_client_t *pClient, lscp_midi_instrument_info_t *pInstrInfo,
+	const char *pszQuery )
+{
+	// Lock this section up.
+	lscp_mutex_lock(pClient->mutex);
+
+	lscp_midi_instrument_info_reset(pInstrInfo);
+	if (lscp_client_call(pClient, pszQuery, 1) == LSCP_OK) {
+		_lscp_midi_instrument_info_parse(pClient->intern, pInstrInfo,
+			(char *) lscp_client_get_result(pClient));
+	}
+	else pInstrInfo = NULL;
+
+	// Unlock this section down.
+	lscp_mutex_unlock(pClient->mutex);
+
+	return pInstrInfo;
+}
+
+
+/**
+ *  Clear the MIDI instrumnet map:
+ *  CLEAR MIDI_INSTRUMENTS ALL|<midi-map>
+ *
+ *  @param pClient  Pointer to client instance structure.
+ *  @param iMidiMap MIDI instrument map number, or @ref LSCP_MIDI_MAP_ALL .
+ *
+ *  @returns LSCP_OK on success, LSCP_FAILED otherwise.
+ */
+lscp_status_t lscp_clear_midi_instruments  ( lscp_client_t *pClient, int iMidiMap )
+{
+	lscp_status_t ret;
+	char szQuery[LSCP_BUFSIZ];
+
+	if (pClient == NULL)
+		return LSCP_FAILED;
+
+	strcpy(szQuery, "CLEAR MIDI_INSTRUMENTS ");
 
 	if (iMidiMap < 0)
 		strcat(szQuery, "ALL");
 	else
 		sprintf(szQuery + strlen(szQuery), "%d", iMidiMap);
 
-	strcat(szQuery, "\r\n");
+	strcat(szQuery, "\r\n");
+
+	ret = lscp_client_query(pClient, szQuery);
+	_lscp_midi_mirror_touch(pClient, (iMidiMap < 0
+		? LSCP_MIDI_MIRROR_LISTS
+		: LSCP_MIDI_MIRROR_KEY(iMidiMap, LSCP_MIDI_MIRROR_LIST)));
+
+	return ret;
+}
+
+
+//-------------------------------------------------------------------------
+// MIDI instrument map mirror functions.
+
+// Map and entry list response target.
+typedef struct _lscp_midi_mirror_list_t
+{
+	int           listed;
+	int *         maps;
+	lscp_midi_instrument_t *instrs;
+
+} lscp_midi_mirror_list_t;
+
+
+// Pipelined response handlers.
+static void _lscp_midi_mirror_maps_result ( lscp_client_t *pClient, int iQuery,
+	lscp_status_t ret, char *pszResult, void *pvData )
+{
+	lscp_mirror_batch_t *pBatch = (lscp_mirror_batch_t *) pvData;
+	lscp_midi_mirror_list_t *pList = (lscp_midi_mirror_list_t *) pBatch->targets[iQuery];
+
+	(void) pClient;
+
+	if (ret == LSCP_OK) {
+		pList->listed = 1;
+		pList->maps = lscp_isplit_create(pszResult ? pszResult : "", ",");
+	}
+}
+
+static void _lscp_midi_mirror_list_result ( lscp_client_t *pClient, int iQuery,
+	lscp_status_t ret, char *pszResult, void *pvData )
+{
+	lscp_mirror_batch_t *pBatch = (lscp_mirror_batch_t *) pvData;
+	lscp_midi_mirror_list_t *pList = (lscp_midi_mirror_list_t *) pBatch->targets[iQuery];
+
+	(void) pClient;
+
+	if (ret == LSCP_OK) {
+		pList->listed = 1;
+		pList->instrs = lscp_midi_instruments_create(pszResult ? pszResult : "");
+	}
+}
+
+static void _lscp_midi_mirror_info_result ( lscp_client_t *pClient, int iQuery,
+	lscp_status_t ret, char *pszResult, void *pvData )
+{
+	lscp_mirror_batch_t *pBatch = (lscp_mirror_batch_t *) pvData;
+	lscp_midi_map_entry_t *pEntry;
+	lscp_midi_map_t *pMap;
+
+	// Either a map name or an entry info request...
+	if (strncmp(pBatch->ppszQueries[iQuery], "GET MIDI_INSTRUMENT_MAP ", 24) == 0) {
+		pMap = (lscp_midi_map_t *) pBatch->targets[iQuery];
+		if (ret == LSCP_OK && pszResult)
+			_lscp_midi_map_name_parse(&(pMap->name), pszResult);
+	} else {
+		pEntry = (lscp_midi_map_entry_t *) pBatch->targets[iQuery];
+		lscp_midi_instrument_info_reset(&(pEntry->info));
+		if (ret == LSCP_OK && pszResult)
+			_lscp_midi_instrument_info_parse(pClient->intern, &(pEntry->info), pszResult);
+	}
+}
+
+
+// Rebuild the mirrored map array after a fresh map list,
+// keeping what's still there; new maps are marked stale.
+static int _lscp_midi_mirror_merge_maps ( lscp_midi_maps_t *pMaps,
+	const int *piMaps, lscp_hash_t *pStale )
+{
+	lscp_midi_map_t *pOld = pMaps->maps;
+	lscp_midi_map_t *pNew;
+	int iOld = pMaps->map_count;
+	int iNew, i, j;
+
+	for (iNew = 0; piMaps && piMaps[iNew] >= 0; iNew++)
+		;
+
+	pNew = (lscp_midi_map_t *) malloc(
+		(iNew > 0 ? iNew : 1) * sizeof(lscp_midi_map_t));
+	if (pNew == NULL)
+		return -1;
+
+	for (i = 0; i < iNew; i++) {
+		for (j = 0; j < iOld; j++) {
+			if (pOld[j].map == piMaps[i])
+				break;
+		}
+		if (j < iOld) {
+			// Move it over...
+			pNew[i] = pOld[j];
+			lscp_midi_map_init(&pOld[j]);
+		} else {
+			// Brand new one...
+			lscp_midi_map_init(&pNew[i]);
+			pNew[i].map = piMaps[i];
+			lscp_hash_insert(pStale,
+				LSCP_MIDI_MIRROR_KEY(piMaps[i], LSCP_MIDI_MIRROR_NAME), pNew);
+			lscp_hash_insert(pStale,
+				LSCP_MIDI_MIRROR_KEY(piMaps[i], LSCP_MIDI_MIRROR_LIST), pNew);
+		}
+	}
+
+	// Get rid of the ones gone...
+	for (j = 0; j < iOld; j++)
+		lscp_midi_map_free(&pOld[j]);
+	if (pOld)
+		free(pOld);
+
+	pMaps->maps = pNew;
+	pMaps->map_count = iNew;
+
+	return 0;
+}
+
+
+// Rebuild a mirrored map entry array after a fresh entry list,
+// keeping what's still there; new entries are marked stale.
+static int _lscp_midi_mirror_merge_entries ( lscp_midi_map_t *pMap,
+	const lscp_midi_instrument_t *pInstrs, lscp_hash_t *pStale )
+{
+	lscp_midi_map_entry_t *pOld = pMap->entries;
+	lscp_midi_map_entry_t *pNew;
+	lscp_midi_map_entry_t *pEntry;
+	lscp_hash_t old;
+	int64_t key;
+	int iOld = pMap->entry_count;
+	int iNew, i;
+
+	for (iNew = 0; pInstrs && pInstrs[iNew].map >= 0; iNew++)
+		;
+
+	pNew = (lscp_midi_map_entry_t *) malloc(
+		(iNew > 0 ? iNew : 1) * sizeof(lscp_midi_map_entry_t));
+	if (pNew == NULL)
+		return -1;
+
+	// Maps may grow large: find old entries by key...
+	lscp_hash_init(&old);
+	for (i = 0; i < iOld; i++) {
+		key = LSCP_MIDI_MIRROR_ENTRY_KEY(pMap->map,
+			pOld[i].instr.bank, pOld[i].instr.prog);
+		if (lscp_hash_insert(&old, key, &pOld[i]) < 0) {
+			lscp_hash_free(&old);
+			free(pNew);
+			return -1;
+		}
+	}
+
+	for (i = 0; i < iNew; i++) {
+		key = LSCP_MIDI_MIRROR_ENTRY_KEY(pMap->map,
+			pInstrs[i].bank, pInstrs[i].prog);
+		pEntry = (lscp_midi_map_entry_t *) lscp_hash_remove(&old, key);
+		if (pEntry) {
+			// Move it over...
+			pNew[i] = *pEntry;
+			lscp_midi_instrument_info_init(&(pEntry->info));
+		} else {
+			// Brand new one...
+			pNew[i].instr.map  = pMap->map;
+			pNew[i].instr.bank = pInstrs[i].bank;
+			pNew[i].instr.prog = pInstrs[i].prog;
+			lscp_midi_instrument_info_init(&(pNew[i].info));
+			lscp_hash_insert(pStale, key, pNew);
+		}
+	}
+
+	lscp_hash_free(&old);
+
+	// Get rid of the ones gone...
+	for (i = 0; i < iOld; i++)
+		lscp_midi_instrument_info_free(&(pOld[i].info));
+	if (pOld)
+		free(pOld);
+
+	pMap->entries = pNew;
+	pMap->entry_count = iNew;
+
+	return 0;
+}
+
+
+// Put back some taken over stale state, for a later retry.
+static lscp_status_t _lscp_midi_mirror_retry ( lscp_midi_mirror_t *pMirror,
+	int iMapsStale, int iListsStale, lscp_hash_t *pStale )
+{
+	int i;
+
+	lscp_mutex_lock(pMirror->mutex);
+	pMirror->maps_stale  |= iMapsStale;
+	pMirror->lists_stale |= iListsStale;
+	for (i = 0; i < pStale->size; i++) {
+		if (pStale->values[i])
+			lscp_hash_insert(&(pMirror->stale), pStale->keys[i], pMirror);
+	}
+	lscp_mutex_unlock(pMirror->mutex);
+
+	lscp_hash_free(pStale);
+
+	return LSCP_FAILED;
+}
+
+
+// Refetch whatever got stale in the MIDI instrument map mirror,
+// in at most three pipelined round-trips (caller must own the
+// client mutex); on failure, stale state is kept for a retry.
+static lscp_status_t _lscp_midi_mirror_refresh ( lscp_client_t *pClient )
+{
+	lscp_midi_mirror_t *pMirror = &(pClient->midi_mirror);
+	lscp_midi_maps_t *pMaps = &(pMirror->maps);
+	lscp_midi_mirror_list_t list, *pLists;
+	lscp_midi_map_entry_t *pEntry;
+	lscp_midi_map_t *pMap;
+	lscp_mirror_batch_t batch;
+	lscp_hash_t stale;
+	int iMapsStale, iListsStale;
+	int iLists, i, j;
+
+	lscp_status_t ret = LSCP_OK;
+
+	// Last-known state is served as is, until reconciled...
+	if (pMirror->warm)
+		return LSCP_OK;
+
+	// Take over current stale state...
+	lscp_mutex_lock(pMirror->mutex);
+	iMapsStale  = pMirror->maps_stale;
+	iListsStale = pMirror->lists_stale;
+	pMirror->maps_stale  = 0;
+	pMirror->lists_stale = 0;
+	stale = pMirror->stale;
+	lscp_hash_init(&(pMirror->stale));
+	lscp_mutex_unlock(pMirror->mutex);
+
+	if (!iMapsStale && !iListsStale && stale.count < 1)
+		return LSCP_OK;
+
+	// 1. Map list...
+	if (iMapsStale) {
+		list.listed = 0;
+		list.maps   = NULL;
+		list.instrs = NULL;
+		if (lscp_mirror_batch_init(&batch, 1) < 0)
+			ret = LSCP_FAILED;
+		if (ret == LSCP_OK) {
+			strcpy(lscp_mirror_batch_add(&batch, &list),
+				"LIST MIDI_INSTRUMENT_MAPS\r\n");
+			ret = lscp_client_call_batch(pClient, batch.ppszQueries, batch.count, 0,
+				_lscp_midi_mirror_maps_result, &batch);
+		}
+		lscp_mirror_batch_free(&batch);
+		if (ret == LSCP_OK && (!list.listed
+			|| _lscp_midi_mirror_merge_maps(pMaps, list.maps, &stale) < 0))
+			ret = LSCP_FAILED;
+		lscp_isplit_destroy(list.maps);
+	}
+
+	// All map entry lists, if so told...
+	if (ret == LSCP_OK && iListsStale) {
+		for (i = 0; i < pMaps->map_count; i++) {
+			lscp_hash_insert(&stale, LSCP_MIDI_MIRROR_KEY(
+				pMaps->maps[i].map, LSCP_MIDI_MIRROR_LIST), pMirror);
+		}
+	}
+
+	// 2. Stale (and new) map entry lists...
+	iLists = 0;
+	for (i = 0; ret == LSCP_OK && i < pMaps->map_count; i++) {
+		if (lscp_hash_find(&stale, LSCP_MIDI_MIRROR_KEY(
+				pMaps->maps[i].map, LSCP_MIDI_MIRROR_LIST)))
+			iLists++;
+	}
+	if (iLists > 0) {
+		pLists = (lscp_midi_mirror_list_t *) malloc(
+			iLists * sizeof(lscp_midi_mirror_list_t));
+		if (pLists == NULL)
+			return _lscp_midi_mirror_retry(pMirror, iMapsStale, iListsStale, &stale);
+		if (lscp_mirror_batch_init(&batch, iLists) < 0)
+			ret = LSCP_FAILED;
+		if (ret == LSCP_OK) {
+			for (i = 0, j = 0; i < pMaps->map_count; i++) {
+				pMap = &(pMaps->maps[i]);
+				if (lscp_hash_find(&stale,
+						LSCP_MIDI_MIRROR_KEY(pMap->map, LSCP_MIDI_MIRROR_LIST)) == NULL)
+					continue;
+				pLists[j].listed = 0;
+				pLists[j].maps   = NULL;
+				pLists[j].instrs = NULL;
+				sprintf(lscp_mirror_batch_add(&batch, &pLists[j]),
+					"LIST MIDI_INSTRUMENTS %d\r\n", pMap->map);
+				j++;
+			}
+			ret = lscp_client_call_batch(pClient, batch.ppszQueries, batch.count, 0,
+				_lscp_midi_mirror_list_result, &batch);
+			for (i = 0, j = 0; i < pMaps->map_count; i++) {
+				pMap = &(pMaps->maps[i]);
+				if (lscp_hash_find(&stale,
+						LSCP_MIDI_MIRROR_KEY(pMap->map, LSCP_MIDI_MIRROR_LIST)) == NULL)
+					continue;
+				if (ret == LSCP_OK && (!pLists[j].listed
+					|| _lscp_midi_mirror_merge_entries(pMap, pLists[j].instrs, &stale) < 0))
+					ret = LSCP_FAILED;
+				lscp_midi_instruments_destroy(pLists[j].instrs);
+				j++;
+			}
+		}
+		lscp_mirror_batch_free(&batch);
+		free(pLists);
+	}
+
+	// 3. Stale (and new) map names and entries info...
+	if (ret == LSCP_OK && stale.count > 0) {
+		if (lscp_mirror_batch_init(&batch, stale.count) < 0)
+			ret = LSCP_FAILED;
+		for (i = 0; ret == LSCP_OK && i < pMaps->map_count; i++) {
+			pMap = &(pMaps->maps[i]);
+			if (lscp_hash_find(&stale,
+					LSCP_MIDI_MIRROR_KEY(pMap->map, LSCP_MIDI_MIRROR_NAME))) {
+				sprintf(lscp_mirror_batch_add(&batch, pMap),
+					"GET MIDI_INSTRUMENT_MAP INFO %d\r\n", pMap->map);
+			}
+			for (j = 0; j < pMap->entry_count; j++) {
+				pEntry = &(pMap->entries[j]);
+				if (lscp_hash_find(&stale, LSCP_MIDI_MIRROR_ENTRY_KEY(pMap->map,
+						pEntry->instr.bank, pEntry->instr.prog)) == NULL)
+					continue;
+				sprintf(lscp_mirror_batch_add(&batch, pEntry),
+					"GET MIDI_INSTRUMENT INFO %d %d %d\r\n",
+					pMap->map, pEntry->instr.bank, pEntry->instr.prog);
+			}
+		}
+		if (ret == LSCP_OK && batch.count > 0)
+			ret = lscp_client_call_batch(pClient, batch.ppszQueries, batch.count, 1,
+				_lscp_midi_mirror_info_result, &batch);
+		lscp_mirror_batch_free(&batch);
+	}
+
+	// Entries might have moved around, so rebuild the lookup indexes...
+	if (lscp_midi_mirror_index(pMirror) < 0)
+		ret = LSCP_FAILED;
+
+	// Leave it all stale for a retry, if something went wrong...
+	if (ret != LSCP_OK)
+		return _lscp_midi_mirror_retry(pMirror, iMapsStale, iListsStale, &stale);
+
+	lscp_hash_free(&stale);
+
+	return ret;
+}
+
+
+/**
+ *  Getting all MIDI instrument maps and their entries, from the local
+ *  mirror. Only what was notified to be stale since the last call gets
+ *  refetched from the server, in a few pipelined requests. The MIDI
+ *  instrument map mirror must be enabled with
+ *  @ref lscp_client_set_midi_map_mirror.
+ *
+ *  @param pClient  Pointer to client instance structure.
+ *
+ *  @returns A pointer to a @ref lscp_midi_maps_t structure, owned
+ *  by the client and valid until the next call, or NULL in case of failure.
+ */
+const lscp_midi_maps_t *lscp_get_midi_instrument_mirror ( lscp_client_t *pClient )
+{
+	lscp_midi_maps_t *pMaps = NULL;
+
+	if (pClient == NULL)
+		return NULL;
+	if (!pClient->midi_mirror.enabled)
+		return NULL;
+
+	// Lock this section up.
+	lscp_mutex_lock(pClient->mutex);
+
+	if (_lscp_midi_mirror_refresh(pClient) == LSCP_OK)
+		pMaps = &(pClient->midi_mirror.maps);
+
+	// Unlock this section down.
+	lscp_mutex_unlock(pClient->mutex);
+
+	return pMaps;
+}
+
+
+/**
+ *  Find what is mapped at a given MIDI instrument map, bank and program,
+ *  in constant time, from the local mirror (see
+ *  @ref lscp_get_midi_instrument_mirror).
+ *
+ *  @param pClient      Pointer to client instance structure.
+ *  @param pMidiInstr   MIDI instrument bank and program parameter key.
+ *
+ *  @returns A pointer to a @ref lscp_midi_map_entry_t structure, owned
+ *  by the client and valid until the next call, or NULL if not found
+ *  or in case of failure.
+ */
+const lscp_midi_map_entry_t *lscp_find_midi_instrument ( lscp_client_t *pClient,
+	lscp_midi_instrument_t *pMidiInstr )
+{
+	lscp_midi_map_entry_t *pEntry = NULL;
+
+	if (pClient == NULL)
+		return NULL;
+	if (!pClient->midi_mirror.enabled)
+		return NULL;
+	if (pMidiInstr->map < 0)
+		return NULL;
+	if (pMidiInstr->bank < 0 || pMidiInstr->bank > 16383)
+		return NULL;
+	if (pMidiInstr->prog < 0 || pMidiInstr->prog > 127)
+		return NULL;
+
+	// Lock this section up.
+	lscp_mutex_lock(pClient->mutex);
+
+	if (_lscp_midi_mirror_refresh(pClient) == LSCP_OK) {
+		pEntry = (lscp_midi_map_entry_t *) lscp_hash_find(
+			&(pClient->midi_mirror.entries), LSCP_MIDI_MIRROR_ENTRY_KEY(
+				pMidiInstr->map, pMidiInstr->bank, pMidiInstr->prog));
+	}
+
+	// Unlock this section down.
+	lscp_mutex_unlock(pClient->mutex);
+
+	return pEntry;
+}
+
+
+/**
+ *  Find all MIDI instrument map entries of a given name, through an
+ *  index of the local mirror (see @ref lscp_get_midi_instrument_mirror).
+ *
+ *  @param pClient  Pointer to client instance structure.
+ *  @param pszName  MIDI instrument map entry name.
+ *
+ *  @returns A NULL terminated array of @ref lscp_midi_map_entry_t pointers,
+ *  in map, bank and program order, owned by the client and valid until
+ *  the next call, or NULL if none found or in case of failure.
+ */
+const lscp_midi_map_entry_t **lscp_find_midi_instruments_by_name (
+	lscp_client_t *pClient, const char *pszName )
+{
+	const lscp_midi_map_entry_t **ppEntries = NULL;
+
+	if (pClient == NULL)
+		return NULL;
+	if (!pClient->midi_mirror.enabled)
+		return NULL;
+	if (pszName == NULL)
+		return NULL;
+
+	// Lock this section up.
+	lscp_mutex_lock(pClient->mutex);
+
+	if (_lscp_midi_mirror_refresh(pClient) == LSCP_OK)
+		ppEntries = lscp_midi_mirror_lookup(&(pClient->midi_mirror), 0,
+			lscp_intern_find(pClient->intern, pszName), -1);
+
+	// Unlock this section down.
+	lscp_mutex_unlock(pClient->mutex);
+
+	return ppEntries;
+}
+
+
+/**
+ *  Find all MIDI instrument map entries of a given instrument file,
+ *  through an index of the local mirror (see
+ *  @ref lscp_get_midi_instrument_mirror).
+ *
+ *  @param pClient      Pointer to client instance structure.
+ *  @param pszFileName  Instrument file name.
+ *  @param iInstrIndex  Instrument index number, or -1 for any.
+ *
+ *  @returns A NULL terminated array of @ref lscp_midi_map_entry_t pointers,
+ *  in map, bank and program order, owned by the client and valid until
+ *  the next call, or NULL if none found or in case of failure.
+ */
+const lscp_midi_map_entry_t **lscp_find_midi_instruments_by_file (
+	lscp_client_t *pClient, const char *pszFileName, int iInstrIndex )
+{
+	const lscp_midi_map_entry_t **ppEntries = NULL;
+
+	if (pClient == NULL)
+		return NULL;
+	if (!pClient->midi_mirror.enabled)
+		return NULL;
+	if (pszFileName == NULL)
+		return NULL;
+
+	// Lock this section up.
+	lscp_mutex_lock(pClient->mutex);
+
+	if (_lscp_midi_mirror_refresh(pClient) == LSCP_OK) {
+		ppEntries = lscp_midi_mirror_lookup(&(pClient->midi_mirror), 1,
+			lscp_intern_find(pClient->intern, pszFileName), iInstrIndex);
+	}
+
+	// Unlock this section down.
+	lscp_mutex_unlock(pClient->mutex);
 
-	return lscp_client_query(pClient, szQuery);
+	return ppEntries;
 }
 
 
@@ -3103,4 +6776,726 @@ lscp_status_t lscp_edit_channel_instrument ( lscp_client_t *pClient, int iSample
 }
 
 
+/**
+ *  Get the live meter values of a sampler channel, as last notified
+ *  by the server. This is lock-free and never touches the network,
+ *  thus safe to call at display rate from any thread; live meters
+ *  must be enabled with @ref lscp_client_set_live_meters.
+ *
+ *  @param pClient          Pointer to client instance structure.
+ *  @param iSamplerChannel  Sampler channel number.
+ *  @param pMeter           Pointer to the meter values to be filled.
+ *
+ *  @returns 0 on success, -1 if nothing has been notified for the
+ *  given sampler channel yet, or in case of failure.
+ */
+int lscp_get_channel_meter ( lscp_client_t *pClient, int iSamplerChannel,
+	lscp_channel_meter_t *pMeter )
+{
+	if (pClient == NULL || pMeter == NULL)
+		return -1;
+	if (!pClient->meters.enabled)
+		return -1;
+
+	return lscp_meter_table_read(&(pClient->meters), iSamplerChannel, pMeter);
+}
+
+
+/**
+ *  Get the total voice count, as last notified by the server, without
+ *  locking nor touching the network; live meters must be enabled with
+ *  @ref lscp_client_set_live_meters.
+ *
+ *  @param pClient  Pointer to client instance structure.
+ *
+ *  @returns The total number of active voices, or -1 if not notified
+ *  yet, or in case of failure.
+ */
+int lscp_get_total_voice_count_meter ( lscp_client_t *pClient )
+{
+	if (pClient == NULL)
+		return -1;
+	if (!pClient->meters.enabled)
+		return -1;
+
+	return pClient->meters.total_voice_count;
+}
+
+
+//-------------------------------------------------------------------------
+// Telemetry functions.
+
+/**
+ *  Get the buffer fill statistics of a disk stream, over the most recent
+ *  time window, as recorded by the telemetry: lowest and average fill,
+ *  in percentage, and trend, in percentage per second. The finest
+ *  resolution covering the whole window is used, so that statistics are
+ *  computed over raw samples for short windows and downsampled buckets
+ *  for longer ones; telemetry must be enabled with
+ *  @ref lscp_client_set_telemetry.
+ *
+ *  @param pClient          Pointer to client instance structure.
+ *  @param iSamplerChannel  Sampler channel number.
+ *  @param iStreamId        Disk stream id, as in @ref lscp_buffer_fill_t.
+ *  @param iWindow          Time window, in msecs.
+ *  @param pStats           Pointer to the statistics to be filled;
+ *                          samples is zero if none is in the window.
+ *
+ *  @returns 0 (zero) on success, -1 if nothing was ever recorded for
+ *  the stream (or telemetry is disabled).
+ */
+int lscp_get_stream_fill_stats ( lscp_client_t *pClient, int iSamplerChannel,
+	unsigned int iStreamId, int iWindow, lscp_telemetry_stats_t *pStats )
+{
+	if (pClient == NULL || pStats == NULL)
+		return -1;
+	if (!pClient->telemetry.enabled)
+		return -1;
+	if (iStreamId == LSCP_TELEMETRY_VOICES)
+		return -1;
+
+	return lscp_telemetry_stats(&(pClient->telemetry),
+		iSamplerChannel, iStreamId, iWindow, pStats);
+}
+
+
+/**
+ *  Get the voice count statistics of a sampler channel, over the most
+ *  recent time window, as recorded by the telemetry: lowest and average
+ *  voice count, and trend, in voices per second; telemetry must be
+ *  enabled with @ref lscp_client_set_telemetry.
+ *
+ *  @param pClient          Pointer to client instance structure.
+ *  @param iSamplerChannel  Sampler channel number.
+ *  @param iWindow          Time window, in msecs.
+ *  @param pStats           Pointer to the statistics to be filled;
+ *                          samples is zero if none is in the window.
+ *
+ *  @returns 0 (zero) on success, -1 if nothing was ever recorded for
+ *  the sampler channel (or telemetry is disabled).
+ */
+int lscp_get_channel_voice_stats ( lscp_client_t *pClient, int iSamplerChannel,
+	int iWindow, lscp_telemetry_stats_t *pStats )
+{
+	if (pClient == NULL || pStats == NULL)
+		return -1;
+	if (!pClient->telemetry.enabled)
+		return -1;
+
+	return lscp_telemetry_stats(&(pClient->telemetry),
+		iSamplerChannel, LSCP_TELEMETRY_VOICES, iWindow, pStats);
+}
+
+
+//-------------------------------------------------------------------------
+// Scene diff and apply functions.
+
+// Scene current state of effect sends and MIDI map entries,
+// as queried in one pipelined round-trip.
+typedef struct _lscp_scene_state_t
+{
+	lscp_mirror_batch_t batch;
+	// Effect sends, in scene order (found flags).
+	int                 fxsend_count;
+	lscp_fxsend_info_t *fxsends;
+	int *               fxsend_found;
+	// MIDI map entries, in scene order (found flags).
+	int                 instrument_count;
+	lscp_midi_instrument_info_t *instruments;
+	int *               instrument_found;
+
+} lscp_scene_state_t;
+
+
+// Scene current state pipelined response handler.
+static void _lscp_scene_state_result ( lscp_client_t *pClient,
+	int iQuery, lscp_status_t ret, char *pszResult, void *pvData )
+{
+	lscp_scene_state_t *pState = (lscp_scene_state_t *) pvData;
+	int *piFound = (int *) pState->batch.targets[iQuery];
+	int i;
+
+	if (ret != LSCP_OK || pszResult == NULL)
+		return;
+
+	if (piFound >= pState->fxsend_found
+		&& piFound < pState->fxsend_found + pState->fxsend_count) {
+		i = piFound - pState->fxsend_found;
+		_lscp_fxsend_info_parse(&(pState->fxsends[i]), pszResult);
+	} else {
+		i = piFound - pState->instrument_found;
+		_lscp_midi_instrument_info_parse(pClient->intern,
+			&(pState->instruments[i]), pszResult);
+	}
+
+	*piFound = 1;
+}
+
+
+static void _lscp_scene_state_free ( lscp_scene_state_t *pState )
+{
+	int i;
+
+	for (i = 0; pState->fxsends && i < pState->fxsend_count; i++)
+		lscp_fxsend_info_free(&(pState->fxsends[i]));
+	for (i = 0; pState->instruments && i < pState->instrument_count; i++)
+		lscp_midi_instrument_info_free(&(pState->instruments[i]));
+
+	if (pState->fxsends)
+		free(pState->fxsends);
+	if (pState->fxsend_found)
+		free(pState->fxsend_found);
+	if (pState->instruments)
+		free(pState->instruments);
+	if (pState->instrument_found)
+		free(pState->instrument_found);
+}
+
+
+// Query the current state of the scene effect sends, of sampler channels
+// found in the current table, and MIDI map entries (caller must own the
+// client mutex).
+static lscp_status_t _lscp_scene_state_query ( lscp_client_t *pClient,
+	const lscp_scene_t *pScene, const lscp_channel_table_t *pCurrent,
+	lscp_scene_state_t *pState )
+{
+	const lscp_scene_channel_t *pChannel;
+	const lscp_midi_instrument_t *pInstr;
+	int i, j, k;
+
+	lscp_status_t ret = LSCP_OK;
+
+	pState->fxsend_count = 0;
+	for (i = 0; i < pScene->channel_count; i++)
+		pState->fxsend_count += pScene->channels[i].fxsend_count;
+	pState->instrument_count = pScene->instrument_count;
+
+	k = pState->fxsend_count + pState->instrument_count;
+	pState->fxsends = (lscp_fxsend_info_t *) malloc(
+		(pState->fxsend_count + 1) * sizeof(lscp_fxsend_info_t));
+	pState->fxsend_found = (int *) calloc(pState->fxsend_count + 1, sizeof(int));
+	pState->instruments = (lscp_midi_instrument_info_t *) malloc(
+		(pState->instrument_count + 1) * sizeof(lscp_midi_instrument_info_t));
+	pState->instrument_found = (int *) calloc(pState->instrument_count + 1, sizeof(int));
+	if (pState->fxsends == NULL || pState->fxsend_found == NULL
+		|| pState->instruments == NULL || pState->instrument_found == NULL) {
+		pState->fxsend_count = 0;
+		pState->instrument_count = 0;
+		return LSCP_FAILED;
+	}
+
+	for (i = 0; i < pState->fxsend_count; i++)
+		lscp_fxsend_info_init(&(pState->fxsends[i]));
+	for (i = 0; i < pState->instrument_count; i++)
+		lscp_midi_instrument_info_init(&(pState->instruments[i]));
+
+	if (k < 1)
+		return LSCP_OK;
+
+	if (lscp_mirror_batch_init(&(pState->batch), k) < 0) {
+		lscp_mirror_batch_free(&(pState->batch));
+		return LSCP_FAILED;
+	}
+
+	for (i = 0, k = 0; i < pScene->channel_count; i++) {
+		pChannel = &(pScene->channels[i]);
+		for (j = 0; j < pChannel->fxsend_count; j++, k++) {
+			if (lscp_channel_table_row(pCurrent, pChannel->channel) < 0)
+				continue;
+			sprintf(lscp_mirror_batch_add(&(pState->batch), &(pState->fxsend_found[k])),
+				"GET FX_SEND INFO %d %d\r\n", pChannel->channel,
+				pChannel->fxsends[j].fxsend);
+		}
+	}
+
+	for (i = 0; i < pScene->instrument_count; i++) {
+		pInstr = &(pScene->instruments[i].instr);
+		sprintf(lscp_mirror_batch_add(&(pState->batch), &(pState->instrument_found[i])),
+			"GET MIDI_INSTRUMENT INFO %d %d %d\r\n",
+			pInstr->map, pInstr->bank, pInstr->prog);
+	}
+
+	if (pState->batch.count > 0) {
+		ret = lscp_client_call_batch(pClient, pState->batch.ppszQueries,
+			pState->batch.count, 1, _lscp_scene_state_result, pState);
+	}
+
+	lscp_mirror_batch_free(&(pState->batch));
+
+	return ret;
+}
+
+
+// Clear the scene convergence command list.
+static void _lscp_scene_clear ( lscp_client_t *pClient )
+{
+	int i;
+
+	for (i = 0; i < pClient->scene_count; i++)
+		free(pClient->scene_commands[i]);
+	pClient->scene_count = 0;
+
+	if (pClient->scene_commands)
+		pClient->scene_commands[0] = NULL;
+}
+
+
+// Make room for one more command in the scene convergence command list.
+static int _lscp_scene_grow ( lscp_client_t *pClient )
+{
+	char **ppszNewCommands;
+	int iNewSize;
+
+	if (pClient->scene_count + 1 < pClient->scene_size)
+		return 0;
+
+	iNewSize = (pClient->scene_size > 0 ? pClient->scene_size << 1 : 32);
+	ppszNewCommands = (char **) realloc(pClient->scene_commands,
+		iNewSize * sizeof(char *));
+	if (ppszNewCommands == NULL)
+		return -1;
+
+	pClient->scene_commands = ppszNewCommands;
+	pClient->scene_commands[pClient->scene_count] = NULL;
+	pClient->scene_size = iNewSize;
+
+	return 0;
+}
+
+
+// Append a command to the scene convergence command list.
+static int _lscp_scene_add ( lscp_client_t *pClient, const char *pszCommand )
+{
+	char *pszNewCommand;
+
+	if (_lscp_scene_grow(pClient) < 0)
+		return -1;
+
+	pszNewCommand = strdup(pszCommand);
+	if (pszNewCommand == NULL)
+		return -1;
+
+	pClient->scene_commands[pClient->scene_count++] = pszNewCommand;
+	pClient->scene_commands[pClient->scene_count] = NULL;
+
+	return 0;
+}
+
+
+// Append a formatted command, as long as it wasn't truncated
+// (given the snprintf result into a LSCP_BUFSIZ buffer).
+static int _lscp_scene_addn ( lscp_client_t *pClient,
+	const char *pszCommand, int cchCommand )
+{
+	if (cchCommand < 0 || cchCommand >= LSCP_BUFSIZ)
+		return -1;
+
+	return _lscp_scene_add(pClient, pszCommand);
+}
+
+
+// Whether two (possibly NULL) strings differ.
+static int _lscp_scene_differs ( const char *psz1, const char *psz2 )
+{
+	if (psz1 == NULL || psz2 == NULL)
+		return (psz1 != psz2);
+
+	return strcmp(psz1, psz2);
+}
+
+
+// Whether two volumes or levels differ (as told by the protocol).
+static int _lscp_scene_differs_float ( float f1, float f2 )
+{
+	float d = f1 - f2;
+
+	return (d > 0.0005f || d < -0.0005f);
+}
+
+
+// Append an audio routing commands, for every differing channel;
+// all of them, if there's no current routing.
+static int _lscp_scene_routing ( lscp_client_t *pClient, const char *pszPrefix,
+	const int *piRouting, const int *piCurrent )
+{
+	char szQuery[LSCP_BUFSIZ];
+	int i, iCurrent, iFailed = 0;
+
+	for (i = 0, iCurrent = 1; piRouting[i] >= 0; i++) {
+		if (piCurrent && iCurrent && piCurrent[i] < 0)
+			iCurrent = 0;
+		if (piCurrent && iCurrent && piCurrent[i] == piRouting[i])
+			continue;
+		iFailed |= _lscp_scene_addn(pClient, szQuery,
+			snprintf(szQuery, sizeof(szQuery), "%s %d %d\r\n",
+				pszPrefix, i, piRouting[i]));
+	}
+
+	return iFailed;
+}
+
+
+// Compute the scene convergence commands (caller must own the client
+// mutex): engines first, then channel and effect send settings, MIDI
+// map entries and, last, the (expensive) instrument loads.
+static lscp_status_t _lscp_scene_diff ( lscp_client_t *pClient,
+	const lscp_scene_t *pScene, const lscp_channel_table_t *pCurrent )
+{
+	const lscp_scene_channel_t *pChannel;
+	const lscp_scene_fxsend_t *pFxSend;
+	const lscp_scene_instrument_t *pSceneInstr;
+	lscp_midi_instrument_info_t *pInstrInfo;
+	lscp_fxsend_info_t *pFxSendInfo;
+	lscp_scene_state_t state;
+	char szQuery[LSCP_BUFSIZ];
+	char szValue[32];
+	int *piReload;
+	int *piDevice;
+	int iChannel, iRow, iFailed = 0;
+	int i, j, k;
+
+	lscp_status_t ret;
+
+	_lscp_scene_clear(pClient);
+	if (_lscp_scene_grow(pClient) < 0)
+		return LSCP_FAILED;
+
+	piReload = (int *) calloc(pScene->channel_count + 1, sizeof(int));
+	piDevice = (int *) calloc(pScene->channel_count + 1, sizeof(int));
+	if (piReload == NULL || piDevice == NULL) {
+		if (piReload)
+			free(piReload);
+		if (piDevice)
+			free(piDevice);
+		return LSCP_FAILED;
+	}
+
+	memset(&state, 0, sizeof(state));
+	ret = _lscp_scene_state_query(pClient, pScene, pCurrent, &state);
+
+	// 1. Engines (instruments must be reloaded then)...
+	for (i = 0; ret == LSCP_OK && i < pScene->channel_count; i++) {
+		pChannel = &(pScene->channels[i]);
+		iChannel = pChannel->channel;
+		iRow = lscp_channel_table_row(pCurrent, iChannel);
+		if (iRow < 0 || pChannel->engine_name == NULL)
+			continue;
+		if (pCurrent->engine_name[iRow] == NULL || strcasecmp(
+				pCurrent->engine_name[iRow], pChannel->engine_name)) {
+			iFailed |= _lscp_scene_addn(pClient, szQuery,
+				snprintf(szQuery, sizeof(szQuery), "LOAD ENGINE %s %d\r\n",
+					pChannel->engine_name, iChannel));
+			piReload[i] = 1;
+		}
+	}
+
+	// 2. Sampler channel settings...
+	for (i = 0; ret == LSCP_OK && i < pScene->channel_count; i++) {
+		pChannel = &(pScene->channels[i]);
+		iChannel = pChannel->channel;
+		iRow = lscp_channel_table_row(pCurrent, iChannel);
+		if (iRow < 0)
+			continue;
+		if (pChannel->audio_device != LSCP_SCENE_KEEP
+			&& pChannel->audio_device != pCurrent->audio_device[iRow]) {
+			sprintf(szQuery, "SET CHANNEL AUDIO_OUTPUT_DEVICE %d %d\r\n",
+				iChannel, pChannel->audio_device);
+			iFailed |= _lscp_scene_add(pClient, szQuery);
+			piDevice[i] = 1;
+		}
+		if (pChannel->audio_routing) {
+			sprintf(szQuery, "SET CHANNEL AUDIO_OUTPUT_CHANNEL %d", iChannel);
+			iFailed |= _lscp_scene_routing(pClient, szQuery, pChannel->audio_routing,
+				(piDevice[i] ? NULL : pCurrent->audio_routing[iRow]));
+		}
+		if (pChannel->midi_device != LSCP_SCENE_KEEP
+			&& pChannel->midi_device != pCurrent->midi_device[iRow]) {
+			sprintf(szQuery, "SET CHANNEL MIDI_INPUT_DEVICE %d %d\r\n",
+				iChannel, pChannel->midi_device);
+			iFailed |= _lscp_scene_add(pClient, szQuery);
+		}
+		if (pChannel->midi_port != LSCP_SCENE_KEEP
+			&& pChannel->midi_port != pCurrent->midi_port[iRow]) {
+			sprintf(szQuery, "SET CHANNEL MIDI_INPUT_PORT %d %d\r\n",
+				iChannel, pChannel->midi_port);
+			iFailed |= _lscp_scene_add(pClient, szQuery);
+		}
+		if (pChannel->midi_channel != LSCP_SCENE_KEEP
+			&& pChannel->midi_channel != pCurrent->midi_channel[iRow]) {
+			if (pChannel->midi_channel == LSCP_MIDI_CHANNEL_ALL)
+				sprintf(szQuery, "SET CHANNEL MIDI_INPUT_CHANNEL %d ALL\r\n",
+					iChannel);
+			else
+				sprintf(szQuery, "SET CHANNEL MIDI_INPUT_CHANNEL %d %d\r\n",
+					iChannel, pChannel->midi_channel);
+			iFailed |= _lscp_scene_add(pClient, szQuery);
+		}
+		if (pChannel->midi_map != LSCP_SCENE_KEEP
+			&& pChannel->midi_map != pCurrent->midi_map[iRow]) {
+			if (pChannel->midi_map == LSCP_MIDI_MAP_NONE)
+				strcpy(szValue, "NONE");
+			else
+			if (pChannel->midi_map == LSCP_MIDI_MAP_DEFAULT)
+				strcpy(szValue, "DEFAULT");
+			else
+				sprintf(szValue, "%d", pChannel->midi_map);
+			sprintf(szQuery, "SET CHANNEL MIDI_INSTRUMENT_MAP %d %s\r\n",
+				iChannel, szValue);
+			iFailed |= _lscp_scene_add(pClient, szQuery);
+		}
+		if (pChannel->volume >= 0.0f
+			&& _lscp_scene_differs_float(pChannel->volume, pCurrent->volume[iRow])) {
+			lscp_ftoa(szValue, sizeof(szValue), pChannel->volume);
+			sprintf(szQuery, "SET CHANNEL VOLUME %d %s\r\n", iChannel, szValue);
+			iFailed |= _lscp_scene_add(pClient, szQuery);
+		}
+		if (pChannel->mute != LSCP_SCENE_KEEP
+			&& (pChannel->mute != 0) != (pCurrent->mute[iRow] != 0)) {
+			sprintf(szQuery, "SET CHANNEL MUTE %d %d\r\n",
+				iChannel, (pChannel->mute ? 1 : 0));
+			iFailed |= _lscp_scene_add(pClient, szQuery);
+		}
+		if (pChannel->solo != LSCP_SCENE_KEEP
+			&& (pChannel->solo != 0) != (pCurrent->solo[iRow] != 0)) {
+			sprintf(szQuery, "SET CHANNEL SOLO %d %d\r\n",
+				iChannel, (pChannel->solo ? 1 : 0));
+			iFailed |= _lscp_scene_add(pClient, szQuery);
+		}
+	}
+
+	// 3. Effect sends (existing ones only)...
+	for (i = 0, k = 0; ret == LSCP_OK && i < pScene->channel_count; i++) {
+		pChannel = &(pScene->channels[i]);
+		iChannel = pChannel->channel;
+		for (j = 0; j < pChannel->fxsend_count; j++, k++) {
+			if (!state.fxsend_found[k])
+				continue;
+			pFxSend = &(pChannel->fxsends[j]);
+			pFxSendInfo = &(state.fxsends[k]);
+			if (pFxSend->level >= 0.0f
+				&& _lscp_scene_differs_float(pFxSend->level, pFxSendInfo->level)) {
+				lscp_ftoa(szValue, sizeof(szValue), pFxSend->level);
+				sprintf(szQuery, "SET FX_SEND LEVEL %d %d %s\r\n",
+					iChannel, pFxSend->fxsend, szValue);
+				iFailed |= _lscp_scene_add(pClient, szQuery);
+			}
+			if (pFxSend->audio_routing) {
+				sprintf(szQuery, "SET FX_SEND AUDIO_OUTPUT_CHANNEL %d %d",
+					iChannel, pFxSend->fxsend);
+				iFailed |= _lscp_scene_routing(pClient, szQuery,
+					pFxSend->audio_routing, pFxSendInfo->audio_routing);
+			}
+		}
+	}
+
+	// 4. MIDI instrument map entries (name kept, if not given)...
+	for (i = 0; ret == LSCP_OK && i < pScene->instrument_count; i++) {
+		pSceneInstr = &(pScene->instruments[i]);
+		pInstrInfo = &(state.instruments[i]);
+		if (pSceneInstr->engine_name == NULL || pSceneInstr->instrument_file == NULL)
+			continue;
+		if (state.instrument_found[i]
+			&& pInstrInfo->engine_name
+			&& strcasecmp(pInstrInfo->engine_name, pSceneInstr->engine_name) == 0
+			&& !_lscp_scene_differs(pInstrInfo->instrument_file,
+				pSceneInstr->instrument_file)
+			&& pInstrInfo->instrument_nr == pSceneInstr->instrument_nr
+			&& !_lscp_scene_differs_float(pInstrInfo->volume,
+				(pSceneInstr->volume < 0.0f ? 1.0f : pSceneInstr->volume))
+			&& (pSceneInstr->load_mode == LSCP_LOAD_DEFAULT
+				|| pSceneInstr->load_mode == pInstrInfo->load_mode)
+			&& (pSceneInstr->name == NULL
+				|| !_lscp_scene_differs(pInstrInfo->name, pSceneInstr->name)))
+			continue;
+		iFailed |= _lscp_scene_addn(pClient, szQuery,
+			_lscp_map_midi_instrument_query(szQuery, sizeof(szQuery), 1,
+				&(pSceneInstr->instr), pSceneInstr->engine_name,
+				pSceneInstr->instrument_file, pSceneInstr->instrument_nr,
+				pSceneInstr->volume, pSceneInstr->load_mode,
+				(pSceneInstr->name ? pSceneInstr->name
+					: (state.instrument_found[i] ? pInstrInfo->name : NULL))));
+	}
+
+	// 5. Instruments, last as these are the expensive ones...
+	for (i = 0; ret == LSCP_OK && i < pScene->channel_count; i++) {
+		pChannel = &(pScene->channels[i]);
+		iChannel = pChannel->channel;
+		iRow = lscp_channel_table_row(pCurrent, iChannel);
+		if (iRow < 0 || pChannel->instrument_file == NULL)
+			continue;
+		// Instrument index kept as currently found, if told so...
+		j = pChannel->instrument_nr;
+		if (j == LSCP_SCENE_KEEP)
+			j = (pCurrent->instrument_nr[iRow] < 0 ? 0 : pCurrent->instrument_nr[iRow]);
+		if (piReload[i]
+			|| pCurrent->instrument_status[iRow] < 0
+			|| pCurrent->instrument_nr[iRow] != j
+			|| _lscp_scene_differs(pCurrent->instrument_file[iRow],
+				pChannel->instrument_file)) {
+			iFailed |= _lscp_scene_addn(pClient, szQuery,
+				snprintf(szQuery, sizeof(szQuery),
+					"LOAD INSTRUMENT NON_MODAL '%s' %d %d\r\n",
+					pChannel->instrument_file, j, iChannel));
+		}
+	}
+
+	if (ret == LSCP_OK && iFailed)
+		ret = LSCP_FAILED;
+	if (ret != LSCP_OK)
+		_lscp_scene_clear(pClient);
+
+	_lscp_scene_state_free(&state);
+	free(piDevice);
+	free(piReload);
+
+	return ret;
+}
+
+
+/**
+ *  Compute the minimal ordered set of commands that would bring the
+ *  server to a given desired scene: engines first, then sampler channel
+ *  and effect send settings, MIDI instrument map entries and, last, the
+ *  (expensive) instrument loads. Only what differs from the current
+ *  state gets a command; the current state of effect sends and MIDI
+ *  instrument map entries is queried in one pipelined round-trip.
+ *  Sampler channels and effect sends not currently found are skipped.
+ *
+ *  @param pClient  Pointer to client instance structure.
+ *  @param pScene   Pointer to the desired scene description.
+ *  @param pCurrent Pointer to the current sampler channels snapshot,
+ *                  as given by @ref lscp_get_all_channel_info, or
+ *                  NULL to have it taken right away.
+ *
+ *  @returns A NULL terminated array of LSCP command strings (possibly
+ *  empty, if nothing is to be changed), owned by the client and valid
+ *  until the next call, or NULL in case of failure.
+ */
+const char **lscp_scene_diff ( lscp_client_t *pClient,
+	const lscp_scene_t *pScene, const lscp_channel_table_t *pCurrent )
+{
+	const char **ppszCommands = NULL;
+
+	if (pClient == NULL || pScene == NULL)
+		return NULL;
+
+	if (pCurrent == NULL)
+		pCurrent = lscp_get_all_channel_info(pClient, 0);
+	if (pCurrent == NULL)
+		return NULL;
+
+	// Lock this section up.
+	lscp_mutex_lock(pClient->mutex);
+
+	if (_lscp_scene_diff(pClient, pScene, pCurrent) == LSCP_OK)
+		ppszCommands = (const char **) pClient->scene_commands;
+
+	// Unlock this section down.
+	lscp_mutex_unlock(pClient->mutex);
+
+	return ppszCommands;
+}
+
+
+// Scene convergence pipelined response state.
+typedef struct _lscp_scene_apply_t
+{
+	lscp_status_t status;   // First failed command status.
+	char *        result;   // First failed command result.
+
+} lscp_scene_apply_t;
+
+
+// Scene convergence pipelined response handler.
+static void _lscp_scene_apply_result ( lscp_client_t *pClient,
+	int iQuery, lscp_status_t ret, char *pszResult, void *pvData )
+{
+	lscp_scene_apply_t *pApply = (lscp_scene_apply_t *) pvData;
+
+	(void) pClient;
+	(void) iQuery;
+
+	if (ret != LSCP_OK && pApply->status == LSCP_OK) {
+		pApply->status = ret;
+		if (pszResult)
+			pApply->result = strdup(pszResult);
+	}
+}
+
+
+/**
+ *  Bring the server to a given desired scene, as told by
+ *  @ref lscp_scene_diff, with all commands pipelined in one go.
+ *
+ *  @param pClient  Pointer to client instance structure.
+ *  @param pScene   Pointer to the desired scene description.
+ *  @param pCurrent Pointer to the current sampler channels snapshot,
+ *                  as given by @ref lscp_get_all_channel_info, or
+ *                  NULL to have it taken right away.
+ *
+ *  @returns LSCP_OK on success, or the status of the first failed
+ *  command (LSCP_FAILED, LSCP_WARNING or LSCP_ERROR).
+ */
+lscp_status_t lscp_scene_apply ( lscp_client_t *pClient,
+	const lscp_scene_t *pScene, const lscp_channel_table_t *pCurrent )
+{
+	const char **ppszCommands;
+	lscp_scene_apply_t apply;
+	lscp_status_t ret;
+	int iMap, iBank, iProg;
+	int i;
+
+	if (pClient == NULL || pScene == NULL)
+		return LSCP_FAILED;
+
+	if (pCurrent == NULL)
+		pCurrent = lscp_get_all_channel_info(pClient, 0);
+	if (pCurrent == NULL)
+		return LSCP_FAILED;
+
+	// Lock this section up.
+	lscp_mutex_lock(pClient->mutex);
+
+	// The command list must not be recomputed (freed) by someone
+	// else until it's all sent, so it's all under one lock hold
+	// (and left empty on failure)...
+	ret = _lscp_scene_diff(pClient, pScene, pCurrent);
+	ppszCommands = (const char **) pClient->scene_commands;
+
+	apply.status = LSCP_OK;
+	apply.result = NULL;
+
+	if (ret == LSCP_OK && pClient->scene_count > 0) {
+		ret = lscp_client_call_batch(pClient, ppszCommands, pClient->scene_count, 0,
+			_lscp_scene_apply_result, &apply);
+	}
+	if (ret == LSCP_OK && apply.status != LSCP_OK) {
+		ret = apply.status;
+		lscp_client_set_result(pClient, apply.result, -1);
+	}
+	if (apply.result)
+		free(apply.result);
+
+	// Whatever got mirrored or cached is now stale...
+	for (i = 0; i < pClient->scene_count; i++) {
+		if (sscanf(ppszCommands[i], "MAP MIDI_INSTRUMENT NON_MODAL %d %d %d",
+				&iMap, &iBank, &iProg) == 3) {
+			_lscp_midi_mirror_touch(pClient,
+				LSCP_MIDI_MIRROR_KEY(iMap, LSCP_MIDI_MIRROR_LIST));
+			_lscp_midi_mirror_touch(pClient,
+				LSCP_MIDI_MIRROR_ENTRY_KEY(iMap, iBank, iProg));
+		}
+	}
+	if (pClient->scene_count > 0) {
+		for (i = 0; i < pScene->channel_count; i++)
+			_lscp_channel_cache_invalidate(pClient, pScene->channels[i].channel);
+	}
+
+	// Unlock this section down.
+	lscp_mutex_unlock(pClient->mutex);
+
+	return ret;
+}
+
+
 // end of client.c
@@ -23,6 +23,10 @@
 #include "common.h"
 
 #include <ctype.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <float.h>
+#include <math.h>
 #include <sys/time.h>
 #ifdef WIN32
 # include <errno.h>
@@ -30,13 +34,34 @@
 # include <sys/errno.h>
 #endif
 
+// Vectorized separator scanning (SSE2 baseline, AVX2 on demand).
+#if defined(__GNUC__) && defined(__SSE2__)
+# include <emmintrin.h>
+# define LSCP_SCAN_SSE2 1
+// The vectorized scanners load whole aligned blocks, which may start
+// ahead of the string and end past its null terminator; that is fine,
+// as an aligned block never crosses a page boundary, but it is still
+// out of bounds to AddressSanitizer, so these are left uninstrumented.
+# define LSCP_SCAN_NOASAN __attribute__((no_sanitize_address))
+# if defined(__x86_64__) && (defined(__clang__) || __GNUC__ >= 5)
+#  include <immintrin.h>
+#  define LSCP_SCAN_AVX2 1
+# endif
+#endif
+
 
-// Split chunk size magic:
-// LSCP_SPLIT_CHUNK1 := 2 ^ LSCP_SPLIT_CHUNK2
+// Split chunk size magic: minimum legal size.
 #define LSCP_SPLIT_CHUNK1   4
-#define LSCP_SPLIT_CHUNK2   2
-// Chunk size legal calculator.
-#define LSCP_SPLIT_SIZE(n) ((((n) >> LSCP_SPLIT_CHUNK2) + 1) << LSCP_SPLIT_CHUNK2)
+
+// Chunk size legal calculator (geometric growth):
+// the smallest power of two greater than n, at least one chunk.
+static int _lscp_split_size ( int n )
+{
+	int iSize = LSCP_SPLIT_CHUNK1;
+	while (iSize <= n)
+		iSize <<= 1;
+	return iSize;
+}
 
 
 //-------------------------------------------------------------------------
@@ -112,6 +137,23 @@ lscp_status_t lscp_client_recv ( lscp_client_t *pClient, char *pchBuffer, int *p
 }
 
 
+// Check whether an accumulated response is complete: single-line results
+// end on the first CRLF; multi-line results end on a lone "." line.
+static int _lscp_client_eot ( const char *pchBuffer, int cchBuffer, int iResult )
+{
+	if (cchBuffer < 2
+		|| pchBuffer[cchBuffer - 1] != '\n'
+		|| pchBuffer[cchBuffer - 2] != '\r')
+		return 0;
+
+	if (iResult < 1)
+		return 1;
+
+	return (cchBuffer >= 3 && pchBuffer[cchBuffer - 3] == '.'
+		&& (cchBuffer == 3 || pchBuffer[cchBuffer - 4] == '\n'));
+}
+
+
 // The main client requester call executive.
 lscp_status_t lscp_client_call ( lscp_client_t *pClient, const char *pszQuery, int iResult )
 {
@@ -120,11 +162,13 @@ lscp_status_t lscp_client_call ( lscp_client_t *pClient, const char *pszQuery, i
 	int    cchBuffer;
 	const  char *pszSeps = ":[]";
 	char  *pszBuffer;
+	char  *pszNewBuffer;
 	char  *pszToken;
 	char  *pch;
 	int    iErrno;
 	char  *pszResult;
 	int    cchResult;
+	int    cbResult;
 	ssize_t sz;
 	
 	lscp_status_t ret = LSCP_FAILED;
@@ -134,6 +178,7 @@ lscp_status_t lscp_client_call ( lscp_client_t *pClient, const char *pszQuery, i
 	
 	iErrno = -1;
 	cchResult = 0;
+	cbResult = 0;
 	pszResult = NULL;
 	pszBuffer = NULL;
 
@@ -187,49 +232,55 @@ lscp_status_t lscp_client_call ( lscp_client_t *pClient, const char *pszQuery, i
 		case LSCP_OK:
 			// Always force the result to be null terminated.
 			achBuffer[cchBuffer] = (char) 0;
-			// Check if the response it's an error or warning message.
-			if (strncasecmp(achBuffer, "WRN:", 4) == 0)
-				ret = LSCP_WARNING;
-			else if (strncasecmp(achBuffer, "ERR:", 4) == 0)
-				ret = LSCP_ERROR;
+			// Check if the response it's an error or warning message
+			// (only at the very beginning of a response, of course).
+			if (cchResult == 0) {
+				if (strncasecmp(achBuffer, "WRN:", 4) == 0)
+					ret = LSCP_WARNING;
+				else if (strncasecmp(achBuffer, "ERR:", 4) == 0)
+					ret = LSCP_ERROR;
+			}
 			// So we got a result...
 			if (ret == LSCP_OK) {
 				// Reset errno in case of success.
 				iErrno = 0;
 				// Is it a special successful response?
-				if (iResult < 1 && strncasecmp(achBuffer, "OK[", 3) == 0) {
+				if (iResult < 1 && cchResult == 0
+					&& strncasecmp(achBuffer, "OK[", 3) == 0) {
 					// Parse the OK message, get the return string under brackets...
 					pszToken = lscp_strtok(achBuffer, pszSeps, &(pch));
 					if (pszToken)
 						pszResult = lscp_strtok(NULL, pszSeps, &(pch));
 				} else {
-					// It can be specially long response...
-					cchResult += sizeof(achBuffer);
-					pszResult  = malloc(cchResult + 1);
-					pszResult[0] = (char) 0;
-					if (pszBuffer) {
-						strcat(pszResult, pszBuffer);
-						free(pszBuffer);
+					// It can be specially long response,
+					// so grow the long-buffer geometrically...
+					if (cchResult + cchBuffer + 1 > cbResult) {
+						if (cbResult < (int) sizeof(achBuffer))
+							cbResult = sizeof(achBuffer);
+						while (cchResult + cchBuffer + 1 > cbResult)
+							cbResult <<= 1;
+						pszNewBuffer = (char *) realloc(pszBuffer, cbResult);
+						if (pszNewBuffer == NULL) {
+							pszResult = "Out of memory during receive operation";
+							iErrno = -ENOMEM;
+							ret = LSCP_FAILED;
+							break;
+						}
+						pszBuffer = pszNewBuffer;
 					}
-					strcat(pszResult, achBuffer);
-					pszBuffer = pszResult;
-					pszResult = NULL;
+					memcpy(pszBuffer + cchResult, achBuffer, cchBuffer + 1);
+					cchResult += cchBuffer;
 					// Check for correct end-of-transmission...
 					// Depending whether its single or multi-line we'll
 					// flag end-of-transmission...
-					cchBuffer = strlen(pszBuffer);
-					if (cchBuffer >= 2
-						&& pszBuffer[cchBuffer - 1] == '\n'
-						&& pszBuffer[cchBuffer - 2] == '\r'
-						&& (iResult < 1 || (cchBuffer >= 3
-								&& pszBuffer[cchBuffer - 3] == '.'))) {
+					if (_lscp_client_eot(pszBuffer, cchResult, iResult)) {
 						// Get rid of the trailling dot and CRLF anyway...
-						while (cchBuffer > 0 && (
-							pszBuffer[cchBuffer - 1] == '\r' ||
-							pszBuffer[cchBuffer - 1] == '\n' ||
-							pszBuffer[cchBuffer - 1] == '.'))
-							cchBuffer--;
-						pszBuffer[cchBuffer] = (char) 0;
+						while (cchResult > 0 && (
+							pszBuffer[cchResult - 1] == '\r' ||
+							pszBuffer[cchResult - 1] == '\n' ||
+							pszBuffer[cchResult - 1] == '.'))
+							cchResult--;
+						pszBuffer[cchResult] = (char) 0;
 						pszResult = pszBuffer;
 					}
 				}
@@ -246,7 +297,7 @@ lscp_status_t lscp_client_call ( lscp_client_t *pClient, const char *pszQuery, i
 					// Get the error number...
 					pszToken = lscp_strtok(NULL, pszSeps, &(pch));
 					if (pszToken) {
-						iErrno = atoi(pszToken) + 100;
+						iErrno = lscp_atoi(pszToken) + 100;
 						// And make the message text our final result.
 						pszResult = lscp_strtok(NULL, pszSeps, &(pch));
 					}
@@ -288,6 +339,311 @@ lscp_status_t lscp_client_call ( lscp_client_t *pClient, const char *pszQuery, i
 }
 
 
+// Pipelined requests: maximum number of queries in flight.
+#define LSCP_BATCH_WINDOW   64
+
+
+// Find the extent of the first complete response in a received stream:
+// single-line results and errors/warnings end on the first CRLF;
+// multi-line results end on a lone "." line; 0 if still incomplete.
+static int _lscp_client_frame ( const char *pchBuffer, int cchBuffer, int iResult )
+{
+	int i, iLine;
+
+	for (iLine = 0, i = 1; i < cchBuffer; i++) {
+		if (pchBuffer[i] != '\n' || pchBuffer[i - 1] != '\r')
+			continue;
+		if (iLine == 0 && (iResult < 1
+			|| strncasecmp(pchBuffer, "ERR:", 4) == 0
+			|| strncasecmp(pchBuffer, "WRN:", 4) == 0))
+			return i + 1;
+		if (i - iLine == 2 && pchBuffer[iLine] == '.')
+			return i + 1;
+		iLine = i + 1;
+	}
+
+	return 0;
+}
+
+
+// Decode one framed response in place, as lscp_client_call would do;
+// the result string is returned on *ppszResult (may be NULL).
+lscp_status_t lscp_client_frame_result ( char *pchFrame, int cchFrame,
+	int iResult, char **ppszResult, int *piErrno )
+{
+	const char *pszSeps = ":[]";
+	char *pszToken;
+	char *pch;
+
+	lscp_status_t ret = LSCP_OK;
+
+	*ppszResult = NULL;
+	*piErrno = 0;
+
+	if (strncasecmp(pchFrame, "WRN:", 4) == 0)
+		ret = LSCP_WARNING;
+	else if (strncasecmp(pchFrame, "ERR:", 4) == 0)
+		ret = LSCP_ERROR;
+
+	// Get rid of the trailling dot and CRLF anyway...
+	while (cchFrame > 0 && (
+		pchFrame[cchFrame - 1] == '\r' ||
+		pchFrame[cchFrame - 1] == '\n' ||
+		(ret == LSCP_OK && iResult > 0 && pchFrame[cchFrame - 1] == '.')))
+		cchFrame--;
+	pchFrame[cchFrame] = (char) 0;
+
+	if (ret != LSCP_OK) {
+		// Parse the error/warning message, skip first colon...
+		*piErrno = -1;
+		pszToken = lscp_strtok(pchFrame, pszSeps, &(pch));
+		if (pszToken) {
+			pszToken = lscp_strtok(NULL, pszSeps, &(pch));
+			if (pszToken) {
+				*piErrno = lscp_atoi(pszToken) + 100;
+				*ppszResult = lscp_strtok(NULL, pszSeps, &(pch));
+			}
+		}
+	}
+	else if (iResult < 1 && strncasecmp(pchFrame, "OK[", 3) == 0) {
+		// Parse the OK message, get the return string under brackets...
+		pszToken = lscp_strtok(pchFrame, pszSeps, &(pch));
+		if (pszToken)
+			*ppszResult = lscp_strtok(NULL, pszSeps, &(pch));
+	}
+	else *ppszResult = pchFrame;
+
+	return ret;
+}
+
+
+// The pipelined client requester call executive: all queries are sent
+// without waiting for each response, keeping up to a window of them in
+// flight; responses are handed over, in order, to the given callback.
+// Response kinds are either given per query (piResults) or else all the
+// same (iResult). Returns LSCP_OK if all responses were received,
+// whatever their status.
+static lscp_status_t _lscp_client_call_batch ( lscp_client_t *pClient,
+	const char **ppszQueries, int iQueries, int iResult, const int *piResults,
+	lscp_client_batch_proc_t pfnResult, void *pvData )
+{
+	char   achBuffer[LSCP_BUFSIZ];
+	int    cchBuffer;
+	char  *pszBuffer;
+	char  *pszNewBuffer;
+	int    iStream;
+	int    cchStream;
+	int    cbStream;
+	int    cchFrame;
+	int    cchQuery;
+	int    iSent;
+	int    iRecv;
+	int    iErrno;
+	char  *pszResult;
+	ssize_t sz;
+
+	lscp_status_t ret = LSCP_OK;
+	lscp_status_t status;
+
+	if (pClient == NULL)
+		return LSCP_FAILED;
+
+	// Check if command socket socket is still valid.
+	if (pClient->cmd.sock == INVALID_SOCKET) {
+		lscp_client_set_result(pClient,
+			"Connection closed or no longer valid", -1);
+		return LSCP_FAILED;
+	}
+
+	// Check if last transaction has timed out, in which case
+	// we'll retry wait and flush for some pending garbage...
+	if (pClient->iTimeoutCount > 0) {
+		pClient->iTimeoutCount = 0;
+		cchBuffer = sizeof(achBuffer);
+		ret = lscp_client_recv(pClient, achBuffer, &cchBuffer, pClient->iTimeout);
+		if (ret != LSCP_OK) {
+			lscp_client_set_result(pClient,
+				"Failure during flush timeout operation", (int) ret);
+			return ret;
+		}
+	}
+
+	pszBuffer = NULL;
+	iStream   = 0;
+	cchStream = 0;
+	cbStream  = 0;
+
+	iSent = 0;
+	iRecv = 0;
+
+	while (ret == LSCP_OK && iRecv < iQueries) {
+		// Send as many queries as fit in the window,
+		// coalesced into as few packets as we can...
+		cchBuffer = 0;
+		while (iSent < iQueries && iSent - iRecv < LSCP_BATCH_WINDOW) {
+			cchQuery = strlen(ppszQueries[iSent]);
+			if (cchBuffer > 0 && cchBuffer + cchQuery > (int) sizeof(achBuffer))
+				break;
+			if (cchQuery > (int) sizeof(achBuffer)) {
+				// Too long to coalesce, send it on its own...
+				sz = send(pClient->cmd.sock, ppszQueries[iSent], cchQuery, 0);
+				if (sz < cchQuery) {
+					ret = LSCP_FAILED;
+					break;
+				}
+			} else {
+				memcpy(achBuffer + cchBuffer, ppszQueries[iSent], cchQuery);
+				cchBuffer += cchQuery;
+			}
+			iSent++;
+		}
+		if (ret == LSCP_OK && cchBuffer > 0) {
+			sz = send(pClient->cmd.sock, achBuffer, cchBuffer, 0);
+			if (sz < cchBuffer)
+				ret = LSCP_FAILED;
+		}
+		if (ret != LSCP_OK) {
+			lscp_socket_perror("_lscp_client_call_batch: send");
+			lscp_client_set_result(pClient,
+				"Failure during send operation", -errno);
+			break;
+		}
+		// Hand over all complete responses received so far...
+		while (iRecv < iSent) {
+			if (piResults)
+				iResult = piResults[iRecv];
+			cchFrame = _lscp_client_frame(pszBuffer + iStream, cchStream, iResult);
+			if (cchFrame < 1) {
+				// Shift any partial response to the front...
+				if (iStream > 0) {
+					memmove(pszBuffer, pszBuffer + iStream, cchStream);
+					iStream = 0;
+				}
+				// Wait for receive event...
+				cchBuffer = sizeof(achBuffer);
+				ret = lscp_client_recv(pClient, achBuffer, &cchBuffer, pClient->iTimeout);
+				if (ret != LSCP_OK)
+					break;
+				// Grow the stream buffer geometrically...
+				if (cchStream + cchBuffer + 1 > cbStream) {
+					if (cbStream < (int) sizeof(achBuffer))
+						cbStream = sizeof(achBuffer);
+					while (cchStream + cchBuffer + 1 > cbStream)
+						cbStream <<= 1;
+					pszNewBuffer = (char *) realloc(pszBuffer, cbStream);
+					if (pszNewBuffer == NULL) {
+						lscp_client_set_result(pClient,
+							"Out of memory during receive operation", -ENOMEM);
+						ret = LSCP_FAILED;
+						break;
+					}
+					pszBuffer = pszNewBuffer;
+				}
+				memcpy(pszBuffer + cchStream, achBuffer, cchBuffer);
+				cchStream += cchBuffer;
+				continue;
+			}
+			// Got one...
+			status = lscp_client_frame_result(pszBuffer + iStream, cchFrame,
+				iResult, &pszResult, &iErrno);
+			if (pfnResult)
+				(*pfnResult)(pClient, iRecv, status, pszResult, pvData);
+			iStream   += cchFrame;
+			cchStream -= cchFrame;
+			iRecv++;
+		}
+	}
+
+	// Make the result official...
+	switch (ret) {
+	case LSCP_OK:
+		lscp_client_set_result(pClient, NULL, 0);
+		break;
+	case LSCP_TIMEOUT:
+		pClient->iTimeoutCount++;
+		lscp_client_set_result(pClient,
+			"Timeout during receive operation", (int) ret);
+		break;
+	case LSCP_QUIT:
+		lscp_client_set_result(pClient,
+			"Server terminated the connection", (int) ret);
+		break;
+	default:
+		break;
+	}
+
+	// Free stream buffer, if any...
+	if (pszBuffer)
+		free(pszBuffer);
+
+	return ret;
+}
+
+// Pipelined requests, all of the same response kind.
+lscp_status_t lscp_client_call_batch ( lscp_client_t *pClient,
+	const char **ppszQueries, int iQueries, int iResult,
+	lscp_client_batch_proc_t pfnResult, void *pvData )
+{
+	return _lscp_client_call_batch(pClient, ppszQueries, iQueries,
+		iResult, NULL, pfnResult, pvData);
+}
+
+// Pipelined requests, of mixed single and multi-line response kinds.
+lscp_status_t lscp_client_call_mixed ( lscp_client_t *pClient,
+	const char **ppszQueries, int iQueries, const int *piResults,
+	lscp_client_batch_proc_t pfnResult, void *pvData )
+{
+	return _lscp_client_call_batch(pClient, ppszQueries, iQueries,
+		0, piResults, pfnResult, pvData);
+}
+
+
+//-------------------------------------------------------------------------
+// Pipelined mirror request helpers.
+
+// Allocate room for a given number of pipelined queries.
+int lscp_mirror_batch_init ( lscp_mirror_batch_t *pBatch, int iSize )
+{
+	pBatch->count = 0;
+	pBatch->size  = iSize;
+
+	if (iSize < 1)
+		iSize = 1;
+
+	pBatch->queries = (char *) malloc(iSize * LSCP_MIRROR_QUERY);
+	pBatch->ppszQueries = (const char **) malloc(iSize * sizeof(char *));
+	pBatch->targets = (void **) malloc(iSize * sizeof(void *));
+
+	if (pBatch->queries && pBatch->ppszQueries && pBatch->targets)
+		return 0;
+
+	pBatch->size = 0;
+	return -1;
+}
+
+void lscp_mirror_batch_free ( lscp_mirror_batch_t *pBatch )
+{
+	if (pBatch->queries)
+		free(pBatch->queries);
+	if (pBatch->ppszQueries)
+		free(pBatch->ppszQueries);
+	if (pBatch->targets)
+		free(pBatch->targets);
+}
+
+// Get the next query string slot, for a given target.
+char *lscp_mirror_batch_add ( lscp_mirror_batch_t *pBatch, void *pvTarget )
+{
+	char *pszQuery = pBatch->queries + pBatch->count * LSCP_MIRROR_QUERY;
+
+	pBatch->ppszQueries[pBatch->count] = pszQuery;
+	pBatch->targets[pBatch->count] = pvTarget;
+	pBatch->count++;
+
+	return pszQuery;
+}
+
+
 //-------------------------------------------------------------------------
 // Other general utility functions.
 
@@ -345,789 +701,5132 @@ void lscp_unquote_dup ( char **ppszDst, char **ppszSrc )
 }
 
 
-// Custom tokenizer.
-char *lscp_strtok ( char *pchBuffer, const char *pszSeps, char **ppch )
+// Unquote and intern an in-split string.
+void lscp_unquote_intern ( lscp_intern_pool_t *pPool, char **ppszDst, char **ppszSrc )
 {
-	char *pszToken;
+	// Release desteny string, if already there.
+	lscp_intern_release(*ppszDst);
+	*ppszDst = NULL;
+	// Unquote (in place) and intern.
+	if (*ppszSrc)
+		*ppszDst = lscp_intern(pPool, lscp_unquote(ppszSrc, 0));
+}
 
-	if (pchBuffer == NULL)
-		pchBuffer = *ppch;
 
-	pchBuffer += strspn(pchBuffer, pszSeps);
-	if (*pchBuffer == '\0')
-		return NULL;
+//-------------------------------------------------------------------------
+// Separator scanning helpers.
 
-	pszToken  = pchBuffer;
-	pchBuffer = strpbrk(pszToken, pszSeps);
-	if (pchBuffer == NULL) {
-		*ppch = strchr(pszToken, '\0');
-	} else {
-		*pchBuffer = '\0';
-		*ppch = pchBuffer + 1;
-		while (**ppch && strchr(pszSeps, **ppch))
-			(*ppch)++;
-	}
+// Maximum separator set size matched by the vectorized scanners;
+// larger sets (none in practice) fall back to strcspn().
+#define LSCP_SCAN_MAXSEPS   4
 
-	return pszToken;
-}
+// Scanner procedure prototype: returns a pointer to the first
+// separator character found, or to the string null terminator.
+typedef const char *(*lscp_scan_proc_t)(const char *psz, const char *pszSeps, int cchSeps);
 
 
-// Split a comma separated string into a null terminated array of strings.
-char **lscp_szsplit_create ( const char *pszCsv, const char *pszSeps )
+// Plain scalar scanner, our portable fallback.
+static const char *_lscp_scan_scalar ( const char *psz, const char *pszSeps, int cchSeps )
 {
-	char *pszHead, *pch;
-	int iSize, i, j, cchSeps;
-	char **ppszSplit, **ppszNewSplit;
-
-	// Initial size is one chunk away.
-	iSize = LSCP_SPLIT_CHUNK1;
-	// Allocate and split...
-	ppszSplit = (char **) malloc(iSize * sizeof(char *));
-	if (ppszSplit == NULL)
-		return NULL;
-
-	// Make a copy of the original string.
-	i = 0;
-	pszHead = (char *) pszCsv;
-	if ((ppszSplit[i++] = lscp_unquote(&pszHead, 1)) == NULL) {
-		free(ppszSplit);
-		return NULL;
-	}
+	int i;
 
-	// Go on for it...
-	cchSeps = strlen(pszSeps);
-	while ((pch = strpbrk(pszHead, pszSeps)) != NULL) {
-		// Pre-advance to next item.
-		pszHead = pch + cchSeps;
-		// Trim and null terminate current item.
-		while (isspace(*(pch - 1)) && pch > ppszSplit[0])
-			--pch;
-		*pch = (char) 0;
-		// Make it official.
-		ppszSplit[i] = lscp_unquote(&pszHead, 0);
-		// Do we need to grow?
-		if (++i >= iSize) {
-			// Yes, but only grow in chunks.
-			iSize += LSCP_SPLIT_CHUNK1;
-			// Allocate and copy to new split array.
-			ppszNewSplit = (char **) malloc(iSize * sizeof(char *));
-			if (ppszNewSplit) {
-				for (j = 0; j < i; j++)
-					ppszNewSplit[j] = ppszSplit[j];
-				free(ppszSplit);
-				ppszSplit = ppszNewSplit;
-			}
+	for ( ; *psz; ++psz) {
+		for (i = 0; i < cchSeps; ++i) {
+			if (*psz == pszSeps[i])
+				return psz;
 		}
 	}
 
-	// NULL terminate split array.
-	for ( ; i < iSize; i++)
-		ppszSplit[i] = NULL;
-
-	return ppszSplit;
+	return psz;
 }
 
 
-// Free allocated memory of a legal null terminated array of strings.
-void lscp_szsplit_destroy ( char **ppszSplit )
+#if defined(LSCP_SCAN_SSE2)
+
+// SSE2 scanner: 16 bytes per iteration, aligned loads only,
+// so that we never read across a page boundary past the end.
+LSCP_SCAN_NOASAN
+static const char *_lscp_scan_sse2 ( const char *psz, const char *pszSeps, int cchSeps )
 {
-	// Our split string is always the first item, if any.
-	if (ppszSplit && ppszSplit[0])
-		free(ppszSplit[0]);
-	// Now free the array itself.
-	if (ppszSplit)
-		free(ppszSplit);
+	const __m128i zero = _mm_setzero_si128();
+	__m128i seps[LSCP_SCAN_MAXSEPS];
+	const char *pch;
+	unsigned int mask;
+	__m128i v, m;
+	int i;
+
+	for (i = 0; i < cchSeps; ++i)
+		seps[i] = _mm_set1_epi8(pszSeps[i]);
+
+	pch = (const char *) ((uintptr_t) psz & ~(uintptr_t) 15);
+	v = _mm_load_si128((const __m128i *) pch);
+	m = _mm_cmpeq_epi8(v, zero);
+	for (i = 0; i < cchSeps; ++i)
+		m = _mm_or_si128(m, _mm_cmpeq_epi8(v, seps[i]));
+	mask = (unsigned int) _mm_movemask_epi8(m) >> (psz - pch);
+	if (mask)
+		return psz + __builtin_ctz(mask);
+
+	for (;;) {
+		pch += 16;
+		v = _mm_load_si128((const __m128i *) pch);
+		m = _mm_cmpeq_epi8(v, zero);
+		for (i = 0; i < cchSeps; ++i)
+			m = _mm_or_si128(m, _mm_cmpeq_epi8(v, seps[i]));
+		mask = (unsigned int) _mm_movemask_epi8(m);
+		if (mask)
+			return pch + __builtin_ctz(mask);
+	}
 }
 
+#endif	// LSCP_SCAN_SSE2
 
-#ifdef LSCP_SZSPLIT_COUNT
 
-// Return the number of items of a null terminated array of strings.
-int lscp_szsplit_count ( char **ppszSplit )
-{
-	int i = 0;
-	while (ppszSplit && ppszSplit[i])
-		i++;
-	return i;
-}
+#if defined(LSCP_SCAN_AVX2)
 
-// Return the allocated number of items of a splitted string array.
-int lscp_szsplit_size ( char **ppszSplit )
+// AVX2 scanner: 32 bytes per iteration, same aligned load rules.
+__attribute__((target("avx2"))) LSCP_SCAN_NOASAN
+static const char *_lscp_scan_avx2 ( const char *psz, const char *pszSeps, int cchSeps )
 {
-	return LSCP_SPLIT_SIZE(lscp_szsplit_count(ppszSplit));
+	const __m256i zero = _mm256_setzero_si256();
+	__m256i seps[LSCP_SCAN_MAXSEPS];
+	const char *pch;
+	unsigned int mask;
+	__m256i v, m;
+	int i;
+
+	for (i = 0; i < cchSeps; ++i)
+		seps[i] = _mm256_set1_epi8(pszSeps[i]);
+
+	pch = (const char *) ((uintptr_t) psz & ~(uintptr_t) 31);
+	v = _mm256_load_si256((const __m256i *) pch);
+	m = _mm256_cmpeq_epi8(v, zero);
+	for (i = 0; i < cchSeps; ++i)
+		m = _mm256_or_si256(m, _mm256_cmpeq_epi8(v, seps[i]));
+	mask = (unsigned int) _mm256_movemask_epi8(m) >> (psz - pch);
+	if (mask)
+		return psz + __builtin_ctz(mask);
+
+	for (;;) {
+		pch += 32;
+		v = _mm256_load_si256((const __m256i *) pch);
+		m = _mm256_cmpeq_epi8(v, zero);
+		for (i = 0; i < cchSeps; ++i)
+			m = _mm256_or_si256(m, _mm256_cmpeq_epi8(v, seps[i]));
+		mask = (unsigned int) _mm256_movemask_epi8(m);
+		if (mask)
+			return pch + __builtin_ctz(mask);
+	}
 }
 
-#endif // LSCP_SZSPLIT_COUNT
+#endif	// LSCP_SCAN_AVX2
 
 
-// Split a comma separated string into a -1 terminated array of positive integers.
-int *lscp_isplit_create ( const char *pszCsv, const char *pszSeps )
+// Runtime scanner selection, done once on first use
+// (benign race: every thread would pick the very same).
+static lscp_scan_proc_t _lscp_scan_proc = NULL;
+
+static lscp_scan_proc_t _lscp_scan_select (void)
 {
-	char *pchHead, *pch;
-	int iSize, i, j, cchSeps;
-	int *piSplit, *piNewSplit;
+	lscp_scan_proc_t pfnScan = _lscp_scan_scalar;
 
-	// Get it clean first.
-	pchHead = lscp_ltrim((char *) pszCsv);
-	if (*pchHead == (char) 0)
-		return NULL;
+#if defined(LSCP_SCAN_SSE2)
+	pfnScan = _lscp_scan_sse2;
+#endif
+#if defined(LSCP_SCAN_AVX2)
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx2"))
+		pfnScan = _lscp_scan_avx2;
+#endif
 
-	// Initial size is one chunk away.
-	iSize = LSCP_SPLIT_CHUNK1;
-	// Allocate and split...
-	piSplit = (int *) malloc(iSize * sizeof(int));
-	if (piSplit == NULL)
-		return NULL;
+	_lscp_scan_proc = pfnScan;
+	return pfnScan;
+}
 
-	// Make a copy of the original string.
-	i = 0;
-	if ((piSplit[i++] = atoi(pchHead)) < 0) {
-		free(piSplit);
-		return NULL;
-	}
 
-	// Go on for it...
-	cchSeps = strlen(pszSeps);
-	while ((pch = strpbrk(pchHead, pszSeps)) != NULL) {
-		// Pre-advance to next item.
-		pchHead = pch + cchSeps;
-		// Make it official.
-		piSplit[i] = atoi(pchHead);
-		// Do we need to grow?
-		if (++i >= iSize) {
-			// Yes, but only grow in chunks.
-			iSize += LSCP_SPLIT_CHUNK1;
-			// Allocate and copy to new split array.
-			piNewSplit = (int *) malloc(iSize * sizeof(int));
-			if (piNewSplit) {
-				for (j = 0; j < i; j++)
-					piNewSplit[j] = piSplit[j];
-				free(piSplit);
-				piSplit = piNewSplit;
-			}
-		}
-	}
+// Find the first separator character, or the null terminator.
+static const char *_lscp_scan ( const char *psz, const char *pszSeps )
+{
+	lscp_scan_proc_t pfnScan = _lscp_scan_proc;
+	int cchSeps = strlen(pszSeps);
 
-	// NULL terminate split array.
-	for ( ; i < iSize; i++)
-		piSplit[i] = -1;
+	if (cchSeps > LSCP_SCAN_MAXSEPS)
+		return psz + strcspn(psz, pszSeps);
 
-	return piSplit;
+	if (pfnScan == NULL)
+		pfnScan = _lscp_scan_select();
+
+	return (*pfnScan)(psz, pszSeps, cchSeps);
 }
 
 
-// Destroy a integer splitted array.
-void lscp_isplit_destroy ( int *piSplit )
+// Whether a character belongs to a (short) separator set.
+static int _lscp_is_sep ( char ch, const char *pszSeps )
 {
-	if (piSplit)
-		free(piSplit);
+	while (*pszSeps) {
+		if (ch == *pszSeps++)
+			return 1;
+	}
+	return 0;
 }
 
 
-#ifdef LSCP_ISPLIT_COUNT
-
-// Compute a string list valid item count.
-int lscp_isplit_count ( int *piSplit )
+// Vectorized strpbrk() substitute.
+char *lscp_strpbrk ( const char *psz, const char *pszSeps )
 {
-	int i = 0;
-	while (piSplit && piSplit[i] >= 0)
-		i++;
-	return i;
+	const char *pch = _lscp_scan(psz, pszSeps);
+	return (*pch ? (char *) pch : NULL);
 }
 
-// Compute a string list size.
-int lscp_isplit_size ( int *piSplit )
+// Fast strcspn() replacement: always returns a pointer to the first
+// separator found or else to the string terminating null.
+char *lscp_strscan ( const char *psz, const char *pszSeps )
 {
-	return LSCP_SPLIT_SIZE(lscp_isplit_count(piSplit));
+	return (char *) _lscp_scan(psz, pszSeps);
 }
 
-#endif // LSCP_ISPLIT_COUNT
-
 
-// Split a string into a null terminated array of parameter items.
-lscp_param_t *lscp_psplit_create ( const char *pszCsv, const char *pszSeps1, const char *pszSeps2 )
+// Custom tokenizer.
+char *lscp_strtok ( char *pchBuffer, const char *pszSeps, char **ppch )
 {
-	char *pszHead, *pch;
-	int iSize, i, j, cchSeps1, cchSeps2;
-	lscp_param_t *ppSplit, *ppNewSplit;
+	char *pszToken;
 
-	pszHead = strdup(pszCsv);
-	if (pszHead == NULL)
-		return NULL;
+	if (pchBuffer == NULL)
+		pchBuffer = *ppch;
 
-	iSize = LSCP_SPLIT_CHUNK1;
-	ppSplit = (lscp_param_t *) malloc(iSize * sizeof(lscp_param_t));
-	if (ppSplit == NULL) {
-		free(pszHead);
+	while (*pchBuffer && _lscp_is_sep(*pchBuffer, pszSeps))
+		++pchBuffer;
+	if (*pchBuffer == '\0')
 		return NULL;
-	}
 
-	cchSeps1 = strlen(pszSeps1);
-	cchSeps2 = strlen(pszSeps2);
-
-	i = 0;
-	while ((pch = strpbrk(pszHead, pszSeps1)) != NULL) {
+	pszToken  = pchBuffer;
+	pchBuffer = (char *) _lscp_scan(pszToken, pszSeps);
+	if (*pchBuffer == '\0') {
+		*ppch = pchBuffer;
+	} else {
+		*pchBuffer = '\0';
+		*ppch = pchBuffer + 1;
+		while (**ppch && _lscp_is_sep(**ppch, pszSeps))
+			(*ppch)++;
+	}
+
+	return pszToken;
+}
+
+
+// Fast locale-independent decimal integer parser (atoi replacement).
+int lscp_atoi ( const char *psz )
+{
+	unsigned int u = 0;
+	int neg = 0;
+
+	while (*psz == ' ' || (*psz >= '\t' && *psz <= '\r'))
+		psz++;
+
+	if (*psz == '-' || *psz == '+')
+		neg = (*psz++ == '-');
+
+	while ((unsigned int) (*psz - '0') < 10)
+		u = (u * 10) + (unsigned int) (*psz++ - '0');
+
+	return (neg ? -(int) u : (int) u);
+}
+
+
+// Exact powers of ten, as far as a double mantissa goes.
+static const double _lscp_pow10_tab[] = {
+	1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,
+	1e8,  1e9,  1e10, 1e11, 1e12, 1e13, 1e14, 1e15,
+	1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+// Scale a value by a power of ten (locale and libm free).
+static double _lscp_scale10 ( double d, int e )
+{
+	if (e < 0) {
+		while (e < -22) {
+			d /= 1e22;
+			e += 22;
+		}
+		return d / _lscp_pow10_tab[-e];
+	}
+
+	while (e > 22) {
+		d *= 1e22;
+		e -= 22;
+	}
+	return d * _lscp_pow10_tab[e];
+}
+
+
+// Exact product of two doubles, as an unevaluated sum (Dekker).
+static void _lscp_two_product ( double a, double b, double *pp, double *pe )
+{
+	const double c = 134217729.0; // 2^27 + 1
+	double ah, al, bh, bl, t;
+
+	t  = c * a;
+	ah = t - (t - a);
+	al = a - ah;
+	t  = c * b;
+	bh = t - (t - b);
+	bl = b - bh;
+
+	*pp = a * b;
+	*pe = ((ah * bh - *pp) + ah * bl + al * bh) + al * bl;
+}
+
+
+// Narrow a double, correctly rounded from m * 10^e (m < 2^53, |e| <= 22),
+// down to float, as if rounded just once from the exact decimal value:
+// it only makes a difference when the double hits a float halfway point.
+static float _lscp_atof_narrow ( double d, uint64_t m, int e )
+{
+	union { float f; uint32_t u; } x, y;
+	double p, r, P;
+
+	x.f = (float) d;
+	if ((double) x.f == d || x.f > FLT_MAX)
+		return x.f;
+
+	y.u = (d > (double) x.f ? x.u + 1 : x.u - 1);
+	if (((double) x.f + (double) y.f) * 0.5 != d)
+		return x.f;
+
+	// Which side of the halfway point is the exact value on?
+	P = _lscp_pow10_tab[e < 0 ? -e : e];
+	if (e < 0) {
+		_lscp_two_product(d, P, &p, &r);
+		r = ((double) m - p) - r;
+	}
+	else _lscp_two_product((double) m, P, &p, &r);
+
+	if (r == 0.0)
+		return x.f;
+
+	return ((r > 0.0) == (y.f > x.f) ? y.f : x.f);
+}
+
+
+// Fast locale-independent floating point parser (atof replacement):
+// always takes '.' as the decimal point, whatever the current locale.
+// Correctly rounded to float, as strtof() does, for up to 15 significant
+// digits within 22 decimal places; values with more digits, or tinier
+// or larger than that, may still be off by one unit in the last place.
+float lscp_atof ( const char *psz )
+{
+	uint64_t m = 0;
+	int nd = 0;
+	int e = 0;
+	int ex = 0;
+	int exneg = 0;
+	int neg = 0;
+	double d;
+	float f;
+
+	while (*psz == ' ' || (*psz >= '\t' && *psz <= '\r'))
+		psz++;
+
+	if (*psz == '-' || *psz == '+')
+		neg = (*psz++ == '-');
+
+	if (strncasecmp(psz, "inf", 3) == 0)
+		return (neg ? -HUGE_VALF : HUGE_VALF);
+	if (strncasecmp(psz, "nan", 3) == 0)
+		return NAN;
+
+	// Mantissa integer part (up to 19 significant digits)...
+	for ( ; (unsigned int) (*psz - '0') < 10; psz++) {
+		if (nd < 19) {
+			m = (m * 10) + (unsigned int) (*psz - '0');
+			if (m > 0)
+				nd++;
+		}
+		else e++;
+	}
+
+	// Mantissa fractional part...
+	if (*psz == '.') {
+		for (psz++; (unsigned int) (*psz - '0') < 10; psz++) {
+			if (nd < 19) {
+				m = (m * 10) + (unsigned int) (*psz - '0');
+				if (m > 0)
+					nd++;
+				e--;
+			}
+		}
+	}
+
+	// Exponent part, if any...
+	if ((*psz == 'e' || *psz == 'E')
+		&& ((unsigned int) (psz[1] - '0') < 10
+		|| ((psz[1] == '-' || psz[1] == '+')
+			&& (unsigned int) (psz[2] - '0') < 10))) {
+		psz++;
+		if (*psz == '-' || *psz == '+')
+			exneg = (*psz++ == '-');
+		for ( ; (unsigned int) (*psz - '0') < 10; psz++) {
+			if (ex < 10000)
+				ex = (ex * 10) + (*psz - '0');
+		}
+		e += (exneg ? -ex : ex);
+	}
+
+	if (m == 0)
+		return (neg ? -0.0f : 0.0f);
+
+	if (m < ((uint64_t) 1 << 53) && e >= -22 && e <= 22) {
+		f = _lscp_atof_narrow(_lscp_scale10((double) m, e), m, e);
+		return (neg ? -f : f);
+	}
+
+	d = (e < -340 ? 0.0 : _lscp_scale10((double) m, e));
+
+	return (float) (neg ? -d : d);
+}
+
+
+// Fast locale-independent floating point formatter (%g replacement):
+// writes the shortest decimal form that parses back to the very same
+// value; returns the formatted string length.
+int lscp_ftoa ( char *pszBuffer, int cchMaxBuffer, float f )
+{
+	char szTemp[32];
+	char achDigits[16];
+	uint64_t digits, limit;
+	double d;
+	int e10, x, p, n, i, k;
+
+	if (pszBuffer == NULL || cchMaxBuffer < 1)
+		return 0;
+
+	k = 0;
+
+	if (f != f) {
+		strcpy(szTemp, "nan");
+		k = 3;
+	}
+	else
+	if (f == 0.0f) {
+		szTemp[k++] = '0';
+	}
+	else {
+		d = (double) f;
+		if (d < 0.0) {
+			szTemp[k++] = '-';
+			d = -d;
+		}
+		if (d > FLT_MAX) {
+			strcpy(szTemp + k, "inf");
+			k += 3;
+		}
+		else {
+			// Find the decimal exponent of the leading digit.
+			e10 = 0;
+			while (_lscp_scale10(1.0, e10 + 1) <= d)
+				e10++;
+			while (_lscp_scale10(1.0, e10) > d)
+				e10--;
+			// Find the least number of significant digits that round-trips...
+			digits = 0;
+			x = e10;
+			for (p = 1; p <= 9; p++) {
+				limit = (uint64_t) _lscp_pow10_tab[p];
+				digits = (uint64_t) (_lscp_scale10(d, p - 1 - e10) + 0.5);
+				x = e10;
+				if (digits >= limit) {
+					digits /= 10;
+					x++;
+				}
+				if ((float) _lscp_scale10((double) digits, x - p + 1) == (float) d)
+					break;
+			}
+			if (p > 9)
+				p = 9;
+			// Render the digits, stripping trailing zeros...
+			for (i = p - 1; i >= 0; i--) {
+				achDigits[i] = (char) ('0' + (digits % 10));
+				digits /= 10;
+			}
+			n = p;
+			while (n > 1 && achDigits[n - 1] == '0')
+				n--;
+			// Plain or scientific notation, as %g does.
+			if (x >= -5 && x < 9) {
+				if (x < 0) {
+					szTemp[k++] = '0';
+					szTemp[k++] = '.';
+					for (i = -1; i > x; i--)
+						szTemp[k++] = '0';
+					for (i = 0; i < n; i++)
+						szTemp[k++] = achDigits[i];
+				} else {
+					for (i = 0; i <= x; i++)
+						szTemp[k++] = (i < n ? achDigits[i] : '0');
+					if (n > x + 1) {
+						szTemp[k++] = '.';
+						for ( ; i < n; i++)
+							szTemp[k++] = achDigits[i];
+					}
+				}
+			} else {
+				szTemp[k++] = achDigits[0];
+				if (n > 1) {
+					szTemp[k++] = '.';
+					for (i = 1; i < n; i++)
+						szTemp[k++] = achDigits[i];
+				}
+				szTemp[k++] = 'e';
+				szTemp[k++] = (x < 0 ? '-' : '+');
+				if (x < 0)
+					x = -x;
+				if (x >= 100)
+					szTemp[k++] = (char) ('0' + (x / 100));
+				szTemp[k++] = (char) ('0' + ((x / 10) % 10));
+				szTemp[k++] = (char) ('0' + (x % 10));
+			}
+		}
+	}
+
+	if (k >= cchMaxBuffer)
+		k = cchMaxBuffer - 1;
+	memcpy(pszBuffer, szTemp, k);
+	pszBuffer[k] = (char) 0;
+
+	return k;
+}
+
+
+// Count all separator chars ahead, as an upper bound for
+// the number of items to split (one single allocation is due).
+static int _lscp_split_count ( const char *psz, const char *pszSeps )
+{
+	const char *pch;
+	int iCount = 0;
+
+	while ((pch = lscp_strpbrk(psz, pszSeps)) != NULL) {
+		++iCount;
+		psz = pch + 1;
+	}
+
+	return iCount;
+}
+
+
+// Split a comma separated string into a null terminated array of strings.
+char **lscp_szsplit_create ( const char *pszCsv, const char *pszSeps )
+{
+	char *pszHead, *pch;
+	int iSize, i, cchSeps;
+	char **ppszSplit;
+
+	// Pre-count items and allocate just once (plus terminator).
+	cchSeps = strlen(pszSeps);
+	iSize = _lscp_split_count(pszCsv, pszSeps) + 2;
+	// Allocate and split...
+	ppszSplit = (char **) malloc(iSize * sizeof(char *));
+	if (ppszSplit == NULL)
+		return NULL;
+
+	// Make a copy of the original string.
+	i = 0;
+	pszHead = (char *) pszCsv;
+	if ((ppszSplit[i++] = lscp_unquote(&pszHead, 1)) == NULL) {
+		free(ppszSplit);
+		return NULL;
+	}
+
+	// Go on for it...
+	while (i < iSize - 1 && (pch = lscp_strpbrk(pszHead, pszSeps)) != NULL) {
+		// Pre-advance to next item.
+		pszHead = pch + cchSeps;
+		// Trim and null terminate current item.
+		while (isspace(*(pch - 1)) && pch > ppszSplit[0])
+			--pch;
+		*pch = (char) 0;
+		// Make it official.
+		ppszSplit[i++] = lscp_unquote(&pszHead, 0);
+	}
+
+	// NULL terminate split array.
+	for ( ; i < iSize; i++)
+		ppszSplit[i] = NULL;
+
+	return ppszSplit;
+}
+
+
+// Free allocated memory of a legal null terminated array of strings.
+void lscp_szsplit_destroy ( char **ppszSplit )
+{
+	// Our split string is always the first item, if any.
+	if (ppszSplit && ppszSplit[0])
+		free(ppszSplit[0]);
+	// Now free the array itself.
+	if (ppszSplit)
+		free(ppszSplit);
+}
+
+
+#ifdef LSCP_SZSPLIT_COUNT
+
+// Return the number of items of a null terminated array of strings.
+int lscp_szsplit_count ( char **ppszSplit )
+{
+	int i = 0;
+	while (ppszSplit && ppszSplit[i])
+		i++;
+	return i;
+}
+
+// Return the (minimum) allocated number of items of a splitted string array.
+int lscp_szsplit_size ( char **ppszSplit )
+{
+	return lscp_szsplit_count(ppszSplit) + 1;
+}
+
+#endif // LSCP_SZSPLIT_COUNT
+
+
+// Split a comma separated string into a -1 terminated array of positive integers.
+int *lscp_isplit_create ( const char *pszCsv, const char *pszSeps )
+{
+	char *pchHead, *pch;
+	int iSize, i, cchSeps;
+	int *piSplit;
+
+	// Get it clean first.
+	pchHead = lscp_ltrim((char *) pszCsv);
+	if (*pchHead == (char) 0)
+		return NULL;
+
+	// Pre-count items and allocate just once (plus terminator).
+	cchSeps = strlen(pszSeps);
+	iSize = _lscp_split_count(pchHead, pszSeps) + 2;
+	// Allocate and split...
+	piSplit = (int *) malloc(iSize * sizeof(int));
+	if (piSplit == NULL)
+		return NULL;
+
+	// Make a copy of the original string.
+	i = 0;
+	if ((piSplit[i++] = lscp_atoi(pchHead)) < 0) {
+		free(piSplit);
+		return NULL;
+	}
+
+	// Go on for it...
+	while (i < iSize - 1 && (pch = lscp_strpbrk(pchHead, pszSeps)) != NULL) {
+		// Pre-advance to next item.
+		pchHead = pch + cchSeps;
+		// Make it official.
+		piSplit[i++] = lscp_atoi(pchHead);
+	}
+
+	// NULL terminate split array.
+	for ( ; i < iSize; i++)
+		piSplit[i] = -1;
+
+	return piSplit;
+}
+
+
+// Destroy a integer splitted array.
+void lscp_isplit_destroy ( int *piSplit )
+{
+	if (piSplit)
+		free(piSplit);
+}
+
+
+#ifdef LSCP_ISPLIT_COUNT
+
+// Compute a string list valid item count.
+int lscp_isplit_count ( int *piSplit )
+{
+	int i = 0;
+	while (piSplit && piSplit[i] >= 0)
+		i++;
+	return i;
+}
+
+// Compute a string list (minimum) size.
+int lscp_isplit_size ( int *piSplit )
+{
+	return lscp_isplit_count(piSplit) + 1;
+}
+
+#endif // LSCP_ISPLIT_COUNT
+
+
+// Split a string into a null terminated array of parameter items.
+lscp_param_t *lscp_psplit_create ( const char *pszCsv, const char *pszSeps1, const char *pszSeps2 )
+{
+	char *pszHead, *pch;
+	int iSize, i, cchSeps1, cchSeps2;
+	lscp_param_t *ppSplit;
+
+	cchSeps1 = strlen(pszSeps1);
+	cchSeps2 = strlen(pszSeps2);
+
+	// Pre-count items and allocate just once (plus terminator).
+	iSize = _lscp_split_count(pszCsv, pszSeps1) + 1;
+	ppSplit = (lscp_param_t *) malloc(iSize * sizeof(lscp_param_t));
+	if (ppSplit == NULL)
+		return NULL;
+
+	pszHead = strdup(pszCsv);
+	if (pszHead == NULL) {
+		free(ppSplit);
+		return NULL;
+	}
+
+	i = 0;
+	while (i < iSize - 1 && (pch = lscp_strpbrk(pszHead, pszSeps1)) != NULL) {
 		ppSplit[i].key = pszHead;
 		pszHead = pch + cchSeps1;
 		*pch = (char) 0;
 		ppSplit[i].value = lscp_unquote(&pszHead, 0);
-		if ((pch = strpbrk(pszHead, pszSeps2)) != NULL) {
+		if ((pch = lscp_strpbrk(pszHead, pszSeps2)) != NULL) {
 			pszHead = pch + cchSeps2;
 			*pch = (char) 0;
 		}
-		if (++i >= iSize) {
-			iSize += LSCP_SPLIT_CHUNK1;
-			ppNewSplit = (lscp_param_t *) malloc(iSize * sizeof(lscp_param_t));
-			if (ppNewSplit) {
-				for (j = 0; j < i; j++) {
-					ppNewSplit[j].key   = ppSplit[j].key;
-					ppNewSplit[j].value = ppSplit[j].value;
-				}
-				free(ppSplit);
-				ppSplit = ppNewSplit;
+		++i;
+	}
+
+	if (i < 1)
+		free(pszHead);
+
+	for ( ; i < iSize; i++) {
+		ppSplit[i].key   = NULL;
+		ppSplit[i].value = NULL;
+	}
+
+	return ppSplit;
+}
+
+
+// Destroy a parameter list array.
+void lscp_psplit_destroy ( lscp_param_t *ppSplit )
+{
+	if (ppSplit && ppSplit[0].key)
+		free(ppSplit[0].key);
+	if (ppSplit)
+		free(ppSplit);
+}
+
+
+#ifdef LSCP_PSPLIT_COUNT
+
+// Compute a parameter list valid item count.
+int lscp_psplit_count ( lscp_param_t *ppSplit )
+{
+	int i = 0;
+	while (ppSplit && ppSplit[i].key)
+		i++;
+	return i;
+}
+
+// Compute a parameter list (minimum) size.
+int lscp_psplit_size ( lscp_param_t *ppSplit )
+{
+	return lscp_psplit_count(ppSplit) + 1;
+}
+
+#endif // LSCP_PSPLIT_COUNT
+
+
+//-------------------------------------------------------------------------
+// Event notification data decoder.
+
+// Parse next unsigned integer field, if any (-1 otherwise).
+static int _lscp_event_int ( const char **ppch, const char *pchEnd )
+{
+	const char *pch = *ppch;
+	int iValue = -1;
+
+	while (pch < pchEnd && (*pch == ' ' || *pch == '\t'))
+		pch++;
+
+	if (pch < pchEnd && (unsigned int) (*pch - '0') < 10) {
+		iValue = 0;
+		while (pch < pchEnd && (unsigned int) (*pch - '0') < 10)
+			iValue = (iValue * 10) + (*pch++ - '0');
+	}
+
+	*ppch = pch;
+	return iValue;
+}
+
+
+// Parse a MIDI event message: <type> <data1> <data2>
+static void _lscp_event_midi ( unsigned char *pMidi,
+	const char *pch, const char *pchEnd )
+{
+	const char *pszType;
+	int cchType, iData1, iData2;
+
+	while (pch < pchEnd && (*pch == ' ' || *pch == '\t'))
+		pch++;
+	pszType = pch;
+	while (pch < pchEnd && *pch != ' ' && *pch != '\t')
+		pch++;
+	cchType = (int) (pch - pszType);
+
+	if (cchType == 7 && strncasecmp(pszType, "NOTE_ON", 7) == 0)
+		pMidi[0] = 0x90;
+	else
+	if (cchType == 8 && strncasecmp(pszType, "NOTE_OFF", 8) == 0)
+		pMidi[0] = 0x80;
+	else
+	if (cchType == 2 && strncasecmp(pszType, "CC", 2) == 0)
+		pMidi[0] = 0xb0;
+
+	iData1 = _lscp_event_int(&pch, pchEnd);
+	iData2 = _lscp_event_int(&pch, pchEnd);
+
+	pMidi[1] = (unsigned char) (iData1 < 0 ? 0 : (iData1 & 0x7f));
+	pMidi[2] = (unsigned char) (iData2 < 0 ? 0 : (iData2 & 0x7f));
+}
+
+
+// Parse buffer fill data: [<stream-id>]<usage>[%],... into growable
+// storage (owned and reused by the caller), always terminated by an
+// extra LSCP_BUFFER_FILL_END stream entry; returns the number of
+// entries (excluding the terminator), or -1 on failure.
+int lscp_buffer_fill_parse ( const char *pch, const char *pchEnd,
+	lscp_buffer_fill_t **ppFill, int *piFillSize, int *piPercentage )
+{
+	lscp_buffer_fill_t *pFill;
+	const char *pchItem;
+	int iSize, iStream, iUsage, i;
+
+	// Count entries, growing storage as needed...
+	iSize = 1;
+	for (pchItem = pch; pchItem < pchEnd; pchItem++) {
+		if (*pchItem == '[')
+			iSize++;
+	}
+	if (iSize > *piFillSize) {
+		pFill = (lscp_buffer_fill_t *) realloc(*ppFill,
+			iSize * sizeof(lscp_buffer_fill_t));
+		if (pFill == NULL)
+			return -1;
+		*ppFill = pFill;
+		*piFillSize = iSize;
+	}
+
+	i = 0;
+	pFill = *ppFill;
+	while (i < iSize - 1 && pch < pchEnd) {
+		while (pch < pchEnd && *pch != '[')
+			pch++;
+		if (pch >= pchEnd)
+			break;
+		pch++;
+		iStream = _lscp_event_int(&pch, pchEnd);
+		if (pch < pchEnd && *pch == ']')
+			pch++;
+		iUsage = _lscp_event_int(&pch, pchEnd);
+		if (pch < pchEnd && *pch == '%' && piPercentage)
+			*piPercentage = 1;
+		pFill[i].stream_id    = (unsigned int) iStream;
+		pFill[i].stream_usage = (unsigned long) (iUsage < 0 ? 0 : iUsage);
+		i++;
+	}
+
+	pFill[i].stream_id    = LSCP_BUFFER_FILL_END;
+	pFill[i].stream_usage = 0;
+
+	return i;
+}
+
+
+// Parse buffer fill event data.
+static int _lscp_event_fill ( lscp_event_data_t *pEventData,
+	const char *pch, const char *pchEnd,
+	lscp_buffer_fill_t **ppFill, int *piFillSize )
+{
+	int iCount;
+
+	iCount = lscp_buffer_fill_parse(pch, pchEnd, ppFill, piFillSize,
+		&(pEventData->fill_percentage));
+	if (iCount < 0)
+		return -1;
+
+	pEventData->fill = *ppFill;
+	pEventData->fill_count = iCount;
+
+	return 0;
+}
+
+
+// Decode an event notification data into its typed structure;
+// buffer fill entries storage is owned (and reused) by the caller.
+int lscp_event_data_decode ( lscp_event_data_t *pEventData, lscp_event_t event,
+	const char *pchData, int cchData, lscp_buffer_fill_t **ppFill, int *piFillSize )
+{
+	const char *pch, *pchEnd;
+
+	pEventData->event = event;
+	pEventData->channel = -1;
+	pEventData->device = -1;
+	pEventData->port = -1;
+	pEventData->count = -1;
+	pEventData->map = -1;
+	pEventData->bank = -1;
+	pEventData->prog = -1;
+	pEventData->midi[0] = 0;
+	pEventData->midi[1] = 0;
+	pEventData->midi[2] = 0;
+	pEventData->fill_count = 0;
+	pEventData->fill_percentage = 0;
+	pEventData->fill = NULL;
+	pEventData->text = (pchData ? pchData : "");
+	pEventData->text_len = (pchData ? cchData : 0);
+
+	pch = pEventData->text;
+	pchEnd = pch + pEventData->text_len;
+
+	switch (event) {
+	case LSCP_EVENT_CHANNEL_COUNT:
+	case LSCP_EVENT_TOTAL_VOICE_COUNT:
+	case LSCP_EVENT_AUDIO_OUTPUT_DEVICE_COUNT:
+	case LSCP_EVENT_MIDI_INPUT_DEVICE_COUNT:
+	case LSCP_EVENT_MIDI_INSTRUMENT_MAP_COUNT:
+		pEventData->count = _lscp_event_int(&pch, pchEnd);
+		break;
+	case LSCP_EVENT_VOICE_COUNT:
+	case LSCP_EVENT_STREAM_COUNT:
+		pEventData->channel = _lscp_event_int(&pch, pchEnd);
+		pEventData->count = _lscp_event_int(&pch, pchEnd);
+		break;
+	case LSCP_EVENT_BUFFER_FILL:
+		pEventData->channel = _lscp_event_int(&pch, pchEnd);
+		return _lscp_event_fill(pEventData, pch, pchEnd, ppFill, piFillSize);
+	case LSCP_EVENT_CHANNEL_INFO:
+		pEventData->channel = _lscp_event_int(&pch, pchEnd);
+		break;
+	case LSCP_EVENT_AUDIO_OUTPUT_DEVICE_INFO:
+	case LSCP_EVENT_MIDI_INPUT_DEVICE_INFO:
+		pEventData->device = _lscp_event_int(&pch, pchEnd);
+		break;
+	case LSCP_EVENT_MIDI_INSTRUMENT_MAP_INFO:
+		pEventData->map = _lscp_event_int(&pch, pchEnd);
+		break;
+	case LSCP_EVENT_MIDI_INSTRUMENT_COUNT:
+		pEventData->map = _lscp_event_int(&pch, pchEnd);
+		pEventData->count = _lscp_event_int(&pch, pchEnd);
+		break;
+	case LSCP_EVENT_MIDI_INSTRUMENT_INFO:
+		pEventData->map = _lscp_event_int(&pch, pchEnd);
+		pEventData->bank = _lscp_event_int(&pch, pchEnd);
+		pEventData->prog = _lscp_event_int(&pch, pchEnd);
+		break;
+	case LSCP_EVENT_CHANNEL_MIDI:
+		pEventData->channel = _lscp_event_int(&pch, pchEnd);
+		_lscp_event_midi(pEventData->midi, pch, pchEnd);
+		break;
+	case LSCP_EVENT_DEVICE_MIDI:
+		pEventData->device = _lscp_event_int(&pch, pchEnd);
+		pEventData->port = _lscp_event_int(&pch, pchEnd);
+		_lscp_event_midi(pEventData->midi, pch, pchEnd);
+		break;
+	case LSCP_EVENT_MISCELLANEOUS:
+	case LSCP_EVENT_NONE:
+	default:
+		break;
+	}
+
+	return 0;
+}
+
+
+// Decode a whole CHANNEL_MIDI or DEVICE_MIDI notification line straight
+// into a compact record (as sent by the server, in upper case); returns
+// the event, or none if it's not one of those.
+lscp_event_t lscp_midi_event_decode ( lscp_midi_event_t *pMidiEvent,
+	const char *pszLine )
+{
+	const char *pch, *pchEnd;
+
+	if (strncmp(pszLine, "NOTIFY:", 7) != 0)
+		return LSCP_EVENT_NONE;
+
+	pch = pszLine + 7;
+	if (strncmp(pch, "CHANNEL_MIDI:", 13) == 0) {
+		pch += 13;
+		pchEnd = pch + strlen(pch);
+		pMidiEvent->event   = LSCP_EVENT_CHANNEL_MIDI;
+		pMidiEvent->channel = _lscp_event_int(&pch, pchEnd);
+		pMidiEvent->device  = -1;
+		pMidiEvent->port    = -1;
+	}
+	else
+	if (strncmp(pch, "DEVICE_MIDI:", 12) == 0) {
+		pch += 12;
+		pchEnd = pch + strlen(pch);
+		pMidiEvent->event   = LSCP_EVENT_DEVICE_MIDI;
+		pMidiEvent->channel = -1;
+		pMidiEvent->device  = _lscp_event_int(&pch, pchEnd);
+		pMidiEvent->port    = _lscp_event_int(&pch, pchEnd);
+	}
+	else return LSCP_EVENT_NONE;
+
+	pMidiEvent->midi[0] = 0;
+	_lscp_event_midi(pMidiEvent->midi, pch, pchEnd);
+
+	return pMidiEvent->event;
+}
+
+
+//-------------------------------------------------------------------------
+// Generic hash table (open addressing, 64bit integer keys).
+
+// Integer key mixer (splitmix64 finalizer).
+static unsigned int _lscp_hash_mix ( int64_t key )
+{
+	uint64_t h = (uint64_t) key;
+
+	h ^= (h >> 30);
+	h *= 0xbf58476d1ce4e5b9ULL;
+	h ^= (h >> 27);
+	h *= 0x94d049bb133111ebULL;
+	h ^= (h >> 31);
+
+	return (unsigned int) h;
+}
+
+
+// Initialize an empty hash table.
+void lscp_hash_init ( lscp_hash_t *pHash )
+{
+	pHash->keys   = NULL;
+	pHash->values = NULL;
+	pHash->size   = 0;
+	pHash->count  = 0;
+}
+
+
+// Free all hash table storage (values are not owned).
+void lscp_hash_free ( lscp_hash_t *pHash )
+{
+	if (pHash->keys)
+		free(pHash->keys);
+	if (pHash->values)
+		free(pHash->values);
+
+	lscp_hash_init(pHash);
+}
+
+
+// Find the value for a given key; NULL if not found.
+void *lscp_hash_find ( lscp_hash_t *pHash, int64_t key )
+{
+	unsigned int mask, i;
+
+	if (pHash->count < 1)
+		return NULL;
+
+	mask = (unsigned int) pHash->size - 1;
+	for (i = _lscp_hash_mix(key) & mask; pHash->values[i]; i = (i + 1) & mask) {
+		if (pHash->keys[i] == key)
+			return pHash->values[i];
+	}
+
+	return NULL;
+}
+
+
+// Resize hash table storage, rehashing all current entries.
+static int _lscp_hash_resize ( lscp_hash_t *pHash, int iNewSize )
+{
+	int64_t *pNewKeys;
+	void   **ppNewValues;
+	unsigned int mask, i, j;
+
+	pNewKeys = (int64_t *) malloc(iNewSize * sizeof(int64_t));
+	if (pNewKeys == NULL)
+		return -1;
+	ppNewValues = (void **) calloc(iNewSize, sizeof(void *));
+	if (ppNewValues == NULL) {
+		free(pNewKeys);
+		return -1;
+	}
+
+	mask = (unsigned int) iNewSize - 1;
+	for (j = 0; j < (unsigned int) pHash->size; j++) {
+		if (pHash->values[j] == NULL)
+			continue;
+		i = _lscp_hash_mix(pHash->keys[j]) & mask;
+		while (ppNewValues[i])
+			i = (i + 1) & mask;
+		pNewKeys[i] = pHash->keys[j];
+		ppNewValues[i] = pHash->values[j];
+	}
+
+	if (pHash->keys)
+		free(pHash->keys);
+	if (pHash->values)
+		free(pHash->values);
+
+	pHash->keys   = pNewKeys;
+	pHash->values = ppNewValues;
+	pHash->size   = iNewSize;
+
+	return 0;
+}
+
+
+// Insert or replace a (non-NULL) value for a given key.
+int lscp_hash_insert ( lscp_hash_t *pHash, int64_t key, void *pvValue )
+{
+	unsigned int mask, i;
+
+	if (pvValue == NULL)
+		return -1;
+
+	// Keep load factor under 3/4...
+	if ((pHash->count + 1) * 4 > pHash->size * 3) {
+		if (_lscp_hash_resize(pHash, pHash->size > 0 ? pHash->size << 1 : 16) < 0)
+			return -1;
+	}
+
+	mask = (unsigned int) pHash->size - 1;
+	for (i = _lscp_hash_mix(key) & mask; pHash->values[i]; i = (i + 1) & mask) {
+		if (pHash->keys[i] == key) {
+			pHash->values[i] = pvValue;
+			return 0;
+		}
+	}
+
+	pHash->keys[i] = key;
+	pHash->values[i] = pvValue;
+	pHash->count++;
+
+	return 0;
+}
+
+
+// Remove a key, returning its former value, if any.
+void *lscp_hash_remove ( lscp_hash_t *pHash, int64_t key )
+{
+	unsigned int mask, i, j, k;
+	void *pvValue;
+
+	if (pHash->count < 1)
+		return NULL;
+
+	mask = (unsigned int) pHash->size - 1;
+	for (i = _lscp_hash_mix(key) & mask; pHash->values[i]; i = (i + 1) & mask) {
+		if (pHash->keys[i] == key)
+			break;
+	}
+
+	pvValue = pHash->values[i];
+	if (pvValue == NULL)
+		return NULL;
+
+	// Backward shift deletion (no tombstones)...
+	for (j = (i + 1) & mask; pHash->values[j]; j = (j + 1) & mask) {
+		k = _lscp_hash_mix(pHash->keys[j]) & mask;
+		if (((j - k) & mask) >= ((j - i) & mask)) {
+			pHash->keys[i] = pHash->keys[j];
+			pHash->values[i] = pHash->values[j];
+			i = j;
+		}
+	}
+
+	pHash->values[i] = NULL;
+	pHash->count--;
+
+	return pvValue;
+}
+
+
+//-------------------------------------------------------------------------
+// Hashed parameter list index.
+//
+// Parameter lists keep their plain null terminated lscp_param_t array
+// layout; a case-insensitive key index is kept right in front of it,
+// in the same allocation, so that lookups and appends take constant
+// time. Only lists made by lscp_plist_alloc have one.
+
+typedef struct _lscp_plist_index_t
+{
+	int  count;     // Number of valid items in array.
+	int  mask;      // Number of index slots minus one.
+	int *slots;     // Item index plus one; NULL if not indexed.
+
+} lscp_plist_index_t;
+
+// Parameter list allocation header (keeps the array aligned).
+typedef union _lscp_plist_head_t
+{
+	lscp_plist_index_t index;
+	lscp_param_t       align;
+
+} lscp_plist_head_t;
+
+// The index of a list made by lscp_plist_alloc.
+#define _lscp_plist_index(p) \
+	(&((((lscp_plist_head_t *) (p)) - 1)->index))
+
+// All the lists made by lscp_plist_alloc and still around, so these
+// can be told apart from any other (caller built) ones without peeking
+// in front of the latter; guarded by a plain spin lock.
+static lscp_hash_t _lscp_plist_lists = { NULL, NULL, 0, 0 };
+static volatile long _lscp_plist_spin = 0;
+
+
+// Keep track of a list made by lscp_plist_alloc, or forget about it.
+static void _lscp_plist_register ( lscp_param_t *pParams, int iRegister )
+{
+	const int64_t key = (int64_t) (intptr_t) pParams;
+
+	while (_lscp_atomic_xchg(&_lscp_plist_spin, 1))
+		;
+
+	if (iRegister)
+		lscp_hash_insert(&_lscp_plist_lists, key, _lscp_plist_index(pParams));
+	else
+	if (lscp_hash_remove(&_lscp_plist_lists, key) && _lscp_plist_lists.count < 1)
+		lscp_hash_free(&_lscp_plist_lists);
+
+	_lscp_atomic_barrier();
+	_lscp_plist_spin = 0;
+}
+
+
+// Whether it's a list made by lscp_plist_alloc (key indexed).
+int lscp_plist_indexed ( lscp_param_t *pParams )
+{
+	int iIndexed;
+
+	if (pParams == NULL)
+		return 0;
+
+	while (_lscp_atomic_xchg(&_lscp_plist_spin, 1))
+		;
+
+	iIndexed = (lscp_hash_find(&_lscp_plist_lists,
+		(int64_t) (intptr_t) pParams) != NULL);
+
+	_lscp_atomic_barrier();
+	_lscp_plist_spin = 0;
+
+	return iIndexed;
+}
+
+
+// Case-insensitive key hash (FNV-1a).
+static unsigned int _lscp_plist_hash ( const char *pszKey )
+{
+	unsigned int h = 2166136261U;
+
+	while (*pszKey)
+		h = (h ^ (unsigned char) tolower(*pszKey++)) * 16777619U;
+
+	return h;
+}
+
+
+// Find an item index in the array, -1 if not found.
+static int _lscp_plist_index_find ( lscp_plist_index_t *pIndex,
+	lscp_param_t *pParams, const char *pszKey )
+{
+	unsigned int i;
+	int k;
+
+	if (pIndex->slots == NULL) {
+		for (k = 0; pParams[k].key; k++) {
+			if (strcasecmp(pParams[k].key, pszKey) == 0)
+				return k;
+		}
+		return -1;
+	}
+
+	for (i = _lscp_plist_hash(pszKey) & pIndex->mask;
+			(k = pIndex->slots[i]) > 0; i = (i + 1) & pIndex->mask) {
+		if (strcasecmp(pParams[k - 1].key, pszKey) == 0)
+			return k - 1;
+	}
+
+	return -1;
+}
+
+
+// (Re)build the key index slots for the current array contents;
+// out of memory, it's left unindexed (linear lookups).
+static void _lscp_plist_index_build ( lscp_plist_index_t *pIndex,
+	lscp_param_t *pParams, int iSlots )
+{
+	unsigned int i;
+	int k;
+
+	if (pIndex->slots)
+		free(pIndex->slots);
+
+	pIndex->slots = (int *) calloc(iSlots, sizeof(int));
+	pIndex->mask  = iSlots - 1;
+	if (pIndex->slots == NULL)
+		return;
+
+	for (k = 0; k < pIndex->count; k++) {
+		i = _lscp_plist_hash(pParams[k].key) & pIndex->mask;
+		while (pIndex->slots[i])
+			i = (i + 1) & pIndex->mask;
+		pIndex->slots[i] = k + 1;
+	}
+}
+
+
+// Allocate a parameter list, optionally copying an existing one.
+void lscp_plist_alloc (lscp_param_t **ppList)
+{
+	lscp_plist_head_t *pHead;
+	lscp_param_t *pParams = NULL;
+	int iSize, i;
+
+	if (ppList) {
+		iSize = _lscp_split_size(0);
+		pHead = (lscp_plist_head_t *) malloc(
+			sizeof(lscp_plist_head_t) + iSize * sizeof(lscp_param_t));
+		if (pHead) {
+			pParams = (lscp_param_t *) (pHead + 1);
+			for (i = 0 ; i < iSize; i++) {
+				pParams[i].key   = NULL;
+				pParams[i].value = NULL;
+			}
+			// Its own key index...
+			pHead->index.count = 0;
+			pHead->index.mask  = 0;
+			pHead->index.slots = NULL;
+			_lscp_plist_index_build(&(pHead->index), pParams, 2 * iSize);
+			_lscp_plist_register(pParams, 1);
+		}
+		*ppList = pParams;
+	}
+}
+
+
+// Destroy a parameter list, including all it's contents.
+void lscp_plist_free ( lscp_param_t **ppList )
+{
+	lscp_param_t *pParams;
+	lscp_plist_index_t *pIndex;
+	int i;
+
+	if (ppList) {
+		if (*ppList) {
+			pParams = *ppList;
+			_lscp_plist_register(pParams, 0);
+			pIndex = _lscp_plist_index(pParams);
+			if (pIndex->slots)
+				free(pIndex->slots);
+			for (i = 0; pParams[i].key; i++) {
+				free(pParams[i].key);
+				free(pParams[i].value);
+			}
+			free(((lscp_plist_head_t *) pParams) - 1);
+		}
+		*ppList = NULL;
+	}
+}
+
+
+// Add an item to a parameter list, growing it as fit.
+void lscp_plist_append ( lscp_param_t **ppList, const char *pszKey, const char *pszValue )
+{
+	lscp_param_t *pParams;
+	lscp_plist_head_t *pNewHead;
+	lscp_plist_index_t *pIndex;
+	int iSize, iNewSize;
+	unsigned int j;
+	int i;
+
+	if (ppList && *ppList) {
+		pParams = *ppList;
+		pIndex = _lscp_plist_index(pParams);
+		i = _lscp_plist_index_find(pIndex, pParams, pszKey);
+		if (i >= 0) {
+			if (pParams[i].value)
+				free(pParams[i].value);
+			pParams[i].value = strdup(pszValue);
+			return;
+		}
+		i = pIndex->count;
+		// Grow geometrically, keeping room for the terminator.
+		iSize = _lscp_split_size(i);
+		if (i + 1 >= iSize) {
+			iNewSize = _lscp_split_size(i + 1);
+			_lscp_plist_register(pParams, 0);
+			pNewHead = (lscp_plist_head_t *) realloc(
+				((lscp_plist_head_t *) pParams) - 1,
+				sizeof(lscp_plist_head_t) + iNewSize * sizeof(lscp_param_t));
+			if (pNewHead == NULL) {
+				_lscp_plist_register(pParams, 1);
+				return;
+			}
+			*ppList = pParams = (lscp_param_t *) (pNewHead + 1);
+			_lscp_plist_register(pParams, 1);
+			pIndex = &(pNewHead->index);
+			for (iSize = i; iSize < iNewSize; iSize++) {
+				pParams[iSize].key   = NULL;
+				pParams[iSize].value = NULL;
+			}
+		}
+		pParams[i].key   = strdup(pszKey);
+		pParams[i].value = strdup(pszValue);
+		pIndex->count = i + 1;
+		if (pIndex->slots == NULL)
+			return;
+		// Keep index load factor under 1/2...
+		if (2 * pIndex->count > pIndex->mask) {
+			_lscp_plist_index_build(pIndex, pParams, 2 * (pIndex->mask + 1));
+			return;
+		}
+		j = _lscp_plist_hash(pszKey) & pIndex->mask;
+		while (pIndex->slots[j])
+			j = (j + 1) & pIndex->mask;
+		pIndex->slots[j] = i + 1;
+	}
+}
+
+
+// Find a parameter value by key, in a list made by lscp_plist_alloc.
+const char *lscp_plist_find ( lscp_param_t *pParams, const char *pszKey )
+{
+	int i;
+
+	if (pParams == NULL || pszKey == NULL)
+		return NULL;
+
+	i = _lscp_plist_index_find(_lscp_plist_index(pParams), pParams, pszKey);
+	if (i < 0)
+		return NULL;
+
+	return (const char *) pParams[i].value;
+}
+
+#ifdef LSCP_PLIST_COUNT
+
+// Compute a parameter list valid item count.
+int lscp_plist_count ( lscp_param_t **ppList )
+{
+	lscp_param_t *pParams;
+	int i = 0;
+	if (ppList && *ppList) {
+		pParams = *ppList;
+		while (pParams[i].key)
+			i++;
+	}
+	return i;
+}
+
+// Compute the legal parameter list size.
+int lscp_plist_size ( lscp_param_t **ppList )
+{
+	return _lscp_split_size(lscp_plist_count(ppList));
+}
+
+#endif // LSCP_PLIST_COUNT
+
+
+// Split a string into an array of MIDI instrument triplets.
+lscp_midi_instrument_t *lscp_midi_instruments_create ( const char *pszCsv )
+{
+	char *pchHead, *pch;
+	int iSize, i, k;
+	lscp_midi_instrument_t *pInstrs;
+	
+	// Get it clean first.
+	pchHead = lscp_ltrim((char *) pszCsv);
+	if (*pchHead == (char) 0)
+		return NULL;
+	
+	// Pre-count triplets and allocate just once (plus terminator).
+	iSize = _lscp_split_count(pchHead, "{") + 1;
+	// Allocate and split...
+	pInstrs = (lscp_midi_instrument_t *) malloc(iSize * sizeof(lscp_midi_instrument_t));
+	if (pInstrs == NULL)
+		return NULL;
+	
+	// Go on for it...
+	i = 0;
+	k = 0;
+	
+	while (i < iSize - 1 && (pch = lscp_strpbrk(pchHead, "{,}")) != NULL) {
+		// Pre-advance to next item.
+		switch (*pch) {
+		case '{':
+			pchHead = pch + 1;
+			if (k == 0) {
+				pInstrs[i].map = lscp_atoi(pchHead);
+				k++;
+			}
+			break;
+		case ',':
+			pchHead = pch + 1;
+			if (k == 1) {
+				pInstrs[i].bank = lscp_atoi(pchHead);
+				k++;
+			}
+			else 
+			if (k == 2) {
+				pInstrs[i].prog = lscp_atoi(pchHead);
+				k++;
+			}
+			break;
+		case '}':
+			pchHead = pch + 1;
+			k = 0;
+			break;
+		}
+		// Got a complete triplet?
+		if (k == 3) {
+			++i;
+			k = 4;
+		}
+	}
+	
+	// Special terminate split array.
+	for ( ; i < iSize; i++) {
+		pInstrs[i].map  = -1;
+		pInstrs[i].bank = -1;
+		pInstrs[i].prog = -1;
+	}
+	
+	return pInstrs;
+}
+
+// Destroy a MIDI instrument triplet array.
+void lscp_midi_instruments_destroy ( lscp_midi_instrument_t *pInstrs )
+{
+	if (pInstrs)
+		free(pInstrs);
+}
+
+#ifdef LSCP_MIDI_INSTRUMENTS_COUNT
+
+// Compute a MIDI instrument array item count.
+int lscp_midi_instruments_count ( lscp_midi_instrument_t *pInstrs )
+{
+	int i = 0;
+	while (pInstrs && pInstrs[i].map >= 0)
+		i++;
+	return i;
+}
+
+// Compute a MIDI instrument array (minimum) size.
+int lscp_midi_instruments_size ( lscp_midi_instrument_t *pInstrs )
+{
+	return lscp_midi_instruments_count(pInstrs) + 1;
+}
+
+#endif // LSCP_MIDI_INSTRUMENTS_COUNT
+
+
+//-------------------------------------------------------------------------
+// Server info struct helper functions.
+
+void lscp_server_info_init ( lscp_server_info_t *pServerInfo )
+{
+	pServerInfo->description      = NULL;
+	pServerInfo->version          = NULL;
+	pServerInfo->protocol_version = NULL;
+}
+
+void lscp_server_info_free ( lscp_server_info_t *pServerInfo )
+{
+	if (pServerInfo->description)
+		free(pServerInfo->description);
+	if (pServerInfo->version)
+		free(pServerInfo->version);
+	if (pServerInfo->protocol_version)
+		free(pServerInfo->protocol_version);
+}
+
+void lscp_server_info_reset ( lscp_server_info_t *pServerInfo )
+{
+	lscp_server_info_free(pServerInfo);
+	lscp_server_info_init(pServerInfo);
+}
+
+
+//-------------------------------------------------------------------------
+// Engine info struct helper functions.
+
+void lscp_engine_info_init ( lscp_engine_info_t *pEngineInfo )
+{
+	pEngineInfo->description = NULL;
+	pEngineInfo->version     = NULL;
+}
+
+void lscp_engine_info_free ( lscp_engine_info_t *pEngineInfo )
+{
+	if (pEngineInfo->description)
+		free(pEngineInfo->description);
+	if (pEngineInfo->version)
+		free(pEngineInfo->version);
+}
+
+void lscp_engine_info_reset ( lscp_engine_info_t *pEngineInfo )
+{
+	lscp_engine_info_free(pEngineInfo);
+	lscp_engine_info_init(pEngineInfo);
+}
+
+
+//-------------------------------------------------------------------------
+// Channel info struct helper functions.
+
+void lscp_channel_info_init ( lscp_channel_info_t *pChannelInfo )
+{
+	pChannelInfo->engine_name       = NULL;
+	pChannelInfo->audio_device      = 0;
+	pChannelInfo->audio_channels    = 0;
+	pChannelInfo->audio_routing     = NULL;
+	pChannelInfo->instrument_file   = NULL;
+	pChannelInfo->instrument_nr     = 0;
+	pChannelInfo->instrument_name   = NULL;
+	pChannelInfo->instrument_status = 0;
+	pChannelInfo->midi_device       = 0;
+	pChannelInfo->midi_port         = 0;
+	pChannelInfo->midi_channel      = 0;
+	pChannelInfo->midi_map          = 0;
+	pChannelInfo->volume            = 0.0;
+	pChannelInfo->mute              = 0;
+	pChannelInfo->solo              = 0;
+}
+
+void lscp_channel_info_free ( lscp_channel_info_t *pChannelInfo )
+{
+	lscp_intern_release(pChannelInfo->engine_name);
+	if (pChannelInfo->audio_routing)
+		lscp_isplit_destroy(pChannelInfo->audio_routing);
+	lscp_intern_release(pChannelInfo->instrument_file);
+	lscp_intern_release(pChannelInfo->instrument_name);
+}
+
+void lscp_channel_info_reset ( lscp_channel_info_t *pChannelInfo )
+{
+	lscp_channel_info_free(pChannelInfo);
+	lscp_channel_info_init(pChannelInfo);
+}
+
+// Copy over, text fields interned anew (destination must be reset).
+void lscp_channel_info_copy ( lscp_intern_pool_t *pPool,
+	lscp_channel_info_t *pDst, const lscp_channel_info_t *pSrc )
+{
+	int i;
+
+	*pDst = *pSrc;
+
+	pDst->engine_name     = lscp_intern(pPool, pSrc->engine_name);
+	pDst->instrument_file = lscp_intern(pPool, pSrc->instrument_file);
+	pDst->instrument_name = lscp_intern(pPool, pSrc->instrument_name);
+
+	pDst->audio_routing = NULL;
+	if (pSrc->audio_routing) {
+		for (i = 0; pSrc->audio_routing[i] >= 0; i++)
+			;
+		pDst->audio_routing = (int *) malloc((i + 1) * sizeof(int));
+		if (pDst->audio_routing)
+			memcpy(pDst->audio_routing, pSrc->audio_routing, (i + 1) * sizeof(int));
+	}
+}
+
+
+void lscp_channel_lazy_init ( lscp_channel_lazy_t *pChannelLazy )
+{
+	int i;
+
+	lscp_response_init(&(pChannelLazy->response));
+	for (i = 0; i < LSCP_CHANNEL_FIELDS; i++)
+		pChannelLazy->values[i] = -1;
+	pChannelLazy->decoded      = 0;
+	pChannelLazy->routing      = NULL;
+	pChannelLazy->routing_size = 0;
+
+	lscp_channel_info_init(&(pChannelLazy->info));
+}
+
+void lscp_channel_lazy_free ( lscp_channel_lazy_t *pChannelLazy )
+{
+	// Decoded strings are not owned, as they live in the response copy.
+	lscp_response_free(&(pChannelLazy->response));
+	if (pChannelLazy->routing)
+		free(pChannelLazy->routing);
+
+	lscp_channel_lazy_init(pChannelLazy);
+}
+
+
+void lscp_channel_cache_init ( lscp_channel_cache_t *pChannelCache )
+{
+	pChannelCache->enabled = 0;
+	pChannelCache->events  = LSCP_EVENT_NONE;
+
+	lscp_hash_init(&(pChannelCache->items));
+	lscp_mutex_init(pChannelCache->mutex);
+}
+
+void lscp_channel_cache_free ( lscp_channel_cache_t *pChannelCache )
+{
+	lscp_channel_cache_flush(pChannelCache);
+	lscp_mutex_destroy(pChannelCache->mutex);
+}
+
+// Drop all cached items (caller must own the cache mutex).
+void lscp_channel_cache_flush ( lscp_channel_cache_t *pChannelCache )
+{
+	lscp_hash_t *pItems = &(pChannelCache->items);
+	lscp_channel_cache_item_t *pItem;
+	int i;
+
+	for (i = 0; i < pItems->size; i++) {
+		pItem = (lscp_channel_cache_item_t *) pItems->values[i];
+		if (pItem) {
+			lscp_channel_info_free(&(pItem->info));
+			free(pItem);
+		}
+	}
+
+	lscp_hash_free(pItems);
+}
+
+// Invalidate one cached item, or all of them if iSamplerChannel < 0
+// (caller must own the cache mutex).
+void lscp_channel_cache_invalidate ( lscp_channel_cache_t *pChannelCache,
+	int iSamplerChannel )
+{
+	lscp_hash_t *pItems = &(pChannelCache->items);
+	lscp_channel_cache_item_t *pItem;
+	int i;
+
+	if (iSamplerChannel < 0) {
+		for (i = 0; i < pItems->size; i++) {
+			pItem = (lscp_channel_cache_item_t *) pItems->values[i];
+			if (pItem) {
+				pItem->valid = 0;
+				pItem->dirty = 1;
+			}
+		}
+	} else {
+		pItem = (lscp_channel_cache_item_t *)
+			lscp_hash_find(pItems, iSamplerChannel);
+		if (pItem) {
+			pItem->valid = 0;
+			pItem->dirty = 1;
+		}
+	}
+}
+
+
+//-------------------------------------------------------------------------
+// Driver info struct functions.
+
+void lscp_driver_info_init ( lscp_driver_info_t *pDriverInfo )
+{
+	pDriverInfo->description = NULL;
+	pDriverInfo->version     = NULL;
+	pDriverInfo->parameters  = NULL;
+}
+
+void lscp_driver_info_free ( lscp_driver_info_t *pDriverInfo )
+{
+	if (pDriverInfo->description)
+		free(pDriverInfo->description);
+	if (pDriverInfo->version)
+		free(pDriverInfo->version);
+	lscp_szsplit_destroy(pDriverInfo->parameters);
+}
+
+void lscp_driver_info_reset ( lscp_driver_info_t *pDriverInfo )
+{
+	lscp_driver_info_free(pDriverInfo);
+	lscp_driver_info_init(pDriverInfo);
+}
+
+
+//-------------------------------------------------------------------------
+// Device info struct functions.
+
+void lscp_device_info_init ( lscp_device_info_t *pDeviceInfo )
+{
+	pDeviceInfo->driver = NULL;
+	lscp_plist_alloc(&(pDeviceInfo->params));
+}
+
+void lscp_device_info_free ( lscp_device_info_t *pDeviceInfo )
+{
+	lscp_intern_release(pDeviceInfo->driver);
+	lscp_plist_free(&(pDeviceInfo->params));
+}
+
+void lscp_device_info_reset ( lscp_device_info_t *pDeviceInfo )
+{
+	lscp_device_info_free(pDeviceInfo);
+	lscp_device_info_init(pDeviceInfo);
+}
+
+
+//-------------------------------------------------------------------------
+// Device channel/port info struct functions.
+
+void lscp_device_port_info_init ( lscp_device_port_info_t *pDevicePortInfo )
+{
+	pDevicePortInfo->name = NULL;
+	lscp_plist_alloc(&(pDevicePortInfo->params));
+}
+
+void lscp_device_port_info_free ( lscp_device_port_info_t *pDevicePortInfo )
+{
+	if (pDevicePortInfo->name)
+		free(pDevicePortInfo->name);
+	lscp_plist_free(&(pDevicePortInfo->params));
+}
+
+void lscp_device_port_info_reset ( lscp_device_port_info_t *pDevicePortInfo )
+{
+	lscp_device_port_info_free(pDevicePortInfo);
+	lscp_device_port_info_init(pDevicePortInfo);
+}
+
+
+//-------------------------------------------------------------------------
+// Parameter struct helper functions.
+
+void lscp_param_info_init ( lscp_param_info_t *pParamInfo )
+{
+	pParamInfo->type          = LSCP_TYPE_NONE;
+	pParamInfo->description   = NULL;
+	pParamInfo->mandatory     = 0;
+	pParamInfo->fix           = 0;
+	pParamInfo->multiplicity  = 0;
+	pParamInfo->depends       = NULL;
+	pParamInfo->defaultv      = NULL;
+	pParamInfo->range_min     = NULL;
+	pParamInfo->range_max     = NULL;
+	pParamInfo->possibilities = NULL;
+}
+
+void lscp_param_info_free ( lscp_param_info_t *pParamInfo )
+{
+	if (pParamInfo->description)
+		free(pParamInfo->description);
+	lscp_szsplit_destroy(pParamInfo->depends);
+	if (pParamInfo->defaultv)
+		free(pParamInfo->defaultv);
+	if (pParamInfo->range_min)
+		free(pParamInfo->range_min);
+	if (pParamInfo->range_max)
+		free(pParamInfo->range_max);
+	lscp_szsplit_destroy(pParamInfo->possibilities);
+}
+
+void lscp_param_info_reset ( lscp_param_info_t *pParamInfo )
+{
+	lscp_param_info_free(pParamInfo);
+	lscp_param_info_init(pParamInfo);
+}
+
+
+//-------------------------------------------------------------------------
+// Concatenate a parameter list (key='value'...) into a string,
+// appending a crlf terminator.
+
+int lscp_param_concat ( char *pszBuffer, int cchMaxBuffer, lscp_param_t *pParams )
+{
+	int cchBuffer, cchParam, i;
+
+	if (pszBuffer == NULL)
+		return 0;
+
+	cchBuffer = strlen(pszBuffer);
+	for (i = 0; pParams && pParams[i].key && pParams[i].value; i++) {
+		cchParam = strlen(pParams[i].key) + strlen(pParams[i].value) + 4;
+		if (cchBuffer + cchParam + 2 < cchMaxBuffer) {
+			sprintf(pszBuffer + cchBuffer, " %s='%s'", pParams[i].key, pParams[i].value);
+			cchBuffer += cchParam;
+		}
+	}
+	
+	if (cchBuffer + 2 < cchMaxBuffer) {
+		pszBuffer[cchBuffer++] = '\r';
+		pszBuffer[cchBuffer++] = '\n';
+		pszBuffer[cchBuffer ]  = (char) 0;
+	}
+	
+	return cchBuffer;
+}
+
+
+//-------------------------------------------------------------------------
+// Effect struct helper functions.
+
+void lscp_fxsend_info_init ( lscp_fxsend_info_t *pFxSendInfo )
+{
+	pFxSendInfo->name            = NULL;
+	pFxSendInfo->midi_controller = 0;
+	pFxSendInfo->audio_routing   = NULL;
+	pFxSendInfo->level           = 0.0f;
+}
+
+void lscp_fxsend_info_free ( lscp_fxsend_info_t *pFxSendInfo )
+{
+	if (pFxSendInfo->name)
+		free(pFxSendInfo->name);
+	if (pFxSendInfo->audio_routing)
+		lscp_isplit_destroy(pFxSendInfo->audio_routing);
+}
+
+void lscp_fxsend_info_reset (lscp_fxsend_info_t *pFxSendInfo )
+{
+	lscp_fxsend_info_free(pFxSendInfo);
+	lscp_fxsend_info_init(pFxSendInfo);
+}
+
+
+//-------------------------------------------------------------------------
+// MIDI instrument info struct helper functions.
+
+void lscp_midi_instrument_info_init ( lscp_midi_instrument_info_t *pInstrInfo )
+{
+	pInstrInfo->name              = NULL;
+	pInstrInfo->engine_name       = NULL;
+	pInstrInfo->instrument_file   = NULL;
+	pInstrInfo->instrument_nr     = 0;
+	pInstrInfo->instrument_name   = NULL;
+	pInstrInfo->load_mode         = LSCP_LOAD_DEFAULT;
+	pInstrInfo->volume            = 0.0;
+}
+
+void lscp_midi_instrument_info_free ( lscp_midi_instrument_info_t *pInstrInfo )
+{
+	lscp_intern_release(pInstrInfo->name);
+	lscp_intern_release(pInstrInfo->engine_name);
+	lscp_intern_release(pInstrInfo->instrument_file);
+	lscp_intern_release(pInstrInfo->instrument_name);
+}
+
+void lscp_midi_instrument_info_reset ( lscp_midi_instrument_info_t *pInstrInfo )
+{
+	lscp_midi_instrument_info_free(pInstrInfo);
+	lscp_midi_instrument_info_init(pInstrInfo);
+}
+
+
+//-------------------------------------------------------------------------
+// Reference-counted info snapshot helper functions.
+
+// Snapshot header, preceding the info struct itself
+// (union'ed for worst case alignment of what follows).
+typedef union _lscp_snapshot_t
+{
+	struct {
+		volatile long        refs;
+		lscp_snapshot_type_t type;
+	} h;
+
+	int64_t align1;
+	double  align2;
+	void   *align3;
+
+} lscp_snapshot_t;
+
+#define _lscp_snapshot_header(pv) (((lscp_snapshot_t *) (pv)) - 1)
+
+
+// Allocate a new snapshot of given info type, initialized
+// and holding one single reference; NULL on failure.
+void *lscp_snapshot_alloc ( lscp_snapshot_type_t type )
+{
+	lscp_snapshot_t *pSnapshot;
+	void *pvInfo;
+	size_t cbInfo;
+
+	switch (type) {
+	case LSCP_SNAPSHOT_SERVER_INFO:
+		cbInfo = sizeof(lscp_server_info_t);
+		break;
+	case LSCP_SNAPSHOT_ENGINE_INFO:
+		cbInfo = sizeof(lscp_engine_info_t);
+		break;
+	case LSCP_SNAPSHOT_CHANNEL_INFO:
+		cbInfo = sizeof(lscp_channel_info_t);
+		break;
+	case LSCP_SNAPSHOT_FXSEND_INFO:
+		cbInfo = sizeof(lscp_fxsend_info_t);
+		break;
+	case LSCP_SNAPSHOT_MIDI_INSTRUMENT_INFO:
+		cbInfo = sizeof(lscp_midi_instrument_info_t);
+		break;
+	case LSCP_SNAPSHOT_DRIVER_INFO:
+		cbInfo = sizeof(lscp_driver_info_t);
+		break;
+	case LSCP_SNAPSHOT_DEVICE_INFO:
+		cbInfo = sizeof(lscp_device_info_t);
+		break;
+	case LSCP_SNAPSHOT_DEVICE_PORT_INFO:
+		cbInfo = sizeof(lscp_device_port_info_t);
+		break;
+	case LSCP_SNAPSHOT_PARAM_INFO:
+		cbInfo = sizeof(lscp_param_info_t);
+		break;
+	default:
+		return NULL;
+	}
+
+	pSnapshot = (lscp_snapshot_t *) malloc(sizeof(lscp_snapshot_t) + cbInfo);
+	if (pSnapshot == NULL)
+		return NULL;
+
+	pSnapshot->h.refs = 1;
+	pSnapshot->h.type = type;
+
+	pvInfo = (void *) (pSnapshot + 1);
+	switch (type) {
+	case LSCP_SNAPSHOT_SERVER_INFO:
+		lscp_server_info_init((lscp_server_info_t *) pvInfo);
+		break;
+	case LSCP_SNAPSHOT_ENGINE_INFO:
+		lscp_engine_info_init((lscp_engine_info_t *) pvInfo);
+		break;
+	case LSCP_SNAPSHOT_CHANNEL_INFO:
+		lscp_channel_info_init((lscp_channel_info_t *) pvInfo);
+		break;
+	case LSCP_SNAPSHOT_FXSEND_INFO:
+		lscp_fxsend_info_init((lscp_fxsend_info_t *) pvInfo);
+		break;
+	case LSCP_SNAPSHOT_MIDI_INSTRUMENT_INFO:
+		lscp_midi_instrument_info_init((lscp_midi_instrument_info_t *) pvInfo);
+		break;
+	case LSCP_SNAPSHOT_DRIVER_INFO:
+		lscp_driver_info_init((lscp_driver_info_t *) pvInfo);
+		break;
+	case LSCP_SNAPSHOT_DEVICE_INFO:
+		lscp_device_info_init((lscp_device_info_t *) pvInfo);
+		break;
+	case LSCP_SNAPSHOT_DEVICE_PORT_INFO:
+		lscp_device_port_info_init((lscp_device_port_info_t *) pvInfo);
+		break;
+	case LSCP_SNAPSHOT_PARAM_INFO:
+		lscp_param_info_init((lscp_param_info_t *) pvInfo);
+		break;
+	}
+
+	return pvInfo;
+}
+
+
+/**
+ *  Acquire an additional reference to an info snapshot, as returned
+ *  by any of the @c lscp_get_*_info_snapshot functions.
+ *
+ *  @param pvSnapshot   Pointer to the info snapshot.
+ */
+void lscp_snapshot_ref ( const void *pvSnapshot )
+{
+	if (pvSnapshot)
+		_lscp_atomic_inc(&(_lscp_snapshot_header(pvSnapshot)->h.refs));
+}
+
+
+/**
+ *  Release a reference to an info snapshot. The snapshot is
+ *  destroyed when its last reference is released.
+ *
+ *  @param pvSnapshot   Pointer to the info snapshot.
+ */
+void lscp_snapshot_unref ( const void *pvSnapshot )
+{
+	lscp_snapshot_t *pSnapshot;
+	void *pvInfo;
+
+	if (pvSnapshot == NULL)
+		return;
+
+	pSnapshot = _lscp_snapshot_header(pvSnapshot);
+	if (_lscp_atomic_dec(&(pSnapshot->h.refs)) > 0)
+		return;
+
+	pvInfo = (void *) (pSnapshot + 1);
+	switch (pSnapshot->h.type) {
+	case LSCP_SNAPSHOT_SERVER_INFO:
+		lscp_server_info_free((lscp_server_info_t *) pvInfo);
+		break;
+	case LSCP_SNAPSHOT_ENGINE_INFO:
+		lscp_engine_info_free((lscp_engine_info_t *) pvInfo);
+		break;
+	case LSCP_SNAPSHOT_CHANNEL_INFO:
+		lscp_channel_info_free((lscp_channel_info_t *) pvInfo);
+		break;
+	case LSCP_SNAPSHOT_FXSEND_INFO:
+		lscp_fxsend_info_free((lscp_fxsend_info_t *) pvInfo);
+		break;
+	case LSCP_SNAPSHOT_MIDI_INSTRUMENT_INFO:
+		lscp_midi_instrument_info_free((lscp_midi_instrument_info_t *) pvInfo);
+		break;
+	case LSCP_SNAPSHOT_DRIVER_INFO:
+		lscp_driver_info_free((lscp_driver_info_t *) pvInfo);
+		break;
+	case LSCP_SNAPSHOT_DEVICE_INFO:
+		lscp_device_info_free((lscp_device_info_t *) pvInfo);
+		break;
+	case LSCP_SNAPSHOT_DEVICE_PORT_INFO:
+		lscp_device_port_info_free((lscp_device_port_info_t *) pvInfo);
+		break;
+	case LSCP_SNAPSHOT_PARAM_INFO:
+		lscp_param_info_free((lscp_param_info_t *) pvInfo);
+		break;
+	}
+
+	free(pSnapshot);
+}
+
+
+//-------------------------------------------------------------------------
+// Memoized metadata cache helper functions (keyed by query string).
+
+// Cached metadata item (chained on key hash collisions).
+typedef struct _lscp_metadata_t
+{
+	char   *query;
+	void   *snapshot;
+
+	struct _lscp_metadata_t *next;
+
+} lscp_metadata_t;
+
+
+// String hash (FNV-1a, 64bit).
+static int64_t _lscp_string_hash ( const char *psz )
+{
+	uint64_t h = 14695981039346656037ULL;
+
+	while (*psz) {
+		h ^= (unsigned char) *psz++;
+		h *= 1099511628211ULL;
+	}
+
+	return (int64_t) h;
+}
+
+
+// Find a cached metadata snapshot, adding a reference on behalf
+// of the caller if iSnapshot is set; NULL if not found.
+void *lscp_metadata_find ( lscp_client_t *pClient, const char *pszQuery,
+	int iSnapshot )
+{
+	lscp_metadata_t *pItem;
+	void *pvSnapshot = NULL;
+
+	// Lock this section up.
+	lscp_mutex_lock(pClient->mutex);
+
+	pItem = (lscp_metadata_t *) lscp_hash_find(&(pClient->metadata),
+		_lscp_string_hash(pszQuery));
+	while (pItem && strcmp(pItem->query, pszQuery))
+		pItem = pItem->next;
+	if (pItem) {
+		pvSnapshot = pItem->snapshot;
+		if (iSnapshot)
+			lscp_snapshot_ref(pvSnapshot);
+	}
+
+	// Unlock this section down.
+	lscp_mutex_unlock(pClient->mutex);
+
+	return pvSnapshot;
+}
+
+
+// Cache a freshly queried metadata snapshot, taking over its reference;
+// if some other thread got there first, the given snapshot is dropped
+// in favor of the already cached one. Returns the cached snapshot,
+// with an additional reference on behalf of the caller if iSnapshot
+// is set (or just the given one, should caching fail).
+void *lscp_metadata_insert ( lscp_client_t *pClient, const char *pszQuery,
+	void *pvSnapshot, int iSnapshot )
+{
+	lscp_metadata_t *pHead, *pItem;
+	int64_t key;
+
+	key = _lscp_string_hash(pszQuery);
+
+	// Lock this section up.
+	lscp_mutex_lock(pClient->mutex);
+
+	pHead = (lscp_metadata_t *) lscp_hash_find(&(pClient->metadata), key);
+	for (pItem = pHead; pItem; pItem = pItem->next) {
+		if (strcmp(pItem->query, pszQuery) == 0) {
+			lscp_snapshot_unref(pvSnapshot);
+			pvSnapshot = pItem->snapshot;
+			break;
+		}
+	}
+
+	if (pItem == NULL) {
+		pItem = (lscp_metadata_t *) malloc(sizeof(lscp_metadata_t));
+		if (pItem) {
+			pItem->query = strdup(pszQuery);
+			pItem->snapshot = pvSnapshot;
+			pItem->next = pHead;
+			if (pItem->query == NULL
+				|| lscp_hash_insert(&(pClient->metadata), key, pItem) < 0) {
+				if (pItem->query)
+					free(pItem->query);
+				free(pItem);
+				pItem = NULL;
+			}
+		}
+	}
+
+	// Add a reference for the caller, unless caching failed,
+	// when the given one is just handed back instead.
+	if (pItem && iSnapshot)
+		lscp_snapshot_ref(pvSnapshot);
+
+	// Unlock this section down.
+	lscp_mutex_unlock(pClient->mutex);
+
+	return pvSnapshot;
+}
+
+
+// Drop all cached metadata (caller must own the client mutex).
+void lscp_metadata_flush ( lscp_client_t *pClient )
+{
+	lscp_hash_t *pMetadata = &(pClient->metadata);
+	lscp_metadata_t *pItem, *pNext;
+	int i;
+
+	for (i = 0; i < pMetadata->size; i++) {
+		pItem = (lscp_metadata_t *) pMetadata->values[i];
+		while (pItem) {
+			pNext = pItem->next;
+			lscp_snapshot_unref(pItem->snapshot);
+			free(pItem->query);
+			free(pItem);
+			pItem = pNext;
+		}
+	}
+
+	lscp_hash_free(pMetadata);
+}
+
+
+//-------------------------------------------------------------------------
+// String intern pool helper functions.
+
+// Get the interned string header from its text.
+#define _lscp_intern_item(psz) ((lscp_intern_item_t *) \
+	((char *) (psz) - offsetof(lscp_intern_item_t, text)))
+
+
+// Free the pool itself (no more references).
+static void _lscp_intern_pool_free ( lscp_intern_pool_t *pPool )
+{
+	lscp_hash_free(&(pPool->items));
+	lscp_mutex_destroy(pPool->mutex);
+
+	free(pPool);
+}
+
+
+// Create a new empty pool, holding one single reference.
+lscp_intern_pool_t *lscp_intern_pool_create (void)
+{
+	lscp_intern_pool_t *pPool;
+
+	pPool = (lscp_intern_pool_t *) malloc(sizeof(lscp_intern_pool_t));
+	if (pPool == NULL)
+		return NULL;
+
+	pPool->refs = 1;
+	lscp_hash_init(&(pPool->items));
+	lscp_mutex_init(pPool->mutex);
+
+	return pPool;
+}
+
+// Drop the (client) pool reference; the pool is only gone for good
+// after the last of its interned strings is released as well.
+void lscp_intern_pool_release ( lscp_intern_pool_t *pPool )
+{
+	int iRefs;
+
+	if (pPool == NULL)
+		return;
+
+	lscp_mutex_lock(pPool->mutex);
+	iRefs = --(pPool->refs);
+	lscp_mutex_unlock(pPool->mutex);
+
+	if (iRefs < 1)
+		_lscp_intern_pool_free(pPool);
+}
+
+
+// Find an interned string, chained by string hash
+// (caller must own the pool mutex).
+static lscp_intern_item_t *_lscp_intern_find ( lscp_intern_pool_t *pPool,
+	const char *psz, int64_t hash )
+{
+	lscp_intern_item_t *pItem;
+
+	pItem = (lscp_intern_item_t *) lscp_hash_find(&(pPool->items), hash);
+	while (pItem && strcmp(pItem->text, psz))
+		pItem = pItem->next;
+
+	return pItem;
+}
+
+
+// Intern a string, returning the one and only shared copy of it, with an
+// additional reference on behalf of the caller; NULL on failure. The
+// returned text must not be changed, nor freed but with lscp_intern_release.
+char *lscp_intern ( lscp_intern_pool_t *pPool, const char *psz )
+{
+	lscp_intern_item_t *pItem;
+	int64_t hash;
+	int cch;
+
+	if (pPool == NULL || psz == NULL)
+		return NULL;
+
+	hash = _lscp_string_hash(psz);
+
+	lscp_mutex_lock(pPool->mutex);
+
+	pItem = _lscp_intern_find(pPool, psz, hash);
+	if (pItem) {
+		pItem->refs++;
+	} else {
+		cch = strlen(psz);
+		pItem = (lscp_intern_item_t *)
+			malloc(offsetof(lscp_intern_item_t, text) + cch + 1);
+		if (pItem) {
+			pItem->next = (lscp_intern_item_t *)
+				lscp_hash_find(&(pPool->items), hash);
+			pItem->pool = pPool;
+			pItem->hash = hash;
+			pItem->refs = 1;
+			memcpy(pItem->text, psz, cch + 1);
+			if (lscp_hash_insert(&(pPool->items), hash, pItem) < 0) {
+				free(pItem);
+				pItem = NULL;
+			}
+			else pPool->refs++;
+		}
+	}
+
+	lscp_mutex_unlock(pPool->mutex);
+
+	return (pItem ? pItem->text : NULL);
+}
+
+// Find the shared copy of a string, if it's interned at all, so that
+// it may be compared by pointer; no reference is added on its behalf.
+char *lscp_intern_find ( lscp_intern_pool_t *pPool, const char *psz )
+{
+	lscp_intern_item_t *pItem;
+
+	if (pPool == NULL || psz == NULL)
+		return NULL;
+
+	lscp_mutex_lock(pPool->mutex);
+	pItem = _lscp_intern_find(pPool, psz, _lscp_string_hash(psz));
+	lscp_mutex_unlock(pPool->mutex);
+
+	return (pItem ? pItem->text : NULL);
+}
+
+// Release an interned string reference, freeing
+// it when gone (and the pool too, if last one).
+void lscp_intern_release ( const char *psz )
+{
+	lscp_intern_item_t *pItem, *pPrev;
+	lscp_intern_pool_t *pPool;
+	int iRefs;
+
+	if (psz == NULL)
+		return;
+
+	pItem = _lscp_intern_item(psz);
+	pPool = pItem->pool;
+
+	lscp_mutex_lock(pPool->mutex);
+
+	if (--(pItem->refs) > 0) {
+		lscp_mutex_unlock(pPool->mutex);
+		return;
+	}
+
+	// Unchain it...
+	pPrev = (lscp_intern_item_t *) lscp_hash_find(&(pPool->items), pItem->hash);
+	if (pPrev == pItem) {
+		if (pItem->next)
+			lscp_hash_insert(&(pPool->items), pItem->hash, pItem->next);
+		else
+			lscp_hash_remove(&(pPool->items), pItem->hash);
+	} else {
+		while (pPrev && pPrev->next != pItem)
+			pPrev = pPrev->next;
+		if (pPrev)
+			pPrev->next = pItem->next;
+	}
+
+	free(pItem);
+
+	iRefs = --(pPool->refs);
+
+	lscp_mutex_unlock(pPool->mutex);
+
+	if (iRefs < 1)
+		_lscp_intern_pool_free(pPool);
+}
+
+
+//-------------------------------------------------------------------------
+// Event stream line framer helper functions.
+
+void lscp_framer_init ( lscp_framer_t *pFramer )
+{
+	pFramer->buffer = NULL;
+	pFramer->size   = 0;
+	pFramer->head   = 0;
+	pFramer->tail   = 0;
+	pFramer->skip   = 0;
+}
+
+void lscp_framer_free ( lscp_framer_t *pFramer )
+{
+	if (pFramer->buffer)
+		free(pFramer->buffer);
+
+	lscp_framer_init(pFramer);
+}
+
+
+// Make room for one bulk read, after any pending (partial) line;
+// returns where to receive into, or NULL on allocation failure.
+char *lscp_framer_space ( lscp_framer_t *pFramer, int *pcchSpace )
+{
+	char *pchBuffer;
+	int iSize;
+
+	// Move the pending line down to the front...
+	if (pFramer->head > 0) {
+		pFramer->tail -= pFramer->head;
+		if (pFramer->tail > 0) {
+			memmove(pFramer->buffer,
+				pFramer->buffer + pFramer->head, pFramer->tail);
+		}
+		pFramer->head = 0;
+	}
+
+	// Way too long for a line: drop it, up to its very end...
+	if (pFramer->tail >= LSCP_FRAMER_MAXSIZ) {
+		pFramer->tail = 0;
+		pFramer->skip = 1;
+	}
+
+	// Grow as needed, always leaving room for a null terminator.
+	if (pFramer->size - pFramer->tail - 1 < LSCP_FRAMER_BUFSIZ) {
+		iSize = (pFramer->size > 0 ? pFramer->size : LSCP_FRAMER_BUFSIZ);
+		while (iSize - pFramer->tail - 1 < LSCP_FRAMER_BUFSIZ)
+			iSize <<= 1;
+		pchBuffer = (char *) realloc(pFramer->buffer, iSize);
+		if (pchBuffer == NULL)
+			return NULL;
+		pFramer->buffer = pchBuffer;
+		pFramer->size = iSize;
+	}
+
+	*pcchSpace = pFramer->size - pFramer->tail - 1;
+
+	return pFramer->buffer + pFramer->tail;
+}
+
+
+// Account for newly received data.
+void lscp_framer_commit ( lscp_framer_t *pFramer, int cchData )
+{
+	if (cchData > 0)
+		pFramer->tail += cchData;
+}
+
+
+// Take the next complete line, stripped of its CR/LF terminator;
+// returns NULL when there's none, but a partial one, pending.
+char *lscp_framer_line ( lscp_framer_t *pFramer )
+{
+	char *pszLine;
+	char *pchEnd;
+
+	while (pFramer->head < pFramer->tail) {
+		pszLine = pFramer->buffer + pFramer->head;
+		pchEnd = (char *) memchr(pszLine, '\n', pFramer->tail - pFramer->head);
+		if (pchEnd == NULL)
+			break;
+		pFramer->head = (int) (pchEnd - pFramer->buffer) + 1;
+		// Skip the remainder of a dropped line...
+		if (pFramer->skip) {
+			pFramer->skip = 0;
+			continue;
+		}
+		*pchEnd = '\0';
+		if (pchEnd > pszLine && *(pchEnd - 1) == '\r')
+			*(pchEnd - 1) = '\0';
+		return pszLine;
+	}
+
+	// All consumed, restart from scratch.
+	if (pFramer->head >= pFramer->tail) {
+		pFramer->head = 0;
+		pFramer->tail = 0;
+	}
+
+	return NULL;
+}
+
+
+//-------------------------------------------------------------------------
+// Queued event delivery helper functions.
+
+lscp_event_queue_t *lscp_event_queue_create ( int iCapacity,
+	lscp_queue_policy_t policy, lscp_client_ready_proc_t pfnReady,
+	void *pvReady )
+{
+	lscp_event_queue_t *pQueue;
+	unsigned int iSize;
+	unsigned int i;
+
+	if (iCapacity < 1 || iCapacity > LSCP_EVENT_QUEUE_MAX)
+		return NULL;
+
+	// Round up to a power of two...
+	iSize = 2;
+	while (iSize < (unsigned int) iCapacity)
+		iSize <<= 1;
+
+	pQueue = (lscp_event_queue_t *) malloc(sizeof(lscp_event_queue_t));
+	if (pQueue == NULL)
+		return NULL;
+
+	pQueue->slots = (lscp_event_slot_t *)
+		malloc(iSize * sizeof(lscp_event_slot_t));
+	if (pQueue->slots == NULL) {
+		free(pQueue);
+		return NULL;
+	}
+
+	for (i = 0; i < iSize; i++) {
+		pQueue->slots[i].text = NULL;
+		pQueue->slots[i].text_size = 0;
+		pQueue->slots[i].fill = NULL;
+		pQueue->slots[i].fill_size = 0;
+	}
+
+	pQueue->mask     = iSize - 1;
+	pQueue->head     = 0;
+	pQueue->tail     = 0;
+	pQueue->policy   = policy;
+	pQueue->drops    = 0;
+	pQueue->pfnReady = pfnReady;
+	pQueue->pvReady  = pvReady;
+	pQueue->ready    = 0;
+
+	return pQueue;
+}
+
+void lscp_event_queue_destroy ( lscp_event_queue_t *pQueue )
+{
+	unsigned int i;
+
+	if (pQueue == NULL)
+		return;
+
+	for (i = 0; i <= pQueue->mask; i++) {
+		if (pQueue->slots[i].text)
+			free(pQueue->slots[i].text);
+		if (pQueue->slots[i].fill)
+			free(pQueue->slots[i].fill);
+	}
+
+	free(pQueue->slots);
+	free(pQueue);
+}
+
+
+// Copy and decode an event into the next free slot (producer side);
+// returns 1 if queued and the ready callback is due, 0 if queued or
+// else dropped for good, -1 if full and the producer shall wait.
+int lscp_event_queue_push ( lscp_event_queue_t *pQueue,
+	lscp_event_t event, const char *pchData, int cchData )
+{
+	lscp_event_slot_t *pSlot;
+	unsigned int iTail;
+	char *pchText;
+	int iSize;
+
+	iTail = pQueue->tail;
+	if (iTail - pQueue->head > pQueue->mask) {
+		if (pQueue->policy == LSCP_QUEUE_WAIT)
+			return -1;
+		pQueue->drops++;
+		return 0;
+	}
+
+	// The slot is only ours after the consumer is done with it.
+	_lscp_atomic_barrier();
+	pSlot = &(pQueue->slots[iTail & pQueue->mask]);
+
+	if (pchData == NULL)
+		cchData = 0;
+	if (cchData + 1 > pSlot->text_size) {
+		iSize = (pSlot->text_size > 0 ? pSlot->text_size : 64);
+		while (cchData + 1 > iSize)
+			iSize <<= 1;
+		pchText = (char *) realloc(pSlot->text, iSize);
+		if (pchText == NULL) {
+			pQueue->drops++;
+			return 0;
+		}
+		pSlot->text = pchText;
+		pSlot->text_size = iSize;
+	}
+	if (cchData > 0)
+		memcpy(pSlot->text, pchData, cchData);
+	pSlot->text[cchData] = '\0';
+
+	lscp_event_data_decode(&(pSlot->data), event,
+		pSlot->text, cchData, &(pSlot->fill), &(pSlot->fill_size));
+
+	// Publish the slot only after it's fully written.
+	_lscp_atomic_barrier();
+	pQueue->tail = iTail + 1;
+
+	// Signal ready just once, until the consumer gets to it.
+	if (pQueue->pfnReady && _lscp_atomic_xchg(&(pQueue->ready), 1) == 0)
+		return 1;
+
+	return 0;
+}
+
+
+// Re-arm the ready signal, before draining (consumer side).
+void lscp_event_queue_arm ( lscp_event_queue_t *pQueue )
+{
+	pQueue->ready = 0;
+	_lscp_atomic_barrier();
+}
+
+
+// Oldest queued event slot, NULL if empty (consumer side).
+lscp_event_slot_t *lscp_event_queue_front ( lscp_event_queue_t *pQueue )
+{
+	unsigned int iHead = pQueue->head;
+
+	if (iHead == pQueue->tail)
+		return NULL;
+
+	_lscp_atomic_barrier();
+
+	return &(pQueue->slots[iHead & pQueue->mask]);
+}
+
+
+// Hand the oldest slot back to the producer (consumer side).
+void lscp_event_queue_pop ( lscp_event_queue_t *pQueue )
+{
+	_lscp_atomic_barrier();
+	pQueue->head++;
+}
+
+
+//-------------------------------------------------------------------------
+// All sampler channels info table helper functions.
+
+void lscp_channel_store_init ( lscp_channel_store_t *pStore )
+{
+	memset(&(pStore->table), 0, sizeof(lscp_channel_table_t));
+
+	pStore->size  = 0;
+	pStore->block = NULL;
+
+	pStore->status   = NULL;
+	pStore->strings  = NULL;
+	pStore->routings = NULL;
+
+	pStore->pool      = NULL;
+	pStore->pool_len  = 0;
+	pStore->pool_size = 0;
+	lscp_hash_init(&(pStore->interned));
+
+	pStore->routing      = NULL;
+	pStore->routing_len  = 0;
+	pStore->routing_size = 0;
+
+	lscp_hash_init(&(pStore->rows));
+}
+
+void lscp_channel_store_free ( lscp_channel_store_t *pStore )
+{
+	if (pStore->block)
+		free(pStore->block);
+	if (pStore->pool)
+		free(pStore->pool);
+	if (pStore->routing)
+		free(pStore->routing);
+	lscp_hash_free(&(pStore->interned));
+	lscp_hash_free(&(pStore->rows));
+
+	lscp_channel_store_init(pStore);
+}
+
+
+// Make room for a given number of rows, all columns laid out in one
+// single block (pointer columns first, for alignment); all rows are
+// left empty, yet to be set, and the pools are cleared.
+int lscp_channel_store_reset ( lscp_channel_store_t *pStore, int iRows )
+{
+	lscp_channel_table_t *pTable = &(pStore->table);
+	void **ppv;
+	int *pi;
+	int iSize, i;
+
+	if (iRows > pStore->size) {
+		iSize = (pStore->size > 0 ? pStore->size : 16);
+		while (iSize < iRows)
+			iSize <<= 1;
+		// 4 pointer columns, 13 public plus 5 private int columns,
+		// and one float column...
+		ppv = (void **) malloc(iSize * (4 * sizeof(void *)
+			+ 18 * sizeof(int) + sizeof(float)));
+		if (ppv == NULL)
+			return -1;
+		if (pStore->block)
+			free(pStore->block);
+		pStore->block = ppv;
+		pStore->size  = iSize;
+	}
+
+	iSize = pStore->size;
+	ppv = (void **) pStore->block;
+	pTable->engine_name     = (const char **) ppv; ppv += iSize;
+	pTable->instrument_file = (const char **) ppv; ppv += iSize;
+	pTable->instrument_name = (const char **) ppv; ppv += iSize;
+	pTable->audio_routing   = (const int **)  ppv; ppv += iSize;
+	pi = (int *) ppv;
+	pTable->channel           = pi; pi += iSize;
+	pTable->audio_device      = pi; pi += iSize;
+	pTable->audio_channels    = pi; pi += iSize;
+	pTable->instrument_nr     = pi; pi += iSize;
+	pTable->instrument_status = pi; pi += iSize;
+	pTable->midi_device       = pi; pi += iSize;
+	pTable->midi_port         = pi; pi += iSize;
+	pTable->midi_channel      = pi; pi += iSize;
+	pTable->midi_map          = pi; pi += iSize;
+	pTable->mute              = pi; pi += iSize;
+	pTable->solo              = pi; pi += iSize;
+	pTable->voice_count       = pi; pi += iSize;
+	pTable->stream_count      = pi; pi += iSize;
+	pStore->status   = pi; pi += iSize;
+	pStore->routings = pi; pi += iSize;
+	pStore->strings  = pi; pi += 3 * iSize;
+	pTable->volume = (float *) pi;
+
+	pTable->count = iRows;
+	for (i = 0; i < iRows; i++) {
+		pTable->channel[i]      = -1;
+		pTable->voice_count[i]  = -1;
+		pTable->stream_count[i] = -1;
+		pStore->status[i] = 0;
+	}
+
+	pStore->pool_len = 0;
+	pStore->routing_len = 0;
+	lscp_hash_free(&(pStore->interned));
+
+	return 0;
+}
+
+
+// Intern a string into the pool, returning its offset (-1 if NULL).
+// Strings are deduplicated by hash; colliding ones are just appended.
+static int _lscp_channel_store_intern ( lscp_channel_store_t *pStore,
+	const char *psz )
+{
+	char *pNewPool;
+	int64_t key;
+	int iPool, iSize, cch;
+
+	if (psz == NULL)
+		return -1;
+
+	key = _lscp_string_hash(psz);
+	iPool = (int) (intptr_t) lscp_hash_find(&(pStore->interned), key) - 1;
+	if (iPool >= 0 && strcmp(pStore->pool + iPool, psz) == 0)
+		return iPool;
+
+	cch = strlen(psz) + 1;
+	if (pStore->pool_len + cch > pStore->pool_size) {
+		iSize = (pStore->pool_size > 0 ? pStore->pool_size : 1024);
+		while (pStore->pool_len + cch > iSize)
+			iSize <<= 1;
+		pNewPool = (char *) realloc(pStore->pool, iSize);
+		if (pNewPool == NULL)
+			return -2;
+		pStore->pool = pNewPool;
+		pStore->pool_size = iSize;
+	}
+
+	iPool = pStore->pool_len;
+	memcpy(pStore->pool + iPool, psz, cch);
+	pStore->pool_len += cch;
+
+	if (lscp_hash_find(&(pStore->interned), key) == NULL)
+		lscp_hash_insert(&(pStore->interned), key, (void *) (intptr_t) (iPool + 1));
+
+	return iPool;
+}
+
+
+// Append a -1 terminated routing list to the pool, returning
+// its offset (-1 if none).
+static int _lscp_channel_store_routing ( lscp_channel_store_t *pStore,
+	const int *piRouting )
+{
+	int *pNewRouting;
+	int iRouting, iSize, n;
+
+	if (piRouting == NULL)
+		return -1;
+
+	for (n = 0; piRouting[n] >= 0; n++)
+		;
+	n++;
+
+	if (pStore->routing_len + n > pStore->routing_size) {
+		iSize = (pStore->routing_size > 0 ? pStore->routing_size : 256);
+		while (pStore->routing_len + n > iSize)
+			iSize <<= 1;
+		pNewRouting = (int *) realloc(pStore->routing, iSize * sizeof(int));
+		if (pNewRouting == NULL)
+			return -2;
+		pStore->routing = pNewRouting;
+		pStore->routing_size = iSize;
+	}
+
+	iRouting = pStore->routing_len;
+	memcpy(pStore->routing + iRouting, piRouting, n * sizeof(int));
+	pStore->routing_len += n;
+
+	return iRouting;
+}
+
+
+// Set a row from a freshly received channel info (texts are interned).
+int lscp_channel_store_set ( lscp_channel_store_t *pStore, int iRow,
+	lscp_channel_info_t *pChannelInfo )
+{
+	lscp_channel_table_t *pTable = &(pStore->table);
+	int *piStrings = &(pStore->strings[3 * iRow]);
+
+	piStrings[0] = _lscp_channel_store_intern(pStore, pChannelInfo->engine_name);
+	piStrings[1] = _lscp_channel_store_intern(pStore, pChannelInfo->instrument_file);
+	piStrings[2] = _lscp_channel_store_intern(pStore, pChannelInfo->instrument_name);
+	pStore->routings[iRow] = _lscp_channel_store_routing(pStore, pChannelInfo->audio_routing);
+	if (piStrings[0] < -1 || piStrings[1] < -1 || piStrings[2] < -1
+		|| pStore->routings[iRow] < -1)
+		return -1;
+
+	pTable->audio_device[iRow]      = pChannelInfo->audio_device;
+	pTable->audio_channels[iRow]    = pChannelInfo->audio_channels;
+	pTable->instrument_nr[iRow]     = pChannelInfo->instrument_nr;
+	pTable->instrument_status[iRow] = pChannelInfo->instrument_status;
+	pTable->midi_device[iRow]       = pChannelInfo->midi_device;
+	pTable->midi_port[iRow]         = pChannelInfo->midi_port;
+	pTable->midi_channel[iRow]      = pChannelInfo->midi_channel;
+	pTable->midi_map[iRow]          = pChannelInfo->midi_map;
+	pTable->volume[iRow]            = pChannelInfo->volume;
+	pTable->mute[iRow]              = pChannelInfo->mute;
+	pTable->solo[iRow]              = pChannelInfo->solo;
+
+	pStore->status[iRow] = 1;
+
+	return 0;
+}
+
+
+// Finish off the table: rows not set (eg. channels gone meanwhile)
+// are dropped, text and routing pointers resolved into the pools
+// and the sampler channel to row index rebuilt.
+int lscp_channel_store_commit ( lscp_channel_store_t *pStore )
+{
+	lscp_channel_table_t *pTable = &(pStore->table);
+	int *piStrings;
+	int i, j;
+
+	for (i = 0, j = 0; i < pTable->count; i++) {
+		if (!pStore->status[i])
+			continue;
+		if (j < i) {
+			pTable->channel[j]           = pTable->channel[i];
+			pTable->audio_device[j]      = pTable->audio_device[i];
+			pTable->audio_channels[j]    = pTable->audio_channels[i];
+			pTable->instrument_nr[j]     = pTable->instrument_nr[i];
+			pTable->instrument_status[j] = pTable->instrument_status[i];
+			pTable->midi_device[j]       = pTable->midi_device[i];
+			pTable->midi_port[j]         = pTable->midi_port[i];
+			pTable->midi_channel[j]      = pTable->midi_channel[i];
+			pTable->midi_map[j]          = pTable->midi_map[i];
+			pTable->volume[j]            = pTable->volume[i];
+			pTable->mute[j]              = pTable->mute[i];
+			pTable->solo[j]              = pTable->solo[i];
+			pTable->voice_count[j]       = pTable->voice_count[i];
+			pTable->stream_count[j]      = pTable->stream_count[i];
+			pStore->routings[j]          = pStore->routings[i];
+			memcpy(&(pStore->strings[3 * j]), &(pStore->strings[3 * i]),
+				3 * sizeof(int));
+		}
+		piStrings = &(pStore->strings[3 * j]);
+		pTable->engine_name[j] = (piStrings[0] < 0 ? NULL
+			: pStore->pool + piStrings[0]);
+		pTable->instrument_file[j] = (piStrings[1] < 0 ? NULL
+			: pStore->pool + piStrings[1]);
+		pTable->instrument_name[j] = (piStrings[2] < 0 ? NULL
+			: pStore->pool + piStrings[2]);
+		pTable->audio_routing[j] = (pStore->routings[j] < 0 ? NULL
+			: pStore->routing + pStore->routings[j]);
+		j++;
+	}
+	pTable->count = j;
+
+	// Sampler channel to row index (channels are sparse)...
+	lscp_hash_free(&(pStore->rows));
+	pTable->row_index = &(pStore->rows);
+	for (i = 0; i < pTable->count; i++) {
+		if (lscp_hash_insert(&(pStore->rows), pTable->channel[i],
+				(void *) (intptr_t) (i + 1)) < 0) {
+			lscp_hash_free(&(pStore->rows));
+			return -1;
+		}
+	}
+
+	return 0;
+}
+
+
+//-------------------------------------------------------------------------
+// Live meter table helper functions (sequence locked).
+
+// Reset a meter to its not yet notified state.
+static void _lscp_meter_item_clear ( lscp_channel_meter_t *pMeter )
+{
+	pMeter->voice_count     = -1;
+	pMeter->stream_count    = -1;
+	pMeter->fill_count      = -1;
+	pMeter->fill_percentage = 0;
+	pMeter->fill_min        = 0;
+	pMeter->fill_max        = 0;
+	pMeter->serial          = 0;
+}
+
+
+// Get the meter item of a sampler channel, optionally
+// allocating its block (writers only); NULL if out of range.
+static lscp_meter_item_t *_lscp_meter_table_item ( lscp_meter_table_t *pMeters,
+	int iSamplerChannel, int iCreate )
+{
+	lscp_meter_item_t *pBlock;
+	int iBlock, i;
+
+	if (iSamplerChannel < 0
+		|| iSamplerChannel >= LSCP_METER_BLOCKS * LSCP_METER_BLOCK_SIZE)
+		return NULL;
+
+	iBlock = iSamplerChannel / LSCP_METER_BLOCK_SIZE;
+	pBlock = pMeters->blocks[iBlock];
+	if (pBlock == NULL && iCreate) {
+		pBlock = (lscp_meter_item_t *)
+			malloc(LSCP_METER_BLOCK_SIZE * sizeof(lscp_meter_item_t));
+		if (pBlock == NULL)
+			return NULL;
+		for (i = 0; i < LSCP_METER_BLOCK_SIZE; i++) {
+			pBlock[i].seq = 0;
+			_lscp_meter_item_clear(&(pBlock[i].meter));
+		}
+		// Publish the block only after it's fully initialized.
+		_lscp_atomic_barrier();
+		pMeters->blocks[iBlock] = pBlock;
+	}
+
+	if (pBlock == NULL)
+		return NULL;
+
+	return &pBlock[iSamplerChannel % LSCP_METER_BLOCK_SIZE];
+}
+
+
+void lscp_meter_table_init ( lscp_meter_table_t *pMeters )
+{
+	int i;
+
+	pMeters->enabled = 0;
+	pMeters->events  = LSCP_EVENT_NONE;
+	pMeters->total_voice_count = -1;
+
+	for (i = 0; i < LSCP_METER_BLOCKS; i++)
+		pMeters->blocks[i] = NULL;
+
+	lscp_mutex_init(pMeters->mutex);
+}
+
+void lscp_meter_table_free ( lscp_meter_table_t *pMeters )
+{
+	int i;
+
+	for (i = 0; i < LSCP_METER_BLOCKS; i++) {
+		if (pMeters->blocks[i])
+			free(pMeters->blocks[i]);
+		pMeters->blocks[i] = NULL;
+	}
+
+	lscp_mutex_destroy(pMeters->mutex);
+}
+
+// Turn all meters back to not yet notified (blocks are kept).
+void lscp_meter_table_reset ( lscp_meter_table_t *pMeters )
+{
+	lscp_meter_item_t *pBlock;
+	int iBlock, i;
+
+	lscp_mutex_lock(pMeters->mutex);
+
+	for (iBlock = 0; iBlock < LSCP_METER_BLOCKS; iBlock++) {
+		pBlock = pMeters->blocks[iBlock];
+		if (pBlock == NULL)
+			continue;
+		for (i = 0; i < LSCP_METER_BLOCK_SIZE; i++) {
+			if (pBlock[i].seq == 0)
+				continue;
+			pBlock[i].seq++;
+			_lscp_atomic_barrier();
+			_lscp_meter_item_clear(&(pBlock[i].meter));
+			_lscp_atomic_barrier();
+			pBlock[i].seq++;
+		}
+	}
+
+	pMeters->total_voice_count = -1;
+
+	lscp_mutex_unlock(pMeters->mutex);
+}
+
+// Update meters from a decoded event notification
+// (called from the event service thread).
+void lscp_meter_table_update ( lscp_meter_table_t *pMeters,
+	const lscp_event_data_t *pEventData )
+{
+	lscp_channel_meter_t *pMeter;
+	lscp_meter_item_t *pItem;
+	int i;
+
+	if (pEventData->event == LSCP_EVENT_TOTAL_VOICE_COUNT) {
+		pMeters->total_voice_count = pEventData->count;
+		return;
+	}
+
+	lscp_mutex_lock(pMeters->mutex);
+
+	pItem = _lscp_meter_table_item(pMeters, pEventData->channel, 1);
+	if (pItem) {
+		// Odd sequence: readers shall retry...
+		pItem->seq++;
+		_lscp_atomic_barrier();
+		pMeter = &(pItem->meter);
+		switch (pEventData->event) {
+		case LSCP_EVENT_VOICE_COUNT:
+			pMeter->voice_count = pEventData->count;
+			break;
+		case LSCP_EVENT_STREAM_COUNT:
+			pMeter->stream_count = pEventData->count;
+			break;
+		case LSCP_EVENT_BUFFER_FILL:
+			pMeter->fill_count = pEventData->fill_count;
+			pMeter->fill_percentage = pEventData->fill_percentage;
+			pMeter->fill_min = 0;
+			pMeter->fill_max = 0;
+			for (i = 0; i < pEventData->fill_count; i++) {
+				if (i == 0 || pMeter->fill_min > pEventData->fill[i].stream_usage)
+					pMeter->fill_min = pEventData->fill[i].stream_usage;
+				if (i == 0 || pMeter->fill_max < pEventData->fill[i].stream_usage)
+					pMeter->fill_max = pEventData->fill[i].stream_usage;
+			}
+			break;
+		default:
+			break;
+		}
+		// Even sequence: consistent again.
+		_lscp_atomic_barrier();
+		pItem->seq++;
+	}
+
+	lscp_mutex_unlock(pMeters->mutex);
+}
+
+// Read a consistent copy of a sampler channel meter, lock-free;
+// returns 0 on success, -1 if nothing was ever notified for it.
+int lscp_meter_table_read ( lscp_meter_table_t *pMeters,
+	int iSamplerChannel, lscp_channel_meter_t *pMeter )
+{
+	lscp_meter_item_t *pItem;
+	unsigned int seq;
+
+	pItem = _lscp_meter_table_item(pMeters, iSamplerChannel, 0);
+	if (pItem == NULL)
+		return -1;
+
+	do {
+		// Wait for any writer in progress...
+		while ((seq = pItem->seq) & 1)
+			;
+		_lscp_atomic_barrier();
+		*pMeter = pItem->meter;
+		_lscp_atomic_barrier();
+	} while (seq != pItem->seq);
+
+	if (seq == 0)
+		return -1;
+
+	pMeter->serial = (seq >> 1);
+
+	return 0;
+}
+
+
+//-------------------------------------------------------------------------
+// Telemetry time-series helper functions.
+
+// Wall clock, for telemetry and conflation (msecs, wrapping around).
+static unsigned int _lscp_clock_msecs (void)
+{
+	struct timeval tv;
+
+	gettimeofday(&tv, NULL);
+
+	return (unsigned int) ((uint64_t) tv.tv_sec * 1000 + tv.tv_usec / 1000);
+}
+
+
+// Telemetry series key (sampler channel and stream id).
+#define _lscp_telemetry_key(ch, id) \
+	((int64_t) (((uint64_t) (unsigned int) (ch) << 32) | (unsigned int) (id)))
+
+// Latest raw sample of a series (there's always one).
+#define _lscp_telemetry_last(s) \
+	(&((s)->raw[((s)->head + LSCP_TELEMETRY_RAW - 1) % LSCP_TELEMETRY_RAW]))
+
+
+// Find a series, creating it if not found; when full, the least recently
+// updated one gets recycled (caller must own the telemetry mutex).
+static lscp_telemetry_series_t *_lscp_telemetry_series (
+	lscp_telemetry_t *pTelemetry, int iSamplerChannel, unsigned int iStreamId,
+	unsigned int now )
+{
+	lscp_telemetry_series_t *pSeries, *pOldSeries;
+	int64_t key, iOldKey = 0;
+	unsigned int iAge, iOldAge = 0;
+	int i;
+
+	key = _lscp_telemetry_key(iSamplerChannel, iStreamId);
+	pSeries = (lscp_telemetry_series_t *) lscp_hash_find(&(pTelemetry->series), key);
+	if (pSeries)
+		return pSeries;
+
+	if (pTelemetry->series.count >= LSCP_TELEMETRY_SERIES) {
+		pOldSeries = NULL;
+		for (i = 0; i < pTelemetry->series.size; i++) {
+			pSeries = (lscp_telemetry_series_t *) pTelemetry->series.values[i];
+			if (pSeries == NULL)
+				continue;
+			iAge = now - _lscp_telemetry_last(pSeries)->time;
+			if (pOldSeries == NULL || iOldAge < iAge) {
+				pOldSeries = pSeries;
+				iOldKey = pTelemetry->series.keys[i];
+				iOldAge = iAge;
+			}
+		}
+		pSeries = (lscp_telemetry_series_t *)
+			lscp_hash_remove(&(pTelemetry->series), iOldKey);
+	} else {
+		pSeries = (lscp_telemetry_series_t *)
+			malloc(sizeof(lscp_telemetry_series_t));
+	}
+
+	if (pSeries == NULL)
+		return NULL;
+
+	memset(pSeries, 0, sizeof(lscp_telemetry_series_t));
+	pSeries->channel = iSamplerChannel;
+	pSeries->stream  = iStreamId;
+
+	if (lscp_hash_insert(&(pTelemetry->series), key, pSeries) < 0) {
+		free(pSeries);
+		return NULL;
+	}
+
+	return pSeries;
+}
+
+
+// Record a new sample, into the raw samples ring and the open bucket of
+// every downsampled tier, closing it first if its time span is over.
+static void _lscp_telemetry_record ( lscp_telemetry_series_t *pSeries,
+	unsigned int now, unsigned long value )
+{
+	lscp_telemetry_tier_t *pTier;
+	lscp_telemetry_sample_t *pSample;
+	unsigned int iSpan, iStart, v;
+	int t;
+
+	if (value > (0xffffffffUL / LSCP_TELEMETRY_SCALE))
+		value = (0xffffffffUL / LSCP_TELEMETRY_SCALE);
+	v = (unsigned int) value * LSCP_TELEMETRY_SCALE;
+
+	pSample = &(pSeries->raw[pSeries->head]);
+	pSample->time  = now;
+	pSample->value = v;
+	pSeries->head = (pSeries->head + 1) % LSCP_TELEMETRY_RAW;
+	if (pSeries->count < LSCP_TELEMETRY_RAW)
+		pSeries->count++;
+
+	iSpan = LSCP_TELEMETRY_SPAN;
+	for (t = 0; t < LSCP_TELEMETRY_TIERS; t++) {
+		pTier = &(pSeries->tiers[t]);
+		iStart = now - (now % iSpan);
+		if (pTier->open.count > 0 && pTier->open.time != iStart) {
+			pTier->buckets[pTier->head] = pTier->open;
+			pTier->head = (pTier->head + 1) % LSCP_TELEMETRY_BUCKETS;
+			if (pTier->count < LSCP_TELEMETRY_BUCKETS)
+				pTier->count++;
+			pTier->open.count = 0;
+		}
+		if (pTier->open.count == 0) {
+			pTier->open.time = iStart;
+			pTier->open.min  = v;
+			pTier->open_sum  = 0;
+		}
+		if (pTier->open.min > v)
+			pTier->open.min = v;
+		pTier->open_sum += v;
+		pTier->open.count++;
+		pTier->open.mean = (unsigned int) (pTier->open_sum / pTier->open.count);
+		iSpan *= LSCP_TELEMETRY_SPAN_X;
+	}
+}
+
+
+// Statistics accumulator (times relative to the window start).
+typedef struct _lscp_telemetry_acc_t
+{
+	int      points;
+	unsigned int min;
+	double   sum, weight;
+	double   sx, sy, sxx, sxy;
+
+} lscp_telemetry_acc_t;
+
+static void _lscp_telemetry_acc_add ( lscp_telemetry_acc_t *pAcc,
+	int x, unsigned int min, unsigned int mean, unsigned int count )
+{
+	if (pAcc->points == 0 || pAcc->min > min)
+		pAcc->min = min;
+
+	pAcc->sum    += (double) mean * count;
+	pAcc->weight += (double) count;
+
+	pAcc->sx  += (double) x;
+	pAcc->sy  += (double) mean;
+	pAcc->sxx += (double) x * x;
+	pAcc->sxy += (double) x * mean;
+	pAcc->points++;
+}
+
+
+// Compute statistics over the last iWindow msecs, off the finest resolution
+// that covers it all, or else the one reaching the furthest back in time
+// (coarser ones are only looked at once finer ones have wrapped around);
+// slope is the least squares fit (caller must own the telemetry mutex).
+static void _lscp_telemetry_series_stats ( lscp_telemetry_series_t *pSeries,
+	unsigned int now, int iWindow, lscp_telemetry_stats_t *pStats )
+{
+	lscp_telemetry_acc_t acc;
+	lscp_telemetry_tier_t *pTier;
+	lscp_telemetry_sample_t *pSample;
+	lscp_telemetry_bucket_t *pBucket;
+	unsigned int iStart, iSpan, iOldest;
+	int iReach, iFull, iTier, iSpanTier = 0;
+	double d;
+	int i, t;
+
+	iStart = now - (unsigned int) iWindow;
+
+	// Pick the time-series resolution...
+	iTier = -1;
+	iSpan = LSCP_TELEMETRY_SPAN;
+	pSample = &(pSeries->raw[(pSeries->head + LSCP_TELEMETRY_RAW
+		- pSeries->count) % LSCP_TELEMETRY_RAW]);
+	iReach = (int) (now - pSample->time);
+	iFull = (pSeries->count == LSCP_TELEMETRY_RAW);
+	for (t = 0; iFull && iReach < iWindow && t < LSCP_TELEMETRY_TIERS; t++) {
+		pTier = &(pSeries->tiers[t]);
+		iOldest = pTier->open.time;
+		if (pTier->count > 0) {
+			iOldest = pTier->buckets[(pTier->head + LSCP_TELEMETRY_BUCKETS
+				- pTier->count) % LSCP_TELEMETRY_BUCKETS].time;
+		}
+		iFull = (pTier->count == LSCP_TELEMETRY_BUCKETS);
+		if ((int) (now - iOldest) > iReach) {
+			iReach = (int) (now - iOldest);
+			iTier = t;
+			iSpanTier = (int) iSpan;
+		}
+		iSpan *= LSCP_TELEMETRY_SPAN_X;
+	}
+
+	memset(&acc, 0, sizeof(acc));
+
+	if (iTier < 0) {
+		for (i = 0; i < pSeries->count; i++) {
+			pSample = &(pSeries->raw[(pSeries->head + LSCP_TELEMETRY_RAW
+				- pSeries->count + i) % LSCP_TELEMETRY_RAW]);
+			if ((int) (pSample->time - iStart) < 0)
+				continue;
+			_lscp_telemetry_acc_add(&acc, (int) (pSample->time - iStart),
+				pSample->value, pSample->value, 1);
+		}
+	} else {
+		// Buckets are taken at their middle time...
+		pTier = &(pSeries->tiers[iTier]);
+		for (i = 0; i <= pTier->count; i++) {
+			if (i < pTier->count) {
+				pBucket = &(pTier->buckets[(pTier->head + LSCP_TELEMETRY_BUCKETS
+					- pTier->count + i) % LSCP_TELEMETRY_BUCKETS]);
+			} else {
+				pBucket = &(pTier->open);
+			}
+			if (pBucket->count < 1
+				|| (int) (pBucket->time + iSpanTier - iStart) <= 0)
+				continue;
+			_lscp_telemetry_acc_add(&acc,
+				(int) (pBucket->time - iStart) + (iSpanTier >> 1),
+				pBucket->min, pBucket->mean, pBucket->count);
+		}
+	}
+
+	pSample = _lscp_telemetry_last(pSeries);
+	pStats->samples = acc.points;
+	pStats->last  = (float) pSample->value / LSCP_TELEMETRY_SCALE;
+	pStats->age   = (int) (now - pSample->time);
+	pStats->min   = pStats->last;
+	pStats->mean  = pStats->last;
+	pStats->slope = 0.0f;
+
+	if (acc.points > 0) {
+		pStats->min  = (float) acc.min / LSCP_TELEMETRY_SCALE;
+		pStats->mean = (float) (acc.sum / acc.weight) / LSCP_TELEMETRY_SCALE;
+	}
+
+	if (acc.points > 1) {
+		d = acc.points * acc.sxx - acc.sx * acc.sx;
+		if (d > 0.0) {
+			pStats->slope = (float) (1000.0 * (acc.points * acc.sxy
+				- acc.sx * acc.sy) / d) / LSCP_TELEMETRY_SCALE;
+		}
+	}
+}
+
+
+// Check whether a disk stream buffer is trending to underrun within
+// the prediction horizon, latching the alert until it's no longer so
+// (caller must own the telemetry mutex); returns 1 if newly raised.
+static int _lscp_telemetry_predict ( lscp_telemetry_t *pTelemetry,
+	lscp_telemetry_series_t *pSeries, unsigned int now,
+	lscp_telemetry_alert_t *pAlert )
+{
+	lscp_telemetry_stats_t *pStats = &(pAlert->stats);
+	float fEta;
+	int iImminent = 0;
+
+	_lscp_telemetry_series_stats(pSeries, now, pTelemetry->horizon, pStats);
+	if (pStats->samples >= LSCP_TELEMETRY_TREND && pStats->slope < 0.0f) {
+		fEta = (pStats->last - pTelemetry->threshold) / -(pStats->slope);
+		pAlert->eta = (fEta > 0.0f ? (int) (1000.0f * fEta) : 0);
+		iImminent = (pAlert->eta <= pTelemetry->horizon);
+	}
+
+	if (!iImminent) {
+		pSeries->alert = 0;
+		return 0;
+	}
+
+	if (pSeries->alert)
+		return 0;
+
+	pSeries->alert = 1;
+	pAlert->channel = pSeries->channel;
+	pAlert->stream  = pSeries->stream;
+
+	return 1;
+}
+
+
+void lscp_telemetry_init ( lscp_telemetry_t *pTelemetry )
+{
+	pTelemetry->enabled = 0;
+	pTelemetry->events  = LSCP_EVENT_NONE;
+
+	lscp_hash_init(&(pTelemetry->series));
+
+	pTelemetry->pfnUnderrun = NULL;
+	pTelemetry->pvUnderrun  = NULL;
+	pTelemetry->horizon     = 0;
+	pTelemetry->threshold   = 0.0f;
+
+	lscp_mutex_init(pTelemetry->mutex);
+}
+
+void lscp_telemetry_free ( lscp_telemetry_t *pTelemetry )
+{
+	lscp_telemetry_reset(pTelemetry);
+
+	lscp_mutex_destroy(pTelemetry->mutex);
+}
+
+// Drop all recorded series.
+void lscp_telemetry_reset ( lscp_telemetry_t *pTelemetry )
+{
+	int i;
+
+	lscp_mutex_lock(pTelemetry->mutex);
+
+	for (i = 0; i < pTelemetry->series.size; i++) {
+		if (pTelemetry->series.values[i])
+			free(pTelemetry->series.values[i]);
+	}
+
+	lscp_hash_free(&(pTelemetry->series));
+
+	lscp_mutex_unlock(pTelemetry->mutex);
+}
+
+// Record disk stream buffer fill samples (in percentage) of a sampler
+// channel, as notified or polled; underrun alerts newly raised are
+// returned, to be notified later; returns the number of alerts.
+int lscp_telemetry_fill ( lscp_telemetry_t *pTelemetry, int iSamplerChannel,
+	const lscp_buffer_fill_t *pFill, int iFillCount,
+	lscp_telemetry_alert_t *pAlerts )
+{
+	lscp_telemetry_series_t *pSeries;
+	unsigned int now;
+	int iAlerts = 0;
+	int i;
+
+	if (iSamplerChannel < 0 || pFill == NULL)
+		return 0;
+
+	now = _lscp_clock_msecs();
+
+	lscp_mutex_lock(pTelemetry->mutex);
+
+	for (i = 0; i < iFillCount; i++) {
+		if (pFill[i].stream_id == LSCP_TELEMETRY_VOICES)
+			continue;
+		pSeries = _lscp_telemetry_series(pTelemetry,
+			iSamplerChannel, pFill[i].stream_id, now);
+		if (pSeries == NULL)
+			continue;
+		_lscp_telemetry_record(pSeries, now, pFill[i].stream_usage);
+		if (pTelemetry->pfnUnderrun && iAlerts < LSCP_TELEMETRY_ALERTS
+			&& _lscp_telemetry_predict(pTelemetry, pSeries, now, &pAlerts[iAlerts]))
+			iAlerts++;
+	}
+
+	lscp_mutex_unlock(pTelemetry->mutex);
+
+	return iAlerts;
+}
+
+// Record from a decoded event notification (called from
+// the event service thread); returns the number of alerts.
+int lscp_telemetry_update ( lscp_telemetry_t *pTelemetry,
+	const lscp_event_data_t *pEventData, lscp_telemetry_alert_t *pAlerts )
+{
+	lscp_telemetry_series_t *pSeries;
+	unsigned int now;
+
+	if (pEventData->channel < 0)
+		return 0;
+
+	switch (pEventData->event) {
+	case LSCP_EVENT_BUFFER_FILL:
+		// Byte counts can't tell how full the buffers are...
+		if (!pEventData->fill_percentage)
+			break;
+		return lscp_telemetry_fill(pTelemetry, pEventData->channel,
+			pEventData->fill, pEventData->fill_count, pAlerts);
+	case LSCP_EVENT_VOICE_COUNT:
+		if (pEventData->count < 0)
+			break;
+		lscp_mutex_lock(pTelemetry->mutex);
+		now = _lscp_clock_msecs();
+		pSeries = _lscp_telemetry_series(pTelemetry,
+			pEventData->channel, LSCP_TELEMETRY_VOICES, now);
+		if (pSeries)
+			_lscp_telemetry_record(pSeries, now, (unsigned long) pEventData->count);
+		lscp_mutex_unlock(pTelemetry->mutex);
+		break;
+	default:
+		break;
+	}
+
+	return 0;
+}
+
+// Notify underrun alerts, if still applicable (no locks held).
+void lscp_telemetry_notify ( lscp_client_t *pClient,
+	const lscp_telemetry_alert_t *pAlerts, int iAlerts )
+{
+	lscp_telemetry_t *pTelemetry = &(pClient->telemetry);
+	lscp_client_underrun_proc_t pfnUnderrun;
+	void *pvUnderrun;
+	int i;
+
+	lscp_mutex_lock(pTelemetry->mutex);
+	pfnUnderrun = pTelemetry->pfnUnderrun;
+	pvUnderrun  = pTelemetry->pvUnderrun;
+	lscp_mutex_unlock(pTelemetry->mutex);
+
+	for (i = 0; pfnUnderrun && i < iAlerts; i++) {
+		(*pfnUnderrun)(pClient, pAlerts[i].channel, pAlerts[i].stream,
+			&(pAlerts[i].stats), pAlerts[i].eta, pvUnderrun);
+	}
+}
+
+// Get statistics of a series over the last iWindow msecs;
+// returns 0 on success, -1 if nothing was ever recorded for it.
+int lscp_telemetry_stats ( lscp_telemetry_t *pTelemetry,
+	int iSamplerChannel, unsigned int iStreamId, int iWindow,
+	lscp_telemetry_stats_t *pStats )
+{
+	lscp_telemetry_series_t *pSeries;
+	int iResult = -1;
+
+	if (iSamplerChannel < 0 || iWindow < 0)
+		return -1;
+
+	lscp_mutex_lock(pTelemetry->mutex);
+
+	pSeries = (lscp_telemetry_series_t *) lscp_hash_find(&(pTelemetry->series),
+		_lscp_telemetry_key(iSamplerChannel, iStreamId));
+	if (pSeries) {
+		_lscp_telemetry_series_stats(pSeries, _lscp_clock_msecs(),
+			iWindow, pStats);
+		iResult = 0;
+	}
+
+	lscp_mutex_unlock(pTelemetry->mutex);
+
+	return iResult;
+}
+
+
+//-------------------------------------------------------------------------
+// Event conflation helper functions.
+
+// Conflation key (event and sampler channel).
+#define _lscp_conflate_key(ev, ch) \
+	((int64_t) (((uint64_t) (unsigned int) (ev) << 32) | (unsigned int) (ch)))
+
+
+void lscp_conflate_init ( lscp_conflate_t *pConflate )
+{
+	pConflate->events   = LSCP_EVENT_NONE;
+	pConflate->interval = 0;
+	lscp_hash_init(&(pConflate->items));
+	pConflate->first    = NULL;
+	pConflate->last     = NULL;
+	pConflate->flushed  = 0;
+	pConflate->flushing = 0;
+}
+
+void lscp_conflate_free ( lscp_conflate_t *pConflate )
+{
+	lscp_conflate_item_t *pItem;
+	int i;
+
+	for (i = 0; i < pConflate->items.size; i++) {
+		pItem = (lscp_conflate_item_t *) pConflate->items.values[i];
+		if (pItem == NULL)
+			continue;
+		if (pItem->text)
+			free(pItem->text);
+		free(pItem);
+	}
+
+	lscp_hash_free(&(pConflate->items));
+
+	pConflate->first    = NULL;
+	pConflate->last     = NULL;
+	pConflate->flushing = 0;
+}
+
+
+// Keep the newest data of a conflated event, in place of any still
+// pending for the same key; returns 0 if kept for later, -1 if it's
+// to be delivered right away (not conflated or out of memory).
+int lscp_conflate_event ( lscp_conflate_t *pConflate,
+	lscp_event_t event, const char *pchData, int cchData )
+{
+	lscp_conflate_item_t *pItem;
+	int64_t key;
+	char *pchText;
+	int iSize;
+
+	if ((pConflate->events & event) == 0 || pConflate->interval < 1)
+		return -1;
+
+	if (pchData == NULL)
+		cchData = 0;
+
+	// All but the total voice count are per sampler channel...
+	if (event == LSCP_EVENT_TOTAL_VOICE_COUNT || cchData < 1)
+		key = _lscp_conflate_key(event, 0);
+	else
+		key = _lscp_conflate_key(event, lscp_atoi(pchData));
+
+	pItem = (lscp_conflate_item_t *) lscp_hash_find(&(pConflate->items), key);
+	if (pItem == NULL) {
+		pItem = (lscp_conflate_item_t *) malloc(sizeof(lscp_conflate_item_t));
+		if (pItem == NULL)
+			return -1;
+		pItem->event     = event;
+		pItem->text      = NULL;
+		pItem->text_len  = 0;
+		pItem->text_size = 0;
+		pItem->pending   = 0;
+		pItem->next      = NULL;
+		if (lscp_hash_insert(&(pConflate->items), key, pItem) < 0) {
+			free(pItem);
+			return -1;
+		}
+	}
+
+	if (cchData + 1 > pItem->text_size) {
+		iSize = (pItem->text_size > 0 ? pItem->text_size : 64);
+		while (cchData + 1 > iSize)
+			iSize <<= 1;
+		pchText = (char *) realloc(pItem->text, iSize);
+		if (pchText == NULL)
+			return -1;
+		pItem->text = pchText;
+		pItem->text_size = iSize;
+	}
+	if (cchData > 0)
+		memcpy(pItem->text, pchData, cchData);
+	pItem->text[cchData] = '\0';
+	pItem->text_len = cchData;
+
+	// Queue it up, if not already...
+	if (!pItem->pending) {
+		pItem->pending = 1;
+		if (pConflate->last)
+			pConflate->last->next = pItem;
+		else
+			pConflate->first = pItem;
+		pConflate->last = pItem;
+	}
+
+	return 0;
+}
+
+
+// Msecs until pending items are due, zero if already,
+// -1 if there's none pending.
+int lscp_conflate_due ( lscp_conflate_t *pConflate )
+{
+	unsigned int iElapsed;
+	int iInterval;
+
+	if (pConflate->first == NULL)
+		return -1;
+	if (pConflate->flushing)
+		return 0;
+
+	iInterval = pConflate->interval;
+	iElapsed  = _lscp_clock_msecs() - pConflate->flushed;
+	if (iInterval < 1 || iElapsed >= (unsigned int) iInterval)
+		return 0;
+
+	return iInterval - (int) iElapsed;
+}
+
+
+// Take the next pending item, if due; its data stays valid
+// until the same key is conflated again.
+lscp_conflate_item_t *lscp_conflate_take ( lscp_conflate_t *pConflate )
+{
+	lscp_conflate_item_t *pItem = pConflate->first;
+
+	if (pItem == NULL) {
+		pConflate->flushing = 0;
+		return NULL;
+	}
+
+	// Start flushing all that's pending, if due...
+	if (!pConflate->flushing) {
+		if (lscp_conflate_due(pConflate) != 0)
+			return NULL;
+		pConflate->flushing = 1;
+		pConflate->flushed  = _lscp_clock_msecs();
+	}
+
+	pConflate->first = pItem->next;
+	if (pConflate->first == NULL)
+		pConflate->last = NULL;
+
+	pItem->next    = NULL;
+	pItem->pending = 0;
+
+	return pItem;
+}
+
+
+//-------------------------------------------------------------------------
+// Event handler registry helper functions.
+
+// Handler chain key (event and id, zero for any).
+#define _lscp_handler_key(ev, id) \
+	((int64_t) (((uint64_t) (unsigned int) (ev) << 32) | (unsigned int) ((id) + 1)))
+
+
+// Event bit index, -1 if not a single event.
+static int _lscp_handler_index ( lscp_event_t event )
+{
+	int i;
+
+	if (event == LSCP_EVENT_NONE || (event & (event - 1)))
+		return -1;
+
+	for (i = 0; (event >> i) != 1; i++)
+		;
+
+	return i;
+}
+
+
+// The sampler channel, device or map an event is about, -1 if none.
+static int _lscp_handler_id ( const lscp_event_data_t *pEventData )
+{
+	if (pEventData->channel >= 0)
+		return pEventData->channel;
+	if (pEventData->device >= 0)
+		return pEventData->device;
+
+	return pEventData->map;
+}
+
+
+void lscp_handler_table_init ( lscp_handler_table_t *pTable )
+{
+	int i;
+
+	pTable->events = LSCP_EVENT_NONE;
+	pTable->registered = LSCP_EVENT_NONE;
+	lscp_hash_init(&(pTable->chains));
+	lscp_hash_init(&(pTable->handles));
+	pTable->next_handle = 0;
+	for (i = 0; i < 32; i++)
+		pTable->counts[i] = 0;
+	lscp_mutex_init(pTable->mutex);
+}
+
+void lscp_handler_table_free ( lscp_handler_table_t *pTable )
+{
+	int i;
+
+	for (i = 0; i < pTable->handles.size; i++) {
+		if (pTable->handles.values[i])
+			free(pTable->handles.values[i]);
+	}
+
+	lscp_hash_free(&(pTable->handles));
+	lscp_hash_free(&(pTable->chains));
+
+	lscp_mutex_destroy(pTable->mutex);
+}
+
+
+// Register a handler at the end of its chain;
+// returns its handle, -1 on failure.
+int lscp_handler_table_add ( lscp_handler_table_t *pTable,
+	lscp_event_t event, int iId, lscp_client_event_proc_t pfnHandler,
+	void *pvData )
+{
+	lscp_handler_t *pHandler, *pChain;
+	int64_t key;
+	int i;
+
+	i = _lscp_handler_index(event);
+	if (i < 0 || iId < -1 || pfnHandler == NULL)
+		return -1;
+
+	pHandler = (lscp_handler_t *) malloc(sizeof(lscp_handler_t));
+	if (pHandler == NULL)
+		return -1;
+
+	pHandler->event      = event;
+	pHandler->id         = iId;
+	pHandler->pfnHandler = pfnHandler;
+	pHandler->pvData     = pvData;
+	pHandler->next       = NULL;
+
+	key = _lscp_handler_key(event, iId);
+
+	lscp_mutex_lock(pTable->mutex);
+
+	// Handles are never reused (well, not before wrapping around)...
+	do {
+		if (++(pTable->next_handle) < 1)
+			pTable->next_handle = 1;
+	} while (lscp_hash_find(&(pTable->handles), pTable->next_handle));
+	pHandler->handle = pTable->next_handle;
+
+	if (lscp_hash_insert(&(pTable->handles), pHandler->handle, pHandler) < 0) {
+		lscp_mutex_unlock(pTable->mutex);
+		free(pHandler);
+		return -1;
+	}
+
+	pChain = (lscp_handler_t *) lscp_hash_find(&(pTable->chains), key);
+	if (pChain) {
+		while (pChain->next)
+			pChain = pChain->next;
+		pChain->next = pHandler;
+	}
+	else if (lscp_hash_insert(&(pTable->chains), key, pHandler) < 0) {
+		lscp_hash_remove(&(pTable->handles), pHandler->handle);
+		lscp_mutex_unlock(pTable->mutex);
+		free(pHandler);
+		return -1;
+	}
+
+	pTable->counts[i]++;
+	pTable->registered |= event;
+
+	lscp_mutex_unlock(pTable->mutex);
+
+	return pHandler->handle;
+}
+
+
+// Unregister a handler; returns its event, none if not found.
+lscp_event_t lscp_handler_table_remove ( lscp_handler_table_t *pTable,
+	int iHandle )
+{
+	lscp_handler_t *pHandler, *pChain;
+	lscp_event_t event;
+	int64_t key;
+
+	lscp_mutex_lock(pTable->mutex);
+
+	pHandler = (lscp_handler_t *) lscp_hash_remove(&(pTable->handles), iHandle);
+	if (pHandler == NULL) {
+		lscp_mutex_unlock(pTable->mutex);
+		return LSCP_EVENT_NONE;
+	}
+
+	key = _lscp_handler_key(pHandler->event, pHandler->id);
+	pChain = (lscp_handler_t *) lscp_hash_find(&(pTable->chains), key);
+	if (pChain == pHandler) {
+		if (pHandler->next)
+			lscp_hash_insert(&(pTable->chains), key, pHandler->next);
+		else
+			lscp_hash_remove(&(pTable->chains), key);
+	} else {
+		while (pChain && pChain->next != pHandler)
+			pChain = pChain->next;
+		if (pChain)
+			pChain->next = pHandler->next;
+	}
+
+	event = pHandler->event;
+	if (--(pTable->counts[_lscp_handler_index(event)]) < 1)
+		pTable->registered &= ~event;
+
+	lscp_mutex_unlock(pTable->mutex);
+
+	free(pHandler);
+
+	return event;
+}
+
+
+// Number of handlers registered for an event.
+int lscp_handler_table_count ( lscp_handler_table_t *pTable,
+	lscp_event_t event )
+{
+	int i = _lscp_handler_index(event);
+
+	return (i < 0 ? 0 : pTable->counts[i]);
+}
+
+
+// Invoke all handlers registered for the event and its sampler channel,
+// device or map, then the ones for any; returns the first non-OK status.
+// The chains are copied under the lock, and the handlers invoked without
+// it, so these may (un)register handlers themselves; the ones meanwhile
+// unregistered are skipped.
+lscp_status_t lscp_handler_table_dispatch ( lscp_handler_table_t *pTable,
+	lscp_client_t *pClient, const lscp_event_data_t *pEventData )
+{
+	lscp_handler_t handlers[LSCP_HANDLER_COPIES];
+	lscp_handler_t *pHandlers = handlers;
+	lscp_handler_t *pNewHandlers;
+	lscp_handler_t *pHandler;
+	lscp_status_t ret = LSCP_OK;
+	lscp_status_t st;
+	int iHandlers = 0;
+	int iSize = LSCP_HANDLER_COPIES;
+	int iId, iValid, i;
+
+	iId = _lscp_handler_id(pEventData);
+
+	lscp_mutex_lock(pTable->mutex);
+
+	for (i = (iId < 0 ? 1 : 0); i < 2; i++) {
+		pHandler = (lscp_handler_t *) lscp_hash_find(&(pTable->chains),
+			_lscp_handler_key(pEventData->event, i > 0 ? -1 : iId));
+		for ( ; pHandler; pHandler = pHandler->next) {
+			if (iHandlers >= iSize) {
+				pNewHandlers = (lscp_handler_t *) malloc(
+					(iSize << 1) * sizeof(lscp_handler_t));
+				if (pNewHandlers == NULL)
+					break;
+				memcpy(pNewHandlers, pHandlers, iHandlers * sizeof(lscp_handler_t));
+				if (pHandlers != handlers)
+					free(pHandlers);
+				pHandlers = pNewHandlers;
+				iSize <<= 1;
 			}
+			pHandlers[iHandlers++] = *pHandler;
 		}
 	}
 
-	if (i < 1)
-		free(pszHead);
-
-	for ( ; i < iSize; i++) {
-		ppSplit[i].key   = NULL;
-		ppSplit[i].value = NULL;
+	lscp_mutex_unlock(pTable->mutex);
+
+	for (i = 0; i < iHandlers; i++) {
+		pHandler = &(pHandlers[i]);
+		// Still registered?
+		lscp_mutex_lock(pTable->mutex);
+		iValid = (lscp_hash_find(&(pTable->handles), pHandler->handle) != NULL);
+		lscp_mutex_unlock(pTable->mutex);
+		if (!iValid)
+			continue;
+		st = (*pHandler->pfnHandler)(pClient, pEventData, pHandler->pvData);
+		if (st != LSCP_OK && ret == LSCP_OK)
+			ret = st;
 	}
 
-	return ppSplit;
+	if (pHandlers != handlers)
+		free(pHandlers);
+
+	return ret;
 }
 
 
-// Destroy a parameter list array.
-void lscp_psplit_destroy ( lscp_param_t *ppSplit )
+//-------------------------------------------------------------------------
+// Device topology mirror helper functions.
+
+void lscp_topology_device_init ( lscp_topology_device_t *pDevice )
 {
-	if (ppSplit && ppSplit[0].key)
-		free(ppSplit[0].key);
-	if (ppSplit)
-		free(ppSplit);
+	pDevice->device = -1;
+	lscp_device_info_init(&(pDevice->info));
+	pDevice->port_count = 0;
+	pDevice->ports = NULL;
 }
 
+void lscp_topology_device_free ( lscp_topology_device_t *pDevice )
+{
+	int i;
 
-#ifdef LSCP_PSPLIT_COUNT
+	for (i = 0; i < pDevice->port_count; i++)
+		lscp_device_port_info_free(&(pDevice->ports[i]));
+	if (pDevice->ports)
+		free(pDevice->ports);
 
-// Compute a parameter list valid item count.
-int lscp_psplit_count ( lscp_param_t *ppSplit )
-{
-	int i = 0;
-	while (ppSplit && ppSplit[i].key)
-		i++;
-	return i;
+	lscp_device_info_free(&(pDevice->info));
 }
 
-// Compute a parameter list size.
-int lscp_psplit_size ( lscp_param_t *ppSplit )
+
+void lscp_device_topology_init ( lscp_device_topology_t *pTopology )
 {
-	return LSCP_SPLIT_SIZE(lscp_psplit_count(ppSplit));
+	pTopology->audio_count = 0;
+	pTopology->audio_devices = NULL;
+	pTopology->midi_count = 0;
+	pTopology->midi_devices = NULL;
 }
 
-#endif // LSCP_PSPLIT_COUNT
+void lscp_device_topology_free ( lscp_device_topology_t *pTopology )
+{
+	int i;
 
+	for (i = 0; i < pTopology->audio_count; i++)
+		lscp_topology_device_free(&(pTopology->audio_devices[i]));
+	if (pTopology->audio_devices)
+		free(pTopology->audio_devices);
 
-// Allocate a parameter list, optionally copying an existing one.
-void lscp_plist_alloc (lscp_param_t **ppList)
-{
-	lscp_param_t *pParams;
-	int iSize, i;
+	for (i = 0; i < pTopology->midi_count; i++)
+		lscp_topology_device_free(&(pTopology->midi_devices[i]));
+	if (pTopology->midi_devices)
+		free(pTopology->midi_devices);
 
-	if (ppList) {
-		iSize = LSCP_SPLIT_CHUNK1;
-		pParams = (lscp_param_t *) malloc(iSize * sizeof(lscp_param_t));
-		if (pParams) {
-			for (i = 0 ; i < iSize; i++) {
-				pParams[i].key   = NULL;
-				pParams[i].value = NULL;
-			}
-		}
-		*ppList = pParams;
-	}
+	lscp_device_topology_init(pTopology);
 }
 
 
-// Destroy a parameter list, including all it's contents.
-void lscp_plist_free ( lscp_param_t **ppList )
+void lscp_device_mirror_init ( lscp_device_mirror_t *pMirror )
 {
-	lscp_param_t *pParams;
-	int i;
+	pMirror->enabled = 0;
+	pMirror->events  = LSCP_EVENT_NONE;
 
-	if (ppList) {
-		if (*ppList) {
-			pParams = *ppList;
-			for (i = 0; pParams && pParams[i].key; i++) {
-				free(pParams[i].key);
-				free(pParams[i].value);
-			}
-			free(pParams);
-		}
-		*ppList = NULL;
-	}
+	lscp_device_topology_init(&(pMirror->topology));
+
+	pMirror->audio_stale = 1;
+	pMirror->midi_stale  = 1;
+
+	lscp_hash_init(&(pMirror->stale));
+	pMirror->warm = 0;
+	lscp_mutex_init(pMirror->mutex);
 }
 
+void lscp_device_mirror_free ( lscp_device_mirror_t *pMirror )
+{
+	lscp_device_topology_free(&(pMirror->topology));
+	lscp_hash_free(&(pMirror->stale));
+	lscp_mutex_destroy(pMirror->mutex);
+}
 
-// Add an item to a parameter list, growing it as fit.
-void lscp_plist_append ( lscp_param_t **ppList, const char *pszKey, const char *pszValue )
+// Mark a device as stale, or the whole device list if iDevice < 0.
+void lscp_device_mirror_stale ( lscp_device_mirror_t *pMirror,
+	int iType, int iDevice )
 {
-	lscp_param_t *pParams;
-	lscp_param_t *pNewParams;
-	int iSize, iNewSize;
-	int i = 0;
+	lscp_mutex_lock(pMirror->mutex);
 
-	if (ppList && *ppList) {
-		pParams = *ppList;
-		while (pParams[i].key) {
-			if (strcasecmp(pParams[i].key, pszKey) == 0) {
-				if (pParams[i].value)
-					free(pParams[i].value);
-				pParams[i].value = strdup(pszValue);
-				return;
-			}
-			i++;
-		}
-		iSize = LSCP_SPLIT_SIZE(i);
-		pParams[i].key   = strdup(pszKey);
-		pParams[i].value = strdup(pszValue);
-		if (++i >= iSize) {
-			iNewSize   = iSize + LSCP_SPLIT_CHUNK1;
-			pNewParams = (lscp_param_t *) malloc(iNewSize * sizeof(lscp_param_t));
-			for (i = 0; i < iSize; i++) {
-				pNewParams[i].key   = pParams[i].key;
-				pNewParams[i].value = pParams[i].value;
-			}
-			for ( ; i < iNewSize; i++) {
-				pNewParams[i].key   = NULL;
-				pNewParams[i].value = NULL;
-			}
-			free(pParams);
-			*ppList = pNewParams;
-		}
+	if (iDevice < 0) {
+		if (iType == LSCP_MIRROR_AUDIO)
+			pMirror->audio_stale = 1;
+		else
+			pMirror->midi_stale = 1;
+	} else {
+		lscp_hash_insert(&(pMirror->stale),
+			LSCP_MIRROR_KEY(iType, iDevice), pMirror);
 	}
-}
 
-#ifdef LSCP_PLIST_COUNT
+	lscp_mutex_unlock(pMirror->mutex);
+}
 
-// Compute a parameter list valid item count.
-int lscp_plist_count ( lscp_param_t **ppList )
+// Mark stale state on behalf of server notifications
+// (called from the event service thread).
+void lscp_device_mirror_event ( lscp_device_mirror_t *pMirror,
+	lscp_event_t event, const char *pszData )
 {
-	lscp_param_t *pParams;
-	int i = 0;
-	if (ppList && *ppList) {
-		pParams = *ppList;
-		while (pParams[i].key)
-			i++;
+	int iDevice = (pszData ? lscp_atoi(pszData) : -1);
+
+	switch (event) {
+	case LSCP_EVENT_AUDIO_OUTPUT_DEVICE_COUNT:
+		lscp_device_mirror_stale(pMirror, LSCP_MIRROR_AUDIO, -1);
+		break;
+	case LSCP_EVENT_AUDIO_OUTPUT_DEVICE_INFO:
+		lscp_device_mirror_stale(pMirror, LSCP_MIRROR_AUDIO, iDevice);
+		break;
+	case LSCP_EVENT_MIDI_INPUT_DEVICE_COUNT:
+		lscp_device_mirror_stale(pMirror, LSCP_MIRROR_MIDI, -1);
+		break;
+	case LSCP_EVENT_MIDI_INPUT_DEVICE_INFO:
+		lscp_device_mirror_stale(pMirror, LSCP_MIRROR_MIDI, iDevice);
+		break;
+	default:
+		break;
 	}
-	return i;
 }
 
-// Compute the legal parameter list size.
-int lscp_plist_size ( lscp_param_t **ppList )
+
+//-------------------------------------------------------------------------
+// MIDI instrument map mirror helper functions.
+
+void lscp_midi_map_init ( lscp_midi_map_t *pMap )
 {
-	return LSCP_SPLIT_SIZE(lscp_plist_count(ppList));
+	pMap->map = -1;
+	pMap->name = NULL;
+	pMap->entry_count = 0;
+	pMap->entries = NULL;
 }
 
-#endif // LSCP_PLIST_COUNT
+void lscp_midi_map_free ( lscp_midi_map_t *pMap )
+{
+	int i;
 
+	for (i = 0; i < pMap->entry_count; i++)
+		lscp_midi_instrument_info_free(&(pMap->entries[i].info));
+	if (pMap->entries)
+		free(pMap->entries);
+	if (pMap->name)
+		free(pMap->name);
 
-// Split a string into an array of MIDI instrument triplets.
-lscp_midi_instrument_t *lscp_midi_instruments_create ( const char *pszCsv )
+	lscp_midi_map_init(pMap);
+}
+
+
+void lscp_midi_maps_init ( lscp_midi_maps_t *pMaps )
 {
-	char *pchHead, *pch;
-	int iSize, i, j, k;
-	lscp_midi_instrument_t *pInstrs;
-	lscp_midi_instrument_t *pNewInstrs;
-	
-	// Get it clean first.
-	pchHead = lscp_ltrim((char *) pszCsv);
-	if (*pchHead == (char) 0)
-		return NULL;
-	
-	// Initial size is one chunk away.
-	iSize = LSCP_SPLIT_CHUNK1;
-	// Allocate and split...
-	pInstrs = (lscp_midi_instrument_t *) malloc(iSize * sizeof(lscp_midi_instrument_t));
-	if (pInstrs == NULL)
-		return NULL;
-	
-	// Go on for it...
-	i = 0;
-	k = 0;
-	
-	while ((pch = strpbrk(pchHead, "{,}")) != NULL) {
-		// Pre-advance to next item.
-		switch (*pch) {
-		case '{':
-			pchHead = pch + 1;
-			if (k == 0) {
-				pInstrs[i].map = atoi(pchHead);
-				k++;
-			}
-			break;
-		case ',':
-			pchHead = pch + 1;
-			if (k == 1) {
-				pInstrs[i].bank = atoi(pchHead);
-				k++;
-			}
-			else 
-			if (k == 2) {
-				pInstrs[i].prog = atoi(pchHead);
-				k++;
-			}
-			break;
-		case '}':
-			pchHead = pch + 1;
-			k = 0;
-			break;
-		}
-		// Do we need to grow?
-		if (k == 3 && ++i >= iSize) {
-			// Yes, but only grow in chunks.
-			iSize += LSCP_SPLIT_CHUNK1;
-			// Allocate and copy to new split array.
-			pNewInstrs = (lscp_midi_instrument_t *) malloc(iSize * sizeof(lscp_midi_instrument_t));
-			if (pNewInstrs) {
-				for (j = 0; j < i; j++) {
-					pNewInstrs[j].map  = pInstrs[j].map;
-					pNewInstrs[j].bank = pInstrs[j].bank;
-					pNewInstrs[j].prog = pInstrs[j].prog;
-				}
-				free(pInstrs);
-				pInstrs = pNewInstrs;
-			}
-		}
-	}
-	
-	// Special terminate split array.
-	for ( ; i < iSize; i++) {
-		pInstrs[i].map  = -1;
-		pInstrs[i].bank = -1;
-		pInstrs[i].prog = -1;
-	}
-	
-	return pInstrs;
+	pMaps->map_count = 0;
+	pMaps->maps = NULL;
 }
 
-// Destroy a MIDI instrument triplet array.
-void lscp_midi_instruments_destroy ( lscp_midi_instrument_t *pInstrs )
+void lscp_midi_maps_free ( lscp_midi_maps_t *pMaps )
 {
-	if (pInstrs)
-		free(pInstrs);
+	int i;
+
+	for (i = 0; i < pMaps->map_count; i++)
+		lscp_midi_map_free(&(pMaps->maps[i]));
+	if (pMaps->maps)
+		free(pMaps->maps);
+
+	lscp_midi_maps_init(pMaps);
 }
 
-#ifdef LSCP_MIDI_INSTRUMENTS_COUNT
 
-// Compute a MIDI instrument array item count.
-int lscp_midi_instruments_count ( lscp_midi_instrument_t *pInstrs )
+void lscp_midi_mirror_init ( lscp_midi_mirror_t *pMirror )
 {
-	int i = 0;
-	while (pInstrs && pInstrs[i].program >= 0)
-		i++;
-	return i;
+	pMirror->enabled = 0;
+	pMirror->events  = LSCP_EVENT_NONE;
+
+	lscp_midi_maps_init(&(pMirror->maps));
+
+	lscp_hash_init(&(pMirror->entries));
+	lscp_hash_init(&(pMirror->names));
+	lscp_hash_init(&(pMirror->files));
+	pMirror->nodes = NULL;
+
+	pMirror->found = NULL;
+	pMirror->found_size = 0;
+
+	pMirror->maps_stale  = 1;
+	pMirror->lists_stale = 0;
+
+	lscp_hash_init(&(pMirror->stale));
+	pMirror->warm = 0;
+	lscp_mutex_init(pMirror->mutex);
 }
 
-// Compute a MIDI instrument array size.
-int lscp_midi_instruments_size ( lscp_midi_instrument_t *pInstrs )
+void lscp_midi_mirror_free ( lscp_midi_mirror_t *pMirror )
 {
-	return LSCP_SPLIT_SIZE(lscp_midi_instruments_count(pInstrs));
+	lscp_midi_mirror_reset(pMirror);
+
+	if (pMirror->found)
+		free(pMirror->found);
+	pMirror->found = NULL;
+	pMirror->found_size = 0;
+
+	lscp_mutex_destroy(pMirror->mutex);
 }
 
-#endif // LSCP_MIDI_INSTRUMENTS_COUNT
+// Drop everything mirrored, all stale again.
+void lscp_midi_mirror_reset ( lscp_midi_mirror_t *pMirror )
+{
+	lscp_mutex_lock(pMirror->mutex);
 
+	lscp_midi_maps_free(&(pMirror->maps));
 
-//-------------------------------------------------------------------------
-// Server info struct helper functions.
+	lscp_hash_free(&(pMirror->entries));
+	lscp_hash_free(&(pMirror->names));
+	lscp_hash_free(&(pMirror->files));
+	if (pMirror->nodes)
+		free(pMirror->nodes);
+	pMirror->nodes = NULL;
 
-void lscp_server_info_init ( lscp_server_info_t *pServerInfo )
+	lscp_hash_free(&(pMirror->stale));
+	pMirror->maps_stale  = 1;
+	pMirror->lists_stale = 0;
+	pMirror->warm = 0;
+
+	lscp_mutex_unlock(pMirror->mutex);
+}
+
+// Mark a map or entry as stale, or else the whole map list
+// or all map entry lists, given their pseudo-keys.
+void lscp_midi_mirror_stale ( lscp_midi_mirror_t *pMirror, int64_t key )
 {
-	pServerInfo->description      = NULL;
-	pServerInfo->version          = NULL;
-	pServerInfo->protocol_version = NULL;
+	lscp_mutex_lock(pMirror->mutex);
+
+	if (key == LSCP_MIDI_MIRROR_MAPS)
+		pMirror->maps_stale = 1;
+	else
+	if (key == LSCP_MIDI_MIRROR_LISTS)
+		pMirror->lists_stale = 1;
+	else
+	if (key >= 0)
+		lscp_hash_insert(&(pMirror->stale), key, pMirror);
+
+	lscp_mutex_unlock(pMirror->mutex);
 }
 
-void lscp_server_info_free ( lscp_server_info_t *pServerInfo )
+// Mark stale state on behalf of server notifications
+// (called from the event service thread).
+void lscp_midi_mirror_event ( lscp_midi_mirror_t *pMirror,
+	lscp_event_t event, const char *pszData )
 {
-	if (pServerInfo->description)
-		free(pServerInfo->description);
-	if (pServerInfo->version)
-		free(pServerInfo->version);
-	if (pServerInfo->protocol_version)
-		free(pServerInfo->protocol_version);
+	char *pch = (char *) pszData;
+	int iMap = -1, iBank = -1, iProg = -1;
+
+	if (pch) {
+		iMap = (int) strtol(pch, &pch, 10);
+		if (event == LSCP_EVENT_MIDI_INSTRUMENT_INFO) {
+			iBank = (int) strtol(pch, &pch, 10);
+			iProg = (int) strtol(pch, &pch, 10);
+		}
+	}
+
+	switch (event) {
+	case LSCP_EVENT_MIDI_INSTRUMENT_MAP_COUNT:
+		lscp_midi_mirror_stale(pMirror, LSCP_MIDI_MIRROR_MAPS);
+		break;
+	case LSCP_EVENT_MIDI_INSTRUMENT_MAP_INFO:
+		if (iMap >= 0)
+			lscp_midi_mirror_stale(pMirror,
+				LSCP_MIDI_MIRROR_KEY(iMap, LSCP_MIDI_MIRROR_NAME));
+		break;
+	case LSCP_EVENT_MIDI_INSTRUMENT_COUNT:
+		if (iMap >= 0)
+			lscp_midi_mirror_stale(pMirror,
+				LSCP_MIDI_MIRROR_KEY(iMap, LSCP_MIDI_MIRROR_LIST));
+		break;
+	case LSCP_EVENT_MIDI_INSTRUMENT_INFO:
+		if (iMap >= 0 && iBank >= 0 && iBank < 16384 && iProg >= 0 && iProg < 128)
+			lscp_midi_mirror_stale(pMirror,
+				LSCP_MIDI_MIRROR_ENTRY_KEY(iMap, iBank, iProg));
+		break;
+	default:
+		break;
+	}
 }
 
-void lscp_server_info_reset ( lscp_server_info_t *pServerInfo )
+
+// Chain an entry to the index node list of a given (interned) string key.
+static int _lscp_midi_mirror_chain ( lscp_hash_t *pIndex,
+	lscp_midi_mirror_node_t *pNode, lscp_midi_map_entry_t *pEntry,
+	const char *pszKey )
 {
-	lscp_server_info_free(pServerInfo);
-	lscp_server_info_init(pServerInfo);
+	int64_t key = (int64_t) (intptr_t) pszKey;
+
+	pNode->entry = pEntry;
+	pNode->next = (lscp_midi_mirror_node_t *) lscp_hash_find(pIndex, key);
+
+	return lscp_hash_insert(pIndex, key, pNode);
+}
+
+// Rebuild all lookup indexes, from scratch
+// (caller must own the client mutex).
+int lscp_midi_mirror_index ( lscp_midi_mirror_t *pMirror )
+{
+	lscp_midi_maps_t *pMaps = &(pMirror->maps);
+	lscp_midi_map_entry_t *pEntry;
+	lscp_midi_mirror_node_t *pNode;
+	int iEntries, i, j;
+
+	lscp_hash_free(&(pMirror->entries));
+	lscp_hash_free(&(pMirror->names));
+	lscp_hash_free(&(pMirror->files));
+	if (pMirror->nodes)
+		free(pMirror->nodes);
+	pMirror->nodes = NULL;
+
+	iEntries = 0;
+	for (i = 0; i < pMaps->map_count; i++)
+		iEntries += pMaps->maps[i].entry_count;
+	if (iEntries < 1)
+		return 0;
+
+	// Two nodes per entry, one for each name and file chain.
+	pMirror->nodes = (lscp_midi_mirror_node_t *) malloc(
+		2 * iEntries * sizeof(lscp_midi_mirror_node_t));
+	if (pMirror->nodes == NULL)
+		return -1;
+
+	// Backwards, so that chains come out in map, bank and program order.
+	pNode = pMirror->nodes;
+	for (i = pMaps->map_count - 1; i >= 0; i--) {
+		for (j = pMaps->maps[i].entry_count - 1; j >= 0; j--) {
+			pEntry = &(pMaps->maps[i].entries[j]);
+			if (lscp_hash_insert(&(pMirror->entries),
+				LSCP_MIDI_MIRROR_ENTRY_KEY(pEntry->instr.map,
+					pEntry->instr.bank, pEntry->instr.prog), pEntry) < 0)
+				return -1;
+			if (pEntry->info.name
+				&& _lscp_midi_mirror_chain(&(pMirror->names),
+					pNode++, pEntry, pEntry->info.name) < 0)
+				return -1;
+			if (pEntry->info.instrument_file
+				&& _lscp_midi_mirror_chain(&(pMirror->files),
+					pNode++, pEntry, pEntry->info.instrument_file) < 0)
+				return -1;
+		}
+	}
+
+	return 0;
+}
+
+// Look up all entries of a given name, or instrument file (and index,
+// if not negative), as interned strings, compared by pointer only;
+// returns a NULL terminated array, owned by the mirror, or NULL if
+// none found (caller must own the client mutex).
+const lscp_midi_map_entry_t **lscp_midi_mirror_lookup ( lscp_midi_mirror_t *pMirror,
+	int iFile, const char *pszKey, int iInstrIndex )
+{
+	const lscp_midi_map_entry_t **ppFound;
+	lscp_midi_mirror_node_t *pNode;
+	int iFound = 0;
+
+	if (pszKey == NULL)
+		return NULL;
+
+	pNode = (lscp_midi_mirror_node_t *) lscp_hash_find(
+		(iFile ? &(pMirror->files) : &(pMirror->names)),
+		(int64_t) (intptr_t) pszKey);
+
+	for ( ; pNode; pNode = pNode->next) {
+		if (iFile && iInstrIndex >= 0
+			&& pNode->entry->info.instrument_nr != iInstrIndex)
+			continue;
+		// Grow results storage as needed (plus terminator)...
+		if (iFound + 1 >= pMirror->found_size) {
+			ppFound = (const lscp_midi_map_entry_t **) realloc(pMirror->found,
+				(pMirror->found_size + 16) * sizeof(lscp_midi_map_entry_t *));
+			if (ppFound == NULL)
+				return NULL;
+			pMirror->found = ppFound;
+			pMirror->found_size += 16;
+		}
+		pMirror->found[iFound++] = pNode->entry;
+	}
+
+	if (iFound < 1)
+		return NULL;
+
+	pMirror->found[iFound] = NULL;
+
+	return pMirror->found;
 }
 
 
 //-------------------------------------------------------------------------
-// Engine info struct helper functions.
+// Warm-start cache file helper functions.
+//
+// A warm-start file is a fixed header followed by tagged records, all made
+// of 32bit words in native byte order, including strings (length prefixed,
+// NUL terminated and padded), so that it may be read or mapped in place.
+
+#define LSCP_WARM_MAGIC         "LSCPWARM"
+#define LSCP_WARM_FORMAT        1
+#define LSCP_WARM_BOM           0x01020304
+
+// Record tags (unknown ones are skipped on load).
+#define LSCP_WARM_SERVER        1
+#define LSCP_WARM_METADATA      2
+#define LSCP_WARM_AUDIO_DEVICE  3
+#define LSCP_WARM_MIDI_DEVICE   4
+#define LSCP_WARM_MIDI_MAP      5
+
+// Growable warm-start file writer buffer.
+typedef struct _lscp_warm_writer_t
+{
+	char *  data;
+	int     size;
+	int     len;
+	int     error;
 
-void lscp_engine_info_init ( lscp_engine_info_t *pEngineInfo )
+} lscp_warm_writer_t;
+
+// Warm-start file reader cursor.
+typedef struct _lscp_warm_reader_t
 {
-	pEngineInfo->description = NULL;
-	pEngineInfo->version     = NULL;
+	const char *data;
+	int     len;
+	int     pos;
+	int     error;
+	lscp_intern_pool_t *intern;
+
+} lscp_warm_reader_t;
+
+
+// Append raw bytes, padded to the next 32bit word.
+static void _lscp_warm_put ( lscp_warm_writer_t *pWriter,
+	const void *pvData, int cbData )
+{
+	int cbPadded = (cbData + 3) & ~3;
+	int iNewSize;
+	char *pNewData;
+
+	if (pWriter->error)
+		return;
+
+	if (pWriter->len + cbPadded > pWriter->size) {
+		iNewSize = (pWriter->size > 0 ? pWriter->size : 4096);
+		while (pWriter->len + cbPadded > iNewSize)
+			iNewSize <<= 1;
+		pNewData = (char *) realloc(pWriter->data, iNewSize);
+		if (pNewData == NULL) {
+			pWriter->error = 1;
+			return;
+		}
+		pWriter->data = pNewData;
+		pWriter->size = iNewSize;
+	}
+
+	memcpy(pWriter->data + pWriter->len, pvData, cbData);
+	memset(pWriter->data + pWriter->len + cbData, 0, cbPadded - cbData);
+	pWriter->len += cbPadded;
 }
 
-void lscp_engine_info_free ( lscp_engine_info_t *pEngineInfo )
+static void _lscp_warm_put_int ( lscp_warm_writer_t *pWriter, int iValue )
 {
-	if (pEngineInfo->description)
-		free(pEngineInfo->description);
-	if (pEngineInfo->version)
-		free(pEngineInfo->version);
+	uint32_t w = (uint32_t) iValue;
+
+	_lscp_warm_put(pWriter, &w, sizeof(w));
+}
+
+static void _lscp_warm_put_float ( lscp_warm_writer_t *pWriter, float fValue )
+{
+	uint32_t w;
+
+	memcpy(&w, &fValue, sizeof(w));
+	_lscp_warm_put(pWriter, &w, sizeof(w));
 }
 
-void lscp_engine_info_reset ( lscp_engine_info_t *pEngineInfo )
+// Strings are stored with their length plus one (zero for NULL).
+static void _lscp_warm_put_str ( lscp_warm_writer_t *pWriter, const char *psz )
 {
-	lscp_engine_info_free(pEngineInfo);
-	lscp_engine_info_init(pEngineInfo);
+	int cch = (psz ? (int) strlen(psz) + 1 : 0);
+
+	_lscp_warm_put_int(pWriter, cch);
+	if (cch > 0)
+		_lscp_warm_put(pWriter, psz, cch);
 }
 
+static void _lscp_warm_put_strs ( lscp_warm_writer_t *pWriter, char **ppsz )
+{
+	int i, n = 0;
 
-//-------------------------------------------------------------------------
-// Channel info struct helper functions.
+	while (ppsz && ppsz[n])
+		n++;
 
-void lscp_channel_info_init ( lscp_channel_info_t *pChannelInfo )
-{
-	pChannelInfo->engine_name       = NULL;
-	pChannelInfo->audio_device      = 0;
-	pChannelInfo->audio_channels    = 0;
-	pChannelInfo->audio_routing     = NULL;
-	pChannelInfo->instrument_file   = NULL;
-	pChannelInfo->instrument_nr     = 0;
-	pChannelInfo->instrument_name   = NULL;
-	pChannelInfo->instrument_status = 0;
-	pChannelInfo->midi_device       = 0;
-	pChannelInfo->midi_port         = 0;
-	pChannelInfo->midi_channel      = 0;
-	pChannelInfo->midi_map          = 0;
-	pChannelInfo->volume            = 0.0;
-	pChannelInfo->mute              = 0;
-	pChannelInfo->solo              = 0;
+	_lscp_warm_put_int(pWriter, n);
+	for (i = 0; i < n; i++)
+		_lscp_warm_put_str(pWriter, ppsz[i]);
 }
 
-void lscp_channel_info_free ( lscp_channel_info_t *pChannelInfo )
+static void _lscp_warm_put_params ( lscp_warm_writer_t *pWriter, lscp_param_t *pParams )
 {
-	if (pChannelInfo->engine_name)
-		free(pChannelInfo->engine_name);
-	if (pChannelInfo->audio_routing)
-		lscp_isplit_destroy(pChannelInfo->audio_routing);
-	if (pChannelInfo->instrument_file)
-		free(pChannelInfo->instrument_file);
-	if (pChannelInfo->instrument_name)
-		free(pChannelInfo->instrument_name);
+	int i, n = 0;
+
+	while (pParams && pParams[n].key)
+		n++;
+
+	_lscp_warm_put_int(pWriter, n);
+	for (i = 0; i < n; i++) {
+		_lscp_warm_put_str(pWriter, pParams[i].key);
+		_lscp_warm_put_str(pWriter, pParams[i].value);
+	}
 }
 
-void lscp_channel_info_reset ( lscp_channel_info_t *pChannelInfo )
+// Start a new record, returning where its size is to be patched.
+static int _lscp_warm_begin ( lscp_warm_writer_t *pWriter, int iTag )
 {
-	lscp_channel_info_free(pChannelInfo);
-	lscp_channel_info_init(pChannelInfo);
-}
+	int iRecord;
 
+	_lscp_warm_put_int(pWriter, iTag);
+	iRecord = pWriter->len;
+	_lscp_warm_put_int(pWriter, 0);
 
-//-------------------------------------------------------------------------
-// Driver info struct functions.
+	return iRecord;
+}
 
-void lscp_driver_info_init ( lscp_driver_info_t *pDriverInfo )
+static void _lscp_warm_end ( lscp_warm_writer_t *pWriter, int iRecord )
 {
-	pDriverInfo->description = NULL;
-	pDriverInfo->version     = NULL;
-	pDriverInfo->parameters  = NULL;
+	uint32_t w;
+
+	if (pWriter->error)
+		return;
+
+	w = (uint32_t) (pWriter->len - iRecord - sizeof(w));
+	memcpy(pWriter->data + iRecord, &w, sizeof(w));
 }
 
-void lscp_driver_info_free ( lscp_driver_info_t *pDriverInfo )
+
+// Fetch raw bytes, padded to the next 32bit word.
+static const char *_lscp_warm_get ( lscp_warm_reader_t *pReader, int cbData )
 {
-	if (pDriverInfo->description)
-		free(pDriverInfo->description);
-	if (pDriverInfo->version)
-		free(pDriverInfo->version);
-	lscp_szsplit_destroy(pDriverInfo->parameters);
+	const char *pch;
+	unsigned int cbPadded;
+	int cbAvail = pReader->len - pReader->pos;
+
+	// Lengths come from the file: check before padding (no overflow)...
+	if (pReader->error || cbData < 0 || cbData > cbAvail) {
+		pReader->error = 1;
+		return NULL;
+	}
+
+	cbPadded = ((unsigned int) cbData + 3) & ~3u;
+	if (cbPadded > (unsigned int) cbAvail) {
+		pReader->error = 1;
+		return NULL;
+	}
+
+	pch = pReader->data + pReader->pos;
+	pReader->pos += (int) cbPadded;
+
+	return pch;
 }
 
-void lscp_driver_info_reset ( lscp_driver_info_t *pDriverInfo )
+static int _lscp_warm_get_int ( lscp_warm_reader_t *pReader )
 {
-	lscp_driver_info_free(pDriverInfo);
-	lscp_driver_info_init(pDriverInfo);
+	const char *pch = _lscp_warm_get(pReader, sizeof(uint32_t));
+	uint32_t w = 0;
+
+	if (pch)
+		memcpy(&w, pch, sizeof(w));
+
+	return (int) w;
 }
 
+static float _lscp_warm_get_float ( lscp_warm_reader_t *pReader )
+{
+	const char *pch = _lscp_warm_get(pReader, sizeof(uint32_t));
+	float f = 0.0f;
+
+	if (pch)
+		memcpy(&f, pch, sizeof(f));
 
-//-------------------------------------------------------------------------
-// Device info struct functions.
+	return f;
+}
 
-void lscp_device_info_init ( lscp_device_info_t *pDeviceInfo )
+// Get a string in place (NULL if so stored, or on error).
+static const char *_lscp_warm_get_str ( lscp_warm_reader_t *pReader )
 {
-	pDeviceInfo->driver = NULL;
-	lscp_plist_alloc(&(pDeviceInfo->params));
+	const char *psz;
+	int cch = _lscp_warm_get_int(pReader);
+
+	if (cch < 1)
+		return NULL;
+
+	psz = _lscp_warm_get(pReader, cch);
+	if (psz && psz[cch - 1]) {
+		pReader->error = 1;
+		return NULL;
+	}
+
+	return psz;
 }
 
-void lscp_device_info_free ( lscp_device_info_t *pDeviceInfo )
+static char *_lscp_warm_get_strdup ( lscp_warm_reader_t *pReader )
 {
-	if (pDeviceInfo->driver)
-		free(pDeviceInfo->driver);
-	lscp_plist_free(&(pDeviceInfo->params));
+	const char *psz = _lscp_warm_get_str(pReader);
+
+	return (psz ? strdup(psz) : NULL);
 }
 
-void lscp_device_info_reset ( lscp_device_info_t *pDeviceInfo )
+static char *_lscp_warm_get_intern ( lscp_warm_reader_t *pReader )
 {
-	lscp_device_info_free(pDeviceInfo);
-	lscp_device_info_init(pDeviceInfo);
+	return lscp_intern(pReader->intern, _lscp_warm_get_str(pReader));
 }
 
+// Get a string list, allocated just like lscp_szsplit_create() does
+// (all items in one single block, owned by the first one).
+static char **_lscp_warm_get_strs ( lscp_warm_reader_t *pReader )
+{
+	const char **ppsz;
+	char **ppszSplit;
+	char *pch;
+	int n, i, cch = 0;
 
-//-------------------------------------------------------------------------
-// Device channel/port info struct functions.
+	n = _lscp_warm_get_int(pReader);
+	if (n < 1 || n > pReader->len)
+		return NULL;
 
-void lscp_device_port_info_init ( lscp_device_port_info_t *pDevicePortInfo )
-{
-	pDevicePortInfo->name = NULL;
-	lscp_plist_alloc(&(pDevicePortInfo->params));
+	ppsz = (const char **) malloc(n * sizeof(char *));
+	if (ppsz == NULL) {
+		pReader->error = 1;
+		return NULL;
+	}
+
+	for (i = 0; i < n; i++) {
+		ppsz[i] = _lscp_warm_get_str(pReader);
+		if (ppsz[i] == NULL) {
+			free(ppsz);
+			pReader->error = 1;
+			return NULL;
+		}
+		cch += strlen(ppsz[i]) + 1;
+	}
+
+	ppszSplit = (char **) malloc((n + 1) * sizeof(char *));
+	pch = (char *) malloc(cch);
+	if (ppszSplit == NULL || pch == NULL) {
+		if (ppszSplit)
+			free(ppszSplit);
+		if (pch)
+			free(pch);
+		free(ppsz);
+		pReader->error = 1;
+		return NULL;
+	}
+
+	for (i = 0; i < n; i++) {
+		ppszSplit[i] = pch;
+		strcpy(pch, ppsz[i]);
+		pch += strlen(ppsz[i]) + 1;
+	}
+	ppszSplit[n] = NULL;
+
+	free(ppsz);
+
+	return ppszSplit;
 }
 
-void lscp_device_port_info_free ( lscp_device_port_info_t *pDevicePortInfo )
+// Get a parameter list, appending to an already allocated one.
+static void _lscp_warm_get_params ( lscp_warm_reader_t *pReader, lscp_param_t **ppParams )
 {
-	if (pDevicePortInfo->name)
-		free(pDevicePortInfo->name);
-	lscp_plist_free(&(pDevicePortInfo->params));
+	const char *pszKey;
+	const char *pszValue;
+	int n, i;
+
+	n = _lscp_warm_get_int(pReader);
+	for (i = 0; i < n && !pReader->error; i++) {
+		pszKey   = _lscp_warm_get_str(pReader);
+		pszValue = _lscp_warm_get_str(pReader);
+		if (pszKey && pszValue)
+			lscp_plist_append(ppParams, pszKey, pszValue);
+	}
 }
 
-void lscp_device_port_info_reset ( lscp_device_port_info_t *pDevicePortInfo )
+
+// Info struct (de)serializers.
+static void _lscp_warm_put_device_info ( lscp_warm_writer_t *pWriter,
+	lscp_device_info_t *pDeviceInfo )
 {
-	lscp_device_port_info_free(pDevicePortInfo);
-	lscp_device_port_info_init(pDevicePortInfo);
+	_lscp_warm_put_str(pWriter, pDeviceInfo->driver);
+	_lscp_warm_put_params(pWriter, pDeviceInfo->params);
 }
 
+static void _lscp_warm_get_device_info ( lscp_warm_reader_t *pReader,
+	lscp_device_info_t *pDeviceInfo )
+{
+	pDeviceInfo->driver = _lscp_warm_get_intern(pReader);
+	_lscp_warm_get_params(pReader, &(pDeviceInfo->params));
+}
 
-//-------------------------------------------------------------------------
-// Parameter struct helper functions.
-
-void lscp_param_info_init ( lscp_param_info_t *pParamInfo )
+static void _lscp_warm_put_port_info ( lscp_warm_writer_t *pWriter,
+	lscp_device_port_info_t *pDevicePortInfo )
 {
-	pParamInfo->type          = LSCP_TYPE_NONE;
-	pParamInfo->description   = NULL;
-	pParamInfo->mandatory     = 0;
-	pParamInfo->fix           = 0;
-	pParamInfo->multiplicity  = 0;
-	pParamInfo->depends       = NULL;
-	pParamInfo->defaultv      = NULL;
-	pParamInfo->range_min     = NULL;
-	pParamInfo->range_max     = NULL;
-	pParamInfo->possibilities = NULL;
+	_lscp_warm_put_str(pWriter, pDevicePortInfo->name);
+	_lscp_warm_put_params(pWriter, pDevicePortInfo->params);
 }
 
-void lscp_param_info_free ( lscp_param_info_t *pParamInfo )
+static void _lscp_warm_get_port_info ( lscp_warm_reader_t *pReader,
+	lscp_device_port_info_t *pDevicePortInfo )
 {
-	if (pParamInfo->description)
-		free(pParamInfo->description);
-	lscp_szsplit_destroy(pParamInfo->depends);
-	if (pParamInfo->defaultv)
-		free(pParamInfo->defaultv);
-	if (pParamInfo->range_min)
-		free(pParamInfo->range_min);
-	if (pParamInfo->range_max)
-		free(pParamInfo->range_max);
-	lscp_szsplit_destroy(pParamInfo->possibilities);
+	pDevicePortInfo->name = _lscp_warm_get_strdup(pReader);
+	_lscp_warm_get_params(pReader, &(pDevicePortInfo->params));
 }
 
-void lscp_param_info_reset ( lscp_param_info_t *pParamInfo )
+static void _lscp_warm_put_snapshot ( lscp_warm_writer_t *pWriter, void *pvInfo )
 {
-	lscp_param_info_free(pParamInfo);
-	lscp_param_info_init(pParamInfo);
+	lscp_snapshot_type_t type = _lscp_snapshot_header(pvInfo)->h.type;
+	lscp_engine_info_t *pEngineInfo;
+	lscp_driver_info_t *pDriverInfo;
+	lscp_param_info_t  *pParamInfo;
+
+	_lscp_warm_put_int(pWriter, (int) type);
+
+	switch (type) {
+	case LSCP_SNAPSHOT_ENGINE_INFO:
+		pEngineInfo = (lscp_engine_info_t *) pvInfo;
+		_lscp_warm_put_str(pWriter, pEngineInfo->description);
+		_lscp_warm_put_str(pWriter, pEngineInfo->version);
+		break;
+	case LSCP_SNAPSHOT_DRIVER_INFO:
+		pDriverInfo = (lscp_driver_info_t *) pvInfo;
+		_lscp_warm_put_str(pWriter, pDriverInfo->description);
+		_lscp_warm_put_str(pWriter, pDriverInfo->version);
+		_lscp_warm_put_strs(pWriter, pDriverInfo->parameters);
+		break;
+	case LSCP_SNAPSHOT_PARAM_INFO:
+		pParamInfo = (lscp_param_info_t *) pvInfo;
+		_lscp_warm_put_int(pWriter, (int) pParamInfo->type);
+		_lscp_warm_put_str(pWriter, pParamInfo->description);
+		_lscp_warm_put_int(pWriter, pParamInfo->mandatory);
+		_lscp_warm_put_int(pWriter, pParamInfo->fix);
+		_lscp_warm_put_int(pWriter, pParamInfo->multiplicity);
+		_lscp_warm_put_strs(pWriter, pParamInfo->depends);
+		_lscp_warm_put_str(pWriter, pParamInfo->defaultv);
+		_lscp_warm_put_str(pWriter, pParamInfo->range_min);
+		_lscp_warm_put_str(pWriter, pParamInfo->range_max);
+		_lscp_warm_put_strs(pWriter, pParamInfo->possibilities);
+		break;
+	default:
+		break;
+	}
 }
 
+// Returns a new snapshot, holding one single reference; NULL on failure.
+static void *_lscp_warm_get_snapshot ( lscp_warm_reader_t *pReader )
+{
+	lscp_snapshot_type_t type = (lscp_snapshot_type_t) _lscp_warm_get_int(pReader);
+	lscp_engine_info_t *pEngineInfo;
+	lscp_driver_info_t *pDriverInfo;
+	lscp_param_info_t  *pParamInfo;
+	void *pvInfo;
 
-//-------------------------------------------------------------------------
-// Concatenate a parameter list (key='value'...) into a string,
-// appending a crlf terminator.
+	if (pReader->error)
+		return NULL;
 
-int lscp_param_concat ( char *pszBuffer, int cchMaxBuffer, lscp_param_t *pParams )
-{
-	int cchBuffer, cchParam, i;
+	switch (type) {
+	case LSCP_SNAPSHOT_ENGINE_INFO:
+	case LSCP_SNAPSHOT_DRIVER_INFO:
+	case LSCP_SNAPSHOT_PARAM_INFO:
+		break;
+	default:
+		return NULL;
+	}
 
-	if (pszBuffer == NULL)
-		return 0;
+	pvInfo = lscp_snapshot_alloc(type);
+	if (pvInfo == NULL)
+		return NULL;
 
-	cchBuffer = strlen(pszBuffer);
-	for (i = 0; pParams && pParams[i].key && pParams[i].value; i++) {
-		cchParam = strlen(pParams[i].key) + strlen(pParams[i].value) + 4;
-		if (cchBuffer + cchParam + 2 < cchMaxBuffer) {
-			sprintf(pszBuffer + cchBuffer, " %s='%s'", pParams[i].key, pParams[i].value);
-			cchBuffer += cchParam;
-		}
+	switch (type) {
+	case LSCP_SNAPSHOT_ENGINE_INFO:
+		pEngineInfo = (lscp_engine_info_t *) pvInfo;
+		pEngineInfo->description = _lscp_warm_get_strdup(pReader);
+		pEngineInfo->version = _lscp_warm_get_strdup(pReader);
+		break;
+	case LSCP_SNAPSHOT_DRIVER_INFO:
+		pDriverInfo = (lscp_driver_info_t *) pvInfo;
+		pDriverInfo->description = _lscp_warm_get_strdup(pReader);
+		pDriverInfo->version = _lscp_warm_get_strdup(pReader);
+		pDriverInfo->parameters = _lscp_warm_get_strs(pReader);
+		break;
+	case LSCP_SNAPSHOT_PARAM_INFO:
+		pParamInfo = (lscp_param_info_t *) pvInfo;
+		pParamInfo->type = (lscp_type_t) _lscp_warm_get_int(pReader);
+		pParamInfo->description = _lscp_warm_get_strdup(pReader);
+		pParamInfo->mandatory = _lscp_warm_get_int(pReader);
+		pParamInfo->fix = _lscp_warm_get_int(pReader);
+		pParamInfo->multiplicity = _lscp_warm_get_int(pReader);
+		pParamInfo->depends = _lscp_warm_get_strs(pReader);
+		pParamInfo->defaultv = _lscp_warm_get_strdup(pReader);
+		pParamInfo->range_min = _lscp_warm_get_strdup(pReader);
+		pParamInfo->range_max = _lscp_warm_get_strdup(pReader);
+		pParamInfo->possibilities = _lscp_warm_get_strs(pReader);
+		break;
+	default:
+		break;
 	}
-	
-	if (cchBuffer + 2 < cchMaxBuffer) {
-		pszBuffer[cchBuffer++] = '\r';
-		pszBuffer[cchBuffer++] = '\n';
-		pszBuffer[cchBuffer ]  = (char) 0;
+
+	if (pReader->error) {
+		lscp_snapshot_unref(pvInfo);
+		pvInfo = NULL;
 	}
-	
-	return cchBuffer;
-}
 
+	return pvInfo;
+}
 
-//-------------------------------------------------------------------------
-// Effect struct helper functions.
 
-void lscp_fxsend_info_init ( lscp_fxsend_info_t *pFxSendInfo )
+static void _lscp_warm_put_devices ( lscp_warm_writer_t *pWriter, int iTag,
+	lscp_topology_device_t *pDevices, int iCount )
 {
-	pFxSendInfo->name            = NULL;
-	pFxSendInfo->midi_controller = 0;
-	pFxSendInfo->audio_routing   = NULL;
-	pFxSendInfo->level           = 0.0f;
+	int iRecord, i, j;
+
+	for (i = 0; i < iCount; i++) {
+		iRecord = _lscp_warm_begin(pWriter, iTag);
+		_lscp_warm_put_int(pWriter, pDevices[i].device);
+		_lscp_warm_put_device_info(pWriter, &(pDevices[i].info));
+		_lscp_warm_put_int(pWriter, pDevices[i].port_count);
+		for (j = 0; j < pDevices[i].port_count; j++)
+			_lscp_warm_put_port_info(pWriter, &(pDevices[i].ports[j]));
+		_lscp_warm_end(pWriter, iRecord);
+	}
 }
 
-void lscp_fxsend_info_free ( lscp_fxsend_info_t *pFxSendInfo )
+// Append a device record to a mirrored device array.
+static int _lscp_warm_get_device ( lscp_warm_reader_t *pReader,
+	lscp_topology_device_t **ppDevices, int *piCount )
 {
-	if (pFxSendInfo->name)
-		free(pFxSendInfo->name);
-	if (pFxSendInfo->audio_routing)
-		lscp_isplit_destroy(pFxSendInfo->audio_routing);
-}
+	lscp_topology_device_t *pNewDevices;
+	lscp_topology_device_t *pDevice;
+	int iPorts, i;
+
+	pNewDevices = (lscp_topology_device_t *) realloc(*ppDevices,
+		(*piCount + 1) * sizeof(lscp_topology_device_t));
+	if (pNewDevices == NULL)
+		return -1;
+
+	*ppDevices = pNewDevices;
+	pDevice = &pNewDevices[(*piCount)++];
+	lscp_topology_device_init(pDevice);
+
+	pDevice->device = _lscp_warm_get_int(pReader);
+	_lscp_warm_get_device_info(pReader, &(pDevice->info));
+	iPorts = _lscp_warm_get_int(pReader);
+	if (pReader->error || iPorts < 0 || iPorts > pReader->len)
+		return -1;
+	if (iPorts > 0) {
+		pDevice->ports = (lscp_device_port_info_t *) malloc(
+			iPorts * sizeof(lscp_device_port_info_t));
+		if (pDevice->ports == NULL)
+			return -1;
+		for (i = 0; i < iPorts; i++) {
+			lscp_device_port_info_init(&(pDevice->ports[i]));
+			pDevice->port_count++;
+			_lscp_warm_get_port_info(pReader, &(pDevice->ports[i]));
+		}
+	}
 
-void lscp_fxsend_info_reset (lscp_fxsend_info_t *pFxSendInfo )
-{
-	lscp_fxsend_info_free(pFxSendInfo);
-	lscp_fxsend_info_init(pFxSendInfo);
+	return (pReader->error ? -1 : 0);
 }
 
 
-//-------------------------------------------------------------------------
-// MIDI instrument info struct helper functions.
+static void _lscp_warm_put_maps ( lscp_warm_writer_t *pWriter,
+	lscp_midi_maps_t *pMaps )
+{
+	lscp_midi_map_t *pMap;
+	lscp_midi_instrument_info_t *pInstrInfo;
+	int iRecord, i, j;
+
+	for (i = 0; i < pMaps->map_count; i++) {
+		pMap = &(pMaps->maps[i]);
+		iRecord = _lscp_warm_begin(pWriter, LSCP_WARM_MIDI_MAP);
+		_lscp_warm_put_int(pWriter, pMap->map);
+		_lscp_warm_put_str(pWriter, pMap->name);
+		_lscp_warm_put_int(pWriter, pMap->entry_count);
+		for (j = 0; j < pMap->entry_count; j++) {
+			pInstrInfo = &(pMap->entries[j].info);
+			_lscp_warm_put_int(pWriter, pMap->entries[j].instr.bank);
+			_lscp_warm_put_int(pWriter, pMap->entries[j].instr.prog);
+			_lscp_warm_put_str(pWriter, pInstrInfo->name);
+			_lscp_warm_put_str(pWriter, pInstrInfo->engine_name);
+			_lscp_warm_put_str(pWriter, pInstrInfo->instrument_file);
+			_lscp_warm_put_int(pWriter, pInstrInfo->instrument_nr);
+			_lscp_warm_put_str(pWriter, pInstrInfo->instrument_name);
+			_lscp_warm_put_int(pWriter, (int) pInstrInfo->load_mode);
+			_lscp_warm_put_float(pWriter, pInstrInfo->volume);
+		}
+		_lscp_warm_end(pWriter, iRecord);
+	}
+}
 
-void lscp_midi_instrument_info_init ( lscp_midi_instrument_info_t *pInstrInfo )
+// Append a map record to the mirrored map array.
+static int _lscp_warm_get_map ( lscp_warm_reader_t *pReader,
+	lscp_midi_maps_t *pMaps )
 {
-	pInstrInfo->name              = NULL;
-	pInstrInfo->engine_name       = NULL;
-	pInstrInfo->instrument_file   = NULL;
-	pInstrInfo->instrument_nr     = 0;
-	pInstrInfo->instrument_name   = NULL;
-	pInstrInfo->load_mode         = LSCP_LOAD_DEFAULT;
-	pInstrInfo->volume            = 0.0;
+	lscp_midi_map_t *pNewMaps;
+	lscp_midi_map_t *pMap;
+	lscp_midi_instrument_info_t *pInstrInfo;
+	int iEntries, i;
+
+	pNewMaps = (lscp_midi_map_t *) realloc(pMaps->maps,
+		(pMaps->map_count + 1) * sizeof(lscp_midi_map_t));
+	if (pNewMaps == NULL)
+		return -1;
+
+	pMaps->maps = pNewMaps;
+	pMap = &pNewMaps[pMaps->map_count++];
+	lscp_midi_map_init(pMap);
+
+	pMap->map  = _lscp_warm_get_int(pReader);
+	pMap->name = _lscp_warm_get_strdup(pReader);
+	iEntries = _lscp_warm_get_int(pReader);
+	if (pReader->error || pMap->map < 0 || iEntries < 0 || iEntries > pReader->len)
+		return -1;
+	if (iEntries > 0) {
+		pMap->entries = (lscp_midi_map_entry_t *) malloc(
+			iEntries * sizeof(lscp_midi_map_entry_t));
+		if (pMap->entries == NULL)
+			return -1;
+		for (i = 0; i < iEntries; i++) {
+			pInstrInfo = &(pMap->entries[i].info);
+			lscp_midi_instrument_info_init(pInstrInfo);
+			pMap->entry_count++;
+			pMap->entries[i].instr.map  = pMap->map;
+			pMap->entries[i].instr.bank = _lscp_warm_get_int(pReader) & 0x3fff;
+			pMap->entries[i].instr.prog = _lscp_warm_get_int(pReader) & 0x7f;
+			pInstrInfo->name = _lscp_warm_get_intern(pReader);
+			pInstrInfo->engine_name = _lscp_warm_get_intern(pReader);
+			pInstrInfo->instrument_file = _lscp_warm_get_intern(pReader);
+			pInstrInfo->instrument_nr = _lscp_warm_get_int(pReader);
+			pInstrInfo->instrument_name = _lscp_warm_get_intern(pReader);
+			pInstrInfo->load_mode = (lscp_load_mode_t) _lscp_warm_get_int(pReader);
+			pInstrInfo->volume = _lscp_warm_get_float(pReader);
+		}
+	}
+
+	return (pReader->error ? -1 : 0);
 }
 
-void lscp_midi_instrument_info_free ( lscp_midi_instrument_info_t *pInstrInfo )
+
+// Serialize the memoized metadata and mirrors into a warm-start file,
+// keyed by the given server version (caller must own the client mutex).
+lscp_status_t lscp_warm_start_save ( lscp_client_t *pClient,
+	const char *pszFilename, const char *pszVersion )
 {
-	if (pInstrInfo->name)
-		free(pInstrInfo->name);
-	if (pInstrInfo->engine_name)
-		free(pInstrInfo->engine_name);
-	if (pInstrInfo->instrument_file)
-		free(pInstrInfo->instrument_file);
-	if (pInstrInfo->instrument_name)
-		free(pInstrInfo->instrument_name);
+	lscp_hash_t *pMetadata = &(pClient->metadata);
+	lscp_warm_writer_t writer;
+	lscp_metadata_t *pItem;
+	uint32_t w;
+	FILE *pFile;
+	int iRecord, i;
+
+	lscp_status_t ret = LSCP_OK;
+
+	writer.data  = NULL;
+	writer.size  = 0;
+	writer.len   = 0;
+	writer.error = 0;
+
+	_lscp_warm_put(&writer, LSCP_WARM_MAGIC, 8);
+	_lscp_warm_put_int(&writer, LSCP_WARM_FORMAT);
+	w = LSCP_WARM_BOM;
+	_lscp_warm_put(&writer, &w, sizeof(w));
+
+	// Server version key always comes first...
+	iRecord = _lscp_warm_begin(&writer, LSCP_WARM_SERVER);
+	_lscp_warm_put_str(&writer, pszVersion);
+	_lscp_warm_end(&writer, iRecord);
+
+	for (i = 0; i < pMetadata->size; i++) {
+		pItem = (lscp_metadata_t *) pMetadata->values[i];
+		for ( ; pItem; pItem = pItem->next) {
+			iRecord = _lscp_warm_begin(&writer, LSCP_WARM_METADATA);
+			_lscp_warm_put_str(&writer, pItem->query);
+			_lscp_warm_put_snapshot(&writer, pItem->snapshot);
+			_lscp_warm_end(&writer, iRecord);
+		}
+	}
+
+	if (pClient->device_mirror.enabled) {
+		_lscp_warm_put_devices(&writer, LSCP_WARM_AUDIO_DEVICE,
+			pClient->device_mirror.topology.audio_devices,
+			pClient->device_mirror.topology.audio_count);
+		_lscp_warm_put_devices(&writer, LSCP_WARM_MIDI_DEVICE,
+			pClient->device_mirror.topology.midi_devices,
+			pClient->device_mirror.topology.midi_count);
+	}
+
+	if (pClient->midi_mirror.enabled)
+		_lscp_warm_put_maps(&writer, &(pClient->midi_mirror.maps));
+
+	if (writer.error)
+		ret = LSCP_FAILED;
+
+	if (ret == LSCP_OK) {
+		pFile = fopen(pszFilename, "wb");
+		if (pFile == NULL)
+			ret = LSCP_FAILED;
+		else {
+			if (fwrite(writer.data, 1, writer.len, pFile) != (size_t) writer.len)
+				ret = LSCP_FAILED;
+			if (fclose(pFile) != 0)
+				ret = LSCP_FAILED;
+		}
+	}
+
+	if (writer.data)
+		free(writer.data);
+
+	return ret;
 }
 
-void lscp_midi_instrument_info_reset ( lscp_midi_instrument_info_t *pInstrInfo )
+
+// Deserialize a warm-start file contents: metadata is memoized as is,
+// while enabled mirrors are replaced by the last-known state, served
+// as such until reconciled (see lscp_client_reconcile_warm_start).
+lscp_status_t lscp_warm_start_load ( lscp_client_t *pClient,
+	const char *pchData, int cbData )
 {
-	lscp_midi_instrument_info_free(pInstrInfo);
-	lscp_midi_instrument_info_init(pInstrInfo);
+	lscp_warm_reader_t reader, record;
+	lscp_device_topology_t topology;
+	lscp_midi_maps_t maps;
+	const char *pszQuery;
+	const char *pch;
+	char *pszVersion = NULL;
+	void *pvSnapshot;
+	uint32_t w;
+	int iTag, cbRecord, i, j;
+
+	lscp_status_t ret = LSCP_OK;
+
+	reader.data  = pchData;
+	reader.len   = cbData;
+	reader.pos   = 0;
+	reader.error = 0;
+	reader.intern = pClient->intern;
+
+	// Check header...
+	pch = _lscp_warm_get(&reader, 8);
+	if (pch == NULL || memcmp(pch, LSCP_WARM_MAGIC, 8))
+		return LSCP_FAILED;
+	if (_lscp_warm_get_int(&reader) != LSCP_WARM_FORMAT)
+		return LSCP_FAILED;
+	pch = _lscp_warm_get(&reader, sizeof(w));
+	if (pch == NULL)
+		return LSCP_FAILED;
+	memcpy(&w, pch, sizeof(w));
+	if (w != LSCP_WARM_BOM)
+		return LSCP_FAILED;
+
+	lscp_device_topology_init(&topology);
+	lscp_midi_maps_init(&maps);
+
+	while (ret == LSCP_OK && reader.pos < reader.len) {
+		iTag = _lscp_warm_get_int(&reader);
+		cbRecord = _lscp_warm_get_int(&reader);
+		pch = _lscp_warm_get(&reader, cbRecord);
+		if (pch == NULL) {
+			ret = LSCP_FAILED;
+			break;
+		}
+		record.data  = pch;
+		record.len   = cbRecord;
+		record.pos   = 0;
+		record.error = 0;
+		record.intern = pClient->intern;
+		// Server version key must come first...
+		if (pszVersion == NULL && iTag != LSCP_WARM_SERVER) {
+			ret = LSCP_FAILED;
+			break;
+		}
+		switch (iTag) {
+		case LSCP_WARM_SERVER:
+			if (pszVersion == NULL)
+				pszVersion = _lscp_warm_get_strdup(&record);
+			if (pszVersion == NULL)
+				ret = LSCP_FAILED;
+			break;
+		case LSCP_WARM_METADATA:
+			pszQuery = _lscp_warm_get_str(&record);
+			pvSnapshot = _lscp_warm_get_snapshot(&record);
+			if (pszQuery && pvSnapshot)
+				pvSnapshot = lscp_metadata_insert(pClient, pszQuery, pvSnapshot, 1);
+			if (pvSnapshot)
+				lscp_snapshot_unref(pvSnapshot);
+			break;
+		case LSCP_WARM_AUDIO_DEVICE:
+			if (_lscp_warm_get_device(&record,
+					&(topology.audio_devices), &(topology.audio_count)) < 0)
+				ret = LSCP_FAILED;
+			break;
+		case LSCP_WARM_MIDI_DEVICE:
+			if (_lscp_warm_get_device(&record,
+					&(topology.midi_devices), &(topology.midi_count)) < 0)
+				ret = LSCP_FAILED;
+			break;
+		case LSCP_WARM_MIDI_MAP:
+			if (_lscp_warm_get_map(&record, &maps) < 0)
+				ret = LSCP_FAILED;
+			break;
+		default:
+			break;
+		}
+	}
+
+	if (ret != LSCP_OK) {
+		lscp_device_topology_free(&topology);
+		lscp_midi_maps_free(&maps);
+		if (pszVersion)
+			free(pszVersion);
+		return ret;
+	}
+
+	// Lock this section up.
+	lscp_mutex_lock(pClient->mutex);
+
+	// Metadata is to be validated against this...
+	if (pClient->warm_version)
+		free(pClient->warm_version);
+	pClient->warm_version = pszVersion;
+
+	// Last-known device topology, all stale...
+	if (pClient->device_mirror.enabled) {
+		lscp_mutex_lock(pClient->device_mirror.mutex);
+		lscp_device_topology_free(&(pClient->device_mirror.topology));
+		pClient->device_mirror.topology = topology;
+		lscp_device_topology_init(&topology);
+		pClient->device_mirror.audio_stale = 1;
+		pClient->device_mirror.midi_stale  = 1;
+		for (i = 0; i < pClient->device_mirror.topology.audio_count; i++) {
+			lscp_hash_insert(&(pClient->device_mirror.stale),
+				LSCP_MIRROR_KEY(LSCP_MIRROR_AUDIO,
+					pClient->device_mirror.topology.audio_devices[i].device),
+				&(pClient->device_mirror));
+		}
+		for (i = 0; i < pClient->device_mirror.topology.midi_count; i++) {
+			lscp_hash_insert(&(pClient->device_mirror.stale),
+				LSCP_MIRROR_KEY(LSCP_MIRROR_MIDI,
+					pClient->device_mirror.topology.midi_devices[i].device),
+				&(pClient->device_mirror));
+		}
+		pClient->device_mirror.warm = 1;
+		lscp_mutex_unlock(pClient->device_mirror.mutex);
+	}
+
+	// Last-known MIDI instrument maps, all stale...
+	if (pClient->midi_mirror.enabled) {
+		lscp_midi_mirror_reset(&(pClient->midi_mirror));
+		lscp_mutex_lock(pClient->midi_mirror.mutex);
+		pClient->midi_mirror.maps = maps;
+		lscp_midi_maps_init(&maps);
+		pClient->midi_mirror.lists_stale = 1;
+		for (i = 0; i < pClient->midi_mirror.maps.map_count; i++) {
+			lscp_midi_map_t *pMap = &(pClient->midi_mirror.maps.maps[i]);
+			lscp_hash_insert(&(pClient->midi_mirror.stale),
+				LSCP_MIDI_MIRROR_KEY(pMap->map, LSCP_MIDI_MIRROR_NAME),
+				&(pClient->midi_mirror));
+			for (j = 0; j < pMap->entry_count; j++) {
+				lscp_hash_insert(&(pClient->midi_mirror.stale),
+					LSCP_MIDI_MIRROR_ENTRY_KEY(pMap->map,
+						pMap->entries[j].instr.bank, pMap->entries[j].instr.prog),
+					&(pClient->midi_mirror));
+			}
+		}
+		pClient->midi_mirror.warm = 1;
+		lscp_mutex_unlock(pClient->midi_mirror.mutex);
+		lscp_midi_mirror_index(&(pClient->midi_mirror));
+	}
+
+	// Unlock this section down.
+	lscp_mutex_unlock(pClient->mutex);
+
+	// Whatever wasn't taken over...
+	lscp_device_topology_free(&topology);
+	lscp_midi_maps_free(&maps);
+
+	return ret;
 }
 
 
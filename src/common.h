@@ -26,6 +26,8 @@
 #include "lscp/client.h"
 #include "lscp/device.h"
 
+#include <stdint.h>
+
 
 // Case unsensitive comparison substitutes.
 #if defined(WIN32)
@@ -33,6 +35,643 @@
 #define strncasecmp     strnicmp
 #endif
 
+// Atomic counter and memory barrier primitives.
+#if defined(WIN32)
+#define _lscp_atomic_inc(p)  InterlockedIncrement(p)
+#define _lscp_atomic_dec(p)  InterlockedDecrement(p)
+#define _lscp_atomic_xchg(p, v) InterlockedExchange((p), (v))
+#define _lscp_atomic_barrier() MemoryBarrier()
+#else
+#define _lscp_atomic_inc(p)  __sync_add_and_fetch((p), 1)
+#define _lscp_atomic_dec(p)  __sync_sub_and_fetch((p), 1)
+#define _lscp_atomic_xchg(p, v) __sync_lock_test_and_set((p), (v))
+#define _lscp_atomic_barrier() __sync_synchronize()
+#endif
+
+//-------------------------------------------------------------------------
+// Generic hash table (open addressing, 64bit integer keys,
+// a NULL value marks an empty slot).
+
+typedef struct _lscp_hash_t
+{
+	int64_t *keys;
+	void   **values;
+	int      size;
+	int      count;
+
+} lscp_hash_t;
+
+void            lscp_hash_init         (lscp_hash_t *pHash);
+void            lscp_hash_free         (lscp_hash_t *pHash);
+void *          lscp_hash_find         (lscp_hash_t *pHash, int64_t key);
+int             lscp_hash_insert       (lscp_hash_t *pHash, int64_t key, void *pvValue);
+void *          lscp_hash_remove       (lscp_hash_t *pHash, int64_t key);
+
+//-------------------------------------------------------------------------
+// String intern pool stuff.
+
+// Interned string, header of its (shared, immutable) text.
+typedef struct _lscp_intern_item_t
+{
+	struct _lscp_intern_item_t *next;
+	struct _lscp_intern_pool_t *pool;
+	int64_t  hash;
+	int      refs;
+	char     text[1];
+
+} lscp_intern_item_t;
+
+// Interned string pool: the client holds one reference and every
+// interned string another, so that it outlives the client while any
+// of its strings is still around (eg. in an info snapshot).
+typedef struct _lscp_intern_pool_t
+{
+	int          refs;
+	lscp_hash_t  items;
+	lscp_mutex_t mutex;
+
+} lscp_intern_pool_t;
+
+lscp_intern_pool_t *lscp_intern_pool_create (void);
+void            lscp_intern_pool_release (lscp_intern_pool_t *pPool);
+char *          lscp_intern            (lscp_intern_pool_t *pPool, const char *psz);
+char *          lscp_intern_find       (lscp_intern_pool_t *pPool, const char *psz);
+void            lscp_intern_release    (const char *psz);
+
+
+//-------------------------------------------------------------------------
+// Event stream line framer stuff.
+
+// Bulk read size, and the longest (pending) line ever kept around.
+#define LSCP_FRAMER_BUFSIZ  (16 * LSCP_BUFSIZ)
+#define LSCP_FRAMER_MAXSIZ  (1024 * LSCP_BUFSIZ)
+
+// Growable carry-over buffer: received data is appended at tail,
+// complete lines are taken from head; a partial line is kept
+// pending until the rest of it arrives.
+typedef struct _lscp_framer_t
+{
+	char *buffer;
+	int   size;
+	int   head;
+	int   tail;
+	int   skip;
+
+} lscp_framer_t;
+
+void            lscp_framer_init       (lscp_framer_t *pFramer);
+void            lscp_framer_free       (lscp_framer_t *pFramer);
+char *          lscp_framer_space      (lscp_framer_t *pFramer, int *pcchSpace);
+void            lscp_framer_commit     (lscp_framer_t *pFramer, int cchData);
+char *          lscp_framer_line       (lscp_framer_t *pFramer);
+
+
+//-------------------------------------------------------------------------
+// Queued event delivery stuff.
+
+// Largest event queue capacity (slots).
+#define LSCP_EVENT_QUEUE_MAX    (1 << 20)
+
+// Queued event slot: decoded data points into its own (reused) text
+// and buffer fill storage, owned by either side while holding the slot.
+typedef struct _lscp_event_slot_t
+{
+	lscp_event_data_t   data;
+	char *              text;
+	int                 text_size;
+	lscp_buffer_fill_t *fill;
+	int                 fill_size;
+
+} lscp_event_slot_t;
+
+// Single producer (event service thread), single consumer (drainer)
+// lock-free ring; head is only ever moved by the consumer, tail by
+// the producer.
+typedef struct _lscp_event_queue_t
+{
+	lscp_event_slot_t * slots;
+	unsigned int        mask;
+	volatile unsigned int head;
+	volatile unsigned int tail;
+	lscp_queue_policy_t policy;
+	// Events dropped while full.
+	volatile unsigned long drops;
+	// Ready callback, signalled once per drain.
+	lscp_client_ready_proc_t pfnReady;
+	void *              pvReady;
+	volatile long       ready;
+
+} lscp_event_queue_t;
+
+lscp_event_queue_t *lscp_event_queue_create (int iCapacity, lscp_queue_policy_t policy, lscp_client_ready_proc_t pfnReady, void *pvReady);
+void            lscp_event_queue_destroy (lscp_event_queue_t *pQueue);
+int             lscp_event_queue_push  (lscp_event_queue_t *pQueue, lscp_event_t event, const char *pchData, int cchData);
+void            lscp_event_queue_arm   (lscp_event_queue_t *pQueue);
+lscp_event_slot_t *lscp_event_queue_front (lscp_event_queue_t *pQueue);
+void            lscp_event_queue_pop   (lscp_event_queue_t *pQueue);
+
+
+//-------------------------------------------------------------------------
+// Event conflation stuff.
+
+// Events that may ever be conflated (level, not structural, changes).
+#define LSCP_CONFLATE_EVENTS    (LSCP_EVENT_VOICE_COUNT \
+	| LSCP_EVENT_STREAM_COUNT | LSCP_EVENT_BUFFER_FILL \
+	| LSCP_EVENT_TOTAL_VOICE_COUNT)
+
+// Longest conflation interval (msecs).
+#define LSCP_CONFLATE_MAX       60000
+
+// Newest event data of one (event, sampler channel) key.
+typedef struct _lscp_conflate_item_t
+{
+	lscp_event_t        event;
+	char *              text;
+	int                 text_len;
+	int                 text_size;
+	int                 pending;
+
+	struct _lscp_conflate_item_t *next;
+
+} lscp_conflate_item_t;
+
+// Event conflation state, owned by the event service thread
+// (only the events mask and interval are set from elsewhere).
+typedef struct _lscp_conflate_t
+{
+	volatile lscp_event_t events;
+	volatile int        interval;
+	// Items by (event, sampler channel) key.
+	lscp_hash_t         items;
+	// Pending items, in order of arrival.
+	lscp_conflate_item_t *first;
+	lscp_conflate_item_t *last;
+	// Last flush time, and whether it's in progress.
+	unsigned int        flushed;
+	int                 flushing;
+
+} lscp_conflate_t;
+
+void            lscp_conflate_init     (lscp_conflate_t *pConflate);
+void            lscp_conflate_free     (lscp_conflate_t *pConflate);
+int             lscp_conflate_event    (lscp_conflate_t *pConflate, lscp_event_t event, const char *pchData, int cchData);
+int             lscp_conflate_due      (lscp_conflate_t *pConflate);
+lscp_conflate_item_t *lscp_conflate_take (lscp_conflate_t *pConflate);
+
+
+//-------------------------------------------------------------------------
+// Lazy channel info opaque descriptor struct.
+
+// Channel info response fields, in server response order.
+typedef enum _lscp_channel_field_t
+{
+	LSCP_CHANNEL_ENGINE_NAME = 0,
+	LSCP_CHANNEL_AUDIO_OUTPUT_DEVICE,
+	LSCP_CHANNEL_AUDIO_OUTPUT_CHANNELS,
+	LSCP_CHANNEL_AUDIO_OUTPUT_ROUTING,
+	LSCP_CHANNEL_INSTRUMENT_FILE,
+	LSCP_CHANNEL_INSTRUMENT_NR,
+	LSCP_CHANNEL_INSTRUMENT_NAME,
+	LSCP_CHANNEL_INSTRUMENT_STATUS,
+	LSCP_CHANNEL_MIDI_INPUT_DEVICE,
+	LSCP_CHANNEL_MIDI_INPUT_PORT,
+	LSCP_CHANNEL_MIDI_INPUT_CHANNEL,
+	LSCP_CHANNEL_MIDI_INSTRUMENT_MAP,
+	LSCP_CHANNEL_VOLUME,
+	LSCP_CHANNEL_MUTE,
+	LSCP_CHANNEL_SOLO,
+	LSCP_CHANNEL_FIELDS
+
+} lscp_channel_field_t;
+
+struct _lscp_channel_lazy_t
+{
+	// Raw response copy and its structured view.
+	lscp_response_t     response;
+	// Field response view item indexes (-1 if missing).
+	int                 values[LSCP_CHANNEL_FIELDS];
+	// Already decoded fields bitmask.
+	unsigned int        decoded;
+	// Audio routing storage (reused).
+	int *               routing;
+	int                 routing_size;
+	// Decoded field values (strings point into response copy).
+	lscp_channel_info_t info;
+};
+
+
+//-------------------------------------------------------------------------
+// Coherent channel info cache stuff.
+
+// Events the channel info cache depends on.
+#define LSCP_CHANNEL_CACHE_EVENTS (LSCP_EVENT_CHANNEL_COUNT \
+	| LSCP_EVENT_CHANNEL_INFO)
+
+// Cached channel info item.
+typedef struct _lscp_channel_cache_item_t
+{
+	// Cached channel info (owned).
+	lscp_channel_info_t info;
+	// Item is up-to-date and may be served locally.
+	int                 valid;
+	// Item got invalidated (while being refreshed).
+	int                 dirty;
+
+} lscp_channel_cache_item_t;
+
+// Channel info cache, keyed by sampler channel.
+typedef struct _lscp_channel_cache_t
+{
+	// Opt-in enabled flag.
+	int                 enabled;
+	// Events subscribed on behalf of the cache.
+	lscp_event_t        events;
+	// Cached channel info items.
+	lscp_hash_t         items;
+	// Guards items against the event thread.
+	lscp_mutex_t        mutex;
+
+} lscp_channel_cache_t;
+
+
+//-------------------------------------------------------------------------
+// All sampler channels info table stuff.
+
+// All sampler channels info table storage (reused).
+typedef struct _lscp_channel_store_t
+{
+	// Public table view.
+	lscp_channel_table_t table;
+	// Allocated rows, all columns in one single block.
+	int                 size;
+	void *              block;
+	// Private columns: row status (info received),
+	// string pool offsets (engine name, instrument file
+	// and name) and routing pool offset (-1 if none).
+	int *               status;
+	int *               strings;
+	int *               routings;
+	// Interned string pool, deduplicated by string hash.
+	char *              pool;
+	int                 pool_len;
+	int                 pool_size;
+	lscp_hash_t         interned;
+	// Audio routing pool (-1 terminated lists).
+	int *               routing;
+	int                 routing_len;
+	int                 routing_size;
+	// Sampler channel to row (plus one) index.
+	lscp_hash_t         rows;
+
+} lscp_channel_store_t;
+
+
+//-------------------------------------------------------------------------
+// Live meters stuff.
+
+// Events the live meters depend on.
+#define LSCP_METER_EVENTS       (LSCP_EVENT_VOICE_COUNT \
+	| LSCP_EVENT_STREAM_COUNT | LSCP_EVENT_BUFFER_FILL \
+	| LSCP_EVENT_TOTAL_VOICE_COUNT)
+
+// Live meter table geometry (sampler channels per block, and blocks).
+#define LSCP_METER_BLOCK_SIZE   64
+#define LSCP_METER_BLOCKS       64
+
+// Live meter item, published under a sequence lock
+// (sequence is odd while being written).
+typedef struct _lscp_meter_item_t
+{
+	volatile unsigned int seq;
+	lscp_channel_meter_t  meter;
+
+} lscp_meter_item_t;
+
+// Live meter table, indexed by sampler channel; blocks are
+// allocated on demand and only freed on client destruction.
+typedef struct _lscp_meter_table_t
+{
+	// Opt-in enabled flag.
+	int                 enabled;
+	// Events subscribed on behalf of the meters.
+	lscp_event_t        events;
+	// Total voice count, as last notified.
+	volatile int        total_voice_count;
+	// Meter item blocks.
+	lscp_meter_item_t * volatile blocks[LSCP_METER_BLOCKS];
+	// Serializes writers (readers are lock-free).
+	lscp_mutex_t        mutex;
+
+} lscp_meter_table_t;
+
+
+//-------------------------------------------------------------------------
+// Telemetry time-series stuff.
+
+// Events the telemetry depends on.
+#define LSCP_TELEMETRY_EVENTS   (LSCP_EVENT_VOICE_COUNT \
+	| LSCP_EVENT_BUFFER_FILL)
+
+// Telemetry fixed-point value scale (Q24.8).
+#define LSCP_TELEMETRY_SCALE    256
+
+// Telemetry series geometry: raw samples ring, and downsampled
+// tiers of buckets, each spanning a fixed time (msecs).
+#define LSCP_TELEMETRY_RAW      32
+#define LSCP_TELEMETRY_BUCKETS  60
+#define LSCP_TELEMETRY_TIERS    2
+#define LSCP_TELEMETRY_SPAN     1000
+#define LSCP_TELEMETRY_SPAN_X   10
+
+// Maximum number of series kept (least recently updated get dropped).
+#define LSCP_TELEMETRY_SERIES   1024
+
+// Minimum number of samples to tell a trend.
+#define LSCP_TELEMETRY_TREND    3
+
+// Pseudo stream id of the sampler channel voice count series.
+#define LSCP_TELEMETRY_VOICES   LSCP_BUFFER_FILL_END
+
+// Telemetry raw sample (time in msecs, fixed-point value).
+typedef struct _lscp_telemetry_sample_t
+{
+	unsigned int        time;
+	unsigned int        value;
+
+} lscp_telemetry_sample_t;
+
+// Telemetry downsampled bucket (time is the bucket start).
+typedef struct _lscp_telemetry_bucket_t
+{
+	unsigned int        time;
+	unsigned int        min;
+	unsigned int        mean;
+	unsigned int        count;
+
+} lscp_telemetry_bucket_t;
+
+// Telemetry downsampled tier: closed buckets ring,
+// plus the one still open, being accumulated.
+typedef struct _lscp_telemetry_tier_t
+{
+	int                 head;
+	int                 count;
+	lscp_telemetry_bucket_t buckets[LSCP_TELEMETRY_BUCKETS];
+	lscp_telemetry_bucket_t open;
+	uint64_t            open_sum;
+
+} lscp_telemetry_tier_t;
+
+// Telemetry series, of one disk stream buffer fill
+// or sampler channel voice count (fixed size).
+typedef struct _lscp_telemetry_series_t
+{
+	int                 channel;
+	unsigned int        stream;
+	// Underrun alert latch.
+	int                 alert;
+	// Raw samples ring.
+	int                 head;
+	int                 count;
+	lscp_telemetry_sample_t raw[LSCP_TELEMETRY_RAW];
+	// Downsampled tiers.
+	lscp_telemetry_tier_t tiers[LSCP_TELEMETRY_TIERS];
+
+} lscp_telemetry_series_t;
+
+// Telemetry store, keyed by sampler channel (high word)
+// and stream id (low word).
+typedef struct _lscp_telemetry_t
+{
+	// Opt-in enabled flag.
+	int                 enabled;
+	// Events subscribed on behalf of the telemetry.
+	lscp_event_t        events;
+	// All series (owned).
+	lscp_hash_t         series;
+	// Underrun prediction callback.
+	lscp_client_underrun_proc_t pfnUnderrun;
+	void *              pvUnderrun;
+	int                 horizon;
+	float               threshold;
+	// Serializes writers and readers.
+	lscp_mutex_t        mutex;
+
+} lscp_telemetry_t;
+
+// Maximum number of underrun alerts raised per recording.
+#define LSCP_TELEMETRY_ALERTS   16
+
+// Underrun alert, as raised while recording
+// (notified later, with no locks held).
+typedef struct _lscp_telemetry_alert_t
+{
+	int                 channel;
+	unsigned int        stream;
+	lscp_telemetry_stats_t stats;
+	int                 eta;
+
+} lscp_telemetry_alert_t;
+
+
+//-------------------------------------------------------------------------
+// Device topology mirror stuff.
+
+// Events the device topology mirror depends on.
+#define LSCP_MIRROR_EVENTS      (LSCP_EVENT_AUDIO_OUTPUT_DEVICE_COUNT \
+	| LSCP_EVENT_AUDIO_OUTPUT_DEVICE_INFO \
+	| LSCP_EVENT_MIDI_INPUT_DEVICE_COUNT \
+	| LSCP_EVENT_MIDI_INPUT_DEVICE_INFO)
+
+// Device topology mirror device types (stale set key high word).
+#define LSCP_MIRROR_AUDIO       0
+#define LSCP_MIRROR_MIDI        1
+
+// Device topology mirror stale set key: device type (high word)
+// and device number (low word, not sign extended).
+#define LSCP_MIRROR_KEY(type, device) \
+	((int64_t) (((uint64_t) (uint32_t) (type) << 32) | (uint32_t) (device)))
+
+// Device topology mirror.
+typedef struct _lscp_device_mirror_t
+{
+	// Opt-in enabled flag.
+	int                 enabled;
+	// Events subscribed on behalf of the mirror.
+	lscp_event_t        events;
+	// Mirrored device topology (owned).
+	lscp_device_topology_t topology;
+	// Stale device lists, as of *_DEVICE_COUNT notifications.
+	int                 audio_stale;
+	int                 midi_stale;
+	// Stale devices, as of *_DEVICE_INFO notifications,
+	// keyed by device type (high word) and number (low word).
+	lscp_hash_t         stale;
+	// Last-known state, as loaded from a warm-start file,
+	// served as is until reconciled with the server.
+	int                 warm;
+	// Guards stale state against the event thread.
+	lscp_mutex_t        mutex;
+
+} lscp_device_mirror_t;
+
+
+//-------------------------------------------------------------------------
+// MIDI instrument map mirror stuff.
+
+// Events the MIDI instrument map mirror depends on.
+#define LSCP_MIDI_MIRROR_EVENTS (LSCP_EVENT_MIDI_INSTRUMENT_MAP_COUNT \
+	| LSCP_EVENT_MIDI_INSTRUMENT_MAP_INFO \
+	| LSCP_EVENT_MIDI_INSTRUMENT_COUNT \
+	| LSCP_EVENT_MIDI_INSTRUMENT_INFO)
+
+// MIDI instrument map mirror stale set keys: map number (high word),
+// and either bank and program, or whole map flags (low word).
+#define LSCP_MIDI_MIRROR_NAME   0x01000000
+#define LSCP_MIDI_MIRROR_LIST   0x02000000
+
+#define LSCP_MIDI_MIRROR_KEY(map, low) \
+	((int64_t) (((uint64_t) (uint32_t) (map) << 32) | (uint32_t) (low)))
+#define LSCP_MIDI_MIRROR_ENTRY_KEY(map, bank, prog) \
+	LSCP_MIDI_MIRROR_KEY(map, ((bank) << 7) | (prog))
+
+// Whole map list and all map entry lists pseudo-keys.
+#define LSCP_MIDI_MIRROR_MAPS   LSCP_MIDI_MIRROR_KEY(-1, 0)
+#define LSCP_MIDI_MIRROR_LISTS  LSCP_MIDI_MIRROR_KEY(-1, LSCP_MIDI_MIRROR_LIST)
+
+// MIDI instrument map mirror index node
+// (chained on same name or file).
+typedef struct _lscp_midi_mirror_node_t
+{
+	lscp_midi_map_entry_t *entry;
+
+	struct _lscp_midi_mirror_node_t *next;
+
+} lscp_midi_mirror_node_t;
+
+// MIDI instrument map mirror.
+typedef struct _lscp_midi_mirror_t
+{
+	// Opt-in enabled flag.
+	int                 enabled;
+	// Events subscribed on behalf of the mirror.
+	lscp_event_t        events;
+	// Mirrored MIDI instrument maps (owned).
+	lscp_midi_maps_t    maps;
+	// Lookup indexes, rebuilt on every refresh:
+	// entries by map, bank and program key;
+	// entry node chains by name and file hash.
+	lscp_hash_t         entries;
+	lscp_hash_t         names;
+	lscp_hash_t         files;
+	lscp_midi_mirror_node_t *nodes;
+	// Last lookup results (NULL terminated).
+	const lscp_midi_map_entry_t **found;
+	int                 found_size;
+	// Stale map list, as of MIDI_INSTRUMENT_MAP_COUNT notifications.
+	int                 maps_stale;
+	// Stale entry lists of all maps (as of clearing them all).
+	int                 lists_stale;
+	// Stale maps and entries, as of MIDI_INSTRUMENT_MAP_INFO,
+	// MIDI_INSTRUMENT_COUNT and MIDI_INSTRUMENT_INFO notifications.
+	lscp_hash_t         stale;
+	// Last-known state, as loaded from a warm-start file,
+	// served as is until reconciled with the server.
+	int                 warm;
+	// Guards stale state against the event thread.
+	lscp_mutex_t        mutex;
+
+} lscp_midi_mirror_t;
+
+
+//-------------------------------------------------------------------------
+// Event handler registry stuff.
+
+// Handlers copied on the stack per dispatch (more go on the heap).
+#define LSCP_HANDLER_COPIES     16
+
+// Registered event handler, chained on the same (event, id) key.
+typedef struct _lscp_handler_t
+{
+	int                 handle;
+	lscp_event_t        event;
+	int                 id;
+	lscp_client_event_proc_t pfnHandler;
+	void *              pvData;
+
+	struct _lscp_handler_t *next;
+
+} lscp_handler_t;
+
+// Event handler registry: handler chains keyed by event (high word)
+// and sampler channel, device or map (low word, zero for any).
+typedef struct _lscp_handler_table_t
+{
+	// Events subscribed on behalf of the handlers.
+	lscp_event_t        events;
+	// Events with any handlers registered.
+	volatile lscp_event_t registered;
+	// Handler chains by (event, id) key, and handlers by handle.
+	lscp_hash_t         chains;
+	lscp_hash_t         handles;
+	int                 next_handle;
+	// Number of handlers per event (bit).
+	volatile int        counts[32];
+	// Guards it all against the event dispatch.
+	lscp_mutex_t        mutex;
+
+} lscp_handler_table_t;
+
+void            lscp_handler_table_init     (lscp_handler_table_t *pTable);
+void            lscp_handler_table_free     (lscp_handler_table_t *pTable);
+int             lscp_handler_table_add      (lscp_handler_table_t *pTable, lscp_event_t event, int iId, lscp_client_event_proc_t pfnHandler, void *pvData);
+lscp_event_t    lscp_handler_table_remove   (lscp_handler_table_t *pTable, int iHandle);
+int             lscp_handler_table_count    (lscp_handler_table_t *pTable, lscp_event_t event);
+lscp_status_t   lscp_handler_table_dispatch (lscp_handler_table_t *pTable, lscp_client_t *pClient, const lscp_event_data_t *pEventData);
+
+
+//-------------------------------------------------------------------------
+// MIDI events fast path stuff.
+
+// MIDI event notifications (as bit flags).
+#define LSCP_MIDI_EVENTS        (LSCP_EVENT_CHANNEL_MIDI | LSCP_EVENT_DEVICE_MIDI)
+
+// Most MIDI event records delivered at once.
+#define LSCP_MIDI_BATCH         64
+
+// MIDI event records batch (owned by the event service thread).
+typedef struct _lscp_midi_batch_t
+{
+	lscp_midi_event_t   events[LSCP_MIDI_BATCH];
+	int                 count;
+
+} lscp_midi_batch_t;
+
+
+//-------------------------------------------------------------------------
+// Event (un)subscription replies stuff.
+
+// Most (un)subscription requests in flight at once.
+#define LSCP_EVT_REPLIES        32
+
+// Pipelined (un)subscription replies, matched to their requests
+// in order, as received by the event service thread.
+typedef struct _lscp_evt_reply_t
+{
+	int                 expected;
+	int                 received;
+	int                 timeout;
+	lscp_status_t       status[LSCP_EVT_REPLIES];
+	// First error message, if any.
+	int                 failed;
+	int                 errnum;
+	char                result[LSCP_BUFSIZ];
+	lscp_mutex_t        mutex;
+	lscp_cond_t         cond;
+
+} lscp_evt_reply_t;
+
+
 //-------------------------------------------------------------------------
 // Client opaque descriptor struct.
 
@@ -41,10 +680,34 @@ struct _lscp_client_t
 	// Client socket stuff.
 	lscp_client_proc_t  pfnCallback;
 	void *              pvData;
+	// Decoded event callback stuff.
+	lscp_client_event_proc_t pfnEventCallback;
+	void *              pvEventData;
+	volatile unsigned int event_seq;	// Odd while (re)setting the pair.
+	lscp_buffer_fill_t *event_fill;
+	int                 event_fill_size;
+	lscp_framer_t       evt_framer;
+	// Queued event delivery (NULL for direct callbacks),
+	// busy while the event service thread is handing over.
+	lscp_event_queue_t * volatile evt_queue;
+	volatile int        evt_queue_busy;
+	lscp_mutex_t        evt_queue_mutex;
+	// Event conflation (owned by the event service thread).
+	lscp_conflate_t     evt_conflate;
+	// Pipelined event (un)subscription replies.
+	lscp_evt_reply_t    evt_reply;
+	// Event handler registry.
+	lscp_handler_table_t handlers;
+	// MIDI events fast path (batched).
+	lscp_client_midi_proc_t pfnMidiCallback;
+	void *              pvMidiData;
+	lscp_midi_batch_t   midi_batch;
 	lscp_socket_agent_t cmd;
 	lscp_socket_agent_t evt;
 	// Subscribed events.
 	lscp_event_t        events;
+	// String intern pool (engine, driver and instrument names).
+	lscp_intern_pool_t *intern;
 	// Client struct persistent caches.
 	char **             audio_drivers;
 	char **             midi_drivers;
@@ -57,19 +720,30 @@ struct _lscp_client_t
 	int  *              midi_maps;
 	char *              midi_map_name;
 	// Client struct volatile caches.
-	lscp_driver_info_t  audio_driver_info;
-	lscp_driver_info_t  midi_driver_info;
 	lscp_device_info_t  audio_device_info;
 	lscp_device_info_t  midi_device_info;
-	lscp_param_info_t   audio_param_info;
-	lscp_param_info_t   midi_param_info;
 	lscp_device_port_info_t audio_channel_info;
 	lscp_device_port_info_t midi_port_info;
 	lscp_param_info_t   audio_channel_param_info;
 	lscp_param_info_t   midi_port_param_info;
 	lscp_server_info_t  server_info;
-	lscp_engine_info_t  engine_info;
 	lscp_channel_info_t channel_info;
+	lscp_channel_lazy_t channel_lazy;
+	lscp_channel_cache_t channel_cache;
+	lscp_channel_store_t channel_store;
+	// Scene convergence commands (NULL terminated).
+	char **             scene_commands;
+	int                 scene_count;
+	int                 scene_size;
+	lscp_meter_table_t  meters;
+	lscp_telemetry_t    telemetry;
+	lscp_device_mirror_t device_mirror;
+	lscp_midi_mirror_t  midi_mirror;
+	// Memoized metadata (driver, engine and parameter info).
+	lscp_hash_t         metadata;
+	// Server version the warm-start state was saved against,
+	// pending reconciliation (NULL if none was loaded).
+	char *              warm_version;
 	lscp_fxsend_info_t  fxsend_info;
 	lscp_midi_instrument_info_t midi_instrument_info;
 	// Result and error status.
@@ -77,6 +751,7 @@ struct _lscp_client_t
 	int                 iErrno;
 	// Stream buffers status.
 	lscp_buffer_fill_t *buffer_fill;
+	int                 buffer_fill_size;
 	int                 iStreamCount;
 	// Transaction call timeout (msecs).
 	int                 iTimeout;
@@ -92,15 +767,46 @@ struct _lscp_client_t
 
 lscp_status_t   lscp_client_recv            (lscp_client_t *pClient, char *pchBuffer, int *pcchBuffer, int iTimeout);
 lscp_status_t   lscp_client_call            (lscp_client_t *pClient, const char *pszQuery, int iResult);
+
+// Pipelined request response callback (in query order).
+typedef void (*lscp_client_batch_proc_t) (lscp_client_t *pClient, int iQuery, lscp_status_t ret, char *pszResult, void *pvData);
+
+lscp_status_t   lscp_client_call_batch      (lscp_client_t *pClient, const char **ppszQueries, int iQueries, int iResult, lscp_client_batch_proc_t pfnResult, void *pvData);
+lscp_status_t   lscp_client_call_mixed      (lscp_client_t *pClient, const char **ppszQueries, int iQueries, const int *piResults, lscp_client_batch_proc_t pfnResult, void *pvData);
 void            lscp_client_set_result      (lscp_client_t *pClient, char *pszResult, int iErrno);
+lscp_status_t   lscp_client_frame_result    (char *pchFrame, int cchFrame, int iResult, char **ppszResult, int *piErrno);
+
+// Pipelined mirror query string slot size.
+#define LSCP_MIRROR_QUERY   64
+
+// Pipelined mirror requests, with a target per query.
+typedef struct _lscp_mirror_batch_t
+{
+	int           count;
+	int           size;
+	char *        queries;
+	const char ** ppszQueries;
+	void **       targets;
+
+} lscp_mirror_batch_t;
+
+int             lscp_mirror_batch_init      (lscp_mirror_batch_t *pBatch, int iSize);
+void            lscp_mirror_batch_free      (lscp_mirror_batch_t *pBatch);
+char *          lscp_mirror_batch_add       (lscp_mirror_batch_t *pBatch, void *pvTarget);
 
 //-------------------------------------------------------------------------
 // General utility function prototypes.
 
+char *          lscp_strpbrk           (const char *psz, const char *pszSeps);
+char *          lscp_strscan           (const char *psz, const char *pszSeps);
+int             lscp_atoi              (const char *psz);
+float           lscp_atof              (const char *psz);
+int             lscp_ftoa              (char *pszBuffer, int cchMaxBuffer, float f);
 char *          lscp_strtok            (char *pchBuffer, const char *pszSeps, char **ppch);
 char *          lscp_ltrim             (char *psz);
 char *          lscp_unquote           (char **ppsz, int dup);
 void            lscp_unquote_dup       (char **ppszDst, char **ppszSrc);
+void            lscp_unquote_intern    (lscp_intern_pool_t *pPool, char **ppszDst, char **ppszSrc);
 
 char **         lscp_szsplit_create    (const char *pszCsv, const char *pszSeps);
 void            lscp_szsplit_destroy   (char **ppszSplit);
@@ -126,6 +832,8 @@ int             lscp_psplit_size       (lscp_param_t *ppSplit);
 void            lscp_plist_alloc       (lscp_param_t **ppList);
 void            lscp_plist_free        (lscp_param_t **ppList);
 void            lscp_plist_append      (lscp_param_t **ppList, const char *pszKey, const char *pszValue);
+const char *    lscp_plist_find        (lscp_param_t *pParams, const char *pszKey);
+int             lscp_plist_indexed     (lscp_param_t *pParams);
 #ifdef LSCP_PLIST_COUNT
 int             lscp_plist_count       (lscp_param_t **ppList);
 int             lscp_plist_size        (lscp_param_t **ppList);
@@ -139,6 +847,14 @@ int             lscp_midi_instruments_size    (lscp_midi_instrument_t *pInstrs);
 #endif
 
 
+//-------------------------------------------------------------------------
+// Event notification data decoder.
+
+int             lscp_event_data_decode (lscp_event_data_t *pEventData, lscp_event_t event, const char *pchData, int cchData, lscp_buffer_fill_t **ppFill, int *piFillSize);
+int             lscp_buffer_fill_parse (const char *pch, const char *pchEnd, lscp_buffer_fill_t **ppFill, int *piFillSize, int *piPercentage);
+lscp_event_t    lscp_midi_event_decode (lscp_midi_event_t *pMidiEvent, const char *pszLine);
+
+
 //-------------------------------------------------------------------------
 // Server struct helper functions.
 
@@ -159,6 +875,70 @@ void            lscp_engine_info_reset      (lscp_engine_info_t *pEngineInfo);
 void            lscp_channel_info_init      (lscp_channel_info_t *pChannelInfo);
 void            lscp_channel_info_free      (lscp_channel_info_t *pChannelInfo);
 void            lscp_channel_info_reset     (lscp_channel_info_t *pChannelInfo);
+void            lscp_channel_info_copy      (lscp_intern_pool_t *pPool, lscp_channel_info_t *pDst, const lscp_channel_info_t *pSrc);
+
+void            lscp_channel_lazy_init      (lscp_channel_lazy_t *pChannelLazy);
+void            lscp_channel_lazy_free      (lscp_channel_lazy_t *pChannelLazy);
+
+void            lscp_channel_cache_init     (lscp_channel_cache_t *pChannelCache);
+void            lscp_channel_cache_free     (lscp_channel_cache_t *pChannelCache);
+void            lscp_channel_cache_flush    (lscp_channel_cache_t *pChannelCache);
+void            lscp_channel_cache_invalidate (lscp_channel_cache_t *pChannelCache, int iSamplerChannel);
+
+void            lscp_channel_store_init     (lscp_channel_store_t *pStore);
+void            lscp_channel_store_free     (lscp_channel_store_t *pStore);
+int             lscp_channel_store_reset    (lscp_channel_store_t *pStore, int iRows);
+int             lscp_channel_store_set      (lscp_channel_store_t *pStore, int iRow, lscp_channel_info_t *pChannelInfo);
+int             lscp_channel_store_commit   (lscp_channel_store_t *pStore);
+
+//-------------------------------------------------------------------------
+// Live meter table helper functions.
+
+void            lscp_meter_table_init       (lscp_meter_table_t *pMeters);
+void            lscp_meter_table_free       (lscp_meter_table_t *pMeters);
+void            lscp_meter_table_reset      (lscp_meter_table_t *pMeters);
+void            lscp_meter_table_update     (lscp_meter_table_t *pMeters, const lscp_event_data_t *pEventData);
+int             lscp_meter_table_read       (lscp_meter_table_t *pMeters, int iSamplerChannel, lscp_channel_meter_t *pMeter);
+
+//-------------------------------------------------------------------------
+// Telemetry time-series helper functions.
+
+void            lscp_telemetry_init         (lscp_telemetry_t *pTelemetry);
+void            lscp_telemetry_free         (lscp_telemetry_t *pTelemetry);
+void            lscp_telemetry_reset        (lscp_telemetry_t *pTelemetry);
+int             lscp_telemetry_fill         (lscp_telemetry_t *pTelemetry, int iSamplerChannel, const lscp_buffer_fill_t *pFill, int iFillCount, lscp_telemetry_alert_t *pAlerts);
+int             lscp_telemetry_update       (lscp_telemetry_t *pTelemetry, const lscp_event_data_t *pEventData, lscp_telemetry_alert_t *pAlerts);
+void            lscp_telemetry_notify       (lscp_client_t *pClient, const lscp_telemetry_alert_t *pAlerts, int iAlerts);
+int             lscp_telemetry_stats        (lscp_telemetry_t *pTelemetry, int iSamplerChannel, unsigned int iStreamId, int iWindow, lscp_telemetry_stats_t *pStats);
+
+//-------------------------------------------------------------------------
+// Device topology mirror helper functions.
+
+void            lscp_device_topology_init   (lscp_device_topology_t *pTopology);
+void            lscp_device_topology_free   (lscp_device_topology_t *pTopology);
+void            lscp_topology_device_init   (lscp_topology_device_t *pDevice);
+void            lscp_topology_device_free   (lscp_topology_device_t *pDevice);
+
+void            lscp_device_mirror_init     (lscp_device_mirror_t *pMirror);
+void            lscp_device_mirror_free     (lscp_device_mirror_t *pMirror);
+void            lscp_device_mirror_stale    (lscp_device_mirror_t *pMirror, int iType, int iDevice);
+void            lscp_device_mirror_event    (lscp_device_mirror_t *pMirror, lscp_event_t event, const char *pszData);
+
+//-------------------------------------------------------------------------
+// MIDI instrument map mirror helper functions.
+
+void            lscp_midi_maps_init         (lscp_midi_maps_t *pMaps);
+void            lscp_midi_maps_free         (lscp_midi_maps_t *pMaps);
+void            lscp_midi_map_init          (lscp_midi_map_t *pMap);
+void            lscp_midi_map_free          (lscp_midi_map_t *pMap);
+
+void            lscp_midi_mirror_init       (lscp_midi_mirror_t *pMirror);
+void            lscp_midi_mirror_free       (lscp_midi_mirror_t *pMirror);
+void            lscp_midi_mirror_reset      (lscp_midi_mirror_t *pMirror);
+void            lscp_midi_mirror_stale      (lscp_midi_mirror_t *pMirror, int64_t key);
+void            lscp_midi_mirror_event      (lscp_midi_mirror_t *pMirror, lscp_event_t event, const char *pszData);
+int             lscp_midi_mirror_index      (lscp_midi_mirror_t *pMirror);
+const lscp_midi_map_entry_t **lscp_midi_mirror_lookup (lscp_midi_mirror_t *pMirror, int iFile, const char *pszKey, int iInstrIndex);
 
 //-------------------------------------------------------------------------
 // Driver struct helper functions.
@@ -207,6 +987,38 @@ void            lscp_midi_instrument_info_init  (lscp_midi_instrument_info_t *pI
 void            lscp_midi_instrument_info_free  (lscp_midi_instrument_info_t *pInstrInfo);
 void            lscp_midi_instrument_info_reset (lscp_midi_instrument_info_t *pInstrInfo);
 
+//-------------------------------------------------------------------------
+// Reference-counted info snapshot helper functions.
+
+typedef enum _lscp_snapshot_type_t
+{
+	LSCP_SNAPSHOT_SERVER_INFO = 0,
+	LSCP_SNAPSHOT_ENGINE_INFO,
+	LSCP_SNAPSHOT_CHANNEL_INFO,
+	LSCP_SNAPSHOT_FXSEND_INFO,
+	LSCP_SNAPSHOT_MIDI_INSTRUMENT_INFO,
+	LSCP_SNAPSHOT_DRIVER_INFO,
+	LSCP_SNAPSHOT_DEVICE_INFO,
+	LSCP_SNAPSHOT_DEVICE_PORT_INFO,
+	LSCP_SNAPSHOT_PARAM_INFO
+
+} lscp_snapshot_type_t;
+
+void *          lscp_snapshot_alloc         (lscp_snapshot_type_t type);
+
+//-------------------------------------------------------------------------
+// Memoized metadata cache helper functions (keyed by query string).
+
+void *          lscp_metadata_find          (lscp_client_t *pClient, const char *pszQuery, int iSnapshot);
+void *          lscp_metadata_insert        (lscp_client_t *pClient, const char *pszQuery, void *pvSnapshot, int iSnapshot);
+void            lscp_metadata_flush         (lscp_client_t *pClient);
+
+//-------------------------------------------------------------------------
+// Warm-start cache file helper functions.
+
+lscp_status_t   lscp_warm_start_save        (lscp_client_t *pClient, const char *pszFilename, const char *pszVersion);
+lscp_status_t   lscp_warm_start_load        (lscp_client_t *pClient, const char *pchData, int cbData);
+
 
 #endif // __LSCP_COMMON_H
 
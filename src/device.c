@@ -26,11 +26,18 @@
 // Local prototypes.
 
 static lscp_driver_info_t *_lscp_driver_info_query (lscp_client_t *pClient, lscp_driver_info_t *pDriverInfo, char *pszQuery);
+static void _lscp_device_info_parse (lscp_intern_pool_t *pPool, lscp_device_info_t *pDeviceInfo, char *pszResult);
 static lscp_device_info_t *_lscp_device_info_query (lscp_client_t *pClient, lscp_device_info_t *pDeviceInfo, char *pszQuery);
 static lscp_param_info_t  *_lscp_param_info_query  (lscp_client_t *pClient, lscp_param_info_t *pParamInfo, char *pszQuery, int cchMaxQuery, lscp_param_t *pDepList);
 
+static void _lscp_device_port_info_parse (lscp_device_port_info_t *pDevicePortInfo, char *pszResult);
 static lscp_device_port_info_t *_lscp_device_port_info_query (lscp_client_t *pClient, lscp_device_port_info_t *pDevicePortInfo, char *pszQuery);
 
+static lscp_driver_info_t *_lscp_driver_info_cached (lscp_client_t *pClient, char *pszQuery, int iSnapshot);
+
+static void _lscp_device_mirror_touch (lscp_client_t *pClient, int iType, int iDevice);
+static lscp_param_info_t  *_lscp_param_info_cached  (lscp_client_t *pClient, char *pszQuery, int cchMaxQuery, lscp_param_t *pDepList, int iSnapshot);
+
 
 //-------------------------------------------------------------------------
 // Local funtions.
@@ -82,38 +89,42 @@ static lscp_driver_info_t *_lscp_driver_info_query ( lscp_client_t *pClient, lsc
 }
 
 
-// Common device info query command.
-static lscp_device_info_t *_lscp_device_info_query ( lscp_client_t *pClient, lscp_device_info_t *pDeviceInfo, char *pszQuery )
+// Common device info response parser.
+static void _lscp_device_info_parse ( lscp_intern_pool_t *pPool, lscp_device_info_t *pDeviceInfo, char *pszResult )
 {
-	const char *pszResult;
 	const char *pszSeps = ":";
 	const char *pszCrlf = "\r\n";
 	char *pszToken;
 	char *pch;
 	char *pszKey;
 
+	pszToken = lscp_strtok(pszResult, pszSeps, &(pch));
+	while (pszToken) {
+		if (strcasecmp(pszToken, "DRIVER") == 0) {
+			pszToken = lscp_strtok(NULL, pszCrlf, &(pch));
+			if (pszToken)
+				lscp_unquote_intern(pPool, &(pDeviceInfo->driver), &pszToken);
+		}
+		else {
+			pszKey = pszToken;
+			pszToken = lscp_strtok(NULL, pszCrlf, &(pch));
+			if (pszToken)
+				lscp_plist_append(&(pDeviceInfo->params), pszKey, lscp_unquote(&pszToken, 0));
+		}
+		pszToken = lscp_strtok(NULL, pszSeps, &(pch));
+	}
+}
+
+
+// Common device info query command.
+static lscp_device_info_t *_lscp_device_info_query ( lscp_client_t *pClient, lscp_device_info_t *pDeviceInfo, char *pszQuery )
+{
 	// Lock this section up.
 	lscp_mutex_lock(pClient->mutex);
 
 	lscp_device_info_reset(pDeviceInfo);
-	if (lscp_client_call(pClient, pszQuery, 1) == LSCP_OK) {
-		pszResult = lscp_client_get_result(pClient);
-		pszToken = lscp_strtok((char *) pszResult, pszSeps, &(pch));
-		while (pszToken) {
-			if (strcasecmp(pszToken, "DRIVER") == 0) {
-				pszToken = lscp_strtok(NULL, pszCrlf, &(pch));
-				if (pszToken)
-					lscp_unquote_dup(&(pDeviceInfo->driver), &pszToken);
-			}
-			else {
-				pszKey = pszToken;
-				pszToken = lscp_strtok(NULL, pszCrlf, &(pch));
-				if (pszToken)
-					lscp_plist_append(&(pDeviceInfo->params), pszKey, lscp_unquote(&pszToken, 0));
-			}
-			pszToken = lscp_strtok(NULL, pszSeps, &(pch));
-		}
-	}
+	if (lscp_client_call(pClient, pszQuery, 1) == LSCP_OK)
+		_lscp_device_info_parse(pClient->intern, pDeviceInfo, (char *) lscp_client_get_result(pClient));
 	else pDeviceInfo = NULL;
 
 	// Unlock this section down.
@@ -123,10 +134,9 @@ static lscp_device_info_t *_lscp_device_info_query ( lscp_client_t *pClient, lsc
 }
 
 
-// Common device channel/port info query command.
-static lscp_device_port_info_t *_lscp_device_port_info_query ( lscp_client_t *pClient, lscp_device_port_info_t *pDevicePortInfo, char *pszQuery )
+// Common device channel/port info response parser.
+static void _lscp_device_port_info_parse ( lscp_device_port_info_t *pDevicePortInfo, char *pszResult )
 {
-	const char *pszResult;
 	const char *pszSeps = ":";
 	const char *pszCrlf = "\r\n";
 	char *pszToken;
@@ -134,31 +144,36 @@ static lscp_device_port_info_t *_lscp_device_port_info_query ( lscp_client_t *pC
 	char *pszKey;
 	char *pszVal;
 
+	pszToken = lscp_strtok(pszResult, pszSeps, &(pch));
+	while (pszToken) {
+		pszKey = pszToken;
+		pszToken = lscp_strtok(NULL, pszCrlf, &(pch));
+		if (pszKey && pszToken) {
+			pszVal = lscp_unquote(&pszToken, 0); 
+			lscp_plist_append(&(pDevicePortInfo->params), pszKey, pszVal);
+			if (strcasecmp(pszKey, "NAME") == 0) {
+				// Free desteny string, if already there.
+				if (pDevicePortInfo->name)
+					free(pDevicePortInfo->name);
+				pDevicePortInfo->name = NULL;
+				if (pszVal)
+					pDevicePortInfo->name = strdup(pszVal);
+			}
+		}
+		pszToken = lscp_strtok(NULL, pszSeps, &(pch));
+	}
+}
+
+
+// Common device channel/port info query command.
+static lscp_device_port_info_t *_lscp_device_port_info_query ( lscp_client_t *pClient, lscp_device_port_info_t *pDevicePortInfo, char *pszQuery )
+{
 	// Lock this section up.
 	lscp_mutex_lock(pClient->mutex);
 
 	lscp_device_port_info_reset(pDevicePortInfo);
-	if (lscp_client_call(pClient, pszQuery, 1) == LSCP_OK) {
-		pszResult = lscp_client_get_result(pClient);
-		pszToken = lscp_strtok((char *) pszResult, pszSeps, &(pch));
-		while (pszToken) {
-			pszKey = pszToken;
-			pszToken = lscp_strtok(NULL, pszCrlf, &(pch));
-			if (pszKey && pszToken) {
-				pszVal = lscp_unquote(&pszToken, 0); 
-				lscp_plist_append(&(pDevicePortInfo->params), pszKey, pszVal);
-				if (strcasecmp(pszKey, "NAME") == 0) {
-					// Free desteny string, if already there.
-					if (pDevicePortInfo->name)
-						free(pDevicePortInfo->name);
-					pDevicePortInfo->name = NULL;
-					if (pszVal)
-						pDevicePortInfo->name = strdup(pszVal);
-				}
-			}
-			pszToken = lscp_strtok(NULL, pszSeps, &(pch));
-		}
-	}
+	if (lscp_client_call(pClient, pszQuery, 1) == LSCP_OK)
+		_lscp_device_port_info_parse(pDevicePortInfo, (char *) lscp_client_get_result(pClient));
 	else pDevicePortInfo = NULL;
 
 	// Unlock this section down.
@@ -263,6 +278,67 @@ static lscp_param_info_t *_lscp_param_info_query ( lscp_client_t *pClient, lscp_
 }
 
 
+// Memoized driver info query (driver metadata never changes while
+// the server is running). Returns the cached info, with an additional
+// reference on behalf of the caller if iSnapshot is set.
+static lscp_driver_info_t *_lscp_driver_info_cached ( lscp_client_t *pClient, char *pszQuery, int iSnapshot )
+{
+	lscp_driver_info_t *pDriverInfo;
+
+	pDriverInfo = (lscp_driver_info_t *) lscp_metadata_find(pClient, pszQuery, iSnapshot);
+	if (pDriverInfo)
+		return pDriverInfo;
+
+	pDriverInfo = (lscp_driver_info_t *) lscp_snapshot_alloc(LSCP_SNAPSHOT_DRIVER_INFO);
+	if (pDriverInfo == NULL)
+		return NULL;
+
+	if (_lscp_driver_info_query(pClient, pDriverInfo, pszQuery) == NULL) {
+		lscp_snapshot_unref(pDriverInfo);
+		return NULL;
+	}
+
+	return (lscp_driver_info_t *) lscp_metadata_insert(pClient, pszQuery, pDriverInfo, iSnapshot);
+}
+
+
+// Memoized driver parameter info query, keyed by the whole query
+// (driver, parameter and dependency list) likewise.
+static lscp_param_info_t *_lscp_param_info_cached ( lscp_client_t *pClient, char *pszQuery, int cchMaxQuery, lscp_param_t *pDepList, int iSnapshot )
+{
+	lscp_param_info_t *pParamInfo;
+	char szKey[LSCP_BUFSIZ];
+
+	strncpy(szKey, pszQuery, sizeof(szKey) - 1);
+	szKey[sizeof(szKey) - 1] = (char) 0;
+	lscp_param_concat(szKey, sizeof(szKey), pDepList);
+
+	pParamInfo = (lscp_param_info_t *) lscp_metadata_find(pClient, szKey, iSnapshot);
+	if (pParamInfo)
+		return pParamInfo;
+
+	pParamInfo = (lscp_param_info_t *) lscp_snapshot_alloc(LSCP_SNAPSHOT_PARAM_INFO);
+	if (pParamInfo == NULL)
+		return NULL;
+
+	if (_lscp_param_info_query(pClient, pParamInfo, pszQuery, cchMaxQuery, pDepList) == NULL) {
+		lscp_snapshot_unref(pParamInfo);
+		return NULL;
+	}
+
+	return (lscp_param_info_t *) lscp_metadata_insert(pClient, szKey, pParamInfo, iSnapshot);
+}
+
+
+// Mark a device (or the device list, if iDevice < 0) stale in the
+// device topology mirror, on behalf of our own changes to it.
+static void _lscp_device_mirror_touch ( lscp_client_t *pClient, int iType, int iDevice )
+{
+	if (pClient->device_mirror.enabled)
+		lscp_device_mirror_stale(&(pClient->device_mirror), iType, iDevice);
+}
+
+
 //-------------------------------------------------------------------------
 // Audio driver control functions.
 
@@ -286,7 +362,7 @@ int lscp_get_available_audio_drivers ( lscp_client_t *pClient )
 	lscp_mutex_lock(pClient->mutex);
 
 	if (lscp_client_call(pClient, "GET AVAILABLE_AUDIO_OUTPUT_DRIVERS\r\n", 0) == LSCP_OK)
-		iAudioDrivers = atoi(lscp_client_get_result(pClient));
+		iAudioDrivers = lscp_atoi(lscp_client_get_result(pClient));
 
 	// Unlock this section down.
 	lscp_mutex_unlock(pClient->mutex);
@@ -314,12 +390,9 @@ const char ** lscp_list_available_audio_drivers ( lscp_client_t *pClient )
 	// Lock this section up.
 	lscp_mutex_lock(pClient->mutex);
 
-	if (pClient->audio_drivers) {
-		lscp_szsplit_destroy(pClient->audio_drivers);
-		pClient->audio_drivers = NULL;
-	}
-
-	if (lscp_client_call(pClient, "LIST AVAILABLE_AUDIO_OUTPUT_DRIVERS\r\n", 0) == LSCP_OK)
+	// Memoized, until flushed...
+	if (pClient->audio_drivers == NULL
+		&& lscp_client_call(pClient, "LIST AVAILABLE_AUDIO_OUTPUT_DRIVERS\r\n", 0) == LSCP_OK)
 		pClient->audio_drivers = lscp_szsplit_create(lscp_client_get_result(pClient), pszSeps);
 
 	// Unlock this section down.
@@ -343,11 +416,39 @@ lscp_driver_info_t* lscp_get_audio_driver_info ( lscp_client_t *pClient, const c
 {
 	char szQuery[LSCP_BUFSIZ];
 
+	if (pClient == NULL)
+		return NULL;
+	if (pszAudioDriver == NULL)
+		return NULL;
+
+	sprintf(szQuery, "GET AUDIO_OUTPUT_DRIVER INFO %s\r\n", pszAudioDriver);
+	return _lscp_driver_info_cached(pClient, szQuery, 0);
+}
+
+
+/**
+ *  Getting a snapshot of informations about a specific audio output driver.
+ *  GET AUDIO_OUTPUT_DRIVER INFO <audio-output-type>
+ *
+ *  @param pClient          Pointer to client instance structure.
+ *  @param pszAudioDriver   Audio driver type string (e.g. "ALSA").
+ *
+ *  @returns A pointer to an immutable and reference-counted @ref lscp_driver_info_t
+ *  snapshot, owned by the caller and valid across any subsequent calls,
+ *  which must be released with @ref lscp_snapshot_unref when done,
+ *  or NULL in case of failure.
+ */
+const lscp_driver_info_t *lscp_get_audio_driver_info_snapshot ( lscp_client_t *pClient, const char *pszAudioDriver )
+{
+	char szQuery[LSCP_BUFSIZ];
+
+	if (pClient == NULL)
+		return NULL;
 	if (pszAudioDriver == NULL)
 		return NULL;
 
 	sprintf(szQuery, "GET AUDIO_OUTPUT_DRIVER INFO %s\r\n", pszAudioDriver);
-	return _lscp_driver_info_query(pClient, &(pClient->audio_driver_info), szQuery);
+	return _lscp_driver_info_cached(pClient, szQuery, 1);
 }
 
 
@@ -375,7 +476,37 @@ lscp_param_info_t *lscp_get_audio_driver_param_info ( lscp_client_t *pClient, co
 		return NULL;
 
 	sprintf(szQuery, "GET AUDIO_OUTPUT_DRIVER_PARAMETER INFO %s %s", pszAudioDriver, pszParam);
-	return _lscp_param_info_query(pClient, &(pClient->audio_param_info), szQuery, sizeof(szQuery), pDepList);
+	return _lscp_param_info_cached(pClient, szQuery, sizeof(szQuery), pDepList, 0);
+}
+
+
+/**
+ *  Getting a snapshot of informations about specific audio output driver parameter.
+ *  GET AUDIO_OUTPUT_DRIVER_PARAMETER INFO <audio-output-driver> <param> [<dep-list>]
+ *
+ *  @param pClient          Pointer to client instance structure.
+ *  @param pszAudioDriver   Audio driver type string (e.g. "ALSA").
+ *  @param pszParam         Audio driver parameter name.
+ *  @param pDepList         Pointer to specific dependencies parameter list.
+ *
+ *  @returns A pointer to an immutable and reference-counted @ref lscp_param_info_t
+ *  snapshot, owned by the caller and valid across any subsequent calls,
+ *  which must be released with @ref lscp_snapshot_unref when done,
+ *  or NULL in case of failure.
+ */
+const lscp_param_info_t *lscp_get_audio_driver_param_info_snapshot ( lscp_client_t *pClient, const char *pszAudioDriver, const char *pszParam, lscp_param_t *pDepList )
+{
+	char szQuery[LSCP_BUFSIZ];
+
+	if (pClient == NULL)
+		return NULL;
+	if (pszAudioDriver == NULL)
+		return NULL;
+	if (pszParam == NULL)
+		return NULL;
+
+	sprintf(szQuery, "GET AUDIO_OUTPUT_DRIVER_PARAMETER INFO %s %s", pszAudioDriver, pszParam);
+	return _lscp_param_info_cached(pClient, szQuery, sizeof(szQuery), pDepList, 1);
 }
 
 
@@ -409,11 +540,14 @@ int lscp_create_audio_device ( lscp_client_t *pClient, const char *pszAudioDrive
 	sprintf(szQuery, "CREATE AUDIO_OUTPUT_DEVICE %s", pszAudioDriver);
 	lscp_param_concat(szQuery, sizeof(szQuery), pParams);
 	if (lscp_client_call(pClient, szQuery, 0) == LSCP_OK)
-		iAudioDevice = atoi(lscp_client_get_result(pClient));
+		iAudioDevice = lscp_atoi(lscp_client_get_result(pClient));
 
 	// Unlock this section down.
 	lscp_mutex_unlock(pClient->mutex);
 
+	if (iAudioDevice >= 0)
+		_lscp_device_mirror_touch(pClient, LSCP_MIRROR_AUDIO, -1);
+
 	return iAudioDevice;
 }
 
@@ -438,7 +572,10 @@ lscp_status_t lscp_destroy_audio_device ( lscp_client_t *pClient, int iAudioDevi
 		return ret;
 
 	sprintf(szQuery, "DESTROY AUDIO_OUTPUT_DEVICE %d\r\n", iAudioDevice);
-	return lscp_client_query(pClient, szQuery);
+	ret = lscp_client_query(pClient, szQuery);
+	_lscp_device_mirror_touch(pClient, LSCP_MIRROR_AUDIO, -1);
+
+	return ret;
 }
 
 
@@ -462,7 +599,7 @@ int lscp_get_audio_devices ( lscp_client_t *pClient )
 	lscp_mutex_lock(pClient->mutex);
 
 	if (lscp_client_call(pClient, "GET AUDIO_OUTPUT_DEVICES\r\n", 0) == LSCP_OK)
-		iAudioDevices = atoi(lscp_client_get_result(pClient));
+		iAudioDevices = lscp_atoi(lscp_client_get_result(pClient));
 
 	// Unlock this section down.
 	lscp_mutex_unlock(pClient->mutex);
@@ -529,6 +666,39 @@ lscp_device_info_t *lscp_get_audio_device_info ( lscp_client_t *pClient, int iAu
 }
 
 
+/**
+ *  Getting a snapshot of current settings of an audio output device.
+ *  GET AUDIO_OUTPUT_DEVICE INFO <audio-device-id>
+ *
+ *  @param pClient      Pointer to client instance structure.
+ *  @param iAudioDevice Audio device number identifier.
+ *
+ *  @returns A pointer to an immutable and reference-counted @ref lscp_device_info_t
+ *  snapshot, owned by the caller and valid across any subsequent calls,
+ *  which must be released with @ref lscp_snapshot_unref when done,
+ *  or NULL in case of failure.
+ */
+const lscp_device_info_t *lscp_get_audio_device_info_snapshot ( lscp_client_t *pClient, int iAudioDevice )
+{
+	lscp_device_info_t *pDeviceInfo;
+	char szQuery[LSCP_BUFSIZ];
+
+	if (pClient == NULL)
+		return NULL;
+	if (iAudioDevice < 0)
+		return NULL;
+
+	sprintf(szQuery, "GET AUDIO_OUTPUT_DEVICE INFO %d\r\n", iAudioDevice);
+	pDeviceInfo = (lscp_device_info_t *) lscp_snapshot_alloc(LSCP_SNAPSHOT_DEVICE_INFO);
+	if (pDeviceInfo && _lscp_device_info_query(pClient, pDeviceInfo, szQuery) == NULL) {
+		lscp_snapshot_unref(pDeviceInfo);
+		pDeviceInfo = NULL;
+	}
+
+	return pDeviceInfo;
+}
+
+
 /**
  *  Changing settings of audio output devices.
  *  SET AUDIO_OUTPUT_DEVICE_PARAMETER <audio-device-id> <param>=<value>
@@ -541,6 +711,7 @@ lscp_device_info_t *lscp_get_audio_device_info ( lscp_client_t *pClient, int iAu
  */
 lscp_status_t lscp_set_audio_device_param ( lscp_client_t *pClient, int iAudioDevice, lscp_param_t *pParam )
 {
+	lscp_status_t ret;
 	char szQuery[LSCP_BUFSIZ];
 
 	if (pClient == NULL)
@@ -551,7 +722,10 @@ lscp_status_t lscp_set_audio_device_param ( lscp_client_t *pClient, int iAudioDe
 		return LSCP_FAILED;
 
 	sprintf(szQuery, "SET AUDIO_OUTPUT_DEVICE_PARAMETER %d %s='%s'\r\n", iAudioDevice, pParam->key, pParam->value);
-	return lscp_client_query(pClient, szQuery);
+	ret = lscp_client_query(pClient, szQuery);
+	_lscp_device_mirror_touch(pClient, LSCP_MIRROR_AUDIO, iAudioDevice);
+
+	return ret;
 }
 
 
@@ -582,6 +756,42 @@ lscp_device_port_info_t* lscp_get_audio_channel_info ( lscp_client_t *pClient, i
 }
 
 
+/**
+ *  Getting a snapshot of informations about an audio channel.
+ *  GET AUDIO_OUTPUT_CHANNEL INFO <audio-device-id> <audio-channel>
+ *
+ *  @param pClient          Pointer to client instance structure.
+ *  @param iAudioDevice     Audio device number identifier.
+ *  @param iAudioChannel    Audio channel number.
+ *
+ *  @returns A pointer to an immutable and reference-counted @ref lscp_device_port_info_t
+ *  snapshot, owned by the caller and valid across any subsequent calls,
+ *  which must be released with @ref lscp_snapshot_unref when done,
+ *  or NULL in case of failure.
+ */
+const lscp_device_port_info_t *lscp_get_audio_channel_info_snapshot ( lscp_client_t *pClient, int iAudioDevice, int iAudioChannel )
+{
+	lscp_device_port_info_t *pDevicePortInfo;
+	char szQuery[LSCP_BUFSIZ];
+
+	if (pClient == NULL)
+		return NULL;
+	if (iAudioDevice < 0)
+		return NULL;
+	if (iAudioChannel < 0)
+		return NULL;
+
+	sprintf(szQuery, "GET AUDIO_OUTPUT_CHANNEL INFO %d %d\r\n", iAudioDevice, iAudioChannel);
+	pDevicePortInfo = (lscp_device_port_info_t *) lscp_snapshot_alloc(LSCP_SNAPSHOT_DEVICE_PORT_INFO);
+	if (pDevicePortInfo && _lscp_device_port_info_query(pClient, pDevicePortInfo, szQuery) == NULL) {
+		lscp_snapshot_unref(pDevicePortInfo);
+		pDevicePortInfo = NULL;
+	}
+
+	return pDevicePortInfo;
+}
+
+
 /**
  *  Getting informations about specific audio channel parameter.
  *  GET AUDIO_OUTPUT_CHANNEL_PARAMETER INFO <audio-device-id> <audio-channel> <param>
@@ -612,6 +822,45 @@ lscp_param_info_t* lscp_get_audio_channel_param_info ( lscp_client_t *pClient, i
 }
 
 
+/**
+ *  Getting a snapshot of informations about specific audio channel parameter.
+ *  GET AUDIO_OUTPUT_CHANNEL_PARAMETER INFO <audio-device-id> <audio-channel> <param>
+ *
+ *  @param pClient          Pointer to client instance structure.
+ *  @param iAudioDevice     Audio device number identifier.
+ *  @param iAudioChannel    Audio channel number.
+ *  @param pszParam         Audio channel parameter name.
+ *
+ *  @returns A pointer to an immutable and reference-counted @ref lscp_param_info_t
+ *  snapshot, owned by the caller and valid across any subsequent calls,
+ *  which must be released with @ref lscp_snapshot_unref when done,
+ *  or NULL in case of failure.
+ */
+const lscp_param_info_t *lscp_get_audio_channel_param_info_snapshot ( lscp_client_t *pClient, int iAudioDevice, int iAudioChannel, const char *pszParam )
+{
+	lscp_param_info_t *pParamInfo;
+	char szQuery[LSCP_BUFSIZ];
+
+	if (pClient == NULL)
+		return NULL;
+	if (iAudioDevice < 0)
+		return NULL;
+	if (iAudioChannel < 0)
+		return NULL;
+	if (pszParam == NULL)
+		return NULL;
+
+	sprintf(szQuery, "GET AUDIO_OUTPUT_CHANNEL_PARAMETER INFO %d %d %s", iAudioDevice, iAudioChannel, pszParam);
+	pParamInfo = (lscp_param_info_t *) lscp_snapshot_alloc(LSCP_SNAPSHOT_PARAM_INFO);
+	if (pParamInfo && _lscp_param_info_query(pClient, pParamInfo, szQuery, sizeof(szQuery), NULL) == NULL) {
+		lscp_snapshot_unref(pParamInfo);
+		pParamInfo = NULL;
+	}
+
+	return pParamInfo;
+}
+
+
 /**
  *  Changing settings of audio output channels.
  *  SET AUDIO_OUTPUT_CHANNEL_PARAMETER <audio-device-id> <audio-channel> <param> <value>
@@ -625,6 +874,7 @@ lscp_param_info_t* lscp_get_audio_channel_param_info ( lscp_client_t *pClient, i
  */
 lscp_status_t lscp_set_audio_channel_param ( lscp_client_t *pClient, int iAudioDevice, int iAudioChannel, lscp_param_t *pParam )
 {
+	lscp_status_t ret;
 	char szQuery[LSCP_BUFSIZ];
 
 	if (pClient == NULL)
@@ -637,7 +887,10 @@ lscp_status_t lscp_set_audio_channel_param ( lscp_client_t *pClient, int iAudioD
 		return LSCP_FAILED;
 
 	sprintf(szQuery, "SET AUDIO_OUTPUT_CHANNEL_PARAMETER %d %d %s='%s'\r\n", iAudioDevice, iAudioChannel, pParam->key, pParam->value);
-	return lscp_client_query(pClient, szQuery);
+	ret = lscp_client_query(pClient, szQuery);
+	_lscp_device_mirror_touch(pClient, LSCP_MIRROR_AUDIO, iAudioDevice);
+
+	return ret;
 }
 
 
@@ -664,7 +917,7 @@ int lscp_get_available_midi_drivers ( lscp_client_t *pClient )
 	lscp_mutex_lock(pClient->mutex);
 
 	if (lscp_client_call(pClient, "GET AVAILABLE_MIDI_INPUT_DRIVERS\r\n", 0) == LSCP_OK)
-		iMidiDrivers = atoi(lscp_client_get_result(pClient));
+		iMidiDrivers = lscp_atoi(lscp_client_get_result(pClient));
 
 	// Unlock this section up.
 	lscp_mutex_unlock(pClient->mutex);
@@ -692,12 +945,9 @@ const char** lscp_list_available_midi_drivers ( lscp_client_t *pClient )
 	// Lock this section up.
 	lscp_mutex_lock(pClient->mutex);
 
-	if (pClient->midi_drivers) {
-		lscp_szsplit_destroy(pClient->midi_drivers);
-		pClient->midi_drivers = NULL;
-	}
-
-	if (lscp_client_call(pClient, "LIST AVAILABLE_MIDI_INPUT_DRIVERS\r\n", 0) == LSCP_OK)
+	// Memoized, until flushed...
+	if (pClient->midi_drivers == NULL
+		&& lscp_client_call(pClient, "LIST AVAILABLE_MIDI_INPUT_DRIVERS\r\n", 0) == LSCP_OK)
 		pClient->midi_drivers = lscp_szsplit_create(lscp_client_get_result(pClient), pszSeps);
 
 	// Unlock this section up.
@@ -721,11 +971,39 @@ lscp_driver_info_t* lscp_get_midi_driver_info ( lscp_client_t *pClient, const ch
 {
 	char szQuery[LSCP_BUFSIZ];
 
+	if (pClient == NULL)
+		return NULL;
 	if (pszMidiDriver == NULL)
 		return NULL;
 
 	sprintf(szQuery, "GET MIDI_INPUT_DRIVER INFO %s\r\n", pszMidiDriver);
-	return _lscp_driver_info_query(pClient, &(pClient->midi_driver_info), szQuery);
+	return _lscp_driver_info_cached(pClient, szQuery, 0);
+}
+
+
+/**
+ *  Getting a snapshot of informations about a specific MIDI input driver.
+ *  GET MIDI_INPUT_DRIVER INFO <midi-input-type>
+ *
+ *  @param pClient          Pointer to client instance structure.
+ *  @param pszMidiDriver    MIDI driver type string (e.g. "ALSA").
+ *
+ *  @returns A pointer to an immutable and reference-counted @ref lscp_driver_info_t
+ *  snapshot, owned by the caller and valid across any subsequent calls,
+ *  which must be released with @ref lscp_snapshot_unref when done,
+ *  or NULL in case of failure.
+ */
+const lscp_driver_info_t *lscp_get_midi_driver_info_snapshot ( lscp_client_t *pClient, const char *pszMidiDriver )
+{
+	char szQuery[LSCP_BUFSIZ];
+
+	if (pClient == NULL)
+		return NULL;
+	if (pszMidiDriver == NULL)
+		return NULL;
+
+	sprintf(szQuery, "GET MIDI_INPUT_DRIVER INFO %s\r\n", pszMidiDriver);
+	return _lscp_driver_info_cached(pClient, szQuery, 1);
 }
 
 
@@ -755,7 +1033,37 @@ lscp_param_info_t *lscp_get_midi_driver_param_info ( lscp_client_t *pClient, con
 		return NULL;
 
 	sprintf(szQuery, "GET MIDI_INPUT_DRIVER_PARAMETER INFO %s %s", pszMidiDriver, pszParam);
-	return _lscp_param_info_query(pClient, &(pClient->midi_param_info), szQuery, sizeof(szQuery), pDepList);
+	return _lscp_param_info_cached(pClient, szQuery, sizeof(szQuery), pDepList, 0);
+}
+
+
+/**
+ *  Getting a snapshot of informations about specific MIDI input driver parameter.
+ *  GET MIDI_INPUT_DRIVER_PARAMETER INFO <midi-input-driver> <param> [<dep-list>]
+ *
+ *  @param pClient          Pointer to client instance structure.
+ *  @param pszMidiDriver    MIDI driver type string (e.g. "ALSA").
+ *  @param pszParam         MIDI driver parameter name.
+ *  @param pDepList         Pointer to specific dependencies parameter list.
+ *
+ *  @returns A pointer to an immutable and reference-counted @ref lscp_param_info_t
+ *  snapshot, owned by the caller and valid across any subsequent calls,
+ *  which must be released with @ref lscp_snapshot_unref when done,
+ *  or NULL in case of failure.
+ */
+const lscp_param_info_t *lscp_get_midi_driver_param_info_snapshot ( lscp_client_t *pClient, const char *pszMidiDriver, const char *pszParam, lscp_param_t *pDepList )
+{
+	char szQuery[LSCP_BUFSIZ];
+
+	if (pClient == NULL)
+		return NULL;
+	if (pszMidiDriver == NULL)
+		return NULL;
+	if (pszParam == NULL)
+		return NULL;
+
+	sprintf(szQuery, "GET MIDI_INPUT_DRIVER_PARAMETER INFO %s %s", pszMidiDriver, pszParam);
+	return _lscp_param_info_cached(pClient, szQuery, sizeof(szQuery), pDepList, 1);
 }
 
 
@@ -789,11 +1097,14 @@ int lscp_create_midi_device ( lscp_client_t *pClient, const char *pszMidiDriver,
 	sprintf(szQuery, "CREATE MIDI_INPUT_DEVICE %s", pszMidiDriver);
 	lscp_param_concat(szQuery, sizeof(szQuery), pParams);
 	if (lscp_client_call(pClient, szQuery, 0) == LSCP_OK)
-		iMidiDevice = atoi(lscp_client_get_result(pClient));
+		iMidiDevice = lscp_atoi(lscp_client_get_result(pClient));
 
 	// Unlock this section down.
 	lscp_mutex_unlock(pClient->mutex);
 
+	if (iMidiDevice >= 0)
+		_lscp_device_mirror_touch(pClient, LSCP_MIRROR_MIDI, -1);
+
 	return iMidiDevice;
 }
 
@@ -818,7 +1129,10 @@ lscp_status_t lscp_destroy_midi_device ( lscp_client_t *pClient, int iMidiDevice
 		return ret;
 
 	sprintf(szQuery, "DESTROY MIDI_INPUT_DEVICE %d\r\n", iMidiDevice);
-	return lscp_client_query(pClient, szQuery);
+	ret = lscp_client_query(pClient, szQuery);
+	_lscp_device_mirror_touch(pClient, LSCP_MIRROR_MIDI, -1);
+
+	return ret;
 }
 
 
@@ -842,7 +1156,7 @@ int lscp_get_midi_devices ( lscp_client_t *pClient )
 	lscp_mutex_lock(pClient->mutex);
 
 	if (lscp_client_call(pClient, "GET MIDI_INPUT_DEVICES\r\n", 0) == LSCP_OK)
-		iMidiDevices = atoi(lscp_client_get_result(pClient));
+		iMidiDevices = lscp_atoi(lscp_client_get_result(pClient));
 		
 	// Unlock this section down.
 	lscp_mutex_unlock(pClient->mutex);
@@ -909,6 +1223,39 @@ lscp_device_info_t* lscp_get_midi_device_info ( lscp_client_t *pClient, int iMid
 }
 
 
+/**
+ *  Getting a snapshot of current settings of a MIDI input device.
+ *  GET MIDI_INPUT_DEVICE INFO <midi-device-id>
+ *
+ *  @param pClient      Pointer to client instance structure.
+ *  @param iMidiDevice  MIDI device number identifier.
+ *
+ *  @returns A pointer to an immutable and reference-counted @ref lscp_device_info_t
+ *  snapshot, owned by the caller and valid across any subsequent calls,
+ *  which must be released with @ref lscp_snapshot_unref when done,
+ *  or NULL in case of failure.
+ */
+const lscp_device_info_t *lscp_get_midi_device_info_snapshot ( lscp_client_t *pClient, int iMidiDevice )
+{
+	lscp_device_info_t *pDeviceInfo;
+	char szQuery[LSCP_BUFSIZ];
+
+	if (pClient == NULL)
+		return NULL;
+	if (iMidiDevice < 0)
+		return NULL;
+
+	sprintf(szQuery, "GET MIDI_INPUT_DEVICE INFO %d\r\n", iMidiDevice);
+	pDeviceInfo = (lscp_device_info_t *) lscp_snapshot_alloc(LSCP_SNAPSHOT_DEVICE_INFO);
+	if (pDeviceInfo && _lscp_device_info_query(pClient, pDeviceInfo, szQuery) == NULL) {
+		lscp_snapshot_unref(pDeviceInfo);
+		pDeviceInfo = NULL;
+	}
+
+	return pDeviceInfo;
+}
+
+
 /**
  *  Changing settings of MIDI input devices.
  *  SET MIDI_INPUT_DEVICE_PARAMETER <midi-device-id> <param>=<value>
@@ -921,6 +1268,7 @@ lscp_device_info_t* lscp_get_midi_device_info ( lscp_client_t *pClient, int iMid
  */
 lscp_status_t lscp_set_midi_device_param ( lscp_client_t *pClient, int iMidiDevice, lscp_param_t *pParam )
 {
+	lscp_status_t ret;
 	char szQuery[LSCP_BUFSIZ];
 
 	if (pClient == NULL)
@@ -931,7 +1279,10 @@ lscp_status_t lscp_set_midi_device_param ( lscp_client_t *pClient, int iMidiDevi
 		return LSCP_FAILED;
 
 	sprintf(szQuery, "SET MIDI_INPUT_DEVICE_PARAMETER %d %s='%s'\r\n", iMidiDevice, pParam->key, pParam->value);
-	return lscp_client_query(pClient, szQuery);
+	ret = lscp_client_query(pClient, szQuery);
+	_lscp_device_mirror_touch(pClient, LSCP_MIRROR_MIDI, iMidiDevice);
+
+	return ret;
 }
 
 
@@ -962,6 +1313,42 @@ lscp_device_port_info_t* lscp_get_midi_port_info ( lscp_client_t *pClient, int i
 }
 
 
+/**
+ *  Getting a snapshot of informations about a MIDI port.
+ *  GET MIDI_INPUT_PORT INFO <midi-device-id> <midi-port>
+ *
+ *  @param pClient      Pointer to client instance structure.
+ *  @param iMidiDevice  MIDI device number identifier.
+ *  @param iMidiPort    MIDI port number.
+ *
+ *  @returns A pointer to an immutable and reference-counted @ref lscp_device_port_info_t
+ *  snapshot, owned by the caller and valid across any subsequent calls,
+ *  which must be released with @ref lscp_snapshot_unref when done,
+ *  or NULL in case of failure.
+ */
+const lscp_device_port_info_t *lscp_get_midi_port_info_snapshot ( lscp_client_t *pClient, int iMidiDevice, int iMidiPort )
+{
+	lscp_device_port_info_t *pDevicePortInfo;
+	char szQuery[LSCP_BUFSIZ];
+
+	if (pClient == NULL)
+		return NULL;
+	if (iMidiDevice < 0)
+		return NULL;
+	if (iMidiPort < 0)
+		return NULL;
+
+	sprintf(szQuery, "GET MIDI_INPUT_PORT INFO %d %d\r\n", iMidiDevice, iMidiPort);
+	pDevicePortInfo = (lscp_device_port_info_t *) lscp_snapshot_alloc(LSCP_SNAPSHOT_DEVICE_PORT_INFO);
+	if (pDevicePortInfo && _lscp_device_port_info_query(pClient, pDevicePortInfo, szQuery) == NULL) {
+		lscp_snapshot_unref(pDevicePortInfo);
+		pDevicePortInfo = NULL;
+	}
+
+	return pDevicePortInfo;
+}
+
+
 /**
  *  Getting informations about specific MIDI port parameter.
  *  GET MIDI_INPUT_PORT_PARAMETER INFO <midi-device-id> <midi-port> <param>
@@ -992,6 +1379,45 @@ lscp_param_info_t* lscp_get_midi_port_param_info ( lscp_client_t *pClient, int i
 }
 
 
+/**
+ *  Getting a snapshot of informations about specific MIDI port parameter.
+ *  GET MIDI_INPUT_PORT_PARAMETER INFO <midi-device-id> <midi-port> <param>
+ *
+ *  @param pClient      Pointer to client instance structure.
+ *  @param iMidiDevice  MIDI device number identifier.
+ *  @param iMidiPort    MIDI port number.
+ *  @param pszParam     MIDI port parameter name.
+ *
+ *  @returns A pointer to an immutable and reference-counted @ref lscp_param_info_t
+ *  snapshot, owned by the caller and valid across any subsequent calls,
+ *  which must be released with @ref lscp_snapshot_unref when done,
+ *  or NULL in case of failure.
+ */
+const lscp_param_info_t *lscp_get_midi_port_param_info_snapshot ( lscp_client_t *pClient, int iMidiDevice, int iMidiPort, const char *pszParam )
+{
+	lscp_param_info_t *pParamInfo;
+	char szQuery[LSCP_BUFSIZ];
+
+	if (pClient == NULL)
+		return NULL;
+	if (iMidiDevice < 0)
+		return NULL;
+	if (iMidiPort < 0)
+		return NULL;
+	if (pszParam == NULL)
+		return NULL;
+
+	sprintf(szQuery, "GET MIDI_INPUT_PORT_PARAMETER INFO %d %d %s", iMidiDevice, iMidiPort, pszParam);
+	pParamInfo = (lscp_param_info_t *) lscp_snapshot_alloc(LSCP_SNAPSHOT_PARAM_INFO);
+	if (pParamInfo && _lscp_param_info_query(pClient, pParamInfo, szQuery, sizeof(szQuery), NULL) == NULL) {
+		lscp_snapshot_unref(pParamInfo);
+		pParamInfo = NULL;
+	}
+
+	return pParamInfo;
+}
+
+
 /**
  *  Changing settings of MIDI input ports.
  *  SET MIDI_INPUT_PORT_PARAMETER <midi-device-id> <midi-port> <param> <value>
@@ -1005,6 +1431,7 @@ lscp_param_info_t* lscp_get_midi_port_param_info ( lscp_client_t *pClient, int i
  */
 lscp_status_t lscp_set_midi_port_param ( lscp_client_t *pClient, int iMidiDevice, int iMidiPort, lscp_param_t *pParam )
 {
+	lscp_status_t ret;
 	char szQuery[LSCP_BUFSIZ];
 
 	if (pClient == NULL)
@@ -1017,17 +1444,352 @@ lscp_status_t lscp_set_midi_port_param ( lscp_client_t *pClient, int iMidiDevice
 		return LSCP_FAILED;
 
 	sprintf(szQuery, "SET MIDI_INPUT_PORT_PARAMETER %d %d %s='%s'\r\n", iMidiDevice, iMidiPort, pParam->key, pParam->value);
-	return lscp_client_query(pClient, szQuery);
+	ret = lscp_client_query(pClient, szQuery);
+	_lscp_device_mirror_touch(pClient, LSCP_MIRROR_MIDI, iMidiDevice);
+
+	return ret;
+}
+
+
+//-------------------------------------------------------------------------
+// Device topology mirror functions.
+
+// Device list response target.
+typedef struct _lscp_mirror_list_t
+{
+	int           listed;
+	int *         devices;
+
+} lscp_mirror_list_t;
+
+
+// Pipelined response handlers.
+static void _lscp_mirror_list_result ( lscp_client_t *pClient, int iQuery,
+	lscp_status_t ret, char *pszResult, void *pvData )
+{
+	lscp_mirror_batch_t *pBatch = (lscp_mirror_batch_t *) pvData;
+	lscp_mirror_list_t *pList = (lscp_mirror_list_t *) pBatch->targets[iQuery];
+
+	(void) pClient;
+
+	if (ret == LSCP_OK) {
+		pList->listed = 1;
+		pList->devices = lscp_isplit_create(pszResult ? pszResult : "", ",");
+	}
+}
+
+static void _lscp_mirror_device_result ( lscp_client_t *pClient, int iQuery,
+	lscp_status_t ret, char *pszResult, void *pvData )
+{
+	lscp_mirror_batch_t *pBatch = (lscp_mirror_batch_t *) pvData;
+	lscp_device_info_t *pDeviceInfo = (lscp_device_info_t *) pBatch->targets[iQuery];
+
+	lscp_device_info_reset(pDeviceInfo);
+	if (ret == LSCP_OK && pszResult)
+		_lscp_device_info_parse(pClient->intern, pDeviceInfo, pszResult);
+}
+
+static void _lscp_mirror_port_result ( lscp_client_t *pClient, int iQuery,
+	lscp_status_t ret, char *pszResult, void *pvData )
+{
+	lscp_mirror_batch_t *pBatch = (lscp_mirror_batch_t *) pvData;
+	lscp_device_port_info_t *pDevicePortInfo = (lscp_device_port_info_t *) pBatch->targets[iQuery];
+
+	(void) pClient;
+
+	lscp_device_port_info_reset(pDevicePortInfo);
+	if (ret == LSCP_OK && pszResult)
+		_lscp_device_port_info_parse(pDevicePortInfo, pszResult);
+}
+
+
+// Rebuild a mirrored device array after a fresh device list,
+// keeping what's still there; new devices are marked stale.
+static int _lscp_mirror_merge ( lscp_topology_device_t **ppDevices, int *piCount,
+	int iType, const int *piDevices, lscp_hash_t *pStale )
+{
+	lscp_topology_device_t *pOld = *ppDevices;
+	lscp_topology_device_t *pNew;
+	int iOld = *piCount;
+	int iNew, i, j;
+
+	for (iNew = 0; piDevices && piDevices[iNew] >= 0; iNew++)
+		;
+
+	pNew = (lscp_topology_device_t *) malloc(
+		(iNew > 0 ? iNew : 1) * sizeof(lscp_topology_device_t));
+	if (pNew == NULL)
+		return -1;
+
+	for (i = 0; i < iNew; i++) {
+		for (j = 0; j < iOld; j++) {
+			if (pOld[j].device == piDevices[i])
+				break;
+		}
+		if (j < iOld) {
+			// Move it over...
+			pNew[i] = pOld[j];
+			lscp_topology_device_init(&pOld[j]);
+		} else {
+			// Brand new one...
+			lscp_topology_device_init(&pNew[i]);
+			pNew[i].device = piDevices[i];
+			lscp_hash_insert(pStale, LSCP_MIRROR_KEY(iType, piDevices[i]), pNew);
+		}
+	}
+
+	// Get rid of the ones gone...
+	for (j = 0; j < iOld; j++)
+		lscp_topology_device_free(&pOld[j]);
+	if (pOld)
+		free(pOld);
+
+	*ppDevices = pNew;
+	*piCount = iNew;
+
+	return 0;
+}
+
+
+// Queue info requests of all stale devices of a given type.
+static void _lscp_mirror_devices_batch ( lscp_mirror_batch_t *pBatch,
+	lscp_topology_device_t *pDevices, int iCount, int iType, lscp_hash_t *pStale )
+{
+	int i;
+
+	for (i = 0; i < iCount; i++) {
+		if (lscp_hash_find(pStale, LSCP_MIRROR_KEY(iType, pDevices[i].device)) == NULL)
+			continue;
+		sprintf(lscp_mirror_batch_add(pBatch, &(pDevices[i].info)),
+			(iType == LSCP_MIRROR_AUDIO
+				? "GET AUDIO_OUTPUT_DEVICE INFO %d\r\n"
+				: "GET MIDI_INPUT_DEVICE INFO %d\r\n"),
+			pDevices[i].device);
+	}
+}
+
+
+// Resize the channels/ports of all stale devices of a given type,
+// as told by their fresh info, and queue their info requests.
+static int _lscp_mirror_ports_batch ( lscp_mirror_batch_t *pBatch,
+	lscp_topology_device_t *pDevices, int iCount, int iType, lscp_hash_t *pStale )
+{
+	lscp_topology_device_t *pDevice;
+	const char *pszCount;
+	int i, iPort, iPorts = 0;
+
+	for (i = 0; i < iCount; i++) {
+		pDevice = &pDevices[i];
+		if (lscp_hash_find(pStale, LSCP_MIRROR_KEY(iType, pDevice->device)) == NULL)
+			continue;
+		for (iPort = 0; iPort < pDevice->port_count; iPort++)
+			lscp_device_port_info_free(&(pDevice->ports[iPort]));
+		if (pDevice->ports)
+			free(pDevice->ports);
+		pDevice->ports = NULL;
+		pDevice->port_count = 0;
+		pszCount = lscp_plist_find(pDevice->info.params,
+			(iType == LSCP_MIRROR_AUDIO ? "CHANNELS" : "PORTS"));
+		if (pszCount == NULL || lscp_atoi(pszCount) < 1)
+			continue;
+		pDevice->ports = (lscp_device_port_info_t *) malloc(
+			lscp_atoi(pszCount) * sizeof(lscp_device_port_info_t));
+		if (pDevice->ports == NULL)
+			return -1;
+		pDevice->port_count = lscp_atoi(pszCount);
+		for (iPort = 0; iPort < pDevice->port_count; iPort++)
+			lscp_device_port_info_init(&(pDevice->ports[iPort]));
+		iPorts += pDevice->port_count;
+	}
+
+	if (pBatch == NULL)
+		return iPorts;
+
+	for (i = 0; i < iCount; i++) {
+		pDevice = &pDevices[i];
+		if (lscp_hash_find(pStale, LSCP_MIRROR_KEY(iType, pDevice->device)) == NULL)
+			continue;
+		for (iPort = 0; iPort < pDevice->port_count; iPort++) {
+			sprintf(lscp_mirror_batch_add(pBatch, &(pDevice->ports[iPort])),
+				(iType == LSCP_MIRROR_AUDIO
+					? "GET AUDIO_OUTPUT_CHANNEL INFO %d %d\r\n"
+					: "GET MIDI_INPUT_PORT INFO %d %d\r\n"),
+				pDevice->device, iPort);
+		}
+	}
+
+	return iPorts;
+}
+
+
+// Refetch whatever got stale in the device topology mirror,
+// in at most three pipelined round-trips (caller must own the
+// client mutex); on failure, stale state is kept for a retry.
+static lscp_status_t _lscp_device_mirror_refresh ( lscp_client_t *pClient )
+{
+	lscp_device_mirror_t *pMirror = &(pClient->device_mirror);
+	lscp_device_topology_t *pTopology = &(pMirror->topology);
+	lscp_mirror_list_t lists[2];
+	lscp_mirror_batch_t batch;
+	lscp_hash_t stale;
+	int iAudioStale, iMidiStale;
+	int iPorts, i;
+
+	lscp_status_t ret = LSCP_OK;
+
+	// Last-known state is served as is, until reconciled...
+	if (pMirror->warm)
+		return LSCP_OK;
+
+	// Take over current stale state...
+	lscp_mutex_lock(pMirror->mutex);
+	iAudioStale = pMirror->audio_stale;
+	iMidiStale  = pMirror->midi_stale;
+	pMirror->audio_stale = 0;
+	pMirror->midi_stale  = 0;
+	stale = pMirror->stale;
+	lscp_hash_init(&(pMirror->stale));
+	lscp_mutex_unlock(pMirror->mutex);
+
+	if (!iAudioStale && !iMidiStale && stale.count < 1)
+		return LSCP_OK;
+
+	// 1. Device lists...
+	lists[LSCP_MIRROR_AUDIO].listed  = 0;
+	lists[LSCP_MIRROR_AUDIO].devices = NULL;
+	lists[LSCP_MIRROR_MIDI].listed   = 0;
+	lists[LSCP_MIRROR_MIDI].devices  = NULL;
+	if (iAudioStale || iMidiStale) {
+		if (lscp_mirror_batch_init(&batch, 2) < 0)
+			ret = LSCP_FAILED;
+		if (ret == LSCP_OK && iAudioStale)
+			strcpy(lscp_mirror_batch_add(&batch, &lists[LSCP_MIRROR_AUDIO]),
+				"LIST AUDIO_OUTPUT_DEVICES\r\n");
+		if (ret == LSCP_OK && iMidiStale)
+			strcpy(lscp_mirror_batch_add(&batch, &lists[LSCP_MIRROR_MIDI]),
+				"LIST MIDI_INPUT_DEVICES\r\n");
+		if (ret == LSCP_OK)
+			ret = lscp_client_call_batch(pClient, batch.ppszQueries, batch.count, 0,
+				_lscp_mirror_list_result, &batch);
+		lscp_mirror_batch_free(&batch);
+		if (ret == LSCP_OK && iAudioStale) {
+			if (!lists[LSCP_MIRROR_AUDIO].listed
+				|| _lscp_mirror_merge(&(pTopology->audio_devices), &(pTopology->audio_count),
+					LSCP_MIRROR_AUDIO, lists[LSCP_MIRROR_AUDIO].devices, &stale) < 0)
+				ret = LSCP_FAILED;
+		}
+		if (ret == LSCP_OK && iMidiStale) {
+			if (!lists[LSCP_MIRROR_MIDI].listed
+				|| _lscp_mirror_merge(&(pTopology->midi_devices), &(pTopology->midi_count),
+					LSCP_MIRROR_MIDI, lists[LSCP_MIRROR_MIDI].devices, &stale) < 0)
+				ret = LSCP_FAILED;
+		}
+		lscp_isplit_destroy(lists[LSCP_MIRROR_AUDIO].devices);
+		lscp_isplit_destroy(lists[LSCP_MIRROR_MIDI].devices);
+	}
+
+	// 2. Stale (and new) devices info...
+	if (ret == LSCP_OK && stale.count > 0) {
+		if (lscp_mirror_batch_init(&batch, stale.count) < 0)
+			ret = LSCP_FAILED;
+		if (ret == LSCP_OK) {
+			_lscp_mirror_devices_batch(&batch, pTopology->audio_devices,
+				pTopology->audio_count, LSCP_MIRROR_AUDIO, &stale);
+			_lscp_mirror_devices_batch(&batch, pTopology->midi_devices,
+				pTopology->midi_count, LSCP_MIRROR_MIDI, &stale);
+			ret = lscp_client_call_batch(pClient, batch.ppszQueries, batch.count, 1,
+				_lscp_mirror_device_result, &batch);
+		}
+		lscp_mirror_batch_free(&batch);
+	}
+
+	// 3. Stale (and new) devices channels and ports info...
+	if (ret == LSCP_OK && stale.count > 0) {
+		iPorts = _lscp_mirror_ports_batch(NULL, pTopology->audio_devices,
+			pTopology->audio_count, LSCP_MIRROR_AUDIO, &stale);
+		i = _lscp_mirror_ports_batch(NULL, pTopology->midi_devices,
+			pTopology->midi_count, LSCP_MIRROR_MIDI, &stale);
+		if (iPorts < 0 || i < 0)
+			ret = LSCP_FAILED;
+		else {
+			if (lscp_mirror_batch_init(&batch, iPorts + i) < 0)
+				ret = LSCP_FAILED;
+			if (ret == LSCP_OK) {
+				_lscp_mirror_ports_batch(&batch, pTopology->audio_devices,
+					pTopology->audio_count, LSCP_MIRROR_AUDIO, &stale);
+				_lscp_mirror_ports_batch(&batch, pTopology->midi_devices,
+					pTopology->midi_count, LSCP_MIRROR_MIDI, &stale);
+				ret = lscp_client_call_batch(pClient, batch.ppszQueries, batch.count, 1,
+					_lscp_mirror_port_result, &batch);
+			}
+			lscp_mirror_batch_free(&batch);
+		}
+	}
+
+	// Leave it all stale for a retry, if something went wrong...
+	if (ret != LSCP_OK) {
+		lscp_mutex_lock(pMirror->mutex);
+		pMirror->audio_stale |= iAudioStale;
+		pMirror->midi_stale  |= iMidiStale;
+		for (i = 0; i < stale.size; i++) {
+			if (stale.values[i])
+				lscp_hash_insert(&(pMirror->stale), stale.keys[i], pMirror);
+		}
+		lscp_mutex_unlock(pMirror->mutex);
+	}
+
+	lscp_hash_free(&stale);
+
+	return ret;
+}
+
+
+/**
+ *  Getting the whole audio output and MIDI input device topology, from
+ *  the local mirror. Only what was notified to be stale since the last
+ *  call gets refetched from the server, in a few pipelined requests.
+ *  The device topology mirror must be enabled with
+ *  @ref lscp_client_set_device_mirror.
+ *
+ *  @param pClient  Pointer to client instance structure.
+ *
+ *  @returns A pointer to a @ref lscp_device_topology_t structure, owned
+ *  by the client and valid until the next call, or NULL in case of failure.
+ */
+const lscp_device_topology_t *lscp_get_device_topology ( lscp_client_t *pClient )
+{
+	lscp_device_topology_t *pTopology = NULL;
+
+	if (pClient == NULL)
+		return NULL;
+	if (!pClient->device_mirror.enabled)
+		return NULL;
+
+	// Lock this section up.
+	lscp_mutex_lock(pClient->mutex);
+
+	if (_lscp_device_mirror_refresh(pClient) == LSCP_OK)
+		pTopology = &(pClient->device_mirror.topology);
+
+	// Unlock this section down.
+	lscp_mutex_unlock(pClient->mutex);
+
+	return pTopology;
 }
 
 
 //-------------------------------------------------------------------------
 // Generic parameter list functions.
 
+// Any parameter list will do here: the ones made by the library are
+// looked up through their key index, only caller built ones are scanned.
 const char *lscp_get_param_value ( lscp_param_t *pParams, const char *pszParam )
 {
 	int i;
 
+	if (lscp_plist_indexed(pParams))
+		return lscp_plist_find(pParams, pszParam);
+
 	for (i = 0; pParams && pParams[i].key; i++) {
 		if (strcasecmp(pParams[i].key, pszParam) == 0)
 			return (const char *) pParams[i].value;
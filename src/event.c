@@ -105,6 +105,54 @@ const char *lscp_event_to_text ( lscp_event_t event )
 }
 
 
+// Perfect hash table of all event names, as found offline for:
+//   h = (13 * s[0] + s[len - 4] + len) & 31
+// (case folded, all names are at least 11 chars long).
+#define LSCP_EVENT_HASH_SIZE  32
+#define LSCP_EVENT_HASH_MASK  (LSCP_EVENT_HASH_SIZE - 1)
+#define LSCP_EVENT_NAME_MIN   11
+
+static const struct _lscp_event_name_t
+{
+	const char   *name;
+	lscp_event_t  event;
+
+} _lscp_event_names[LSCP_EVENT_HASH_SIZE] = {
+	{ "CHANNEL_MIDI",              LSCP_EVENT_CHANNEL_MIDI              }, //  0
+	{ NULL,                        LSCP_EVENT_NONE                      }, //  1
+	{ NULL,                        LSCP_EVENT_NONE                      }, //  2
+	{ "CHANNEL_COUNT",             LSCP_EVENT_CHANNEL_COUNT             }, //  3
+	{ "TOTAL_VOICE_COUNT",         LSCP_EVENT_TOTAL_VOICE_COUNT         }, //  4
+	{ NULL,                        LSCP_EVENT_NONE                      }, //  5
+	{ "MIDI_INSTRUMENT_INFO",      LSCP_EVENT_MIDI_INSTRUMENT_INFO      }, //  6
+	{ NULL,                        LSCP_EVENT_NONE                      }, //  7
+	{ "MIDI_INPUT_DEVICE_INFO",    LSCP_EVENT_MIDI_INPUT_DEVICE_INFO    }, //  8
+	{ NULL,                        LSCP_EVENT_NONE                      }, //  9
+	{ "MIDI_INSTRUMENT_MAP_INFO",  LSCP_EVENT_MIDI_INSTRUMENT_MAP_INFO  }, // 10
+	{ "BUFFER_FILL",               LSCP_EVENT_BUFFER_FILL               }, // 11
+	{ "DEVICE_MIDI",               LSCP_EVENT_DEVICE_MIDI               }, // 12
+	{ "MIDI_INSTRUMENT_COUNT",     LSCP_EVENT_MIDI_INSTRUMENT_COUNT     }, // 13
+	{ "AUDIO_OUTPUT_DEVICE_INFO",  LSCP_EVENT_AUDIO_OUTPUT_DEVICE_INFO  }, // 14
+	{ "MIDI_INPUT_DEVICE_COUNT",   LSCP_EVENT_MIDI_INPUT_DEVICE_COUNT   }, // 15
+	{ NULL,                        LSCP_EVENT_NONE                      }, // 16
+	{ "MIDI_INSTRUMENT_MAP_COUNT", LSCP_EVENT_MIDI_INSTRUMENT_MAP_COUNT }, // 17
+	{ "STREAM_COUNT",              LSCP_EVENT_STREAM_COUNT              }, // 18
+	{ NULL,                        LSCP_EVENT_NONE                      }, // 19
+	{ NULL,                        LSCP_EVENT_NONE                      }, // 20
+	{ "AUDIO_OUTPUT_DEVICE_COUNT", LSCP_EVENT_AUDIO_OUTPUT_DEVICE_COUNT }, // 21
+	{ NULL,                        LSCP_EVENT_NONE                      }, // 22
+	{ NULL,                        LSCP_EVENT_NONE                      }, // 23
+	{ "VOICE_COUNT",               LSCP_EVENT_VOICE_COUNT               }, // 24
+	{ NULL,                        LSCP_EVENT_NONE                      }, // 25
+	{ NULL,                        LSCP_EVENT_NONE                      }, // 26
+	{ "MISCELLANEOUS",             LSCP_EVENT_MISCELLANEOUS             }, // 27
+	{ "CHANNEL_INFO",              LSCP_EVENT_CHANNEL_INFO              }, // 28
+	{ NULL,                        LSCP_EVENT_NONE                      }, // 29
+	{ NULL,                        LSCP_EVENT_NONE                      }, // 30
+	{ NULL,                        LSCP_EVENT_NONE                      }  // 31
+};
+
+
 /**
  *  Getting an event from a text string.
  *
@@ -114,46 +162,27 @@ const char *lscp_event_to_text ( lscp_event_t event )
  */
 lscp_event_t lscp_event_from_text ( const char *pszText )
 {
-	lscp_event_t event = LSCP_EVENT_NONE;
-
-	if (pszText) {
-		if (strcasecmp(pszText, "CHANNEL_COUNT") == 0)
-			event = LSCP_EVENT_CHANNEL_COUNT;
-		else if (strcasecmp(pszText, "VOICE_COUNT") == 0)
-			event = LSCP_EVENT_VOICE_COUNT;
-		else if (strcasecmp(pszText, "STREAM_COUNT") == 0)
-			event = LSCP_EVENT_STREAM_COUNT;
-		else if (strcasecmp(pszText, "BUFFER_FILL") == 0)
-			event = LSCP_EVENT_BUFFER_FILL;
-		else if (strcasecmp(pszText, "CHANNEL_INFO") == 0)
-			event = LSCP_EVENT_CHANNEL_INFO;
-		else if (strcasecmp(pszText, "TOTAL_VOICE_COUNT") == 0)
-			event = LSCP_EVENT_TOTAL_VOICE_COUNT;
-		else if (strcasecmp(pszText, "AUDIO_OUTPUT_DEVICE_COUNT") == 0)
-			event = LSCP_EVENT_AUDIO_OUTPUT_DEVICE_COUNT;
-		else if (strcasecmp(pszText, "AUDIO_OUTPUT_DEVICE_INFO") == 0)
-			event = LSCP_EVENT_AUDIO_OUTPUT_DEVICE_INFO;
-		else if (strcasecmp(pszText, "MIDI_INPUT_DEVICE_COUNT") == 0)
-			event = LSCP_EVENT_MIDI_INPUT_DEVICE_COUNT;
-		else if (strcasecmp(pszText, "MIDI_INPUT_DEVICE_INFO") == 0)
-			event = LSCP_EVENT_MIDI_INPUT_DEVICE_INFO;
-		else if (strcasecmp(pszText, "MIDI_INSTRUMENT_MAP_COUNT") == 0)
-			event = LSCP_EVENT_MIDI_INSTRUMENT_MAP_COUNT;
-		else if (strcasecmp(pszText, "MIDI_INSTRUMENT_MAP_INFO") == 0)
-			event = LSCP_EVENT_MIDI_INSTRUMENT_MAP_INFO;
-		else if (strcasecmp(pszText, "MIDI_INSTRUMENT_COUNT") == 0)
-			event = LSCP_EVENT_MIDI_INSTRUMENT_COUNT;
-		else if (strcasecmp(pszText, "MIDI_INSTRUMENT_INFO") == 0)
-			event = LSCP_EVENT_MIDI_INSTRUMENT_INFO;
-		else if (strcasecmp(pszText, "MISCELLANEOUS") == 0)
-			event = LSCP_EVENT_MISCELLANEOUS;
-		else if (strcasecmp(pszText, "CHANNEL_MIDI") == 0)
-			event = LSCP_EVENT_CHANNEL_MIDI;
-		else if (strcasecmp(pszText, "DEVICE_MIDI") == 0)
-			event = LSCP_EVENT_DEVICE_MIDI;
-	}
+	const struct _lscp_event_name_t *pName;
+	unsigned int h;
+	int cchText;
+
+	if (pszText == NULL)
+		return LSCP_EVENT_NONE;
+
+	cchText = strlen(pszText);
+	if (cchText < LSCP_EVENT_NAME_MIN)
+		return LSCP_EVENT_NONE;
+
+	// Case folding (0xdf) is fine as names are all letters or '_'...
+	h  = 13 * ((unsigned char) pszText[0] & 0xdf);
+	h += ((unsigned char) pszText[cchText - 4] & 0xdf);
+	h += (unsigned int) cchText;
+
+	pName = &_lscp_event_names[h & LSCP_EVENT_HASH_MASK];
+	if (pName->name && strcasecmp(pName->name, pszText) == 0)
+		return pName->event;
 
-	return event;
+	return LSCP_EVENT_NONE;
 }
 
 
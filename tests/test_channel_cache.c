@@ -0,0 +1,125 @@
+// test_channel_cache.c
+//
+/****************************************************************************
+   liblscp - LinuxSampler Control Protocol API
+   Copyright (C) 2004-2021, rncbc aka Rui Nuno Capela. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+*****************************************************************************/
+
+
+#include "test_server.h"
+
+#include <string.h>
+
+#define TEST_PORT   18805
+
+static const test_reply_t _replies[] = {
+	{ "GET CHANNEL INFO 0",
+		"ENGINE_NAME: GIG\r\n"
+		"VOLUME: 0.5\r\n"
+		"AUDIO_OUTPUT_DEVICE: 0\r\n"
+		"AUDIO_OUTPUT_CHANNELS: 2\r\n"
+		"AUDIO_OUTPUT_ROUTING: 0,1\r\n"
+		"MIDI_INPUT_DEVICE: 0\r\n"
+		"MIDI_INPUT_PORT: 0\r\n"
+		"MIDI_INPUT_CHANNEL: 3\r\n"
+		"INSTRUMENT_FILE: /samples/a.gig\r\n"
+		"INSTRUMENT_NR: 0\r\n"
+		"INSTRUMENT_NAME: Piano\r\n"
+		"INSTRUMENT_STATUS: 100\r\n"
+		"MUTE: false\r\n"
+		"SOLO: false\r\n"
+		"MIDI_INSTRUMENT_MAP: NONE\r\n"
+		".\r\n" },
+	{ NULL, NULL }
+};
+
+
+int main ( int argc, char *argv[] )
+{
+	lscp_server_t *pServer;
+	lscp_client_t *pClient;
+	lscp_channel_info_t *pChannelInfo;
+
+	(void) argc;
+	(void) argv;
+
+	pServer = test_server_start(TEST_PORT, _replies);
+	TEST_CHECK(pServer != NULL);
+	pClient = test_client_create(TEST_PORT);
+	TEST_CHECK(pClient != NULL);
+	if (pServer == NULL || pClient == NULL)
+		return 1;
+
+	TEST_CHECK(lscp_client_set_channel_cache(pClient, 1) == LSCP_OK);
+	TEST_CHECK(lscp_client_get_channel_cache(pClient) == 1);
+
+	// Fetched on first read only...
+	test_server_clear();
+	pChannelInfo = lscp_get_channel_info(pClient, 0);
+	TEST_CHECK(pChannelInfo != NULL);
+	pChannelInfo = lscp_get_channel_info(pClient, 0);
+	TEST_CHECK(pChannelInfo != NULL
+		&& pChannelInfo->midi_channel == 3
+		&& pChannelInfo->audio_routing && pChannelInfo->audio_routing[1] == 1
+		&& strcmp(pChannelInfo->instrument_name, "Piano") == 0);
+	TEST_CHECK(test_server_count("GET CHANNEL INFO 0") == 1);
+
+	// What's handed out is a copy, unaffected by notifications...
+	test_server_notify(pServer, LSCP_EVENT_CHANNEL_INFO, "0");
+	test_sleep(100);
+	TEST_CHECK(pChannelInfo->midi_channel == 3
+		&& strcmp(pChannelInfo->engine_name, "GIG") == 0);
+
+	// ...which have it refetched on next read.
+	pChannelInfo = lscp_get_channel_info(pClient, 0);
+	TEST_CHECK(pChannelInfo != NULL);
+	TEST_CHECK(test_server_count("GET CHANNEL INFO 0") == 2);
+
+	// Setters write-through, no round-trip on next read...
+	TEST_CHECK(lscp_set_channel_solo(pClient, 0, 1) == LSCP_OK);
+	TEST_CHECK(lscp_set_channel_volume(pClient, 0, 0.25f) == LSCP_OK);
+	TEST_CHECK(lscp_set_channel_audio_channel(pClient, 0, 1, 0) == LSCP_OK);
+	pChannelInfo = lscp_get_channel_info(pClient, 0);
+	TEST_CHECK(pChannelInfo != NULL
+		&& pChannelInfo->solo == 1
+		&& pChannelInfo->volume == 0.25f
+		&& pChannelInfo->audio_routing && pChannelInfo->audio_routing[1] == 0);
+	TEST_CHECK(test_server_count("GET CHANNEL INFO 0") == 2);
+
+	// ...until the server tells otherwise.
+	test_server_notify(pServer, LSCP_EVENT_CHANNEL_INFO, "0");
+	test_sleep(100);
+	pChannelInfo = lscp_get_channel_info(pClient, 0);
+	TEST_CHECK(pChannelInfo != NULL && pChannelInfo->solo == 0);
+	TEST_CHECK(test_server_count("GET CHANNEL INFO 0") == 3);
+
+	// Channels gone are not cached at all.
+	TEST_CHECK(lscp_get_channel_info(pClient, 1) == NULL);
+	TEST_CHECK(lscp_get_channel_info(pClient, 1) == NULL);
+	TEST_CHECK(test_server_count("GET CHANNEL INFO 1") == 2);
+
+	TEST_CHECK(lscp_client_set_channel_cache(pClient, 0) == LSCP_OK);
+
+	lscp_client_destroy(pClient);
+	test_server_stop(pServer);
+
+	return TEST_RESULT();
+}
+
+
+// end of test_channel_cache.c
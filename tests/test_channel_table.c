@@ -0,0 +1,105 @@
+// test_channel_table.c
+//
+/****************************************************************************
+   liblscp - LinuxSampler Control Protocol API
+   Copyright (C) 2004-2021, rncbc aka Rui Nuno Capela. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+*****************************************************************************/
+
+#include "test_server.h"
+
+#include <string.h>
+
+#define TEST_PORT   18811
+
+#define TEST_CHANNEL_INFO(engine) \
+	"ENGINE_NAME: " engine "\r\n" \
+	"VOLUME: 1.0\r\n" \
+	"AUDIO_OUTPUT_DEVICE: 0\r\n" \
+	"AUDIO_OUTPUT_CHANNELS: 2\r\n" \
+	"AUDIO_OUTPUT_ROUTING: 0,1\r\n" \
+	"MIDI_INPUT_DEVICE: 0\r\n" \
+	"MIDI_INPUT_PORT: 0\r\n" \
+	"MIDI_INPUT_CHANNEL: ALL\r\n" \
+	"INSTRUMENT_FILE: /samples/a.gig\r\n" \
+	"INSTRUMENT_NR: 0\r\n" \
+	"INSTRUMENT_NAME: Some\r\n" \
+	"INSTRUMENT_STATUS: 100\r\n" \
+	"MUTE: false\r\n" \
+	"SOLO: false\r\n" \
+	"MIDI_INSTRUMENT_MAP: NONE\r\n" \
+	".\r\n"
+
+// Sparse sampler channels, one of these long lived (huge numbered).
+static const test_reply_t _replies[] = {
+	{ "LIST CHANNELS", "5,2147483646,0\r\n" },
+	{ "GET CHANNEL INFO 5", TEST_CHANNEL_INFO("SF2") },
+	{ "GET CHANNEL INFO 2147483646", TEST_CHANNEL_INFO("GIG") },
+	{ "GET CHANNEL INFO 0", TEST_CHANNEL_INFO("SFZ") },
+	{ NULL, NULL }
+};
+
+
+int main ( int argc, char *argv[] )
+{
+	lscp_server_t *pServer;
+	lscp_client_t *pClient;
+	const lscp_channel_table_t *pTable;
+	int iRow;
+
+	(void) argc;
+	(void) argv;
+
+	pServer = test_server_start(TEST_PORT, _replies);
+	TEST_CHECK(pServer != NULL);
+	pClient = test_client_create(TEST_PORT);
+	TEST_CHECK(pClient != NULL);
+	if (pServer == NULL || pClient == NULL)
+		return 1;
+
+	// No table, no rows...
+	TEST_CHECK(lscp_channel_table_row(NULL, 0) == -1);
+
+	pTable = lscp_get_all_channel_info(pClient, 0);
+	TEST_CHECK(pTable != NULL && pTable->count == 3);
+	if (pTable == NULL)
+		return TEST_RESULT();
+
+	// Each sampler channel to its own row, however sparse...
+	iRow = lscp_channel_table_row(pTable, 2147483646);
+	TEST_CHECK(iRow >= 0 && pTable->channel[iRow] == 2147483646
+		&& strcmp(pTable->engine_name[iRow], "GIG") == 0);
+	iRow = lscp_channel_table_row(pTable, 5);
+	TEST_CHECK(iRow >= 0 && pTable->channel[iRow] == 5
+		&& strcmp(pTable->engine_name[iRow], "SF2") == 0);
+	iRow = lscp_channel_table_row(pTable, 0);
+	TEST_CHECK(iRow >= 0 && pTable->channel[iRow] == 0
+		&& strcmp(pTable->engine_name[iRow], "SFZ") == 0);
+
+	// ...and none for the ones not found.
+	TEST_CHECK(lscp_channel_table_row(pTable, 1) == -1);
+	TEST_CHECK(lscp_channel_table_row(pTable, -1) == -1);
+	TEST_CHECK(lscp_channel_table_row(pTable, 2147483647) == -1);
+
+	lscp_client_destroy(pClient);
+	test_server_stop(pServer);
+
+	return TEST_RESULT();
+}
+
+
+// end of test_channel_table.c
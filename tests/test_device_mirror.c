@@ -0,0 +1,128 @@
+// test_device_mirror.c
+//
+/****************************************************************************
+   liblscp - LinuxSampler Control Protocol API
+   Copyright (C) 2004-2021, rncbc aka Rui Nuno Capela. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+*****************************************************************************/
+
+
+#include "test_server.h"
+#include "lscp/device.h"
+
+#include <string.h>
+
+#define TEST_PORT   18806
+
+static const test_reply_t _replies[] = {
+	{ "LIST AUDIO_OUTPUT_DEVICES", "0,1\r\n" },
+	{ "LIST MIDI_INPUT_DEVICES", "0\r\n" },
+	{ "GET AUDIO_OUTPUT_DEVICE INFO 0",
+		"DRIVER: ALSA\r\n"
+		"ACTIVE: true\r\n"
+		"CHANNELS: 2\r\n"
+		".\r\n" },
+	{ "GET AUDIO_OUTPUT_DEVICE INFO 1",
+		"DRIVER: JACK\r\n"
+		"ACTIVE: true\r\n"
+		"CHANNELS: 1\r\n"
+		".\r\n" },
+	{ "GET AUDIO_OUTPUT_CHANNEL INFO",
+		"NAME: Output\r\n"
+		"IS_MIX_CHANNEL: false\r\n"
+		".\r\n" },
+	{ "GET MIDI_INPUT_DEVICE INFO 0",
+		"DRIVER: ALSA\r\n"
+		"ACTIVE: true\r\n"
+		"PORTS: 1\r\n"
+		".\r\n" },
+	{ "GET MIDI_INPUT_PORT INFO 0 0",
+		"NAME: Port 0\r\n"
+		".\r\n" },
+	{ NULL, NULL }
+};
+
+
+int main ( int argc, char *argv[] )
+{
+	lscp_server_t *pServer;
+	lscp_client_t *pClient;
+	const lscp_device_topology_t *pTopology;
+
+	(void) argc;
+	(void) argv;
+
+	pServer = test_server_start(TEST_PORT, _replies);
+	TEST_CHECK(pServer != NULL);
+	pClient = test_client_create(TEST_PORT);
+	TEST_CHECK(pClient != NULL);
+	if (pServer == NULL || pClient == NULL)
+		return 1;
+
+	TEST_CHECK(lscp_client_set_device_mirror(pClient, 1) == LSCP_OK);
+	TEST_CHECK(lscp_client_get_device_mirror(pClient) == 1);
+
+	// The whole topology, on first access...
+	pTopology = lscp_get_device_topology(pClient);
+	TEST_CHECK(pTopology != NULL);
+	if (pTopology == NULL)
+		return TEST_RESULT();
+	TEST_CHECK(pTopology->audio_count == 2 && pTopology->midi_count == 1);
+	if (pTopology->audio_count == 2 && pTopology->midi_count == 1) {
+		TEST_CHECK(pTopology->audio_devices[0].port_count == 2);
+		TEST_CHECK(pTopology->audio_devices[1].port_count == 1);
+		TEST_CHECK(strcmp(pTopology->audio_devices[1].info.driver, "JACK") == 0);
+		TEST_CHECK(pTopology->midi_devices[0].port_count == 1);
+		TEST_CHECK(strcmp(pTopology->midi_devices[0].ports[0].name, "Port 0") == 0);
+	}
+
+	// Nothing refetched unless notified stale...
+	test_server_clear();
+	TEST_CHECK(lscp_get_device_topology(pClient) != NULL);
+	TEST_CHECK(test_server_count("") == 0);
+
+	// ...and then just the one device.
+	test_server_notify(pServer, LSCP_EVENT_AUDIO_OUTPUT_DEVICE_INFO, "1");
+	test_sleep(100);
+	pTopology = lscp_get_device_topology(pClient);
+	TEST_CHECK(pTopology != NULL && pTopology->audio_count == 2);
+	TEST_CHECK(test_server_count("GET AUDIO_OUTPUT_DEVICE INFO 1") == 1);
+	TEST_CHECK(test_server_count("GET AUDIO_OUTPUT_CHANNEL INFO 1 0") == 1);
+	TEST_CHECK(test_server_count("GET") == 2);
+	TEST_CHECK(test_server_count("LIST") == 0);
+
+	// Whole device lists, as told...
+	test_server_clear();
+	test_server_notify(pServer, LSCP_EVENT_MIDI_INPUT_DEVICE_COUNT, "1");
+	test_sleep(100);
+	pTopology = lscp_get_device_topology(pClient);
+	TEST_CHECK(pTopology != NULL && pTopology->midi_count == 1);
+	TEST_CHECK(test_server_count("LIST MIDI_INPUT_DEVICES") == 1);
+	TEST_CHECK(test_server_count("LIST AUDIO_OUTPUT_DEVICES") == 0);
+	TEST_CHECK(test_server_count("GET") == 0);
+
+	TEST_CHECK(lscp_client_set_device_mirror(pClient, 0) == LSCP_OK);
+	TEST_CHECK(lscp_get_device_topology(pClient) == NULL);
+
+	lscp_client_destroy(pClient);
+	test_server_stop(pServer);
+
+	return TEST_RESULT();
+}
+
+
+// end of test_device_mirror.c
@@ -0,0 +1,202 @@
+// test_event_handlers.c
+//
+/****************************************************************************
+   liblscp - LinuxSampler Control Protocol API
+   Copyright (C) 2004-2021, rncbc aka Rui Nuno Capela. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+*****************************************************************************/
+
+
+#include "test_server.h"
+
+#include <string.h>
+
+#define TEST_PORT   18809
+
+// What each handler got, in order.
+typedef struct _test_seen_t
+{
+	int channels[16];
+	int count;
+
+} test_seen_t;
+
+// A handler that unregisters itself, on first event.
+typedef struct _test_once_t
+{
+	int handle;
+	int count;
+
+} test_once_t;
+
+static int _test_callback_count = 0;
+
+
+static lscp_status_t _test_callback ( lscp_client_t *pClient,
+	lscp_event_t event, const char *pchData, int cchData, void *pvData )
+{
+	(void) pClient;
+	(void) event;
+	(void) pchData;
+	(void) cchData;
+	(void) pvData;
+
+	_test_callback_count++;
+
+	return LSCP_OK;
+}
+
+
+static lscp_status_t _test_handler ( lscp_client_t *pClient,
+	const lscp_event_data_t *pEventData, void *pvData )
+{
+	test_seen_t *pSeen = (test_seen_t *) pvData;
+
+	(void) pClient;
+
+	if (pSeen->count < 16)
+		pSeen->channels[pSeen->count++] = pEventData->channel;
+
+	return LSCP_OK;
+}
+
+
+static lscp_status_t _test_handler_once ( lscp_client_t *pClient,
+	const lscp_event_data_t *pEventData, void *pvData )
+{
+	test_once_t *pOnce = (test_once_t *) pvData;
+
+	(void) pEventData;
+
+	pOnce->count++;
+	lscp_client_remove_event_handler(pClient, pOnce->handle);
+
+	return LSCP_OK;
+}
+
+
+// Wait for some handler to have seen so many events, for a while.
+static void _test_wait_for ( test_seen_t *pSeen, int iCount )
+{
+	int i;
+
+	for (i = 0; i < 100 && pSeen->count < iCount; i++)
+		test_sleep(10);
+}
+
+
+int main ( int argc, char *argv[] )
+{
+	lscp_server_t *pServer;
+	lscp_client_t *pClient;
+	test_seen_t seen1, seen2, seenAny;
+	test_once_t once;
+	int iHandle1, iHandle2, iHandleAny, iHandleCount;
+
+	(void) argc;
+	(void) argv;
+
+	memset(&seen1, 0, sizeof(seen1));
+	memset(&seen2, 0, sizeof(seen2));
+	memset(&seenAny, 0, sizeof(seenAny));
+
+	pServer = test_server_start(TEST_PORT, NULL);
+	TEST_CHECK(pServer != NULL);
+	pClient = lscp_client_create("127.0.0.1", TEST_PORT, _test_callback, NULL);
+	TEST_CHECK(pClient != NULL);
+	if (pServer == NULL || pClient == NULL)
+		return 1;
+
+	lscp_client_set_timeout(pClient, 2000);
+
+	// Bogus events are refused...
+	TEST_CHECK(lscp_client_add_event_handler(pClient,
+		LSCP_EVENT_NONE, -1, _test_handler, &seenAny) < 0);
+	TEST_CHECK(lscp_client_remove_event_handler(pClient, 12345) == LSCP_FAILED);
+
+	// The first handler of an event subscribes it, only once...
+	iHandle1 = lscp_client_add_event_handler(pClient,
+		LSCP_EVENT_CHANNEL_INFO, 1, _test_handler, &seen1);
+	TEST_CHECK(iHandle1 > 0);
+	iHandle2 = lscp_client_add_event_handler(pClient,
+		LSCP_EVENT_CHANNEL_INFO, 2, _test_handler, &seen2);
+	TEST_CHECK(iHandle2 > 0 && iHandle2 != iHandle1);
+	iHandleAny = lscp_client_add_event_handler(pClient,
+		LSCP_EVENT_CHANNEL_INFO, -1, _test_handler, &seenAny);
+	TEST_CHECK(iHandleAny > 0);
+	TEST_CHECK(test_server_count("SUBSCRIBE CHANNEL_INFO") == 1);
+
+	// Each gets just its own sampler channel, or any...
+	test_server_notify(pServer, LSCP_EVENT_CHANNEL_INFO,
+		"1\r\n"
+		"NOTIFY:CHANNEL_INFO:2\r\n"
+		"NOTIFY:CHANNEL_INFO:3\r\n"
+		"NOTIFY:CHANNEL_INFO:1");
+	_test_wait_for(&seenAny, 4);
+	TEST_CHECK(seen1.count == 2 && seen1.channels[0] == 1 && seen1.channels[1] == 1);
+	TEST_CHECK(seen2.count == 1 && seen2.channels[0] == 2);
+	TEST_CHECK(seenAny.count == 4 && seenAny.channels[0] == 1
+		&& seenAny.channels[1] == 2 && seenAny.channels[2] == 3
+		&& seenAny.channels[3] == 1);
+	// ...but not the client callback, as not subscribed by the client.
+	TEST_CHECK(_test_callback_count == 0);
+
+	// The last handler of an event unsubscribes it...
+	TEST_CHECK(lscp_client_remove_event_handler(pClient, iHandle1) == LSCP_OK);
+	TEST_CHECK(lscp_client_remove_event_handler(pClient, iHandle1) == LSCP_FAILED);
+	TEST_CHECK(lscp_client_remove_event_handler(pClient, iHandle2) == LSCP_OK);
+	TEST_CHECK(test_server_count("UNSUBSCRIBE CHANNEL_INFO") == 0);
+	TEST_CHECK(lscp_client_remove_event_handler(pClient, iHandleAny) == LSCP_OK);
+	TEST_CHECK(test_server_count("UNSUBSCRIBE CHANNEL_INFO") == 1);
+
+	// ...unless also subscribed by the client itself, then both get it.
+	TEST_CHECK(lscp_client_subscribe(pClient, LSCP_EVENT_CHANNEL_COUNT) == LSCP_OK);
+	test_server_clear();
+	memset(&seenAny, 0, sizeof(seenAny));
+	iHandleCount = lscp_client_add_event_handler(pClient,
+		LSCP_EVENT_CHANNEL_COUNT, -1, _test_handler, &seenAny);
+	TEST_CHECK(iHandleCount > 0);
+	TEST_CHECK(test_server_count("SUBSCRIBE") == 0);
+	test_server_notify(pServer, LSCP_EVENT_CHANNEL_COUNT, "4");
+	_test_wait_for(&seenAny, 1);
+	test_sleep(50);
+	TEST_CHECK(seenAny.count == 1);
+	TEST_CHECK(_test_callback_count == 1);
+
+	// Handlers may unregister themselves, from the event service thread...
+	once.count = 0;
+	once.handle = lscp_client_add_event_handler(pClient,
+		LSCP_EVENT_CHANNEL_COUNT, -1, _test_handler_once, &once);
+	TEST_CHECK(once.handle > 0);
+	test_server_notify(pServer, LSCP_EVENT_CHANNEL_COUNT,
+		"5\r\n"
+		"NOTIFY:CHANNEL_COUNT:6");
+	_test_wait_for(&seenAny, 3);
+	TEST_CHECK(seenAny.count == 3);
+	TEST_CHECK(once.count == 1);
+	TEST_CHECK(lscp_client_remove_event_handler(pClient, once.handle) == LSCP_FAILED);
+	TEST_CHECK(lscp_client_remove_event_handler(pClient, iHandleCount) == LSCP_OK);
+	TEST_CHECK(test_server_count("UNSUBSCRIBE") == 0);
+
+	lscp_client_destroy(pClient);
+	test_server_stop(pServer);
+
+	return TEST_RESULT();
+}
+
+
+// end of test_event_handlers.c
@@ -0,0 +1,106 @@
+// test_event_names.c
+//
+/****************************************************************************
+   liblscp - LinuxSampler Control Protocol API
+   Copyright (C) 2004-2021, rncbc aka Rui Nuno Capela. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+*****************************************************************************/
+
+
+#include "test_server.h"
+
+#include <string.h>
+#include <ctype.h>
+#include <strings.h>
+
+
+int main ( int argc, char *argv[] )
+{
+	static const lscp_event_t events[] = {
+		LSCP_EVENT_CHANNEL_COUNT,
+		LSCP_EVENT_VOICE_COUNT,
+		LSCP_EVENT_STREAM_COUNT,
+		LSCP_EVENT_BUFFER_FILL,
+		LSCP_EVENT_CHANNEL_INFO,
+		LSCP_EVENT_TOTAL_VOICE_COUNT,
+		LSCP_EVENT_AUDIO_OUTPUT_DEVICE_COUNT,
+		LSCP_EVENT_AUDIO_OUTPUT_DEVICE_INFO,
+		LSCP_EVENT_MIDI_INPUT_DEVICE_COUNT,
+		LSCP_EVENT_MIDI_INPUT_DEVICE_INFO,
+		LSCP_EVENT_MIDI_INSTRUMENT_MAP_COUNT,
+		LSCP_EVENT_MIDI_INSTRUMENT_MAP_INFO,
+		LSCP_EVENT_MIDI_INSTRUMENT_COUNT,
+		LSCP_EVENT_MIDI_INSTRUMENT_INFO,
+		LSCP_EVENT_MISCELLANEOUS,
+		LSCP_EVENT_CHANNEL_MIDI,
+		LSCP_EVENT_DEVICE_MIDI
+	};
+
+	static const char *bogus[] = {
+		"", "X", "INFO", "COUNT", "CHANNEL", "CHANNEL_", "CHANNEL_INF",
+		"CHANNEL_INFOS", "CHANNEL INFO", "_CHANNEL_INFO", "VOICE_COUNT ",
+		NULL
+	};
+
+	const int iEvents = (int) (sizeof(events) / sizeof(events[0]));
+	const char *pszName;
+	char szName[64];
+	lscp_event_t event;
+	int i, j, k, n;
+
+	(void) argc;
+	(void) argv;
+
+	for (i = 0; i < iEvents; i++) {
+		pszName = lscp_event_to_text(events[i]);
+		TEST_CHECK(pszName != NULL);
+		if (pszName == NULL)
+			continue;
+		// Each and every name maps back, in any case...
+		TEST_CHECK(lscp_event_from_text(pszName) == events[i]);
+		n = (int) strlen(pszName);
+		for (k = 0; k <= n; k++)
+			szName[k] = (char) tolower((unsigned char) pszName[k]);
+		TEST_CHECK(lscp_event_from_text(szName) == events[i]);
+		// ...but not with any single character changed, or truncated.
+		for (j = 0; j < n; j++) {
+			strcpy(szName, pszName);
+			for (k = 'A'; k <= 'Z' + 1; k++) {
+				szName[j] = (char) (k > 'Z' ? '_' : k);
+				event = lscp_event_from_text(szName);
+				if (strcasecmp(szName, pszName) == 0)
+					TEST_CHECK(event == events[i]);
+				else
+					TEST_CHECK(event != events[i]);
+			}
+			strcpy(szName, pszName);
+			szName[j] = (char) 0;
+			TEST_CHECK(lscp_event_from_text(szName) == LSCP_EVENT_NONE);
+		}
+	}
+
+	for (i = 0; bogus[i]; i++)
+		TEST_CHECK(lscp_event_from_text(bogus[i]) == LSCP_EVENT_NONE);
+
+	TEST_CHECK(lscp_event_from_text(NULL) == LSCP_EVENT_NONE);
+	TEST_CHECK(lscp_event_to_text(LSCP_EVENT_NONE) == NULL);
+
+	return TEST_RESULT();
+}
+
+
+// end of test_event_names.c
@@ -0,0 +1,213 @@
+// test_event_queue.c
+//
+/****************************************************************************
+   liblscp - LinuxSampler Control Protocol API
+   Copyright (C) 2004-2021, rncbc aka Rui Nuno Capela. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+*****************************************************************************/
+
+
+#include "test_server.h"
+#include "src/common.h"
+
+#include <string.h>
+#include <sys/time.h>
+
+#define TEST_PORT   18808
+
+// Ten CHANNEL_INFO notifications (0..9), all sent in one go.
+#define TEST_EVENTS "0\r\n" \
+	"NOTIFY:CHANNEL_INFO:1\r\n" \
+	"NOTIFY:CHANNEL_INFO:2\r\n" \
+	"NOTIFY:CHANNEL_INFO:3\r\n" \
+	"NOTIFY:CHANNEL_INFO:4\r\n" \
+	"NOTIFY:CHANNEL_INFO:5\r\n" \
+	"NOTIFY:CHANNEL_INFO:6\r\n" \
+	"NOTIFY:CHANNEL_INFO:7\r\n" \
+	"NOTIFY:CHANNEL_INFO:8\r\n" \
+	"NOTIFY:CHANNEL_INFO:9"
+
+// Sampler channels seen by the event callback, in order.
+static int _test_seen[64];
+static int _test_seen_count = 0;
+
+static volatile int _test_ready = 0;
+
+
+static lscp_status_t _test_callback ( lscp_client_t *pClient,
+	lscp_event_t event, const char *pchData, int cchData, void *pvData )
+{
+	(void) pClient;
+	(void) cchData;
+	(void) pvData;
+
+	if (event == LSCP_EVENT_CHANNEL_INFO && _test_seen_count < 64)
+		_test_seen[_test_seen_count++] = lscp_atoi(pchData);
+
+	return LSCP_OK;
+}
+
+
+static void _test_ready_callback ( lscp_client_t *pClient, void *pvData )
+{
+	(void) pClient;
+	(void) pvData;
+
+	_test_ready++;
+}
+
+
+// Whether the seen sampler channels are just 0..n-1, in order.
+static int _test_seen_in_order ( int n )
+{
+	int i;
+
+	if (_test_seen_count != n)
+		return 0;
+
+	for (i = 0; i < n; i++) {
+		if (_test_seen[i] != i)
+			return 0;
+	}
+
+	return 1;
+}
+
+
+// Current time in milliseconds.
+static long _test_clock (void)
+{
+	struct timeval tv;
+
+	gettimeofday(&tv, NULL);
+
+	return (long) tv.tv_sec * 1000 + (long) (tv.tv_usec / 1000);
+}
+
+
+// Wait for some events to have been queued or dropped, for a while.
+static void _test_wait_for ( lscp_client_t *pClient, int iEvents )
+{
+	lscp_event_queue_t *pQueue = pClient->evt_queue;
+	int i;
+
+	for (i = 0; i < 300; i++) {
+		if ((int) (pQueue->tail - pQueue->head)
+			+ (int) pQueue->drops >= iEvents)
+			break;
+		test_sleep(10);
+	}
+}
+
+
+int main ( int argc, char *argv[] )
+{
+	lscp_server_t *pServer;
+	lscp_client_t *pClient;
+	int i, n;
+	long t0;
+
+	(void) argc;
+	(void) argv;
+
+	pServer = test_server_start(TEST_PORT, NULL);
+	TEST_CHECK(pServer != NULL);
+	pClient = lscp_client_create("127.0.0.1", TEST_PORT, _test_callback, NULL);
+	TEST_CHECK(pClient != NULL);
+	if (pServer == NULL || pClient == NULL)
+		return 1;
+
+	lscp_client_set_timeout(pClient, 2000);
+	TEST_CHECK(lscp_client_subscribe(pClient, LSCP_EVENT_CHANNEL_INFO) == LSCP_OK);
+
+	// Drop policy: the newest events are dropped while full...
+	TEST_CHECK(lscp_client_set_event_queue(pClient, 4,
+		LSCP_QUEUE_DROP, _test_ready_callback, NULL) == LSCP_OK);
+	TEST_CHECK(lscp_client_get_event_queue(pClient) == 4);
+	test_server_notify(pServer, LSCP_EVENT_CHANNEL_INFO, TEST_EVENTS);
+	_test_wait_for(pClient, 10);
+	TEST_CHECK(_test_seen_count == 0);
+	TEST_CHECK(_test_ready == 1);
+	TEST_CHECK(lscp_client_get_event_drops(pClient) == 6);
+	TEST_CHECK(lscp_client_drain_events(pClient, 0) == 4);
+	TEST_CHECK(_test_seen_in_order(4));
+	TEST_CHECK(lscp_client_drain_events(pClient, 0) == 0);
+
+	// ...and ready is signaled again, once drained.
+	test_server_notify(pServer, LSCP_EVENT_CHANNEL_INFO, "0");
+	for (i = 0; i < 100 && _test_ready < 2; i++)
+		test_sleep(10);
+	TEST_CHECK(_test_ready == 2);
+
+	// Wait policy: nothing lost while drained meanwhile...
+	_test_seen_count = 0;
+	TEST_CHECK(lscp_client_set_event_queue(pClient, 4,
+		LSCP_QUEUE_WAIT, _test_ready_callback, NULL) == LSCP_OK);
+	TEST_CHECK(lscp_client_get_event_drops(pClient) == 0);
+	test_server_notify(pServer, LSCP_EVENT_CHANNEL_INFO, TEST_EVENTS);
+	test_sleep(100);
+	for (i = n = 0; i < 300 && n < 10; i++) {
+		n += lscp_client_drain_events(pClient, 0);
+		test_sleep(10);
+	}
+	TEST_CHECK(n == 10);
+	TEST_CHECK(_test_seen_in_order(10));
+	TEST_CHECK(lscp_client_get_event_drops(pClient) == 0);
+
+	// ...but still dropping past the client timeout, if not drained.
+	_test_seen_count = 0;
+	lscp_client_set_timeout(pClient, 100);
+	test_server_notify(pServer, LSCP_EVENT_CHANNEL_INFO,
+		"0\r\n"
+		"NOTIFY:CHANNEL_INFO:1\r\n"
+		"NOTIFY:CHANNEL_INFO:2\r\n"
+		"NOTIFY:CHANNEL_INFO:3\r\n"
+		"NOTIFY:CHANNEL_INFO:4\r\n"
+		"NOTIFY:CHANNEL_INFO:5");
+	_test_wait_for(pClient, 6);
+	TEST_CHECK(lscp_client_get_event_drops(pClient) == 2);
+	TEST_CHECK(lscp_client_drain_events(pClient, 0) == 4);
+	TEST_CHECK(_test_seen_in_order(4));
+
+	// Nor held while (un)subscription replies are due.
+	_test_seen_count = 0;
+	lscp_client_set_timeout(pClient, 2000);
+	test_server_notify(pServer, LSCP_EVENT_CHANNEL_INFO, TEST_EVENTS);
+	for (i = 0; i < 100 && pClient->evt_queue->tail
+			- pClient->evt_queue->head < 4; i++)
+		test_sleep(10);
+	t0 = _test_clock();
+	TEST_CHECK(lscp_client_subscribe(pClient, LSCP_EVENT_CHANNEL_COUNT) == LSCP_OK);
+	TEST_CHECK(_test_clock() - t0 < 1000);
+	_test_wait_for(pClient, 10);
+	TEST_CHECK(lscp_client_drain_events(pClient, 0) == 4);
+	TEST_CHECK(_test_seen_in_order(4));
+
+	// Back to direct delivery.
+	TEST_CHECK(lscp_client_set_event_queue(pClient, 0,
+		LSCP_QUEUE_DROP, NULL, NULL) == LSCP_OK);
+	TEST_CHECK(lscp_client_get_event_queue(pClient) == 0);
+	TEST_CHECK(lscp_client_drain_events(pClient, 0) == -1);
+
+	lscp_client_destroy(pClient);
+	test_server_stop(pServer);
+
+	return TEST_RESULT();
+}
+
+
+// end of test_event_queue.c
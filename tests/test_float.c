@@ -0,0 +1,112 @@
+// test_float.c
+//
+/****************************************************************************
+   liblscp - LinuxSampler Control Protocol API
+   Copyright (C) 2004-2021, rncbc aka Rui Nuno Capela. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+*****************************************************************************/
+
+
+#include "test_server.h"
+#include "src/common.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#define TEST_ROUNDS  1000000
+
+
+// Same bits, or both not a number.
+static int _test_same ( float f, float g )
+{
+	return (memcmp(&f, &g, sizeof(float)) == 0 || (f != f && g != g));
+}
+
+
+// Random float bits, any but not a number or infinity.
+static float _test_random ( unsigned int *puSeed )
+{
+	union { float f; uint32_t u; } x;
+
+	do {
+		*puSeed = (*puSeed * 1103515245u) + 12345u;
+		x.u = (*puSeed >> 16);
+		*puSeed = (*puSeed * 1103515245u) + 12345u;
+		x.u |= (*puSeed & 0xffff0000u);
+	}
+	while ((x.u & 0x7f800000u) == 0x7f800000u);
+
+	return x.f;
+}
+
+
+int main ( int argc, char *argv[] )
+{
+	static const char *numbers[] = {
+		"0", "-0", "1", "0.5", "1.25", "-3.75", "0.1", "0.707",
+		"  2.5", "+7", "1e3", "1.5E-3", "3.4028235e38", "1.17549435e-38",
+		"967498269e-19",  // Double rounded onto a float halfway point.
+		"16777217", "16777219", "1.00000006", "0.300000012",
+		NULL
+	};
+
+	char szBuffer[64];
+	unsigned int uSeed = 1;
+	float f, g;
+	int i, n;
+
+	(void) argc;
+	(void) argv;
+
+	for (i = 0; numbers[i]; i++) {
+		f = lscp_atof(numbers[i]);
+		g = strtof(numbers[i], NULL);
+		TEST_CHECK(_test_same(f, g));
+		if (!_test_same(f, g))
+			fprintf(stderr, "\"%s\": %.9g != %.9g\n", numbers[i], f, g);
+	}
+
+	// Just as strtof() does, on up to 9 significant digits, and
+	// the shortest form always parses back to the very same float...
+	for (i = 0; i < TEST_ROUNDS; i++) {
+		f = _test_random(&uSeed);
+		// Keep within the correctly rounded range...
+		if (f != 0.0f && (f > -1e-7f && f < 1e-7f))
+			continue;
+		if (f > 1e7f || f < -1e7f)
+			continue;
+		sprintf(szBuffer, "%.9g", f);
+		g = lscp_atof(szBuffer);
+		if (!_test_same(g, strtof(szBuffer, NULL))) {
+			TEST_CHECK(_test_same(g, strtof(szBuffer, NULL)));
+			fprintf(stderr, "\"%s\"\n", szBuffer);
+			break;
+		}
+		n = lscp_ftoa(szBuffer, sizeof(szBuffer), f);
+		if (n < 1 || !_test_same(lscp_atof(szBuffer), f)) {
+			TEST_CHECK(_test_same(lscp_atof(szBuffer), f));
+			fprintf(stderr, "%.9g: \"%s\"\n", f, szBuffer);
+			break;
+		}
+	}
+
+	return TEST_RESULT();
+}
+
+
+// end of test_float.c
@@ -0,0 +1,129 @@
+// test_framer.c
+//
+/****************************************************************************
+   liblscp - LinuxSampler Control Protocol API
+   Copyright (C) 2004-2021, rncbc aka Rui Nuno Capela. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+*****************************************************************************/
+
+
+#include "test_server.h"
+#include "src/common.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define TEST_ROUNDS  200
+
+
+// Feed some data in chunks of random sizes (up to cchChunk),
+// appending each complete line as taken, LF terminated, to pszLines.
+static void _test_feed ( lscp_framer_t *pFramer, const char *pchData,
+	int cchData, int cchChunk, unsigned int *puSeed, char *pszLines )
+{
+	char *pchSpace, *pszLine;
+	int cchSpace, n;
+
+	while (cchData > 0) {
+		*puSeed = (*puSeed * 1103515245u) + 12345u;
+		n = 1 + (int) ((*puSeed >> 16) % (unsigned int) cchChunk);
+		if (n > cchData)
+			n = cchData;
+		pchSpace = lscp_framer_space(pFramer, &cchSpace);
+		TEST_CHECK(pchSpace != NULL && cchSpace >= n);
+		if (pchSpace == NULL || cchSpace < n)
+			return;
+		memcpy(pchSpace, pchData, n);
+		lscp_framer_commit(pFramer, n);
+		pchData += n;
+		cchData -= n;
+		while ((pszLine = lscp_framer_line(pFramer)) != NULL) {
+			strcat(pszLines, pszLine);
+			strcat(pszLines, "\n");
+		}
+	}
+}
+
+
+int main ( int argc, char *argv[] )
+{
+	static const char *pszStream =
+		"NOTIFY:CHANNEL_INFO:0\r\n"
+		"\r\n"
+		"NOTIFY:VOICE_COUNT:1 12\r\n"
+		"NOTIFY:MISCELLANEOUS:no carriage return\n"
+		"NOTIFY:BUFFER_FILL:0 [1]10%,[2]20%\r\n"
+		"NOTIFY:partial";
+	static const char *pszExpected =
+		"NOTIFY:CHANNEL_INFO:0\n"
+		"\n"
+		"NOTIFY:VOICE_COUNT:1 12\n"
+		"NOTIFY:MISCELLANEOUS:no carriage return\n"
+		"NOTIFY:BUFFER_FILL:0 [1]10%,[2]20%\n";
+
+	lscp_framer_t framer;
+	unsigned int uSeed = 1;
+	char szLines[1024];
+	char *pchLong;
+	int cchLong, i;
+
+	(void) argc;
+	(void) argv;
+
+	// Whatever the read sizes, the very same lines come out,
+	// and the trailing partial one is kept pending...
+	for (i = 0; i < TEST_ROUNDS; i++) {
+		lscp_framer_init(&framer);
+		szLines[0] = (char) 0;
+		_test_feed(&framer, pszStream, strlen(pszStream),
+			1 + (i % 32), &uSeed, szLines);
+		TEST_CHECK(strcmp(szLines, pszExpected) == 0);
+		if (strcmp(szLines, pszExpected) != 0) {
+			fprintf(stderr, "round %d:\n%s", i, szLines);
+			lscp_framer_free(&framer);
+			break;
+		}
+		// ...until the rest of it arrives.
+		szLines[0] = (char) 0;
+		_test_feed(&framer, " line\r\n", 7, 4, &uSeed, szLines);
+		TEST_CHECK(strcmp(szLines, "NOTIFY:partial line\n") == 0);
+		lscp_framer_free(&framer);
+	}
+
+	// A line way too long gets dropped, up to its very end, but not
+	// any of the lines around it...
+	cchLong = LSCP_FRAMER_MAXSIZ + LSCP_FRAMER_BUFSIZ;
+	pchLong = (char *) malloc(cchLong + 17);
+	TEST_CHECK(pchLong != NULL);
+	if (pchLong == NULL)
+		return TEST_RESULT();
+	memcpy(pchLong, "before\r\n", 8);
+	memset(pchLong + 8, 'x', cchLong);
+	memcpy(pchLong + 8 + cchLong, "\r\nafter\r\n", 9);
+	lscp_framer_init(&framer);
+	szLines[0] = (char) 0;
+	_test_feed(&framer, pchLong, cchLong + 17, LSCP_FRAMER_BUFSIZ, &uSeed, szLines);
+	TEST_CHECK(strcmp(szLines, "before\nafter\n") == 0);
+	TEST_CHECK(framer.size <= 2 * LSCP_FRAMER_MAXSIZ);
+	lscp_framer_free(&framer);
+	free(pchLong);
+
+	return TEST_RESULT();
+}
+
+
+// end of test_framer.c
@@ -0,0 +1,89 @@
+// test_live_meters.c
+//
+/****************************************************************************
+   liblscp - LinuxSampler Control Protocol API
+   Copyright (C) 2004-2021, rncbc aka Rui Nuno Capela. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+*****************************************************************************/
+
+
+#include "test_server.h"
+
+#define TEST_PORT   18810
+
+
+int main ( int argc, char *argv[] )
+{
+	lscp_server_t *pServer;
+	lscp_client_t *pClient;
+	lscp_channel_meter_t meter;
+	int i;
+
+	(void) argc;
+	(void) argv;
+
+	pServer = test_server_start(TEST_PORT, NULL);
+	TEST_CHECK(pServer != NULL);
+	pClient = test_client_create(TEST_PORT);
+	TEST_CHECK(pClient != NULL);
+	if (pServer == NULL || pClient == NULL)
+		return 1;
+
+	// Nothing to read unless enabled...
+	TEST_CHECK(lscp_get_channel_meter(pClient, 1, &meter) == -1);
+	TEST_CHECK(lscp_get_total_voice_count_meter(pClient) == -1);
+
+	// Level events are subscribed internally...
+	TEST_CHECK(lscp_client_set_live_meters(pClient, 1) == LSCP_OK);
+	TEST_CHECK(lscp_client_get_live_meters(pClient) == 1);
+	TEST_CHECK(test_server_count("SUBSCRIBE VOICE_COUNT") == 1);
+	TEST_CHECK(test_server_count("SUBSCRIBE STREAM_COUNT") == 1);
+	TEST_CHECK(test_server_count("SUBSCRIBE BUFFER_FILL") == 1);
+	TEST_CHECK(test_server_count("SUBSCRIBE TOTAL_VOICE_COUNT") == 1);
+	TEST_CHECK(lscp_get_channel_meter(pClient, 1, &meter) == -1);
+
+	// ...and kept as last notified.
+	test_server_notify(pServer, LSCP_EVENT_VOICE_COUNT,
+		"1 8\r\n"
+		"NOTIFY:VOICE_COUNT:1 12\r\n"
+		"NOTIFY:STREAM_COUNT:1 3\r\n"
+		"NOTIFY:BUFFER_FILL:1 [0]10%,[1]40%,[2]25%\r\n"
+		"NOTIFY:TOTAL_VOICE_COUNT:20");
+	for (i = 0; i < 100 && lscp_get_total_voice_count_meter(pClient) < 0; i++)
+		test_sleep(10);
+	TEST_CHECK(lscp_get_total_voice_count_meter(pClient) == 20);
+	TEST_CHECK(lscp_get_channel_meter(pClient, 1, &meter) == 0);
+	TEST_CHECK(meter.voice_count == 12);
+	TEST_CHECK(meter.stream_count == 3);
+	TEST_CHECK(meter.fill_count == 3 && meter.fill_percentage);
+	TEST_CHECK(meter.fill_min == 10 && meter.fill_max == 40);
+	TEST_CHECK(lscp_get_channel_meter(pClient, 2, &meter) == -1);
+
+	// All gone when disabled.
+	TEST_CHECK(lscp_client_set_live_meters(pClient, 0) == LSCP_OK);
+	TEST_CHECK(lscp_client_get_live_meters(pClient) == 0);
+	TEST_CHECK(test_server_count("UNSUBSCRIBE") == 4);
+	TEST_CHECK(lscp_get_channel_meter(pClient, 1, &meter) == -1);
+
+	lscp_client_destroy(pClient);
+	test_server_stop(pServer);
+
+	return TEST_RESULT();
+}
+
+
+// end of test_live_meters.c
@@ -0,0 +1,117 @@
+// test_midi_batch.c
+//
+/****************************************************************************
+   liblscp - LinuxSampler Control Protocol API
+   Copyright (C) 2004-2021, rncbc aka Rui Nuno Capela. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+*****************************************************************************/
+
+
+#include "test_server.h"
+
+#include <string.h>
+
+#define TEST_PORT   18807
+
+// Order of arrival, as seen by the callbacks.
+static char _test_seen[64];
+static int  _test_seen_len = 0;
+
+static void _test_seen_add ( char ch )
+{
+	if (_test_seen_len < (int) sizeof(_test_seen) - 1)
+		_test_seen[_test_seen_len++] = ch;
+	_test_seen[_test_seen_len] = (char) 0;
+}
+
+
+static lscp_status_t _test_midi_callback ( lscp_client_t *pClient,
+	const lscp_midi_event_t *pMidiEvents, int iMidiEvents, void *pvData )
+{
+	int i;
+
+	(void) pClient;
+	(void) pvData;
+
+	for (i = 0; i < iMidiEvents; i++)
+		_test_seen_add(pMidiEvents[i].midi[0] == 0x90 ? 'N' : 'F');
+
+	return LSCP_OK;
+}
+
+
+static lscp_status_t _test_callback ( lscp_client_t *pClient,
+	lscp_event_t event, const char *pchData, int cchData, void *pvData )
+{
+	(void) pClient;
+	(void) pchData;
+	(void) cchData;
+	(void) pvData;
+
+	if (event == LSCP_EVENT_VOICE_COUNT)
+		_test_seen_add('V');
+
+	return LSCP_OK;
+}
+
+
+int main ( int argc, char *argv[] )
+{
+	lscp_server_t *pServer;
+	lscp_client_t *pClient;
+	int i;
+
+	(void) argc;
+	(void) argv;
+
+	pServer = test_server_start(TEST_PORT, NULL);
+	TEST_CHECK(pServer != NULL);
+	pClient = lscp_client_create("127.0.0.1", TEST_PORT, _test_callback, NULL);
+	TEST_CHECK(pClient != NULL);
+	if (pServer == NULL || pClient == NULL)
+		return 1;
+
+	lscp_client_set_timeout(pClient, 2000);
+	TEST_CHECK(lscp_client_set_midi_callback(pClient,
+		_test_midi_callback, NULL) == LSCP_OK);
+	TEST_CHECK(lscp_client_subscribe(pClient,
+		LSCP_EVENT_CHANNEL_MIDI | LSCP_EVENT_VOICE_COUNT) == LSCP_OK);
+
+	// All in one go, so that it's all handled in one single read...
+	test_server_notify(pServer, LSCP_EVENT_CHANNEL_MIDI,
+		"0 NOTE_ON 60 100\r\n"
+		"NOTIFY:CHANNEL_MIDI:0 NOTE_ON 64 100\r\n"
+		"NOTIFY:VOICE_COUNT:0 2\r\n"
+		"NOTIFY:CHANNEL_MIDI:0 NOTE_OFF 60 0\r\n"
+		"NOTIFY:VOICE_COUNT:0 1");
+
+	for (i = 0; i < 50 && _test_seen_len < 5; i++)
+		test_sleep(10);
+
+	// Other notifications don't overtake the MIDI events batched before.
+	TEST_CHECK(strcmp(_test_seen, "NNVFV") == 0);
+	if (strcmp(_test_seen, "NNVFV") != 0)
+		fprintf(stderr, "seen: \"%s\"\n", _test_seen);
+
+	lscp_client_destroy(pClient);
+	test_server_stop(pServer);
+
+	return TEST_RESULT();
+}
+
+
+// end of test_midi_batch.c
@@ -0,0 +1,156 @@
+// test_midi_mirror.c
+//
+/****************************************************************************
+   liblscp - LinuxSampler Control Protocol API
+   Copyright (C) 2004-2021, rncbc aka Rui Nuno Capela. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+*****************************************************************************/
+
+
+#include "test_server.h"
+
+#include <string.h>
+
+#define TEST_PORT   18803
+
+static const test_reply_t _replies[] = {
+	{ "LIST MIDI_INSTRUMENT_MAPS", "0,1\r\n" },
+	{ "GET MIDI_INSTRUMENT_MAP INFO 0",
+		"NAME: Default\r\n"
+		"DEFAULT: true\r\n"
+		".\r\n" },
+	{ "GET MIDI_INSTRUMENT_MAP INFO 1",
+		"NAME: Drums\r\n"
+		"DEFAULT: false\r\n"
+		".\r\n" },
+	{ "LIST MIDI_INSTRUMENTS 0", "{0,0,1},{0,1,2}\r\n" },
+	{ "LIST MIDI_INSTRUMENTS 1", "{1,0,0}\r\n" },
+	{ "GET MIDI_INSTRUMENT INFO 0 0 1",
+		"NAME: Piano\r\n"
+		"ENGINE_NAME: GIG\r\n"
+		"INSTRUMENT_FILE: /samples/piano.gig\r\n"
+		"INSTRUMENT_NR: 0\r\n"
+		"INSTRUMENT_NAME: Grand Piano\r\n"
+		"LOAD_MODE: ON_DEMAND\r\n"
+		"VOLUME: 1.0\r\n"
+		".\r\n" },
+	{ "GET MIDI_INSTRUMENT INFO 0 1 2",
+		"NAME: Strings\r\n"
+		"ENGINE_NAME: GIG\r\n"
+		"INSTRUMENT_FILE: /samples/strings.gig\r\n"
+		"INSTRUMENT_NR: 3\r\n"
+		"INSTRUMENT_NAME: Strings\r\n"
+		"LOAD_MODE: PERSISTENT\r\n"
+		"VOLUME: 0.5\r\n"
+		".\r\n" },
+	{ "GET MIDI_INSTRUMENT INFO 1 0 0",
+		"NAME: Kit\r\n"
+		"ENGINE_NAME: GIG\r\n"
+		"INSTRUMENT_FILE: /samples/piano.gig\r\n"
+		"INSTRUMENT_NR: 0\r\n"
+		"INSTRUMENT_NAME: Grand Piano\r\n"
+		"LOAD_MODE: ON_DEMAND\r\n"
+		"VOLUME: 1.0\r\n"
+		".\r\n" },
+	{ NULL, NULL }
+};
+
+
+int main ( int argc, char *argv[] )
+{
+	lscp_server_t *pServer;
+	lscp_client_t *pClient;
+	const lscp_midi_maps_t *pMaps;
+	const lscp_midi_map_entry_t *pEntry;
+	const lscp_midi_map_entry_t **ppEntries;
+	lscp_midi_instrument_t instr;
+	int i;
+
+	(void) argc;
+	(void) argv;
+
+	pServer = test_server_start(TEST_PORT, _replies);
+	TEST_CHECK(pServer != NULL);
+	pClient = test_client_create(TEST_PORT);
+	TEST_CHECK(pClient != NULL);
+	if (pServer == NULL || pClient == NULL)
+		return 1;
+
+	TEST_CHECK(lscp_get_midi_instrument_mirror(pClient) == NULL);
+	TEST_CHECK(lscp_client_set_midi_map_mirror(pClient, 1) == LSCP_OK);
+	TEST_CHECK(lscp_client_get_midi_map_mirror(pClient) == 1);
+
+	// The whole thing, on first access...
+	pMaps = lscp_get_midi_instrument_mirror(pClient);
+	TEST_CHECK(pMaps != NULL && pMaps->map_count == 2);
+	if (pMaps == NULL || pMaps->map_count != 2)
+		return TEST_RESULT();
+	TEST_CHECK(pMaps->maps[0].map == 0 && pMaps->maps[0].entry_count == 2);
+	TEST_CHECK(pMaps->maps[1].map == 1 && pMaps->maps[1].entry_count == 1);
+	TEST_CHECK(pMaps->maps[0].name && strcmp(pMaps->maps[0].name, "Default") == 0);
+	TEST_CHECK(pMaps->maps[1].name && strcmp(pMaps->maps[1].name, "Drums") == 0);
+
+	// Indexed lookups...
+	instr.map  = 0;
+	instr.bank = 1;
+	instr.prog = 2;
+	pEntry = lscp_find_midi_instrument(pClient, &instr);
+	TEST_CHECK(pEntry != NULL && pEntry->info.name
+		&& strcmp(pEntry->info.name, "Strings") == 0);
+	instr.prog = 3;
+	TEST_CHECK(lscp_find_midi_instrument(pClient, &instr) == NULL);
+
+	ppEntries = lscp_find_midi_instruments_by_name(pClient, "Piano");
+	TEST_CHECK(ppEntries != NULL && ppEntries[0] != NULL && ppEntries[1] == NULL);
+	ppEntries = lscp_find_midi_instruments_by_file(pClient, "/samples/piano.gig", 0);
+	for (i = 0; ppEntries && ppEntries[i]; i++)
+		;
+	TEST_CHECK(i == 2);
+
+	// Nothing gets refetched unless notified stale...
+	test_server_clear();
+	TEST_CHECK(lscp_get_midi_instrument_mirror(pClient) != NULL);
+	TEST_CHECK(test_server_count("") == 0);
+
+	// Just the one entry notified...
+	test_server_notify(pServer, LSCP_EVENT_MIDI_INSTRUMENT_INFO, "0 1 2");
+	test_sleep(100);
+	TEST_CHECK(lscp_get_midi_instrument_mirror(pClient) != NULL);
+	TEST_CHECK(test_server_count("GET MIDI_INSTRUMENT INFO 0 1 2") == 1);
+	TEST_CHECK(test_server_count("GET MIDI_INSTRUMENT INFO") == 1);
+	TEST_CHECK(test_server_count("LIST") == 0);
+
+	// The map list, on its pseudo-key...
+	test_server_clear();
+	test_server_notify(pServer, LSCP_EVENT_MIDI_INSTRUMENT_MAP_COUNT, "2");
+	test_sleep(100);
+	pMaps = lscp_get_midi_instrument_mirror(pClient);
+	TEST_CHECK(pMaps != NULL && pMaps->map_count == 2);
+	TEST_CHECK(test_server_count("LIST MIDI_INSTRUMENT_MAPS") == 1);
+	TEST_CHECK(test_server_count("GET MIDI_INSTRUMENT INFO") == 0);
+
+	TEST_CHECK(lscp_client_set_midi_map_mirror(pClient, 0) == LSCP_OK);
+	TEST_CHECK(lscp_get_midi_instrument_mirror(pClient) == NULL);
+
+	lscp_client_destroy(pClient);
+	test_server_stop(pServer);
+
+	return TEST_RESULT();
+}
+
+
+// end of test_midi_mirror.c
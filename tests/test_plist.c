@@ -0,0 +1,104 @@
+// test_plist.c
+//
+/****************************************************************************
+   liblscp - LinuxSampler Control Protocol API
+   Copyright (C) 2004-2021, rncbc aka Rui Nuno Capela. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+*****************************************************************************/
+
+
+#include "test_server.h"
+#include "src/common.h"
+
+#include <string.h>
+
+#define TEST_PARAMS 1000
+
+
+int main ( int argc, char *argv[] )
+{
+	static lscp_param_t params[] = {
+		{ "DRIVER", "ALSA" },
+		{ "CHANNELS", "2" },
+		{ NULL, NULL }
+	};
+
+	lscp_param_t *pParams = NULL;
+	char szKey[32];
+	char szValue[32];
+	const char *pszValue;
+	int i, iMatch;
+
+	(void) argc;
+	(void) argv;
+
+	lscp_plist_alloc(&pParams);
+	TEST_CHECK(pParams != NULL && pParams[0].key == NULL);
+	if (pParams == NULL)
+		return TEST_RESULT();
+	TEST_CHECK(lscp_plist_find(pParams, "none") == NULL);
+
+	// Plenty of keys, the array moving around as it grows...
+	for (i = 0; i < TEST_PARAMS; i++) {
+		sprintf(szKey, "key%d", i);
+		sprintf(szValue, "%d", i);
+		lscp_plist_append(&pParams, szKey, szValue);
+	}
+
+	// Looked up case-insensitively...
+	for (i = 0, iMatch = 0; i < TEST_PARAMS; i++) {
+		sprintf(szKey, "KEY%d", i);
+		pszValue = lscp_plist_find(pParams, szKey);
+		if (pszValue && lscp_atoi(pszValue) == i)
+			iMatch++;
+	}
+	TEST_CHECK(iMatch == TEST_PARAMS);
+	TEST_CHECK(lscp_plist_find(pParams, "key1000") == NULL);
+
+	// Same key, value replaced in place...
+	lscp_plist_append(&pParams, "Key7", "seven");
+	pszValue = lscp_plist_find(pParams, "key7");
+	TEST_CHECK(pszValue && strcmp(pszValue, "seven") == 0);
+
+	// Still the plain null terminated layout, in order...
+	for (i = 0; pParams[i].key; i++)
+		;
+	TEST_CHECK(i == TEST_PARAMS);
+	TEST_CHECK(strcmp(pParams[0].key, "key0") == 0);
+	TEST_CHECK(strcmp(pParams[TEST_PARAMS - 1].key, "key999") == 0);
+
+	// The public getter goes through the key index, wherever it moved...
+	TEST_CHECK(lscp_plist_indexed(pParams));
+	pszValue = lscp_get_param_value(pParams, "KEY999");
+	TEST_CHECK(pszValue && lscp_atoi(pszValue) == 999);
+	TEST_CHECK(lscp_get_param_value(pParams, "key1000") == NULL);
+
+	lscp_plist_free(&pParams);
+	TEST_CHECK(pParams == NULL);
+	TEST_CHECK(!lscp_plist_indexed(params));
+
+	// Any other parameter list goes through the public getter...
+	pszValue = lscp_get_param_value(params, "channels");
+	TEST_CHECK(pszValue && strcmp(pszValue, "2") == 0);
+	TEST_CHECK(lscp_get_param_value(params, "ports") == NULL);
+	TEST_CHECK(lscp_get_param_value(NULL, "ports") == NULL);
+
+	return TEST_RESULT();
+}
+
+
+// end of test_plist.c
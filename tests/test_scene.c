@@ -0,0 +1,232 @@
+// test_scene.c
+//
+/****************************************************************************
+   liblscp - LinuxSampler Control Protocol API
+   Copyright (C) 2004-2021, rncbc aka Rui Nuno Capela. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+*****************************************************************************/
+
+
+#include "test_server.h"
+
+#include <string.h>
+
+#define TEST_PORT   18804
+
+#define TEST_CHANNEL_INFO(engine, file, nr) \
+	"ENGINE_NAME: " engine "\r\n" \
+	"VOLUME: 1.0\r\n" \
+	"AUDIO_OUTPUT_DEVICE: 0\r\n" \
+	"AUDIO_OUTPUT_CHANNELS: 2\r\n" \
+	"AUDIO_OUTPUT_ROUTING: 0,1\r\n" \
+	"MIDI_INPUT_DEVICE: 0\r\n" \
+	"MIDI_INPUT_PORT: 0\r\n" \
+	"MIDI_INPUT_CHANNEL: ALL\r\n" \
+	"INSTRUMENT_FILE: " file "\r\n" \
+	"INSTRUMENT_NR: " nr "\r\n" \
+	"INSTRUMENT_NAME: Some\r\n" \
+	"INSTRUMENT_STATUS: 100\r\n" \
+	"MUTE: false\r\n" \
+	"SOLO: false\r\n" \
+	"MIDI_INSTRUMENT_MAP: NONE\r\n" \
+	".\r\n"
+
+static const test_reply_t _replies[] = {
+	{ "LIST CHANNELS", "0,1,2\r\n" },
+	{ "GET CHANNEL INFO 0", TEST_CHANNEL_INFO("GIG", "/samples/a.gig", "0") },
+	{ "GET CHANNEL INFO 1", TEST_CHANNEL_INFO("GIG", "/samples/b.gig", "0") },
+	{ "GET CHANNEL INFO 2", TEST_CHANNEL_INFO("GIG", "/samples/d.gig", "2") },
+	{ "GET FX_SEND INFO 0 0",
+		"NAME: Reverb\r\n"
+		"MIDI_CONTROLLER: 91\r\n"
+		"AUDIO_OUTPUT_ROUTING: 0,1\r\n"
+		"LEVEL: 0.5\r\n"
+		".\r\n" },
+	{ "GET MIDI_INSTRUMENT INFO 0 0 0",
+		"NAME: Old\r\n"
+		"ENGINE_NAME: GIG\r\n"
+		"INSTRUMENT_FILE: /samples/a.gig\r\n"
+		"INSTRUMENT_NR: 0\r\n"
+		"INSTRUMENT_NAME: Some\r\n"
+		"LOAD_MODE: ON_DEMAND\r\n"
+		"VOLUME: 1.0\r\n"
+		".\r\n" },
+	{ "SET CHANNEL MUTE", "ERR:1:Mute failed.\r\n" },
+	{ NULL, NULL }
+};
+
+
+// Whether some command list holds these (prefixes) in order, and no more.
+static int _commands_match ( const char **ppszCommands, const char **ppszExpected )
+{
+	int i;
+
+	for (i = 0; ppszCommands[i] && ppszExpected[i]; i++) {
+		if (strncmp(ppszCommands[i], ppszExpected[i], strlen(ppszExpected[i])) != 0)
+			break;
+	}
+
+	if (ppszCommands[i] == NULL && ppszExpected[i] == NULL)
+		return 1;
+
+	for (i = 0; ppszCommands[i]; i++)
+		fprintf(stderr, "  %s", ppszCommands[i]);
+
+	return 0;
+}
+
+
+static void _scene_channel_keep ( lscp_scene_channel_t *pChannel, int iChannel )
+{
+	memset(pChannel, 0, sizeof(*pChannel));
+
+	pChannel->channel       = iChannel;
+	pChannel->instrument_nr = LSCP_SCENE_KEEP;
+	pChannel->audio_device  = LSCP_SCENE_KEEP;
+	pChannel->midi_device   = LSCP_SCENE_KEEP;
+	pChannel->midi_port     = LSCP_SCENE_KEEP;
+	pChannel->midi_channel  = LSCP_SCENE_KEEP;
+	pChannel->midi_map      = LSCP_SCENE_KEEP;
+	pChannel->volume        = -1.0f;
+	pChannel->mute          = LSCP_SCENE_KEEP;
+	pChannel->solo          = LSCP_SCENE_KEEP;
+}
+
+
+int main ( int argc, char *argv[] )
+{
+	static const int routing_same[] = { 0, 1, -1 };
+	static const int routing_mono[] = { 1, 1, -1 };
+
+	static const char *expected[] = {
+		"LOAD ENGINE SF2 1\r\n",
+		"SET CHANNEL AUDIO_OUTPUT_CHANNEL 0 0 1\r\n",
+		"SET CHANNEL VOLUME 0 0.25",
+		"SET CHANNEL MUTE 0 1\r\n",
+		"MAP MIDI_INSTRUMENT NON_MODAL 0 0 0 GIG '/samples/a.gig' 0 1",
+		"LOAD INSTRUMENT NON_MODAL '/samples/c.sf2' 0 1\r\n",
+		NULL
+	};
+	static const char *reload[] = {
+		"LOAD INSTRUMENT NON_MODAL '/samples/e.gig' 2 2\r\n",
+		NULL
+	};
+	static const char *nothing[] = { NULL };
+
+	lscp_server_t *pServer;
+	lscp_client_t *pClient;
+	lscp_scene_channel_t channels[3];
+	lscp_scene_fxsend_t fxsend;
+	lscp_scene_instrument_t instr;
+	lscp_scene_t scene;
+	const char **ppszCommands;
+	char szLongFile[LSCP_BUFSIZ + 16];
+
+	(void) argc;
+	(void) argv;
+
+	pServer = test_server_start(TEST_PORT, _replies);
+	TEST_CHECK(pServer != NULL);
+	pClient = test_client_create(TEST_PORT);
+	TEST_CHECK(pClient != NULL);
+	if (pServer == NULL || pClient == NULL)
+		return 1;
+
+	// Channel 0: some settings and routing; the effect send is as found.
+	_scene_channel_keep(&channels[0], 0);
+	channels[0].engine_name   = "GIG";
+	channels[0].audio_routing = routing_mono;
+	channels[0].volume        = 0.25f;
+	channels[0].mute          = 1;
+	channels[0].solo          = 0;
+	channels[0].fxsend_count  = 1;
+	channels[0].fxsends       = &fxsend;
+	fxsend.fxsend        = 0;
+	fxsend.level         = 0.5f;
+	fxsend.audio_routing = routing_same;
+
+	// Channel 1: another engine, and so another instrument.
+	_scene_channel_keep(&channels[1], 1);
+	channels[1].engine_name     = "SF2";
+	channels[1].instrument_file = "/samples/c.sf2";
+
+	// A map entry, just renamed.
+	memset(&instr, 0, sizeof(instr));
+	instr.engine_name     = "GIG";
+	instr.instrument_file = "/samples/a.gig";
+	instr.volume          = -1.0f;
+	instr.load_mode       = LSCP_LOAD_DEFAULT;
+	instr.name            = "New";
+
+	scene.channel_count    = 2;
+	scene.channels         = channels;
+	scene.instrument_count = 1;
+	scene.instruments      = &instr;
+
+	// The minimal set of commands, in order...
+	ppszCommands = lscp_scene_diff(pClient, &scene, NULL);
+	TEST_CHECK(ppszCommands != NULL);
+	if (ppszCommands)
+		TEST_CHECK(_commands_match(ppszCommands, expected));
+
+	// All of them get sent, the first failure told...
+	test_server_clear();
+	TEST_CHECK(lscp_scene_apply(pClient, &scene, NULL) == LSCP_ERROR);
+	TEST_CHECK(strcmp(lscp_client_get_result(pClient), "Mute failed.") == 0);
+	TEST_CHECK(test_server_count("LOAD ENGINE SF2 1") == 1);
+	TEST_CHECK(test_server_count("SET CHANNEL ") == 3);
+	TEST_CHECK(test_server_count("MAP MIDI_INSTRUMENT NON_MODAL") == 1);
+	TEST_CHECK(test_server_count("LOAD INSTRUMENT") == 1);
+
+	// Nothing to do when it's all as found...
+	_scene_channel_keep(&channels[0], 0);
+	_scene_channel_keep(&channels[1], 1);
+	channels[1].engine_name     = "GIG";
+	channels[1].instrument_file = "/samples/b.gig";
+	scene.instrument_count = 0;
+	ppszCommands = lscp_scene_diff(pClient, &scene, NULL);
+	TEST_CHECK(ppszCommands != NULL && _commands_match(ppszCommands, nothing));
+	test_server_clear();
+	TEST_CHECK(lscp_scene_apply(pClient, &scene, NULL) == LSCP_OK);
+	TEST_CHECK(test_server_count("LOAD") == 0 && test_server_count("SET") == 0);
+
+	// The instrument index is kept as found, if told so...
+	_scene_channel_keep(&channels[2], 2);
+	channels[2].instrument_file = "/samples/d.gig";
+	scene.channel_count = 3;
+	ppszCommands = lscp_scene_diff(pClient, &scene, NULL);
+	TEST_CHECK(ppszCommands != NULL && _commands_match(ppszCommands, nothing));
+	channels[2].instrument_file = "/samples/e.gig";
+	ppszCommands = lscp_scene_diff(pClient, &scene, NULL);
+	TEST_CHECK(ppszCommands != NULL && _commands_match(ppszCommands, reload));
+	scene.channel_count = 2;
+
+	// Commands that wouldn't fit are refused, not truncated...
+	memset(szLongFile, 'x', sizeof(szLongFile) - 1);
+	szLongFile[0] = '/';
+	szLongFile[sizeof(szLongFile) - 1] = '\0';
+	channels[1].instrument_file = szLongFile;
+	TEST_CHECK(lscp_scene_diff(pClient, &scene, NULL) == NULL);
+
+	lscp_client_destroy(pClient);
+	test_server_stop(pServer);
+
+	return TEST_RESULT();
+}
+
+
+// end of test_scene.c
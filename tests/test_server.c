@@ -0,0 +1,264 @@
+// test_server.c
+//
+/****************************************************************************
+   liblscp - LinuxSampler Control Protocol API
+   Copyright (C) 2004-2021, rncbc aka Rui Nuno Capela. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+*****************************************************************************/
+
+#include "test_server.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#if !defined(WIN32)
+#include <unistd.h>
+#endif
+
+// Most connections and request lines kept track of.
+#define TEST_CONNECTS   8
+#define TEST_REQUESTS   4096
+
+
+int test_failures = 0;
+
+// Partial request line carried over, per connection.
+static struct _test_connect_t
+{
+	lscp_connect_t *connect;
+	char            line[LSCP_BUFSIZ];
+	int             len;
+
+} _test_connects[TEST_CONNECTS];
+
+static const test_reply_t *_test_replies = NULL;
+
+static char *_test_requests[TEST_REQUESTS];
+static int   _test_count = 0;
+
+static lscp_mutex_t _test_mutex;
+
+
+//-------------------------------------------------------------------------
+// Request handling.
+
+static void _test_server_request ( lscp_connect_t *pConnect, const char *pszLine )
+{
+	const test_reply_t *pReply;
+	const char *pszResult = NULL;
+	int iMatch = 0;
+
+	lscp_mutex_lock(_test_mutex);
+
+	if (_test_count < TEST_REQUESTS)
+		_test_requests[_test_count++] = strdup(pszLine);
+
+	for (pReply = _test_replies; pReply && pReply->query; pReply++) {
+		if (strncmp(pszLine, pReply->query, strlen(pReply->query)) == 0) {
+			pszResult = pReply->result;
+			iMatch = 1;
+			break;
+		}
+	}
+
+	lscp_mutex_unlock(_test_mutex);
+
+	// Subscriptions are always honored, whatever the reply...
+	if (strncmp(pszLine, "SUBSCRIBE ", 10) == 0) {
+		if (!iMatch || (pszResult && strncmp(pszResult, "OK", 2) == 0))
+			lscp_server_subscribe(pConnect, lscp_event_from_text(pszLine + 10));
+	}
+	else
+	if (strncmp(pszLine, "UNSUBSCRIBE ", 12) == 0)
+		lscp_server_unsubscribe(pConnect, lscp_event_from_text(pszLine + 12));
+
+	if (!iMatch) {
+		if (strncmp(pszLine, "GET ", 4) == 0 || strncmp(pszLine, "LIST ", 5) == 0)
+			pszResult = "ERR:0:Unknown query.\r\n";
+		else
+			pszResult = "OK\r\n";
+	}
+
+	if (pszResult)
+		lscp_server_result(pConnect, pszResult, strlen(pszResult));
+}
+
+
+static lscp_status_t _test_server_callback ( lscp_connect_t *pConnect,
+	const char *pchBuffer, int cchBuffer, void *pvData )
+{
+	struct _test_connect_t *pTest = NULL;
+	int i;
+
+	(void) pvData;
+
+	for (i = 0; i < TEST_CONNECTS; i++) {
+		if (_test_connects[i].connect == pConnect) {
+			pTest = &_test_connects[i];
+			break;
+		}
+	}
+
+	if (pchBuffer == NULL) {
+		if (cchBuffer == LSCP_CONNECT_OPEN) {
+			for (i = 0; pTest == NULL && i < TEST_CONNECTS; i++) {
+				if (_test_connects[i].connect == NULL) {
+					pTest = &_test_connects[i];
+					pTest->connect = pConnect;
+				}
+			}
+		}
+		if (pTest)
+			pTest->len = 0;
+		if (pTest && cchBuffer == LSCP_CONNECT_CLOSE)
+			pTest->connect = NULL;
+		return LSCP_OK;
+	}
+
+	if (pTest == NULL)
+		return LSCP_FAILED;
+
+	// Handle each complete line, keeping the rest for later...
+	for (i = 0; i < cchBuffer; i++) {
+		if (pchBuffer[i] == '\n') {
+			while (pTest->len > 0 && pTest->line[pTest->len - 1] == '\r')
+				pTest->len--;
+			pTest->line[pTest->len] = '\0';
+			if (pTest->len > 0)
+				_test_server_request(pConnect, pTest->line);
+			pTest->len = 0;
+		}
+		else if (pTest->len < LSCP_BUFSIZ - 1)
+			pTest->line[pTest->len++] = pchBuffer[i];
+	}
+
+	return LSCP_OK;
+}
+
+
+//-------------------------------------------------------------------------
+// Scripted server functions.
+
+lscp_server_t *test_server_start ( int iPort, const test_reply_t *pReplies )
+{
+	lscp_mutex_init(_test_mutex);
+
+	memset(_test_connects, 0, sizeof(_test_connects));
+	_test_replies = pReplies;
+	_test_count = 0;
+
+	return lscp_server_create(iPort, _test_server_callback, NULL);
+}
+
+
+void test_server_stop ( lscp_server_t *pServer )
+{
+	lscp_server_destroy(pServer);
+
+	test_server_clear();
+
+	lscp_mutex_destroy(_test_mutex);
+}
+
+
+void test_server_replies ( const test_reply_t *pReplies )
+{
+	lscp_mutex_lock(_test_mutex);
+	_test_replies = pReplies;
+	lscp_mutex_unlock(_test_mutex);
+}
+
+
+// Number of request lines received so far, starting with some prefix.
+int test_server_count ( const char *pszPrefix )
+{
+	int iCount = 0;
+	int i;
+
+	lscp_mutex_lock(_test_mutex);
+
+	for (i = 0; i < _test_count; i++) {
+		if (strncmp(_test_requests[i], pszPrefix, strlen(pszPrefix)) == 0)
+			iCount++;
+	}
+
+	lscp_mutex_unlock(_test_mutex);
+
+	return iCount;
+}
+
+
+void test_server_clear (void)
+{
+	int i;
+
+	lscp_mutex_lock(_test_mutex);
+
+	for (i = 0; i < _test_count; i++)
+		free(_test_requests[i]);
+	_test_count = 0;
+
+	lscp_mutex_unlock(_test_mutex);
+}
+
+
+lscp_status_t test_server_notify ( lscp_server_t *pServer,
+	lscp_event_t event, const char *pszData )
+{
+	return lscp_server_broadcast(pServer, event, pszData, strlen(pszData));
+}
+
+
+//-------------------------------------------------------------------------
+// Client helpers.
+
+static lscp_status_t _test_client_callback ( lscp_client_t *pClient,
+	lscp_event_t event, const char *pchData, int cchData, void *pvData )
+{
+	(void) pClient;
+	(void) event;
+	(void) pchData;
+	(void) cchData;
+	(void) pvData;
+
+	return LSCP_OK;
+}
+
+
+lscp_client_t *test_client_create ( int iPort )
+{
+	lscp_client_t *pClient;
+
+	pClient = lscp_client_create("127.0.0.1", iPort, _test_client_callback, NULL);
+	if (pClient)
+		lscp_client_set_timeout(pClient, 2000);
+
+	return pClient;
+}
+
+
+void test_sleep ( int iMsecs )
+{
+#if defined(WIN32)
+	Sleep(iMsecs);
+#else
+	usleep(iMsecs * 1000);
+#endif
+}
+
+
+// end of test_server.c
@@ -0,0 +1,74 @@
+// test_server.h
+//
+/****************************************************************************
+   liblscp - LinuxSampler Control Protocol API
+   Copyright (C) 2004-2021, rncbc aka Rui Nuno Capela. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+*****************************************************************************/
+
+#ifndef __TEST_SERVER_H
+#define __TEST_SERVER_H
+
+#include "server.h"
+#include "lscp/client.h"
+
+#include <stdio.h>
+
+
+//-------------------------------------------------------------------------
+// Scripted in-process server, for behavior tests.
+
+/** Scripted reply: the first entry whose query is a prefix of the
+    request line gets its result sent (none at all if NULL). */
+typedef struct _test_reply_t
+{
+	const char *query;
+	const char *result;
+
+} test_reply_t;
+
+lscp_server_t * test_server_start   (int iPort, const test_reply_t *pReplies);
+void            test_server_stop    (lscp_server_t *pServer);
+void            test_server_replies (const test_reply_t *pReplies);
+
+int             test_server_count   (const char *pszPrefix);
+void            test_server_clear   (void);
+
+lscp_status_t   test_server_notify  (lscp_server_t *pServer, lscp_event_t event, const char *pszData);
+
+lscp_client_t * test_client_create  (int iPort);
+
+void            test_sleep          (int iMsecs);
+
+
+//-------------------------------------------------------------------------
+// Test assertions.
+
+extern int test_failures;
+
+#define TEST_CHECK(cond) \
+	do { if (!(cond)) { test_failures++; \
+		fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+	} } while (0)
+
+#define TEST_RESULT() \
+	(test_failures > 0 ? (fprintf(stderr, "%d check(s) failed.\n", test_failures), 1) : 0)
+
+
+#endif // __TEST_SERVER_H
+
+// end of test_server.h
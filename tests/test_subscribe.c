@@ -0,0 +1,118 @@
+// test_subscribe.c
+//
+/****************************************************************************
+   liblscp - LinuxSampler Control Protocol API
+   Copyright (C) 2004-2021, rncbc aka Rui Nuno Capela. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+*****************************************************************************/
+
+
+#include "test_server.h"
+
+#include <string.h>
+#include <time.h>
+
+#define TEST_PORT   18802
+
+// No reply at all to this one subscription.
+static const test_reply_t _replies[] = {
+	{ "SUBSCRIBE MISCELLANEOUS", NULL },
+	{ NULL, NULL }
+};
+
+// Steady notification traffic, keeping the event service busy.
+static volatile int _traffic = 0;
+
+static void _traffic_proc ( void *pvServer )
+{
+	lscp_server_t *pServer = (lscp_server_t *) pvServer;
+
+	while (_traffic) {
+		test_server_notify(pServer, LSCP_EVENT_CHANNEL_INFO, "0");
+		test_sleep(5);
+	}
+}
+
+
+int main ( int argc, char *argv[] )
+{
+	lscp_server_t *pServer;
+	lscp_client_t *pClient;
+	lscp_thread_t *pThread;
+	time_t t0;
+
+	(void) argc;
+	(void) argv;
+
+	pServer = test_server_start(TEST_PORT, _replies);
+	TEST_CHECK(pServer != NULL);
+	pClient = test_client_create(TEST_PORT);
+	TEST_CHECK(pClient != NULL);
+	if (pServer == NULL || pClient == NULL)
+		return 1;
+
+	// Pipelined, all replied in order...
+	TEST_CHECK(lscp_client_subscribe(pClient,
+		LSCP_EVENT_CHANNEL_INFO | LSCP_EVENT_CHANNEL_COUNT
+		| LSCP_EVENT_VOICE_COUNT) == LSCP_OK);
+	TEST_CHECK(lscp_client_get_events(pClient) == (LSCP_EVENT_CHANNEL_INFO
+		| LSCP_EVENT_CHANNEL_COUNT | LSCP_EVENT_VOICE_COUNT));
+
+	_traffic = 1;
+	pThread = lscp_thread_create(_traffic_proc, pServer, 0);
+	test_sleep(50);
+
+	// A missing reply times out on the caller side,
+	// however busy the event service may be...
+	lscp_client_set_timeout(pClient, 200);
+	t0 = time(NULL);
+	TEST_CHECK(lscp_client_subscribe(pClient,
+		LSCP_EVENT_MISCELLANEOUS) == LSCP_TIMEOUT);
+	TEST_CHECK(time(NULL) - t0 <= 2);
+	TEST_CHECK((lscp_client_get_events(pClient) & LSCP_EVENT_MISCELLANEOUS) == 0);
+
+	// And the next ones are just fine...
+	lscp_client_set_timeout(pClient, 2000);
+	TEST_CHECK(lscp_client_subscribe(pClient,
+		LSCP_EVENT_STREAM_COUNT) == LSCP_OK);
+	TEST_CHECK(lscp_client_unsubscribe(pClient,
+		LSCP_EVENT_VOICE_COUNT) == LSCP_OK);
+	TEST_CHECK((lscp_client_get_events(pClient) & LSCP_EVENT_VOICE_COUNT) == 0);
+
+	_traffic = 0;
+	lscp_thread_destroy(pThread);
+
+	// Nor do conflated events pending for long hold it up...
+	TEST_CHECK(lscp_client_set_event_conflation(pClient,
+		LSCP_EVENT_CHANNEL_INFO, 5000) == LSCP_OK);
+	test_server_notify(pServer, LSCP_EVENT_CHANNEL_INFO, "0");
+	test_server_notify(pServer, LSCP_EVENT_CHANNEL_INFO, "1");
+	test_sleep(50);
+	lscp_client_set_timeout(pClient, 200);
+	t0 = time(NULL);
+	TEST_CHECK(lscp_client_subscribe(pClient,
+		LSCP_EVENT_MISCELLANEOUS) == LSCP_TIMEOUT);
+	TEST_CHECK(time(NULL) - t0 <= 2);
+
+	lscp_client_destroy(pClient);
+	test_server_stop(pServer);
+
+	return TEST_RESULT();
+}
+
+
+// end of test_subscribe.c
@@ -0,0 +1,186 @@
+// test_warm_start.c
+//
+/****************************************************************************
+   liblscp - LinuxSampler Control Protocol API
+   Copyright (C) 2004-2021, rncbc aka Rui Nuno Capela. All rights reserved.
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation, Inc.,
+   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+*****************************************************************************/
+
+#include "test_server.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#define TEST_PORT   18801
+
+static const test_reply_t _replies[] = {
+	{ "GET SERVER INFO",
+		"DESCRIPTION: Test Server\r\n"
+		"VERSION: 1.0.0\r\n"
+		"PROTOCOL_VERSION: 1.7\r\n"
+		".\r\n" },
+	{ "GET ENGINE INFO GIG",
+		"DESCRIPTION: Gigasampler Engine\r\n"
+		"VERSION: 2.0\r\n"
+		".\r\n" },
+	{ NULL, NULL }
+};
+
+
+static char *_file_read ( const char *pszFilename, int *pcbData )
+{
+	FILE *pFile;
+	char *pchData;
+	long cbData;
+
+	pFile = fopen(pszFilename, "rb");
+	if (pFile == NULL)
+		return NULL;
+
+	fseek(pFile, 0, SEEK_END);
+	cbData = ftell(pFile);
+	fseek(pFile, 0, SEEK_SET);
+
+	pchData = (char *) malloc(cbData > 0 ? cbData : 1);
+	if (pchData && fread(pchData, 1, cbData, pFile) != (size_t) cbData) {
+		free(pchData);
+		pchData = NULL;
+	}
+
+	fclose(pFile);
+
+	*pcbData = (int) cbData;
+	return pchData;
+}
+
+
+static void _file_write ( const char *pszFilename, const char *pchData, int cbData )
+{
+	FILE *pFile = fopen(pszFilename, "wb");
+
+	if (pFile) {
+		if (cbData > 0)
+			fwrite(pchData, 1, cbData, pFile);
+		fclose(pFile);
+	}
+}
+
+
+// Load a corrupt copy, with a 32bit word patched at some offset.
+static lscp_status_t _load_patched ( lscp_client_t *pClient,
+	const char *pszFilename, const char *pchData, int cbData,
+	int iOffset, uint32_t w )
+{
+	char *pchCopy = (char *) malloc(cbData);
+
+	lscp_status_t ret;
+
+	memcpy(pchCopy, pchData, cbData);
+	memcpy(pchCopy + iOffset, &w, sizeof(w));
+	_file_write(pszFilename, pchCopy, cbData);
+	free(pchCopy);
+
+	ret = lscp_client_load_warm_start(pClient, pszFilename);
+
+	return ret;
+}
+
+
+int main ( int argc, char *argv[] )
+{
+	static const uint32_t lengths[] = {
+		0x7ffffffdu, 0x7ffffffeu, 0x7fffffffu,
+		0x80000000u, 0xfffffffdu, 0xffffffffu
+	};
+
+	const char *pszFilename = "test_warm_start.lscp";
+	const char *pszCorrupt  = "test_warm_start_corrupt.lscp";
+	lscp_server_t *pServer;
+	lscp_client_t *pClient;
+	lscp_engine_info_t *pEngineInfo;
+	char *pchData;
+	int cbData, i, j;
+
+	lscp_status_t ret;
+
+	(void) argc;
+	(void) argv;
+
+	pServer = test_server_start(TEST_PORT, _replies);
+	TEST_CHECK(pServer != NULL);
+	pClient = test_client_create(TEST_PORT);
+	TEST_CHECK(pClient != NULL);
+	if (pServer == NULL || pClient == NULL)
+		return 1;
+
+	// Memoize some metadata and save it all...
+	pEngineInfo = lscp_get_engine_info(pClient, "GIG");
+	TEST_CHECK(pEngineInfo != NULL);
+	TEST_CHECK(lscp_client_save_warm_start(pClient, pszFilename) == LSCP_OK);
+	lscp_client_destroy(pClient);
+
+	// A fresh client gets it from the file, no round-trip...
+	pClient = test_client_create(TEST_PORT);
+	test_server_clear();
+	TEST_CHECK(lscp_client_load_warm_start(pClient, pszFilename) == LSCP_OK);
+	pEngineInfo = lscp_get_engine_info(pClient, "GIG");
+	TEST_CHECK(pEngineInfo != NULL
+		&& strcmp(pEngineInfo->description, "Gigasampler Engine") == 0);
+	TEST_CHECK(test_server_count("GET ENGINE INFO") == 0);
+
+	pchData = _file_read(pszFilename, &cbData);
+	TEST_CHECK(pchData != NULL && cbData > 32);
+	if (pchData == NULL)
+		return TEST_RESULT();
+
+	// Missing or bogus files are refused...
+	TEST_CHECK(lscp_client_load_warm_start(pClient, "test_warm_start.none") == LSCP_FAILED);
+	_file_write(pszCorrupt, pchData, 0);
+	TEST_CHECK(lscp_client_load_warm_start(pClient, pszCorrupt) == LSCP_FAILED);
+
+	// Any truncation is either refused or a whole record shorter...
+	for (i = 1; i < cbData; i++) {
+		_file_write(pszCorrupt, pchData, i);
+		ret = lscp_client_load_warm_start(pClient, pszCorrupt);
+		TEST_CHECK(ret == LSCP_OK || ret == LSCP_FAILED);
+		if (i < 16)
+			TEST_CHECK(ret == LSCP_FAILED);
+	}
+
+	// Huge or negative record and string lengths are refused
+	// (header is 16 bytes, then the server version record tag,
+	// record length, and version string length)...
+	for (j = 0; j < (int) (sizeof(lengths) / sizeof(lengths[0])); j++) {
+		TEST_CHECK(_load_patched(pClient, pszCorrupt,
+			pchData, cbData, 20, lengths[j]) == LSCP_FAILED);
+		TEST_CHECK(_load_patched(pClient, pszCorrupt,
+			pchData, cbData, 24, lengths[j]) == LSCP_FAILED);
+	}
+
+	free(pchData);
+	remove(pszFilename);
+	remove(pszCorrupt);
+
+	lscp_client_destroy(pClient);
+	test_server_stop(pServer);
+
+	return TEST_RESULT();
+}
+
+
+// end of test_warm_start.c